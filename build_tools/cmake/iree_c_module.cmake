@@ -20,6 +20,9 @@
 #     -DIREE_BUILD_TESTS=ON to CMake.
 # NO_RUNTIME: When added, this target will be built without the runtime library
 #     support.
+# SHARED: When added, the module is additionally built into a shared library
+#     target ${NAME}_shared exporting `iree_vm_dynamic_module_create` that can
+#     be loaded at runtime with iree_vm_dynamic_module_load_from_file.
 #
 # Note:
 # By default, iree_c_module will create a library named ${NAME},
@@ -28,7 +31,7 @@
 function(iree_c_module)
   cmake_parse_arguments(
     _RULE
-    "TESTONLY;NO_RUNTIME"
+    "TESTONLY;NO_RUNTIME;SHARED"
     "NAME;SRC;H_FILE_OUTPUT;COMPILE_TOOL;STATIC_LIB_PATH"
     "FLAGS"
     ${ARGN}
@@ -62,6 +65,9 @@ function(iree_c_module)
 
   set(_ARGS "--output-format=vm-c")
   list(APPEND _ARGS "${_RULE_FLAGS}")
+  if(_RULE_SHARED)
+    list(APPEND _ARGS "--iree-vm-c-module-dynamic-export")
+  endif()
   list(APPEND _ARGS "${_SRC_PATH}")
   list(APPEND _ARGS "-o")
   list(APPEND _ARGS "${_RULE_H_FILE_OUTPUT}")
@@ -102,6 +108,41 @@ function(iree_c_module)
       iree_defs
   )
 
+  if(_RULE_SHARED)
+    # The library statically links the parts of the runtime it uses and
+    # resolves the builtin types against the hosting instance on creation.
+    set(_SHARED_NAME "${_PACKAGE_NAME}_${_RULE_NAME}_shared")
+    add_library(${_SHARED_NAME} SHARED
+      "${IREE_SOURCE_DIR}/runtime/src/iree/vm/module_impl_emitc.c"
+      "${_RULE_H_FILE_OUTPUT}"
+    )
+    target_include_directories(${_SHARED_NAME}
+      PRIVATE
+        "${CMAKE_CURRENT_BINARY_DIR}"
+    )
+    target_compile_definitions(${_SHARED_NAME}
+      PRIVATE
+        "EMITC_IMPLEMENTATION=\"${_RULE_H_FILE_OUTPUT}\""
+    )
+    target_compile_options(${_SHARED_NAME} PRIVATE ${IREE_DEFAULT_COPTS})
+    target_link_libraries(${_SHARED_NAME}
+      PRIVATE
+        iree_defs
+        iree::vm
+        iree::vm::dynamic::api
+        iree::vm::ops
+        iree::vm::ops_emitc
+        iree::vm::shims_emitc
+    )
+    set_target_properties(${_SHARED_NAME}
+      PROPERTIES
+        WINDOWS_EXPORT_ALL_SYMBOLS ON
+        PREFIX ""
+        OUTPUT_NAME "${_RULE_NAME}"
+    )
+    add_library(${_PACKAGE_NS}::${_RULE_NAME}_shared ALIAS ${_SHARED_NAME})
+  endif()
+
   if(_RULE_NO_RUNTIME)
     return()
   endif()
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+
+# Copyright 2025 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Measures how llvm-cpu compile time scales with codegen partitions.
+
+Generates a program with many distinct dispatches (which are linked into a
+single executable by default) and compiles it with a range of
+--iree-llvmcpu-codegen-partitions= values. Each configuration is also compiled
+with threading disabled to verify that the output only depends on the
+partition count and not on how many threads were used.
+
+Example usage:
+  $ python3 benchmark_llvmcpu_codegen_partitions.py \
+    --iree-compile=../iree-build/tools/iree-compile \
+    --dispatch-count=256 \
+    --partitions=1,2,4,8,16
+"""
+
+import argparse
+import hashlib
+import os
+import subprocess
+import tempfile
+import time
+
+
+def parse_arguments():
+    """Parses command line arguments."""
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--iree-compile",
+        default="iree-compile",
+        help="Path to the iree-compile tool.",
+    )
+    parser.add_argument(
+        "--dispatch-count",
+        type=int,
+        default=128,
+        help="Number of distinct dispatches in the generated program.",
+    )
+    parser.add_argument(
+        "--partitions",
+        default="1,2,4,8",
+        help="Comma-separated list of partition counts to compile with.",
+    )
+    parser.add_argument(
+        "--repetitions",
+        type=int,
+        default=3,
+        help="Number of times each configuration is compiled; the fastest is "
+        "reported.",
+    )
+    parser.add_argument(
+        "--skip-determinism-check",
+        action="store_true",
+        help="Skips compiling with threading disabled to verify the output.",
+    )
+    return parser.parse_args()
+
+
+def generate_program(dispatch_count):
+    """Returns MLIR with |dispatch_count| dispatches that will not be deduped.
+
+    Each dispatch operates on a different static shape so that they all end up
+    as unique functions with a non-trivial amount of code to generate.
+    """
+
+    lines = []
+    for i in range(dispatch_count):
+        rows = 16 + i
+        lines.append(
+            f"""
+func.func @dispatch_{i}(%lhs: tensor<{rows}x67xf32>,
+                        %rhs: tensor<{rows}x67xf32>) -> tensor<{rows}x67xf32> {{
+  %init = tensor.empty() : tensor<{rows}x67xf32>
+  %0 = linalg.generic {{
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}}
+      ins(%lhs, %rhs : tensor<{rows}x67xf32>, tensor<{rows}x67xf32>)
+      outs(%init : tensor<{rows}x67xf32>) {{
+  ^bb0(%a: f32, %b: f32, %out: f32):
+    %e = math.exp %a : f32
+    %t = math.tanh %b : f32
+    %m = arith.mulf %e, %t : f32
+    %r = math.rsqrt %m : f32
+    linalg.yield %r : f32
+  }} -> tensor<{rows}x67xf32>
+  return %0 : tensor<{rows}x67xf32>
+}}
+"""
+        )
+    return "\n".join(lines)
+
+
+def compile_program(args, source_path, output_path, partitions, threaded):
+    """Compiles the program and returns the wall time in seconds."""
+
+    command = [
+        args.iree_compile,
+        source_path,
+        "--iree-hal-target-device=local",
+        "--iree-hal-local-target-device-backends=llvm-cpu",
+        "--iree-llvmcpu-target-cpu=host",
+        f"--iree-llvmcpu-codegen-partitions={partitions}",
+        "-o",
+        output_path,
+    ]
+    if not threaded:
+        command.append("--mlir-disable-threading")
+    start_time = time.perf_counter()
+    subprocess.run(command, check=True)
+    return time.perf_counter() - start_time
+
+
+def hash_file(path):
+    with open(path, "rb") as f:
+        return hashlib.sha256(f.read()).hexdigest()
+
+
+def main(args):
+    partition_counts = [int(value) for value in args.partitions.split(",")]
+    with tempfile.TemporaryDirectory() as temp_dir:
+        source_path = os.path.join(temp_dir, "program.mlir")
+        with open(source_path, "w") as f:
+            f.write(generate_program(args.dispatch_count))
+
+        print(f"{'partitions':>10} {'seconds':>10} {'speedup':>10} {'output':>16}")
+        baseline_seconds = None
+        for partitions in partition_counts:
+            output_path = os.path.join(temp_dir, f"program_{partitions}.vmfb")
+            seconds = min(
+                compile_program(
+                    args, source_path, output_path, partitions, threaded=True
+                )
+                for _ in range(args.repetitions)
+            )
+            if baseline_seconds is None:
+                baseline_seconds = seconds
+            output_hash = hash_file(output_path)
+
+            if not args.skip_determinism_check:
+                serial_output_path = os.path.join(
+                    temp_dir, f"program_{partitions}_serial.vmfb"
+                )
+                compile_program(
+                    args, source_path, serial_output_path, partitions, threaded=False
+                )
+                if hash_file(serial_output_path) != output_hash:
+                    raise RuntimeError(
+                        f"output with {partitions} partitions differs when "
+                        "compiled with threading disabled"
+                    )
+
+            print(
+                f"{partitions:>10} {seconds:>10.2f} "
+                f"{baseline_seconds / seconds:>9.2f}x {output_hash[:16]:>16}"
+            )
+
+
+if __name__ == "__main__":
+    main(parse_arguments())
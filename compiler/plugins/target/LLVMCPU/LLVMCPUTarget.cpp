@@ -35,7 +35,10 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Linker/Linker.h"
+#include "llvm/Support/MemoryBufferRef.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "mlir/Dialect/ArmNeon/ArmNeonDialect.h"
 #include "mlir/Dialect/ArmSME/IR/ArmSME.h"
 #include "mlir/Dialect/ArmSVE/IR/ArmSVEDialect.h"
@@ -45,6 +48,7 @@
 #include "mlir/Dialect/Transform/IR/TransformDialect.h"
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/DialectResourceBlobManager.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Target/LLVMIR/Dialect/ArmSME/ArmSMEToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Dialect/ArmSVE/ArmSVEToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Dialect/Builtin/BuiltinToLLVMIRTranslation.h"
@@ -103,6 +107,73 @@ static void fixupVisibility(llvm::Module &module,
   }
 }
 
+// Compiles |module| to one object file per partition in |objectFiles|.
+// When |partitionCount| is greater than 1 the module is split and each
+// partition is loaded into its own LLVM context and compiled concurrently on
+// the MLIR context thread pool (if threading is enabled). The partitioning only
+// depends on the module contents and the partition count and the object files
+// are returned in partition order so the output is deterministic.
+static LogicalResult
+emitObjectFiles(Location loc, const LLVMTarget &target,
+                llvm::TargetMachine &targetMachine, llvm::Module &module,
+                unsigned partitionCount,
+                SmallVectorImpl<std::string> &objectFiles) {
+  if (partitionCount <= 1) {
+    std::string objectData;
+    if (failed(runEmitObjFilePasses(&targetMachine, &module,
+                                    llvm::CodeGenFileType::ObjectFile,
+                                    &objectData))) {
+      return failure();
+    }
+    objectFiles.push_back(std::move(objectData));
+    return success();
+  }
+
+  // Splitting modifies the module it splits (such as externalizing locals
+  // referenced across partitions) so we split a clone and leave |module|
+  // intact for any later uses (such as assembly dumps).
+  std::unique_ptr<llvm::Module> splitModule = llvm::CloneModule(module);
+
+  // Round-trip each partition through bitcode as LLVM contexts (and the
+  // modules within them) cannot be used from multiple threads.
+  SmallVector<SmallString<0>> partitionBitcode;
+  llvm::SplitModule(
+      *splitModule, partitionCount,
+      [&](std::unique_ptr<llvm::Module> partition) {
+        SmallString<0> &bitcode = partitionBitcode.emplace_back();
+        llvm::raw_svector_ostream os(bitcode);
+        llvm::WriteBitcodeToFile(*partition, os);
+      },
+      /*PreserveLocals=*/false);
+
+  objectFiles.resize(objectFiles.size() + partitionBitcode.size());
+  MutableArrayRef<std::string> partitionObjectFiles =
+      MutableArrayRef<std::string>(objectFiles)
+          .take_back(partitionBitcode.size());
+  return failableParallelForEachN(
+      loc.getContext(), 0, partitionBitcode.size(),
+      [&](size_t i) -> LogicalResult {
+        llvm::LLVMContext context;
+        auto partition = llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef(partitionBitcode[i], "partition"), context);
+        if (!partition) {
+          return mlir::emitError(loc)
+                 << "failed to load codegen partition " << i << ": "
+                 << llvm::toString(partition.takeError());
+        }
+        // Target machines are not thread-safe so each partition needs its own.
+        auto partitionTargetMachine = createTargetMachine(target);
+        if (!partitionTargetMachine) {
+          return mlir::emitError(loc)
+                 << "failed to create target machine for codegen partition "
+                 << i;
+        }
+        return runEmitObjFilePasses(
+            partitionTargetMachine.get(), partition->get(),
+            llvm::CodeGenFileType::ObjectFile, &partitionObjectFiles[i]);
+      });
+}
+
 // Appends the |debugDatabase| to the end of |baseFile| and writes the footer
 // so the runtime can find it.
 static LogicalResult appendDebugDatabase(std::vector<int8_t> &baseFile,
@@ -265,6 +336,27 @@ public:
                                           defaultOptions_.target);
   }
 
+  std::optional<std::string>
+  getSerializationCacheKey(IREE::HAL::ExecutableVariantOp variantOp) override {
+    // Static libraries are written to the output path as a side effect of
+    // serialization and kept linker artifacts are only useful when the linker
+    // actually runs so neither can be served from the cache.
+    auto maybeTarget = getVariantTarget(variantOp);
+    if (!maybeTarget || maybeTarget->linkStatic ||
+        defaultOptions_.keepLinkerArtifacts) {
+      return std::nullopt;
+    }
+    // Everything else that influences codegen is stored in the variant target
+    // configuration and is part of the IR.
+    std::string key;
+    llvm::raw_string_ostream os(key);
+    os << "system-linker=" << defaultOptions_.systemLinkerPath
+       << ";embedded-linker=" << defaultOptions_.embeddedLinkerPath
+       << ";wasm-linker=" << defaultOptions_.wasmLinkerPath
+       << ";codegen-partitions=" << defaultOptions_.codegenPartitionCount;
+    return key;
+  }
+
   LogicalResult serializeExecutable(const SerializationOptions &options,
                                     IREE::HAL::ExecutableVariantOp variantOp,
                                     OpBuilder &executableBuilder) override {
@@ -631,31 +723,36 @@ public:
 
     SmallVector<Artifact> objectFiles;
 
-    // Emit the base object file containing the bulk of our code.
-    // This must come first such that we have the proper library linking order.
+    // Emit the base object files containing the bulk of our code.
+    // These must come first such that we have the proper library linking
+    // order.
     {
-      // NOTE: today we just use a single object file, however if we wanted to
-      // scale code generation and linking we'd want to generate one per
-      // function (or something like that). A single object file is also
-      // instrumental to static library generation (which only supports one
-      // object file per library).
-      std::string objectData;
-      if (failed(runEmitObjFilePasses(targetMachine.get(), llvmModule.get(),
-                                      llvm::CodeGenFileType::ObjectFile,
-                                      &objectData))) {
+      // Large executables (such as when all dispatches have been linked into
+      // one) can be split into multiple partitions that are compiled
+      // concurrently. Static library generation only supports one object file
+      // per library so we always use a single partition there.
+      unsigned partitionCount =
+          target.linkStatic ? 1 : defaultOptions_.codegenPartitionCount;
+      SmallVector<std::string> objectDatas;
+      if (failed(emitObjectFiles(variantOp.getLoc(), target, *targetMachine,
+                                 *llvmModule, partitionCount, objectDatas))) {
         return variantOp.emitError()
                << "failed to compile LLVM-IR module to an object file";
       }
-      if (!options.dumpIntermediatesPath.empty()) {
-        dumpDataToPath(options.dumpIntermediatesPath, options.dumpBaseName,
-                       variantOp.getName(), ".o", objectData);
+      for (auto [index, objectData] : llvm::enumerate(objectDatas)) {
+        if (!options.dumpIntermediatesPath.empty()) {
+          std::string suffix =
+              index == 0 ? ".o" : (".part" + std::to_string(index) + ".o");
+          dumpDataToPath(options.dumpIntermediatesPath, options.dumpBaseName,
+                         variantOp.getName(), suffix, objectData);
+        }
+        auto objectFile = Artifact::createTemporary(libraryName, "o");
+        auto &os = objectFile.outputFile->os();
+        os << objectData;
+        os.flush();
+        os.close();
+        objectFiles.push_back(std::move(objectFile));
       }
-      auto objectFile = Artifact::createTemporary(libraryName, "o");
-      auto &os = objectFile.outputFile->os();
-      os << objectData;
-      os.flush();
-      os.close();
-      objectFiles.push_back(std::move(objectFile));
     }
 
     // Dump assembly listing after optimization, which is just a textual
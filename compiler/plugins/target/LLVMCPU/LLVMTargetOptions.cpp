@@ -503,6 +503,14 @@ void LLVMCPUTargetCLOptions::bindOptions(OptionsBinder &binder) {
       "iree-llvmcpu-keep-linker-artifacts", keepLinkerArtifacts,
       llvm::cl::cat(category),
       llvm::cl::desc("Keep LLVM linker target artifacts (.so/.dll/etc)"));
+  binder.opt<unsigned>(
+      "iree-llvmcpu-codegen-partitions", codegenPartitionCount,
+      llvm::cl::cat(category),
+      llvm::cl::desc(
+          "Splits each executable into this many partitions that are "
+          "compiled to object files concurrently and linked together. The "
+          "output is deterministic for a given partition count regardless of "
+          "the number of compiler threads. Ignored for static libraries."));
 
   // Default device options.
   binder.opt<std::string>("iree-llvmcpu-target-triple", targetTriple,
@@ -599,6 +607,7 @@ LLVMTargetOptions LLVMCPUTargetCLOptions::getTargetOptions() {
   targetOptions.embeddedLinkerPath = embeddedLinkerPath;
   targetOptions.wasmLinkerPath = wasmLinkerPath;
   targetOptions.keepLinkerArtifacts = keepLinkerArtifacts;
+  targetOptions.codegenPartitionCount = codegenPartitionCount;
 
   if (targetTriple.empty()) {
     targetTriple = llvm::sys::getProcessTriple();
@@ -163,6 +163,13 @@ struct LLVMTargetOptions {
 
   // True to keep linker artifacts for debugging.
   bool keepLinkerArtifacts = false;
+
+  // Number of partitions each executable is split into for code generation.
+  // Partitions are compiled concurrently when the MLIR context has threading
+  // enabled. The output only depends on the partition count and not on the
+  // number of threads used. Static libraries are always emitted as a single
+  // partition.
+  unsigned codegenPartitionCount = 1;
 };
 
 // Creates target machine form target options.
@@ -177,6 +184,7 @@ struct LLVMCPUTargetCLOptions {
   std::string embeddedLinkerPath;
   std::string wasmLinkerPath;
   bool keepLinkerArtifacts = false;
+  unsigned codegenPartitionCount = 1;
 
   // Default device options.
   std::string targetTriple;
@@ -184,6 +184,14 @@ matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
              rhsElemType.isSignlessInteger(4) &&
              outElemType.isSignlessInteger(32)) {
     flags = IREE_UK_FLAG_MMT4D_TYPE_S8S4S32;
+  } else if (lhsElemType.isUnsignedInteger(8) &&
+             rhsElemType.isSignlessInteger(8) &&
+             outElemType.isSignlessInteger(32)) {
+    flags = IREE_UK_FLAG_MMT4D_TYPE_U8S8S32;
+  } else if (lhsElemType.isSignlessInteger(4) &&
+             rhsElemType.isSignlessInteger(4) &&
+             outElemType.isSignlessInteger(32)) {
+    flags = IREE_UK_FLAG_MMT4D_TYPE_S4S4S32;
   } else if (lhsElemType.isSignlessInteger(16) &&
              rhsElemType.isSignlessInteger(16) &&
              outElemType.isSignlessInteger(32)) {
@@ -211,6 +219,12 @@ matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
   } else if (lhsElemType.isBF16() && rhsElemType.isBF16() &&
              outElemType.isBF16()) {
     flags = IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16;
+  } else if (isa<Float8E4M3FNType>(lhsElemType) &&
+             isa<Float8E4M3FNType>(rhsElemType) && outElemType.isF32()) {
+    flags = IREE_UK_FLAG_MMT4D_TYPE_F8E4M3FNF8E4M3FNF32;
+  } else if (isa<Float8E5M2Type>(lhsElemType) &&
+             isa<Float8E5M2Type>(rhsElemType) && outElemType.isF32()) {
+    flags = IREE_UK_FLAG_MMT4D_TYPE_F8E5M2F8E5M2F32;
   } else {
     return rewriter.notifyMatchFailure(
         op, "unsupported combination of element types");
@@ -503,6 +517,18 @@ getFlagForUserAndOperandTypes(IREE::Encoding::EncodingAttr encoding,
   } else if (lhs.isSignlessInteger(8) && rhs.isSignlessInteger(8) &&
              out.isSignlessInteger(32)) {
     return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I8I8I32;
+  } else if (lhs.isUnsignedInteger(8) && rhs.isSignlessInteger(8) &&
+             out.isSignlessInteger(32)) {
+    return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_U8S8S32;
+  } else if (lhs.isSignlessInteger(4) && rhs.isSignlessInteger(4) &&
+             out.isSignlessInteger(32)) {
+    return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I4I4I32;
+  } else if (isa<Float8E4M3FNType>(lhs) && isa<Float8E4M3FNType>(rhs) &&
+             out.isF32()) {
+    return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F8E4M3FNF8E4M3FNF32;
+  } else if (isa<Float8E5M2Type>(lhs) && isa<Float8E5M2Type>(rhs) &&
+             out.isF32()) {
+    return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F8E5M2F8E5M2F32;
   } else {
     return IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_NONE;
   }
@@ -597,3 +597,83 @@ func.func @mmt4d_i16u4i32_extend_producers(%arg0: tensor<10x10x1x8xi16>, %arg1:
 // CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
 // CHECK-SAME:       outs(%[[ARG2]] :
 //      CHECK:   return %[[MICRO_KERNEL]]#0
+
+// -----
+
+func.func @mmt4d_u8i8i32_extend_producers(%arg0: tensor<10x10x16x4xi8>, %arg1: tensor<10x10x16x4xi8>, %arg2: tensor<10x10x16x16xi32>) -> tensor<10x10x16x16xi32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features="+avx512vnni"}>
+} {
+  %0 = tensor.empty() : tensor<10x10x16x4xi32>
+  %1 = linalg.generic {indexing_maps = [affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>,
+                                        affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>],
+                        iterator_types = ["parallel", "parallel", "parallel", "parallel"]}
+                        ins(%arg0 : tensor<10x10x16x4xi8>) outs(%0 : tensor<10x10x16x4xi32>) {
+  ^bb0(%in: i8, %out: i32):
+    %5 = arith.extui %in : i8 to i32
+    linalg.yield %5 : i32
+  } -> tensor<10x10x16x4xi32>
+  %2 = linalg.generic {indexing_maps = [affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>,
+                                        affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>],
+                        iterator_types = ["parallel", "parallel", "parallel", "parallel"]}
+                        ins(%arg1 : tensor<10x10x16x4xi8>) outs(%0 : tensor<10x10x16x4xi32>) {
+  ^bb0(%in: i8, %out: i32):
+    %5 = arith.extsi %in : i8 to i32
+    linalg.yield %5 : i32
+  } -> tensor<10x10x16x4xi32>
+  %3 = linalg.mmt4d ins(%1, %2 : tensor<10x10x16x4xi32>, tensor<10x10x16x4xi32>) outs(%arg2 : tensor<10x10x16x16xi32>) -> tensor<10x10x16x16xi32>
+  return %3 : tensor<10x10x16x16xi32>
+}
+// CHECK-LABEL: func @mmt4d_u8i8i32_extend_producers(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<10x10x16x4xi8>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<10x10x16x4xi8>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<10x10x16x16xi32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 779 : i32
+//      CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "iree_uk_mmt4d"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+// CHECK-SAME:       outs(%[[ARG2]] :
+// CHECK-SAME:       %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]#0
+
+// -----
+
+func.func @mmt4d_i4i4i32(%arg0 : tensor<?x?x16x8xi4>, %arg1 : tensor<?x?x16x8xi4>,
+    %arg2 : tensor<?x?x16x16xi32>) -> tensor<?x?x16x16xi32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features="+avx512vnni"}>
+} {
+  %0 = linalg.mmt4d ins(%arg0, %arg1 : tensor<?x?x16x8xi4>, tensor<?x?x16x8xi4>)
+      outs(%arg2 : tensor<?x?x16x16xi32>) -> tensor<?x?x16x16xi32>
+  return %0 : tensor<?x?x16x16xi32>
+}
+// CHECK-LABEL: func @mmt4d_i4i4i32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x16x8xi4>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x16x8xi4>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x16x16xi32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 780 : i32
+//  CHECK-DAG:   %[[C8_i32:.+]] = arith.constant 8 : i32
+//  CHECK-DAG:   %[[C16_i32:.+]] = arith.constant 16 : i32
+//      CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "iree_uk_mmt4d"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+// CHECK-SAME:       outs(%[[ARG2]] :
+// CHECK-SAME:       %[[C16_i32]], %[[C16_i32]], %[[C8_i32]], %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]#0
+
+// -----
+
+func.func @mmt4d_f8E4M3FNf8E4M3FNf32(%arg0 : tensor<?x?x16x1xf8E4M3FN>, %arg1 : tensor<?x?x16x1xf8E4M3FN>,
+    %arg2 : tensor<?x?x16x16xf32>) -> tensor<?x?x16x16xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features="+avx512f"}>
+} {
+  %0 = linalg.mmt4d ins(%arg0, %arg1 : tensor<?x?x16x1xf8E4M3FN>, tensor<?x?x16x1xf8E4M3FN>)
+      outs(%arg2 : tensor<?x?x16x16xf32>) -> tensor<?x?x16x16xf32>
+  return %0 : tensor<?x?x16x16xf32>
+}
+// CHECK-LABEL: func @mmt4d_f8E4M3FNf8E4M3FNf32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?x16x1xf8E4M3FN>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?x16x1xf8E4M3FN>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<?x?x16x16xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 781 : i32
+//      CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "iree_uk_mmt4d"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
+// CHECK-SAME:       outs(%[[ARG2]] :
+// CHECK-SAME:       %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]#0
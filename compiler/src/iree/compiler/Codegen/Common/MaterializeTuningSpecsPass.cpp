@@ -278,4 +278,7 @@ struct MaterializeTuningSpecsPass final
 };
 
 } // namespace
+
+bool isUserTuningSpecRequested() { return !clCodegenTuningSpecPath.empty(); }
+
 } // namespace mlir::iree_compiler
@@ -57,6 +57,10 @@ void addEncodingToNopPasses(FunctionLikeNest &passManager);
 /// which these nested tuning specs appear in the IR.
 FailureOr<transform::NamedSequenceOp> linkTuningSpecs(ModuleOp module);
 
+/// Returns true if a tuning spec was passed with
+/// `--iree-codegen-tuning-spec-path`.
+bool isUserTuningSpecRequested();
+
 //------------------------------------------------------------------------------
 // Wrappers that not use tablegen options. See Passes.td for details.
 //------------------------------------------------------------------------------
@@ -6,6 +6,8 @@
 
 #include "iree/compiler/Codegen/Dialect/CPU/IR/IREECPUDialect.h"
 
+#include <utility>
+
 #include "iree/compiler/Codegen/Dialect/CPU/IR/IREECPUDialect.cpp.inc"
 #include "iree/compiler/Codegen/Dialect/CPU/IR/IREECPUTypes.h"
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenDialect.h"
@@ -29,4 +31,16 @@ void IREECPUDialect::initialize() {
   addInterfaces<IREECPUDialectOpAsmInterface>();
 }
 
+void IREECPUDialect::recordProfileGuidedTuningSequence(StringRef dispatchName,
+                                                       std::string sequence) {
+  std::lock_guard<std::mutex> guard(profileGuidedTuningSequencesMutex);
+  profileGuidedTuningSequences[dispatchName.str()] = std::move(sequence);
+}
+
+std::map<std::string, std::string>
+IREECPUDialect::takeProfileGuidedTuningSequences() {
+  std::lock_guard<std::mutex> guard(profileGuidedTuningSequencesMutex);
+  return std::exchange(profileGuidedTuningSequences, {});
+}
+
 } // namespace mlir::iree_compiler::IREE::CPU
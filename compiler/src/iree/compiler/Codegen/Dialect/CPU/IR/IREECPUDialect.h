@@ -7,6 +7,10 @@
 #ifndef IREE_COMPILER_CODEGEN_DIALECT_CPU_IREECPUDIALECT_H_
 #define IREE_COMPILER_CODEGEN_DIALECT_CPU_IREECPUDIALECT_H_
 
+#include <map>
+#include <mutex>
+#include <string>
+
 #include "mlir/IR/Dialect.h"
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/TypeID.h"
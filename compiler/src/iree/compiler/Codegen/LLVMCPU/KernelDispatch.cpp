@@ -12,6 +12,7 @@
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenInterfaces.h"
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenTypes.h"
 #include "iree/compiler/Codegen/Interfaces/PartitionableLoopsInterface.h"
+#include "iree/compiler/Codegen/LLVMCPU/ProfileGuidedTiling.h"
 #include "iree/compiler/Codegen/LLVMCPU/TargetMLTransformInfo.h"
 #include "iree/compiler/Codegen/LLVMCPU/Utils.h"
 #include "iree/compiler/Codegen/Utils/CPUUtils.h"
@@ -3023,8 +3024,10 @@ setRootConfigImpl(mlir::FunctionOpInterface entryPointFn, Operation *op,
   auto result =
       TypeSwitch<Operation *, LogicalResult>(op)
           .Case<IREE::LinalgExt::CustomOp>([&](auto op) {
-            return setDefaultCustomOpLoweringConfig(entryPointFn, op,
-                                                    initCPULaunchConfig);
+            return setDefaultCustomOpLoweringConfig(
+                entryPointFn, op, [](FunctionOpInterface funcOp) {
+                  return initCPULaunchConfig(funcOp);
+                });
           })
           .Case<IREE::LinalgExt::AttentionOp, IREE::LinalgExt::FftOp,
                 linalg::PackOp, tensor::PadOp, linalg::UnPackOp,
@@ -3861,10 +3864,77 @@ static bool shouldSetLoweringConfig(Operation *op) {
   return true;
 }
 
+/// Scales the distribution tile sizes of `rootOp` for the profile-guided tile
+/// size `candidate`. Sizes that would fall below, or stop being a multiple of,
+/// the vector tile sizes are kept as-is, and the cache level tiles are clamped
+/// to the new distribution tiles.
+static void applyProfileGuidedTileCandidate(Operation *rootOp,
+                                            int64_t candidate) {
+  auto tilingInterfaceOp = dyn_cast<TilingInterface>(rootOp);
+  auto loweringConfig =
+      getLoweringConfig<IREE::CPU::LoweringConfigAttr>(rootOp);
+  int64_t scaleLog2 = getProfileGuidedTileScaleLog2(candidate);
+  if (!tilingInterfaceOp || !loweringConfig || scaleLog2 == 0) {
+    return;
+  }
+
+  SmallVector<IREE::CPU::LoweringConfigLevelInfo> tilingInfo =
+      loweringConfig.getAvailableTilingInfo();
+  auto findLevel = [&](IREE::CPU::TilingLevel level)
+      -> IREE::CPU::LoweringConfigLevelInfo * {
+    auto it = llvm::find_if(tilingInfo, [&](auto &info) {
+      return info.level == level;
+    });
+    return it == tilingInfo.end() ? nullptr : &*it;
+  };
+  IREE::CPU::LoweringConfigLevelInfo *distInfo =
+      findLevel(IREE::CPU::TilingLevel::DistributionTiles);
+  if (!distInfo) {
+    return;
+  }
+  IREE::CPU::LoweringConfigLevelInfo *cacheInfo =
+      findLevel(IREE::CPU::TilingLevel::CacheParallelTiles);
+  IREE::CPU::LoweringConfigLevelInfo *vecInfo =
+      findLevel(IREE::CPU::TilingLevel::VectorCommonParallelTiles);
+
+  SmallVector<int64_t> lbs, ubs;
+  getRangeBounds(tilingInterfaceOp, lbs, ubs);
+  SmallVector<int64_t> &distSizes = distInfo->sizes;
+  for (auto idx : llvm::seq<size_t>(0, distSizes.size())) {
+    int64_t size = distSizes[idx];
+    bool scalable = idx < distInfo->scalableFlags.size() &&
+                    distInfo->scalableFlags[idx];
+    if (size == 0 || scalable) {
+      continue;
+    }
+    int64_t newSize = scaleLog2 > 0 ? size << scaleLog2 : size >> -scaleLog2;
+    if (idx < ubs.size() && ShapedType::isStatic(ubs[idx])) {
+      newSize = std::min(newSize, ubs[idx]);
+    }
+    int64_t vecSize = vecInfo ? vecInfo->sizes[idx] : 1;
+    if (newSize == 0 || (vecSize && newSize % vecSize != 0)) {
+      continue;
+    }
+    if (cacheInfo && cacheInfo->sizes[idx]) {
+      cacheInfo->sizes[idx] = cacheInfo->sizes[idx] == size
+                                  ? newSize
+                                  : std::min(cacheInfo->sizes[idx], newSize);
+    }
+    distSizes[idx] = newSize;
+  }
+
+  LDBG() << "Profile-guided tile candidate " << candidate
+         << " distribution tile sizes: " << distSizes;
+  setLoweringConfig(rootOp,
+                    getNewLoweringConfig(rootOp->getContext(), tilingInfo,
+                                         /*setDistributionConfig=*/true));
+}
+
 /// Sets the translation information to use for a dispatch region.
 static LogicalResult
 setTranslationInfoAndRootConfig(mlir::FunctionOpInterface entryPointFn,
-                                ArrayRef<Operation *> computeOps) {
+                                ArrayRef<Operation *> computeOps,
+                                ArrayRef<DispatchProfile> dispatchProfiles) {
   // Make sure that lowering_config is not preset on any compute ops.
   for (auto computeOp : computeOps) {
     if (getLoweringConfig(computeOp))
@@ -3895,6 +3965,15 @@ setTranslationInfoAndRootConfig(mlir::FunctionOpInterface entryPointFn,
   // Ignore the tile sizes adjustment.
   auto pipeline = getTranslationInfo(entryPointFn).getPassPipeline().getValue();
   if (pipeline != DispatchLoweringPassPipeline::TransformDialectCodegen) {
+    std::optional<int64_t> tileCandidate;
+    if (failed(selectProfileGuidedTileCandidate(entryPointFn, dispatchProfiles,
+                                                tileCandidate))) {
+      return failure();
+    }
+    if (tileCandidate) {
+      applyProfileGuidedTileCandidate(rootOperation, *tileCandidate);
+    }
+
     if (failed(adjustTileSizesForRootUnPackOp(entryPointFn, rootOperation))) {
       return failure();
     }
@@ -3905,12 +3984,18 @@ setTranslationInfoAndRootConfig(mlir::FunctionOpInterface entryPointFn,
                                               rootOperation))) {
       return failure();
     }
+
+    if (tileCandidate &&
+        failed(recordProfileGuidedConfig(entryPointFn, rootOperation))) {
+      return failure();
+    }
   }
 
   return success();
 }
 
-LogicalResult initCPULaunchConfig(FunctionOpInterface funcOp) {
+LogicalResult initCPULaunchConfig(FunctionOpInterface funcOp,
+                                  ArrayRef<DispatchProfile> dispatchProfiles) {
   if (getTranslationInfo(funcOp)) {
     return success();
   }
@@ -3922,7 +4007,8 @@ LogicalResult initCPULaunchConfig(FunctionOpInterface funcOp) {
   }
 
   SmallVector<Operation *> computeOps = getComputeOps(funcOp);
-  if (failed(setTranslationInfoAndRootConfig(funcOp, computeOps))) {
+  if (failed(setTranslationInfoAndRootConfig(funcOp, computeOps,
+                                             dispatchProfiles))) {
     return failure();
   }
 
@@ -8,12 +8,17 @@
 #define IREE_COMPILER_CODEGEN_LLVMCPU_KERNELDISPATCH_H_
 
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenAttrs.h"
+#include "iree/compiler/Codegen/LLVMCPU/ProfileGuidedTiling.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/Interfaces/FunctionInterfaces.h"
 
 namespace mlir::iree_compiler {
 
-LogicalResult initCPULaunchConfig(FunctionOpInterface funcOp);
+/// Sets the translation info and lowering configurations of `funcOp`. The tile
+/// sizes of hot dispatches are refined with `dispatchProfiles`, if any.
+LogicalResult
+initCPULaunchConfig(FunctionOpInterface funcOp,
+                    ArrayRef<DispatchProfile> dispatchProfiles = {});
 
 } // namespace mlir::iree_compiler
 
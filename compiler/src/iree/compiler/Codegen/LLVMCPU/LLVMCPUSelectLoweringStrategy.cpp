@@ -34,7 +34,21 @@ public:
         .insert<IREE::CPU::IREECPUDialect, IREE::Codegen::IREECodegenDialect>();
   }
 
+  LogicalResult initialize(MLIRContext *context) override {
+    // The profiles are loaded once and shared by the clones of the pass that
+    // configure functions in parallel.
+    auto profiles = std::make_shared<SmallVector<DispatchProfile>>();
+    if (failed(loadDispatchProfiles(context, *profiles))) {
+      return failure();
+    }
+    dispatchProfiles = std::move(profiles);
+    return success();
+  }
+
   void runOnOperation() override;
+
+private:
+  std::shared_ptr<const SmallVector<DispatchProfile>> dispatchProfiles;
 };
 } // namespace
 
@@ -234,7 +248,7 @@ void LLVMCPUSelectLoweringStrategyPass::runOnOperation() {
   mlir::ModuleOp moduleOp = getOperation();
   for (auto funcOp : moduleOp.getOps<FunctionOpInterface>()) {
     // Set the strategy with default heuristics.
-    if (failed(initCPULaunchConfig(funcOp))) {
+    if (failed(initCPULaunchConfig(funcOp, *dispatchProfiles))) {
       funcOp.emitOpError("failed to set lowering configuration");
       return signalPassFailure();
     }
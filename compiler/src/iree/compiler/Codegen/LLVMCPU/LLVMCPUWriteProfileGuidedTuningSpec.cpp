@@ -0,0 +1,29 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Codegen/LLVMCPU/Passes.h"
+#include "iree/compiler/Codegen/LLVMCPU/ProfileGuidedTiling.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir::iree_compiler {
+
+#define GEN_PASS_DEF_LLVMCPUWRITEPROFILEGUIDEDTUNINGSPECPASS
+#include "iree/compiler/Codegen/LLVMCPU/Passes.h.inc"
+
+namespace {
+
+struct LLVMCPUWriteProfileGuidedTuningSpecPass
+    : public impl::LLVMCPUWriteProfileGuidedTuningSpecPassBase<
+          LLVMCPUWriteProfileGuidedTuningSpecPass> {
+  void runOnOperation() override {
+    if (failed(writeProfileGuidedTuningSpec(getOperation()))) {
+      return signalPassFailure();
+    }
+  }
+};
+
+} // namespace
+} // namespace mlir::iree_compiler
@@ -12,6 +12,7 @@
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenAttrs.h"
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenInterfaces.h"
 #include "iree/compiler/Codegen/LLVMCPU/Passes.h"
+#include "iree/compiler/Codegen/LLVMCPU/ProfileGuidedTiling.h"
 #include "iree/compiler/Dialect/LinalgExt/Transforms/Passes.h"
 #include "iree/compiler/Dialect/Util/Transforms/Passes.h"
 #include "iree/compiler/Utils/PassUtils.h"
@@ -659,6 +660,11 @@ void buildLLVMCPUCodegenConfigurationPassPipelineImpl(
     addCommonTargetExecutablePreprocessingPasses(funcPassManager,
                                                  clUseSoftmaxInterFusion);
   }
+  // Tuning specs are only used to reapply profile-guided configurations on
+  // CPU, so they are not materialized unless one was passed in.
+  if (isUserTuningSpecRequested()) {
+    modulePassManager.addPass(createMaterializeTuningSpecsPass());
+  }
   modulePassManager.addPass(createMaterializeUserConfigsPass());
   FunctionLikeNest(modulePassManager)
       .addPass(createMaterializeDeviceEncodingPass)
@@ -722,6 +728,12 @@ void buildLLVMCPUCodegenPassPipeline(OpPassManager &variantPassManager,
 // hal.executable ops.
 void buildLLVMCPULinkingPassPipeline(OpPassManager &modulePassManager,
                                      std::optional<std::string> target) {
+  // Profile-guided configurations are recorded while configuring each
+  // executable and written out once for the whole program.
+  if (isProfileGuidedTuningSpecRequested()) {
+    modulePassManager.addPass(createLLVMCPUWriteProfileGuidedTuningSpecPass());
+  }
+
   // Link together executables. This may produce some IR duplication.
   LLVMCPULinkExecutablesPassOptions linkOptions;
   linkOptions.target = target.value_or("");
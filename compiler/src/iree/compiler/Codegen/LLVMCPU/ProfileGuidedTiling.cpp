@@ -0,0 +1,377 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Codegen/LLVMCPU/ProfileGuidedTiling.h"
+
+#include <map>
+
+#include "iree/compiler/Codegen/Dialect/CPU/IR/IREECPUDialect.h"
+#include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenAttrs.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/DebugLog.h"
+#include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/AsmState.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Support/FileUtilities.h"
+#include "mlir/Transforms/RegionUtils.h"
+
+#define DEBUG_TYPE "iree-llvmcpu-profile-guided-tiling"
+
+namespace mlir::iree_compiler {
+
+static llvm::cl::list<std::string> clPGODispatchProfiles(
+    "iree-llvmcpu-pgo-dispatch-profiles",
+    llvm::cl::desc(
+        "Comma separated list of per-dispatch CSV profiles. Profile N is "
+        "expected to have been measured with tile candidate N; profile 0 "
+        "decides which dispatches are hot."),
+    llvm::cl::CommaSeparated);
+
+static llvm::cl::opt<int> clPGOTileCandidate(
+    "iree-llvmcpu-pgo-tile-candidate",
+    llvm::cl::desc(
+        "Forces the tile size candidate to use for hot dispatches (or all "
+        "dispatches when no profile is given). -1 picks the fastest candidate "
+        "from the profiles."),
+    llvm::cl::init(-1));
+
+static llvm::cl::opt<float> clPGOHotDispatchThreshold(
+    "iree-llvmcpu-pgo-hot-dispatch-threshold",
+    llvm::cl::desc("Fraction of the total time in profile 0 a dispatch needs "
+                   "to take to be considered hot."),
+    llvm::cl::init(0.02f));
+
+static llvm::cl::opt<std::string> clPGOTuningSpecOutput(
+    "iree-llvmcpu-pgo-tuning-spec-output",
+    llvm::cl::desc("Writes the profile-guided configurations to a tuning spec "
+                   "consumable with `--iree-codegen-tuning-spec-path`."),
+    llvm::cl::init(""));
+
+static llvm::cl::opt<std::string> clPGOTuningSpecName(
+    "iree-llvmcpu-pgo-tuning-spec-name",
+    llvm::cl::desc("Symbol name of the tuning spec module written with "
+                   "`--iree-llvmcpu-pgo-tuning-spec-output`."),
+    llvm::cl::init("iree_llvmcpu_pgo_tuning_spec"));
+
+//===----------------------------------------------------------------------===//
+// Profile loading
+//===----------------------------------------------------------------------===//
+
+static SmallVector<StringRef> splitCSVRow(StringRef row) {
+  SmallVector<StringRef> fields;
+  row.split(fields, ',');
+  for (StringRef &field : fields) {
+    field = field.trim();
+    if (field.size() >= 2 && field.front() == '"' && field.back() == '"') {
+      field = field.drop_front().drop_back();
+    }
+  }
+  return fields;
+}
+
+static LogicalResult loadDispatchProfile(StringRef path,
+                                         DispatchProfile &profile,
+                                         std::string &errorMessage) {
+  std::unique_ptr<llvm::MemoryBuffer> buffer =
+      mlir::openInputFile(path, &errorMessage);
+  if (!buffer) {
+    return failure();
+  }
+  llvm::line_iterator lineIt(*buffer, /*SkipBlanks=*/true);
+  if (lineIt.is_at_eof()) {
+    errorMessage = "empty dispatch profile";
+    return failure();
+  }
+
+  SmallVector<StringRef> header = splitCSVRow(*lineIt);
+  auto findColumn = [&](StringRef name) -> std::optional<size_t> {
+    auto it = llvm::find(header, name);
+    if (it == header.end()) {
+      return std::nullopt;
+    }
+    return std::distance(header.begin(), it);
+  };
+  std::optional<size_t> nameColumn = findColumn("name");
+  std::optional<size_t> totalColumn = findColumn("total_ns");
+  std::optional<size_t> countColumn = findColumn("counts");
+  if (!nameColumn || !totalColumn) {
+    errorMessage = "dispatch profile header requires `name` and `total_ns`";
+    return failure();
+  }
+
+  for (++lineIt; !lineIt.is_at_eof(); ++lineIt) {
+    SmallVector<StringRef> fields = splitCSVRow(*lineIt);
+    if (fields.size() != header.size()) {
+      errorMessage = ("malformed row at line " +
+                      Twine(lineIt.line_number()) + ": " + *lineIt)
+                         .str();
+      return failure();
+    }
+    int64_t totalNs = 0;
+    int64_t count = 1;
+    if (fields[*totalColumn].getAsInteger(10, totalNs) ||
+        (countColumn && fields[*countColumn].getAsInteger(10, count))) {
+      errorMessage =
+          ("invalid timing at line " + Twine(lineIt.line_number())).str();
+      return failure();
+    }
+    DispatchProfile::Timing &timing = profile.timings[fields[*nameColumn]];
+    timing.totalNs += totalNs;
+    timing.count += count;
+    profile.totalNs += totalNs;
+  }
+  return success();
+}
+
+LogicalResult loadDispatchProfiles(MLIRContext *context,
+                                   SmallVectorImpl<DispatchProfile> &profiles) {
+  profiles.clear();
+  if (clPGODispatchProfiles.size() > kNumProfileGuidedTileCandidates) {
+    return emitError(UnknownLoc::get(context))
+           << "expected at most " << kNumProfileGuidedTileCandidates
+           << " dispatch profiles, got " << clPGODispatchProfiles.size();
+  }
+  for (const std::string &path : clPGODispatchProfiles) {
+    std::string errorMessage;
+    if (failed(loadDispatchProfile(path, profiles.emplace_back(),
+                                   errorMessage))) {
+      return emitError(UnknownLoc::get(context))
+             << "failed to load dispatch profile " << path << ": "
+             << errorMessage;
+    }
+  }
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Candidate selection
+//===----------------------------------------------------------------------===//
+
+int64_t getProfileGuidedTileScaleLog2(int64_t candidate) {
+  // Alternate between growing and shrinking the tiles so that the closest
+  // neighbors of the default configuration are tried first.
+  return candidate % 2 ? (candidate + 1) / 2 : -(candidate / 2);
+}
+
+LogicalResult
+selectProfileGuidedTileCandidate(FunctionOpInterface funcOp,
+                                 ArrayRef<DispatchProfile> profiles,
+                                 std::optional<int64_t> &candidate) {
+  candidate = std::nullopt;
+  int64_t forcedCandidate = clPGOTileCandidate;
+  if (forcedCandidate >= kNumProfileGuidedTileCandidates) {
+    return funcOp.emitError()
+           << "invalid profile-guided tile candidate " << forcedCandidate
+           << "; expected a value below " << kNumProfileGuidedTileCandidates;
+  }
+  if (profiles.empty()) {
+    if (forcedCandidate >= 0) {
+      candidate = forcedCandidate;
+    }
+    return success();
+  }
+
+  // Only dispatches that take a significant part of the baseline are tuned so
+  // that the candidates do not perturb the rest of the program.
+  StringRef name = funcOp.getName();
+  const DispatchProfile &baseline = profiles.front();
+  double hotThresholdNs = clPGOHotDispatchThreshold * baseline.totalNs;
+  auto baselineIt = baseline.timings.find(name);
+  if (baselineIt == baseline.timings.end() ||
+      baselineIt->second.totalNs < hotThresholdNs) {
+    LDBG() << "Skipping cold dispatch " << name;
+    return success();
+  }
+  if (forcedCandidate >= 0) {
+    candidate = forcedCandidate;
+    return success();
+  }
+
+  std::optional<double> bestMeanNs;
+  for (auto [index, profile] : llvm::enumerate(profiles)) {
+    auto it = profile.timings.find(name);
+    if (it == profile.timings.end() || it->second.count == 0) {
+      continue;
+    }
+    double meanNs =
+        static_cast<double>(it->second.totalNs) / it->second.count;
+    LDBG() << "Dispatch " << name << " candidate " << index << ": " << meanNs
+           << "ns";
+    if (!bestMeanNs || meanNs < *bestMeanNs) {
+      bestMeanNs = meanNs;
+      candidate = index;
+    }
+  }
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Tuning spec emission
+//===----------------------------------------------------------------------===//
+
+/// Prints the body of a `transform.iree.match.cast_compatible_dag_from_root`
+/// matcher for `rootOp`. Each distinct operand becomes a block argument.
+static LogicalResult printRootOpMatcher(Operation *rootOp,
+                                        llvm::raw_ostream &os) {
+  // Values captured from above by a region cannot be expressed in the matcher.
+  for (Region &region : rootOp->getRegions()) {
+    llvm::SetVector<Value> capturedValues;
+    getUsedValuesDefinedAbove(region, capturedValues);
+    if (!capturedValues.empty()) {
+      return failure();
+    }
+  }
+
+  llvm::SetVector<Value> operands(rootOp->operand_begin(),
+                                  rootOp->operand_end());
+  SmallVector<Type> operandTypes = llvm::map_to_vector(
+      operands, [](Value operand) { return operand.getType(); });
+
+  // Clone the root op into a detached function so that the operands print as
+  // entry block arguments.
+  OpBuilder builder(rootOp->getContext());
+  auto funcOp = func::FuncOp::create(
+      rootOp->getLoc(), "matcher",
+      builder.getFunctionType(operandTypes, /*results=*/{}));
+  Block *block = funcOp.addEntryBlock();
+  IRMapping mapping;
+  mapping.map(operands.getArrayRef(), block->getArguments());
+  builder.setInsertionPointToStart(block);
+  Operation *clonedOp = builder.clone(*rootOp, mapping);
+  clonedOp->removeAttr(kConfigAttrName);
+
+  os << "^bb0(";
+  llvm::interleaveComma(block->getArguments(), os, [&](BlockArgument arg) {
+    os << "%arg" << arg.getArgNumber() << ": " << arg.getType();
+  });
+  os << "):\n";
+  AsmState asmState(funcOp, OpPrintingFlags().enableDebugInfo(false));
+  clonedOp->print(os, asmState);
+  os << "\n";
+  funcOp.erase();
+  return success();
+}
+
+static std::string getMatcherName(StringRef dispatchName) {
+  std::string name = "match_";
+  for (char c : dispatchName) {
+    name.push_back(llvm::isAlnum(c) ? c : '_');
+  }
+  return name;
+}
+
+bool isProfileGuidedTuningSpecRequested() {
+  return !clPGOTuningSpecOutput.empty();
+}
+
+LogicalResult writeProfileGuidedTuningSpec(ModuleOp moduleOp) {
+  auto *dialect =
+      moduleOp.getContext()->getLoadedDialect<IREE::CPU::IREECPUDialect>();
+  if (!dialect || !isProfileGuidedTuningSpecRequested()) {
+    return success();
+  }
+  std::map<std::string, std::string> sequences =
+      dialect->takeProfileGuidedTuningSequences();
+  if (sequences.empty()) {
+    return success();
+  }
+
+  std::string errorMessage;
+  std::unique_ptr<llvm::ToolOutputFile> file =
+      mlir::openOutputFile(clPGOTuningSpecOutput, &errorMessage);
+  if (!file) {
+    return moduleOp.emitError() << "failed to open tuning spec output "
+                                << clPGOTuningSpecOutput << ": "
+                                << errorMessage;
+  }
+  llvm::raw_ostream &os = file->os();
+  os << "module "
+     << SymbolRefAttr::get(moduleOp.getContext(), clPGOTuningSpecName)
+     << " attributes {"
+     << kTuningSpecDefaultEntrypointAttrName
+     << ", transform.with_named_sequence} {\n";
+  os << "transform.named_sequence @apply_op_config("
+        "%op: !transform.any_op {transform.readonly}, "
+        "%config: !transform.any_param {transform.readonly}) {\n"
+        "  transform.annotate %op \"compilation_info\" = %config : "
+        "!transform.any_op, !transform.any_param\n"
+        "  transform.yield\n"
+        "}\n";
+  for (auto &[dispatchName, sequence] : sequences) {
+    os << sequence;
+  }
+  os << "transform.named_sequence @" << kKernelConfigSpecName
+     << "(%variant_op: !transform.any_op {transform.consumed}) -> "
+        "!transform.any_op attributes {"
+     << kTuningSpecEntrypointAttrName << "} {\n";
+  os << "  %res = transform.foreach_match in %variant_op";
+  llvm::interleaveComma(sequences, os, [&](auto &it) {
+    os << "\n      @" << getMatcherName(it.first) << " -> @apply_op_config";
+  });
+  os << "\n    : (!transform.any_op) -> !transform.any_op\n";
+  os << "  transform.yield %res : !transform.any_op\n";
+  os << "}\n";
+  os << "}\n";
+  file->keep();
+  return success();
+}
+
+LogicalResult recordProfileGuidedConfig(FunctionOpInterface funcOp,
+                                        Operation *rootOp) {
+  if (!isProfileGuidedTuningSpecRequested()) {
+    return success();
+  }
+  auto loweringConfig = getLoweringConfig(rootOp);
+  IREE::Codegen::TranslationInfoAttr translationInfo =
+      getTranslationInfo(funcOp);
+  if (!loweringConfig || !translationInfo) {
+    return success();
+  }
+
+  std::string matcher;
+  llvm::raw_string_ostream matcherOs(matcher);
+  if (failed(printRootOpMatcher(rootOp, matcherOs))) {
+    LDBG() << "Cannot build a matcher for " << *rootOp;
+    return success();
+  }
+
+  auto compilationInfo = IREE::Codegen::CompilationInfoAttr::get(
+      rootOp->getContext(), loweringConfig, translationInfo);
+  std::string sequence;
+  llvm::raw_string_ostream os(sequence);
+  os << "// " << funcOp.getName() << "\n";
+  os << "transform.named_sequence @" << getMatcherName(funcOp.getName())
+     << "(%root: !transform.any_op {transform.readonly}) -> "
+        "(!transform.any_op, !transform.any_param) {\n";
+  os << "  %ins, %outs = transform.iree.match.cast_compatible_dag_from_root "
+        "%root {\n"
+     << matcher << "  } : (!transform.any_op) -> "
+     << "(!transform.any_value, !transform.any_value)\n";
+  os << "  %config = transform.param.constant " << compilationInfo
+     << " -> !transform.any_param\n";
+  os << "  transform.yield %root, %config : "
+        "!transform.any_op, !transform.any_param\n";
+  os << "}\n";
+
+  // Dispatches are configured per executable, so the sequences are collected
+  // with the context and written out together once all have been configured.
+  auto *dialect =
+      funcOp->getContext()->getLoadedDialect<IREE::CPU::IREECPUDialect>();
+  assert(dialect && "expected the iree_cpu dialect to be loaded");
+  dialect->recordProfileGuidedTuningSequence(funcOp.getName(),
+                                             std::move(sequence));
+  return success();
+}
+
+} // namespace mlir::iree_compiler
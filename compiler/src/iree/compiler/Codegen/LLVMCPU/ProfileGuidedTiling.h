@@ -0,0 +1,91 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===----------------------------------------------------------------------===//
+// Profile-guided tile size selection for LLVMCPU dispatches.
+//
+// Tile sizes picked by the KernelDispatch heuristics can be refined by
+// measuring a small set of candidates on the target:
+//
+//   1. Compile and run the model once with the default configuration while
+//      collecting a per-dispatch profile (e.g. a Tracy capture exported with
+//      `iree-tracy-csvexport`).
+//   2. For each candidate N in [1, kNumProfileGuidedTileCandidates) recompile
+//      with `--iree-llvmcpu-pgo-dispatch-profiles=<profile 0>` and
+//      `--iree-llvmcpu-pgo-tile-candidate=N` and collect another profile.
+//   3. Compile with all profiles (in candidate order) passed to
+//      `--iree-llvmcpu-pgo-dispatch-profiles`. The fastest candidate of each
+//      hot dispatch is used and, with
+//      `--iree-llvmcpu-pgo-tuning-spec-output`, written out as a tuning spec
+//      that can be reused through `--iree-codegen-tuning-spec-path` without
+//      needing the profiles. The spec is written once all executables have
+//      been configured, before they are linked.
+//
+// Profiles are CSV files with a header row. The `name` column holds the
+// dispatch (export) name and the `total_ns` column holds the total time spent
+// in it; an optional `counts` column holds the number of invocations.
+//===----------------------------------------------------------------------===//
+
+#ifndef IREE_COMPILER_CODEGEN_LLVMCPU_PROFILEGUIDEDTILING_H_
+#define IREE_COMPILER_CODEGEN_LLVMCPU_PROFILEGUIDEDTILING_H_
+
+#include <optional>
+
+#include "llvm/ADT/StringMap.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Operation.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
+#include "mlir/Support/LLVM.h"
+
+namespace mlir::iree_compiler {
+
+/// Number of tile size candidates tried for a hot dispatch. Candidate 0 is the
+/// configuration picked by the default heuristics.
+constexpr int64_t kNumProfileGuidedTileCandidates = 5;
+
+/// Per-dispatch timings of a profile measured with one tile size candidate.
+struct DispatchProfile {
+  struct Timing {
+    int64_t totalNs = 0;
+    int64_t count = 0;
+  };
+  llvm::StringMap<Timing> timings;
+  int64_t totalNs = 0;
+};
+
+/// Loads the profiles passed with `--iree-llvmcpu-pgo-dispatch-profiles` in
+/// candidate order. `profiles` is left empty if none were passed.
+LogicalResult loadDispatchProfiles(MLIRContext *context,
+                                   SmallVectorImpl<DispatchProfile> &profiles);
+
+/// Returns the log2 of the factor the distribution tile sizes are scaled by
+/// for `candidate`.
+int64_t getProfileGuidedTileScaleLog2(int64_t candidate);
+
+/// Selects the tile size candidate to use for `funcOp` based on `profiles`
+/// and the candidate passed on the command line. `candidate` is left unset if
+/// the default heuristics should be used as-is.
+LogicalResult
+selectProfileGuidedTileCandidate(FunctionOpInterface funcOp,
+                                 ArrayRef<DispatchProfile> profiles,
+                                 std::optional<int64_t> &candidate);
+
+/// Returns true if `--iree-llvmcpu-pgo-tuning-spec-output` was passed.
+bool isProfileGuidedTuningSpecRequested();
+
+/// Records the configuration chosen for `rootOp` for the tuning spec written
+/// by `writeProfileGuidedTuningSpec`, if one was requested.
+LogicalResult recordProfileGuidedConfig(FunctionOpInterface funcOp,
+                                        Operation *rootOp);
+
+/// Writes the configurations recorded in the context of `moduleOp` to the
+/// path passed with `--iree-llvmcpu-pgo-tuning-spec-output` and clears them.
+/// Nothing is written if no configuration was recorded.
+LogicalResult writeProfileGuidedTuningSpec(ModuleOp moduleOp);
+
+} // namespace mlir::iree_compiler
+
+#endif // IREE_COMPILER_CODEGEN_LLVMCPU_PROFILEGUIDEDTILING_H_
@@ -0,0 +1,89 @@
+// RUN: iree-opt --pass-pipeline='builtin.module(iree-llvmcpu-select-lowering-strategy)' \
+// RUN:   --iree-llvmcpu-pgo-tile-candidate=1 --split-input-file %s | FileCheck %s --check-prefix=FORCED
+
+// RUN: iree-opt --pass-pipeline='builtin.module(iree-llvmcpu-select-lowering-strategy,iree-llvmcpu-write-profile-guided-tuning-spec)' \
+// RUN:   --iree-llvmcpu-pgo-dispatch-profiles=%p/profile_guided_tiling_0.csv,%p/profile_guided_tiling_1.csv,%p/profile_guided_tiling_2.csv \
+// RUN:   --iree-llvmcpu-pgo-tuning-spec-output=%t.spec.mlir \
+// RUN:   --split-input-file %s | FileCheck %s --check-prefix=PROFILED
+// RUN: iree-opt %t.spec.mlir | FileCheck %s --check-prefix=SPEC
+
+// RUN: iree-opt --pass-pipeline='builtin.module(iree-codegen-materialize-tuning-specs,iree-codegen-materialize-user-configs,iree-llvmcpu-select-lowering-strategy)' \
+// RUN:   --iree-codegen-tuning-spec-path=%t.spec.mlir \
+// RUN:   --split-input-file %s | FileCheck %s --check-prefix=SPEC-APPLIED
+
+// Both dispatches are the same matmul, which by default is distributed with
+// [48, 64, 0] tiles. The profiles mark @matmul_static as hot and candidate 2
+// (tiles halved) as its fastest configuration while @matmul_cold is below the
+// hot dispatch threshold.
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {cpu_features = "+avx512f", data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128", native_vector_size = 16 : index, target_triple = "x86_64-none-elf"}>
+func.func @matmul_static(%3: tensor<384x512xf32>, %4: tensor<512x128xf32>) -> tensor<384x128xf32> attributes {hal.executable.target = #executable_target_embedded_elf_x86_64_} {
+  %cst = arith.constant 0.000000e+00 : f32
+  %5 = tensor.empty() : tensor<384x128xf32>
+  %6 = linalg.fill ins(%cst : f32) outs(%5 : tensor<384x128xf32>) -> tensor<384x128xf32>
+  %7 = linalg.matmul ins(%3, %4 : tensor<384x512xf32>, tensor<512x128xf32>) outs(%6 : tensor<384x128xf32>) -> tensor<384x128xf32>
+  return %7 : tensor<384x128xf32>
+}
+//  FORCED-DAG: #[[CONFIG:.+]] = #iree_cpu.lowering_config<cache_parallel = [96, 128, 0], distribution = [96, 128, 0], vector_common_parallel = [8, 32, 0], vector_reduction = [0, 0, 16]>
+//      FORCED: func.func @matmul_static(
+//      FORCED: linalg.matmul
+// FORCED-SAME:     lowering_config = #[[CONFIG]]
+
+//  PROFILED-DAG: #[[CONFIG:.+]] = #iree_cpu.lowering_config<cache_parallel = [24, 32, 0], distribution = [24, 32, 0], vector_common_parallel = [8, 32, 0], vector_reduction = [0, 0, 16]>
+//  PROFILED-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<pipeline = CPUDoubleTilingExpert, {{\{}}enable_loop_peeling}>
+//      PROFILED: func.func @matmul_static(
+// PROFILED-SAME:     translation_info = #[[TRANSLATION]]
+//      PROFILED: linalg.matmul
+// PROFILED-SAME:     lowering_config = #[[CONFIG]]
+
+// The tuning spec matches ops by their structure, so the identical cold matmul
+// below picks up the same configuration once the spec is applied.
+
+//  SPEC-APPLIED-DAG: #[[CONFIG:.+]] = #iree_cpu.lowering_config<cache_parallel = [24, 32, 0], distribution = [24, 32, 0]
+//      SPEC-APPLIED: func.func @matmul_static(
+//      SPEC-APPLIED: linalg.matmul
+// SPEC-APPLIED-SAME:     lowering_config = #[[CONFIG]]
+
+// -----
+
+#executable_target_embedded_elf_x86_64_ = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {cpu_features = "+avx512f", data_layout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128", native_vector_size = 16 : index, target_triple = "x86_64-none-elf"}>
+func.func @matmul_cold(%3: tensor<384x512xf32>, %4: tensor<512x128xf32>) -> tensor<384x128xf32> attributes {hal.executable.target = #executable_target_embedded_elf_x86_64_} {
+  %cst = arith.constant 0.000000e+00 : f32
+  %5 = tensor.empty() : tensor<384x128xf32>
+  %6 = linalg.fill ins(%cst : f32) outs(%5 : tensor<384x128xf32>) -> tensor<384x128xf32>
+  %7 = linalg.matmul ins(%3, %4 : tensor<384x512xf32>, tensor<512x128xf32>) outs(%6 : tensor<384x128xf32>) -> tensor<384x128xf32>
+  return %7 : tensor<384x128xf32>
+}
+//  FORCED-DAG: #[[CONFIG:.+]] = #iree_cpu.lowering_config<cache_parallel = [96, 128, 0], distribution = [96, 128, 0]
+//      FORCED: func.func @matmul_cold(
+//      FORCED: linalg.matmul
+// FORCED-SAME:     lowering_config = #[[CONFIG]]
+
+//  PROFILED-DAG: #[[CONFIG:.+]] = #iree_cpu.lowering_config<cache_parallel = [48, 64, 0], distribution = [48, 64, 0]
+//      PROFILED: func.func @matmul_cold(
+//      PROFILED: linalg.matmul
+// PROFILED-SAME:     lowering_config = #[[CONFIG]]
+
+//  SPEC-APPLIED-DAG: #[[CONFIG:.+]] = #iree_cpu.lowering_config<cache_parallel = [24, 32, 0], distribution = [24, 32, 0]
+//      SPEC-APPLIED: func.func @matmul_cold(
+//      SPEC-APPLIED: linalg.matmul
+// SPEC-APPLIED-SAME:     lowering_config = #[[CONFIG]]
+
+// Only the hot dispatch is recorded in the tuning spec. Nothing is recorded
+// for the cold dispatch, so its split does not overwrite the spec.
+
+//   SPEC-DAG: #[[CONFIG:.+]] = #iree_cpu.lowering_config<cache_parallel = [24, 32, 0], distribution = [24, 32, 0]
+//   SPEC-DAG: #[[INFO:.+]] = #iree_codegen.compilation_info<lowering_config = #[[CONFIG]]
+// SPEC-LABEL: module @iree_llvmcpu_pgo_tuning_spec
+//  SPEC-SAME:   iree_codegen.tuning_spec_with_default_entrypoint
+//       SPEC:   transform.named_sequence @apply_op_config
+//       SPEC:     transform.annotate %{{.+}} "compilation_info" = %{{.+}}
+//       SPEC:   transform.named_sequence @match_matmul_static
+//       SPEC:     transform.iree.match.cast_compatible_dag_from_root
+//       SPEC:       linalg.matmul ins(%{{.+}}, %{{.+}} : tensor<384x512xf32>, tensor<512x128xf32>) outs(%{{.+}} : tensor<384x128xf32>)
+//       SPEC:     transform.param.constant #[[INFO]]
+//   SPEC-NOT:   @match_matmul_cold
+//       SPEC:   transform.named_sequence @__kernel_config
+//  SPEC-SAME:     iree_codegen.tuning_spec_entrypoint
+//       SPEC:     transform.foreach_match
+//       SPEC:       @match_matmul_static -> @apply_op_config
@@ -301,6 +301,21 @@ public:
     assert(false && "unimplemented serializeExecutable");
     return failure();
   }
+
+  // Returns a string capturing any backend state not present in the IR of
+  // |variantOp| that affects the binaries produced by serializeExecutable
+  // (such as linker paths specified by command line flags). The key is hashed
+  // together with the variant IR to look up previously serialized binaries in
+  // the persistent executable cache (`--iree-hal-executable-cache-path=`).
+  //
+  // Backends must return std::nullopt to opt out of caching if serialization
+  // has side effects beyond producing hal.executable.binary ops or if the
+  // output is not fully determined by the IR and the returned key. This is the
+  // default as caching is only safe once a backend has been audited for both.
+  virtual std::optional<std::string>
+  getSerializationCacheKey(IREE::HAL::ExecutableVariantOp variantOp) {
+    return std::nullopt;
+  }
 };
 
 // Returns a sorted uniqued set of target backends used in the executable.
@@ -93,6 +93,26 @@ void TargetOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Path to write translated and serialized executable binaries into."),
       llvm::cl::cat(halTargetOptionsCategory));
+
+  binder.opt<std::string>(
+      "iree-hal-executable-cache-path", executableCachePath,
+      llvm::cl::desc(
+          "Path to a directory used to cache serialized executable binaries "
+          "across compiler invocations. Executables whose IR and target "
+          "options are unchanged reuse the cached binaries instead of being "
+          "serialized again. The key includes the compiler version of release "
+          "builds. Development builds without embedded release info should "
+          "clear the directory when switching between builds."),
+      llvm::cl::cat(halTargetOptionsCategory));
+
+  binder.opt<unsigned>(
+      "iree-hal-executable-cache-max-size-mb", executableCacheMaxSizeMB,
+      llvm::cl::desc("Maximum size of the executable cache in megabytes. The "
+                     "least recently used entries are evicted when the cache "
+                     "grows beyond this size. The cache is checked "
+                     "periodically and may briefly exceed the size by up to "
+                     "1/8th. 0 disables eviction."),
+      llvm::cl::cat(halTargetOptionsCategory));
 }
 
 } // namespace mlir::iree_compiler::IREE::HAL
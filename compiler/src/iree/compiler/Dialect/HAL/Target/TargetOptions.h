@@ -76,6 +76,14 @@ struct TargetOptions {
   // A path to write translated and serialized executable binaries into.
   std::string executableBinariesPath;
 
+  // A directory used to persist serialized executable binaries across
+  // compiler invocations. Disabled if empty.
+  std::string executableCachePath;
+
+  // Maximum size of the executable cache in megabytes. The least recently used
+  // entries are evicted when exceeded. 0 disables eviction.
+  unsigned executableCacheMaxSizeMB = 1024;
+
   void bindOptions(OptionsBinder &binder);
   using FromFlags = OptionsFromFlags<TargetOptions>;
 };
@@ -575,7 +575,9 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
         IREE::HAL::createSerializeAllExecutablesPass(
             {&targetRegistry, targetOptions.debugLevel,
              targetOptions.executableIntermediatesPath,
-             targetOptions.executableBinariesPath}));
+             targetOptions.executableBinariesPath,
+             targetOptions.executableCachePath,
+             targetOptions.executableCacheMaxSizeMB}));
 
     // NOTE: symbol DCE will destroy executable target contents, so only run
     // it if we serialized things.
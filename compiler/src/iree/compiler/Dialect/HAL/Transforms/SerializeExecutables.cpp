@@ -4,7 +4,11 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <memory>
+#include <type_traits>
 #include <utility>
 
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
@@ -12,12 +16,24 @@
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
+#include "iree/compiler/Tools/version.h"
 #include "iree/compiler/Utils/TracingUtils.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SHA256.h"
 #include "mlir/IR/Attributes.h"
+#include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
+#include "mlir/IR/OperationSupport.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassManager.h"
 
@@ -27,6 +43,309 @@ namespace mlir::iree_compiler::IREE::HAL {
 #define GEN_PASS_DEF_SERIALIZETARGETEXECUTABLESPASS
 #include "iree/compiler/Dialect/HAL/Transforms/Passes.h.inc"
 
+//===----------------------------------------------------------------------===//
+// Executable cache
+//===----------------------------------------------------------------------===//
+
+// Cache entries are files named by the hex SHA-256 of the variant key that
+// contain the hal.executable.binary ops produced when serializing the variant:
+//   char magic[8]
+//   uint32_t binary_count
+//   binary_count x {
+//     uint32_t sym_name_length; char sym_name[sym_name_length];
+//     uint32_t format_length; char format[format_length];
+//     uint32_t mime_type_length; char mime_type[mime_type_length];
+//     uint64_t data_length; uint8_t data[data_length];
+//   }
+// All integers are little-endian and an empty mime type indicates none. The
+// magic is also hashed into the key so changing it whenever the layout or the
+// key contents change orphans all existing entries (which then age out).
+static constexpr llvm::StringLiteral kCacheEntryMagic = "IREEHXC2";
+static constexpr llvm::StringLiteral kCacheEntryExtension = ".bin";
+
+namespace {
+
+// Forwards everything written to the stream into a SHA-256 hasher so that
+// large IR can be hashed without first printing it into memory.
+class HashingOStream final : public llvm::raw_ostream {
+public:
+  explicit HashingOStream(llvm::SHA256 &hasher) : hasher(hasher) {}
+  ~HashingOStream() override { flush(); }
+
+private:
+  void write_impl(const char *ptr, size_t size) override {
+    hasher.update(llvm::StringRef(ptr, size));
+    position += size;
+  }
+  uint64_t current_pos() const override { return position; }
+
+  llvm::SHA256 &hasher;
+  uint64_t position = 0;
+};
+
+} // namespace
+
+// Returns the hex-encoded cache key for |variantOp| or std::nullopt if the
+// target backend does not support caching the variant.
+static std::optional<std::string>
+computeCacheKey(TargetBackend &targetBackend,
+                IREE::HAL::ExecutableVariantOp variantOp, int debugLevel) {
+  std::optional<std::string> backendKey =
+      targetBackend.getSerializationCacheKey(variantOp);
+  if (!backendKey) {
+    return std::nullopt;
+  }
+
+  llvm::SHA256 hasher;
+  {
+    HashingOStream os(hasher);
+    // Binaries produced by other compiler versions may differ even when the
+    // IR is identical. Development builds without embedded release info
+    // report an empty revision and rely on the LLVM version alone.
+    os << kCacheEntryMagic << '\0' << getIreeRevision() << '\0'
+       << LLVM_VERSION_STRING << '\0' << debugLevel << '\0' << *backendKey
+       << '\0';
+    // Backends name their binaries and symbols after the parent executable.
+    os << variantOp->getParentOfType<IREE::HAL::ExecutableOp>().getName()
+       << '\0';
+    // Locations are only included when they may be turned into debug info.
+    // Elements attributes must never be elided as then different constants
+    // would produce the same key.
+    OpPrintingFlags flags;
+    flags.useLocalScope()
+        .assumeVerified()
+        .elideLargeElementsAttrs(std::numeric_limits<int64_t>::max())
+        .enableDebugInfo(/*enable=*/debugLevel > 0);
+    variantOp->print(os, flags);
+  }
+
+  // Resource blobs are printed as references only so hash their contents.
+  variantOp->walk([&](Operation *op) {
+    op->getAttrDictionary().walk([&](DenseResourceElementsAttr attr) {
+      if (auto *blob = attr.getRawHandle().getBlob()) {
+        ArrayRef<char> data = blob->getData();
+        hasher.update(llvm::StringRef(data.data(), data.size()));
+      }
+    });
+  });
+
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+// Inserts the binaries stored in the cache entry at |path| with |builder| and
+// marks the entry as recently used. Fails without modifying the IR if the
+// entry does not exist or is malformed.
+static LogicalResult loadCacheEntry(StringRef path, Location loc,
+                                    OpBuilder &builder) {
+  auto fileOr = llvm::MemoryBuffer::getFile(path, /*IsText=*/false,
+                                            /*RequiresNullTerminator=*/false);
+  if (!fileOr) {
+    return failure();
+  }
+  StringRef contents = (*fileOr)->getBuffer();
+
+  auto readBytes = [&](uint64_t length, StringRef &value) {
+    if (contents.size() < length) {
+      return false;
+    }
+    value = contents.take_front(length);
+    contents = contents.drop_front(length);
+    return true;
+  };
+  auto readLength = [&](auto &length) {
+    using T = std::remove_reference_t<decltype(length)>;
+    StringRef bytes;
+    if (!readBytes(sizeof(T), bytes)) {
+      return false;
+    }
+    length = llvm::support::endian::read<T, llvm::endianness::little>(
+        bytes.data());
+    return true;
+  };
+  auto readString = [&](StringRef &value) {
+    uint32_t length = 0;
+    return readLength(length) && readBytes(length, value);
+  };
+
+  // Parse all binaries before inserting any so that truncated entries (such as
+  // those from a full disk) do not leave partial results behind.
+  struct Binary {
+    StringRef symName;
+    StringRef format;
+    StringRef mimeType;
+    StringRef data;
+  };
+  SmallVector<Binary> binaries;
+  StringRef magic;
+  uint32_t binaryCount = 0;
+  if (!readBytes(kCacheEntryMagic.size(), magic) ||
+      magic != kCacheEntryMagic || !readLength(binaryCount)) {
+    return failure();
+  }
+  for (uint32_t i = 0; i < binaryCount; ++i) {
+    Binary binary;
+    uint64_t dataLength = 0;
+    if (!readString(binary.symName) || !readString(binary.format) ||
+        !readString(binary.mimeType) || !readLength(dataLength) ||
+        !readBytes(dataLength, binary.data)) {
+      return failure();
+    }
+    binaries.push_back(binary);
+  }
+  if (!contents.empty()) {
+    return failure();
+  }
+
+  for (auto &binary : binaries) {
+    auto binaryOp = IREE::HAL::ExecutableBinaryOp::create(
+        builder, loc, binary.symName, binary.format,
+        std::vector<uint8_t>(binary.data.bytes_begin(),
+                             binary.data.bytes_end()));
+    if (!binary.mimeType.empty()) {
+      binaryOp.setMimeTypeAttr(builder.getStringAttr(binary.mimeType));
+    }
+  }
+
+  // Bump the modification time used to order entries for eviction. This is
+  // best-effort as the cache may be read-only.
+  int fd = -1;
+  if (!llvm::sys::fs::openFileForReadWrite(path, fd,
+                                           llvm::sys::fs::CD_OpenExisting,
+                                           llvm::sys::fs::OF_None)) {
+    (void)llvm::sys::fs::setLastAccessAndModificationTime(
+        fd, std::chrono::system_clock::now());
+    (void)llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+  }
+  return success();
+}
+
+// Writes |binaryOps| to the cache entry at |path|. The entry is written to a
+// temporary file first and renamed into place so that other compiler
+// processes sharing the cache never observe partially written entries.
+static LogicalResult
+storeCacheEntry(StringRef path,
+                ArrayRef<IREE::HAL::ExecutableBinaryOp> binaryOps) {
+  int fd = -1;
+  SmallString<128> tempPath;
+  if (llvm::sys::fs::createUniqueFile(path + ".tmp-%%%%%%%%", fd, tempPath)) {
+    return failure();
+  }
+
+  bool succeeded = true;
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    auto writeString = [&](StringRef value) {
+      llvm::support::endian::write<uint32_t>(os, value.size(),
+                                             llvm::endianness::little);
+      os << value;
+    };
+    os << kCacheEntryMagic;
+    llvm::support::endian::write<uint32_t>(os, binaryOps.size(),
+                                           llvm::endianness::little);
+    for (auto binaryOp : binaryOps) {
+      auto dataAttr = dyn_cast<IREE::Util::SerializableAttrInterface>(
+          binaryOp.getData());
+      SmallVector<char> data;
+      if (!dataAttr ||
+          failed(dataAttr.serializeToVector(
+              binaryOp.getLoc(), llvm::endianness::little, data))) {
+        succeeded = false;
+        break;
+      }
+      writeString(binaryOp.getSymName());
+      writeString(binaryOp.getFormat());
+      writeString(binaryOp.getMimeType().value_or(""));
+      llvm::support::endian::write<uint64_t>(os, data.size(),
+                                             llvm::endianness::little);
+      os.write(data.data(), data.size());
+    }
+    os.close();
+    if (os.has_error()) {
+      os.clear_error();
+      succeeded = false;
+    }
+  }
+
+  if (!succeeded || llvm::sys::fs::rename(tempPath, path)) {
+    (void)llvm::sys::fs::remove(tempPath);
+    return failure();
+  }
+  return success();
+}
+
+// Removes the least recently used entries from the cache at |cachePath| until
+// its total size is at most |maxSize| bytes. Returns the number of entries
+// removed by this call. This scans the whole cache directory and should only be
+// called occasionally (see shouldEvictCacheEntries).
+static unsigned evictCacheEntries(StringRef cachePath, uint64_t maxSize) {
+  struct Entry {
+    std::string path;
+    uint64_t size;
+    llvm::sys::TimePoint<> lastUsedTime;
+  };
+  SmallVector<Entry> entries;
+  uint64_t totalSize = 0;
+  std::error_code ec;
+  for (llvm::sys::fs::directory_iterator it(cachePath, ec), end;
+       it != end && !ec; it.increment(ec)) {
+    if (llvm::sys::path::extension(it->path()) != kCacheEntryExtension) {
+      continue;
+    }
+    auto status = it->status();
+    if (!status) {
+      continue;
+    }
+    entries.push_back({it->path(), status->getSize(),
+                       status->getLastModificationTime()});
+    totalSize += status->getSize();
+  }
+  if (totalSize <= maxSize) {
+    return 0;
+  }
+
+  llvm::sort(entries, [](const Entry &lhs, const Entry &rhs) {
+    return lhs.lastUsedTime < rhs.lastUsedTime;
+  });
+  unsigned evictionCount = 0;
+  for (auto &entry : entries) {
+    if (totalSize <= maxSize) {
+      break;
+    }
+    // Another compiler process sharing the cache may have already removed the
+    // entry; either way it no longer counts towards the total.
+    if (!llvm::sys::fs::remove(entry.path, /*IgnoreNonExisting=*/false)) {
+      ++evictionCount;
+    }
+    totalSize -= entry.size;
+  }
+  return evictionCount;
+}
+
+// Bytes stored in the cache by this process since it was last scanned for
+// eviction. Shared across all passes (and compiler sessions) in the process.
+static std::atomic<uint64_t> cacheBytesSinceEviction{0};
+static std::atomic<bool> cacheEvictedOnce{false};
+
+// Returns true if the cache should be scanned for eviction after storing an
+// entry of |storedSize| bytes. Scanning lists the entire cache directory so
+// instead of scanning after every store the cache is scanned on the first store
+// in the process (to trim any growth from previous processes) and then each
+// time another 1/8th of |maxSize| has been stored. The cache may temporarily
+// exceed |maxSize| by that amount.
+static bool shouldEvictCacheEntries(uint64_t storedSize, uint64_t maxSize) {
+  if (!cacheEvictedOnce.exchange(true)) {
+    cacheBytesSinceEviction = 0;
+    return true;
+  }
+  uint64_t evictionInterval = std::max<uint64_t>(maxSize / 8, 1);
+  uint64_t storedBytes = cacheBytesSinceEviction += storedSize;
+  if (storedBytes < evictionInterval) {
+    return false;
+  }
+  // Only one of the threads crossing the interval performs the scan.
+  return cacheBytesSinceEviction.compare_exchange_strong(storedBytes, 0);
+}
+
 namespace {
 
 //===----------------------------------------------------------------------===//
@@ -75,21 +394,86 @@ struct SerializeTargetExecutablesPass
       llvm::sys::fs::create_directories(dumpBinariesPath);
     }
 
+    // Cached binaries can't reproduce the intermediates and binaries dumped as
+    // a side effect of serialization so the cache is bypassed when dumping.
+    bool useCache = !cachePath.empty() && dumpIntermediatesPath.empty() &&
+                    dumpBinariesPath.empty();
+    if (useCache) {
+      if (auto ec = llvm::sys::fs::create_directories(cachePath)) {
+        executableOp.emitWarning()
+            << "executable cache disabled; failed to create cache directory '"
+            << cachePath << "': " << ec.message();
+        useCache = false;
+      }
+    }
+
     auto variantOps = llvm::to_vector(
         executableOp.getBlock().getOps<IREE::HAL::ExecutableVariantOp>());
     for (auto variantOp : variantOps) {
       if (variantOp.getTarget().getBackend().getValue() != target)
         continue;
       OpBuilder executableBuilder(variantOp);
+
+      // Reuse the binaries from a previous serialization of identical IR.
+      std::optional<std::string> cacheKey;
+      SmallString<128> cacheEntryPath;
+      if (useCache) {
+        cacheKey = computeCacheKey(*targetBackend, variantOp, debugLevel);
+      }
+      if (cacheKey) {
+        cacheEntryPath = cachePath;
+        llvm::sys::path::append(cacheEntryPath,
+                                *cacheKey + kCacheEntryExtension);
+        if (succeeded(loadCacheEntry(cacheEntryPath, variantOp.getLoc(),
+                                     executableBuilder))) {
+          ++numCacheHits;
+          variantOp.erase();
+          continue;
+        }
+      }
+
       // Ask the target backend to serialize the executable. Note that it
       // may create one or more hal.executable.binary ops in the case of
       // multi-architecture binaries.
+      Operation *prevOp = variantOp->getPrevNode();
       if (failed(targetBackend->serializeExecutable(
               serializationOptions, variantOp, executableBuilder))) {
         variantOp.emitError()
             << "failed to serialize executable for target backend " << target;
         return signalPassFailure();
       }
+
+      // Store everything the backend inserted before the variant. If the
+      // backend produced anything other than binaries the variant can't be
+      // reconstructed from the cache and is skipped. Failing to write the
+      // entry is not an error as the cache is only an optimization.
+      if (cacheKey) {
+        ++numCacheMisses;
+        SmallVector<IREE::HAL::ExecutableBinaryOp> binaryOps;
+        bool onlyBinaries = true;
+        for (Operation *op = prevOp ? prevOp->getNextNode()
+                                    : &executableOp.getBlock().front();
+             op != variantOp.getOperation(); op = op->getNextNode()) {
+          auto binaryOp = dyn_cast<IREE::HAL::ExecutableBinaryOp>(op);
+          if (!binaryOp) {
+            onlyBinaries = false;
+            break;
+          }
+          binaryOps.push_back(binaryOp);
+        }
+        uint64_t storedSize = 0;
+        if (onlyBinaries &&
+            succeeded(storeCacheEntry(cacheEntryPath, binaryOps)) &&
+            !llvm::sys::fs::file_size(cacheEntryPath, storedSize) &&
+            cacheMaxSizeMB > 0) {
+          uint64_t maxSize =
+              static_cast<uint64_t>(cacheMaxSizeMB) * 1024 * 1024;
+          if (shouldEvictCacheEntries(storedSize, maxSize)) {
+            numCacheEvictions += evictCacheEntries(cachePath, maxSize);
+          }
+        }
+      }
+
       variantOp.erase();
     }
   }
@@ -110,7 +494,7 @@ struct SerializeAllExecutablesPass
     for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
       passManager.addPass(IREE::HAL::createSerializeTargetExecutablesPass(
           {targetRegistry, targetName, debugLevel, dumpIntermediatesPath,
-           dumpBinariesPath}));
+           dumpBinariesPath, cachePath, cacheMaxSizeMB}));
     }
 
     IREE_COMPILER_TRACE_MESSAGE_DYNAMIC(INFO, executableOp.getSymName().str());
@@ -119,6 +503,19 @@ struct SerializeAllExecutablesPass
       executableOp.emitError() << "failed to serialize executables";
       return signalPassFailure();
     }
+
+    // Statistics of dynamically run pipelines are not reported by the pass
+    // manager so accumulate the cache statistics of each target pass here.
+    for (Pass &pass : passManager.getPasses()) {
+      for (Pass::Statistic *statistic : pass.getStatistics()) {
+        for (Pass::Statistic *total :
+             {&numCacheHits, &numCacheMisses, &numCacheEvictions}) {
+          if (StringRef(statistic->getName()) == total->getName()) {
+            *total += statistic->getValue();
+          }
+        }
+      }
+    }
   }
 };
 
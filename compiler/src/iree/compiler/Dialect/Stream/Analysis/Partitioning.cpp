@@ -247,14 +247,18 @@ void PartitionSet::topologicalSort() {
 
 PartitionSet partitionStreamableOps(IREE::Stream::PartitioningConfigAttr config,
                                     Block *block) {
-  // Only one algorithm today.
+  if (config.getFavor().getValue() == IREE::Stream::Favor::Balanced) {
+    return partitionStreamableOpsCostModel(config, block);
+  }
   return partitionStreamableOpsReference(config, block);
 }
 
 PartitionSet
 partitionRegionConcurrency(IREE::Stream::PartitioningConfigAttr config,
                            Block *block) {
-  // Only one algorithm today.
+  if (config.getFavor().getValue() == IREE::Stream::Favor::Balanced) {
+    return partitionRegionConcurrencyCostModel(config, block);
+  }
   return partitionRegionConcurrencyReference(config, block);
 }
 
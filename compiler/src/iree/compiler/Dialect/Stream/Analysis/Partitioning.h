@@ -8,6 +8,8 @@
 #define IREE_COMPILER_DIALECT_STREAM_ANALYSIS_PARTITIONING_H_
 
 #include "iree/compiler/Dialect/Stream/IR/StreamTypes.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
 #include "mlir/IR/Operation.h"
 #include "mlir/Support/LLVM.h"
 
@@ -134,6 +136,48 @@ PartitionSet
 partitionRegionConcurrencyReference(IREE::Stream::PartitioningConfigAttr config,
                                     Block *block);
 
+// Selects which of the |candidates| waves |op| should be placed into. Waves
+// are numbered in reverse execution order as they are formed bottom-up such
+// that ordinal 0 is the last wave to execute. Returns -1 to place the op into
+// a new wave that executes before all existing ones.
+using WaveSelectorFn = llvm::function_ref<int(
+    Operation *op, const llvm::BitVector &candidates)>;
+
+// Forms waves using the same hazard tracking as
+// partitionRegionConcurrencyReference but with the wave each op is placed into
+// chosen by |selectWave|.
+PartitionSet partitionRegionConcurrencyWithSelector(
+    IREE::Stream::PartitioningConfigAttr config, Block *block,
+    WaveSelectorFn selectWave);
+
+//===----------------------------------------------------------------------===//
+// Cost model partitioning
+//===----------------------------------------------------------------------===//
+
+// Returns an estimate of the relative cost of executing |op|. The unit is
+// roughly bytes of resource memory touched plus one per dispatch workload
+// element. Ops with dynamic sizes are assigned a large fixed cost as they are
+// likely to be expensive.
+uint64_t estimatePartitioningCost(Operation *op);
+
+// Starts from the partitions produced by partitionStreamableOpsReference and
+// merges partitions too cheap to amortize their submission overhead into a
+// compatible neighbor when doing so does not introduce a cycle or cross an
+// ordering barrier. The cheapest neighbor is chosen to keep the resulting
+// partitions balanced.
+PartitionSet
+partitionStreamableOpsCostModel(IREE::Stream::PartitioningConfigAttr config,
+                                Block *block);
+
+// Forms waves with the same hazard tracking as
+// partitionRegionConcurrencyReference but places each op into the candidate
+// wave whose estimated execution time (that of its most expensive op) grows
+// the least. Ops of similar cost end up running concurrently instead of short
+// ops waiting behind long ones.
+PartitionSet
+partitionRegionConcurrencyCostModel(IREE::Stream::PartitioningConfigAttr config,
+                                    Block *block);
+
 } // namespace mlir::iree_compiler::IREE::Stream
 
 #endif // IREE_COMPILER_DIALECT_STREAM_ANALYSIS_PARTITIONING_H_
@@ -0,0 +1,358 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Stream/Analysis/Partitioning.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+#include <algorithm>
+#include <optional>
+
+#define DEBUG_TYPE "iree-stream-partitioning"
+
+namespace mlir::iree_compiler::IREE::Stream {
+
+//===----------------------------------------------------------------------===//
+// Cost estimation
+//===----------------------------------------------------------------------===//
+
+// Cost assigned to each size or workload dimension that is not statically
+// known. Dynamically shaped work is usually large enough to be worth
+// isolating so we err on the side of treating it as expensive.
+static constexpr uint64_t kUnknownCost = 1 * 1024 * 1024;
+
+// Estimated fixed cost of submitting and synchronizing an execution region in
+// the same units as estimatePartitioningCost. Partitions cheaper than this are
+// merged into a neighbor when legal.
+static constexpr uint64_t kPartitionOverheadCost = 256 * 1024;
+
+// Returns the static value of |size| or kUnknownCost if it is dynamic.
+static uint64_t getStaticSizeOrUnknown(Value size) {
+  APInt value;
+  if (!size || !matchPattern(size, m_ConstantInt(&value))) {
+    return kUnknownCost;
+  }
+  return value.getZExtValue();
+}
+
+uint64_t estimatePartitioningCost(Operation *op) {
+  auto streamableOp = dyn_cast<IREE::Stream::StreamableOpInterface>(op);
+  if (!streamableOp || streamableOp.isMetadata()) {
+    return 0;
+  }
+
+  // Bytes of resource memory read or written by the op.
+  uint64_t cost = 0;
+  if (auto sizeAwareOp = dyn_cast<IREE::Util::SizeAwareOpInterface>(op)) {
+    for (auto operand : llvm::enumerate(op->getOperands())) {
+      if (!isa<IREE::Stream::ResourceType>(operand.value().getType())) {
+        continue;
+      }
+      cost = llvm::SaturatingAdd(
+          cost,
+          getStaticSizeOrUnknown(sizeAwareOp.getOperandSize(operand.index())));
+    }
+    for (auto result : op->getResults()) {
+      if (!isa<IREE::Stream::ResourceType>(result.getType())) {
+        continue;
+      }
+      cost = llvm::SaturatingAdd(
+          cost, getStaticSizeOrUnknown(
+                    sizeAwareOp.getResultSize(result.getResultNumber())));
+    }
+  }
+
+  // Dispatches additionally scale with their workload as the amount of
+  // compute is not reflected in the bytes they touch.
+  if (auto dispatchOp = dyn_cast<IREE::Stream::AsyncDispatchOp>(op)) {
+    uint64_t workload = 1;
+    for (auto dim : dispatchOp.getWorkload()) {
+      workload =
+          llvm::SaturatingMultiply(workload, getStaticSizeOrUnknown(dim));
+    }
+    cost = llvm::SaturatingAdd(cost, workload);
+  }
+
+  return cost;
+}
+
+//===----------------------------------------------------------------------===//
+// Execution region partitioning
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+struct PartitionNode {
+  Partition partition;
+  // Sum of the estimated cost of all ops in the partition.
+  uint64_t cost = 0;
+  // Index of the span of ops between side-effecting barriers the partition
+  // lives in. Partitions may only be merged within the same epoch.
+  unsigned epoch = 0;
+  // False if the partition has been merged into another.
+  bool live = true;
+};
+
+} // namespace
+
+// Returns the ancestor of |op| that is directly within |block| or nullptr if
+// |op| is not nested within |block|.
+static Operation *getBlockLevelOp(Operation *op, Block *block) {
+  while (op && op->getBlock() != block) {
+    op = op->getParentOp();
+  }
+  return op;
+}
+
+// Returns true if any op in |nodes[fromIndex]| reaches an op in
+// |nodes[toIndex]| through an op that is in neither. Merging two such
+// partitions would create a cycle with the intermediate op.
+static bool hasIndirectPath(
+    ArrayRef<PartitionNode> nodes, unsigned fromIndex, unsigned toIndex,
+    Block *block, DenseMap<Operation *, SmallVector<unsigned>> &opPartitions) {
+  const Partition &from = nodes[fromIndex].partition;
+  const Partition &to = nodes[toIndex].partition;
+  SmallVector<Operation *> worklist;
+  DenseSet<Operation *> visited;
+  auto enqueue = [&](Operation *op) {
+    if (!from.ops.contains(op) && visited.insert(op).second) {
+      worklist.push_back(op);
+    }
+  };
+  // Seed with the direct users of |from| that are not in |to|; direct edges
+  // are preserved by merging.
+  for (auto *op : from.ops) {
+    for (auto *user : op->getUsers()) {
+      auto *blockUser = getBlockLevelOp(user, block);
+      if (blockUser && !to.ops.contains(blockUser)) {
+        enqueue(blockUser);
+      }
+    }
+  }
+  while (!worklist.empty()) {
+    auto *op = worklist.pop_back_val();
+    // All ops in a partition execute together so reaching one means all of
+    // them are downstream.
+    for (unsigned index : opPartitions.lookup(op)) {
+      if (index == fromIndex || !nodes[index].live) {
+        continue;
+      }
+      if (index == toIndex) {
+        return true;
+      }
+      for (auto *partitionOp : nodes[index].partition.ops) {
+        enqueue(partitionOp);
+      }
+    }
+    for (auto *user : op->getUsers()) {
+      auto *blockUser = getBlockLevelOp(user, block);
+      if (!blockUser) {
+        continue;
+      }
+      if (to.ops.contains(blockUser)) {
+        return true;
+      }
+      enqueue(blockUser);
+    }
+  }
+  return false;
+}
+
+// Merges |source| into |target| and recomputes the ins/outs of |target|.
+static void mergePartitionInto(PartitionNode &source, PartitionNode &target) {
+  Partition &merged = target.partition;
+  if (!merged.affinity) {
+    merged.affinity = source.partition.affinity;
+  } else if (source.partition.affinity) {
+    merged.affinity = merged.affinity.joinAND(source.partition.affinity);
+  }
+  for (auto *op : source.partition.ops) {
+    merged.ops.insert(op);
+  }
+
+  // Values flowing between the two partitions are now internal.
+  SetVector<Value> ins;
+  auto addIns = [&](const SetVector<Value> &values) {
+    for (auto value : values) {
+      auto *definingOp = value.getDefiningOp();
+      if (!definingOp || !merged.ops.contains(definingOp)) {
+        ins.insert(value);
+      }
+    }
+  };
+  addIns(merged.ins);
+  addIns(source.partition.ins);
+  SetVector<Value> outs;
+  auto addOuts = [&](const SetVector<Value> &values) {
+    for (auto value : values) {
+      if (llvm::any_of(value.getUsers(), [&](Operation *user) {
+            return !merged.ops.contains(user);
+          })) {
+        outs.insert(value);
+      }
+    }
+  };
+  addOuts(merged.outs);
+  addOuts(source.partition.outs);
+  merged.ins = std::move(ins);
+  merged.outs = std::move(outs);
+
+  target.cost = llvm::SaturatingAdd(target.cost, source.cost);
+  source.live = false;
+}
+
+PartitionSet
+partitionStreamableOpsCostModel(IREE::Stream::PartitioningConfigAttr config,
+                                Block *block) {
+  // The reference partitioning produces correct partitions that are as large
+  // as it can make them; we then fold away the ones that are not worth their
+  // submission overhead.
+  PartitionSet partitionSet = partitionStreamableOpsReference(config, block);
+  if (partitionSet.size() <= 1) {
+    return partitionSet;
+  }
+
+  // Assign each op the epoch it lives in. Side-effecting non-streamable ops
+  // act as barriers that no partition may span.
+  DenseMap<Operation *, unsigned> opEpochs;
+  unsigned epoch = 0;
+  for (auto &op : *block) {
+    opEpochs[&op] = epoch;
+    if (!isa<IREE::Stream::StreamableOpInterface>(op) &&
+        !op.hasTrait<OpTrait::ConstantLike>() &&
+        !isa<IREE::Util::GlobalStoreOpInterface>(op) &&
+        !mlir::wouldOpBeTriviallyDead(&op)) {
+      ++epoch;
+    }
+  }
+
+  SmallVector<PartitionNode> nodes;
+  DenseMap<Operation *, SmallVector<unsigned>> opPartitions;
+  for (auto &partition : partitionSet.partitions) {
+    PartitionNode node;
+    std::optional<unsigned> partitionEpoch;
+    for (auto *op : partition.ops) {
+      node.cost = llvm::SaturatingAdd(node.cost, estimatePartitioningCost(op));
+      opPartitions[op].push_back(nodes.size());
+      unsigned opEpoch = opEpochs.lookup(op);
+      if (!partitionEpoch) {
+        partitionEpoch = opEpoch;
+      } else if (*partitionEpoch != opEpoch) {
+        // Should not happen with the reference partitioning but if it does we
+        // keep the partition out of any merging.
+        partitionEpoch = ~0u;
+      }
+    }
+    node.epoch = partitionEpoch.value_or(~0u);
+    node.partition = std::move(partition);
+    nodes.push_back(std::move(node));
+  }
+
+  // Greedily merge the cheapest partition below the overhead threshold into
+  // its cheapest legal neighbor until no more merges are possible.
+  bool didChange = true;
+  while (didChange) {
+    didChange = false;
+    SmallVector<unsigned> order;
+    for (auto [index, node] : llvm::enumerate(nodes)) {
+      if (node.live && node.epoch != ~0u &&
+          node.cost < kPartitionOverheadCost) {
+        order.push_back(index);
+      }
+    }
+    llvm::stable_sort(order, [&](unsigned lhs, unsigned rhs) {
+      return nodes[lhs].cost < nodes[rhs].cost;
+    });
+    for (unsigned sourceIndex : order) {
+      auto &source = nodes[sourceIndex];
+      std::optional<unsigned> targetIndex;
+      for (auto [index, target] : llvm::enumerate(nodes)) {
+        if (index == sourceIndex || !target.live ||
+            target.epoch != source.epoch ||
+            !IREE::Stream::AffinityAttr::canExecuteTogether(
+                source.partition.affinity, target.partition.affinity)) {
+          continue;
+        }
+        if (targetIndex && nodes[*targetIndex].cost <= target.cost) {
+          continue;
+        }
+        if (hasIndirectPath(nodes, sourceIndex, index, block, opPartitions) ||
+            hasIndirectPath(nodes, index, sourceIndex, block, opPartitions)) {
+          continue;
+        }
+        targetIndex = index;
+      }
+      if (!targetIndex) {
+        continue;
+      }
+      LLVM_DEBUG(llvm::dbgs()
+                 << "Merging partition " << sourceIndex << " (cost "
+                 << source.cost << ") into partition " << *targetIndex
+                 << " (cost " << nodes[*targetIndex].cost << ")\n");
+      for (auto *op : source.partition.ops) {
+        auto &indices = opPartitions[op];
+        std::replace(indices.begin(), indices.end(), sourceIndex,
+                     *targetIndex);
+      }
+      mergePartitionInto(source, nodes[*targetIndex]);
+      didChange = true;
+      break;
+    }
+  }
+
+  PartitionSet mergedSet;
+  for (auto &node : nodes) {
+    if (node.live) {
+      mergedSet.partitions.push_back(std::move(node.partition));
+    }
+  }
+  mergedSet.topologicalSort();
+  return mergedSet;
+}
+
+//===----------------------------------------------------------------------===//
+// Concurrency wave partitioning
+//===----------------------------------------------------------------------===//
+
+PartitionSet
+partitionRegionConcurrencyCostModel(IREE::Stream::PartitioningConfigAttr config,
+                                    Block *block) {
+  // Estimated execution time of each wave by ordinal assuming its ops run
+  // fully concurrently: the cost of its most expensive op.
+  SmallVector<uint64_t> waveCosts;
+  return partitionRegionConcurrencyWithSelector(
+      config, block,
+      [&](Operation *op, const llvm::BitVector &candidates) -> int {
+        uint64_t opCost = estimatePartitioningCost(op);
+        int bestOrdinal = -1;
+        uint64_t bestIncrease = 0;
+        for (unsigned ordinal : candidates.set_bits()) {
+          uint64_t waveCost = waveCosts[ordinal];
+          uint64_t increase = opCost > waveCost ? opCost - waveCost : 0;
+          // Ties go to the lowest ordinal (latest executing wave) to keep the
+          // op close to its consumers and its results short-lived.
+          if (bestOrdinal == -1 || increase < bestIncrease) {
+            bestOrdinal = ordinal;
+            bestIncrease = increase;
+          }
+        }
+        if (bestOrdinal == -1) {
+          // New wave is created at the next ordinal.
+          waveCosts.push_back(opCost);
+        } else {
+          waveCosts[bestOrdinal] = std::max(waveCosts[bestOrdinal], opCost);
+        }
+        return bestOrdinal;
+      });
+}
+
+} // namespace mlir::iree_compiler::IREE::Stream
@@ -658,6 +658,19 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
 PartitionSet
 partitionRegionConcurrencyReference(IREE::Stream::PartitioningConfigAttr config,
                                     Block *block) {
+  auto favor = config.getFavor().getValue();
+  return partitionRegionConcurrencyWithSelector(
+      config, block,
+      [&](Operation *op, const llvm::BitVector &candidates) -> int {
+        return favor == IREE::Stream::Favor::MaxConcurrency
+                   ? candidates.find_first()
+                   : candidates.find_last();
+      });
+}
+
+PartitionSet partitionRegionConcurrencyWithSelector(
+    IREE::Stream::PartitioningConfigAttr config, Block *block,
+    WaveSelectorFn selectWave) {
   PartitionSet waveSet;
 
   auto favor = config.getFavor().getValue();
@@ -808,17 +821,18 @@ partitionRegionConcurrencyReference(IREE::Stream::PartitioningConfigAttr config,
     opInfo.membership.reserve(builders.size() + 1);
     opInfo.membership.resize(builders.size(), /*t=*/false);
 
-    // No consumers - if there's any candidate then we'll go into that.
-    int firstCandidateOrdinal = favor == IREE::Stream::Favor::MaxConcurrency
-                                    ? candidates.find_first()
-                                    : candidates.find_last();
-    if (firstCandidateOrdinal != -1) {
-      LLVM_DEBUG(llvm::dbgs() << "Moving to last candidate wave "
-                              << firstCandidateOrdinal << " (continue)\n");
-      builders[firstCandidateOrdinal]->ops.insert(&op);
-      opInfo.membership.set(firstCandidateOrdinal);
-      opInfo.hazards.set(0, firstCandidateOrdinal);
-      opInfo.hazards.reset(firstCandidateOrdinal);
+    // No consumers - if there's any candidate then we'll go into the one the
+    // selector picks.
+    int candidateOrdinal = selectWave(&op, candidates);
+    if (candidateOrdinal != -1) {
+      assert(candidates.test(candidateOrdinal) &&
+             "selector must pick one of the candidate waves");
+      LLVM_DEBUG(llvm::dbgs() << "Moving to candidate wave "
+                              << candidateOrdinal << " (continue)\n");
+      builders[candidateOrdinal]->ops.insert(&op);
+      opInfo.membership.set(candidateOrdinal);
+      opInfo.hazards.set(0, candidateOrdinal);
+      opInfo.hazards.reset(candidateOrdinal);
       continue;
     }
 
@@ -112,6 +112,10 @@ struct Statistics {
   size_t submissionCount = 0;
   int64_t transientSize = 0;
   bool transientSizeDynamic = false;
+  // Statically packed transient slab sizes as laid out by LayoutSlices and the
+  // lower bound of each (the maximum number of simultaneously live bytes).
+  int64_t transientPackedSize = 0;
+  int64_t transientLiveBound = 0;
   // TODO(benvanik): add fill/copy sizes (when possible).
   size_t fillCount = 0;
   size_t copyCount = 0;
@@ -160,6 +164,15 @@ struct Statistics {
       } else {
         transientSizeDynamic = true;
       }
+      if (auto packingAttr = allocaOp->getAttrOfType<DictionaryAttr>(
+              "stream.slice_packing")) {
+        auto packedSizeAttr = packingAttr.getAs<IntegerAttr>("packed_size");
+        auto liveBoundAttr = packingAttr.getAs<IntegerAttr>("live_bound");
+        if (packedSizeAttr && liveBoundAttr) {
+          transientPackedSize += packedSizeAttr.getInt();
+          transientLiveBound += liveBoundAttr.getInt();
+        }
+      }
     }
     for (auto executeOp : usageInfo.executeOps) {
       executeOp.walk([&](Operation *op) {
@@ -243,6 +256,18 @@ static void prettyPrintStatistics(const UsageInfo &usageInfo,
       "{}{} B ({:F2} MiB)\n", stats.transientSizeDynamic ? "minimum " : "",
       stats.transientSize, stats.transientSize / (1 * 1024 * 1024.0f));
 
+  os << llvm::formatv("//  Transients: packed {} B ({:F2} MiB), ",
+                      stats.transientPackedSize,
+                      stats.transientPackedSize / (1 * 1024 * 1024.0f));
+  os << llvm::formatv(
+      "live bound {} B ({:F2} MiB), {}% wastage\n", stats.transientLiveBound,
+      stats.transientLiveBound / (1 * 1024 * 1024.0f),
+      stats.transientPackedSize
+          ? (int)std::roundf((1.0f - (stats.transientLiveBound /
+                                      (float)stats.transientPackedSize)) *
+                             100.0f)
+          : 0);
+
   os << llvm::formatv("//   DMA Fills: {}\n", stats.fillCount);
   os << llvm::formatv("//  DMA Copies: {}\n", stats.copyCount);
   os << llvm::formatv("// Collectives: {}\n", stats.collectiveCount);
@@ -400,7 +425,7 @@ static void dumpAggregateCSVTable(const UsageInfo &usageInfo,
   Statistics stats;
   stats.analyze(usageInfo);
 
-  os << R"("Constants","Constant Size","Variables","Variable Size","Awaits","Submissions","Transient Size","Fills","Copies","Dispatches","Async Calls","Executables")";
+  os << R"("Constants","Constant Size","Variables","Variable Size","Awaits","Submissions","Transient Size","Fills","Copies","Dispatches","Async Calls","Executables","Transient Packed Size","Transient Live Bound")";
   os << "\n";
 
   // Globals:
@@ -416,7 +441,11 @@ static void dumpAggregateCSVTable(const UsageInfo &usageInfo,
                       stats.dispatchCount, stats.callCount);
 
   // Executables:
-  os << llvm::formatv("{}", stats.executableCount);
+  os << llvm::formatv("{},", stats.executableCount);
+
+  // Transient packing:
+  os << llvm::formatv("{},{}", stats.transientPackedSize,
+                      stats.transientLiveBound);
 
   os << "\n";
   os << "\n";
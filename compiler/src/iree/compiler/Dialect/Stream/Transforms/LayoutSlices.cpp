@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <list>
+#include <optional>
 
 #include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
@@ -14,6 +15,8 @@
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "iree/compiler/Utils/IntegerSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Sequence.h"
 #include "llvm/Support/Debug.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/IR/AsmState.h"
@@ -34,32 +37,35 @@ namespace {
 
 using Slice = IREE::Stream::ResourcePackOp::Slice;
 
-// Packs a set of statically-sized slices by greedy strip packing.
+// A statically-sized slice being placed by one of the packing heuristics.
+struct StaticSlice {
+  const Slice *slice = nullptr;
+  int64_t alignedSize = 0;
+};
+
+// Result of placing a set of static slices with a particular heuristic.
+struct StaticPacking {
+  // Name of the heuristic that produced the packing.
+  StringRef heuristic;
+  // Offset of each slice in the same order as the input slices.
+  SmallVector<int64_t> offsets;
+  // Total number of bytes required to hold all slices (unaligned).
+  int64_t highwaterMark = 0;
+};
+
+// Places |staticSlices| in the given |order| by strip packing: each slice is
+// placed into a gap between the already placed slices whose lifetimes
+// intersect with it. When |bestFit| is true the smallest gap that fits is
+// chosen and otherwise the lowest one is. Slices that do not fit in any gap
+// are placed above the highest intersecting slice.
 //
-// This is the same algorithm used in tflite here:
+// With the slices in their original (ascending lifetime) order and best-fit
+// this is the same algorithm used in tflite here:
 // https://github.com/tensorflow/tensorflow/blob/master/tensorflow/lite/simple_memory_arena.cc
-// It's not fantastic and can end up with a significant amount of wastage.
-// They do the packing at runtime and as such care more about performance than
-// we do while doing the packing here offline. For this initial version I
-// wanted to ensure we matched apples/apples their implementation.
-//
-// We should use a set of heuristics and pick the smallest one. There are also
-// some really great papers that have approximations (as all of these are -
-// 2D strip packing is NP-hard) such as
-// https://www.sciencedirect.com/science/article/pii/S0925772113001016 that
-// someone with a brain able to parse mathy papers can try implementing.
-//
-// Slice packed offset SSA values will be updated and start at the given
-// |baseOffset|. Returns |baseOffset| + the total size of the allocation
-// aligned to the requirements of |resourceConfig|.
-static Value
-packStaticSlicesGreedily(IREE::Stream::ResourcePackOp packOp, Value baseOffset,
-                         MutableArrayRef<Slice> slices,
-                         IREE::Stream::ResourceConfigAttr resourceConfig,
-                         IndexSet &indexSet, OpBuilder &builder) {
-  int64_t offsetAlignment = resourceConfig.getMinBufferOffsetAlignment();
-  int64_t rangeAlignment = resourceConfig.getMinBufferRangeAlignment();
-
+static StaticPacking placeStaticSlices(StringRef heuristic,
+                                       ArrayRef<StaticSlice> staticSlices,
+                                       ArrayRef<unsigned> order, bool bestFit,
+                                       int64_t offsetAlignment) {
   struct Reservation {
     const Slice *slice = nullptr;
     int64_t staticOffset = 0;
@@ -67,18 +73,20 @@ packStaticSlicesGreedily(IREE::Stream::ResourcePackOp packOp, Value baseOffset,
   };
   static constexpr int64_t UNASSIGNED = INT64_MAX;
 
+  StaticPacking packing;
+  packing.heuristic = heuristic;
+  packing.offsets.resize(staticSlices.size(), 0);
   std::list<Reservation> reservations;
-  int64_t highwaterMark = 0;
-  for (auto &slice : slices) {
+  for (unsigned index : order) {
+    const auto &staticSlice = staticSlices[index];
+    const Slice &slice = *staticSlice.slice;
+    int64_t alignedSize = staticSlice.alignedSize;
     int64_t bestOffset = UNASSIGNED;
     int64_t bestOffsetFit = UNASSIGNED;
-    int64_t staticSize =
-        cast<arith::ConstantIndexOp>(slice.dynamicSize.getDefiningOp()).value();
-    int64_t alignedSize = IREE::Util::align(staticSize, rangeAlignment);
 
     // Iterate through reservations (sorted by ascending offset) and identify
     // gaps in which the slice will fit. To reduce wastage we want to find the
-    // smallest gap.
+    // smallest gap when best-fit is requested.
     int64_t currentOffset = 0;
     for (auto &reservation : reservations) {
       if (!reservation.slice->intersects(slice)) {
@@ -94,6 +102,9 @@ packStaticSlicesGreedily(IREE::Stream::ResourcePackOp packOp, Value baseOffset,
           reservation.staticOffset - alignedOffset < bestOffsetFit) {
         bestOffset = alignedOffset;
         bestOffsetFit = reservation.staticOffset - currentOffset;
+        if (!bestFit) {
+          break;
+        }
       }
       currentOffset = std::max(currentOffset, reservation.staticOffset +
                                                   reservation.staticSize);
@@ -113,15 +124,135 @@ packStaticSlicesGreedily(IREE::Stream::ResourcePackOp packOp, Value baseOffset,
       ++insertionIt;
     }
     reservations.insert(insertionIt, reservation);
-    slice.packedOffset.replaceAllUsesWith(builder.createOrFold<arith::AddIOp>(
-        packOp.getLoc(), baseOffset, indexSet.get(bestOffset)));
+    packing.offsets[index] = bestOffset;
 
     // Update highwater mark indicating how much memory needs to be allocated
     // for the entire slab.
-    highwaterMark = std::max(highwaterMark, bestOffset + alignedSize);
+    packing.highwaterMark =
+        std::max(packing.highwaterMark, bestOffset + alignedSize);
   }
+  return packing;
+}
+
+// Returns the maximum number of bytes simultaneously live across all
+// |staticSlices|. No packing can produce an allocation smaller than this.
+static int64_t computeStaticLiveBound(ArrayRef<StaticSlice> staticSlices) {
+  // The peak always begins at the start of some slice lifetime.
+  int64_t maxLiveSize = 0;
+  for (auto &candidate : staticSlices) {
+    int64_t time = candidate.slice->lifetimeStart;
+    int64_t liveSize = 0;
+    for (auto &staticSlice : staticSlices) {
+      if (staticSlice.slice->lifetimeStart <= time &&
+          staticSlice.slice->lifetimeEnd >= time) {
+        liveSize += staticSlice.alignedSize;
+      }
+    }
+    maxLiveSize = std::max(maxLiveSize, liveSize);
+  }
+  return maxLiveSize;
+}
 
-  highwaterMark = IREE::Util::align(highwaterMark, rangeAlignment);
+// Packs a set of statically-sized slices by trying several 2D strip packing
+// heuristics and picking the one producing the smallest allocation. All of
+// them are approximations (2D strip packing is NP-hard) but as we are packing
+// offline we can afford to try a few:
+//   - greedy: slices in lifetime order placed into the best-fitting gap.
+//     This matches the tflite runtime arena and is kept as the baseline.
+//   - size: largest slices first placed into the best-fitting gap.
+//   - lifetime: longest-lived slices first placed into the best-fitting gap.
+//   - interval-coloring: slices in lifetime order placed into the lowest gap
+//     as in first-fit coloring of the interval graph.
+// Ties go to the earlier heuristic in the list. If a heuristic reaches the
+// lower bound given by the maximum number of simultaneously live bytes we stop
+// early as nothing can do better.
+//
+// There are some really great papers that have better approximations such as
+// https://www.sciencedirect.com/science/article/pii/S0925772113001016 that
+// someone with a brain able to parse mathy papers can try implementing.
+//
+// Slice packed offset SSA values will be updated and start at the given
+// |baseOffset|. Returns |baseOffset| + the total size of the allocation
+// aligned to the requirements of |resourceConfig|. |outPackedSize| and
+// |outLiveBound| receive the aligned size of the chosen packing and the lower
+// bound it is measured against.
+static Value
+packStaticSlices(IREE::Stream::ResourcePackOp packOp, Value baseOffset,
+                 MutableArrayRef<Slice> slices,
+                 IREE::Stream::ResourceConfigAttr resourceConfig,
+                 IndexSet &indexSet, OpBuilder &builder,
+                 StringRef &outHeuristic, int64_t &outPackedSize,
+                 int64_t &outLiveBound) {
+  int64_t offsetAlignment = resourceConfig.getMinBufferOffsetAlignment();
+  int64_t rangeAlignment = resourceConfig.getMinBufferRangeAlignment();
+
+  SmallVector<StaticSlice> staticSlices;
+  staticSlices.reserve(slices.size());
+  for (auto &slice : slices) {
+    int64_t staticSize =
+        cast<arith::ConstantIndexOp>(slice.dynamicSize.getDefiningOp()).value();
+    staticSlices.push_back(
+        {&slice, IREE::Util::align(staticSize, rangeAlignment)});
+  }
+  int64_t liveBound = computeStaticLiveBound(staticSlices);
+
+  auto getLifetimeLength = [&](unsigned index) {
+    return staticSlices[index].slice->lifetimeEnd -
+           staticSlices[index].slice->lifetimeStart;
+  };
+  SmallVector<unsigned> lifetimeOrder =
+      llvm::to_vector(llvm::seq<unsigned>(0, staticSlices.size()));
+  SmallVector<unsigned> sizeOrder = lifetimeOrder;
+  llvm::stable_sort(sizeOrder, [&](unsigned lhs, unsigned rhs) {
+    return staticSlices[lhs].alignedSize > staticSlices[rhs].alignedSize;
+  });
+  SmallVector<unsigned> lengthOrder = lifetimeOrder;
+  llvm::stable_sort(lengthOrder, [&](unsigned lhs, unsigned rhs) {
+    int64_t lhsLength = getLifetimeLength(lhs);
+    int64_t rhsLength = getLifetimeLength(rhs);
+    if (lhsLength != rhsLength) {
+      return lhsLength > rhsLength;
+    }
+    return staticSlices[lhs].alignedSize > staticSlices[rhs].alignedSize;
+  });
+
+  struct Heuristic {
+    StringRef name;
+    ArrayRef<unsigned> order;
+    bool bestFit;
+  };
+  Heuristic heuristics[] = {
+      {"greedy", lifetimeOrder, /*bestFit=*/true},
+      {"size", sizeOrder, /*bestFit=*/true},
+      {"lifetime", lengthOrder, /*bestFit=*/true},
+      {"interval-coloring", lifetimeOrder, /*bestFit=*/false},
+  };
+  std::optional<StaticPacking> bestPacking;
+  for (auto &heuristic : heuristics) {
+    auto packing = placeStaticSlices(heuristic.name, staticSlices,
+                                     heuristic.order, heuristic.bestFit,
+                                     offsetAlignment);
+    LLVM_DEBUG(llvm::dbgs() << "[LayoutSlices] " << heuristic.name << ": "
+                            << packing.highwaterMark << " (live bound "
+                            << liveBound << ")\n");
+    if (!bestPacking || packing.highwaterMark < bestPacking->highwaterMark) {
+      bestPacking = std::move(packing);
+    }
+    if (bestPacking->highwaterMark <= liveBound) {
+      break;
+    }
+  }
+
+  for (auto [slice, offset] : llvm::zip_equal(slices, bestPacking->offsets)) {
+    slice.packedOffset.replaceAllUsesWith(builder.createOrFold<arith::AddIOp>(
+        packOp.getLoc(), baseOffset, indexSet.get(offset)));
+  }
+
+  int64_t highwaterMark =
+      IREE::Util::align(bestPacking->highwaterMark, rangeAlignment);
+  outHeuristic = bestPacking->heuristic;
+  outPackedSize = highwaterMark;
+  outLiveBound = liveBound;
   return builder.createOrFold<arith::AddIOp>(packOp.getLoc(), baseOffset,
                                              indexSet.get(highwaterMark));
 }
@@ -227,9 +358,6 @@ struct LayoutSlicesPass
       return;
     }
 
-    // NOTE: we could try several algorithms and compute which packs best. For
-    // now we just pack greedily as it's fast and what most existing ML
-    // frameworks do.
     parentOp.walk([&](IREE::Stream::ResourcePackOp packOp) {
       // Derive resource constraints based on pack affinity.
       auto resourceConfig = IREE::Stream::ResourceConfigAttr::lookup(packOp);
@@ -257,8 +385,28 @@ struct LayoutSlicesPass
       // compile time.
       auto offset = packOp.getOffset() ? packOp.getOffset() : indexSet.get(0);
       if (!staticSlices.empty()) {
-        offset = packStaticSlicesGreedily(packOp, offset, staticSlices,
-                                          resourceConfig, indexSet, builder);
+        StringRef heuristic;
+        int64_t packedSize = 0;
+        int64_t liveBound = 0;
+        offset = packStaticSlices(packOp, offset, staticSlices, resourceConfig,
+                                  indexSet, builder, heuristic, packedSize,
+                                  liveBound);
+
+        // Record how well we packed on the allocations of the slab so that
+        // statistics can report the wastage.
+        auto packingAttr = builder.getDictionaryAttr({
+            builder.getNamedAttr("heuristic",
+                                 builder.getStringAttr(heuristic)),
+            builder.getNamedAttr("live_bound",
+                                 builder.getI64IntegerAttr(liveBound)),
+            builder.getNamedAttr("packed_size",
+                                 builder.getI64IntegerAttr(packedSize)),
+        });
+        for (auto *user : packOp.getTotalLength().getUsers()) {
+          if (isa<IREE::Stream::ResourceAllocaOp>(user)) {
+            user->setAttr("stream.slice_packing", packingAttr);
+          }
+        }
 
         // TODO(benvanik): make this an option; it can be useful for debugging
         // this code.
@@ -8,10 +8,14 @@
 #include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamTypes.h"
 #include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "mlir/IR/AsmState.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Dominance.h"
+#include "mlir/Interfaces/ControlFlowInterfaces.h"
 #include "mlir/Pass/Pass.h"
 
 namespace mlir::iree_compiler::IREE::Stream {
@@ -21,95 +25,373 @@ namespace mlir::iree_compiler::IREE::Stream {
 
 namespace {
 
+//===----------------------------------------------------------------------===//
+// Lifetime analysis
+//===----------------------------------------------------------------------===//
+
+// Returns true if |block| can reach itself along a path that does not pass
+// through |barrierBlock|.
+static bool isInCycleAvoiding(Block *block, Block *barrierBlock) {
+  SmallPtrSet<Block *, 8> visitedBlocks;
+  SmallVector<Block *> worklist = llvm::to_vector(block->getSuccessors());
+  while (!worklist.empty()) {
+    Block *nextBlock = worklist.pop_back_val();
+    if (nextBlock == block) {
+      return true;
+    }
+    if (nextBlock == barrierBlock || !visitedBlocks.insert(nextBlock).second) {
+      continue;
+    }
+    llvm::append_range(worklist, nextBlock->getSuccessors());
+  }
+  return false;
+}
+
+// Answers lifetime queries about transient resources within a callable region.
+// Reusing a deallocated resource removes the deallocation and extends the
+// lifetime of the resource over the allocation that replaces it: this is only
+// valid if every execution of the deallocation is paired with exactly one
+// execution of the allocation or the resource would leak or be aliased.
+class ReuseLifetimeAnalysis {
+public:
+  explicit ReuseLifetimeAnalysis(Operation *parentOp)
+      : domInfo(parentOp), postDomInfo(parentOp) {}
+
+  DominanceInfo &getDominanceInfo() { return domInfo; }
+
+  // Returns true if |laterBlock| executes exactly once for each execution of
+  // |earlierBlock|: all paths through |earlierBlock| continue to |laterBlock|
+  // and neither block can repeat without the other.
+  bool areExecutedTogether(Block *earlierBlock, Block *laterBlock) {
+    if (earlierBlock == laterBlock) {
+      return true;
+    } else if (earlierBlock->getParent() != laterBlock->getParent()) {
+      return false;
+    }
+    return domInfo.dominates(earlierBlock, laterBlock) &&
+           postDomInfo.postDominates(laterBlock, earlierBlock) &&
+           !isInCycleAvoiding(earlierBlock, laterBlock) &&
+           !isInCycleAvoiding(laterBlock, earlierBlock);
+  }
+
+private:
+  DominanceInfo domInfo;
+  PostDominanceInfo postDomInfo;
+};
+
 //===----------------------------------------------------------------------===//
 // --iree-stream-reuse-allocations
 //===----------------------------------------------------------------------===//
 
-// Tries to replace the transient |allocaOp| with the operand of a prior
-// deallocation on the same affinity and timeline. Only deallocations in the
-// same block are checked.
-//
-// NOTE: assumes the alloca is uninitialized as the contents will be undefined.
-//
-// Returns true if the allocation was replaced.
-static bool
-tryReuseExistingAllocation(IREE::Stream::ResourceAllocaOp allocaOp) {
-  // A walk is performed on the timeline defined by the timepoint SSA values.
-  // Immediate allocations have no timeline and ones from
-  auto awaitTimepoint = allocaOp.getAwaitTimepoint();
-  if (!awaitTimepoint) {
-    return false; // only timeline-based allocations are checked
+class AllocationReuser {
+public:
+  AllocationReuser(Operation *parentOp, bool unifiedMemoryReuse)
+      : lifetimeAnalysis(parentOp), unifiedMemoryReuse(unifiedMemoryReuse) {}
+
+  // Tries to replace the transient |allocaOp| with the operand of a prior
+  // deallocation that it awaits. Returns true if the allocation was replaced.
+  //
+  // NOTE: assumes the alloca is uninitialized as the contents will be
+  // undefined.
+  bool tryReuse(IREE::Stream::ResourceAllocaOp allocaOp) {
+    return tryReuseDominatingAllocation(allocaOp) ||
+           tryReuseLoopCarriedAllocation(allocaOp);
   }
-  auto awaitOp = dyn_cast_if_present<IREE::Stream::TimelineOpInterface>(
-      awaitTimepoint.getDefiningOp());
-  if (!awaitOp) {
-    return false; // only timeline-based allocations are checked
-  } else if (awaitOp->getBlock() != allocaOp->getBlock()) {
-    return false; // only local analysis here
+
+  int64_t numAllocationsReused = 0;
+  int64_t numLoopCarriedAllocations = 0;
+  int64_t numCrossAffinityReuses = 0;
+
+private:
+  // Returns true if memory released on the affinity of |deallocaOp| can be
+  // used to service an allocation on the affinity of |allocaOp|.
+  bool areAffinitiesCompatible(IREE::Stream::ResourceDeallocaOp deallocaOp,
+                               IREE::Stream::ResourceAllocaOp allocaOp) {
+    auto deallocaAffinityAttr = deallocaOp.getAffinityAttr();
+    auto allocaAffinityAttr = allocaOp.getAffinityAttr();
+    if (deallocaAffinityAttr == allocaAffinityAttr) {
+      return true;
+    }
+    // Unknown placement is never assumed compatible with a known one.
+    if (!deallocaAffinityAttr || !allocaAffinityAttr) {
+      return false;
+    }
+    // Affinities that can execute with one another (such as queue subsets of
+    // the same device) share the same memory.
+    if (deallocaAffinityAttr.isExecutableWith(allocaAffinityAttr) ||
+        allocaAffinityAttr.isExecutableWith(deallocaAffinityAttr)) {
+      return true;
+    }
+    // Distinct devices can only share memory when both use a unified memory
+    // model (no NUMA). We can't verify that the devices are physically the
+    // same here and rely on the user opting in.
+    if (!unifiedMemoryReuse) {
+      return false;
+    }
+    auto deallocaConfigAttr =
+        IREE::Stream::ResourceConfigAttr::lookup(deallocaOp);
+    auto allocaConfigAttr = IREE::Stream::ResourceConfigAttr::lookup(allocaOp);
+    return deallocaConfigAttr.getMemoryModel() ==
+               IREE::Stream::MemoryModel::Unified &&
+           allocaConfigAttr.getMemoryModel() ==
+               IREE::Stream::MemoryModel::Unified;
   }
 
-  // TODO(benvanik): allow reuse across compatible affinities when in
-  // unified memory mode (no NUMA). This information needs device analysis in a
-  // way we don't have access to here yet. We could make it a flag to start
-  // (ala the existing --iree-stream-resource-* flags).
-  auto isCandidateDeallocaOp =
-      [&](IREE::Stream::ResourceDeallocaOp deallocaOp) {
-        return deallocaOp.getOperandSize() == allocaOp.getStorageSize() &&
-               deallocaOp.getOperand().getType() ==
-                   allocaOp.getResult().getType() &&
-               deallocaOp.getAffinity() == allocaOp.getAffinity() &&
-               deallocaOp->getBlock() == allocaOp->getBlock();
-      };
-
-  // Walk up timepoint joins and look for a dealloca that can be reused.
-  // This is a local analysis and stops at the first op outside of the local
-  // block.
-  IREE::Stream::ResourceDeallocaOp chosenDeallocaOp;
-  SmallVector<Operation *> worklist;
-  worklist.push_back(awaitTimepoint.getDefiningOp());
-  while (!worklist.empty()) {
-    auto *workOp = worklist.pop_back_val();
-    if (auto deallocaOp = dyn_cast<IREE::Stream::ResourceDeallocaOp>(workOp)) {
-      if (isCandidateDeallocaOp(deallocaOp)) {
-        chosenDeallocaOp = deallocaOp;
-        break;
+  // Walks up the timeline from |timepoint| through joins and returns the first
+  // deallocation that is compatible with |allocaOp| and accepted by
+  // |isLifetimeCompatible|. Returns nullptr if none is found.
+  IREE::Stream::ResourceDeallocaOp findReusableDeallocaOp(
+      Value timepoint, IREE::Stream::ResourceAllocaOp allocaOp,
+      llvm::function_ref<bool(IREE::Stream::ResourceDeallocaOp)>
+          isLifetimeCompatible) {
+    SmallPtrSet<Operation *, 8> visitedOps;
+    SmallVector<Value> worklist;
+    worklist.push_back(timepoint);
+    while (!worklist.empty()) {
+      auto *workOp = worklist.pop_back_val().getDefiningOp();
+      if (!workOp || !visitedOps.insert(workOp).second) {
+        continue;
       }
-    } else if (auto joinOp = dyn_cast<IREE::Stream::TimepointJoinOp>(workOp)) {
-      for (auto joinTimepoint : joinOp.getAwaitTimepoints()) {
-        if (auto *definingOp = joinTimepoint.getDefiningOp()) {
-          if (definingOp->getBlock() == allocaOp->getBlock()) {
-            worklist.push_back(definingOp);
-          }
+      if (auto deallocaOp =
+              dyn_cast<IREE::Stream::ResourceDeallocaOp>(workOp)) {
+        if (deallocaOp.getOperandSize() == allocaOp.getStorageSize() &&
+            deallocaOp.getOperand().getType() ==
+                allocaOp.getResult().getType() &&
+            areAffinitiesCompatible(deallocaOp, allocaOp) &&
+            isLifetimeCompatible(deallocaOp)) {
+          return deallocaOp;
         }
+      } else if (auto joinOp =
+                     dyn_cast<IREE::Stream::TimepointJoinOp>(workOp)) {
+        llvm::append_range(worklist, joinOp.getAwaitTimepoints());
       }
     }
+    return {};
+  }
+
+  // Erases |deallocaOp| so that its operand remains live and returns the
+  // timepoint at which the resource is available for reuse.
+  Value eraseDeallocaOp(IREE::Stream::ResourceDeallocaOp deallocaOp,
+                        IREE::Stream::ResourceAllocaOp allocaOp) {
+    if (deallocaOp.getAffinityAttr() != allocaOp.getAffinityAttr()) {
+      ++numCrossAffinityReuses;
+    }
+    Value availableTimepoint = deallocaOp.getAwaitTimepoint();
+    if (!availableTimepoint) {
+      OpBuilder builder(deallocaOp);
+      availableTimepoint = IREE::Stream::TimepointImmediateOp::create(
+          builder, deallocaOp.getLoc());
+    }
+    deallocaOp.replaceAllUsesWith(availableTimepoint);
+    deallocaOp.erase();
+    return availableTimepoint;
   }
-  if (!chosenDeallocaOp) {
-    return false; // no candidate dealloca ops found on local timeline
+
+  // Reuses a deallocation that dominates |allocaOp| on the timeline and in
+  // the CFG. The deallocation may be in another block so long as the two ops
+  // are always executed together.
+  bool tryReuseDominatingAllocation(IREE::Stream::ResourceAllocaOp allocaOp) {
+    // A walk is performed on the timeline defined by the timepoint SSA values.
+    // Immediate allocations have no timeline and are not checked.
+    auto awaitTimepoint = allocaOp.getAwaitTimepoint();
+    if (!awaitTimepoint) {
+      return false;
+    }
+    auto deallocaOp = findReusableDeallocaOp(
+        awaitTimepoint, allocaOp,
+        [&](IREE::Stream::ResourceDeallocaOp candidateOp) {
+          return lifetimeAnalysis.areExecutedTogether(candidateOp->getBlock(),
+                                                      allocaOp->getBlock());
+        });
+    if (!deallocaOp) {
+      return false; // no candidate dealloca ops found on the timeline
+    }
+
+    // Replace the allocation with the previously deallocated resource and
+    // erase the deallocation so it remains live. Users of the allocated
+    // resource are updated to wait on whatever the deallocation was so the
+    // resource is known to be available for reuse.
+    Value resource = deallocaOp.getOperand();
+    Value availableTimepoint = eraseDeallocaOp(deallocaOp, allocaOp);
+    allocaOp.replaceAllUsesWith(ValueRange{resource, availableTimepoint});
+    allocaOp.erase();
+    ++numAllocationsReused;
+    return true;
   }
 
-  // Replace the allocation with the previously deallocated resource and
-  // erase the deallocation so it remains live. Users of the allocated
-  // resource are updated to wait on whatever the deallocation was so the
-  // resource is known to be available for reuse.
-  Value availableTimepoint = chosenDeallocaOp.getAwaitTimepoint();
-  if (!availableTimepoint) {
-    OpBuilder builder(chosenDeallocaOp);
-    availableTimepoint = IREE::Stream::TimepointImmediateOp::create(
-        builder, chosenDeallocaOp.getLoc());
+  // Reuses the resource deallocated at the end of a loop iteration for the
+  // allocation at the start of the next one by carrying it across the back
+  // edge. Example:
+  //   ^header(%tp: !stream.timepoint):
+  //     cf.cond_br %cond, ^body, ^exit
+  //   ^body:
+  //     %r, %r_tp = stream.resource.alloca await(%tp) ...
+  //     %d_tp = stream.resource.dealloca await(...) => %r ...
+  //     cf.br ^header(%d_tp)
+  // Becomes:
+  //   ^header(%tp: !stream.timepoint, %r: !stream.resource<transient>):
+  //     cf.cond_br %cond, ^body, ^exit
+  //   ^body:
+  //     cf.br ^header(%d_await_tp, %r)
+  //   ^exit:
+  //     stream.resource.dealloca await(%tp) => %r ...
+  // Edges entering the loop allocate the resource once before the loop.
+  bool tryReuseLoopCarriedAllocation(IREE::Stream::ResourceAllocaOp allocaOp) {
+    Value awaitTimepoint = allocaOp.getAwaitTimepoint();
+    if (!awaitTimepoint) {
+      return false;
+    }
+    auto blockArg = dyn_cast<BlockArgument>(awaitTimepoint);
+    if (!blockArg) {
+      return false;
+    }
+    Block *headerBlock = blockArg.getOwner();
+    Block *allocaBlock = allocaOp->getBlock();
+    if (headerBlock->isEntryBlock() || headerBlock == allocaBlock ||
+        allocaBlock->getSinglePredecessor() != headerBlock) {
+      return false; // only simple loops with a separate body
+    }
+
+    // The loop must exit from the header into a block only reachable from
+    // the header so that the carried resource can be deallocated there.
+    Operation *headerTerminator = headerBlock->getTerminator();
+    if (headerTerminator->getNumSuccessors() != 2) {
+      return false;
+    }
+    Block *exitBlock = headerTerminator->getSuccessor(0) == allocaBlock
+                           ? headerTerminator->getSuccessor(1)
+                           : headerTerminator->getSuccessor(0);
+    if (exitBlock == allocaBlock ||
+        exitBlock->getSinglePredecessor() != headerBlock) {
+      return false;
+    }
+    Value storageSize = allocaOp.getStorageSize();
+    DominanceInfo &domInfo = lifetimeAnalysis.getDominanceInfo();
+    if (!domInfo.properlyDominates(storageSize, headerTerminator)) {
+      return false; // size must be loop-invariant
+    }
+
+    // Classify each edge into the header as either reusing a deallocation
+    // from the previous iteration or entering the loop with a new allocation.
+    struct IncomingEdge {
+      BranchOpInterface branchOp;
+      unsigned successorIndex;
+      IREE::Stream::ResourceDeallocaOp deallocaOp;
+    };
+    auto getTimepointOperand = [&](IncomingEdge &edge) -> OpOperand & {
+      auto successorOperands =
+          edge.branchOp.getSuccessorOperands(edge.successorIndex);
+      return successorOperands.getMutableForwardedOperands()
+          [blockArg.getArgNumber() -
+           successorOperands.getProducedOperandCount()];
+    };
+    SmallVector<IncomingEdge> incomingEdges;
+    SmallPtrSet<Operation *, 4> chosenDeallocaOps;
+    bool hasReuseEdge = false;
+    for (auto it = headerBlock->pred_begin(), end = headerBlock->pred_end();
+         it != end; ++it) {
+      Block *predecessorBlock = *it;
+      auto branchOp =
+          dyn_cast<BranchOpInterface>(predecessorBlock->getTerminator());
+      if (!branchOp || blockArg.getArgNumber() <
+                           branchOp.getSuccessorOperands(it.getSuccessorIndex())
+                               .getProducedOperandCount()) {
+        return false;
+      }
+      IncomingEdge edge{branchOp, it.getSuccessorIndex(), {}};
+      edge.deallocaOp = findReusableDeallocaOp(
+          getTimepointOperand(edge).get(), allocaOp,
+          [&](IREE::Stream::ResourceDeallocaOp candidateOp) {
+            Block *deallocaBlock = candidateOp->getBlock();
+            return !chosenDeallocaOps.contains(candidateOp) &&
+                   lifetimeAnalysis.areExecutedTogether(allocaBlock,
+                                                        deallocaBlock) &&
+                   lifetimeAnalysis.areExecutedTogether(deallocaBlock,
+                                                        predecessorBlock);
+          });
+      if (edge.deallocaOp) {
+        chosenDeallocaOps.insert(edge.deallocaOp);
+        hasReuseEdge = true;
+      } else if (domInfo.dominates(headerBlock, predecessorBlock) ||
+                 !domInfo.properlyDominates(storageSize,
+                                            branchOp.getOperation())) {
+        // Back edges without a deallocation would leak the carried resource.
+        return false;
+      }
+      incomingEdges.push_back(edge);
+    }
+    if (!hasReuseEdge) {
+      return false; // nothing to reuse; hoisting alone is not profitable
+    }
+
+    // Carry the resource across all edges into the header. Operands are only
+    // appended once all edges have been updated as appending may invalidate
+    // the operands of other edges from the same branch op.
+    SmallVector<Value> edgeResources;
+    for (auto &edge : incomingEdges) {
+      if (edge.deallocaOp) {
+        edgeResources.push_back(edge.deallocaOp.getOperand());
+        eraseDeallocaOp(edge.deallocaOp, allocaOp);
+        continue;
+      }
+      OpOperand &timepointOperand = getTimepointOperand(edge);
+      OpBuilder builder(edge.branchOp);
+      auto entryAllocaOp = IREE::Stream::ResourceAllocaOp::create(
+          builder, allocaOp.getLoc(), allocaOp.getResult().getType(),
+          allocaOp.getResultTimepoint().getType(), storageSize,
+          allocaOp.getIndeterminateLifetimeAttr(), timepointOperand.get(),
+          allocaOp.getAffinityAttr());
+      timepointOperand.set(entryAllocaOp.getResultTimepoint());
+      edgeResources.push_back(entryAllocaOp.getResult());
+    }
+    Value carriedResource = headerBlock->addArgument(
+        allocaOp.getResult().getType(), allocaOp.getLoc());
+    for (auto [edge, resource] :
+         llvm::zip_equal(incomingEdges, edgeResources)) {
+      edge.branchOp.getSuccessorOperands(edge.successorIndex).append(resource);
+    }
+    allocaOp.replaceAllUsesWith(ValueRange{carriedResource, blockArg});
+    allocaOp.erase();
+
+    // Deallocate the carried resource when leaving the loop. Users of the
+    // timepoint after the loop wait on the deallocation as they did on the
+    // deallocation of the final iteration prior to the change.
+    Value exitTimepoint = blockArg;
+    unsigned exitSuccessorIndex =
+        headerTerminator->getSuccessor(0) == exitBlock ? 0 : 1;
+    auto exitOperands = cast<BranchOpInterface>(headerTerminator)
+                            .getSuccessorOperands(exitSuccessorIndex);
+    for (unsigned i = 0; i < exitBlock->getNumArguments(); ++i) {
+      if (exitOperands[i] == blockArg) {
+        exitTimepoint = exitBlock->getArgument(i);
+        break;
+      }
+    }
+    auto exitBuilder = OpBuilder::atBlockBegin(exitBlock);
+    auto exitDeallocaOp = IREE::Stream::ResourceDeallocaOp::create(
+        exitBuilder, allocaOp.getLoc(), carriedResource, storageSize,
+        /*prefer_origin=*/false, exitTimepoint, allocaOp.getAffinityAttr());
+    exitTimepoint.replaceUsesWithIf(
+        exitDeallocaOp.getResultTimepoint(), [&](OpOperand &use) {
+          Operation *exitOp = exitDeallocaOp.getOperation();
+          return use.getOwner() != exitOp &&
+                 domInfo.properlyDominates(exitOp, use.getOwner());
+        });
+
+    ++numAllocationsReused;
+    ++numLoopCarriedAllocations;
+    return true;
   }
-  allocaOp.replaceAllUsesWith(
-      ValueRange{chosenDeallocaOp.getOperand(), availableTimepoint});
-  allocaOp.erase();
-  chosenDeallocaOp.replaceAllUsesWith(availableTimepoint);
-  chosenDeallocaOp.erase();
 
-  return true;
-}
+  ReuseLifetimeAnalysis lifetimeAnalysis;
+  bool unifiedMemoryReuse;
+};
 
 struct ReuseAllocationsPass
     : public IREE::Stream::impl::ReuseAllocationsPassBase<
           ReuseAllocationsPass> {
+  using IREE::Stream::impl::ReuseAllocationsPassBase<
+      ReuseAllocationsPass>::ReuseAllocationsPassBase;
   void runOnOperation() override {
     mlir::CallableOpInterface parentOp = getOperation();
     if (!parentOp.getCallableRegion() ||
@@ -118,14 +400,22 @@ struct ReuseAllocationsPass
     }
 
     // Traversal order defines whether earlier (pre-order) or later (post-order)
-    // allocations are reused. It does not seem to make much of a difference
-    // given the strict local behavior of the pass.
-    bool didChange = false;
-    for (auto allocaOp : llvm::make_early_inc_range(
-             parentOp.getCallableRegion()
-                 ->getOps<IREE::Stream::ResourceAllocaOp>())) {
-      didChange = tryReuseExistingAllocation(allocaOp) || didChange;
+    // allocations are reused. Earlier reuse is preferred so that deallocations
+    // inserted when leaving loops can be reused by allocations after the loop.
+    // The CFG is never modified and the lifetime analysis remains valid.
+    AllocationReuser reuser(parentOp, unifiedMemoryReuse);
+    SmallVector<IREE::Stream::ResourceAllocaOp> allocaOps;
+    for (auto &block : *parentOp.getCallableRegion()) {
+      llvm::append_range(allocaOps,
+                         block.getOps<IREE::Stream::ResourceAllocaOp>());
+    }
+    for (auto allocaOp : allocaOps) {
+      reuser.tryReuse(allocaOp);
     }
+
+    numAllocationsReused += reuser.numAllocationsReused;
+    numLoopCarriedAllocations += reuser.numLoopCarriedAllocations;
+    numCrossAffinityReuses += reuser.numCrossAffinityReuses;
   }
 };
 
@@ -29,6 +29,40 @@ util.func public @layoutStatic() -> (index, index, index, index, index, index, i
 
 // -----
 
+#layoutStaticHeuristicsConfig = #stream.resource_config<{
+  max_allocation_size = 1073741824,
+  min_buffer_offset_alignment = 16,
+  max_buffer_range = 1073741824,
+  min_buffer_range_alignment = 16,
+  index_bits = 32
+}>
+
+// Tests that the smallest of the packing heuristics is chosen and that the
+// result is recorded on the allocation of the slab. Packing in lifetime order
+// would place [4, 7] above [3, 6] and require 128 bytes while placing the
+// largest slices first reaches the 112 byte live bound.
+
+// CHECK-LABEL: @layoutStaticHeuristics
+util.func public @layoutStaticHeuristics(%await: !stream.timepoint) -> (!stream.resource<transient>, index, index, index)
+    attributes {stream.resources = #layoutStaticHeuristicsConfig} {
+  %c16 = arith.constant 16 : index
+  %c48 = arith.constant 48 : index
+  %c64 = arith.constant 64 : index
+  %t:4 = stream.resource.pack slices({
+    [1, 3] = %c16,  // +0
+    [3, 6] = %c48,  // +64 (above [4, 7])
+    [4, 7] = %c64,  // +0 (reuse [1, 3])
+  }) : index
+  // CHECK: stream.resource.alloca
+  // CHECK-SAME: stream.slice_packing = {heuristic = "size", live_bound = 112 : i64, packed_size = 112 : i64}
+  // CHECK-SAME: !stream.resource<transient>{%c112}
+  %alloca, %alloca_timepoint = stream.resource.alloca uninitialized await(%await) => !stream.resource<transient>{%t#0} => !stream.timepoint
+  // CHECK: util.return %{{.+}}, %c0, %c64, %c0
+  util.return %alloca, %t#1, %t#2, %t#3 : !stream.resource<transient>, index, index, index
+}
+
+// -----
+
 #layoutDynamicConfig = #stream.resource_config<{
   max_allocation_size = 1073741824,
   min_buffer_offset_alignment = 16,
@@ -1,4 +1,5 @@
 // RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(util.func(iree-stream-reuse-allocations))' %s | FileCheck %s
+// RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(util.func(iree-stream-reuse-allocations{unified-memory=true}))' %s | FileCheck %s --check-prefix=UNIFIED
 
 // Tests that a direct reuse of a deallocated resource is reused.
 
@@ -28,36 +29,114 @@ util.func private @reuseTypeMismatch(%input_timepoint: !stream.timepoint, %input
 
 // -----
 
-// Tests that affinities are checked for compatibility before reusing.
+// Tests that affinities are checked for compatibility before reusing. Distinct
+// devices are only compatible when opted in and using unified memory.
 
 // CHECK-LABEL: @reuseAffinityMismatch
+// UNIFIED-LABEL: @reuseAffinityMismatch
 util.func private @reuseAffinityMismatch(%input_timepoint: !stream.timepoint, %input_resource: !stream.resource<transient>, %size: index) -> (!stream.resource<transient>, !stream.timepoint) {
   // CHECK: stream.resource.dealloca
+  // UNIFIED-NOT: stream.resource.dealloca
   %dealloca_timepoint = stream.resource.dealloca on(#hal.device.promise<@device0>) await(%input_timepoint) => %input_resource : !stream.resource<transient>{%size} => !stream.timepoint
   // CHECK: stream.resource.alloca
+  // UNIFIED-NOT: stream.resource.alloca
   %output_resource, %alloca_timepoint = stream.resource.alloca uninitialized on(#hal.device.promise<@device1>) await(%dealloca_timepoint) => !stream.resource<transient>{%size} => !stream.timepoint
   util.return %output_resource, %alloca_timepoint : !stream.resource<transient>, !stream.timepoint
 }
 
 // -----
 
-// Tests that only block-local deallocations are checked in the current local
-// analysis.
+// Tests that compatible queue affinities on the same device are reused.
 
-// CHECK-LABEL: @reuseInBlockOnly
+// CHECK-LABEL: @reuseQueueAffinity
 // CHECK-SAME: (%[[INPUT_TIMEPOINT:.+]]: !stream.timepoint, %[[INPUT_RESOURCE:.+]]: !stream.resource<transient>, %[[SIZE:.+]]: index)
-util.func private @reuseInBlockOnly(%input_timepoint: !stream.timepoint, %input_resource: !stream.resource<transient>, %size: index) -> (!stream.resource<transient>, !stream.timepoint) {
-  // CHECK: stream.resource.dealloca
+util.func private @reuseQueueAffinity(%input_timepoint: !stream.timepoint, %input_resource: !stream.resource<transient>, %size: index) -> (!stream.resource<transient>, !stream.timepoint) {
+  // CHECK-NOT: stream.resource.dealloca
+  %dealloca_timepoint = stream.resource.dealloca on(#hal.device.promise<@device0, [0, 1]>) await(%input_timepoint) => %input_resource : !stream.resource<transient>{%size} => !stream.timepoint
+  // CHECK-NOT: stream.resource.alloca
+  %output_resource, %alloca_timepoint = stream.resource.alloca uninitialized on(#hal.device.promise<@device0, [1]>) await(%dealloca_timepoint) => !stream.resource<transient>{%size} => !stream.timepoint
+  // CHECK: util.return %[[INPUT_RESOURCE]], %[[INPUT_TIMEPOINT]]
+  util.return %output_resource, %alloca_timepoint : !stream.resource<transient>, !stream.timepoint
+}
+
+// -----
+
+// Tests that deallocations in dominating blocks are reused when the allocation
+// always executes after them.
+
+// CHECK-LABEL: @reuseAcrossBlocks
+// CHECK-SAME: (%[[INPUT_TIMEPOINT:.+]]: !stream.timepoint, %[[INPUT_RESOURCE:.+]]: !stream.resource<transient>, %[[SIZE:.+]]: index)
+util.func private @reuseAcrossBlocks(%input_timepoint: !stream.timepoint, %input_resource: !stream.resource<transient>, %size: index) -> (!stream.resource<transient>, !stream.timepoint) {
+  // CHECK-NOT: stream.resource.dealloca
   %dealloca_timepoint = stream.resource.dealloca await(%input_timepoint) => %input_resource : !stream.resource<transient>{%size} => !stream.timepoint
   cf.br ^bb2
 ^bb2:
-  // CHECK: stream.resource.alloca
+  // CHECK-NOT: stream.resource.alloca
   %output_resource, %alloca_timepoint = stream.resource.alloca uninitialized await(%dealloca_timepoint) =>  !stream.resource<transient>{%size} => !stream.timepoint
+  // CHECK: util.return %[[INPUT_RESOURCE]], %[[INPUT_TIMEPOINT]]
   util.return %output_resource, %alloca_timepoint : !stream.resource<transient>, !stream.timepoint
 }
 
 // -----
 
+// Tests that deallocations are not reused by allocations that may not execute
+// as the resource would otherwise leak on the other paths.
+
+// CHECK-LABEL: @reuseConditionalBlock
+util.func private @reuseConditionalBlock(%input_timepoint: !stream.timepoint, %input_resource: !stream.resource<transient>, %size: index, %cond: i1) -> !stream.timepoint {
+  // CHECK: stream.resource.dealloca
+  %dealloca_timepoint = stream.resource.dealloca await(%input_timepoint) => %input_resource : !stream.resource<transient>{%size} => !stream.timepoint
+  cf.cond_br %cond, ^bb1, ^bb2(%dealloca_timepoint : !stream.timepoint)
+^bb1:
+  // CHECK: stream.resource.alloca
+  %output_resource, %alloca_timepoint = stream.resource.alloca uninitialized await(%dealloca_timepoint) =>  !stream.resource<transient>{%size} => !stream.timepoint
+  %output_timepoint = stream.resource.dealloca await(%alloca_timepoint) => %output_resource : !stream.resource<transient>{%size} => !stream.timepoint
+  cf.br ^bb2(%output_timepoint : !stream.timepoint)
+^bb2(%result_timepoint: !stream.timepoint):
+  util.return %result_timepoint : !stream.timepoint
+}
+
+// -----
+
+// Tests that deallocations in the body of a loop are carried across the back
+// edge to the allocation in the next iteration. The resource is allocated once
+// when entering the loop and deallocated once when leaving it.
+
+// CHECK-LABEL: @reuseLoopCarried
+// CHECK-SAME: (%[[INPUT_TIMEPOINT:.+]]: !stream.timepoint, %[[SIZE:.+]]: index, %[[COUNT:.+]]: index)
+util.func private @reuseLoopCarried(%input_timepoint: !stream.timepoint, %size: index, %count: index) -> !stream.timepoint {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c0_i32 = arith.constant 0 : i32
+  // CHECK: %[[ENTRY_RESOURCE:.+]], %[[ENTRY_TIMEPOINT:.+]] = stream.resource.alloca uninitialized await(%[[INPUT_TIMEPOINT]]) => !stream.resource<transient>{%[[SIZE]]}
+  // CHECK: cf.br ^bb1(%c0, %[[ENTRY_TIMEPOINT]], %[[ENTRY_RESOURCE]] : index, !stream.timepoint, !stream.resource<transient>)
+  cf.br ^bb1(%c0, %input_timepoint : index, !stream.timepoint)
+// CHECK: ^bb1(%[[I:.+]]: index, %[[TIMEPOINT:.+]]: !stream.timepoint, %[[RESOURCE:.+]]: !stream.resource<transient>):
+^bb1(%i: index, %timepoint: !stream.timepoint):
+  %cond = arith.cmpi slt, %i, %count : index
+  cf.cond_br %cond, ^bb2, ^bb3
+// CHECK: ^bb2:
+^bb2:
+  // CHECK-NOT: stream.resource.alloca
+  %resource, %alloca_timepoint = stream.resource.alloca uninitialized await(%timepoint) => !stream.resource<transient>{%size} => !stream.timepoint
+  // CHECK: %[[EXECUTE_TIMEPOINT:.+]] = stream.cmd.execute await(%[[TIMEPOINT]]) => with(%[[RESOURCE]] as
+  %execute_timepoint = stream.cmd.execute await(%alloca_timepoint) => with(%resource as %capture: !stream.resource<transient>{%size}) {
+    stream.cmd.fill %c0_i32, %capture[%c0 for %size] : i32 -> !stream.resource<transient>{%size}
+  } => !stream.timepoint
+  // CHECK-NOT: stream.resource.dealloca
+  %dealloca_timepoint = stream.resource.dealloca await(%execute_timepoint) => %resource : !stream.resource<transient>{%size} => !stream.timepoint
+  %next = arith.addi %i, %c1 : index
+  // CHECK: cf.br ^bb1(%{{.+}}, %[[EXECUTE_TIMEPOINT]], %[[RESOURCE]] : index, !stream.timepoint, !stream.resource<transient>)
+  cf.br ^bb1(%next, %dealloca_timepoint : index, !stream.timepoint)
+// CHECK: ^bb3:
+^bb3:
+  // CHECK: %[[EXIT_TIMEPOINT:.+]] = stream.resource.dealloca await(%[[TIMEPOINT]]) => %[[RESOURCE]] : !stream.resource<transient>{%[[SIZE]]}
+  // CHECK: util.return %[[EXIT_TIMEPOINT]]
+  util.return %timepoint : !stream.timepoint
+}
+
+// -----
+
 // Tests that the reuse selection logic crosses timeline join ops.
 
 // CHECK-LABEL: @reuseResourceThroughJoin
@@ -186,3 +186,43 @@ util.func public @groupCollectiveOps(%channel: !stream.channel, %send0: !stream.
   util.optimization_barrier %result#1 : !stream.resource<transient>
   util.return
 }
+
+// -----
+
+// Tests that the balanced cost model groups ops of similar estimated cost into
+// the same wave: the two large dispatches run together and the small splat
+// runs alongside the small dispatch instead of waiting behind a large one.
+
+// CHECK-LABEL: @partitioningForBalanced
+// CHECK-SAME: (%[[ARG0:.+]]: !stream.resource<external>)
+util.func public @partitioningForBalanced(%arg0: !stream.resource<external>) -> (!stream.resource<external>, !stream.resource<external>, !stream.resource<external>)
+    attributes {stream.partitioning = #stream.partitioning_config<"balanced">} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c20 = arith.constant 20 : index
+  %c1024 = arith.constant 1024 : index
+  %c255_i32 = arith.constant 255 : i32
+  // CHECK: stream.async.execute
+  %results:3, %result_timepoint = stream.async.execute
+      with(%arg0 as %arg1: !stream.resource<external>{%c20})
+      -> (!stream.resource<external>{%c20}, !stream.resource<external>{%c20}, !stream.resource<external>{%c20}) {
+
+    // CHECK: stream.async.concurrent
+    // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_2[%c1024, %c1024, %c1]
+    // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_0[%c1024, %c1024, %c1]
+    // CHECK-NEXT: stream.yield
+
+    // CHECK: stream.async.concurrent
+    // CHECK-NEXT: stream.async.splat
+    // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_1[%c1, %c1, %c1]
+    // CHECK-NEXT: stream.yield
+
+    %0 = stream.async.splat %c255_i32 : i32 -> !stream.resource<external>{%c20}
+    %1 = stream.async.dispatch @ex::@dispatch_2[%c1024, %c1024, %c1](%arg1[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<external>{%c20}
+    %2 = stream.async.dispatch @ex::@dispatch_0[%c1024, %c1024, %c1](%arg1[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<transient>{%c20}
+    %3 = stream.async.dispatch @ex::@dispatch_1[%c1, %c1, %c1](%2[%c0 to %c20 for %c20]) : (!stream.resource<transient>{%c20}) -> !stream.resource<external>{%c20}
+    stream.yield %0, %1, %3 : !stream.resource<external>{%c20}, !stream.resource<external>{%c20}, !stream.resource<external>{%c20}
+  } => !stream.timepoint
+  %4:3 = stream.timepoint.await %result_timepoint => %results#0, %results#1, %results#2 : !stream.resource<external>{%c20}, !stream.resource<external>{%c20}, !stream.resource<external>{%c20}
+  util.return %4#0, %4#1, %4#2 : !stream.resource<external>, !stream.resource<external>, !stream.resource<external>
+}
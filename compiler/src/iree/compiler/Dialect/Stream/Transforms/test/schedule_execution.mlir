@@ -561,3 +561,40 @@ util.func public @cloneAcrossLoadBarrier(%arg0: !stream.resource<external>) -> (
   // CHECK: stream.timepoint.await %[[TP1]] => %[[RESULTS1]]
   util.return %dispatch1, %dispatch2 : !stream.resource<transient>, !stream.resource<transient>
 }
+
+// -----
+
+// Tests that the balanced cost model merges partitions too small to amortize
+// their submission overhead into a compatible neighbor. The reference
+// partitioning places %producer into its own execution region as it feeds
+// consumers on two different devices; merging it into the @device_a consumer
+// is legal as there is no path between the two through the @device_b region.
+
+util.global private @device_a : !hal.device
+util.global private @device_b : !hal.device
+
+// CHECK-LABEL: @partitioningBalancedMergesSmallPartitions
+// CHECK-SAME: (%[[ARG0:.+]]: !stream.resource<external>)
+util.func public @partitioningBalancedMergesSmallPartitions(%arg0: !stream.resource<external>) -> (!stream.resource<external>, !stream.resource<external>)
+    attributes {stream.partitioning = #stream.partitioning_config<"balanced">} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c20 = arith.constant 20 : index
+
+  // CHECK: stream.async.execute on(#hal.device.affinity<@device_a>)
+  // CHECK-SAME: with(%[[ARG0]] as %{{.+}}: !stream.resource<external>{%c20})
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_0
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_2
+  // CHECK-NEXT: stream.yield
+  %producer = stream.async.dispatch on(#hal.device.affinity<@device_a>) @ex::@dispatch_0[%c1](%arg0[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<transient>{%c20}
+
+  // CHECK: stream.async.execute on(#hal.device.affinity<@device_b>)
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_1
+  // CHECK-NEXT: stream.yield
+  %consumer_b = stream.async.dispatch on(#hal.device.affinity<@device_b>) @ex::@dispatch_1[%c1](%producer[%c0 to %c20 for %c20]) : (!stream.resource<transient>{%c20}) -> !stream.resource<external>{%c20}
+  %consumer_a = stream.async.dispatch on(#hal.device.affinity<@device_a>) @ex::@dispatch_2[%c1](%producer[%c0 to %c20 for %c20]) : (!stream.resource<transient>{%c20}) -> !stream.resource<external>{%c20}
+
+  // CHECK-NOT: stream.async.execute
+  // CHECK: util.return
+  util.return %consumer_b, %consumer_a : !stream.resource<external>, !stream.resource<external>
+}
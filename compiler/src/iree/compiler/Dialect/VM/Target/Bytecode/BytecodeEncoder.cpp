@@ -11,6 +11,7 @@
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
 #include "iree/compiler/Dialect/VM/IR/VMTypes.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/TypeSwitch.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Diagnostics.h"
 
@@ -50,9 +51,26 @@ public:
   LogicalResult encodeI8(int value) override { return writeUint8(value); }
 
   LogicalResult encodeOpcode(StringRef name, int opcode) override {
+    if (elideNextOpcode_) {
+      elideNextOpcode_ = false;
+      return success();
+    }
+    if (nextOpcode_.has_value()) {
+      opcode = static_cast<int>(*nextOpcode_);
+      nextOpcode_.reset();
+    }
     return writeUint8(opcode);
   }
 
+  // Replaces the opcode written by the next encodeOpcode with |opcode|. Used to
+  // turn the first op of a superinstruction into the fused opcode while
+  // keeping its operand encoding.
+  void overrideNextOpcode(Opcode opcode) { nextOpcode_ = opcode; }
+
+  // Skips the opcode written by the next encodeOpcode. Used to append the
+  // operands of the trailing op of a superinstruction to the fused opcode.
+  void elideNextOpcode() { elideNextOpcode_ = true; }
+
   LogicalResult encodeSymbolOrdinal(SymbolTable &syms,
                                     StringRef name) override {
     auto *symbolOp = syms.lookup(name);
@@ -347,6 +365,10 @@ private:
 
   Operation *currentOp_ = nullptr;
 
+  // Pending opcode override/elision applied to the next encodeOpcode.
+  std::optional<Opcode> nextOpcode_;
+  bool elideNextOpcode_ = false;
+
   std::vector<uint8_t> bytecode_;
   llvm::DenseMap<Block *, size_t> blockOffsets_;
   std::vector<std::pair<Block *, size_t>> blockOffsetFixups_;
@@ -354,10 +376,160 @@ private:
 
 } // namespace
 
+// Returns the superinstruction opcode fusing |op| with a vm.cond_br on its
+// result, if |op| is a comparison that has one.
+static std::optional<Opcode> getCmpCondBranchOpcode(Operation *op) {
+  return llvm::TypeSwitch<Operation *, std::optional<Opcode>>(op)
+      .Case([](IREE::VM::CmpEQI32Op) { return Opcode::CmpEQI32CondBranch; })
+      .Case([](IREE::VM::CmpNEI32Op) { return Opcode::CmpNEI32CondBranch; })
+      .Case([](IREE::VM::CmpLTI32SOp) { return Opcode::CmpLTI32SCondBranch; })
+      .Case([](IREE::VM::CmpLTI32UOp) { return Opcode::CmpLTI32UCondBranch; })
+      .Case([](IREE::VM::CmpEQI64Op) { return Opcode::CmpEQI64CondBranch; })
+      .Case([](IREE::VM::CmpNEI64Op) { return Opcode::CmpNEI64CondBranch; })
+      .Case([](IREE::VM::CmpLTI64SOp) { return Opcode::CmpLTI64SCondBranch; })
+      .Case([](IREE::VM::CmpLTI64UOp) { return Opcode::CmpLTI64UCondBranch; })
+      .Default([](Operation *) { return std::nullopt; });
+}
+
+namespace {
+
+// An integer add with one constant operand encoded as an add-immediate.
+struct AddImmMatch {
+  Opcode opcode;
+  // Index of the operand defined by the constant.
+  unsigned constIndex;
+  // Constant value encoded inline in the superinstruction.
+  TypedAttr value;
+};
+
+} // namespace
+
+// Matches a vm.add.i32/vm.add.i64 with an operand produced by a constant.
+// Constants are hoisted by canonicalization so the constant op may be anywhere
+// in the function. The rhs is preferred when both operands are constant.
+static std::optional<AddImmMatch> matchAddImm(Operation *op) {
+  std::optional<Opcode> opcode;
+  if (isa<IREE::VM::AddI32Op>(op)) {
+    opcode = Opcode::AddI32Imm;
+  } else if (isa<IREE::VM::AddI64Op>(op)) {
+    opcode = Opcode::AddI64Imm;
+  } else {
+    return std::nullopt;
+  }
+  for (unsigned constIndex : {1u, 0u}) {
+    Operation *constOp = op->getOperand(constIndex).getDefiningOp();
+    if (!isa_and_present<IREE::VM::ConstI32Op, IREE::VM::ConstI64Op>(
+            constOp)) {
+      continue;
+    }
+    return AddImmMatch{*opcode, constIndex,
+                       constOp->getAttrOfType<TypedAttr>("value")};
+  }
+  return std::nullopt;
+}
+
+// Returns true if every use of the constant |op| has been folded into an
+// add-immediate superinstruction and the constant need not be materialized.
+static bool isFoldedIntoAddImm(Operation *op) {
+  if (!isa<IREE::VM::ConstI32Op, IREE::VM::ConstI64Op>(op) ||
+      op->use_empty()) {
+    return false;
+  }
+  return llvm::all_of(op->getUses(), [](OpOperand &use) {
+    auto match = matchAddImm(use.getOwner());
+    return match && match->constIndex == use.getOperandNumber();
+  });
+}
+
+// Encodes a single serializable |op| and records its source location.
+static LogicalResult encodeOp(Operation *op, V0BytecodeEncoder &encoder,
+                              SymbolTable &symbolTable,
+                              FunctionSourceMap &sourceMap) {
+  sourceMap.locations.push_back(
+      {static_cast<int32_t>(encoder.getOffset()), op->getLoc()});
+  if (failed(encoder.beginOp(op)) ||
+      failed(cast<IREE::VM::VMSerializableOp>(op).encode(symbolTable,
+                                                         encoder)) ||
+      failed(encoder.endOp(op))) {
+    return op->emitOpError() << "failed to encode";
+  }
+  return success();
+}
+
+// Tries to encode |op| and the ops following it as a single superinstruction.
+// Superinstructions encode the same operands as the ops they fuse so that the
+// interpreter can execute common sequences with a single dispatch:
+//   vm.cmp.* + vm.cond_br: the branch reuses the comparison result directly.
+//   vm.const.* + vm.add.*: the constant is encoded inline in the add.
+//   vm.global.load.ref + vm.call*: the call operands follow the load.
+// Returns the number of ops encoded or 0 if no superinstruction matched.
+static FailureOr<unsigned>
+encodeSuperinstruction(Operation *op, V0BytecodeEncoder &encoder,
+                       SymbolTable &symbolTable, FunctionSourceMap &sourceMap) {
+  Operation *nextOp = op->getNextNode();
+
+  if (auto opcode = getCmpCondBranchOpcode(op)) {
+    auto condBranchOp = dyn_cast_if_present<IREE::VM::CondBranchOp>(nextOp);
+    if (condBranchOp && condBranchOp.getCondition() == op->getResult(0)) {
+      encoder.overrideNextOpcode(*opcode);
+      if (failed(encodeOp(op, encoder, symbolTable, sourceMap))) {
+        return failure();
+      }
+      // The condition register is implied by the comparison result.
+      sourceMap.locations.push_back({static_cast<int32_t>(encoder.getOffset()),
+                                     condBranchOp.getLoc()});
+      if (failed(encoder.beginOp(condBranchOp)) ||
+          failed(encoder.encodeBranch(condBranchOp.getTrueDest(),
+                                      condBranchOp.getTrueOperands(), 0)) ||
+          failed(encoder.encodeBranch(condBranchOp.getFalseDest(),
+                                      condBranchOp.getFalseOperands(), 1)) ||
+          failed(encoder.endOp(condBranchOp))) {
+        return condBranchOp.emitOpError() << "failed to encode";
+      }
+      return 2u;
+    }
+  }
+
+  if (auto match = matchAddImm(op)) {
+    unsigned operandIndex = 1 - match->constIndex;
+    sourceMap.locations.push_back(
+        {static_cast<int32_t>(encoder.getOffset()), op->getLoc()});
+    if (failed(encoder.beginOp(op)) ||
+        failed(encoder.encodeOpcode(op->getName().getStringRef(),
+                                    static_cast<int>(match->opcode))) ||
+        failed(encoder.encodeOperand(op->getOperand(operandIndex),
+                                     operandIndex)) ||
+        failed(encoder.encodePrimitiveAttr(match->value)) ||
+        failed(encoder.encodeResult(op->getResult(0))) ||
+        failed(encoder.endOp(op))) {
+      return op->emitOpError() << "failed to encode";
+    }
+    return 1u;
+  }
+
+  if (isa<IREE::VM::GlobalLoadRefOp>(op) &&
+      isa_and_present<IREE::VM::CallOp, IREE::VM::CallVariadicOp>(nextOp)) {
+    encoder.overrideNextOpcode(isa<IREE::VM::CallOp>(nextOp)
+                                   ? Opcode::GlobalLoadRefCall
+                                   : Opcode::GlobalLoadRefCallVariadic);
+    if (failed(encodeOp(op, encoder, symbolTable, sourceMap))) {
+      return failure();
+    }
+    encoder.elideNextOpcode();
+    if (failed(encodeOp(nextOp, encoder, symbolTable, sourceMap))) {
+      return failure();
+    }
+    return 2u;
+  }
+
+  return 0u;
+}
+
 // static
 std::optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
     IREE::VM::FuncOp funcOp, llvm::DenseMap<Type, int> &typeTable,
-    SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase) {
+    SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase,
+    bool emitSuperinstructions) {
   EncodedBytecodeFunction result;
 
   // Perform register allocation first so that we can quickly lookup values as
@@ -380,9 +552,9 @@ std::optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
       return std::nullopt;
     }
 
-    for (auto &op : block.getOperations()) {
-      auto serializableOp = dyn_cast<IREE::VM::VMSerializableOp>(op);
-      if (!serializableOp) {
+    for (auto it = block.begin(); it != block.end(); ++it) {
+      Operation &op = *it;
+      if (!isa<IREE::VM::VMSerializableOp>(op)) {
         if (op.hasTrait<OpTrait::IREE::VM::AssignmentOp>()) {
           // Assignment ops are ok to not be serializable.
           continue;
@@ -390,12 +562,23 @@ std::optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
         op.emitOpError() << "is not serializable";
         return std::nullopt;
       }
-      sourceMap.locations.push_back(
-          {static_cast<int32_t>(encoder.getOffset()), op.getLoc()});
-      if (failed(encoder.beginOp(&op)) ||
-          failed(serializableOp.encode(symbolTable, encoder)) ||
-          failed(encoder.endOp(&op))) {
-        op.emitOpError() << "failed to encode";
+      if (emitSuperinstructions) {
+        // Constants only used as add immediates are encoded in the adds.
+        if (isFoldedIntoAddImm(&op)) {
+          continue;
+        }
+        auto fusedOpCount =
+            encodeSuperinstruction(&op, encoder, symbolTable, sourceMap);
+        if (failed(fusedOpCount)) {
+          return std::nullopt;
+        }
+        if (*fusedOpCount > 0) {
+          result.usesSuperinstructions = true;
+          std::advance(it, *fusedOpCount - 1);
+          continue;
+        }
+      }
+      if (failed(encodeOp(&op, encoder, symbolTable, sourceMap))) {
         return std::nullopt;
       }
     }
@@ -28,6 +28,9 @@ struct EncodedBytecodeFunction {
   uint16_t i32RegisterCount = 0;
   // Total vm.ref register slots required for execution.
   uint16_t refRegisterCount = 0;
+
+  // True if any superinstruction opcodes were encoded.
+  bool usesSuperinstructions = false;
 };
 
 // Abstract encoder used for function bytecode encoding.
@@ -35,15 +38,27 @@ class BytecodeEncoder : public VMFuncEncoder {
 public:
   // Matches IREE_VM_BYTECODE_VERSION_MAJOR.
   static constexpr uint32_t kVersionMajor = 15;
-  // Matches IREE_VM_BYTECODE_VERSION_MINOR.
-  static constexpr uint32_t kVersionMinor = 0;
-  static constexpr uint32_t kVersion = (kVersionMajor << 16) | kVersionMinor;
+  // Matches IREE_VM_BYTECODE_VERSION_MINOR. Modules are emitted with the
+  // lowest minor version supporting the opcodes they use so that they can
+  // still be loaded by older runtimes.
+  static constexpr uint32_t kVersionMinor = 1;
+  // Minor version that introduced superinstruction opcodes.
+  static constexpr uint32_t kVersionMinorSuperinstructions = 1;
+
+  // Returns the bytecode version of a module based on the opcodes it uses.
+  static constexpr uint32_t getVersion(bool usesSuperinstructions) {
+    return (kVersionMajor << 16) |
+           (usesSuperinstructions ? kVersionMinorSuperinstructions : 0u);
+  }
 
   // Encodes a vm.func to bytecode and returns the result.
+  // When |emitSuperinstructions| is set common op sequences are fused into
+  // single superinstruction opcodes.
   // Returns None on failure.
   static std::optional<EncodedBytecodeFunction>
   encodeFunction(IREE::VM::FuncOp funcOp, llvm::DenseMap<Type, int> &typeTable,
-                 SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase);
+                 SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase,
+                 bool emitSuperinstructions);
 
   BytecodeEncoder() = default;
   ~BytecodeEncoder() = default;
@@ -362,15 +362,18 @@ buildFlatBufferModule(IREE::VM::TargetOptions vmOptions,
   bytecodeDataParts.resize(internalFuncOps.size());
   functionDescriptors.resize(internalFuncOps.size());
   iree_vm_FeatureBits_enum_t moduleRequirements = 0;
+  bool usesSuperinstructions = false;
   size_t totalBytecodeLength = 0;
   for (auto [i, funcOp] : llvm::enumerate(internalFuncOps)) {
     auto encodedFunction = BytecodeEncoder::encodeFunction(
-        funcOp, typeOrdinalMap, symbolTable, debugDatabase);
+        funcOp, typeOrdinalMap, symbolTable, debugDatabase,
+        bytecodeOptions.emitSuperinstructions);
     if (!encodedFunction) {
       return funcOp.emitError() << "failed to encode function bytecode";
     }
     auto funcRequirements = findRequiredFeatures(funcOp);
     moduleRequirements |= funcRequirements;
+    usesSuperinstructions |= encodedFunction->usesSuperinstructions;
     iree_vm_FunctionDescriptor_assign(
         &functionDescriptors[i], totalBytecodeLength,
         encodedFunction->bytecodeLength, funcRequirements,
@@ -563,8 +566,8 @@ buildFlatBufferModule(IREE::VM::TargetOptions vmOptions,
   iree_vm_BytecodeModuleDef_rwdata_segments_add(fbb, rwdataSegmentsRef);
   iree_vm_BytecodeModuleDef_function_descriptors_add(fbb,
                                                      functionDescriptorsRef);
-  iree_vm_BytecodeModuleDef_bytecode_version_add(fbb,
-                                                 BytecodeEncoder::kVersion);
+  iree_vm_BytecodeModuleDef_bytecode_version_add(
+      fbb, BytecodeEncoder::getVersion(usesSuperinstructions));
   iree_vm_BytecodeModuleDef_bytecode_data_add(fbb, bytecodeDataRef);
   iree_vm_BytecodeModuleDef_debug_database_add(fbb, debugDatabaseRef);
   iree_vm_BytecodeModuleDef_end_as_root(fbb);
@@ -746,6 +749,13 @@ void BytecodeTargetOptions::bindOptions(OptionsBinder &binder) {
   binder.opt<bool>("iree-vm-bytecode-module-strip-source-map", stripSourceMap,
                    llvm::cl::cat(vmBytecodeOptionsCategory),
                    llvm::cl::desc("Strips the source map from the module"));
+  binder.opt<bool>(
+      "iree-vm-bytecode-module-superinstructions", emitSuperinstructions,
+      llvm::cl::cat(vmBytecodeOptionsCategory),
+      llvm::cl::desc("Fuses common op sequences into superinstructions that "
+                     "the interpreter executes with a single dispatch. "
+                     "Modules using them require a runtime supporting "
+                     "bytecode version 15.1"));
   binder.opt<bool>("iree-vm-bytecode-module-strip-debug-ops", stripDebugOps,
                    llvm::cl::cat(vmBytecodeOptionsCategory),
                    llvm::cl::desc("Strips debug-only ops from the module"));
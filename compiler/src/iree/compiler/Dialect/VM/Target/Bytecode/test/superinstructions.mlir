@@ -0,0 +1,162 @@
+// RUN: iree-compile --split-input-file --compile-mode=vm \
+// RUN:   --iree-vm-bytecode-module-output-format=flatbuffer-text %s | \
+// RUN: FileCheck %s
+// RUN: iree-compile --split-input-file --compile-mode=vm \
+// RUN:   --iree-vm-bytecode-module-output-format=flatbuffer-text \
+// RUN:   --iree-vm-bytecode-module-superinstructions=false %s | \
+// RUN: FileCheck %s --check-prefix=NOFUSE
+
+// Tests that a comparison feeding a conditional branch is encoded as a single
+// CmpLTI32SCondBranch (0x87) op with the cmp operands and result followed by
+// the branch targets. The condition register is not encoded.
+
+// CHECK-LABEL: "name": "cmp_cond_branch"
+// NOFUSE-LABEL: "name": "cmp_cond_branch"
+vm.module @cmp_cond_branch {
+  vm.export @func
+  vm.func @func(%arg0 : i32, %arg1 : i32) -> i32 {
+    %0 = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.cond_br %0, ^bb1, ^bb2
+  ^bb1:
+    vm.return %arg0 : i32
+  ^bb2:
+    vm.return %arg1 : i32
+  }
+  // Modules using superinstructions require bytecode version 15.1.
+  //      CHECK: "bytecode_version": 983041
+  //      CHECK: "bytecode_data": [
+  // CHECK-NEXT:   121,
+  // CHECK-NEXT:   135,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   {{[0-9]+}},
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   {{[0-9]+}},
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   {{[0-9]+}},
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   121,
+
+  //      NOFUSE: "bytecode_version": 983040
+  //      NOFUSE: "bytecode_data": [
+  // NOFUSE-NEXT:   121,
+  // NOFUSE-NEXT:   75,
+  //      NOFUSE:   87,
+}
+
+// -----
+
+// Tests that an add with a constant operand is encoded as an AddI32Imm (0x8D)
+// with the constant value inline and that the constant is not materialized.
+
+// CHECK-LABEL: "name": "add_imm"
+// NOFUSE-LABEL: "name": "add_imm"
+vm.module @add_imm {
+  vm.export @func
+  vm.func @func(%arg0 : i32) -> i32 {
+    %c100 = vm.const.i32 100
+    %0 = vm.add.i32 %arg0, %c100 : i32
+    vm.return %0 : i32
+  }
+  //      CHECK: "bytecode_data": [
+  // CHECK-NEXT:   121,
+  // CHECK-NEXT:   141,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   100,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   {{[0-9]+}},
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   90,
+
+  //      NOFUSE: "bytecode_data": [
+  // NOFUSE-NEXT:   121,
+  // NOFUSE-NEXT:   13,
+  // NOFUSE-NEXT:   100,
+  //      NOFUSE:   34,
+}
+
+// -----
+
+// Tests that a constant with uses other than add operands is still
+// materialized while the adds use it as an immediate.
+
+// CHECK-LABEL: "name": "add_imm_shared_const"
+vm.module @add_imm_shared_const {
+  vm.export @func
+  vm.func @func(%arg0 : i32) -> (i32, i32) {
+    %c7 = vm.const.i32 7
+    %0 = vm.add.i32 %arg0, %c7 : i32
+    vm.return %0, %c7 : i32, i32
+  }
+  //      CHECK: "bytecode_data": [
+  // CHECK-NEXT:   121,
+  // CHECK-NEXT:   13,
+  // CHECK-NEXT:   7,
+  //      CHECK:   141,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   7,
+}
+
+// -----
+
+// Tests that a global ref load immediately followed by a call is encoded as a
+// GlobalLoadRefCall (0x8F) with the call operands directly following the load
+// operands and no Call opcode in between.
+
+// CHECK-LABEL: "name": "global_load_ref_call"
+vm.module @global_load_ref_call {
+  vm.global.ref private mutable @buffer : !vm.buffer
+  vm.import private @other.consume(%buffer : !vm.buffer)
+  vm.export @func
+  vm.func @func() {
+    %0 = vm.global.load.ref @buffer : !vm.buffer
+    vm.call @other.consume(%0) : (!vm.buffer) -> ()
+    vm.return
+  }
+  //      CHECK: "bytecode_data": [
+  // CHECK-NEXT:   121,
+  // CHECK-NEXT:   143,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   {{[0-9]+}},
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   {{[0-9]+}},
+  // CHECK-NEXT:   128,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   128,
+}
+
+// -----
+
+// Tests that modules without any fusable op sequences keep bytecode version
+// 15.0 so that they can be loaded by runtimes predating superinstructions.
+
+// CHECK-LABEL: "name": "no_superinstructions"
+vm.module @no_superinstructions {
+  vm.export @func
+  vm.func @func(%arg0 : i32, %arg1 : i32) -> i32 {
+    %0 = vm.add.i32 %arg0, %arg1 : i32
+    vm.return %0 : i32
+  }
+  // CHECK: "bytecode_version": 983040
+}
@@ -106,9 +106,39 @@ canonicalizeModule(IREE::VM::ModuleOp moduleOp,
   return success();
 }
 
+// Emits the entry point looked up by iree_vm_dynamic_module_load_from_file
+// that forwards to the `<module>_create` function of the C module.
+static void emitDynamicModuleExport(StringRef moduleName,
+                                    llvm::raw_ostream &output) {
+  output << R"(
+#if defined(EMITC_IMPLEMENTATION)
+#include "iree/vm/dynamic/api.h"
+
+IREE_VM_DYNAMIC_MODULE_EXPORT iree_status_t iree_vm_dynamic_module_create(
+    iree_vm_dynamic_module_version_t max_version, iree_vm_instance_t* instance,
+    iree_host_size_t param_count, const iree_string_pair_t* params,
+    iree_allocator_t allocator, iree_vm_module_t** out_module) {
+  *out_module = NULL;
+  if (max_version != IREE_VM_DYNAMIC_MODULE_VERSION_LATEST) {
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "unsupported runtime version %u, module compiled with version %u",
+        max_version, IREE_VM_DYNAMIC_MODULE_VERSION_LATEST);
+  }
+  // The library has its own copy of the builtin type registrations that must
+  // be resolved against the hosting instance.
+  IREE_RETURN_IF_ERROR(iree_vm_resolve_builtin_types(instance));
+  return )"
+         << moduleName << R"(_create(instance, allocator, out_module);
+}
+#endif  // EMITC_IMPLEMENTATION
+)";
+}
+
 LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
                                  CTargetOptions targetOptions,
                                  llvm::raw_ostream &output) {
+  std::string moduleName = moduleOp.getName().str();
   moduleOp.getContext()
       ->loadDialect<IREE::Util::UtilDialect, mlir::cf::ControlFlowDialect>();
 
@@ -130,7 +160,14 @@ LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
     return success();
   }
 
-  return mlir::emitc::translateToCpp(mlirModule.getOperation(), output, true);
+  if (failed(mlir::emitc::translateToCpp(mlirModule.getOperation(), output,
+                                         true))) {
+    return failure();
+  }
+  if (targetOptions.emitDynamicModuleExport) {
+    emitDynamicModuleExport(moduleName, output);
+  }
+  return success();
 }
 
 LogicalResult translateModuleToC(mlir::ModuleOp outerModuleOp,
@@ -32,6 +32,11 @@ struct CTargetOptions {
 
   // Strips vm ops with the VM_DebugOnly trait.
   bool stripDebugOps = false;
+
+  // Emits an `iree_vm_dynamic_module_create` entry point so that the C module
+  // can be compiled into a shared library and loaded at runtime with
+  // iree_vm_dynamic_module_load_from_file in place of the bytecode module.
+  bool emitDynamicModuleExport = false;
 };
 
 // Translates a vm.module to a c module.
@@ -33,11 +33,20 @@ static llvm::cl::opt<bool> stripDebugOpsFlag{
     llvm::cl::init(false),
 };
 
+static llvm::cl::opt<bool> dynamicExportFlag{
+    "iree-vm-c-module-dynamic-export",
+    llvm::cl::desc("Emits an iree_vm_dynamic_module_create entry point so the "
+                   "C module can be built as a shared library and loaded in "
+                   "place of the bytecode module"),
+    llvm::cl::init(false),
+};
+
 CTargetOptions getCTargetOptionsFromFlags() {
   CTargetOptions targetOptions;
   targetOptions.outputFormat = outputFormatFlag;
   targetOptions.optimize = optimizeFlag;
   targetOptions.stripDebugOps = stripDebugOpsFlag;
+  targetOptions.emitDynamicModuleExport = dynamicExportFlag;
   return targetOptions;
 }
 
@@ -0,0 +1,17 @@
+// RUN: iree-compile --compile-mode=vm --output-format=vm-c \
+// RUN:   --iree-vm-c-module-dynamic-export %s | FileCheck %s
+
+// CHECK: iree_status_t dynamic_module_create(
+// CHECK: #endif  // EMITC_IMPLEMENTATION
+// CHECK: #if defined(EMITC_IMPLEMENTATION)
+// CHECK-NEXT: #include "iree/vm/dynamic/api.h"
+// CHECK: IREE_VM_DYNAMIC_MODULE_EXPORT iree_status_t iree_vm_dynamic_module_create(
+// CHECK: IREE_RETURN_IF_ERROR(iree_vm_resolve_builtin_types(instance));
+// CHECK-NEXT: return dynamic_module_create(instance, allocator, out_module);
+vm.module @dynamic_module {
+  vm.export @add
+  vm.func @add(%arg0 : i32, %arg1 : i32) -> i32 {
+    %0 = vm.add.i32 %arg0, %arg1 : i32
+    vm.return %0 : i32
+  }
+}
@@ -103,7 +103,9 @@ void buildHALInlineDynamicTransformPassPipeline(
       IREE::HAL::createSerializeAllExecutablesPass(
           {&targetRegistry, targetOptions.debugLevel,
            targetOptions.executableIntermediatesPath,
-           targetOptions.executableBinariesPath}));
+           targetOptions.executableBinariesPath,
+           targetOptions.executableCachePath,
+           targetOptions.executableCacheMaxSizeMB}));
 
   // NOTE: symbol DCE will destroy executable target contents.
   passManager.addPass(mlir::createSymbolDCEPass());
@@ -7,6 +7,7 @@
 #ifndef IREE_BASE_ATTRIBUTES_H_
 #define IREE_BASE_ATTRIBUTES_H_
 
+#include "iree/base/config.h"
 #include "iree/base/target_platform.h"
 
 //===----------------------------------------------------------------------===//
@@ -223,4 +224,28 @@
 #define IREE_HAVE_ATTRIBUTE_WEAK 0
 #endif  // IREE_HAVE_ATTRIBUTE(weak)
 
+//===----------------------------------------------------------------------===//
+// Thread-local storage
+//===----------------------------------------------------------------------===//
+
+// Declares a variable with thread storage duration. Declarations must also
+// specify their linkage as the qualifier may expand to nothing:
+//   static iree_thread_local int counter = 0;
+// When synchronization is disabled there is only one thread and the qualifier
+// is dropped so the variable is a plain static. If the compiler has no thread-local support all threads
+// share the variable so users must tolerate that (e.g. by only using it as a
+// hint).
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+#define iree_thread_local
+#elif defined(__cplusplus)
+#define iree_thread_local thread_local
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201102L) && \
+    !__STDC_NO_THREADS__
+#define iree_thread_local _Thread_local
+#elif defined(IREE_COMPILER_MSVC)
+#define iree_thread_local __declspec(thread)
+#else
+#define iree_thread_local
+#endif  // IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
 #endif  // IREE_BASE_ATTRIBUTES_H_
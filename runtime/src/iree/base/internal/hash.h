@@ -0,0 +1,44 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BASE_INTERNAL_HASH_H_
+#define IREE_BASE_INTERNAL_HASH_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Hashes |value| with 64-bit FNV-1a followed by a finalizer.
+//
+// Intended for short identifiers (function names, parameter keys) used in
+// open-addressed tables that select slots by masking the low bits of the hash.
+// Such strings often differ only in a few characters and the low bits of
+// FNV-1a only depend on the low bits of each byte so the finalizer mixes the
+// high bits back in to avoid long probe sequences. The low 32 bits are suitable
+// for use as a 32-bit hash.
+//
+// Not stable across releases; do not persist.
+static inline uint64_t iree_hash_string_view(iree_string_view_t value) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < value.size; ++i) {
+    hash ^= (uint8_t)value.data[i];
+    hash *= 0x100000001B3ull;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_INTERNAL_HASH_H_
@@ -0,0 +1,42 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/hash.h"
+
+#include <set>
+#include <string>
+
+#include "iree/testing/gtest.h"
+
+namespace {
+
+TEST(HashTest, EqualStringsHashEqual) {
+  std::string a = "model.layers.17.self_attn.q_proj.weight";
+  std::string b = a;
+  EXPECT_EQ(iree_hash_string_view(iree_make_string_view(a.data(), a.size())),
+            iree_hash_string_view(iree_make_string_view(b.data(), b.size())));
+}
+
+TEST(HashTest, Empty) {
+  EXPECT_EQ(iree_hash_string_view(iree_string_view_empty()),
+            iree_hash_string_view(iree_make_string_view("", 0)));
+}
+
+// Keys that differ only in a few digits must still spread across the low bits
+// used to select table slots.
+TEST(HashTest, LowBitsSpread) {
+  static const int kKeyCount = 256;
+  std::set<uint64_t> slots;
+  for (int i = 0; i < kKeyCount; ++i) {
+    std::string key = "model.layers." + std::to_string(i) + ".weight";
+    slots.insert(iree_hash_string_view(
+                     iree_make_string_view(key.data(), key.size())) &
+                 (kKeyCount * 2 - 1));
+  }
+  EXPECT_GT(slots.size(), kKeyCount / 2);
+}
+
+}  // namespace
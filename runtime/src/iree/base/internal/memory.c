@@ -159,3 +159,282 @@ void iree_memory_flush_icache(void* base_address, iree_host_size_t length) {
 }
 
 #endif  // IREE_PLATFORM_*
+
+//===----------------------------------------------------------------------===//
+// NUMA memory placement
+//===----------------------------------------------------------------------===//
+
+bool iree_memory_parse_node_list(iree_string_view_t node_list,
+                                 iree_host_size_t* out_node_count,
+                                 uint64_t* out_node_mask) {
+  *out_node_count = 0;
+  if (out_node_mask) *out_node_mask = 0ull;
+  iree_host_size_t node_count = 0;
+  uint64_t node_mask = 0ull;
+  iree_string_view_t remaining = iree_string_view_trim(node_list);
+  while (!iree_string_view_is_empty(remaining)) {
+    iree_string_view_t range = iree_string_view_empty();
+    iree_string_view_split(remaining, ',', &range, &remaining);
+    iree_string_view_t range_begin = iree_string_view_empty();
+    iree_string_view_t range_end = iree_string_view_empty();
+    const bool has_end =
+        iree_string_view_split(range, '-', &range_begin, &range_end) != -1;
+    uint32_t begin = 0;
+    if (!iree_string_view_atoi_uint32(range_begin, &begin)) return false;
+    uint32_t end = begin;
+    if (has_end && !iree_string_view_atoi_uint32(range_end, &end)) {
+      return false;
+    }
+    if (end < begin) return false;
+    node_count += (iree_host_size_t)(end - begin) + 1;
+    for (uint32_t node_id = begin; node_id <= end && node_id < 64; ++node_id) {
+      node_mask |= 1ull << node_id;
+    }
+  }
+  *out_node_count = node_count;
+  if (out_node_mask) *out_node_mask = node_mask;
+  return true;
+}
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+
+#if (defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)) && \
+    defined(__NR_mbind)
+
+// From linux/mempolicy.h; defined here to avoid a dependency on libnuma or the
+// kernel headers.
+#define IREE_MEMORY_MPOL_PREFERRED 1
+
+// Maximum NUMA node ID that can be bound. Matches the default kernel
+// CONFIG_NODES_SHIFT on large x86 configurations.
+#define IREE_MEMORY_MAX_NODE_COUNT 1024
+
+// Reads the list of online nodes into |out_node_count| and |out_node_mask|.
+// Returns false if the list is not available or is empty.
+static bool iree_memory_query_online_nodes(iree_host_size_t* out_node_count,
+                                           uint64_t* out_node_mask) {
+  // The online node list is a set of ranges such as `0-1,4`.
+  FILE* file = fopen("/sys/devices/system/node/online", "r");
+  if (!file) return false;
+  char buffer[1024];
+  const size_t length = fread(buffer, 1, sizeof(buffer), file);
+  fclose(file);
+  return iree_memory_parse_node_list(iree_make_string_view(buffer, length),
+                                     out_node_count, out_node_mask) &&
+         *out_node_count > 0;
+}
+
+iree_host_size_t iree_memory_query_node_count(void) {
+  iree_host_size_t node_count = 0;
+  uint64_t node_mask = 0ull;
+  if (!iree_memory_query_online_nodes(&node_count, &node_mask)) return 1;
+  return node_count;
+}
+
+uint64_t iree_memory_query_node_mask(void) {
+  iree_host_size_t node_count = 0;
+  uint64_t node_mask = 0ull;
+  if (!iree_memory_query_online_nodes(&node_count, &node_mask) ||
+      node_mask == 0ull) {
+    return 1ull;
+  }
+  return node_mask;
+}
+
+uint32_t iree_memory_query_processor_node(uint32_t processor_id) {
+  // The processor directory contains a `nodeN` link to the node it belongs to.
+  // e.g. /sys/devices/system/cpu/cpu3/node0
+  char cpu_path[64];
+  snprintf(cpu_path, sizeof(cpu_path), "/sys/devices/system/cpu/cpu%u",
+           processor_id);
+  DIR* dir = opendir(cpu_path);
+  if (!dir) return IREE_MEMORY_NODE_ID_ANY;
+  uint32_t node_id = IREE_MEMORY_NODE_ID_ANY;
+  struct dirent* entry = NULL;
+  while ((entry = readdir(dir)) != NULL) {
+    unsigned int value = 0;
+    char trailing = 0;
+    if (strncmp(entry->d_name, "node", 4) == 0 &&
+        sscanf(entry->d_name + 4, "%u%c", &value, &trailing) == 1) {
+      node_id = value;
+      break;
+    }
+  }
+  closedir(dir);
+  return node_id;
+}
+
+uint32_t iree_memory_query_current_node(void) {
+#if defined(__NR_getcpu)
+  unsigned int cpu = 0;
+  unsigned int node = 0;
+  if (syscall(__NR_getcpu, &cpu, &node, NULL) != 0) {
+    return IREE_MEMORY_NODE_ID_ANY;
+  }
+  return node;
+#else
+  return IREE_MEMORY_NODE_ID_ANY;
+#endif  // __NR_getcpu
+}
+
+iree_status_t iree_memory_allocate_on_node(iree_host_size_t length,
+                                           uint32_t node_id,
+                                           void** out_base_address) {
+  *out_base_address = NULL;
+  if (node_id >= IREE_MEMORY_MAX_NODE_COUNT) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "NUMA node %u out of range", node_id);
+  }
+  if (length == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "allocation length must be non-zero");
+  }
+
+  void* base_address = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base_address == MAP_FAILED) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "mmap of %" PRIhsz " bytes failed", length);
+  }
+
+  // The pages were just mapped and have not been touched so the policy only
+  // affects where they are faulted in; nothing needs to be migrated.
+  const iree_host_size_t bits_per_word = 8 * sizeof(unsigned long);
+  unsigned long node_mask[IREE_MEMORY_MAX_NODE_COUNT / (8 * sizeof(long))];
+  memset(node_mask, 0, sizeof(node_mask));
+  node_mask[node_id / bits_per_word] = 1ul << (node_id % bits_per_word);
+  long result = syscall(__NR_mbind, base_address, length,
+                        IREE_MEMORY_MPOL_PREFERRED, node_mask,
+                        (unsigned long)IREE_MEMORY_MAX_NODE_COUNT + 1, 0);
+  if (result != 0) {
+    const int error = errno;
+    munmap(base_address, length);
+    if (error == ENOSYS || error == EPERM) {
+      return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "NUMA placement not available (%d)", error);
+    }
+    return iree_make_status(iree_status_code_from_errno(error),
+                            "mbind of %" PRIhsz " bytes to node %u failed",
+                            length, node_id);
+  }
+
+  *out_base_address = base_address;
+  return iree_ok_status();
+}
+
+void iree_memory_free_on_node(void* base_address, iree_host_size_t length) {
+  if (base_address) munmap(base_address, length);
+}
+
+#if defined(__NR_move_pages)
+
+// Maximum number of pages sampled by iree_memory_query_node_residency.
+#define IREE_MEMORY_MAX_RESIDENCY_SAMPLES 256
+
+iree_status_t iree_memory_query_node_residency(
+    const void* base_address, iree_host_size_t length, uint32_t node_id,
+    iree_host_size_t* out_local_page_count,
+    iree_host_size_t* out_resident_page_count) {
+  *out_local_page_count = 0;
+  *out_resident_page_count = 0;
+
+  // Only whole pages within the range are sampled.
+  const iree_host_size_t page_size = (iree_host_size_t)sysconf(_SC_PAGESIZE);
+  const uintptr_t page_begin =
+      iree_host_align((uintptr_t)base_address, page_size);
+  const uintptr_t page_end =
+      ((uintptr_t)base_address + length) & ~(uintptr_t)(page_size - 1);
+  if (page_end <= page_begin) return iree_ok_status();
+  const iree_host_size_t page_count = (page_end - page_begin) / page_size;
+
+  // Sample pages evenly across the range to bound the cost on large ranges.
+  const iree_host_size_t sample_count =
+      iree_min(page_count, IREE_MEMORY_MAX_RESIDENCY_SAMPLES);
+  void* pages[IREE_MEMORY_MAX_RESIDENCY_SAMPLES];
+  int page_nodes[IREE_MEMORY_MAX_RESIDENCY_SAMPLES];
+  for (iree_host_size_t i = 0; i < sample_count; ++i) {
+    const iree_host_size_t page_index = i * page_count / sample_count;
+    pages[i] = (void*)(page_begin + page_index * page_size);
+  }
+
+  // With no target nodes move_pages only reports where each page resides.
+  long result = syscall(__NR_move_pages, 0, (unsigned long)sample_count, pages,
+                        NULL, page_nodes, 0);
+  if (result != 0) {
+    const int error = errno;
+    if (error == ENOSYS || error == EPERM) {
+      return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "NUMA residency query not available (%d)",
+                              error);
+    }
+    return iree_make_status(iree_status_code_from_errno(error),
+                            "move_pages query of %" PRIhsz " pages failed",
+                            sample_count);
+  }
+  for (iree_host_size_t i = 0; i < sample_count; ++i) {
+    // Negative values are errors such as -ENOENT for pages never touched.
+    if (page_nodes[i] < 0) continue;
+    ++*out_resident_page_count;
+    if ((uint32_t)page_nodes[i] == node_id) ++*out_local_page_count;
+  }
+  return iree_ok_status();
+}
+
+#else
+
+iree_status_t iree_memory_query_node_residency(
+    const void* base_address, iree_host_size_t length, uint32_t node_id,
+    iree_host_size_t* out_local_page_count,
+    iree_host_size_t* out_resident_page_count) {
+  *out_local_page_count = 0;
+  *out_resident_page_count = 0;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "NUMA residency query not available");
+}
+
+#endif  // __NR_move_pages
+
+#else
+
+iree_host_size_t iree_memory_query_node_count(void) { return 1; }
+
+uint64_t iree_memory_query_node_mask(void) { return 1ull; }
+
+uint32_t iree_memory_query_processor_node(uint32_t processor_id) {
+  return IREE_MEMORY_NODE_ID_ANY;
+}
+
+uint32_t iree_memory_query_current_node(void) {
+  return IREE_MEMORY_NODE_ID_ANY;
+}
+
+iree_status_t iree_memory_allocate_on_node(iree_host_size_t length,
+                                           uint32_t node_id,
+                                           void** out_base_address) {
+  *out_base_address = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "NUMA placement not available on this platform");
+}
+
+void iree_memory_free_on_node(void* base_address, iree_host_size_t length) {}
+
+iree_status_t iree_memory_query_node_residency(
+    const void* base_address, iree_host_size_t length, uint32_t node_id,
+    iree_host_size_t* out_local_page_count,
+    iree_host_size_t* out_resident_page_count) {
+  *out_local_page_count = 0;
+  *out_resident_page_count = 0;
+  return iree_make_status(
+      IREE_STATUS_UNAVAILABLE,
+      "NUMA residency query not available on this platform");
+}
+
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
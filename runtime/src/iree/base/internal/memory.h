@@ -68,6 +68,81 @@ void iree_memory_jit_context_end(void);
 // executing code from any pages that have been written during load.
 void iree_memory_flush_icache(void* base_address, iree_host_size_t length);
 
+//===----------------------------------------------------------------------===//
+// NUMA memory placement
+//===----------------------------------------------------------------------===//
+
+// Indicates that memory is not associated with any particular NUMA node.
+#define IREE_MEMORY_NODE_ID_ANY UINT32_MAX
+
+// Returns the number of online NUMA memory nodes in the system or 1 if the
+// query is not available on the platform.
+iree_host_size_t iree_memory_query_node_count(void);
+
+// Returns a bitmask of the IDs of the online NUMA memory nodes in the system
+// that are below 64 or a mask of only node 0 if the query is not available on
+// the platform. Node IDs need not be dense: nodes may be offline or absent.
+uint64_t iree_memory_query_node_mask(void);
+
+// Parses a node list in the kernel sysfs format (such as
+// /sys/devices/system/node/online) into the number of nodes it contains and a
+// bitmask of the node IDs below 64 in |out_node_mask| (optional). Nodes with
+// higher IDs are counted but not included in the mask.
+// The list is a comma-separated set of node IDs or inclusive ranges such as
+// `0-1,4`. Returns false if the list is malformed.
+bool iree_memory_parse_node_list(iree_string_view_t node_list,
+                                 iree_host_size_t* out_node_count,
+                                 uint64_t* out_node_mask);
+
+// Returns the NUMA memory node that the logical processor |processor_id| is
+// attached to or IREE_MEMORY_NODE_ID_ANY if the query is not available on the
+// platform.
+//
+// NOTE: this is the node the kernel allocates memory from for the processor
+// and may differ from the cluster/package IDs used for scheduling topologies.
+uint32_t iree_memory_query_processor_node(uint32_t processor_id);
+
+// Returns the NUMA memory node of the processor the calling thread is currently
+// running on or IREE_MEMORY_NODE_ID_ANY if the query is not available on the
+// platform. Unlike iree_memory_query_processor_node this is cheap enough to
+// call on every submission (a single getcpu syscall) but the result may be
+// stale by the time it is used if the thread migrates.
+uint32_t iree_memory_query_current_node(void);
+
+// Allocates |length| bytes of zero-initialized pages directly from the system
+// with a placement policy preferring NUMA node |node_id|. The pages are placed
+// on the node as they are first touched. Placement is a preference: if the
+// node runs out of memory pages will come from other nodes instead of failing.
+//
+// The memory is owned by the caller and must be freed with
+// iree_memory_free_on_node. Each allocation maps whole pages and should only be
+// used for allocations large enough to amortize that.
+//
+// Returns IREE_STATUS_UNAVAILABLE if NUMA placement is not supported on the
+// platform or the kernel.
+iree_status_t iree_memory_allocate_on_node(iree_host_size_t length,
+                                           uint32_t node_id,
+                                           void** out_base_address);
+
+// Frees memory allocated with iree_memory_allocate_on_node. |length| must match
+// the length used when allocating.
+void iree_memory_free_on_node(void* base_address, iree_host_size_t length);
+
+// Queries which NUMA nodes the pages in [base_address, base_address + length)
+// are resident on. Large ranges are sampled. |out_resident_page_count| is set
+// to the number of sampled pages that are resident in memory and
+// |out_local_page_count| to how many of those are resident on |node_id|. Pages
+// that have never been touched are not counted.
+//
+// Each call issues a syscall and should only be used for on-demand reporting.
+//
+// Returns IREE_STATUS_UNAVAILABLE if the query is not supported on the
+// platform or the kernel.
+iree_status_t iree_memory_query_node_residency(
+    const void* base_address, iree_host_size_t length, uint32_t node_id,
+    iree_host_size_t* out_local_page_count,
+    iree_host_size_t* out_resident_page_count);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,159 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/memory.h"
+
+#include <cstring>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+static bool ParseNodeList(const char* node_list,
+                          iree_host_size_t* out_node_count,
+                          uint64_t* out_node_mask = NULL) {
+  return iree_memory_parse_node_list(iree_make_cstring_view(node_list),
+                                     out_node_count, out_node_mask);
+}
+
+TEST(MemoryTest, ParseNodeListSingle) {
+  iree_host_size_t node_count = 0;
+  uint64_t node_mask = 0;
+  EXPECT_TRUE(ParseNodeList("0\n", &node_count, &node_mask));
+  EXPECT_EQ(node_count, 1);
+  EXPECT_EQ(node_mask, 0x1ull);
+}
+
+TEST(MemoryTest, ParseNodeListRanges) {
+  iree_host_size_t node_count = 0;
+  uint64_t node_mask = 0;
+  EXPECT_TRUE(ParseNodeList("0-1\n", &node_count, &node_mask));
+  EXPECT_EQ(node_count, 2);
+  EXPECT_EQ(node_mask, 0x3ull);
+  EXPECT_TRUE(ParseNodeList("0-3,8-11\n", &node_count, &node_mask));
+  EXPECT_EQ(node_count, 8);
+  EXPECT_EQ(node_mask, 0xF0Full);
+}
+
+// Nodes may be offline leaving holes in the ID space.
+TEST(MemoryTest, ParseNodeListSparse) {
+  iree_host_size_t node_count = 0;
+  uint64_t node_mask = 0;
+  EXPECT_TRUE(ParseNodeList("0,2,5-6", &node_count, &node_mask));
+  EXPECT_EQ(node_count, 4);
+  EXPECT_EQ(node_mask, 0x65ull);
+  EXPECT_TRUE(ParseNodeList("1,3", &node_count, &node_mask));
+  EXPECT_EQ(node_count, 2);
+  EXPECT_EQ(node_mask, 0xAull);
+}
+
+// Nodes at or above 64 are counted but do not fit in the mask.
+TEST(MemoryTest, ParseNodeListHighIds) {
+  iree_host_size_t node_count = 0;
+  uint64_t node_mask = 0;
+  EXPECT_TRUE(ParseNodeList("62-65,100", &node_count, &node_mask));
+  EXPECT_EQ(node_count, 5);
+  EXPECT_EQ(node_mask, 0xC000000000000000ull);
+}
+
+TEST(MemoryTest, ParseNodeListEmpty) {
+  iree_host_size_t node_count = 1;
+  uint64_t node_mask = 1;
+  EXPECT_TRUE(ParseNodeList("\n", &node_count, &node_mask));
+  EXPECT_EQ(node_count, 0);
+  EXPECT_EQ(node_mask, 0ull);
+}
+
+TEST(MemoryTest, ParseNodeListMalformed) {
+  iree_host_size_t node_count = 0;
+  EXPECT_FALSE(ParseNodeList("a", &node_count));
+  EXPECT_FALSE(ParseNodeList("0-", &node_count));
+  EXPECT_FALSE(ParseNodeList("3-1", &node_count));
+  EXPECT_FALSE(ParseNodeList("0,,1", &node_count));
+}
+
+TEST(MemoryTest, QueryNodeCount) {
+  EXPECT_GE(iree_memory_query_node_count(), 1);
+}
+
+// The mask has a bit for each online node below 64.
+TEST(MemoryTest, QueryNodeMask) {
+  const uint64_t node_mask = iree_memory_query_node_mask();
+  EXPECT_NE(node_mask, 0ull);
+  iree_host_size_t mask_node_count = 0;
+  for (uint64_t bits = node_mask; bits != 0; bits &= bits - 1) {
+    ++mask_node_count;
+  }
+  EXPECT_LE(mask_node_count, iree_memory_query_node_count());
+}
+
+// Every system with NUMA placement support has a node 0.
+TEST(MemoryTest, AllocateOnNode) {
+  const iree_host_size_t length = 1024 * 1024 + 1;
+  void* base_address = NULL;
+  iree_status_t status =
+      iree_memory_allocate_on_node(length, /*node_id=*/0, &base_address);
+  if (iree_status_is_unavailable(status)) {
+    iree_status_ignore(status);
+    GTEST_SKIP() << "NUMA placement not available";
+  }
+  IREE_ASSERT_OK(status);
+  ASSERT_NE(base_address, nullptr);
+  uint8_t* bytes = (uint8_t*)base_address;
+  EXPECT_EQ(bytes[0], 0);
+  EXPECT_EQ(bytes[length - 1], 0);
+  memset(bytes, 0xCD, length);
+  EXPECT_EQ(bytes[length - 1], 0xCD);
+  iree_memory_free_on_node(base_address, length);
+}
+
+TEST(MemoryTest, AllocateOnNodeOutOfRange) {
+  void* base_address = NULL;
+  iree_status_t status = iree_memory_allocate_on_node(
+      4096, IREE_MEMORY_NODE_ID_ANY, &base_address);
+  EXPECT_FALSE(iree_status_is_ok(status));
+  iree_status_ignore(status);
+  EXPECT_EQ(base_address, nullptr);
+}
+
+// Only pages that have been touched are reported as resident.
+TEST(MemoryTest, QueryNodeResidency) {
+  const iree_host_size_t length = 1024 * 1024;
+  void* base_address = NULL;
+  iree_status_t status =
+      iree_memory_allocate_on_node(length, /*node_id=*/0, &base_address);
+  if (iree_status_is_unavailable(status)) {
+    iree_status_ignore(status);
+    GTEST_SKIP() << "NUMA placement not available";
+  }
+  IREE_ASSERT_OK(status);
+
+  iree_host_size_t local_page_count = 0;
+  iree_host_size_t resident_page_count = 0;
+  status = iree_memory_query_node_residency(base_address, length,
+                                            /*node_id=*/0, &local_page_count,
+                                            &resident_page_count);
+  if (iree_status_is_unavailable(status)) {
+    iree_status_ignore(status);
+    iree_memory_free_on_node(base_address, length);
+    GTEST_SKIP() << "NUMA residency query not available";
+  }
+  IREE_ASSERT_OK(status);
+  EXPECT_EQ(resident_page_count, 0);
+  EXPECT_EQ(local_page_count, 0);
+
+  memset(base_address, 0xCD, length);
+  IREE_ASSERT_OK(iree_memory_query_node_residency(
+      base_address, length, /*node_id=*/0, &local_page_count,
+      &resident_page_count));
+  EXPECT_GT(resident_page_count, 0);
+  EXPECT_LE(local_page_count, resident_page_count);
+
+  iree_memory_free_on_node(base_address, length);
+}
+
+}  // namespace
@@ -645,10 +645,28 @@ bool iree_notification_commit_wait(iree_notification_t* notification,
 
   pthread_mutex_lock(&notification->mutex);
 
+  // The epoch is guarded by the mutex so spinning has to poll it under the
+  // lock. This is much more expensive than the futex path but still cheaper
+  // than a condvar wake.
+  if (spin_ns != IREE_DURATION_ZERO && notification->epoch == wait_token) {
+    const iree_time_t spin_deadline_ns = iree_time_now() + spin_ns;
+    do {
+      pthread_mutex_unlock(&notification->mutex);
+      iree_processor_yield();
+      pthread_mutex_lock(&notification->mutex);
+    } while (notification->epoch == wait_token &&
+             iree_time_now() < spin_deadline_ns);
+  }
+
   // Spin until notified and the epoch increments from what we captured during
   // iree_notification_prepare_wait.
   bool result = true;
   while (notification->epoch == wait_token) {
+    if (deadline_ns == IREE_TIME_INFINITE_PAST) {
+      // Poll only; the caller didn't want to block.
+      result = false;
+      break;
+    }
     int ret = pthread_cond_timedwait(&notification->cond, &notification->mutex,
                                      &abs_ts);
     if (ret != 0) {
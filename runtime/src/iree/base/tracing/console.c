@@ -9,26 +9,17 @@
 #include <string.h>
 
 #include "iree/base/alignment.h"
+#include "iree/base/attributes.h"
 #include "iree/base/internal/time.h"
 #include "iree/base/tracing.h"
 
 // NOTE: threading support is optional.
 #if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
 
-#define iree_thread_local static
 #define iree_thread_id() 0
 
 #else
 
-#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201102L) && \
-    !__STDC_NO_THREADS__
-#define iree_thread_local _Thread_local
-#elif defined(IREE_COMPILER_MSVC)
-#define iree_thread_local __declspec(thread)
-#else
-#define iree_thread_local
-#endif  // __STDC_NO_THREADS__
-
 #if defined(IREE_PLATFORM_ANDROID)
 #include <unistd.h>
 #define iree_thread_id() ((uint64_t)gettid())
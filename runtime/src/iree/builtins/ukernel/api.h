@@ -9,6 +9,7 @@
 
 #include "iree/builtins/ukernel/mmt4d.h"
 #include "iree/builtins/ukernel/pack.h"
+#include "iree/builtins/ukernel/qmmt.h"
 #include "iree/builtins/ukernel/query_tile_sizes.h"
 #include "iree/builtins/ukernel/unpack.h"
 
@@ -220,3 +220,185 @@ IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
 IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_s8s4s32_1x8x8_to_8x8x8_arm_64_dotprod,
     iree_uk_mmt4d_tile_s8s4s32_8x8x8_arm_64_dotprod, 8)
+
+// The u8s8s32 kernel below flips the sign bit of the LHS uint8 values to turn
+// them into the int8 values (v - 128), so that SDOT can be used. That bias
+// subtracts 128 * sum(rhs) from each accumulator, which is accumulated
+// separately (once per column, shared by all rows) and added back at the end.
+// CPUs with +i8mm have a native mixed-signedness USDOT/USMMLA instead, see
+// mmt4d_arm_64_i8mm.c.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_u8s8s32_1x8x4_to_8x8x4_arm_64_dotprod(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const int8x16_t sign_bit = vdupq_n_s8(-128);
+  const int8x16_t ones = vdupq_n_s8(1);
+  int32x4_t acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = vld1q_s32(out_ptr + 4 * i);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) { acc[i] = vdupq_n_s32(0); }
+  }
+  int32x4_t rhs_sum[2] = {vdupq_n_s32(0), vdupq_n_s32(0)};
+  for (int k = 0; k < params->K; ++k) {
+    int8x16_t rhs[2];
+    IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+      rhs[i] = vld1q_s8(rhs_ptr + 16 * i);
+      rhs_sum[i] = vdotq_s32(rhs_sum[i], rhs[i], ones);
+    }
+    rhs_ptr += 32;
+    int8x16_t lhs[2];
+    if (M0 == 1) {
+      lhs[0] = vdupq_n_s8(0);
+      lhs[0] = vreinterpretq_s8_s32(vld1q_lane_s32(
+          (const int32_t*)lhs_ptr, vreinterpretq_s32_s8(lhs[0]), 0));
+    } else if (M0 == 2) {
+      lhs[0] = vcombine_s8(vld1_s8(lhs_ptr), vdup_n_s8(0));
+    } else {
+      IREE_UK_UNROLL for (int i = 0; i < M0 / 4; ++i) {
+        lhs[i] = vld1q_s8(lhs_ptr + 16 * i);
+      }
+    }
+    lhs_ptr += 4 * M0;
+    IREE_UK_UNROLL for (int i = 0; i < (M0 + 3) / 4; ++i) {
+      lhs[i] = veorq_s8(lhs[i], sign_bit);
+    }
+    acc[0] = vdotq_lane_s32(acc[0], rhs[0], vget_low_s8(lhs[0]), 0);
+    acc[1] = vdotq_lane_s32(acc[1], rhs[1], vget_low_s8(lhs[0]), 0);
+    if (M0 == 1) continue;
+    acc[2] = vdotq_lane_s32(acc[2], rhs[0], vget_low_s8(lhs[0]), 1);
+    acc[3] = vdotq_lane_s32(acc[3], rhs[1], vget_low_s8(lhs[0]), 1);
+    if (M0 == 2) continue;
+    acc[4] = vdotq_lane_s32(acc[4], rhs[0], vget_high_s8(lhs[0]), 0);
+    acc[5] = vdotq_lane_s32(acc[5], rhs[1], vget_high_s8(lhs[0]), 0);
+    acc[6] = vdotq_lane_s32(acc[6], rhs[0], vget_high_s8(lhs[0]), 1);
+    acc[7] = vdotq_lane_s32(acc[7], rhs[1], vget_high_s8(lhs[0]), 1);
+    if (M0 == 4) continue;
+    acc[8] = vdotq_lane_s32(acc[8], rhs[0], vget_low_s8(lhs[1]), 0);
+    acc[9] = vdotq_lane_s32(acc[9], rhs[1], vget_low_s8(lhs[1]), 0);
+    acc[10] = vdotq_lane_s32(acc[10], rhs[0], vget_low_s8(lhs[1]), 1);
+    acc[11] = vdotq_lane_s32(acc[11], rhs[1], vget_low_s8(lhs[1]), 1);
+    acc[12] = vdotq_lane_s32(acc[12], rhs[0], vget_high_s8(lhs[1]), 0);
+    acc[13] = vdotq_lane_s32(acc[13], rhs[1], vget_high_s8(lhs[1]), 0);
+    acc[14] = vdotq_lane_s32(acc[14], rhs[0], vget_high_s8(lhs[1]), 1);
+    acc[15] = vdotq_lane_s32(acc[15], rhs[1], vget_high_s8(lhs[1]), 1);
+  }
+
+  IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+    acc[i] = vaddq_s32(acc[i], vshlq_n_s32(rhs_sum[i % 2], 7));
+    vst1q_s32(out_ptr + 4 * i, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x8x4_to_8x8x4_arm_64_dotprod,
+    iree_uk_mmt4d_tile_u8s8s32_1x8x4_arm_64_dotprod, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x8x4_to_8x8x4_arm_64_dotprod,
+    iree_uk_mmt4d_tile_u8s8s32_2x8x4_arm_64_dotprod, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x8x4_to_8x8x4_arm_64_dotprod,
+    iree_uk_mmt4d_tile_u8s8s32_4x8x4_arm_64_dotprod, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x8x4_to_8x8x4_arm_64_dotprod,
+    iree_uk_mmt4d_tile_u8s8s32_8x8x4_arm_64_dotprod, 8)
+
+// Unlike the s8s4s32 kernel above, which keeps the int4s in the upper 4 bits
+// and shifts the accumulators at the end, the s4s4s32 kernel below would need
+// to shift by 8 bits, which would overflow for large K. Instead, both sides
+// are sign-extended to int8 with a pair of shifts, keeping the accumulators
+// exact.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_s4s4s32_1x8x8_to_8x8x8_arm_64_dotprod(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  int32x4_t acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = vld1q_s32(out_ptr + 4 * i);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) { acc[i] = vdupq_n_s32(0); }
+  }
+  for (int k = 0; k < params->K; ++k) {
+    // Each column of the 8x8xs4 RHS is 4 bytes. The even K0 elements are in
+    // the low nibbles and the odd K0 elements in the high nibbles.
+    int8x16_t rhs_even[2];
+    int8x16_t rhs_odd[2];
+    IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+      int8x16_t r = vld1q_s8(rhs_ptr + 16 * i);
+      rhs_even[i] = vshrq_n_s8(vshlq_n_s8(r, 4), 4);
+      rhs_odd[i] = vshrq_n_s8(r, 4);
+    }
+    rhs_ptr += 32;
+    // Each row of the M0x8xs4 LHS is 4 bytes, laid out like the RHS columns.
+    int8x16_t lhs[2];
+    if (M0 == 1) {
+      lhs[0] = vdupq_n_s8(0);
+      lhs[0] = vreinterpretq_s8_s32(vld1q_lane_s32(
+          (const int32_t*)lhs_ptr, vreinterpretq_s32_s8(lhs[0]), 0));
+    } else if (M0 == 2) {
+      lhs[0] = vcombine_s8(vld1_s8(lhs_ptr), vdup_n_s8(0));
+    } else {
+      IREE_UK_UNROLL for (int i = 0; i < M0 / 4; ++i) {
+        lhs[i] = vld1q_s8(lhs_ptr + 16 * i);
+      }
+    }
+    lhs_ptr += 4 * M0;
+    int8x16_t lhs_even[2];
+    int8x16_t lhs_odd[2];
+    IREE_UK_UNROLL for (int i = 0; i < (M0 + 3) / 4; ++i) {
+      lhs_even[i] = vshrq_n_s8(vshlq_n_s8(lhs[i], 4), 4);
+      lhs_odd[i] = vshrq_n_s8(lhs[i], 4);
+    }
+    // Row `row` of the LHS is in 32-bit lane (row % 4) of lhs_*[row / 4].
+#define IREE_UK_MMT4D_S4S4S32_DOTPROD_ROW(row, get_half, lane)             \
+  IREE_UK_UNROLL for (int j = 0; j < 2; ++j) {                              \
+    acc[2 * row + j] = vdotq_lane_s32(acc[2 * row + j], rhs_even[j],        \
+                                      get_half(lhs_even[row / 4]), lane);   \
+    acc[2 * row + j] = vdotq_lane_s32(acc[2 * row + j], rhs_odd[j],         \
+                                      get_half(lhs_odd[row / 4]), lane);    \
+  }
+    IREE_UK_MMT4D_S4S4S32_DOTPROD_ROW(0, vget_low_s8, 0)
+    if (M0 == 1) continue;
+    IREE_UK_MMT4D_S4S4S32_DOTPROD_ROW(1, vget_low_s8, 1)
+    if (M0 == 2) continue;
+    IREE_UK_MMT4D_S4S4S32_DOTPROD_ROW(2, vget_high_s8, 0)
+    IREE_UK_MMT4D_S4S4S32_DOTPROD_ROW(3, vget_high_s8, 1)
+    if (M0 == 4) continue;
+    IREE_UK_MMT4D_S4S4S32_DOTPROD_ROW(4, vget_low_s8, 0)
+    IREE_UK_MMT4D_S4S4S32_DOTPROD_ROW(5, vget_low_s8, 1)
+    IREE_UK_MMT4D_S4S4S32_DOTPROD_ROW(6, vget_high_s8, 0)
+    IREE_UK_MMT4D_S4S4S32_DOTPROD_ROW(7, vget_high_s8, 1)
+#undef IREE_UK_MMT4D_S4S4S32_DOTPROD_ROW
+  }
+
+  IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+    vst1q_s32(out_ptr + 4 * i, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s4s4s32_1x8x8_to_8x8x8_arm_64_dotprod,
+    iree_uk_mmt4d_tile_s4s4s32_1x8x8_arm_64_dotprod, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s4s4s32_1x8x8_to_8x8x8_arm_64_dotprod,
+    iree_uk_mmt4d_tile_s4s4s32_2x8x8_arm_64_dotprod, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s4s4s32_1x8x8_to_8x8x8_arm_64_dotprod,
+    iree_uk_mmt4d_tile_s4s4s32_4x8x8_arm_64_dotprod, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s4s4s32_1x8x8_to_8x8x8_arm_64_dotprod,
+    iree_uk_mmt4d_tile_s4s4s32_8x8x8_arm_64_dotprod, 8)
@@ -108,6 +108,89 @@ IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_s8s8s32_1x8x8_to_8x8x8_arm_64_i8mm,
     iree_uk_mmt4d_tile_s8s8s32_8x8x8_arm_64_i8mm, 8)
 
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_u8s8s32_1x8x8_to_8x8x8_arm_64_i8mm(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const iree_uk_uint8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+
+  // Same as the s8s8s32 kernel above, except that it uses the mixed-signedness
+  // USMMLA instruction, which takes an unsigned LHS and a signed RHS.
+  // Accumulator 2x2 register tiles.
+  int32x4_t acc[4][4];
+  const int mtiles = M0 == 1 ? 1 : M0 / 2;
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    // Load row-major accumulator and swizzle into 2x2 register tiles.
+    IREE_UK_UNROLL for (int i = 0; i < mtiles; ++i) {
+      IREE_UK_UNROLL for (int j = 0; j < 2; ++j) {
+        int32x4_t acc_1x4_0 = vld1q_s32(out_ptr + 8 * (2 * i + 0) + 4 * j);
+        int32x4_t acc_1x4_1 =
+            M0 == 1 ? vdupq_n_s32(0)
+                    : vld1q_s32(out_ptr + 8 * (2 * i + 1) + 4 * j);
+        acc[i][2 * j + 0] = iree_uk_neon_zip1_s32_as_s64(acc_1x4_0, acc_1x4_1);
+        acc[i][2 * j + 1] = iree_uk_neon_zip2_s32_as_s64(acc_1x4_0, acc_1x4_1);
+      }
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < mtiles; ++i) {
+      IREE_UK_UNROLL for (int j = 0; j < 4; ++j) { acc[i][j] = vdupq_n_s32(0); }
+    }
+  }
+  for (int k = 0; k < params->K; ++k) {
+    int8x16_t rhs[4];
+    IREE_UK_UNROLL for (int i = 0; i < 4; ++i) {
+      rhs[i] = vld1q_s8(rhs_ptr + 16 * i);
+    }
+    rhs_ptr += 64;
+    uint8x16_t lhs[4];
+    if (M0 == 1) {
+      uint8x8_t lhs8 = vld1_u8(lhs_ptr);
+      lhs[0] = vcombine_u8(lhs8, lhs8);
+      lhs_ptr += 8;
+    } else
+      IREE_UK_UNROLL for (int i = 0; i < mtiles; ++i) {
+        lhs[i] = vld1q_u8(lhs_ptr);
+        lhs_ptr += 16;
+      }
+    IREE_UK_UNROLL for (int i = 0; i < mtiles; ++i) {
+      IREE_UK_UNROLL for (int j = 0; j < 4; ++j) {
+        acc[i][j] = vusmmlaq_s32(acc[i][j], lhs[i], rhs[j]);
+      }
+    }
+  }
+
+  // Swizzle accumulator 2x2 register tiles back to row-major and store.
+  IREE_UK_UNROLL for (int i = 0; i < mtiles; ++i) {
+    IREE_UK_UNROLL for (int j = 0; j < 2; ++j) {
+      int32x4_t acc_1x4_0 =
+          iree_uk_neon_uzp1_s32_as_s64(acc[i][2 * j + 0], acc[i][2 * j + 1]);
+      vst1q_s32(out_ptr + 8 * (2 * i + 0) + 4 * j, acc_1x4_0);
+      if (M0 > 1) {
+        int32x4_t acc_1x4_1 =
+            iree_uk_neon_uzp2_s32_as_s64(acc[i][2 * j + 0], acc[i][2 * j + 1]);
+        vst1q_s32(out_ptr + 8 * (2 * i + 1) + 4 * j, acc_1x4_1);
+      }
+    }
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x8x8_to_8x8x8_arm_64_i8mm,
+    iree_uk_mmt4d_tile_u8s8s32_1x8x8_arm_64_i8mm, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x8x8_to_8x8x8_arm_64_i8mm,
+    iree_uk_mmt4d_tile_u8s8s32_2x8x8_arm_64_i8mm, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x8x8_to_8x8x8_arm_64_i8mm,
+    iree_uk_mmt4d_tile_u8s8s32_4x8x8_arm_64_i8mm, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x8x8_to_8x8x8_arm_64_i8mm,
+    iree_uk_mmt4d_tile_u8s8s32_8x8x8_arm_64_i8mm, 8)
+
 // In the s8s4s32 kernels below, we unpack int4s into individual int8s.
 // To preserve signedness, int4s are moved to the upper 4-bits of each byte.
 // This has the effect of multiplying each int4 by 2^4 = 16. To compensate,
@@ -57,3 +57,15 @@ IREE_UK_MMT4D_TILE(arm_64, s8, s4, s32, 8, 8, 8, _dotprod)
 IREE_UK_MMT4D_TILE(arm_64, s8, s4, s32, 1, 8, 16, _i8mm)
 IREE_UK_MMT4D_TILE(arm_64, s8, s4, s32, 2, 8, 16, _i8mm)
 IREE_UK_MMT4D_TILE(arm_64, s8, s4, s32, 4, 8, 16, _i8mm)
+IREE_UK_MMT4D_TILE(arm_64, u8, s8, s32, 1, 8, 4, _dotprod)
+IREE_UK_MMT4D_TILE(arm_64, u8, s8, s32, 2, 8, 4, _dotprod)
+IREE_UK_MMT4D_TILE(arm_64, u8, s8, s32, 4, 8, 4, _dotprod)
+IREE_UK_MMT4D_TILE(arm_64, u8, s8, s32, 8, 8, 4, _dotprod)
+IREE_UK_MMT4D_TILE(arm_64, u8, s8, s32, 1, 8, 8, _i8mm)
+IREE_UK_MMT4D_TILE(arm_64, u8, s8, s32, 2, 8, 8, _i8mm)
+IREE_UK_MMT4D_TILE(arm_64, u8, s8, s32, 4, 8, 8, _i8mm)
+IREE_UK_MMT4D_TILE(arm_64, u8, s8, s32, 8, 8, 8, _i8mm)
+IREE_UK_MMT4D_TILE(arm_64, s4, s4, s32, 1, 8, 8, _dotprod)
+IREE_UK_MMT4D_TILE(arm_64, s4, s4, s32, 2, 8, 8, _dotprod)
+IREE_UK_MMT4D_TILE(arm_64, s4, s4, s32, 4, 8, 8, _dotprod)
+IREE_UK_MMT4D_TILE(arm_64, s4, s4, s32, 8, 8, 8, _dotprod)
@@ -292,3 +292,132 @@ void iree_uk_mmt4d_tile_s16u4s32_1x32x8_x86_64_avx512_vnni(
   _mm512_storeu_si512((__m512i*)(out_ptr + 16 * 0), acc0);
   _mm512_storeu_si512((__m512i*)(out_ptr + 16 * 1), acc1);
 }
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_u8s8s32_1x16x4_to_16x16x4_x86_64_avx512_vnni(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 16 && iree_uk_is_po2_u32(M0));
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  __m512i acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_loadu_si512((__m512i*)(out_ptr + i * 16));
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_setzero_si512();
+    }
+  }
+
+  for (int k = 0; k < params->K; ++k) {
+    // Unsigned*signed 8bit is exactly what _mm512_dpbusd_epi32 computes, so
+    // unlike the s8s8s32 case there is no need to widen to 16bit and each
+    // instruction consumes a whole K0=4 slice.
+    __m512i rhs = _mm512_loadu_si512((const __m512i*)rhs_ptr);
+    rhs_ptr += 64;
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_dpbusd_epi32(
+          acc[i], _mm512_set1_epi32(*(const iree_uk_int32_t*)lhs_ptr), rhs);
+      lhs_ptr += 4;
+    }
+  }
+
+  IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+    _mm512_storeu_si512((__m512i*)(out_ptr + i * 16), acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x16x4_to_16x16x4_x86_64_avx512_vnni,
+    iree_uk_mmt4d_tile_u8s8s32_1x16x4_x86_64_avx512_vnni, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x16x4_to_16x16x4_x86_64_avx512_vnni,
+    iree_uk_mmt4d_tile_u8s8s32_2x16x4_x86_64_avx512_vnni, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x16x4_to_16x16x4_x86_64_avx512_vnni,
+    iree_uk_mmt4d_tile_u8s8s32_4x16x4_x86_64_avx512_vnni, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x16x4_to_16x16x4_x86_64_avx512_vnni,
+    iree_uk_mmt4d_tile_u8s8s32_8x16x4_x86_64_avx512_vnni, 8)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_u8s8s32_1x16x4_to_16x16x4_x86_64_avx512_vnni,
+    iree_uk_mmt4d_tile_u8s8s32_16x16x4_x86_64_avx512_vnni, 16)
+
+// The s4s4s32 kernel below sign-extends the RHS int4s to int8, and maps the
+// LHS int4 values v to the uint4 values (v + 8) so that _mm512_dpbusd_epi32,
+// which takes an unsigned LHS, can be used. That bias adds 8 * sum(rhs) to
+// each accumulator, which is accumulated separately (once per column, shared
+// by all rows) and subtracted at the end.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_s4s4s32_1x16x8_to_16x16x8_x86_64_avx512_vnni(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 16 && iree_uk_is_po2_u32(M0));
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  __m512i acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_loadu_si512((__m512i*)(out_ptr + i * 16));
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_setzero_si512();
+    }
+  }
+  __m512i rhs_bias = _mm512_setzero_si512();
+  const __m512i mask_0f = _mm512_set1_epi8(0x0f);
+  const __m512i splat_8 = _mm512_set1_epi8(0x08);
+
+  for (int k = 0; k < params->K; ++k) {
+    // Load 8x16xs4 RHS data and sign-extend the even/odd s4 lanes to s8 as
+    // ((x ^ 8) - 8).
+    __m512i rhs = _mm512_loadu_si512((const __m512i*)rhs_ptr);
+    rhs_ptr += 64;
+    __m512i rhs_even = _mm512_sub_epi8(
+        _mm512_xor_si512(_mm512_and_si512(rhs, mask_0f), splat_8), splat_8);
+    __m512i rhs_odd = _mm512_sub_epi8(
+        _mm512_xor_si512(
+            _mm512_and_si512(_mm512_srli_epi16(rhs, 4), mask_0f), splat_8),
+        splat_8);
+    rhs_bias = _mm512_dpbusd_epi32(rhs_bias, splat_8, rhs_even);
+    rhs_bias = _mm512_dpbusd_epi32(rhs_bias, splat_8, rhs_odd);
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      // Load 8xs4 LHS data and bias the even/odd s4 lanes to u8 as (x ^ 8).
+      iree_uk_uint32_t lhs = *(const iree_uk_uint32_t*)lhs_ptr;
+      lhs_ptr += 4;
+      __m512i lhs_even = _mm512_set1_epi32((lhs & 0x0f0f0f0f) ^ 0x08080808);
+      __m512i lhs_odd =
+          _mm512_set1_epi32(((lhs >> 4) & 0x0f0f0f0f) ^ 0x08080808);
+      acc[i] = _mm512_dpbusd_epi32(acc[i], lhs_even, rhs_even);
+      acc[i] = _mm512_dpbusd_epi32(acc[i], lhs_odd, rhs_odd);
+    }
+  }
+
+  IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+    acc[i] = _mm512_sub_epi32(acc[i], rhs_bias);
+    _mm512_storeu_si512((__m512i*)(out_ptr + i * 16), acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s4s4s32_1x16x8_to_16x16x8_x86_64_avx512_vnni,
+    iree_uk_mmt4d_tile_s4s4s32_1x16x8_x86_64_avx512_vnni, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s4s4s32_1x16x8_to_16x16x8_x86_64_avx512_vnni,
+    iree_uk_mmt4d_tile_s4s4s32_2x16x8_x86_64_avx512_vnni, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s4s4s32_1x16x8_to_16x16x8_x86_64_avx512_vnni,
+    iree_uk_mmt4d_tile_s4s4s32_4x16x8_x86_64_avx512_vnni, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s4s4s32_1x16x8_to_16x16x8_x86_64_avx512_vnni,
+    iree_uk_mmt4d_tile_s4s4s32_8x16x8_x86_64_avx512_vnni, 8)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s4s4s32_1x16x8_to_16x16x8_x86_64_avx512_vnni,
+    iree_uk_mmt4d_tile_s4s4s32_16x16x8_x86_64_avx512_vnni, 16)
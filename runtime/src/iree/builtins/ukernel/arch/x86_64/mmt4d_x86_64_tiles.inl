@@ -73,3 +73,13 @@ IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 4, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 8, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 16, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s16, u4, s32, 1, 32, 8, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, u8, s8, s32, 1, 16, 4, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, u8, s8, s32, 2, 16, 4, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, u8, s8, s32, 4, 16, 4, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, u8, s8, s32, 8, 16, 4, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, u8, s8, s32, 16, 16, 4, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s4, s4, s32, 1, 16, 8, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s4, s4, s32, 2, 16, 8, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s4, s4, s32, 4, 16, 8, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s4, s4, s32, 8, 16, 8, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s4, s4, s32, 16, 16, 8, _avx512_vnni)
@@ -379,6 +379,13 @@ typedef iree_uk_uint8_t iree_uk_type_t;
 #define IREE_UK_TYPE_CATEGORY_INTEGER_SIGNED 0x30u
 // Unsigned integers. Similar comments as for signed integers.
 #define IREE_UK_TYPE_CATEGORY_INTEGER_UNSIGNED 0x40u
+// 8-bit floating-point format with 5 exponent bits and 2 mantissa bits,
+// following IEEE754 conventions for Inf and NaN (OCP FP8 E5M2).
+#define IREE_UK_TYPE_CATEGORY_FLOAT_E5M2 0xC0u
+// 8-bit floating-point format with 4 exponent bits and 3 mantissa bits, without
+// infinities and with a single NaN encoding per sign (OCP FP8 E4M3, the "FN"
+// variant in MLIR terminology).
+#define IREE_UK_TYPE_CATEGORY_FLOAT_E4M3FN 0xD0u
 // "Brain" floating-point format. Currently only used for bfloat16.
 #define IREE_UK_TYPE_CATEGORY_FLOAT_BRAIN 0xE0u
 // IEEE754 floating-point format.
@@ -419,6 +426,8 @@ enum {
   IREE_UK_TYPE_FLOAT_32 = IREE_UK_TYPE_CATEGORY_FLOAT_IEEE | 5,
   IREE_UK_TYPE_FLOAT_64 = IREE_UK_TYPE_CATEGORY_FLOAT_IEEE | 6,
   IREE_UK_TYPE_BFLOAT_16 = IREE_UK_TYPE_CATEGORY_FLOAT_BRAIN | 4,
+  IREE_UK_TYPE_FLOAT8_E4M3FN = IREE_UK_TYPE_CATEGORY_FLOAT_E4M3FN | 3,
+  IREE_UK_TYPE_FLOAT8_E5M2 = IREE_UK_TYPE_CATEGORY_FLOAT_E5M2 | 3,
 };
 
 IREE_UK_STATIC_ASSERT(IREE_UK_TYPE_NONE == 0);
@@ -791,4 +800,69 @@ static inline iree_uk_uint16_t iree_uk_f32_to_bf16(float value) {
   return iree_uk_f32_to_generic_fp16(value, 8);
 }
 
+//===----------------------------------------------------------------------===//
+// 8-bit -> 32-bit floating point conversions.
+//===----------------------------------------------------------------------===//
+
+// Converts an 8-bit floating-point value with |exp_bits| exponent bits to a
+// 32-bit C `float`. Unlike the 16-bit conversions above, subnormals are not
+// flushed to zero: they make up a meaningful part of the tiny fp8 value range.
+// When |have_infinity| is false, the all-ones exponent encodes finite values
+// and only the all-ones exponent-and-mantissa encoding is NaN.
+static inline float iree_uk_generic_fp8_to_f32(iree_uk_uint8_t fp8_value,
+                                               int exp_bits,
+                                               bool have_infinity) {
+  IREE_UK_FP_FORMAT_CONSTANTS(fp8_, 8, exp_bits)
+  IREE_UK_FP_FORMAT_CONSTANTS(f32_, 32, 8)
+  const int fp8_exp_bias = (1 << (fp8_exp_bits - 1)) - 1;
+  const int f32_exp_bias = (1 << (f32_exp_bits - 1)) - 1;
+  const iree_uk_uint32_t fp8_sign = fp8_value & fp8_sign_mask;
+  const iree_uk_uint32_t fp8_exp = fp8_value & fp8_exp_mask;
+  const iree_uk_uint32_t fp8_mantissa = fp8_value & fp8_mantissa_mask;
+  const iree_uk_uint32_t f32_sign = fp8_sign
+                                    << (f32_sign_shift - fp8_sign_shift);
+  const bool is_nan_or_inf =
+      have_infinity ? fp8_exp == fp8_exp_mask
+                    : (fp8_value & ~fp8_sign_mask) ==
+                          (fp8_exp_mask | fp8_mantissa_mask);
+  iree_uk_uint32_t u32_value = 0;
+  float f32_value;
+  if (is_nan_or_inf) {
+    // Generate a quiet NaN for any nonzero mantissa. Formats without
+    // infinities only get here for their NaN encoding.
+    u32_value = f32_sign | f32_exp_mask;
+    if (fp8_mantissa) u32_value |= f32_mantissa_mask;
+  } else if (fp8_exp == 0) {
+    // Zero or subnormal: the value is mantissa * 2^(1 - bias - mantissa_bits),
+    // and that power of two is a normal f32, so the product is exact.
+    const iree_uk_uint32_t u32_scale =
+        (iree_uk_uint32_t)(f32_exp_bias + 1 - fp8_exp_bias - fp8_mantissa_bits)
+        << f32_exp_shift;
+    float scale;
+    iree_uk_memcpy(&scale, &u32_scale, sizeof scale);
+    f32_value = (float)fp8_mantissa * scale;
+    return fp8_sign ? -f32_value : f32_value;
+  } else {
+    // Normal finite value.
+    const iree_uk_uint32_t f32_exp =
+        ((fp8_exp >> fp8_exp_shift) + f32_exp_bias - fp8_exp_bias)
+        << f32_exp_shift;
+    const iree_uk_uint32_t f32_mantissa =
+        fp8_mantissa << (f32_mantissa_bits - fp8_mantissa_bits);
+    u32_value = f32_sign | f32_exp | f32_mantissa;
+  }
+  iree_uk_memcpy(&f32_value, &u32_value, sizeof f32_value);
+  return f32_value;
+}
+
+// Converts a f8e4m3fn value to a 32-bit C `float`.
+static inline float iree_uk_f8e4m3fn_to_f32(iree_uk_uint8_t value) {
+  return iree_uk_generic_fp8_to_f32(value, 4, /*have_infinity=*/false);
+}
+
+// Converts a f8e5m2 value to a 32-bit C `float`.
+static inline float iree_uk_f8e5m2_to_f32(iree_uk_uint8_t value) {
+  return iree_uk_generic_fp8_to_f32(value, 5, /*have_infinity=*/true);
+}
+
 #endif  // IREE_BUILTINS_UKERNEL_COMMON_H_
@@ -38,7 +38,11 @@
 #define IREE_UK_FLAG_MMT4D_TYPE_S16U4S32 0x08
 #define IREE_UK_FLAG_MMT4D_TYPE_S16S8S32 0x09
 #define IREE_UK_FLAG_MMT4D_TYPE_S8S4S32 0x0A
-#define IREE_UK_FLAG_MMT4D_TYPE_END 0x0B
+#define IREE_UK_FLAG_MMT4D_TYPE_U8S8S32 0x0B
+#define IREE_UK_FLAG_MMT4D_TYPE_S4S4S32 0x0C
+#define IREE_UK_FLAG_MMT4D_TYPE_F8E4M3FNF8E4M3FNF32 0x0D
+#define IREE_UK_FLAG_MMT4D_TYPE_F8E5M2F8E5M2F32 0x0E
+#define IREE_UK_FLAG_MMT4D_TYPE_END 0x0F
 
 // bit flags
 #define IREE_UK_FLAG_MMT4D_ACCUMULATE 0x100
@@ -82,6 +86,23 @@
 #define IREE_UK_FLAG_UNPACK_TRANSPOSE_INNER 0x100
 #define IREE_UK_FLAG_UNPACK_TRANSPOSE_OUTER 0x200
 
+//===----------------------------------------------------------------------===//
+// qmmt
+//===----------------------------------------------------------------------===//
+
+// type enum. The RHS is in one of the GGML block-quantized formats found in
+// .gguf files (Q4_0, Q8_0, Q4_K).
+#define IREE_UK_FLAG_QMMT_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_QMMT_TYPE_NONE 0x00
+#define IREE_UK_FLAG_QMMT_TYPE_F32Q4_0F32 0x01
+#define IREE_UK_FLAG_QMMT_TYPE_F32Q8_0F32 0x02
+#define IREE_UK_FLAG_QMMT_TYPE_F32Q4_KF32 0x03
+#define IREE_UK_FLAG_QMMT_TYPE_S8Q8_0F32 0x04
+#define IREE_UK_FLAG_QMMT_TYPE_END 0x05
+
+// bit flags
+#define IREE_UK_FLAG_QMMT_ACCUMULATE 0x100
+
 //===----------------------------------------------------------------------===//
 // query_tile_sizes
 //===----------------------------------------------------------------------===//
@@ -104,5 +125,9 @@
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F16F16F16 0x0400
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32 0x0500
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16BF16 0x0600
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_U8S8S32 0x0700
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_I4I4I32 0x0800
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F8E4M3FNF8E4M3FNF32 0x0900
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_F8E5M2F8E5M2F32 0x0A00
 
 #endif  // IREE_BUILTINS_UKERNEL_EXPORTED_BITS_H_
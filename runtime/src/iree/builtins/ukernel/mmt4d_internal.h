@@ -46,6 +46,10 @@ typedef enum iree_uk_mmt4d_type_t {
       IREE_UK_TIE_3_TYPES_LITERAL(SINT_8, SINT_8, SINT_32),
   iree_uk_mmt4d_type_s8s4s32 =
       IREE_UK_TIE_3_TYPES_LITERAL(SINT_8, SINT_4, SINT_32),
+  iree_uk_mmt4d_type_u8s8s32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(UINT_8, SINT_8, SINT_32),
+  iree_uk_mmt4d_type_s4s4s32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(SINT_4, SINT_4, SINT_32),
   iree_uk_mmt4d_type_s16s16s32 =
       IREE_UK_TIE_3_TYPES_LITERAL(SINT_16, SINT_16, SINT_32),
   iree_uk_mmt4d_type_s16u4s32 =
@@ -60,6 +64,10 @@ typedef enum iree_uk_mmt4d_type_t {
       IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, FLOAT_32),
   iree_uk_mmt4d_type_bf16bf16bf16 =
       IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, BFLOAT_16),
+  iree_uk_mmt4d_type_f8e4m3fnf8e4m3fnf32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT8_E4M3FN, FLOAT8_E4M3FN, FLOAT_32),
+  iree_uk_mmt4d_type_f8e5m2f8e5m2f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT8_E5M2, FLOAT8_E5M2, FLOAT_32),
 } iree_uk_mmt4d_type_t;
 
 static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
@@ -70,6 +78,10 @@ static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
       return iree_uk_mmt4d_type_s8s8s32;
     case IREE_UK_FLAG_MMT4D_TYPE_S8S4S32:
       return iree_uk_mmt4d_type_s8s4s32;
+    case IREE_UK_FLAG_MMT4D_TYPE_U8S8S32:
+      return iree_uk_mmt4d_type_u8s8s32;
+    case IREE_UK_FLAG_MMT4D_TYPE_S4S4S32:
+      return iree_uk_mmt4d_type_s4s4s32;
     case IREE_UK_FLAG_MMT4D_TYPE_S16S16S32:
       return iree_uk_mmt4d_type_s16s16s32;
     case IREE_UK_FLAG_MMT4D_TYPE_S16U4S32:
@@ -84,6 +96,10 @@ static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
       return iree_uk_mmt4d_type_bf16bf16f32;
     case IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16:
       return iree_uk_mmt4d_type_bf16bf16bf16;
+    case IREE_UK_FLAG_MMT4D_TYPE_F8E4M3FNF8E4M3FNF32:
+      return iree_uk_mmt4d_type_f8e4m3fnf8e4m3fnf32;
+    case IREE_UK_FLAG_MMT4D_TYPE_F8E5M2F8E5M2F32:
+      return iree_uk_mmt4d_type_f8e5m2f8e5m2f32;
     default:
       // Work around a LLVM/riscv32 miscompile. Without the unreachable here,
       // returning (iree_uk_mmt4d_type_t)0 causes this whole switch statement to
@@ -77,6 +77,72 @@ static void iree_uk_mmt4d_tile_s8s8s32_generic(
   }
 }
 
+// Generic implementation of matmul tile, u8*s8->s32 case.
+static void iree_uk_mmt4d_tile_u8s8s32_generic(
+    void* out_tile_untyped, const void* lhs_panel_untyped,
+    const void* rhs_panel_untyped, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* out_tile = out_tile_untyped;
+  const iree_uk_uint8_t* lhs_panel = lhs_panel_untyped;
+  const iree_uk_int8_t* rhs_panel = rhs_panel_untyped;
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  for (iree_uk_index_t i0 = 0; i0 < M0; ++i0) {
+    for (iree_uk_index_t j0 = 0; j0 < N0; ++j0) {
+      iree_uk_int32_t acc = (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE)
+                                ? out_tile[i0 * N0 + j0]
+                                : 0;
+      for (iree_uk_index_t k = 0; k < params->K; ++k) {
+        for (iree_uk_index_t k0 = 0; k0 < K0; ++k0) {
+          iree_uk_int32_t lhs_i32 = lhs_panel[k * M0 * K0 + i0 * K0 + k0];
+          iree_uk_int32_t rhs_i32 = rhs_panel[k * N0 * K0 + j0 * K0 + k0];
+          acc += lhs_i32 * rhs_i32;
+        }
+      }
+      out_tile[i0 * N0 + j0] = acc;
+    }
+  }
+}
+
+// Generic implementation of matmul tile, s4*s4->s32 case.
+static void iree_uk_mmt4d_tile_s4s4s32_generic(
+    void* out_tile_untyped, const void* lhs_panel_untyped,
+    const void* rhs_panel_untyped, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_int32_t* out_tile = out_tile_untyped;
+  const iree_uk_uint8_t* lhs_panel = lhs_panel_untyped;
+  const iree_uk_uint8_t* rhs_panel = rhs_panel_untyped;
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  // K0 must be even.
+  IREE_UK_ASSERT(!(K0 % 2));
+  iree_uk_int16_t K0half = K0 / 2;
+  for (iree_uk_index_t i0 = 0; i0 < M0; ++i0) {
+    for (iree_uk_index_t j0 = 0; j0 < N0; ++j0) {
+      iree_uk_int32_t acc = (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE)
+                                ? out_tile[i0 * N0 + j0]
+                                : 0;
+      for (iree_uk_index_t k = 0; k < params->K; ++k) {
+        // As K0 must be even, we 2x-unroll the K0 loop, writing a 2D dot
+        // product. Each byte holds the even element in its low nibble.
+        for (iree_uk_index_t k0h = 0; k0h < K0half; ++k0h) {
+          iree_uk_uint8_t lhs_byte =
+              lhs_panel[k * M0 * K0half + i0 * K0half + k0h];
+          iree_uk_uint8_t rhs_byte =
+              rhs_panel[k * N0 * K0half + j0 * K0half + k0h];
+          // Sign-extend the nibbles: ((x ^ 8) - 8) maps [0, 15] to [-8, 7].
+          iree_uk_int32_t lhs_0 = ((lhs_byte & 0x0F) ^ 0x08) - 0x08;
+          iree_uk_int32_t lhs_1 = ((lhs_byte >> 4) ^ 0x08) - 0x08;
+          iree_uk_int32_t rhs_0 = ((rhs_byte & 0x0F) ^ 0x08) - 0x08;
+          iree_uk_int32_t rhs_1 = ((rhs_byte >> 4) ^ 0x08) - 0x08;
+          acc += lhs_0 * rhs_0 + lhs_1 * rhs_1;
+        }
+      }
+      out_tile[i0 * N0 + j0] = acc;
+    }
+  }
+}
+
 // Generic implementation of matmul tile, s16*s16->s32 case.
 static void iree_uk_mmt4d_tile_s16s16s32_generic(
     void* out_tile_untyped, const void* lhs_panel_untyped,
@@ -314,6 +380,64 @@ static void iree_uk_mmt4d_tile_bf16bf16f32_generic(
   }
 }
 
+// Generic implementation of matmul tile, f8e4m3fn*f8e4m3fn->f32 case.
+static void iree_uk_mmt4d_tile_f8e4m3fnf8e4m3fnf32_generic(
+    void* out_tile_untyped, const void* lhs_panel_untyped,
+    const void* rhs_panel_untyped, const iree_uk_mmt4d_params_t* params) {
+  float* out_tile = out_tile_untyped;
+  const iree_uk_uint8_t* lhs_panel = lhs_panel_untyped;
+  const iree_uk_uint8_t* rhs_panel = rhs_panel_untyped;
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  for (iree_uk_index_t i0 = 0; i0 < M0; ++i0) {
+    for (iree_uk_index_t j0 = 0; j0 < N0; ++j0) {
+      float acc = (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE)
+                      ? out_tile[i0 * N0 + j0]
+                      : 0.f;
+      for (iree_uk_index_t k = 0; k < params->K; ++k) {
+        for (iree_uk_index_t k0 = 0; k0 < K0; ++k0) {
+          float lhs_f32 =
+              iree_uk_f8e4m3fn_to_f32(lhs_panel[k * M0 * K0 + i0 * K0 + k0]);
+          float rhs_f32 =
+              iree_uk_f8e4m3fn_to_f32(rhs_panel[k * N0 * K0 + j0 * K0 + k0]);
+          acc += lhs_f32 * rhs_f32;
+        }
+      }
+      out_tile[i0 * N0 + j0] = acc;
+    }
+  }
+}
+
+// Generic implementation of matmul tile, f8e5m2*f8e5m2->f32 case.
+static void iree_uk_mmt4d_tile_f8e5m2f8e5m2f32_generic(
+    void* out_tile_untyped, const void* lhs_panel_untyped,
+    const void* rhs_panel_untyped, const iree_uk_mmt4d_params_t* params) {
+  float* out_tile = out_tile_untyped;
+  const iree_uk_uint8_t* lhs_panel = lhs_panel_untyped;
+  const iree_uk_uint8_t* rhs_panel = rhs_panel_untyped;
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  for (iree_uk_index_t i0 = 0; i0 < M0; ++i0) {
+    for (iree_uk_index_t j0 = 0; j0 < N0; ++j0) {
+      float acc = (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE)
+                      ? out_tile[i0 * N0 + j0]
+                      : 0.f;
+      for (iree_uk_index_t k = 0; k < params->K; ++k) {
+        for (iree_uk_index_t k0 = 0; k0 < K0; ++k0) {
+          float lhs_f32 =
+              iree_uk_f8e5m2_to_f32(lhs_panel[k * M0 * K0 + i0 * K0 + k0]);
+          float rhs_f32 =
+              iree_uk_f8e5m2_to_f32(rhs_panel[k * N0 * K0 + j0 * K0 + k0]);
+          acc += lhs_f32 * rhs_f32;
+        }
+      }
+      out_tile[i0 * N0 + j0] = acc;
+    }
+  }
+}
+
 // Generic implementation of matmul tile, bf16*bf16->bf16 case.
 // Not skipping intermediate roundings.
 static void iree_uk_mmt4d_tile_bf16bf16bf16_generic_noskipround(
@@ -384,6 +508,10 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_generic(
       return iree_uk_mmt4d_tile_s8s8s32_generic;
     case iree_uk_mmt4d_type_s8s4s32:
       return iree_uk_mmt4d_tile_s8s4s32_generic;
+    case iree_uk_mmt4d_type_u8s8s32:
+      return iree_uk_mmt4d_tile_u8s8s32_generic;
+    case iree_uk_mmt4d_type_s4s4s32:
+      return iree_uk_mmt4d_tile_s4s4s32_generic;
     case iree_uk_mmt4d_type_s16s16s32:
       return iree_uk_mmt4d_tile_s16s16s32_generic;
     case iree_uk_mmt4d_type_s16u4s32:
@@ -402,6 +530,10 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_generic(
       return (params->flags & IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS)
                  ? iree_uk_mmt4d_tile_bf16bf16bf16_generic_skipround
                  : iree_uk_mmt4d_tile_bf16bf16bf16_generic_noskipround;
+    case iree_uk_mmt4d_type_f8e4m3fnf8e4m3fnf32:
+      return iree_uk_mmt4d_tile_f8e4m3fnf8e4m3fnf32_generic;
+    case iree_uk_mmt4d_type_f8e5m2f8e5m2f32:
+      return iree_uk_mmt4d_tile_f8e5m2f8e5m2f32_generic;
     default:
       // Shouldn't happen, validated earlier.
       return 0;
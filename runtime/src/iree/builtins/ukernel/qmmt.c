@@ -0,0 +1,230 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/qmmt.h"
+
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/qmmt_internal.h"
+
+static void iree_uk_qmmt_validate(const iree_uk_qmmt_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_QMMT_TYPE_MASK | IREE_UK_FLAG_QMMT_ACCUMULATE;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type = params->flags & IREE_UK_FLAG_QMMT_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type > IREE_UK_FLAG_QMMT_TYPE_NONE &&
+                 flags_type < IREE_UK_FLAG_QMMT_TYPE_END);
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->M, 31));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->N, 31));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->K, 31));
+  // Blocks never straddle rows so K must be a whole number of blocks.
+  iree_uk_index_t block_element_count =
+      iree_uk_qmmt_rhs_block_element_count(params->flags);
+  IREE_UK_ASSERT(!(params->K % block_element_count));
+  IREE_UK_ASSERT(params->lhs_stride0 >= params->K);
+  IREE_UK_ASSERT(params->rhs_stride0 >=
+                 (params->K / block_element_count) *
+                     iree_uk_qmmt_rhs_block_size(params->flags));
+  IREE_UK_ASSERT(params->out_stride0 >= params->N);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Loads a little-endian f16 from a possibly unaligned address in a block.
+static inline float iree_uk_qmmt_load_f16(const iree_uk_uint8_t* ptr) {
+  return iree_uk_f16_to_f32((iree_uk_uint16_t)(ptr[0] | (ptr[1] << 8)));
+}
+
+// Dequantizes one RHS block into iree_uk_qmmt_*_block_element_count floats.
+typedef void (*iree_uk_qmmt_dequantize_func_t)(
+    const iree_uk_uint8_t* IREE_UK_RESTRICT block,
+    float* IREE_UK_RESTRICT out_values);
+
+static void iree_uk_qmmt_dequantize_q4_0(
+    const iree_uk_uint8_t* IREE_UK_RESTRICT block,
+    float* IREE_UK_RESTRICT out_values) {
+  const float d = iree_uk_qmmt_load_f16(block);
+  const iree_uk_uint8_t* qs = block + 2;
+  for (int i = 0; i < iree_uk_qmmt_q4_0_block_element_count / 2; ++i) {
+    out_values[i] = d * ((qs[i] & 0xF) - 8);
+    out_values[i + 16] = d * ((qs[i] >> 4) - 8);
+  }
+}
+
+static void iree_uk_qmmt_dequantize_q8_0(
+    const iree_uk_uint8_t* IREE_UK_RESTRICT block,
+    float* IREE_UK_RESTRICT out_values) {
+  const float d = iree_uk_qmmt_load_f16(block);
+  const iree_uk_int8_t* qs = (const iree_uk_int8_t*)(block + 2);
+  for (int i = 0; i < iree_uk_qmmt_q8_0_block_element_count; ++i) {
+    out_values[i] = d * qs[i];
+  }
+}
+
+// Unpacks the 6-bit scale and min of Q4_K sub-block |j| from the 12 bytes of
+// packed |scales|. Sub-blocks 0-3 store theirs in the low 6 bits of bytes 0-7
+// and sub-blocks 4-7 split theirs between bytes 8-11 and the top 2 bits of
+// bytes 0-7.
+static inline void iree_uk_qmmt_q4_k_scale_min(int j,
+                                               const iree_uk_uint8_t* scales,
+                                               int* out_scale, int* out_min) {
+  if (j < 4) {
+    *out_scale = scales[j] & 63;
+    *out_min = scales[j + 4] & 63;
+  } else {
+    *out_scale = (scales[j + 4] & 0xF) | ((scales[j - 4] >> 6) << 4);
+    *out_min = (scales[j + 4] >> 4) | ((scales[j] >> 6) << 4);
+  }
+}
+
+static void iree_uk_qmmt_dequantize_q4_k(
+    const iree_uk_uint8_t* IREE_UK_RESTRICT block,
+    float* IREE_UK_RESTRICT out_values) {
+  const float d = iree_uk_qmmt_load_f16(block);
+  const float dmin = iree_uk_qmmt_load_f16(block + 2);
+  const iree_uk_uint8_t* scales = block + 4;
+  const iree_uk_uint8_t* qs = block + 16;
+  // Each group of 32 bytes holds two sub-blocks: the first in the low nibbles
+  // and the second in the high nibbles.
+  for (int j = 0; j < 8; j += 2) {
+    int scale0 = 0, min0 = 0, scale1 = 0, min1 = 0;
+    iree_uk_qmmt_q4_k_scale_min(j + 0, scales, &scale0, &min0);
+    iree_uk_qmmt_q4_k_scale_min(j + 1, scales, &scale1, &min1);
+    const float d0 = d * scale0, m0 = dmin * min0;
+    const float d1 = d * scale1, m1 = dmin * min1;
+    float* out0 = out_values + j * 32;
+    float* out1 = out0 + 32;
+    for (int i = 0; i < 32; ++i) {
+      out0[i] = d0 * (qs[i] & 0xF) - m0;
+      out1[i] = d1 * (qs[i] >> 4) - m1;
+    }
+    qs += 32;
+  }
+}
+
+static void iree_uk_qmmt_zero_out(const iree_uk_qmmt_params_t* params) {
+  float* out = (float*)params->out_buffer + params->out_offset;
+  for (iree_uk_index_t m = 0; m < params->M; ++m) {
+    for (iree_uk_index_t n = 0; n < params->N; ++n) {
+      out[m * params->out_stride0 + n] = 0.0f;
+    }
+  }
+}
+
+// f32 LHS: each RHS block is dequantized once into a small buffer and then
+// reused across all LHS rows, so for the common decode case of small M the
+// cost is dominated by streaming the quantized RHS.
+static void iree_uk_qmmt_f32(const iree_uk_qmmt_params_t* params,
+                             iree_uk_qmmt_dequantize_func_t dequantize) {
+  const float* lhs = (const float*)params->lhs_buffer + params->lhs_offset;
+  const iree_uk_uint8_t* rhs =
+      (const iree_uk_uint8_t*)params->rhs_buffer + params->rhs_offset;
+  float* out = (float*)params->out_buffer + params->out_offset;
+  const iree_uk_index_t block_element_count =
+      iree_uk_qmmt_rhs_block_element_count(params->flags);
+  const iree_uk_index_t block_size =
+      iree_uk_qmmt_rhs_block_size(params->flags);
+  const iree_uk_index_t block_count = params->K / block_element_count;
+  IREE_UK_ATTRIBUTE_ALIGNED(64)
+  float rhs_values[iree_uk_qmmt_max_block_element_count];
+  for (iree_uk_index_t n = 0; n < params->N; ++n) {
+    const iree_uk_uint8_t* rhs_row = rhs + n * params->rhs_stride0;
+    for (iree_uk_index_t b = 0; b < block_count; ++b) {
+      dequantize(rhs_row + b * block_size, rhs_values);
+      const float* lhs_block = lhs + b * block_element_count;
+      for (iree_uk_index_t m = 0; m < params->M; ++m) {
+        const float* lhs_row = lhs_block + m * params->lhs_stride0;
+        float acc = 0.0f;
+        for (iree_uk_index_t k = 0; k < block_element_count; ++k) {
+          acc += lhs_row[k] * rhs_values[k];
+        }
+        out[m * params->out_stride0 + n] += acc;
+      }
+    }
+  }
+}
+
+// s8 LHS with Q8_0 RHS: the products within a block are accumulated exactly
+// in int32 and only the per-block sum is scaled by the block scale.
+static void iree_uk_qmmt_s8q8_0f32(const iree_uk_qmmt_params_t* params) {
+  const iree_uk_int8_t* lhs =
+      (const iree_uk_int8_t*)params->lhs_buffer + params->lhs_offset;
+  const iree_uk_uint8_t* rhs =
+      (const iree_uk_uint8_t*)params->rhs_buffer + params->rhs_offset;
+  float* out = (float*)params->out_buffer + params->out_offset;
+  const iree_uk_index_t block_count =
+      params->K / iree_uk_qmmt_q8_0_block_element_count;
+  for (iree_uk_index_t n = 0; n < params->N; ++n) {
+    const iree_uk_uint8_t* rhs_row = rhs + n * params->rhs_stride0;
+    for (iree_uk_index_t b = 0; b < block_count; ++b) {
+      const iree_uk_uint8_t* block = rhs_row + b * iree_uk_qmmt_q8_0_block_size;
+      const float d = iree_uk_qmmt_load_f16(block);
+      const iree_uk_int8_t* qs = (const iree_uk_int8_t*)(block + 2);
+      const iree_uk_int8_t* lhs_block =
+          lhs + b * iree_uk_qmmt_q8_0_block_element_count;
+      for (iree_uk_index_t m = 0; m < params->M; ++m) {
+        const iree_uk_int8_t* lhs_row = lhs_block + m * params->lhs_stride0;
+        iree_uk_int32_t acc = 0;
+        for (int k = 0; k < iree_uk_qmmt_q8_0_block_element_count; ++k) {
+          acc += (iree_uk_int32_t)lhs_row[k] * qs[k];
+        }
+        out[m * params->out_stride0 + n] += d * acc;
+      }
+    }
+  }
+}
+
+void iree_uk_qmmt_p(const iree_uk_qmmt_params_t* params) {
+  iree_uk_qmmt_validate(params);
+
+  // Trivial cases.
+  if (params->M == 0 || params->N == 0) return;
+  if (!(params->flags & IREE_UK_FLAG_QMMT_ACCUMULATE)) {
+    iree_uk_qmmt_zero_out(params);
+  }
+  if (params->K == 0) return;
+
+  switch (params->flags & IREE_UK_FLAG_QMMT_TYPE_MASK) {
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q4_0F32:
+      iree_uk_qmmt_f32(params, iree_uk_qmmt_dequantize_q4_0);
+      break;
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q8_0F32:
+      iree_uk_qmmt_f32(params, iree_uk_qmmt_dequantize_q8_0);
+      break;
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q4_KF32:
+      iree_uk_qmmt_f32(params, iree_uk_qmmt_dequantize_q4_k);
+      break;
+    case IREE_UK_FLAG_QMMT_TYPE_S8Q8_0F32:
+      iree_uk_qmmt_s8q8_0f32(params);
+      break;
+    default:
+      // Shouldn't happen, validated earlier.
+      break;
+  }
+}
+
+IREE_UK_EXPORT void iree_uk_qmmt(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0, void* out_buffer,
+    iree_uk_index_t out_offset, iree_uk_index_t out_stride0, iree_uk_index_t M,
+    iree_uk_index_t N, iree_uk_index_t K, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data) {
+  iree_uk_qmmt_params_t params = {.lhs_buffer = lhs_buffer,
+                                  .lhs_offset = lhs_offset,
+                                  .lhs_stride0 = lhs_stride0,
+                                  .rhs_buffer = rhs_buffer,
+                                  .rhs_offset = rhs_offset,
+                                  .rhs_stride0 = rhs_stride0,
+                                  .out_buffer = out_buffer,
+                                  .out_offset = out_offset,
+                                  .out_stride0 = out_stride0,
+                                  .M = M,
+                                  .N = N,
+                                  .K = K,
+                                  .flags = flags,
+                                  .cpu_data = cpu_data};
+  iree_uk_qmmt_p(&params);
+}
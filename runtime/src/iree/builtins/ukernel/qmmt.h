@@ -0,0 +1,31 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_QMMT_H_
+#define IREE_BUILTINS_UKERNEL_QMMT_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// `qmmt` microkernel: matrix multiplication with a transposed RHS that is
+// stored in one of the GGML block-quantized formats used by .gguf files. RHS
+// blocks are dequantized on the fly so that quantized weights can be consumed
+// at their native bit width instead of being expanded ahead of time.
+//
+// Computes out[m, n] (+)= sum_k lhs[m, k] * dequantize(rhs)[n, k] with an f32
+// result. Each RHS row is K / block_element_count consecutive blocks, which is
+// the layout of a GGML tensor with dimensions [K, N].
+//
+// LHS and out offsets and strides are in elements. RHS offsets and strides are
+// in bytes as blocks have no finer granularity.
+IREE_UK_EXPORT void iree_uk_qmmt(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0, void* out_buffer,
+    iree_uk_index_t out_offset, iree_uk_index_t out_stride0, iree_uk_index_t M,
+    iree_uk_index_t N, iree_uk_index_t K, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_BUILTINS_UKERNEL_QMMT_H_
@@ -0,0 +1,98 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_QMMT_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_QMMT_INTERNAL_H_
+
+#include "iree/builtins/ukernel/qmmt.h"
+
+// While the iree_uk_qmmt public entry point takes separate parameters,
+// internally the implementation functions pass parameters as this struct.
+typedef struct iree_uk_qmmt_params_t {
+  const void* lhs_buffer;
+  iree_uk_index_t lhs_offset;
+  iree_uk_index_t lhs_stride0;
+  const void* rhs_buffer;
+  iree_uk_index_t rhs_offset;
+  iree_uk_index_t rhs_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t M;
+  iree_uk_index_t N;
+  iree_uk_index_t K;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_qmmt_params_t;
+
+// Same as the iree_uk_qmmt public entry point, but taking the struct.
+void iree_uk_qmmt_p(const iree_uk_qmmt_params_t* params);
+
+// GGML block formats. Blocks are little-endian and start with f16 scales
+// followed by the packed quantized values:
+//   Q4_0: {f16 d; u8 qs[16]} for 32 values d * (q - 8), low nibbles first.
+//   Q8_0: {f16 d; s8 qs[32]} for 32 values d * q.
+//   Q4_K: {f16 d; f16 dmin; u8 scales[12]; u8 qs[128]} for 256 values in 8
+//         sub-blocks of 32 with 6-bit scales and mins.
+enum {
+  iree_uk_qmmt_q4_0_block_element_count = 32,
+  iree_uk_qmmt_q4_0_block_size = 18,
+  iree_uk_qmmt_q8_0_block_element_count = 32,
+  iree_uk_qmmt_q8_0_block_size = 34,
+  iree_uk_qmmt_q4_k_block_element_count = 256,
+  iree_uk_qmmt_q4_k_block_size = 144,
+  iree_uk_qmmt_max_block_element_count = 256,
+};
+
+static inline iree_uk_type_t iree_uk_qmmt_lhs_type(iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_QMMT_TYPE_MASK) {
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q4_0F32:
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q8_0F32:
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q4_KF32:
+      return IREE_UK_TYPE_FLOAT_32;
+    case IREE_UK_FLAG_QMMT_TYPE_S8Q8_0F32:
+      return IREE_UK_TYPE_SINT_8;
+    default:
+      // Shouldn't happen, validated earlier.
+      return IREE_UK_TYPE_NONE;
+  }
+}
+
+// Returns the number of RHS elements encoded by each block.
+static inline iree_uk_index_t iree_uk_qmmt_rhs_block_element_count(
+    iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_QMMT_TYPE_MASK) {
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q4_0F32:
+      return iree_uk_qmmt_q4_0_block_element_count;
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q8_0F32:
+    case IREE_UK_FLAG_QMMT_TYPE_S8Q8_0F32:
+      return iree_uk_qmmt_q8_0_block_element_count;
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q4_KF32:
+      return iree_uk_qmmt_q4_k_block_element_count;
+    default:
+      // Shouldn't happen, validated earlier.
+      return 0;
+  }
+}
+
+// Returns the size in bytes of each RHS block.
+static inline iree_uk_index_t iree_uk_qmmt_rhs_block_size(
+    iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_QMMT_TYPE_MASK) {
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q4_0F32:
+      return iree_uk_qmmt_q4_0_block_size;
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q8_0F32:
+    case IREE_UK_FLAG_QMMT_TYPE_S8Q8_0F32:
+      return iree_uk_qmmt_q8_0_block_size;
+    case IREE_UK_FLAG_QMMT_TYPE_F32Q4_KF32:
+      return iree_uk_qmmt_q4_k_block_size;
+    default:
+      // Shouldn't happen, validated earlier.
+      return 0;
+  }
+}
+
+#endif  // IREE_BUILTINS_UKERNEL_QMMT_INTERNAL_H_
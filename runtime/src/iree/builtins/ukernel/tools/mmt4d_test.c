@@ -195,6 +195,78 @@ static void iree_mmt4d_reference_innerloop_s8s4s32(
   *out_ptr = acc;
 }
 
+static void iree_mmt4d_reference_innerloop_u8s8s32(
+    int32_t* out_ptr, const uint8_t* lhs_ptr, const int8_t* rhs_ptr,
+    const iree_uk_mmt4d_params_t* params) {
+  int32_t acc = params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE ? *out_ptr : 0;
+  for (iree_uk_index_t k = 0; k < params->K; ++k) {
+    for (iree_uk_index_t k0 = 0; k0 < params->K0; ++k0) {
+      int32_t lhs_i32 = lhs_ptr[k * params->M0 * params->K0 + k0];
+      int32_t rhs_i32 = rhs_ptr[k * params->N0 * params->K0 + k0];
+      acc += lhs_i32 * rhs_i32;
+    }
+  }
+  *out_ptr = acc;
+}
+
+static int32_t iree_mmt4d_reference_sign_extend_s4(uint8_t nibble) {
+  return (nibble & 0x08) ? (int32_t)nibble - 16 : (int32_t)nibble;
+}
+
+static void iree_mmt4d_reference_innerloop_s4s4s32(
+    int32_t* out_ptr, const uint8_t* lhs_ptr, const uint8_t* rhs_ptr,
+    const iree_uk_mmt4d_params_t* params) {
+  // K0 must be even.
+  IREE_UK_ASSERT(!(params->K0 % 2));
+  iree_uk_int16_t K0half = params->K0 / 2;
+  int32_t acc = params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE ? *out_ptr : 0;
+  for (iree_uk_index_t k = 0; k < params->K; ++k) {
+    // As K0 must be even, we 2x-unroll the K0 loop, writing a 2D dot product.
+    for (iree_uk_index_t k0h = 0; k0h < K0half; ++k0h) {
+      uint8_t lhs_byte = lhs_ptr[k * params->M0 * K0half + k0h];
+      uint8_t rhs_byte = rhs_ptr[k * params->N0 * K0half + k0h];
+      int32_t lhs_0 = iree_mmt4d_reference_sign_extend_s4(lhs_byte & 0xf);
+      int32_t lhs_1 = iree_mmt4d_reference_sign_extend_s4(lhs_byte >> 4);
+      int32_t rhs_0 = iree_mmt4d_reference_sign_extend_s4(rhs_byte & 0xf);
+      int32_t rhs_1 = iree_mmt4d_reference_sign_extend_s4(rhs_byte >> 4);
+      acc += lhs_0 * rhs_0 + lhs_1 * rhs_1;
+    }
+  }
+  *out_ptr = acc;
+}
+
+static void iree_mmt4d_reference_innerloop_f8e4m3fnf8e4m3fnf32(
+    float* out_ptr, const uint8_t* lhs_ptr, const uint8_t* rhs_ptr,
+    const iree_uk_mmt4d_params_t* params) {
+  float acc = params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE ? *out_ptr : 0.f;
+  for (iree_uk_index_t k = 0; k < params->K; ++k) {
+    for (iree_uk_index_t k0 = 0; k0 < params->K0; ++k0) {
+      float lhs_f32 =
+          iree_math_f8e4m3fn_to_f32(lhs_ptr[k * params->M0 * params->K0 + k0]);
+      float rhs_f32 =
+          iree_math_f8e4m3fn_to_f32(rhs_ptr[k * params->N0 * params->K0 + k0]);
+      acc += lhs_f32 * rhs_f32;
+    }
+  }
+  *out_ptr = acc;
+}
+
+static void iree_mmt4d_reference_innerloop_f8e5m2f8e5m2f32(
+    float* out_ptr, const uint8_t* lhs_ptr, const uint8_t* rhs_ptr,
+    const iree_uk_mmt4d_params_t* params) {
+  float acc = params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE ? *out_ptr : 0.f;
+  for (iree_uk_index_t k = 0; k < params->K; ++k) {
+    for (iree_uk_index_t k0 = 0; k0 < params->K0; ++k0) {
+      float lhs_f32 =
+          iree_math_f8e5m2_to_f32(lhs_ptr[k * params->M0 * params->K0 + k0]);
+      float rhs_f32 =
+          iree_math_f8e5m2_to_f32(rhs_ptr[k * params->N0 * params->K0 + k0]);
+      acc += lhs_f32 * rhs_f32;
+    }
+  }
+  *out_ptr = acc;
+}
+
 static void iree_mmt4d_reference_innerloop_s16s16s32(
     int32_t* out_ptr, const int16_t* lhs_ptr, const int16_t* rhs_ptr,
     const iree_uk_mmt4d_params_t* params) {
@@ -315,6 +387,26 @@ static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
                   (int32_t*)out_ptr, (const int8_t*)lhs_ptr,
                   (const int8_t*)rhs_ptr, params);
               break;
+            case IREE_UK_FLAG_MMT4D_TYPE_U8S8S32:
+              iree_mmt4d_reference_innerloop_u8s8s32(
+                  (int32_t*)out_ptr, (const uint8_t*)lhs_ptr,
+                  (const int8_t*)rhs_ptr, params);
+              break;
+            case IREE_UK_FLAG_MMT4D_TYPE_S4S4S32:
+              iree_mmt4d_reference_innerloop_s4s4s32(
+                  (int32_t*)out_ptr, (const uint8_t*)lhs_ptr,
+                  (const uint8_t*)rhs_ptr, params);
+              break;
+            case IREE_UK_FLAG_MMT4D_TYPE_F8E4M3FNF8E4M3FNF32:
+              iree_mmt4d_reference_innerloop_f8e4m3fnf8e4m3fnf32(
+                  (float*)out_ptr, (const uint8_t*)lhs_ptr,
+                  (const uint8_t*)rhs_ptr, params);
+              break;
+            case IREE_UK_FLAG_MMT4D_TYPE_F8E5M2F8E5M2F32:
+              iree_mmt4d_reference_innerloop_f8e5m2f8e5m2f32(
+                  (float*)out_ptr, (const uint8_t*)lhs_ptr,
+                  (const uint8_t*)rhs_ptr, params);
+              break;
             case IREE_UK_FLAG_MMT4D_TYPE_S16S16S32:
               iree_mmt4d_reference_innerloop_s16s16s32(
                   (int32_t*)out_ptr, (const int16_t*)lhs_ptr,
@@ -552,6 +644,10 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 3, 5, 8, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 11, 4, 1, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16, 2, 9, 3, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_U8S8S32, 5, 7, 3, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S4S4S32, 3, 5, 4, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F8E4M3FNF8E4M3FNF32, 6, 5, 3, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F8E5M2F8E5M2F32, 3, 7, 2, "");
 
 #if defined(IREE_ARCH_ARM_64)
 
@@ -572,6 +668,9 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 8, 8, 8, "i8mm");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 8, 8, 8, "dotprod");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 4, 8, 16, "i8mm");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_U8S8S32, 8, 8, 4, "dotprod");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_U8S8S32, 8, 8, 8, "i8mm");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S4S4S32, 8, 8, 8, "dotprod");
 
 #elif defined(IREE_ARCH_X86_64)
 
@@ -601,6 +700,8 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16S16S32, 16, 16, 2,
                      "avx512_vnni");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16U4S32, 1, 32, 8, "avx512_vnni");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_U8S8S32, 16, 16, 4, "avx512_vnni");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S4S4S32, 16, 16, 8, "avx512_vnni");
 
 #elif defined(IREE_ARCH_RISCV_64)
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 7, 16, 1, "v");
@@ -0,0 +1,127 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/qmmt_internal.h"
+#include "iree/builtins/ukernel/tools/benchmark.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+IREE_FLAG(int32_t, m_size, 1,
+          "M-dimension of qmmt ops. 1 is the matrix-vector product used when "
+          "decoding a single token.");
+IREE_FLAG(int32_t, n_size, 4096,
+          "N-dimension of qmmt ops: the number of quantized RHS rows.");
+IREE_FLAG(int32_t, k_size, 4096,
+          "K-dimension of qmmt ops. Rounded up to a whole number of RHS "
+          "blocks.");
+IREE_FLAG(bool, accumulate, false,
+          "Whether the kernel should accumulate into the existing accumulator "
+          "values, or zero the accumulator.");
+
+static iree_status_t iree_uk_benchmark_qmmt(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_uk_benchmark_user_data_t* user_data = benchmark_def->user_data;
+  const iree_uk_qmmt_params_t* src_params = iree_uk_benchmark_params(user_data);
+  iree_uk_qmmt_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  params.cpu_data = iree_uk_benchmark_cpu_data(user_data);
+  if (FLAG_accumulate) params.flags |= IREE_UK_FLAG_QMMT_ACCUMULATE;
+  iree_uk_index_t block_element_count =
+      iree_uk_qmmt_rhs_block_element_count(params.flags);
+  params.M = FLAG_m_size;
+  params.N = FLAG_n_size;
+  params.K = iree_uk_index_max(1, (FLAG_k_size + block_element_count - 1) /
+                                      block_element_count) *
+             block_element_count;
+  params.lhs_stride0 = params.K;
+  params.rhs_stride0 = (params.K / block_element_count) *
+                       iree_uk_qmmt_rhs_block_size(params.flags);
+  params.out_stride0 = params.N;
+  iree_uk_type_t lhs_type = iree_uk_qmmt_lhs_type(params.flags);
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size = params.N * params.rhs_stride0;
+  iree_uk_index_t out_buffer_size = iree_uk_2d_buffer_length(
+      IREE_UK_TYPE_FLOAT_32, params.M, params.out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  uint8_t* rhs_buffer = malloc(rhs_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  iree_uk_random_engine_t* engine = iree_uk_benchmark_random_engine(user_data);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, IREE_UK_TYPE_UINT_8,
+                              engine);
+  iree_uk_write_random_buffer(out_buffer, out_buffer_size,
+                              IREE_UK_TYPE_FLOAT_32, engine);
+  // Random block scales could be NaN or infinity; use 1.0 (f16 0x3C00) to keep
+  // the arithmetic representative of real weights. Q4_K blocks have a second
+  // scale for the mins.
+  iree_uk_index_t block_size = iree_uk_qmmt_rhs_block_size(params.flags);
+  int scale_count = (params.flags & IREE_UK_FLAG_QMMT_TYPE_MASK) ==
+                            IREE_UK_FLAG_QMMT_TYPE_F32Q4_KF32
+                        ? 2
+                        : 1;
+  for (iree_uk_index_t offset = 0; offset < rhs_buffer_size;
+       offset += block_size) {
+    for (int i = 0; i < scale_count; ++i) {
+      rhs_buffer[offset + 2 * i + 0] = 0x00;
+      rhs_buffer[offset + 2 * i + 1] = 0x3C;
+    }
+  }
+  params.lhs_buffer = lhs_buffer;
+  params.rhs_buffer = rhs_buffer;
+  params.out_buffer = out_buffer;
+  int64_t total_iterations = 0;
+  int64_t batch_count = 1;
+  while (iree_benchmark_keep_running(benchmark_state, batch_count)) {
+    for (int i = 0; i < batch_count; ++i) {
+      iree_uk_qmmt_p(&params);
+    }
+    total_iterations += batch_count;
+    batch_count *= 2;
+  }
+  iree_benchmark_set_items_processed(
+      benchmark_state, total_iterations * 2 * params.M * params.N * params.K);
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(out_buffer);
+  return iree_ok_status();
+}
+
+static void iree_uk_benchmark_register_qmmt(iree_uk_uint32_t flags,
+                                            const char* type_str,
+                                            const char* cpu_features) {
+  char name[128];
+  snprintf(name, sizeof name, "qmmt_%s", type_str);
+  iree_uk_qmmt_params_t params = {.flags = flags};
+  iree_uk_benchmark_register(name, iree_uk_benchmark_qmmt, &params,
+                             sizeof params, cpu_features);
+}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage("qmmt_benchmark", "");
+
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
+  iree_uk_benchmark_initialize(&argc, argv);
+
+  // There are no architecture-specific code paths yet so these all measure
+  // the generic implementation as compiled for the host.
+  iree_uk_benchmark_register_qmmt(IREE_UK_FLAG_QMMT_TYPE_F32Q4_0F32,
+                                  "f32q4_0f32", "");
+  iree_uk_benchmark_register_qmmt(IREE_UK_FLAG_QMMT_TYPE_F32Q8_0F32,
+                                  "f32q8_0f32", "");
+  iree_uk_benchmark_register_qmmt(IREE_UK_FLAG_QMMT_TYPE_F32Q4_KF32,
+                                  "f32q4_kf32", "");
+  iree_uk_benchmark_register_qmmt(IREE_UK_FLAG_QMMT_TYPE_S8Q8_0F32,
+                                  "s8q8_0f32", "");
+
+  iree_uk_benchmark_run_and_cleanup();
+}
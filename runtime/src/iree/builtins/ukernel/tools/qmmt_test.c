@@ -0,0 +1,257 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/api.h"
+#include "iree/base/internal/math.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/qmmt_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// Reference dequantization, following the dequantize_row_* functions in
+// ggml-quants.c. Returns the value of element |k| in the row of blocks
+// starting at |row|.
+static float iree_qmmt_reference_load_f16(const uint8_t* ptr) {
+  return iree_math_f16_to_f32((uint16_t)(ptr[0] | (ptr[1] << 8)));
+}
+
+static float iree_qmmt_reference_dequantize_q4_0(const uint8_t* row,
+                                                 iree_uk_index_t k) {
+  const uint8_t* block = row + (k / 32) * 18;
+  int i = k % 32;
+  uint8_t byte = block[2 + i % 16];
+  int q = i < 16 ? (byte & 0xF) : (byte >> 4);
+  return iree_qmmt_reference_load_f16(block) * (q - 8);
+}
+
+static float iree_qmmt_reference_dequantize_q8_0(const uint8_t* row,
+                                                 iree_uk_index_t k) {
+  const uint8_t* block = row + (k / 32) * 34;
+  return iree_qmmt_reference_load_f16(block) * (int8_t)block[2 + k % 32];
+}
+
+static float iree_qmmt_reference_dequantize_q4_k(const uint8_t* row,
+                                                 iree_uk_index_t k) {
+  const uint8_t* block = row + (k / 256) * 144;
+  const uint8_t* scales = block + 4;
+  int i = k % 256;
+  int j = i / 32;
+  int scale, min;
+  if (j < 4) {
+    scale = scales[j] & 63;
+    min = scales[j + 4] & 63;
+  } else {
+    scale = (scales[j + 4] & 0xF) | ((scales[j - 4] >> 6) << 4);
+    min = (scales[j + 4] >> 4) | ((scales[j] >> 6) << 4);
+  }
+  uint8_t byte = block[16 + (j / 2) * 32 + i % 32];
+  int q = (j % 2) ? (byte >> 4) : (byte & 0xF);
+  return iree_qmmt_reference_load_f16(block) * scale * q -
+         iree_qmmt_reference_load_f16(block + 2) * min;
+}
+
+static void iree_qmmt_reference(const iree_uk_qmmt_params_t* params) {
+  const uint8_t* rhs = (const uint8_t*)params->rhs_buffer + params->rhs_offset;
+  float* out = (float*)params->out_buffer + params->out_offset;
+  iree_uk_uint32_t type = params->flags & IREE_UK_FLAG_QMMT_TYPE_MASK;
+  for (iree_uk_index_t m = 0; m < params->M; ++m) {
+    for (iree_uk_index_t n = 0; n < params->N; ++n) {
+      const uint8_t* rhs_row = rhs + n * params->rhs_stride0;
+      float acc = (params->flags & IREE_UK_FLAG_QMMT_ACCUMULATE)
+                      ? out[m * params->out_stride0 + n]
+                      : 0.0f;
+      for (iree_uk_index_t k = 0; k < params->K; ++k) {
+        iree_uk_index_t lhs_index =
+            params->lhs_offset + m * params->lhs_stride0 + k;
+        float lhs_value =
+            type == IREE_UK_FLAG_QMMT_TYPE_S8Q8_0F32
+                ? ((const int8_t*)params->lhs_buffer)[lhs_index]
+                : ((const float*)params->lhs_buffer)[lhs_index];
+        float rhs_value = 0.0f;
+        switch (type) {
+          case IREE_UK_FLAG_QMMT_TYPE_F32Q4_0F32:
+            rhs_value = iree_qmmt_reference_dequantize_q4_0(rhs_row, k);
+            break;
+          case IREE_UK_FLAG_QMMT_TYPE_F32Q8_0F32:
+          case IREE_UK_FLAG_QMMT_TYPE_S8Q8_0F32:
+            rhs_value = iree_qmmt_reference_dequantize_q8_0(rhs_row, k);
+            break;
+          case IREE_UK_FLAG_QMMT_TYPE_F32Q4_KF32:
+            rhs_value = iree_qmmt_reference_dequantize_q4_k(rhs_row, k);
+            break;
+          default:
+            IREE_UK_ASSERT(0 && "unhandled type");
+        }
+        acc += lhs_value * rhs_value;
+      }
+      out[m * params->out_stride0 + n] = acc;
+    }
+  }
+}
+
+// Fills |buffer| with random blocks. Block bytes are random but the f16 scales
+// are overwritten with 0.5 or 1.0 so that all dequantized values and their
+// products with small integer LHS values are exactly representable. This lets
+// the test compare results exactly regardless of the accumulation order.
+static void iree_uk_qmmt_write_random_blocks(void* buffer,
+                                             iree_uk_index_t size_in_bytes,
+                                             iree_uk_uint32_t flags,
+                                             iree_uk_random_engine_t* engine) {
+  uint8_t* bytes = (uint8_t*)buffer;
+  for (iree_uk_index_t i = 0; i < size_in_bytes; ++i) {
+    bytes[i] = iree_uk_random_engine_get_0_255(engine);
+  }
+  iree_uk_index_t block_size = iree_uk_qmmt_rhs_block_size(flags);
+  int scale_count =
+      (flags & IREE_UK_FLAG_QMMT_TYPE_MASK) == IREE_UK_FLAG_QMMT_TYPE_F32Q4_KF32
+          ? 2
+          : 1;
+  for (iree_uk_index_t offset = 0; offset + block_size <= size_in_bytes;
+       offset += block_size) {
+    for (int i = 0; i < scale_count; ++i) {
+      uint16_t scale = iree_math_f32_to_f16(
+          iree_uk_random_engine_get_0_1(engine) ? 1.0f : 0.5f);
+      bytes[offset + 2 * i + 0] = scale & 0xFF;
+      bytes[offset + 2 * i + 1] = scale >> 8;
+    }
+  }
+}
+
+static void iree_uk_qmmt_write_random_lhs(void* buffer,
+                                          iree_uk_index_t element_count,
+                                          iree_uk_type_t type,
+                                          iree_uk_random_engine_t* engine) {
+  for (iree_uk_index_t i = 0; i < element_count; ++i) {
+    int value = iree_uk_random_engine_get_0_255(engine) % 5 - 2;
+    if (type == IREE_UK_TYPE_SINT_8) {
+      ((int8_t*)buffer)[i] = value;
+    } else {
+      ((float*)buffer)[i] = value;
+    }
+  }
+}
+
+static void iree_uk_test_qmmt_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_qmmt_params_t* src_params) {
+  iree_uk_qmmt_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  iree_uk_type_t lhs_type = iree_uk_qmmt_lhs_type(params.flags);
+  iree_uk_index_t rhs_row_size =
+      (params.K / iree_uk_qmmt_rhs_block_element_count(params.flags)) *
+      iree_uk_qmmt_rhs_block_size(params.flags);
+  // Randomly make strides and offsets either tight or not to exercise all
+  // cases. Loose RHS strides and offsets leave blocks unaligned.
+  params.lhs_stride0 = params.K + iree_uk_random_engine_get_0_1(engine);
+  params.rhs_stride0 = rhs_row_size + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 = params.N + iree_uk_random_engine_get_0_1(engine);
+  params.lhs_offset = iree_uk_random_engine_get_0_1(engine);
+  params.rhs_offset = iree_uk_random_engine_get_0_1(engine);
+  params.out_offset = iree_uk_random_engine_get_0_1(engine);
+  iree_uk_index_t lhs_element_count =
+      params.lhs_offset + params.M * params.lhs_stride0;
+  iree_uk_index_t rhs_buffer_size =
+      params.rhs_offset + params.N * params.rhs_stride0;
+  iree_uk_index_t out_element_count =
+      params.out_offset + params.M * params.out_stride0;
+  void* lhs_buffer =
+      malloc(lhs_element_count * iree_uk_type_size(lhs_type) + 1);
+  uint8_t* rhs_buffer = malloc(rhs_buffer_size + 1);
+  iree_uk_qmmt_write_random_lhs(lhs_buffer, lhs_element_count, lhs_type,
+                                engine);
+  memset(rhs_buffer, 0, rhs_buffer_size + 1);
+  for (iree_uk_index_t n = 0; n < params.N; ++n) {
+    iree_uk_qmmt_write_random_blocks(
+        rhs_buffer + params.rhs_offset + n * params.rhs_stride0, rhs_row_size,
+        params.flags, engine);
+  }
+  params.lhs_buffer = lhs_buffer;
+  params.rhs_buffer = rhs_buffer;
+
+  iree_uk_index_t out_buffer_size = out_element_count * sizeof(float) + 1;
+  float* init_out_buffer = malloc(out_buffer_size);
+  iree_uk_qmmt_write_random_lhs(init_out_buffer, out_element_count,
+                                IREE_UK_TYPE_FLOAT_32, engine);
+
+  iree_uk_qmmt_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof params);
+  void* reference_out_buffer = malloc(out_buffer_size);
+  memcpy(reference_out_buffer, init_out_buffer, out_buffer_size);
+  reference_params.out_buffer = reference_out_buffer;
+
+  iree_uk_qmmt_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof params);
+  void* actual_out_buffer = malloc(out_buffer_size);
+  memcpy(actual_out_buffer, init_out_buffer, out_buffer_size);
+  actual_params.out_buffer = actual_out_buffer;
+
+  iree_qmmt_reference(&reference_params);
+  iree_uk_qmmt_p(&actual_params);
+
+  // Exact comparison: see iree_uk_qmmt_write_random_blocks.
+  if (memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size)) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(init_out_buffer);
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+  free(lhs_buffer);
+  free(rhs_buffer);
+}
+
+static void iree_uk_test_qmmt_for_type(iree_uk_test_t* test,
+                                       const void* src_params) {
+  typedef struct shape_mnk_t {
+    int m, n, k_blocks;
+  } shape_mnk_t;
+  const shape_mnk_t shapes[] = {
+      // Degenerate cases. Vacuous if flags have ACCUMULATE, otherwise zeroing
+      // the output buffer when K==0.
+      {0, 1, 1},
+      {1, 0, 1},
+      {1, 1, 0},
+      {5, 7, 0},
+      // Non-degenerate cases. M==1 is the matrix-vector product used when
+      // decoding.
+      {1, 1, 1},
+      {1, 1, 5},
+      {1, 9, 2},
+      {3, 1, 1},
+      {4, 5, 3},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_qmmt_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.cpu_data = iree_uk_test_cpu_data(test);
+    params.M = shapes[i].m;
+    params.N = shapes[i].n;
+    params.K = shapes[i].k_blocks *
+               iree_uk_qmmt_rhs_block_element_count(params.flags);
+    for (int accumulate = 0; accumulate <= 1; ++accumulate) {
+      if (accumulate) params.flags |= IREE_UK_FLAG_QMMT_ACCUMULATE;
+      iree_uk_test_qmmt_for_shape_params(test, &params);
+    }
+  }
+}
+
+static void iree_uk_test_qmmt(iree_uk_uint32_t flags, const char* type_str,
+                              const char* cpu_features) {
+  iree_uk_qmmt_params_t params = {.flags = flags};
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "types:%s", type_str);
+  iree_uk_test(test_label_str, iree_uk_test_qmmt_for_type, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  iree_uk_test_qmmt(IREE_UK_FLAG_QMMT_TYPE_F32Q4_0F32, "f32q4_0f32", "");
+  iree_uk_test_qmmt(IREE_UK_FLAG_QMMT_TYPE_F32Q8_0F32, "f32q8_0f32", "");
+  iree_uk_test_qmmt(IREE_UK_FLAG_QMMT_TYPE_F32Q4_KF32, "f32q4_kf32", "");
+  iree_uk_test_qmmt(IREE_UK_FLAG_QMMT_TYPE_S8Q8_0F32, "s8q8_0f32", "");
+
+  return iree_uk_test_exit_status();
+}
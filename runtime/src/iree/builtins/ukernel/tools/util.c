@@ -145,6 +145,15 @@ void iree_uk_write_random_buffer(void* buffer, iree_uk_index_t size_in_bytes,
         ((uint16_t*)buffer)[i] =
             iree_math_f32_to_bf16((float)((random_val % 4) - 2));
         break;
+      case IREE_UK_TYPE_FLOAT8_E4M3FN:
+        ((uint8_t*)buffer)[i] =
+            iree_math_f32_to_f8e4m3fn((float)((random_val % 16) - 8));
+        break;
+      case IREE_UK_TYPE_FLOAT8_E5M2:
+        // With only 2 mantissa bits, not all integers in [-8, 7] are exact.
+        ((uint8_t*)buffer)[i] =
+            iree_math_f32_to_f8e5m2((float)((random_val % 8) - 4));
+        break;
       case IREE_UK_TYPE_SINT_32:
         ((int32_t*)buffer)[i] = (random_val % 2048) - 512;
         break;
@@ -183,6 +192,10 @@ static const char* iree_uk_type_category_str(const iree_uk_type_t type) {
       return "f";
     case IREE_UK_TYPE_CATEGORY_FLOAT_BRAIN:
       return "bf";
+    case IREE_UK_TYPE_CATEGORY_FLOAT_E4M3FN:
+      return "f8e4m3fn";
+    case IREE_UK_TYPE_CATEGORY_FLOAT_E5M2:
+      return "f8e5m2";
     default:
       IREE_UK_ASSERT(false && "unknown type category");
       return "(?)";
@@ -190,14 +203,22 @@ static const char* iree_uk_type_category_str(const iree_uk_type_t type) {
 }
 
 int iree_uk_type_str(char* buf, int buf_length, const iree_uk_type_t type) {
+  switch (iree_uk_type_category(type)) {
+    case IREE_UK_TYPE_CATEGORY_FLOAT_E4M3FN:
+    case IREE_UK_TYPE_CATEGORY_FLOAT_E5M2:
+      // The 8-bit float category names already include the bit width.
+      return snprintf(buf, buf_length, "%s", iree_uk_type_category_str(type));
+    default:
+      break;
+  }
   return snprintf(buf, buf_length, "%s%d", iree_uk_type_category_str(type),
                   iree_uk_type_bit_count(type));
 }
 
 int iree_uk_type_pair_str(char* buf, int buf_length,
                           const iree_uk_type_pair_t pair) {
-  char type0_buf[8];
-  char type1_buf[8];
+  char type0_buf[16];
+  char type1_buf[16];
   iree_uk_type_str(type0_buf, sizeof type0_buf, iree_uk_untie_type(0, pair));
   iree_uk_type_str(type1_buf, sizeof type1_buf, iree_uk_untie_type(1, pair));
   return snprintf(buf, buf_length, "%s%s", type0_buf, type1_buf);
@@ -205,9 +226,9 @@ int iree_uk_type_pair_str(char* buf, int buf_length,
 
 int iree_uk_type_triple_str(char* buf, int buf_length,
                             const iree_uk_type_triple_t triple) {
-  char type0_buf[8];
-  char type1_buf[8];
-  char type2_buf[8];
+  char type0_buf[16];
+  char type1_buf[16];
+  char type2_buf[16];
   iree_uk_type_str(type0_buf, sizeof type0_buf, iree_uk_untie_type(0, triple));
   iree_uk_type_str(type1_buf, sizeof type1_buf, iree_uk_untie_type(1, triple));
   iree_uk_type_str(type2_buf, sizeof type2_buf, iree_uk_untie_type(2, triple));
@@ -67,6 +67,27 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_statistics_format(
       statistics->device_bytes_freed,
       (statistics->device_bytes_allocated - statistics->device_bytes_freed)));
 
+  if (statistics->pool_hit_count || statistics->pool_miss_count) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder,
+        "     POOLING: %12" PRIu64 "  hits / %12" PRIu64
+        "  misses / %12" PRIdsz "B wasted\n",
+        statistics->pool_hit_count, statistics->pool_miss_count,
+        statistics->pool_bytes_wasted));
+  }
+
+  if (statistics->numa_local_bytes || statistics->numa_remote_bytes) {
+    const iree_device_size_t numa_total_bytes =
+        statistics->numa_local_bytes + statistics->numa_remote_bytes;
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder,
+        "        NUMA: %12" PRIdsz "B local / %12" PRIdsz
+        "B remote / %11.2f%% remote\n",
+        statistics->numa_local_bytes, statistics->numa_remote_bytes,
+        100.0 * (double)statistics->numa_remote_bytes /
+            (double)numa_total_bytes));
+  }
+
 #else
   // No-op when disabled.
 #endif  // IREE_STATISTICS_ENABLE
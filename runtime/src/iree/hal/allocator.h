@@ -319,6 +319,23 @@ typedef struct iree_hal_allocator_statistics_t {
   iree_device_size_t device_bytes_peak;
   iree_device_size_t device_bytes_allocated;
   iree_device_size_t device_bytes_freed;
+  // Total number of allocation requests serviced from a cache of previously
+  // released buffers by pooling allocators.
+  uint64_t pool_hit_count;
+  // Total number of allocation requests a pooling allocator could not service
+  // from its cache and had to pass to the underlying allocator.
+  uint64_t pool_miss_count;
+  // Total bytes of padding added to allocation requests by pooling allocators
+  // in order to round them up to reusable size classes.
+  iree_device_size_t pool_bytes_wasted;
+  // Estimated bytes of live NUMA-bound allocations resident on the node they
+  // were bound to. Sampled when the statistics are queried.
+  iree_device_size_t numa_local_bytes;
+  // Estimated bytes of live NUMA-bound allocations resident on nodes other than
+  // the one they were bound to. Sampled when the statistics are queried. A high
+  // ratio of remote to local bytes indicates that memory was first touched by
+  // threads on other nodes or that the bound node ran out of memory.
+  iree_device_size_t numa_remote_bytes;
   // TODO(benvanik): mapping information (discarded, mapping ranges,
   //                 flushed/invalidated, etc).
 #else
@@ -652,6 +669,30 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_t identifier, iree_allocator_t data_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
 
+// Creates a host-local heap allocator as with iree_hal_allocator_create_heap
+// that places the storage of buffers on the NUMA node of the queues they are
+// allocated for. |queue_nodes| maps each of the first |queue_count| queue
+// affinity bits to the NUMA node ID of the processors servicing the queue
+// selected for that bit or IREE_MEMORY_NODE_ID_ANY (from
+// iree/base/internal/memory.h) if the queue is not bound to a node.
+//
+// A buffer is bound to a node if all queues in its queue affinity are on that
+// node. Bound buffers have their storage mapped directly from the system
+// instead of being allocated from |data_allocator| and small buffers that
+// would share pages with other allocations are never bound. Buffers that may
+// be used by queues on multiple nodes are placed by the platform on first
+// touch. Placement is a preference and falls back to other nodes if the bound
+// node runs out of memory. On platforms without NUMA support this behaves the
+// same as iree_hal_allocator_create_heap.
+//
+// When statistics are enabled the residency of live bound buffers is sampled
+// each time statistics are queried and reported as
+// numa_local_bytes/numa_remote_bytes.
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_numa(
+    iree_string_view_t identifier, iree_host_size_t queue_count,
+    const uint32_t* queue_nodes, iree_allocator_t data_allocator,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_allocator_t implementation details
 //===----------------------------------------------------------------------===//
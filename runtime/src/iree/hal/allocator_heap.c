@@ -5,8 +5,10 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/memory.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer.h"
 #include "iree/hal/buffer_heap_impl.h"
@@ -18,6 +20,10 @@ typedef struct iree_hal_heap_allocator_t {
   iree_allocator_t data_allocator;
   iree_string_view_t identifier;
   IREE_STATISTICS(iree_hal_heap_allocator_statistics_t statistics;)
+  // NUMA node of the queue selected for each queue affinity bit or
+  // IREE_MEMORY_NODE_ID_ANY. Empty if buffers are not bound to nodes.
+  iree_host_size_t queue_count;
+  uint32_t queue_nodes[];
 } iree_hal_heap_allocator_t;
 
 static const iree_hal_allocator_vtable_t iree_hal_heap_allocator_vtable;
@@ -30,13 +36,38 @@ iree_hal_heap_allocator_t* iree_hal_heap_allocator_cast(
 IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_t identifier, iree_allocator_t data_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+  return iree_hal_allocator_create_heap_numa(identifier, /*queue_count=*/0,
+                                             /*queue_nodes=*/NULL,
+                                             data_allocator, host_allocator,
+                                             out_allocator);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_numa(
+    iree_string_view_t identifier, iree_host_size_t queue_count,
+    const uint32_t* queue_nodes, iree_allocator_t data_allocator,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+  IREE_ASSERT_ARGUMENT(!queue_count || queue_nodes);
   IREE_ASSERT_ARGUMENT(out_allocator);
   *out_allocator = NULL;
+  if (queue_count > IREE_HAL_MAX_QUEUES) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "queue count %" PRIhsz " exceeds the maximum of %d",
+                            queue_count, (int)IREE_HAL_MAX_QUEUES);
+  }
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Placement is only useful if queues are bound to nodes.
+  bool any_queue_bound = false;
+  for (iree_host_size_t i = 0; i < queue_count; ++i) {
+    any_queue_bound |= queue_nodes[i] != IREE_MEMORY_NODE_ID_ANY;
+  }
+  if (!any_queue_bound) queue_count = 0;
+
   iree_hal_heap_allocator_t* allocator = NULL;
+  const iree_host_size_t queue_nodes_size =
+      queue_count * sizeof(allocator->queue_nodes[0]);
   iree_host_size_t total_size =
-      iree_sizeof_struct(*allocator) + identifier.size;
+      iree_sizeof_struct(*allocator) + queue_nodes_size + identifier.size;
   iree_status_t status =
       iree_allocator_malloc(host_allocator, total_size, (void**)&allocator);
   if (iree_status_is_ok(status)) {
@@ -44,9 +75,13 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
                                  &allocator->resource);
     allocator->host_allocator = host_allocator;
     allocator->data_allocator = data_allocator;
+    allocator->queue_count = queue_count;
+    if (queue_count > 0) {
+      memcpy(allocator->queue_nodes, queue_nodes, queue_nodes_size);
+    }
     iree_string_view_append_to_buffer(
         identifier, &allocator->identifier,
-        (char*)allocator + iree_sizeof_struct(*allocator));
+        (char*)allocator + iree_sizeof_struct(*allocator) + queue_nodes_size);
 
     IREE_STATISTICS({
       // All start initialized to zero.
@@ -95,6 +130,11 @@ static void iree_hal_heap_allocator_query_statistics(
     iree_slim_mutex_lock(&allocator->statistics.mutex);
     memcpy(out_statistics, &allocator->statistics.base,
            sizeof(*out_statistics));
+    // Residency is sampled only when requested as it requires a syscall per
+    // live node-bound buffer.
+    iree_hal_heap_allocator_statistics_query_numa_residency(
+        &allocator->statistics, &out_statistics->numa_local_bytes,
+        &out_statistics->numa_remote_bytes);
     iree_slim_mutex_unlock(&allocator->statistics.mutex);
   });
 }
@@ -175,6 +215,27 @@ iree_hal_heap_allocator_query_buffer_compatibility(
   return compatibility;
 }
 
+// Returns the NUMA node all queues in |queue_affinity| are bound to or
+// IREE_MEMORY_NODE_ID_ANY if they span multiple nodes (or none).
+static uint32_t iree_hal_heap_allocator_select_numa_node(
+    iree_hal_heap_allocator_t* allocator,
+    iree_hal_queue_affinity_t queue_affinity) {
+  if (allocator->queue_count == 0) return IREE_MEMORY_NODE_ID_ANY;
+  uint32_t node = IREE_MEMORY_NODE_ID_ANY;
+  bool any_queue_selected = false;
+  for (iree_host_size_t i = 0; i < allocator->queue_count; ++i) {
+    if (!((queue_affinity >> i) & 1)) continue;
+    const uint32_t queue_node = allocator->queue_nodes[i];
+    if (!any_queue_selected) {
+      node = queue_node;
+      any_queue_selected = true;
+    } else if (queue_node != node) {
+      return IREE_MEMORY_NODE_ID_ANY;
+    }
+  }
+  return node;
+}
+
 static iree_status_t iree_hal_heap_allocator_allocate_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
@@ -197,9 +258,11 @@ static iree_status_t iree_hal_heap_allocator_allocate_buffer(
   iree_hal_heap_allocator_statistics_t* statistics = NULL;
   IREE_STATISTICS(statistics = &allocator->statistics);
   iree_hal_buffer_t* buffer = NULL;
+  const uint32_t numa_node = iree_hal_heap_allocator_select_numa_node(
+      allocator, compat_params.queue_affinity);
   IREE_RETURN_IF_ERROR(iree_hal_heap_buffer_create(
-      statistics, &compat_params, allocation_size, allocator->data_allocator,
-      allocator->host_allocator, &buffer));
+      statistics, &compat_params, allocation_size, numa_node,
+      allocator->data_allocator, allocator->host_allocator, &buffer));
 
   *out_buffer = buffer;
   return iree_ok_status();
@@ -0,0 +1,167 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/memory.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Large enough to be bound to a node.
+static constexpr iree_device_size_t kLargeLength = 1024 * 1024;
+// Small enough to never be bound to a node.
+static constexpr iree_device_size_t kSmallLength = 4096;
+
+// Allocator forwarding to the system allocator that counts allocations.
+struct CountingAllocator {
+  int allocation_count = 0;
+
+  static iree_status_t Ctl(void* self, iree_allocator_command_t command,
+                           const void* params, void** inout_ptr) {
+    CountingAllocator* allocator = (CountingAllocator*)self;
+    if (command != IREE_ALLOCATOR_COMMAND_FREE) ++allocator->allocation_count;
+    iree_allocator_t system = iree_allocator_system();
+    return system.ctl(system.self, command, params, inout_ptr);
+  }
+
+  iree_allocator_t allocator() { return {this, Ctl}; }
+};
+
+// Returns true if memory can be placed on |node_id| on this system.
+static bool IsPlacementAvailable(uint32_t node_id) {
+  void* base_address = NULL;
+  iree_status_t status =
+      iree_memory_allocate_on_node(kLargeLength, node_id, &base_address);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return false;
+  }
+  iree_memory_free_on_node(base_address, kLargeLength);
+  return true;
+}
+
+class HeapAllocatorNumaTest : public ::testing::Test {
+ protected:
+  void CreateAllocator(std::vector<uint32_t> queue_nodes) {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap_numa(
+        IREE_SV("heap"), queue_nodes.size(), queue_nodes.data(),
+        data_allocator_.allocator(), iree_allocator_system(), &allocator_));
+  }
+
+  void TearDown() override { iree_hal_allocator_release(allocator_); }
+
+  // Allocates a buffer for |queue_affinity|, checks that it is usable, and
+  // returns the number of allocations made from the data allocator for it.
+  int AllocateAndVerify(iree_hal_queue_affinity_t queue_affinity,
+                        iree_device_size_t length) {
+    const int initial_count = data_allocator_.allocation_count;
+    iree_hal_buffer_params_t params = {};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage =
+        IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING;
+    params.queue_affinity = queue_affinity;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(allocator_, params,
+                                                     length, &buffer));
+    const int allocation_count =
+        data_allocator_.allocation_count - initial_count;
+
+    std::vector<uint8_t> expected(length);
+    for (size_t i = 0; i < expected.size(); ++i) expected[i] = (uint8_t)i;
+    IREE_CHECK_OK(iree_hal_buffer_map_write(buffer, 0, expected.data(),
+                                            expected.size()));
+    std::vector<uint8_t> actual(length);
+    IREE_CHECK_OK(
+        iree_hal_buffer_map_read(buffer, 0, actual.data(), actual.size()));
+    EXPECT_EQ(actual, expected);
+    iree_hal_buffer_release(buffer);
+    return allocation_count;
+  }
+
+  CountingAllocator data_allocator_;
+  iree_hal_allocator_t* allocator_ = NULL;
+};
+
+// Large buffers for queues on a node are mapped on that node instead of being
+// allocated from the data allocator.
+TEST_F(HeapAllocatorNumaTest, BoundBuffer) {
+  if (!IsPlacementAvailable(0)) GTEST_SKIP() << "NUMA placement unavailable";
+  CreateAllocator({0, 0});
+  EXPECT_EQ(AllocateAndVerify(/*queue_affinity=*/0b01, kLargeLength), 0);
+  EXPECT_EQ(AllocateAndVerify(IREE_HAL_QUEUE_AFFINITY_ANY, kLargeLength), 0);
+  EXPECT_EQ(AllocateAndVerify(/*queue_affinity=*/0b11, kLargeLength), 0);
+}
+
+// Small buffers would share pages with other allocations and are never bound.
+TEST_F(HeapAllocatorNumaTest, SmallBufferUnbound) {
+  CreateAllocator({0, 0});
+  EXPECT_EQ(AllocateAndVerify(/*queue_affinity=*/0b01, kSmallLength), 1);
+}
+
+// Buffers that may be used by queues on different nodes are left unbound.
+TEST_F(HeapAllocatorNumaTest, SpanningNodesUnbound) {
+  if (!IsPlacementAvailable(0)) GTEST_SKIP() << "NUMA placement unavailable";
+  CreateAllocator({0, 1});
+  EXPECT_EQ(AllocateAndVerify(/*queue_affinity=*/0b01, kLargeLength), 0);
+  EXPECT_EQ(AllocateAndVerify(/*queue_affinity=*/0b11, kLargeLength), 1);
+}
+
+// Placement failures (such as nodes that do not exist) fall back to the data
+// allocator.
+TEST_F(HeapAllocatorNumaTest, UnavailableNodeFallsBack) {
+  CreateAllocator({1023});
+  EXPECT_EQ(AllocateAndVerify(/*queue_affinity=*/0b01, kLargeLength), 1);
+}
+
+TEST_F(HeapAllocatorNumaTest, NoQueuesBound) {
+  CreateAllocator({IREE_MEMORY_NODE_ID_ANY, IREE_MEMORY_NODE_ID_ANY});
+  EXPECT_EQ(AllocateAndVerify(/*queue_affinity=*/0b01, kLargeLength), 1);
+}
+
+#if IREE_STATISTICS_ENABLE
+
+// Residency is sampled from the live bound buffers when statistics are queried.
+// Storage that has never been touched and freed buffers are not counted.
+TEST_F(HeapAllocatorNumaTest, ResidencyStatistics) {
+  if (!IsPlacementAvailable(0)) GTEST_SKIP() << "NUMA placement unavailable";
+  CreateAllocator({0});
+  iree_hal_buffer_params_t params = {};
+  params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING;
+  params.queue_affinity = 0b01;
+  iree_hal_buffer_t* touched_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      allocator_, params, kLargeLength, &touched_buffer));
+  iree_hal_buffer_t* untouched_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      allocator_, params, kLargeLength, &untouched_buffer));
+  IREE_ASSERT_OK(
+      iree_hal_buffer_map_fill(touched_buffer, 0, kLargeLength, "\x01", 1));
+
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator_, &statistics);
+  if (statistics.numa_local_bytes + statistics.numa_remote_bytes == 0) {
+    iree_hal_buffer_release(touched_buffer);
+    iree_hal_buffer_release(untouched_buffer);
+    GTEST_SKIP() << "NUMA residency query unavailable";
+  }
+  EXPECT_EQ(statistics.numa_local_bytes + statistics.numa_remote_bytes,
+            kLargeLength);
+
+  iree_hal_buffer_release(touched_buffer);
+  iree_hal_allocator_query_statistics(allocator_, &statistics);
+  EXPECT_EQ(statistics.numa_local_bytes, 0);
+  EXPECT_EQ(statistics.numa_remote_bytes, 0);
+  iree_hal_buffer_release(untouched_buffer);
+}
+
+#endif  // IREE_STATISTICS_ENABLE
+
+}  // namespace
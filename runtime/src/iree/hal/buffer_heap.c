@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/memory.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer.h"
 #include "iree/hal/buffer_heap_impl.h"
@@ -28,8 +29,17 @@ typedef enum iree_hal_heap_buffer_storage_mode_e {
   // A user-provided buffer release callback is notified that the buffer is no
   // longer referencing the data.
   IREE_HAL_HEAP_BUFFER_STORAGE_MODE_EXTERNAL = 2u,
+  // Allocated as split [metadata] and [data] mapped on a NUMA node.
+  // The base metadata pointer must be freed with iree_allocator_free.
+  // The data storage must be freed with iree_memory_free_on_node.
+  IREE_HAL_HEAP_BUFFER_STORAGE_MODE_NODE = 3u,
 } iree_hal_heap_buffer_storage_mode_t;
 
+// Minimum allocation size bound to a NUMA node. Smaller allocations are left to
+// the data allocator as mapping whole pages for them would waste memory and
+// the cost of the mapping would not be amortized.
+#define IREE_HAL_HEAP_BUFFER_NODE_MIN_SIZE (64 * 1024)
+
 typedef struct iree_hal_heap_buffer_t {
   // base.flags has the iree_hal_heap_buffer_storage_mode_t.
   iree_hal_buffer_t base;
@@ -51,6 +61,12 @@ typedef struct iree_hal_heap_buffer_t {
 
   // Optional statistics shared with the allocator.
   IREE_STATISTICS(iree_hal_heap_allocator_statistics_t* statistics;)
+
+  // NUMA node the storage is bound to and the links in the statistics list of
+  // node-bound buffers. Only used for IREE_HAL_HEAP_BUFFER_STORAGE_MODE_NODE.
+  IREE_STATISTICS(uint32_t numa_node;)
+  IREE_STATISTICS(struct iree_hal_heap_buffer_t* node_buffer_prev;)
+  IREE_STATISTICS(struct iree_hal_heap_buffer_t* node_buffer_next;)
 } iree_hal_heap_buffer_t;
 
 static const iree_hal_buffer_vtable_t iree_hal_heap_buffer_vtable;
@@ -83,6 +99,29 @@ static iree_status_t iree_hal_heap_buffer_allocate_split(
   return status;
 }
 
+// Allocates a buffer with the metadata split from storage mapped with a
+// placement policy preferring |numa_node|. Fails if placement is unavailable
+// so that the caller can fall back to the data allocator.
+static iree_status_t iree_hal_heap_buffer_allocate_node(
+    iree_device_size_t allocation_size, uint32_t numa_node,
+    iree_allocator_t host_allocator, iree_hal_heap_buffer_t** out_buffer,
+    iree_byte_span_t* out_data) {
+  // Mappings are page aligned and always meet the minimum buffer alignment.
+  void* data_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_memory_allocate_on_node(
+      (iree_host_size_t)allocation_size, numa_node, &data_ptr));
+  *out_data = iree_make_byte_span(data_ptr, allocation_size);
+
+  // Allocate the host metadata wrapper with natural alignment.
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(**out_buffer), (void**)out_buffer);
+  if (!iree_status_is_ok(status)) {
+    // Need to free the storage we just allocated.
+    iree_memory_free_on_node(data_ptr, (iree_host_size_t)allocation_size);
+  }
+  return status;
+}
+
 // Allocates a buffer with the metadata as a prefix to the storage.
 // This results in a single allocation per buffer but requires that both the
 // metadata and storage live together.
@@ -117,8 +156,8 @@ static iree_status_t iree_hal_heap_buffer_allocate_slab(
 iree_status_t iree_hal_heap_buffer_create(
     iree_hal_heap_allocator_statistics_t* statistics,
     const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
-    iree_allocator_t data_allocator, iree_allocator_t host_allocator,
-    iree_hal_buffer_t** out_buffer) {
+    uint32_t numa_node, iree_allocator_t data_allocator,
+    iree_allocator_t host_allocator, iree_hal_buffer_t** out_buffer) {
   IREE_ASSERT_ARGUMENT(params);
   IREE_ASSERT_ARGUMENT(out_buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -131,12 +170,32 @@ iree_status_t iree_hal_heap_buffer_create(
 
   iree_hal_heap_buffer_t* buffer = NULL;
   iree_byte_span_t data = iree_make_byte_span(NULL, 0);
-  iree_status_t status =
-      same_allocator
-          ? iree_hal_heap_buffer_allocate_slab(allocation_size, host_allocator,
-                                               &buffer, &data)
-          : iree_hal_heap_buffer_allocate_split(allocation_size, data_allocator,
+  iree_hal_heap_buffer_storage_mode_t storage_mode =
+      same_allocator ? IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SLAB
+                     : IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT;
+
+  // Storage bound to a node is mapped directly so that the placement policy
+  // only applies to pages owned by the buffer. Placement is an optimization and
+  // if it is unavailable the storage comes from the data allocator instead.
+  iree_status_t status = iree_ok_status();
+  if (numa_node != IREE_MEMORY_NODE_ID_ANY &&
+      allocation_size >= IREE_HAL_HEAP_BUFFER_NODE_MIN_SIZE) {
+    status = iree_hal_heap_buffer_allocate_node(
+        allocation_size, numa_node, host_allocator, &buffer, &data);
+    if (iree_status_is_ok(status)) {
+      storage_mode = IREE_HAL_HEAP_BUFFER_STORAGE_MODE_NODE;
+    } else {
+      status = iree_status_ignore(status);
+    }
+  }
+
+  if (storage_mode == IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SLAB) {
+    status = iree_hal_heap_buffer_allocate_slab(allocation_size,
                                                 host_allocator, &buffer, &data);
+  } else if (storage_mode == IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT) {
+    status = iree_hal_heap_buffer_allocate_split(
+        allocation_size, data_allocator, host_allocator, &buffer, &data);
+  }
 
   if (iree_status_is_ok(status)) {
     iree_hal_buffer_initialize(
@@ -145,13 +204,11 @@ iree_status_t iree_hal_heap_buffer_create(
         &iree_hal_heap_buffer_vtable, &buffer->base);
     buffer->host_allocator = host_allocator;
     buffer->data = data;
-
-    if (same_allocator) {
-      buffer->base.flags = IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SLAB;
-      buffer->data_allocator = iree_allocator_null();
-    } else {
-      buffer->base.flags = IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT;
+    buffer->base.flags = storage_mode;
+    if (storage_mode == IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT) {
       buffer->data_allocator = data_allocator;
+    } else {
+      buffer->data_allocator = iree_allocator_null();
     }
 
     IREE_STATISTICS({
@@ -160,6 +217,17 @@ iree_status_t iree_hal_heap_buffer_create(
         iree_slim_mutex_lock(&statistics->mutex);
         iree_hal_allocator_statistics_record_alloc(
             &statistics->base, params->type, allocation_size);
+        buffer->numa_node = IREE_MEMORY_NODE_ID_ANY;
+        buffer->node_buffer_prev = NULL;
+        buffer->node_buffer_next = NULL;
+        if (storage_mode == IREE_HAL_HEAP_BUFFER_STORAGE_MODE_NODE) {
+          buffer->numa_node = numa_node;
+          buffer->node_buffer_next = statistics->node_buffer_head;
+          if (statistics->node_buffer_head) {
+            statistics->node_buffer_head->node_buffer_prev = buffer;
+          }
+          statistics->node_buffer_head = buffer;
+        }
         iree_slim_mutex_unlock(&statistics->mutex);
       }
     });
@@ -212,6 +280,39 @@ iree_status_t iree_hal_heap_buffer_wrap(
   return status;
 }
 
+#if IREE_STATISTICS_ENABLE
+
+void iree_hal_heap_allocator_statistics_query_numa_residency(
+    iree_hal_heap_allocator_statistics_t* statistics,
+    iree_device_size_t* out_local_bytes, iree_device_size_t* out_remote_bytes) {
+  *out_local_bytes = 0;
+  *out_remote_bytes = 0;
+  for (iree_hal_heap_buffer_t* buffer = statistics->node_buffer_head; buffer;
+       buffer = buffer->node_buffer_next) {
+    iree_host_size_t local_page_count = 0;
+    iree_host_size_t resident_page_count = 0;
+    iree_status_t status = iree_memory_query_node_residency(
+        buffer->data.data, (iree_host_size_t)buffer->data.data_length,
+        buffer->numa_node, &local_page_count, &resident_page_count);
+    if (!iree_status_is_ok(status)) {
+      // Reporting is best-effort and if the query is unavailable for one
+      // buffer it is unavailable for all of them.
+      iree_status_ignore(status);
+      break;
+    }
+    if (resident_page_count == 0) continue;
+    // Scale the sampled residency to the size of the storage.
+    const iree_device_size_t local_bytes =
+        (iree_device_size_t)((double)local_page_count /
+                             (double)resident_page_count *
+                             (double)buffer->data.data_length);
+    *out_local_bytes += local_bytes;
+    *out_remote_bytes += buffer->data.data_length - local_bytes;
+  }
+}
+
+#endif  // IREE_STATISTICS_ENABLE
+
 static void iree_hal_heap_buffer_destroy(iree_hal_buffer_t* base_buffer) {
   iree_hal_heap_buffer_t* buffer = (iree_hal_heap_buffer_t*)base_buffer;
   iree_allocator_t host_allocator = buffer->host_allocator;
@@ -223,6 +324,16 @@ static void iree_hal_heap_buffer_destroy(iree_hal_buffer_t* base_buffer) {
       iree_hal_allocator_statistics_record_free(&buffer->statistics->base,
                                                 base_buffer->memory_type,
                                                 base_buffer->allocation_size);
+      if (buffer->base.flags == IREE_HAL_HEAP_BUFFER_STORAGE_MODE_NODE) {
+        if (buffer->node_buffer_prev) {
+          buffer->node_buffer_prev->node_buffer_next = buffer->node_buffer_next;
+        } else {
+          buffer->statistics->node_buffer_head = buffer->node_buffer_next;
+        }
+        if (buffer->node_buffer_next) {
+          buffer->node_buffer_next->node_buffer_prev = buffer->node_buffer_prev;
+        }
+      }
       iree_slim_mutex_unlock(&buffer->statistics->mutex);
     }
   });
@@ -233,7 +344,13 @@ static void iree_hal_heap_buffer_destroy(iree_hal_buffer_t* base_buffer) {
       break;
     }
     case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT: {
-      iree_allocator_free(buffer->data_allocator, buffer->data.data);
+      iree_allocator_free_aligned(buffer->data_allocator, buffer->data.data);
+      iree_allocator_free(host_allocator, buffer);
+      break;
+    }
+    case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_NODE: {
+      iree_memory_free_on_node(buffer->data.data,
+                               (iree_host_size_t)buffer->data.data_length);
       iree_allocator_free(host_allocator, buffer);
       break;
     }
@@ -20,21 +20,41 @@ extern "C" {
 //===----------------------------------------------------------------------===//
 
 // Shared heap allocator statistics; owned by a heap allocator.
-// Access to the base statistics must be guarded by |mutex|.
+// Access to the base statistics and the node buffer list must be guarded by
+// |mutex|.
 typedef struct iree_hal_heap_allocator_statistics_t {
   iree_slim_mutex_t mutex;
   iree_hal_allocator_statistics_t base;
+  // Live buffers with storage bound to a NUMA node. Their residency is only
+  // sampled when statistics are queried.
+  struct iree_hal_heap_buffer_t* node_buffer_head;
 } iree_hal_heap_allocator_statistics_t;
 
+#if IREE_STATISTICS_ENABLE
+
+// Samples which NUMA nodes the storage of all live node-bound buffers in
+// |statistics| is resident on and stores the estimated bytes resident on the
+// node each buffer was bound to in |out_local_bytes| and on other nodes in
+// |out_remote_bytes|. Storage that has never been touched is not counted.
+// Must be called with the statistics |mutex| held.
+void iree_hal_heap_allocator_statistics_query_numa_residency(
+    iree_hal_heap_allocator_statistics_t* statistics,
+    iree_device_size_t* out_local_bytes, iree_device_size_t* out_remote_bytes);
+
+#endif  // IREE_STATISTICS_ENABLE
+
 // Allocates a new heap buffer from the specified |data_allocator|.
 // |host_allocator| is used for the iree_hal_buffer_t metadata. If both
 // |data_allocator| and |host_allocator| are the same the buffer will be created
-// as a flat slab. |out_buffer| must be released by the caller.
+// as a flat slab. If |numa_node| is not IREE_MEMORY_NODE_ID_ANY large
+// allocations are mapped directly with a placement policy preferring the node
+// instead of using |data_allocator|. |out_buffer| must be released by the
+// caller.
 iree_status_t iree_hal_heap_buffer_create(
     iree_hal_heap_allocator_statistics_t* statistics,
     const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
-    iree_allocator_t data_allocator, iree_allocator_t host_allocator,
-    iree_hal_buffer_t** out_buffer);
+    uint32_t numa_node, iree_allocator_t data_allocator,
+    iree_allocator_t host_allocator, iree_hal_buffer_t** out_buffer);
 
 #ifdef __cplusplus
 }  // extern "C"
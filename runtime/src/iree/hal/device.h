@@ -236,6 +236,15 @@ static inline iree_hal_host_call_t iree_hal_make_host_call(
 typedef uint64_t iree_hal_execute_flags_t;
 enum iree_hal_execute_flag_bits_t {
   IREE_HAL_EXECUTE_FLAG_NONE = 0,
+  // Hints that the execution is latency-sensitive and should be scheduled
+  // ahead of normal priority work submitted to the same device. Devices that
+  // support preemption may suspend lower priority work in order to make
+  // progress. Ignored by devices that do not support prioritization.
+  IREE_HAL_EXECUTE_FLAG_PRIORITY_HIGH = 1ull << 0,
+  // Hints that the execution is throughput-oriented background work that may
+  // be deferred or preempted in favor of normal and high priority work.
+  // Ignored by devices that do not support prioritization.
+  IREE_HAL_EXECUTE_FLAG_PRIORITY_LOW = 1ull << 1,
 };
 
 // Defines how a multi-wait operation treats the results of multiple semaphores.
@@ -11,6 +11,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/memory.h"
 #include "iree/hal/drivers/local_task/task_driver.h"
 #include "iree/hal/local/loaders/registration/init.h"
 #include "iree/hal/local/plugins/registration/init.h"
@@ -20,6 +21,38 @@ IREE_FLAG(
     bool, task_abort_on_failure, false,
     "Aborts the program on the first failure within a task system queue.");
 
+IREE_FLAG(
+    bool, task_hazard_tracking, false,
+    "Tracks buffer ranges accessed by commands so that command buffer\n"
+    "barriers only order commands with overlapping reads/writes. When\n"
+    "disabled every barrier is a full join of all prior commands.");
+
+IREE_FLAG(
+    int32_t, task_file_transfer_threads, 1,
+    "Number of host threads used to stage large file reads and writes.\n"
+    "Values >1 split each transfer into chunks that are read/written by\n"
+    "multiple threads concurrently with the queue copies.");
+
+IREE_FLAG(
+    bool, task_file_io_uring, false,
+    "Reads and writes imported files with io_uring when supported by the\n"
+    "kernel, keeping many requests in flight. Falls back to pread/pwrite\n"
+    "if io_uring is unavailable or restricted for the process.");
+
+IREE_FLAG(
+    bool, task_numa_placement, false,
+    "Binds the memory of buffers allocated for a queue to the NUMA node of\n"
+    "the executor servicing the queue and routes operations that may run on\n"
+    "any of several queues to the queue on the caller's node. Only has an\n"
+    "effect on systems with multiple NUMA nodes when executors are pinned to\n"
+    "nodes (such as with --task_topology_mode=numa).");
+
+IREE_FLAG(
+    bool, task_replay_command_buffers, false,
+    "Builds the task graph of reusable command buffers once and replays it\n"
+    "on each submission with the new binding table. When disabled the\n"
+    "commands are recorded into a new task graph on every submission.");
+
 static iree_status_t iree_hal_local_task_driver_factory_enumerate(
     void* self, iree_host_size_t* out_driver_info_count,
     const iree_hal_driver_info_t** out_driver_infos) {
@@ -49,6 +82,15 @@ static iree_status_t iree_hal_local_task_driver_factory_try_create(
   if (FLAG_task_abort_on_failure) {
     default_params.queue_scope_flags |= IREE_TASK_SCOPE_FLAG_ABORT_ON_FAILURE;
   }
+  default_params.barrier_mode = FLAG_task_hazard_tracking
+                                    ? IREE_HAL_TASK_BARRIER_MODE_HAZARD_TRACKING
+                                    : IREE_HAL_TASK_BARRIER_MODE_GLOBAL;
+  default_params.file_transfer_thread_count =
+      (iree_host_size_t)iree_max(1, FLAG_task_file_transfer_threads);
+  default_params.file_io_uring = FLAG_task_file_io_uring;
+  default_params.numa_queue_routing = FLAG_task_numa_placement;
+  default_params.numa_buffer_placement = FLAG_task_numa_placement;
+  default_params.replay_command_buffers = FLAG_task_replay_command_buffers;
 
   // Create executors for each topology specified by flags.
   // Stack allocated storage today but we can query for the total count and
@@ -73,12 +115,30 @@ static iree_status_t iree_hal_local_task_driver_factory_try_create(
         host_allocator);
   }
 
+  // Each executor services one queue and buffers allocated for that queue are
+  // placed on the NUMA node the executor workers are pinned to. The device
+  // selects queue `queue_affinity % executor_count` so each affinity bit maps
+  // to the node of the queue selected when only that bit is set.
+  uint32_t queue_nodes[IREE_HAL_MAX_QUEUES];
+  iree_host_size_t queue_node_count = 0;
+  if (iree_status_is_ok(status) && FLAG_task_numa_placement &&
+      iree_memory_query_node_count() > 1) {
+    uint32_t executor_nodes[IREE_ARRAYSIZE(executor_storage)];
+    for (iree_host_size_t i = 0; i < executor_count; ++i) {
+      executor_nodes[i] = iree_task_executor_query_memory_node(executors[i]);
+    }
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(queue_nodes); ++i) {
+      queue_nodes[i] = executor_nodes[(1ull << i) % executor_count];
+    }
+    queue_node_count = IREE_ARRAYSIZE(queue_nodes);
+  }
+
   // TODO(benvanik): allow this to be injected to share across drivers.
   iree_hal_allocator_t* device_allocator = NULL;
   if (iree_status_is_ok(status)) {
-    status = iree_hal_allocator_create_heap(iree_make_cstring_view("local"),
-                                            host_allocator, host_allocator,
-                                            &device_allocator);
+    status = iree_hal_allocator_create_heap_numa(
+        iree_make_cstring_view("local"), queue_node_count, queue_nodes,
+        host_allocator, host_allocator, &device_allocator);
   }
 
   // Create a task driver that will use the given executors for scheduling work
@@ -15,12 +15,127 @@
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_executable.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/resource_set.h"
 #include "iree/task/affinity_set.h"
 #include "iree/task/list.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 
+//===----------------------------------------------------------------------===//
+// Hazard tracking
+//===----------------------------------------------------------------------===//
+
+// Maximum number of live buffer accesses tracked in
+// IREE_HAL_TASK_BARRIER_MODE_HAZARD_TRACKING mode before a barrier is lowered
+// into a full fence. This bounds the cost of recording each command as every
+// new access is checked against all live ones.
+#define IREE_HAL_TASK_CMD_MAX_TRACKED_ACCESSES 512
+
+typedef struct iree_hal_task_cmd_node_t iree_hal_task_cmd_node_t;
+
+// A dependency edge from one command node to another.
+typedef struct iree_hal_task_cmd_edge_t {
+  struct iree_hal_task_cmd_edge_t* next;
+  iree_hal_task_cmd_node_t* target;
+} iree_hal_task_cmd_edge_t;
+
+// A command task in the DAG being built when hazard tracking.
+// Edges are accumulated during recording and lowered into task completion
+// dependencies (with a fan-out barrier when there are multiple successors) when
+// recording ends as we can't know the successors of a task until then.
+struct iree_hal_task_cmd_node_t {
+  // Next node in recording order.
+  iree_hal_task_cmd_node_t* next;
+  // Task executing the command.
+  iree_task_t* task;
+  // Barrier epoch in which the command was recorded. Commands in the same
+  // epoch may execute concurrently.
+  uint32_t epoch;
+  // Total number of nodes that must complete before this one may execute.
+  uint32_t predecessor_count;
+  // Total number of nodes in |successors|.
+  uint32_t successor_count;
+  // Nodes that must wait for this one to complete.
+  iree_hal_task_cmd_edge_t* successors;
+  // The last node added to |successors|, used to avoid duplicate edges when a
+  // command has multiple hazards with this one.
+  iree_hal_task_cmd_node_t* last_successor;
+};
+
+// A byte range of an allocated buffer accessed by a command.
+typedef struct iree_hal_task_cmd_access_t {
+  struct iree_hal_task_cmd_access_t* next;
+  // Allocated buffer (not the subspan) so that aliasing subspans are detected.
+  iree_hal_buffer_t* buffer;
+  // Byte range [begin, end) within the allocated buffer.
+  iree_device_size_t begin;
+  iree_device_size_t end;
+  // True if the command may write to the range.
+  bool is_write;
+  // Node performing the access.
+  iree_hal_task_cmd_node_t* node;
+} iree_hal_task_cmd_access_t;
+
+//===----------------------------------------------------------------------===//
+// Replay
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_task_command_buffer_t iree_hal_task_command_buffer_t;
+
+// A task in the graph of a reusable command buffer and the dependency state it
+// had when recording ended. Retiring a task consumes its dependency edges and
+// they are restored from this each time the graph is replayed.
+typedef struct iree_hal_task_cmd_replay_task_t {
+  struct iree_hal_task_cmd_replay_task_t* next;
+  iree_task_t* task;
+  iree_task_t* completion_task;
+  int32_t pending_dependency_count;
+} iree_hal_task_cmd_replay_task_t;
+
+// Updates |cmd| with buffer references resolved against the binding table
+// provided when the command buffer is issued. |refs| has the same order as the
+// references passed to iree_hal_task_command_buffer_append_fixup.
+typedef iree_status_t (*iree_hal_task_cmd_fixup_fn_t)(
+    void* cmd, iree_host_size_t ref_count, const iree_hal_buffer_ref_t* refs);
+
+// A buffer reference as recorded and the usage and access the command
+// requires of the buffer it resolves to.
+typedef struct iree_hal_task_cmd_fixup_ref_t {
+  iree_hal_buffer_ref_t ref;
+  iree_hal_buffer_usage_t usage;
+  iree_hal_memory_access_t access;
+} iree_hal_task_cmd_fixup_ref_t;
+
+static inline iree_hal_task_cmd_fixup_ref_t iree_hal_task_cmd_make_fixup_ref(
+    iree_hal_buffer_ref_t ref, iree_hal_buffer_usage_t usage,
+    iree_hal_memory_access_t access) {
+  iree_hal_task_cmd_fixup_ref_t fixup_ref = {
+      .ref = ref,
+      .usage = usage,
+      .access = access,
+  };
+  return fixup_ref;
+}
+
+// Buffer references of a command that must be resolved each time the command
+// buffer is issued, either because they are indirect into the binding table or
+// because issuing the command consumes state derived from them.
+typedef struct iree_hal_task_cmd_fixup_t {
+  struct iree_hal_task_cmd_fixup_t* next;
+  iree_hal_task_cmd_fixup_fn_t fn;
+  void* cmd;
+  iree_host_size_t ref_count;
+  iree_hal_task_cmd_fixup_ref_t refs[];
+} iree_hal_task_cmd_fixup_t;
+
+// Barrier that all leaf tasks of a reusable command buffer complete into.
+// Its cleanup marks the graph as no longer in-flight.
+typedef struct iree_hal_task_cmd_tail_t {
+  iree_task_barrier_t task;
+  iree_hal_task_command_buffer_t* command_buffer;
+} iree_hal_task_cmd_tail_t;
+
 //===----------------------------------------------------------------------===//
 // iree_hal_task_command_buffer_t
 //===----------------------------------------------------------------------===//
@@ -33,12 +148,21 @@
 // additional allocations required during recording or execution. That means our
 // command buffer here is essentially just a builder for the task system types
 // and manager of the lifetime of the tasks.
-typedef struct iree_hal_task_command_buffer_t {
+//
+// Reusable command buffers build the task DAG once and replay it on each
+// submission by resetting the tasks in-place and resolving binding table
+// references. As the tasks can only be in-flight once a deferred copy of the
+// commands is also recorded and used to build a transient DAG when the
+// command buffer is submitted again before a prior replay has completed.
+struct iree_hal_task_command_buffer_t {
   iree_hal_command_buffer_t base;
   iree_allocator_t host_allocator;
 
   iree_task_scope_t* scope;
 
+  // Controls how barriers are lowered into the task DAG.
+  iree_hal_task_barrier_mode_t barrier_mode;
+
   // Arena used for all allocations; references the shared device block pool.
   iree_arena_allocator_t arena;
 
@@ -76,8 +200,46 @@ typedef struct iree_hal_task_command_buffer_t {
 
     // All execution tasks emitted that must execute after |open_barrier|.
     iree_task_list_t open_tasks;
+
+    // Hazard tracking state used in IREE_HAL_TASK_BARRIER_MODE_HAZARD_TRACKING
+    // mode only. The fields above are unused in that mode.
+    struct {
+      // Barrier epoch assigned to newly recorded commands.
+      uint32_t epoch;
+      // All nodes recorded in recording order.
+      iree_hal_task_cmd_node_t* node_head;
+      iree_hal_task_cmd_node_t* node_tail;
+      // Total number of edges between all nodes.
+      iree_host_size_t edge_count;
+      // Optional fence node that all subsequently recorded nodes depend on.
+      iree_hal_task_cmd_node_t* fence_node;
+      // Accesses of the next command to be emitted.
+      iree_hal_task_cmd_access_t* pending_accesses;
+      // Accesses that subsequently recorded commands may have hazards with.
+      iree_hal_task_cmd_access_t* live_accesses;
+      iree_host_size_t live_access_count;
+      // Accesses that are no longer live and can be reused.
+      iree_hal_task_cmd_access_t* free_accesses;
+    } hazards;
   } state;
-} iree_hal_task_command_buffer_t;
+
+  // Commands with buffer references resolved when issued.
+  iree_hal_task_cmd_fixup_t* fixup_head;
+  iree_hal_task_cmd_fixup_t* fixup_tail;
+
+  // State used to replay the task DAG of reusable command buffers only.
+  struct {
+    // Deferred recording of all commands used when the DAG is in-flight.
+    iree_hal_command_buffer_t* deferred;
+    // All tasks in the DAG in recording order.
+    iree_hal_task_cmd_replay_task_t* task_head;
+    iree_hal_task_cmd_replay_task_t* task_tail;
+    // Barrier joining all leaf tasks or NULL if the DAG is empty.
+    iree_hal_task_cmd_tail_t* tail;
+    // Non-zero while the DAG is submitted and has not yet completed.
+    iree_atomic_int32_t in_flight;
+  } replay;
+};
 
 static const iree_hal_command_buffer_vtable_t
     iree_hal_task_command_buffer_vtable;
@@ -90,6 +252,7 @@ static iree_hal_task_command_buffer_t* iree_hal_task_command_buffer_cast(
 
 iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_allocator_t* device_allocator, iree_task_scope_t* scope,
+    iree_hal_task_barrier_mode_t barrier_mode,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
@@ -98,27 +261,14 @@ iree_status_t iree_hal_task_command_buffer_create(
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
-    // If we want reuse we'd need to support duplicating the task DAG after
-    // recording or have some kind of copy-on-submit behavior that does so if
-    // a command buffer is submitted for execution twice. Allowing for the same
-    // command buffer to be enqueued multiple times would be fine so long as
-    // execution doesn't overlap (`cmdbuf|cmdbuf` vs
-    // `cmdbuf -> semaphore -> cmdbuf`) though we'd still need to be careful
-    // that we did the enqueuing and reset of the task structures at the right
-    // times. Definitely something that'll be useful in the future... but not
-    // today :)
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "only one-shot command buffer usage is supported");
-  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Hazards can only be tracked between buffers known at recording time. The
+  // buffers in the binding table may alias each other in ways we can't see.
   if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
+    barrier_mode = IREE_HAL_TASK_BARRIER_MODE_GLOBAL;
   }
 
-  IREE_TRACE_ZONE_BEGIN(z0);
-
   iree_hal_task_command_buffer_t* command_buffer = NULL;
   iree_status_t status = iree_allocator_malloc(
       host_allocator,
@@ -132,15 +282,26 @@ iree_status_t iree_hal_task_command_buffer_create(
         &iree_hal_task_command_buffer_vtable, &command_buffer->base);
     command_buffer->host_allocator = host_allocator;
     command_buffer->scope = scope;
+    command_buffer->barrier_mode = barrier_mode;
     iree_arena_initialize(block_pool, &command_buffer->arena);
     iree_task_list_initialize(&command_buffer->root_tasks);
     iree_task_list_initialize(&command_buffer->leaf_tasks);
     memset(&command_buffer->state, 0, sizeof(command_buffer->state));
+    command_buffer->fixup_head = NULL;
+    command_buffer->fixup_tail = NULL;
+    memset(&command_buffer->replay, 0, sizeof(command_buffer->replay));
     if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_UNRETAINED)) {
       status = iree_hal_resource_set_allocate(block_pool,
                                               &command_buffer->resource_set);
     }
   }
+  if (iree_status_is_ok(status) &&
+      !iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    status = iree_hal_deferred_command_buffer_create(
+        device_allocator, mode, command_categories, queue_affinity,
+        binding_capacity, block_pool, host_allocator,
+        &command_buffer->replay.deferred);
+  }
   if (iree_status_is_ok(status)) {
     *out_command_buffer = &command_buffer->base;
   } else {
@@ -163,6 +324,7 @@ static void iree_hal_task_command_buffer_destroy(
   iree_task_list_discard(&command_buffer->leaf_tasks);
   iree_arena_deinitialize(&command_buffer->arena);
   iree_hal_resource_set_free(command_buffer->resource_set);
+  iree_hal_command_buffer_release(command_buffer->replay.deferred);
   iree_allocator_free(host_allocator, command_buffer);
 
   IREE_TRACE_ZONE_END(z0);
@@ -174,21 +336,35 @@ bool iree_hal_task_command_buffer_isa(
                               &iree_hal_task_command_buffer_vtable);
 }
 
+static bool iree_hal_task_command_buffer_is_reusable(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  return command_buffer->replay.deferred != NULL;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_task_command_buffer_t recording
 //===----------------------------------------------------------------------===//
 
 static iree_status_t iree_hal_task_command_buffer_flush_tasks(
     iree_hal_task_command_buffer_t* command_buffer);
+static iree_status_t iree_hal_task_command_buffer_flush_hazards(
+    iree_hal_task_command_buffer_t* command_buffer);
+static iree_status_t iree_hal_task_command_buffer_finalize_replay(
+    iree_hal_task_command_buffer_t* command_buffer);
 
 static iree_status_t iree_hal_task_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
-  if (!iree_task_list_is_empty(&command_buffer->root_tasks)) {
+  if (!iree_task_list_is_empty(&command_buffer->root_tasks) ||
+      command_buffer->replay.task_head) {
     return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                             "command buffer cannot be re-recorded");
   }
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_command_buffer_begin(command_buffer->replay.deferred));
+  }
   return iree_ok_status();
 }
 
@@ -197,9 +373,15 @@ static iree_status_t iree_hal_task_command_buffer_end(
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
 
-  // Flush any open barriers.
-  IREE_RETURN_IF_ERROR(
-      iree_hal_task_command_buffer_flush_tasks(command_buffer));
+  // Flush any open barriers or the DAG built while tracking hazards.
+  if (command_buffer->barrier_mode ==
+      IREE_HAL_TASK_BARRIER_MODE_HAZARD_TRACKING) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_task_command_buffer_flush_hazards(command_buffer));
+  } else {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_task_command_buffer_flush_tasks(command_buffer));
+  }
 
   // Move the tasks from the leaf list (tail) to the root list (head) if this
   // was the first set of tasks recorded.
@@ -209,11 +391,197 @@ static iree_status_t iree_hal_task_command_buffer_end(
                         &command_buffer->root_tasks);
   }
 
+  if (iree_hal_task_command_buffer_is_reusable(command_buffer)) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_task_command_buffer_finalize_replay(command_buffer));
+    IREE_RETURN_IF_ERROR(
+        iree_hal_command_buffer_end(command_buffer->replay.deferred));
+  }
+
   iree_hal_resource_set_freeze(command_buffer->resource_set);
 
   return iree_ok_status();
 }
 
+// Tracks |task| so that it can be reset each time the DAG of a reusable command
+// buffer is replayed. Must be called for every task allocated as part of the
+// DAG. No-op for one-shot command buffers.
+static iree_status_t iree_hal_task_command_buffer_track_task(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
+  if (!iree_hal_task_command_buffer_is_reusable(command_buffer)) {
+    return iree_ok_status();
+  }
+  iree_hal_task_cmd_replay_task_t* replay_task = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, sizeof(*replay_task), (void**)&replay_task));
+  memset(replay_task, 0, sizeof(*replay_task));
+  replay_task->task = task;
+  if (command_buffer->replay.task_tail) {
+    command_buffer->replay.task_tail->next = replay_task;
+  } else {
+    command_buffer->replay.task_head = replay_task;
+  }
+  command_buffer->replay.task_tail = replay_task;
+  return iree_ok_status();
+}
+
+// Called when the tail barrier of a replayed DAG retires (or is discarded).
+// All other tasks in the DAG have retired and it may be replayed again.
+static void iree_hal_task_cmd_tail_cleanup(iree_task_t* task,
+                                           iree_status_code_t status_code) {
+  iree_hal_task_cmd_tail_t* tail = (iree_hal_task_cmd_tail_t*)task;
+  iree_atomic_store(&tail->command_buffer->replay.in_flight, 0,
+                    iree_memory_order_release);
+}
+
+// Joins the leaves of the DAG of a reusable command buffer on a tail barrier
+// and captures the dependency state of all tasks for resetting them on replay.
+static iree_status_t iree_hal_task_command_buffer_finalize_replay(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  iree_task_list_t* leaf_tasks =
+      iree_task_list_is_empty(&command_buffer->leaf_tasks)
+          ? &command_buffer->root_tasks
+          : &command_buffer->leaf_tasks;
+  if (iree_task_list_is_empty(leaf_tasks)) return iree_ok_status();
+
+  iree_hal_task_cmd_tail_t* tail = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*tail), (void**)&tail));
+  iree_task_barrier_initialize_empty(command_buffer->scope, &tail->task);
+  iree_task_set_cleanup_fn(&tail->task.header, iree_hal_task_cmd_tail_cleanup);
+  tail->command_buffer = command_buffer;
+  for (iree_task_t* task = iree_task_list_front(leaf_tasks); task != NULL;
+       task = task->next_task) {
+    iree_task_set_completion_task(task, &tail->task.header);
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_task(
+      command_buffer, &tail->task.header));
+  command_buffer->replay.tail = tail;
+
+  for (iree_hal_task_cmd_replay_task_t* replay_task =
+           command_buffer->replay.task_head;
+       replay_task != NULL; replay_task = replay_task->next) {
+    replay_task->completion_task = replay_task->task->completion_task;
+    replay_task->pending_dependency_count =
+        iree_atomic_load(&replay_task->task->pending_dependency_count,
+                         iree_memory_order_relaxed);
+  }
+
+  // The task lists are rebuilt from the captured state on each replay as the
+  // intrusive list pointers are reused by the executor.
+  iree_task_list_initialize(&command_buffer->root_tasks);
+  iree_task_list_initialize(&command_buffer->leaf_tasks);
+  return iree_ok_status();
+}
+
+// Appends a fixup that calls |fn| with |ref_count| buffer references resolved
+// against the binding table each time the command buffer is issued. The
+// references as recorded and the usage and access the command requires of them
+// must be stored into |out_refs| by the caller.
+static iree_status_t iree_hal_task_command_buffer_append_fixup(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_task_cmd_fixup_fn_t fn, void* cmd, iree_host_size_t ref_count,
+    iree_hal_task_cmd_fixup_ref_t** out_refs) {
+  iree_hal_task_cmd_fixup_t* fixup = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena,
+      sizeof(*fixup) + ref_count * sizeof(fixup->refs[0]), (void**)&fixup));
+  fixup->next = NULL;
+  fixup->fn = fn;
+  fixup->cmd = cmd;
+  fixup->ref_count = ref_count;
+  if (command_buffer->fixup_tail) {
+    command_buffer->fixup_tail->next = fixup;
+  } else {
+    command_buffer->fixup_head = fixup;
+  }
+  command_buffer->fixup_tail = fixup;
+  *out_refs = fixup->refs;
+  return iree_ok_status();
+}
+
+// Resolves |fixup_ref| against |binding_table| into |out_resolved_ref|.
+// Indirect references are validated as they would be had the command been
+// recorded with the bound buffer: the buffer must allow the usage and access of
+// the command and the resolved range must be within both the binding and the
+// buffer. Direct references were validated when recorded.
+static iree_status_t iree_hal_task_cmd_resolve_fixup_ref(
+    iree_hal_buffer_binding_table_t binding_table,
+    const iree_hal_task_cmd_fixup_ref_t* fixup_ref,
+    iree_hal_buffer_ref_t* out_resolved_ref) {
+  if (fixup_ref->ref.buffer) {
+    *out_resolved_ref = fixup_ref->ref;
+    return iree_ok_status();
+  }
+
+  const uint32_t slot = fixup_ref->ref.buffer_slot;
+  if (IREE_UNLIKELY(slot >= binding_table.count)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "indirect buffer reference to binding table slot "
+                            "%u out of range of binding table with %" PRIhsz
+                            " bindings",
+                            slot, binding_table.count);
+  }
+  iree_hal_buffer_t* buffer = binding_table.bindings[slot].buffer;
+  if (IREE_UNLIKELY(!buffer)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "binding table slot %u requires a buffer but none was provided", slot);
+  }
+  IREE_RETURN_IF_ERROR(
+      iree_hal_buffer_validate_usage(iree_hal_buffer_allowed_usage(buffer),
+                                     fixup_ref->usage),
+      "binding table slot %u", slot);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_buffer_validate_access(iree_hal_buffer_allowed_access(buffer),
+                                      fixup_ref->access),
+      "binding table slot %u", slot);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_buffer_binding_table_resolve_ref(binding_table, fixup_ref->ref,
+                                                out_resolved_ref),
+      "binding table slot %u", slot);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_buffer_validate_range(buffer, out_resolved_ref->offset,
+                                     out_resolved_ref->length),
+      "binding table slot %u", slot);
+  return iree_ok_status();
+}
+
+// Resolves the buffer references of all commands with fixups against
+// |binding_table| and updates the commands prior to issuing them.
+static iree_status_t iree_hal_task_command_buffer_apply_fixups(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_buffer_binding_table_t binding_table,
+    iree_arena_allocator_t* arena) {
+  if (!command_buffer->fixup_head) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_buffer_ref_t* resolved_refs = NULL;
+  iree_host_size_t resolved_capacity = 0;
+  iree_status_t status = iree_ok_status();
+  for (iree_hal_task_cmd_fixup_t* fixup = command_buffer->fixup_head;
+       fixup != NULL && iree_status_is_ok(status); fixup = fixup->next) {
+    if (fixup->ref_count > resolved_capacity) {
+      status = iree_arena_allocate(arena,
+                                   fixup->ref_count * sizeof(*resolved_refs),
+                                   (void**)&resolved_refs);
+      if (!iree_status_is_ok(status)) break;
+      resolved_capacity = fixup->ref_count;
+    }
+    for (iree_host_size_t i = 0;
+         i < fixup->ref_count && iree_status_is_ok(status); ++i) {
+      status = iree_hal_task_cmd_resolve_fixup_ref(
+          binding_table, &fixup->refs[i], &resolved_refs[i]);
+    }
+    if (iree_status_is_ok(status)) {
+      status = fixup->fn(fixup->cmd, fixup->ref_count, resolved_refs);
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // Flushes all open tasks to the previous barrier and prepares for more
 // recording. The root tasks are also populated here when required as this is
 // the one place where we can see both halves of the most recent synchronization
@@ -285,6 +653,8 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
   IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
                                            sizeof(*barrier), (void**)&barrier));
   iree_task_barrier_initialize_empty(command_buffer->scope, barrier);
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_task(
+      command_buffer, &barrier->header));
 
   // If there were previous tasks then join them to the barrier.
   for (iree_task_t* task = iree_task_list_front(&command_buffer->leaf_tasks);
@@ -317,11 +687,284 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
   return iree_ok_status();
 }
 
+// Adds an edge from |source| to |target| unless one already exists.
+static iree_status_t iree_hal_task_command_buffer_add_edge(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_task_cmd_node_t* source, iree_hal_task_cmd_node_t* target) {
+  if (source == target || source->last_successor == target) {
+    return iree_ok_status();
+  }
+  iree_hal_task_cmd_edge_t* edge = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*edge), (void**)&edge));
+  edge->next = source->successors;
+  edge->target = target;
+  source->successors = edge;
+  source->last_successor = target;
+  ++source->successor_count;
+  ++target->predecessor_count;
+  ++command_buffer->state.hazards.edge_count;
+  return iree_ok_status();
+}
+
+// Allocates a new node for |task| and appends it to the DAG.
+static iree_status_t iree_hal_task_command_buffer_append_node(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task,
+    iree_hal_task_cmd_node_t** out_node) {
+  iree_hal_task_cmd_node_t* node = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*node), (void**)&node));
+  memset(node, 0, sizeof(*node));
+  node->task = task;
+  node->epoch = command_buffer->state.hazards.epoch;
+  if (command_buffer->state.hazards.node_tail) {
+    command_buffer->state.hazards.node_tail->next = node;
+  } else {
+    command_buffer->state.hazards.node_head = node;
+  }
+  command_buffer->state.hazards.node_tail = node;
+  *out_node = node;
+  return iree_ok_status();
+}
+
+// Records that the next command emitted will access the given range of
+// |buffer|. Must be called prior to
+// iree_hal_task_command_buffer_emit_execution_task for each range the command
+// reads or writes. No-op unless tracking hazards.
+static iree_status_t iree_hal_task_command_buffer_track_access(
+    iree_hal_task_command_buffer_t* command_buffer, iree_hal_buffer_t* buffer,
+    iree_device_size_t offset, iree_device_size_t length, bool is_write) {
+  if (command_buffer->barrier_mode !=
+          IREE_HAL_TASK_BARRIER_MODE_HAZARD_TRACKING ||
+      !buffer || length == 0) {
+    return iree_ok_status();
+  }
+
+  // Ranges are tracked in the allocated buffer so that accesses through
+  // different subspans of the same allocation are compared.
+  iree_device_size_t begin = iree_hal_buffer_byte_offset(buffer) + offset;
+  iree_device_size_t end =
+      length == IREE_HAL_WHOLE_BUFFER
+          ? iree_hal_buffer_byte_offset(buffer) +
+                iree_hal_buffer_byte_length(buffer)
+          : begin + length;
+
+  iree_hal_task_cmd_access_t* access =
+      command_buffer->state.hazards.free_accesses;
+  if (access) {
+    command_buffer->state.hazards.free_accesses = access->next;
+  } else {
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        &command_buffer->arena, sizeof(*access), (void**)&access));
+  }
+  access->buffer = iree_hal_buffer_allocated_buffer(buffer);
+  access->begin = begin;
+  access->end = end;
+  access->is_write = is_write;
+  access->node = NULL;
+  access->next = command_buffer->state.hazards.pending_accesses;
+  command_buffer->state.hazards.pending_accesses = access;
+  return iree_ok_status();
+}
+
+// Appends |task| to the DAG with edges from all prior nodes recorded in earlier
+// epochs that it has a hazard with based on the pending accesses.
+static iree_status_t iree_hal_task_command_buffer_emit_hazard_task(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
+  iree_hal_task_cmd_node_t* node = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_append_node(command_buffer, task, &node));
+
+  // Everything recorded after a fence must wait for it.
+  if (command_buffer->state.hazards.fence_node) {
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_add_edge(
+        command_buffer, command_buffer->state.hazards.fence_node, node));
+  }
+
+  // Check each access against the live ones. Accesses recorded in the same
+  // epoch have no barrier between them and are allowed to execute concurrently
+  // as with global barriers.
+  for (iree_hal_task_cmd_access_t* access =
+           command_buffer->state.hazards.pending_accesses;
+       access != NULL; access = access->next) {
+    iree_hal_task_cmd_access_t** live_ptr =
+        &command_buffer->state.hazards.live_accesses;
+    while (*live_ptr) {
+      iree_hal_task_cmd_access_t* live = *live_ptr;
+      const bool has_hazard =
+          live->node->epoch < node->epoch && live->buffer == access->buffer &&
+          live->begin < access->end && access->begin < live->end &&
+          (live->is_write || access->is_write);
+      if (!has_hazard) {
+        live_ptr = &live->next;
+        continue;
+      }
+      IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_add_edge(
+          command_buffer, live->node, node));
+      if (access->is_write && access->begin <= live->begin &&
+          live->end <= access->end) {
+        // The new write covers the live access entirely and is ordered after
+        // it so any future hazard with the live access will also be a hazard
+        // with the new one. We can stop tracking the live access.
+        *live_ptr = live->next;
+        live->next = command_buffer->state.hazards.free_accesses;
+        command_buffer->state.hazards.free_accesses = live;
+        --command_buffer->state.hazards.live_access_count;
+      } else {
+        live_ptr = &live->next;
+      }
+    }
+  }
+
+  // Move the pending accesses to the live list.
+  iree_hal_task_cmd_access_t* access =
+      command_buffer->state.hazards.pending_accesses;
+  while (access) {
+    iree_hal_task_cmd_access_t* next_access = access->next;
+    access->node = node;
+    access->next = command_buffer->state.hazards.live_accesses;
+    command_buffer->state.hazards.live_accesses = access;
+    ++command_buffer->state.hazards.live_access_count;
+    access = next_access;
+  }
+  command_buffer->state.hazards.pending_accesses = NULL;
+
+  return iree_ok_status();
+}
+
+// Emits a barrier while tracking hazards. Commands recorded after the barrier
+// will only wait on commands recorded prior that they have hazards with. If
+// too many accesses are live we instead insert a fence that joins all of them
+// to keep recording costs bounded.
+static iree_status_t iree_hal_task_command_buffer_emit_hazard_barrier(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  ++command_buffer->state.hazards.epoch;
+  if (command_buffer->state.hazards.live_access_count <=
+      IREE_HAL_TASK_CMD_MAX_TRACKED_ACCESSES) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_task_barrier_t* fence = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(&command_buffer->arena, sizeof(*fence),
+                              (void**)&fence));
+  iree_task_barrier_initialize_empty(command_buffer->scope, fence);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_task_command_buffer_track_task(command_buffer,
+                                                  &fence->header));
+  iree_hal_task_cmd_node_t* fence_node = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_task_command_buffer_append_node(
+              command_buffer, &fence->header, &fence_node));
+
+  // The fence joins the prior fence (if any) and all nodes with live accesses.
+  // Nodes without live accesses are already ordered before one of those.
+  if (command_buffer->state.hazards.fence_node) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_task_command_buffer_add_edge(
+                command_buffer, command_buffer->state.hazards.fence_node,
+                fence_node));
+  }
+  iree_hal_task_cmd_access_t* access =
+      command_buffer->state.hazards.live_accesses;
+  while (access) {
+    iree_hal_task_cmd_access_t* next_access = access->next;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_task_command_buffer_add_edge(command_buffer, access->node,
+                                                  fence_node));
+    access->next = command_buffer->state.hazards.free_accesses;
+    command_buffer->state.hazards.free_accesses = access;
+    access = next_access;
+  }
+  command_buffer->state.hazards.live_accesses = NULL;
+  command_buffer->state.hazards.live_access_count = 0;
+  command_buffer->state.hazards.fence_node = fence_node;
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Lowers the DAG built while tracking hazards into task dependencies.
+// Nodes with no predecessors become the root tasks and nodes with no successors
+// are joined on a barrier that becomes the single leaf task. Nodes with
+// multiple successors fan out through a barrier as tasks only support a single
+// completion task.
+static iree_status_t iree_hal_task_command_buffer_flush_hazards(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  if (!command_buffer->state.hazards.node_head) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0,
+                                   command_buffer->state.hazards.edge_count);
+
+  // If there are no edges all tasks are both roots and leaves and the issue
+  // will chain them directly to the retire task.
+  iree_task_barrier_t* join = NULL;
+  if (command_buffer->state.hazards.edge_count > 0) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_arena_allocate(&command_buffer->arena, sizeof(*join),
+                                (void**)&join));
+    iree_task_barrier_initialize_empty(command_buffer->scope, join);
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_task_command_buffer_track_task(command_buffer,
+                                                    &join->header));
+  }
+
+  for (iree_hal_task_cmd_node_t* node = command_buffer->state.hazards.node_head;
+       node != NULL; node = node->next) {
+    if (node->successor_count == 0) {
+      if (join) iree_task_set_completion_task(node->task, &join->header);
+    } else if (node->successor_count == 1) {
+      iree_task_set_completion_task(node->task, node->successors->target->task);
+    } else {
+      iree_task_barrier_t* fan_out = NULL;
+      iree_task_t** dependent_tasks = NULL;
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_arena_allocate(&command_buffer->arena,
+                                  sizeof(*fan_out) + node->successor_count *
+                                                         sizeof(iree_task_t*),
+                                  (void**)&fan_out));
+      dependent_tasks = (iree_task_t**)((uint8_t*)fan_out + sizeof(*fan_out));
+      iree_host_size_t i = 0;
+      for (iree_hal_task_cmd_edge_t* edge = node->successors; edge != NULL;
+           edge = edge->next) {
+        dependent_tasks[i++] = edge->target->task;
+      }
+      iree_task_barrier_initialize(command_buffer->scope,
+                                   node->successor_count, dependent_tasks,
+                                   fan_out);
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_hal_task_command_buffer_track_task(command_buffer,
+                                                      &fan_out->header));
+      iree_task_set_completion_task(node->task, &fan_out->header);
+    }
+    if (node->predecessor_count == 0) {
+      iree_task_list_push_back(&command_buffer->root_tasks, node->task);
+    }
+  }
+  if (join) {
+    iree_task_list_push_back(&command_buffer->leaf_tasks, &join->header);
+  }
+
+  memset(&command_buffer->state.hazards, 0,
+         sizeof(command_buffer->state.hazards));
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 // Emits a the given execution |task| into the current open synchronization
-// scope (after state.open_barrier and before the next barrier).
+// scope (after state.open_barrier and before the next barrier). When tracking
+// hazards all accesses of the task must have been recorded with
+// iree_hal_task_command_buffer_track_access first.
 static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
     iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
-  if (command_buffer->state.open_barrier == NULL) {
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_track_task(command_buffer, task));
+  if (command_buffer->barrier_mode ==
+      IREE_HAL_TASK_BARRIER_MODE_HAZARD_TRACKING) {
+    return iree_hal_task_command_buffer_emit_hazard_task(command_buffer, task);
+  } else if (command_buffer->state.open_barrier == NULL) {
     // If there is no open barrier then we are at the head and going right into
     // the task DAG.
     iree_task_list_push_back(&command_buffer->leaf_tasks, task);
@@ -337,20 +980,104 @@ static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
 // iree_hal_task_command_buffer_t execution
 //===----------------------------------------------------------------------===//
 
+bool iree_hal_task_command_buffer_acquire(
+    iree_hal_command_buffer_t* base_command_buffer, iree_task_scope_t* scope) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (!iree_hal_task_command_buffer_is_reusable(command_buffer)) return true;
+  if (command_buffer->scope != scope) return false;
+  if (!command_buffer->replay.tail) return true;  // empty
+  int32_t expected = 0;
+  return iree_atomic_compare_exchange_strong(
+      &command_buffer->replay.in_flight, &expected, 1,
+      iree_memory_order_acquire, iree_memory_order_relaxed);
+}
+
+iree_hal_command_buffer_t* iree_hal_task_command_buffer_deferred(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  return command_buffer->replay.deferred;
+}
+
+// Issues the DAG of a reusable command buffer acquired for replay.
+// All tasks are reset to the state they had when recording ended.
+static iree_status_t iree_hal_task_command_buffer_issue_replay(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* retire_task,
+    iree_task_priority_t priority,
+    iree_hal_buffer_binding_table_t binding_table,
+    iree_arena_allocator_t* arena, iree_task_submission_t* pending_submission) {
+  iree_hal_task_cmd_tail_t* tail = command_buffer->replay.tail;
+  if (!tail) return iree_ok_status();  // empty
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Reset all tasks and gather the roots.
+  iree_task_list_t root_tasks;
+  iree_task_list_initialize(&root_tasks);
+  for (iree_hal_task_cmd_replay_task_t* replay_task =
+           command_buffer->replay.task_head;
+       replay_task != NULL; replay_task = replay_task->next) {
+    iree_task_reset(replay_task->task, replay_task->completion_task,
+                    replay_task->pending_dependency_count);
+    if (replay_task->pending_dependency_count == 0) {
+      iree_task_list_push_back(&root_tasks, replay_task->task);
+    }
+  }
+
+  iree_status_t status = iree_hal_task_command_buffer_apply_fixups(
+      command_buffer, binding_table, arena);
+  if (!iree_status_is_ok(status)) {
+    // Nothing was issued and the DAG can be replayed again.
+    iree_atomic_store(&command_buffer->replay.in_flight, 0,
+                      iree_memory_order_release);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // The tail barrier joins all leaves and its completion indicates that all
+  // commands have completed.
+  iree_task_set_completion_task(&tail->task.header, retire_task);
+
+  // Assign the priority class to the roots; the rest of the DAG inherits it as
+  // the roots retire and ready their dependents.
+  for (iree_task_t* task = root_tasks.head; task != NULL;
+       task = task->next_task) {
+    iree_task_set_priority(task, priority);
+  }
+
+  iree_task_submission_enqueue_list(pending_submission, &root_tasks);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_task_command_buffer_issue(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_task_queue_state_t* queue_state, iree_task_t* retire_task,
+    iree_task_priority_t priority,
+    iree_hal_buffer_binding_table_t binding_table,
     iree_arena_allocator_t* arena, iree_task_submission_t* pending_submission) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
   IREE_ASSERT_TRUE(command_buffer);
 
+  if (iree_hal_task_command_buffer_is_reusable(command_buffer)) {
+    return iree_hal_task_command_buffer_issue_replay(
+        command_buffer, retire_task, priority, binding_table, arena,
+        pending_submission);
+  }
+
   // If the command buffer is empty (valid!) then we are a no-op.
   bool has_root_tasks = !iree_task_list_is_empty(&command_buffer->root_tasks);
   if (!has_root_tasks) {
     return iree_ok_status();
   }
 
+  // Resolve any indirect buffer references prior to linking the DAG so that
+  // it remains untouched on failure.
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_apply_fixups(
+      command_buffer, binding_table, arena));
+
   bool has_leaf_tasks = !iree_task_list_is_empty(&command_buffer->leaf_tasks);
   if (has_leaf_tasks) {
     // Chain the retire task onto the leaf tasks as their completion indicates
@@ -368,6 +1095,13 @@ iree_status_t iree_hal_task_command_buffer_issue(
     }
   }
 
+  // Assign the priority class to the roots; the rest of the DAG inherits it as
+  // the roots retire and ready their dependents.
+  for (iree_task_t* task = command_buffer->root_tasks.head; task != NULL;
+       task = task->next_task) {
+    iree_task_set_priority(task, priority);
+  }
+
   // Enqueue all root tasks that are ready to run immediately.
   // After this all of the command buffer tasks are owned by the submission and
   // we need to ensure the command buffer doesn't try to discard them.
@@ -386,12 +1120,24 @@ static iree_status_t iree_hal_task_command_buffer_begin_debug_group(
     iree_hal_command_buffer_t* base_command_buffer, iree_string_view_t label,
     iree_hal_label_color_t label_color,
     const iree_hal_label_location_t* location) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_begin_debug_group(
+        command_buffer->replay.deferred, label, label_color, location));
+  }
   // TODO(benvanik): tracy event stack.
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_task_command_buffer_end_debug_group(
     iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_end_debug_group(
+        command_buffer->replay.deferred));
+  }
   // TODO(benvanik): tracy event stack.
   return iree_ok_status();
 }
@@ -411,9 +1157,19 @@ static iree_status_t iree_hal_task_command_buffer_execution_barrier(
     const iree_hal_buffer_barrier_t* buffer_barriers) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
-
-  // TODO(benvanik): actual DAG construction. Right now we are just doing simple
-  // global barriers each time and forcing a join-fork point.
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_execution_barrier(
+        command_buffer->replay.deferred, source_stage_mask, target_stage_mask,
+        flags, memory_barrier_count, memory_barriers, buffer_barrier_count,
+        buffer_barriers));
+  }
+  if (command_buffer->barrier_mode ==
+      IREE_HAL_TASK_BARRIER_MODE_HAZARD_TRACKING) {
+    // Commands only touch memory through the buffers they reference and those
+    // accesses are tracked so we can ignore the barrier scopes and only order
+    // commands that actually have a hazard.
+    return iree_hal_task_command_buffer_emit_hazard_barrier(command_buffer);
+  }
   return iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
 }
 
@@ -424,6 +1180,12 @@ static iree_status_t iree_hal_task_command_buffer_execution_barrier(
 static iree_status_t iree_hal_task_command_buffer_signal_event(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
     iree_hal_execution_stage_t source_stage_mask) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_signal_event(
+        command_buffer->replay.deferred, event, source_stage_mask));
+  }
   // TODO(#4518): implement events. For now we just insert global barriers.
   return iree_ok_status();
 }
@@ -435,6 +1197,12 @@ static iree_status_t iree_hal_task_command_buffer_signal_event(
 static iree_status_t iree_hal_task_command_buffer_reset_event(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
     iree_hal_execution_stage_t source_stage_mask) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_reset_event(
+        command_buffer->replay.deferred, event, source_stage_mask));
+  }
   // TODO(#4518): implement events. For now we just insert global barriers.
   return iree_ok_status();
 }
@@ -454,7 +1222,17 @@ static iree_status_t iree_hal_task_command_buffer_wait_events(
     const iree_hal_buffer_barrier_t* buffer_barriers) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_wait_events(
+        command_buffer->replay.deferred, event_count, events,
+        source_stage_mask, target_stage_mask, memory_barrier_count,
+        memory_barriers, buffer_barrier_count, buffer_barriers));
+  }
   // TODO(#4518): implement events. For now we just insert global barriers.
+  if (command_buffer->barrier_mode ==
+      IREE_HAL_TASK_BARRIER_MODE_HAZARD_TRACKING) {
+    return iree_hal_task_command_buffer_emit_hazard_barrier(command_buffer);
+  }
   return iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
 }
 
@@ -466,6 +1244,12 @@ static iree_status_t iree_hal_task_command_buffer_advise_buffer(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_buffer_ref_t buffer_ref, iree_hal_memory_advise_flags_t flags,
     uint64_t arg0, uint64_t arg1) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_advise_buffer(
+        command_buffer->replay.deferred, buffer_ref, flags, arg0, arg1));
+  }
   return iree_ok_status();
 }
 
@@ -511,12 +1295,28 @@ static iree_status_t iree_hal_task_cmd_fill_tile(
   return status;
 }
 
+static iree_status_t iree_hal_task_cmd_fill_fixup(
+    void* user_data, iree_host_size_t ref_count,
+    const iree_hal_buffer_ref_t* refs) {
+  iree_hal_task_cmd_fill_buffer_t* cmd =
+      (iree_hal_task_cmd_fill_buffer_t*)user_data;
+  cmd->target_ref = refs[0];
+  cmd->task.workgroup_count.value[0] = (uint32_t)iree_device_size_ceil_div(
+      cmd->target_ref.length, cmd->task.workgroup_size[0]);
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_command_buffer_fill_buffer(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_buffer_ref_t target_ref, const void* pattern,
     iree_host_size_t pattern_length, iree_hal_fill_flags_t flags) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_fill_buffer(
+        command_buffer->replay.deferred, target_ref, pattern, pattern_length,
+        flags));
+  }
 
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
       command_buffer->resource_set, 1, &target_ref.buffer));
@@ -542,7 +1342,18 @@ static iree_status_t iree_hal_task_command_buffer_fill_buffer(
   cmd->target_ref = target_ref;
   memcpy(cmd->pattern, pattern, pattern_length);
   cmd->pattern_length = pattern_length;
+  if (!target_ref.buffer) {
+    iree_hal_task_cmd_fixup_ref_t* fixup_refs = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_append_fixup(
+        command_buffer, iree_hal_task_cmd_fill_fixup, cmd, 1, &fixup_refs));
+    fixup_refs[0] = iree_hal_task_cmd_make_fixup_ref(
+        target_ref, IREE_HAL_BUFFER_USAGE_TRANSFER_TARGET,
+        IREE_HAL_MEMORY_ACCESS_WRITE);
+  }
 
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_access(
+      command_buffer, target_ref.buffer, target_ref.offset, target_ref.length,
+      /*is_write=*/true));
   return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
                                                           &cmd->task.header);
 }
@@ -570,12 +1381,28 @@ static iree_status_t iree_hal_task_cmd_update_buffer(
   return status;
 }
 
+static iree_status_t iree_hal_task_cmd_update_fixup(
+    void* user_data, iree_host_size_t ref_count,
+    const iree_hal_buffer_ref_t* refs) {
+  iree_hal_task_cmd_update_buffer_t* cmd =
+      (iree_hal_task_cmd_update_buffer_t*)user_data;
+  // The length is that of the source data copied into the command.
+  cmd->target_ref.buffer = refs[0].buffer;
+  cmd->target_ref.offset = refs[0].offset;
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_command_buffer_update_buffer(
     iree_hal_command_buffer_t* base_command_buffer, const void* source_buffer,
     iree_host_size_t source_offset, iree_hal_buffer_ref_t target_ref,
     iree_hal_update_flags_t flags) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_update_buffer(
+        command_buffer->replay.deferred, source_buffer, source_offset,
+        target_ref, flags));
+  }
 
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
       command_buffer->resource_set, 1, &target_ref.buffer));
@@ -594,7 +1421,18 @@ static iree_status_t iree_hal_task_command_buffer_update_buffer(
   cmd->target_ref = target_ref;
   memcpy(cmd->source_buffer, (const uint8_t*)source_buffer + source_offset,
          cmd->target_ref.length);
+  if (!target_ref.buffer) {
+    iree_hal_task_cmd_fixup_ref_t* fixup_refs = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_append_fixup(
+        command_buffer, iree_hal_task_cmd_update_fixup, cmd, 1, &fixup_refs));
+    fixup_refs[0] = iree_hal_task_cmd_make_fixup_ref(
+        target_ref, IREE_HAL_BUFFER_USAGE_TRANSFER_TARGET,
+        IREE_HAL_MEMORY_ACCESS_WRITE);
+  }
 
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_access(
+      command_buffer, target_ref.buffer, target_ref.offset, target_ref.length,
+      /*is_write=*/true));
   return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
                                                           &cmd->task.header);
 }
@@ -641,12 +1479,28 @@ static iree_status_t iree_hal_task_cmd_copy_tile(
   return status;
 }
 
+static iree_status_t iree_hal_task_cmd_copy_fixup(
+    void* user_data, iree_host_size_t ref_count,
+    const iree_hal_buffer_ref_t* refs) {
+  iree_hal_task_cmd_copy_buffer_t* cmd =
+      (iree_hal_task_cmd_copy_buffer_t*)user_data;
+  cmd->source_ref = refs[0];
+  cmd->target_ref = refs[1];
+  cmd->task.workgroup_count.value[0] = (uint32_t)iree_device_size_ceil_div(
+      cmd->target_ref.length, cmd->task.workgroup_size[0]);
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_command_buffer_copy_buffer(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_buffer_ref_t source_ref, iree_hal_buffer_ref_t target_ref,
     iree_hal_copy_flags_t flags) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_copy_buffer(
+        command_buffer->replay.deferred, source_ref, target_ref, flags));
+  }
 
   const iree_hal_buffer_t* buffers[2] = {
       source_ref.buffer,
@@ -675,7 +1529,24 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
       workgroup_size, workgroup_count, &cmd->task);
   cmd->source_ref = source_ref;
   cmd->target_ref = target_ref;
+  if (!source_ref.buffer || !target_ref.buffer) {
+    iree_hal_task_cmd_fixup_ref_t* fixup_refs = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_append_fixup(
+        command_buffer, iree_hal_task_cmd_copy_fixup, cmd, 2, &fixup_refs));
+    fixup_refs[0] = iree_hal_task_cmd_make_fixup_ref(
+        source_ref, IREE_HAL_BUFFER_USAGE_TRANSFER_SOURCE,
+        IREE_HAL_MEMORY_ACCESS_READ);
+    fixup_refs[1] = iree_hal_task_cmd_make_fixup_ref(
+        target_ref, IREE_HAL_BUFFER_USAGE_TRANSFER_TARGET,
+        IREE_HAL_MEMORY_ACCESS_WRITE);
+  }
 
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_access(
+      command_buffer, source_ref.buffer, source_ref.offset, source_ref.length,
+      /*is_write=*/false));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_access(
+      command_buffer, target_ref.buffer, target_ref.offset, target_ref.length,
+      /*is_write=*/true));
   return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
                                                           &cmd->task.header);
 }
@@ -688,6 +1559,13 @@ static iree_status_t iree_hal_task_command_buffer_collective(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_channel_t* channel,
     iree_hal_collective_op_t op, uint32_t param, iree_hal_buffer_ref_t send_ref,
     iree_hal_buffer_ref_t recv_ref, iree_device_size_t element_count) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_collective(
+        command_buffer->replay.deferred, channel, op, param, send_ref,
+        recv_ref, element_count));
+  }
   // The channel can be used as a vtable if we want to inject collective APIs -
   // the device creation function would set up the channel once and we'll
   // receive it here each time. When interacting with the task system we want to
@@ -783,6 +1661,45 @@ static iree_status_t iree_hal_task_cmd_dispatch_tile(
   return status;
 }
 
+// Maps the resolved binding and workgroup count references of a dispatch.
+// |refs| contains one reference per binding followed by the workgroup count
+// reference if the dispatch uses indirect parameters.
+static iree_status_t iree_hal_task_cmd_dispatch_fixup(
+    void* user_data, iree_host_size_t ref_count,
+    const iree_hal_buffer_ref_t* refs) {
+  iree_hal_task_cmd_dispatch_t* cmd = (iree_hal_task_cmd_dispatch_t*)user_data;
+  uint8_t* cmd_ptr = (uint8_t*)cmd + sizeof(*cmd);
+  cmd_ptr += cmd->constant_count * sizeof(uint32_t);
+  void** binding_ptrs = (void**)cmd_ptr;
+  cmd_ptr += cmd->binding_count * sizeof(*binding_ptrs);
+  size_t* binding_lengths = (size_t*)cmd_ptr;
+  for (iree_host_size_t i = 0; i < cmd->binding_count; ++i) {
+    // TODO(benvanik): track mapping so we can properly map/unmap/flush/etc.
+    iree_hal_buffer_mapping_t buffer_mapping = {{0}};
+    IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+        refs[i].buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
+        IREE_HAL_MEMORY_ACCESS_ANY, refs[i].offset, refs[i].length,
+        &buffer_mapping));
+    binding_ptrs[i] = buffer_mapping.contents.data;
+    binding_lengths[i] = buffer_mapping.contents.data_length;
+  }
+
+  // Issuing an indirect dispatch replaces the workgroup count pointer with the
+  // value read from it so we have to restore both each time.
+  if (ref_count > cmd->binding_count) {
+    const iree_hal_buffer_ref_t workgroup_count_ref = refs[cmd->binding_count];
+    iree_hal_buffer_mapping_t buffer_mapping = {{0}};
+    IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+        workgroup_count_ref.buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
+        IREE_HAL_MEMORY_ACCESS_READ, workgroup_count_ref.offset,
+        3 * sizeof(uint32_t), &buffer_mapping));
+    cmd->task.workgroup_count.ptr =
+        (const uint32_t*)buffer_mapping.contents.data;
+    cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_INDIRECT;
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_command_buffer_dispatch(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable,
@@ -791,6 +1708,11 @@ static iree_status_t iree_hal_task_command_buffer_dispatch(
     iree_hal_buffer_ref_list_t bindings, iree_hal_dispatch_flags_t flags) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (command_buffer->replay.deferred) {
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_dispatch(
+        command_buffer->replay.deferred, executable, export_ordinal, config,
+        constants, bindings, flags));
+  }
 
   // TODO(benvanik): support custom arguments.
   if (iree_hal_dispatch_uses_custom_arguments(flags)) {
@@ -825,9 +1747,18 @@ static iree_status_t iree_hal_task_command_buffer_dispatch(
                                       (void*)cmd),
       config.workgroup_size, config.workgroup_count, &cmd->task);
 
+  // Indirect references are resolved when issued and indirect parameters need
+  // to be restored each time a reusable command buffer is replayed.
+  const bool uses_indirect_parameters =
+      iree_hal_dispatch_uses_indirect_parameters(flags);
+  bool needs_fixup =
+      uses_indirect_parameters &&
+      (iree_hal_task_command_buffer_is_reusable(command_buffer) ||
+       !config.workgroup_count_ref.buffer);
+
   iree_host_size_t resource_count = 1;
   const void* resources[2] = {executable, NULL};
-  if (iree_hal_dispatch_uses_indirect_parameters(flags)) {
+  if (uses_indirect_parameters) {
     resources[resource_count++] = config.workgroup_count_ref.buffer;
 
     // Make task system fetch the workgroup count from the provided buffer.
@@ -835,12 +1766,18 @@ static iree_status_t iree_hal_task_command_buffer_dispatch(
 
     // TODO(benvanik): track mapping so we can properly map/unmap/flush/etc.
     iree_hal_buffer_mapping_t buffer_mapping = {{0}};
-    IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
-        config.workgroup_count_ref.buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
-        IREE_HAL_MEMORY_ACCESS_READ, config.workgroup_count_ref.offset,
-        3 * sizeof(uint32_t), &buffer_mapping));
+    if (config.workgroup_count_ref.buffer) {
+      IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+          config.workgroup_count_ref.buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
+          IREE_HAL_MEMORY_ACCESS_READ, config.workgroup_count_ref.offset,
+          3 * sizeof(uint32_t), &buffer_mapping));
+    }
     cmd->task.workgroup_count.ptr =
         (const uint32_t*)buffer_mapping.contents.data;
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_access(
+        command_buffer, config.workgroup_count_ref.buffer,
+        config.workgroup_count_ref.offset, 3 * sizeof(uint32_t),
+        /*is_write=*/false));
   }
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
       command_buffer->resource_set, resource_count, resources));
@@ -899,6 +1836,9 @@ static iree_status_t iree_hal_task_command_buffer_dispatch(
           binding.buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
           IREE_HAL_MEMORY_ACCESS_ANY, binding.offset, binding.length,
           &buffer_mapping));
+    } else if (command_buffer->base.binding_capacity > 0) {
+      // Indirect reference into the binding table mapped when issued.
+      needs_fixup = true;
     } else {
       return iree_make_status(
           IREE_STATUS_FAILED_PRECONDITION,
@@ -908,11 +1848,35 @@ static iree_status_t iree_hal_task_command_buffer_dispatch(
     }
     binding_ptrs[i] = buffer_mapping.contents.data;
     binding_lengths[i] = buffer_mapping.contents.data_length;
+
+    // Executables don't declare whether bindings are read-only so we have to
+    // conservatively assume all bindings may be written.
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_access(
+        command_buffer, bindings.values[i].buffer, bindings.values[i].offset,
+        bindings.values[i].length, /*is_write=*/true));
   }
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_strided(
       command_buffer->resource_set, bindings.count, bindings.values,
       offsetof(iree_hal_buffer_ref_t, buffer), sizeof(iree_hal_buffer_ref_t)));
 
+  if (needs_fixup) {
+    iree_hal_task_cmd_fixup_ref_t* fixup_refs = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_append_fixup(
+        command_buffer, iree_hal_task_cmd_dispatch_fixup, cmd,
+        bindings.count + (uses_indirect_parameters ? 1 : 0), &fixup_refs));
+    for (iree_host_size_t i = 0; i < bindings.count; ++i) {
+      fixup_refs[i] = iree_hal_task_cmd_make_fixup_ref(
+          bindings.values[i], IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE,
+          IREE_HAL_MEMORY_ACCESS_ANY);
+    }
+    if (uses_indirect_parameters) {
+      fixup_refs[bindings.count] = iree_hal_task_cmd_make_fixup_ref(
+          config.workgroup_count_ref,
+          IREE_HAL_BUFFER_USAGE_DISPATCH_INDIRECT_PARAMETERS,
+          IREE_HAL_MEMORY_ACCESS_READ);
+    }
+  }
+
   return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
                                                           &cmd->task.header);
 }
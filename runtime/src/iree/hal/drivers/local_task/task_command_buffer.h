@@ -18,8 +18,31 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Controls how execution barriers recorded into a task command buffer are
+// lowered into the task DAG.
+typedef enum iree_hal_task_barrier_mode_e {
+  // Each barrier joins all previously recorded tasks and forks all subsequently
+  // recorded tasks. Cheapest to record but serializes independent work that
+  // happens to be separated by a barrier.
+  IREE_HAL_TASK_BARRIER_MODE_GLOBAL = 0u,
+  // Each command tracks the byte ranges of the buffers it reads and writes and
+  // barriers only order commands that have a hazard (read-after-write,
+  // write-after-read, or write-after-write) on overlapping ranges. Commands
+  // touching disjoint memory may overlap even when separated by barriers.
+  IREE_HAL_TASK_BARRIER_MODE_HAZARD_TRACKING = 1u,
+} iree_hal_task_barrier_mode_t;
+
+// Creates a task command buffer that builds the task DAG of the recorded
+// commands for submission to |scope|.
+//
+// Reusable command buffers (without IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)
+// build the DAG once and each submission resets the tasks and resolves the
+// binding table in-place instead of recording a new DAG. A deferred copy of
+// the commands is retained to handle overlapping submissions; see
+// iree_hal_task_command_buffer_acquire.
 iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_allocator_t* device_allocator, iree_task_scope_t* scope,
+    iree_hal_task_barrier_mode_t barrier_mode,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
@@ -30,7 +53,23 @@ iree_status_t iree_hal_task_command_buffer_create(
 bool iree_hal_task_command_buffer_isa(
     iree_hal_command_buffer_t* command_buffer);
 
+// Acquires the task DAG of |command_buffer| for issuing to a queue that
+// submits tasks to |scope|. Always succeeds for one-shot command buffers.
+// Reusable command buffers fail if the DAG was built for another scope or
+// if a prior submission of it has not yet completed. In that case the caller
+// must instead apply the commands from iree_hal_task_command_buffer_deferred
+// to a transient command buffer.
+bool iree_hal_task_command_buffer_acquire(
+    iree_hal_command_buffer_t* command_buffer, iree_task_scope_t* scope);
+
+// Returns the deferred copy of the commands recorded into a reusable
+// |command_buffer| or NULL if the command buffer is one-shot.
+iree_hal_command_buffer_t* iree_hal_task_command_buffer_deferred(
+    iree_hal_command_buffer_t* command_buffer);
+
 // Issues a recorded command buffer using the serial |queue_state|.
+// The command buffer must have been acquired with
+// iree_hal_task_command_buffer_acquire.
 // |queue_state| is used to track the synchronization scope of the queue from
 // prior commands such as signaled events and will be mutated as events are
 // reset or new events are signaled.
@@ -44,11 +83,19 @@ bool iree_hal_task_command_buffer_isa(
 // all of the allocated commands issued have completed and their memory in the
 // arena can be recycled.
 //
+// |priority| is assigned to the root tasks of the command buffer and inherited
+// by all tasks they ready as they retire.
+//
+// Indirect buffer references recorded in the command buffer are resolved
+// against |binding_table|.
+//
 // |pending_submission| will receive the ready list of commands and must be
 // submitted to the executor (or discarded on failure) by the caller.
 iree_status_t iree_hal_task_command_buffer_issue(
     iree_hal_command_buffer_t* command_buffer,
     iree_hal_task_queue_state_t* queue_state, iree_task_t* retire_task,
+    iree_task_priority_t priority,
+    iree_hal_buffer_binding_table_t binding_table,
     iree_arena_allocator_t* arena, iree_task_submission_t* pending_submission);
 
 #ifdef __cplusplus
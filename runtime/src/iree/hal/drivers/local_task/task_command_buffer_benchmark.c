@@ -0,0 +1,294 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_task/task_device.h"
+#include "iree/task/executor.h"
+#include "iree/task/topology.h"
+#include "iree/testing/benchmark.h"
+
+// Number of worker threads in the executor. Matches the number of independent
+// chains of commands recorded so that with hazard tracking every worker can be
+// kept busy.
+#define IREE_HAL_TASK_BENCHMARK_WORKER_COUNT 8
+
+// Number of commands recorded in each chain.
+#define IREE_HAL_TASK_BENCHMARK_CHAIN_LENGTH 32
+
+// Size of each copy. Kept under the copy slice length so that each command is
+// a single tile and all parallelism must come from overlapping commands.
+#define IREE_HAL_TASK_BENCHMARK_COPY_LENGTH (64 * 1024)
+
+typedef struct iree_hal_task_benchmark_device_t {
+  iree_task_executor_t* executor;
+  iree_hal_allocator_t* device_allocator;
+  iree_hal_device_t* device;
+  iree_hal_semaphore_t* semaphore;
+  uint64_t semaphore_value;
+  // Two buffers per chain that are copied back and forth.
+  iree_hal_buffer_t* buffers[IREE_HAL_TASK_BENCHMARK_WORKER_COUNT * 2];
+} iree_hal_task_benchmark_device_t;
+
+static void iree_hal_task_benchmark_device_initialize(
+    iree_hal_task_barrier_mode_t barrier_mode, bool replay_command_buffers,
+    iree_allocator_t host_allocator,
+    iree_hal_task_benchmark_device_t* out_device) {
+  memset(out_device, 0, sizeof(*out_device));
+
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(
+      IREE_HAL_TASK_BENCHMARK_WORKER_COUNT, &topology);
+  IREE_CHECK_OK(iree_task_executor_create(options, &topology, host_allocator,
+                                          &out_device->executor));
+  iree_task_topology_deinitialize(&topology);
+
+  IREE_CHECK_OK(iree_hal_allocator_create_heap(
+      iree_make_cstring_view("local"), host_allocator, host_allocator,
+      &out_device->device_allocator));
+
+  iree_hal_task_device_params_t params;
+  iree_hal_task_device_params_initialize(&params);
+  params.barrier_mode = barrier_mode;
+  params.replay_command_buffers = replay_command_buffers;
+  IREE_CHECK_OK(iree_hal_task_device_create(
+      iree_make_cstring_view("local-task"), &params, /*queue_count=*/1,
+      &out_device->executor, /*loader_count=*/0, /*loaders=*/NULL,
+      out_device->device_allocator, host_allocator, &out_device->device));
+
+  IREE_CHECK_OK(iree_hal_semaphore_create(
+      out_device->device, IREE_HAL_QUEUE_AFFINITY_ANY, 0ull,
+      IREE_HAL_SEMAPHORE_FLAG_DEFAULT, &out_device->semaphore));
+
+  iree_hal_buffer_params_t buffer_params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
+  };
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(out_device->buffers); ++i) {
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        out_device->device_allocator, buffer_params,
+        IREE_HAL_TASK_BENCHMARK_COPY_LENGTH, &out_device->buffers[i]));
+  }
+}
+
+static void iree_hal_task_benchmark_device_deinitialize(
+    iree_hal_task_benchmark_device_t* device) {
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(device->buffers); ++i) {
+    iree_hal_buffer_release(device->buffers[i]);
+  }
+  iree_hal_semaphore_release(device->semaphore);
+  iree_hal_device_release(device->device);
+  iree_hal_allocator_release(device->device_allocator);
+  iree_task_executor_release(device->executor);
+}
+
+// Records |chain_count| independent chains of copies where each copy depends on
+// the prior one in its chain. Chains are recorded one after the other with a
+// barrier between every command as a conservative compiler would emit. With
+// global barriers this fully serializes execution while with hazard tracking
+// all chains can execute concurrently.
+static void iree_hal_task_benchmark_record(
+    iree_hal_task_benchmark_device_t* device, uint32_t chain_count,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_CHECK_OK(iree_hal_command_buffer_create(
+      device->device,
+      IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+          IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
+      IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+  for (uint32_t chain = 0; chain < chain_count; ++chain) {
+    for (uint32_t i = 0; i < IREE_HAL_TASK_BENCHMARK_CHAIN_LENGTH; ++i) {
+      iree_hal_buffer_t* source_buffer = device->buffers[chain * 2 + (i % 2)];
+      iree_hal_buffer_t* target_buffer =
+          device->buffers[chain * 2 + ((i + 1) % 2)];
+      IREE_CHECK_OK(iree_hal_command_buffer_copy_buffer(
+          command_buffer,
+          iree_hal_make_buffer_ref(source_buffer, 0,
+                                   IREE_HAL_TASK_BENCHMARK_COPY_LENGTH),
+          iree_hal_make_buffer_ref(target_buffer, 0,
+                                   IREE_HAL_TASK_BENCHMARK_COPY_LENGTH),
+          IREE_HAL_COPY_FLAG_NONE));
+      IREE_CHECK_OK(iree_hal_command_buffer_execution_barrier(
+          command_buffer, IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE,
+          IREE_HAL_EXECUTION_STAGE_COMMAND_ISSUE,
+          IREE_HAL_EXECUTION_BARRIER_FLAG_NONE, 0, NULL, 0, NULL));
+    }
+  }
+  IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+  *out_command_buffer = command_buffer;
+}
+
+// Records and executes chains of small copies separated by barriers.
+// Compare the real time of the global and hazard variants: the ratio is the
+// effective number of cores kept busy by hazard tracking.
+//
+// user_data is the iree_hal_task_barrier_mode_t to use.
+static iree_status_t iree_hal_task_command_buffer_benchmark_chains(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_hal_task_barrier_mode_t barrier_mode =
+      (iree_hal_task_barrier_mode_t)(uintptr_t)benchmark_def->user_data;
+  iree_hal_task_benchmark_device_t device;
+  iree_hal_task_benchmark_device_initialize(
+      barrier_mode, /*replay_command_buffers=*/true,
+      benchmark_state->host_allocator, &device);
+
+  const uint32_t chain_count = IREE_HAL_TASK_BENCHMARK_WORKER_COUNT;
+  while (iree_benchmark_keep_running(
+      benchmark_state,
+      /*batch_count=*/chain_count * IREE_HAL_TASK_BENCHMARK_CHAIN_LENGTH)) {
+    iree_hal_command_buffer_t* command_buffer = NULL;
+    iree_hal_task_benchmark_record(&device, chain_count, &command_buffer);
+    uint64_t signal_value = ++device.semaphore_value;
+    iree_hal_semaphore_list_t signal_semaphores = {
+        .count = 1,
+        .semaphores = &device.semaphore,
+        .payload_values = &signal_value,
+    };
+    IREE_CHECK_OK(iree_hal_device_queue_execute(
+        device.device, IREE_HAL_QUEUE_AFFINITY_ANY,
+        iree_hal_semaphore_list_empty(), signal_semaphores, command_buffer,
+        iree_hal_buffer_binding_table_empty(), IREE_HAL_EXECUTE_FLAG_NONE));
+    IREE_CHECK_OK(iree_hal_semaphore_wait(device.semaphore, signal_value,
+                                          iree_infinite_timeout(),
+                                          IREE_HAL_WAIT_FLAG_DEFAULT));
+    iree_hal_command_buffer_release(command_buffer);
+  }
+
+  iree_hal_task_benchmark_device_deinitialize(&device);
+  return iree_ok_status();
+}
+
+// Records a single chain of copies that ping-pong between two binding table
+// slots. The command buffer is recorded once and reused by every execution.
+static void iree_hal_task_benchmark_record_reusable(
+    iree_hal_task_benchmark_device_t* device,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_CHECK_OK(iree_hal_command_buffer_create(
+      device->device, IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED,
+      IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/2, &command_buffer));
+  IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer));
+  for (uint32_t i = 0; i < IREE_HAL_TASK_BENCHMARK_CHAIN_LENGTH; ++i) {
+    IREE_CHECK_OK(iree_hal_command_buffer_copy_buffer(
+        command_buffer,
+        iree_hal_make_indirect_buffer_ref(i % 2, 0,
+                                          IREE_HAL_TASK_BENCHMARK_COPY_LENGTH),
+        iree_hal_make_indirect_buffer_ref((i + 1) % 2, 0,
+                                          IREE_HAL_TASK_BENCHMARK_COPY_LENGTH),
+        IREE_HAL_COPY_FLAG_NONE));
+    IREE_CHECK_OK(iree_hal_command_buffer_execution_barrier(
+        command_buffer, IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE,
+        IREE_HAL_EXECUTION_STAGE_COMMAND_ISSUE,
+        IREE_HAL_EXECUTION_BARRIER_FLAG_NONE, 0, NULL, 0, NULL));
+  }
+  IREE_CHECK_OK(iree_hal_command_buffer_end(command_buffer));
+  *out_command_buffer = command_buffer;
+}
+
+// Executes a reusable command buffer with a different binding table on each
+// iteration as a decode loop would with its per-step buffers. With replay the
+// task graph built at record time is re-armed in place; without it every
+// execution re-records the commands into freshly allocated tasks.
+//
+// user_data is nonzero if command buffer replay is enabled.
+static iree_status_t iree_hal_task_command_buffer_benchmark_replay(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const bool replay_command_buffers = benchmark_def->user_data != NULL;
+  iree_hal_task_benchmark_device_t device;
+  iree_hal_task_benchmark_device_initialize(
+      IREE_HAL_TASK_BARRIER_MODE_GLOBAL, replay_command_buffers,
+      benchmark_state->host_allocator, &device);
+
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  iree_hal_task_benchmark_record_reusable(&device, &command_buffer);
+
+  uint32_t step = 0;
+  while (iree_benchmark_keep_running(
+      benchmark_state, /*batch_count=*/IREE_HAL_TASK_BENCHMARK_CHAIN_LENGTH)) {
+    // Rotate through the buffer pairs so each step binds different buffers.
+    const uint32_t pair = step++ % IREE_HAL_TASK_BENCHMARK_WORKER_COUNT;
+    const iree_hal_buffer_binding_t bindings[2] = {
+        {device.buffers[pair * 2 + 0], 0, IREE_HAL_WHOLE_BUFFER},
+        {device.buffers[pair * 2 + 1], 0, IREE_HAL_WHOLE_BUFFER},
+    };
+    const iree_hal_buffer_binding_table_t binding_table = {
+        .count = IREE_ARRAYSIZE(bindings),
+        .bindings = bindings,
+    };
+    uint64_t signal_value = ++device.semaphore_value;
+    iree_hal_semaphore_list_t signal_semaphores = {
+        .count = 1,
+        .semaphores = &device.semaphore,
+        .payload_values = &signal_value,
+    };
+    IREE_CHECK_OK(iree_hal_device_queue_execute(
+        device.device, IREE_HAL_QUEUE_AFFINITY_ANY,
+        iree_hal_semaphore_list_empty(), signal_semaphores, command_buffer,
+        binding_table, IREE_HAL_EXECUTE_FLAG_NONE));
+    IREE_CHECK_OK(iree_hal_semaphore_wait(device.semaphore, signal_value,
+                                          iree_infinite_timeout(),
+                                          IREE_HAL_WAIT_FLAG_DEFAULT));
+  }
+
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_task_benchmark_device_deinitialize(&device);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_hal_task_command_buffer_benchmark_chains
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_MICROSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_task_command_buffer_benchmark_chains,
+    };
+    benchmark_def.user_data = (void*)IREE_HAL_TASK_BARRIER_MODE_GLOBAL;
+    iree_benchmark_register(iree_make_cstring_view("chains_global"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)IREE_HAL_TASK_BARRIER_MODE_HAZARD_TRACKING;
+    iree_benchmark_register(iree_make_cstring_view("chains_hazard_tracking"),
+                            &benchmark_def);
+  }
+
+  // iree_hal_task_command_buffer_benchmark_replay
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_MICROSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_task_command_buffer_benchmark_replay,
+    };
+    benchmark_def.user_data = (void*)1;
+    iree_benchmark_register(iree_make_cstring_view("reusable_replay"),
+                            &benchmark_def);
+    benchmark_def.user_data = NULL;
+    iree_benchmark_register(iree_make_cstring_view("reusable_rerecord"),
+                            &benchmark_def);
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
@@ -0,0 +1,552 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_command_buffer.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/arena.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_task/task_device.h"
+#include "iree/hal/drivers/local_task/task_queue.h"
+#include "iree/task/executor.h"
+#include "iree/task/scope.h"
+#include "iree/task/submission.h"
+#include "iree/task/topology.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Large enough that fills and copies are split into several tiles so that
+// commands that are not ordered correctly are likely to interleave.
+constexpr iree_device_size_t kBufferLength = 1024 * 1024;
+constexpr iree_device_size_t kQuarterLength = kBufferLength / 4;
+
+// Number of times each command buffer is recorded and executed.
+constexpr int kIterationCount = 16;
+
+// Creates a local-task device and buffers for recording command buffers.
+class TaskCommandBufferTestBase : public ::testing::Test {
+ protected:
+  void CreateDevice(iree_hal_task_barrier_mode_t barrier_mode,
+                    bool replay_command_buffers) {
+    iree_allocator_t host_allocator = iree_allocator_system();
+
+    iree_task_executor_options_t options;
+    iree_task_executor_options_initialize(&options);
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(4, &topology);
+    IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                             host_allocator, &executor_));
+    iree_task_topology_deinitialize(&topology);
+
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("local"), host_allocator, host_allocator,
+        &device_allocator_));
+
+    iree_hal_task_device_params_t params;
+    iree_hal_task_device_params_initialize(&params);
+    params.barrier_mode = barrier_mode;
+    params.replay_command_buffers = replay_command_buffers;
+    IREE_ASSERT_OK(iree_hal_task_device_create(
+        iree_make_cstring_view("local-task"), &params, /*queue_count=*/1,
+        &executor_, /*loader_count=*/0, /*loaders=*/NULL, device_allocator_,
+        host_allocator, &device_));
+
+    IREE_ASSERT_OK(iree_hal_semaphore_create(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, 0ull,
+        IREE_HAL_SEMAPHORE_FLAG_DEFAULT, &semaphore_));
+
+    iree_hal_buffer_params_t buffer_params = {0};
+    buffer_params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    buffer_params.usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+                          IREE_HAL_BUFFER_USAGE_TRANSFER |
+                          IREE_HAL_BUFFER_USAGE_MAPPING;
+    IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_, buffer_params, kBufferLength, &buffer_a_));
+    IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_, buffer_params, kBufferLength, &buffer_b_));
+  }
+
+  void TearDown() override {
+    iree_hal_buffer_release(buffer_b_);
+    iree_hal_buffer_release(buffer_a_);
+    iree_hal_semaphore_release(semaphore_);
+    iree_hal_device_release(device_);
+    iree_hal_allocator_release(device_allocator_);
+    iree_task_executor_release(executor_);
+  }
+
+  // Resets |buffer| to all zeros from the host.
+  void ZeroBuffer(iree_hal_buffer_t* buffer) {
+    IREE_ASSERT_OK(iree_hal_buffer_map_zero(buffer, 0, IREE_HAL_WHOLE_BUFFER));
+  }
+
+  // Records a one-shot command buffer with |record|, executes it with |flags|
+  // and waits for it to complete.
+  void RecordAndExecute(
+      std::function<void(iree_hal_command_buffer_t*)> record,
+      iree_hal_execute_flags_t flags = IREE_HAL_EXECUTE_FLAG_NONE) {
+    iree_hal_command_buffer_t* command_buffer = NULL;
+    IREE_ASSERT_OK(iree_hal_command_buffer_create(
+        device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+        IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+        /*binding_capacity=*/0, &command_buffer));
+    IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+    record(command_buffer);
+    IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+    uint64_t signal_value = ++semaphore_value_;
+    iree_hal_semaphore_list_t signal_semaphores = {
+        /*count=*/1,
+        /*semaphores=*/&semaphore_,
+        /*payload_values=*/&signal_value,
+    };
+    IREE_ASSERT_OK(iree_hal_device_queue_execute(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_semaphores, command_buffer,
+        iree_hal_buffer_binding_table_empty(), flags));
+    IREE_ASSERT_OK(iree_hal_semaphore_wait(semaphore_, signal_value,
+                                           iree_infinite_timeout(),
+                                           IREE_HAL_WAIT_FLAG_DEFAULT));
+    iree_hal_command_buffer_release(command_buffer);
+  }
+
+  // Returns the number of uint32_t elements of |buffer| in
+  // [offset, offset + length) that are not |value|.
+  size_t CountMismatches(iree_hal_buffer_t* buffer, iree_device_size_t offset,
+                         iree_device_size_t length, uint32_t value) {
+    std::vector<uint32_t> data(length / sizeof(uint32_t));
+    IREE_CHECK_OK(iree_hal_buffer_map_read(buffer, offset, data.data(),
+                                           data.size() * sizeof(uint32_t)));
+    size_t mismatch_count = 0;
+    for (uint32_t element : data) {
+      if (element != value) ++mismatch_count;
+    }
+    return mismatch_count;
+  }
+
+  iree_task_executor_t* executor_ = NULL;
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_hal_semaphore_t* semaphore_ = NULL;
+  uint64_t semaphore_value_ = 0;
+  iree_hal_buffer_t* buffer_a_ = NULL;
+  iree_hal_buffer_t* buffer_b_ = NULL;
+};
+
+// Records commands into a command buffer with the device configured to use
+// the barrier mode the test is parameterized on. Every command is separated
+// by a barrier and the tests check that the commands observe each other's
+// results when they access overlapping ranges.
+class TaskCommandBufferTest
+    : public TaskCommandBufferTestBase,
+      public ::testing::WithParamInterface<iree_hal_task_barrier_mode_t> {
+ protected:
+  void SetUp() override {
+    CreateDevice(GetParam(), /*replay_command_buffers=*/false);
+  }
+};
+
+static void Fill(iree_hal_command_buffer_t* command_buffer,
+                 iree_hal_buffer_t* buffer, iree_device_size_t offset,
+                 iree_device_size_t length, uint32_t value) {
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, iree_hal_make_buffer_ref(buffer, offset, length), &value,
+      sizeof(value), IREE_HAL_FILL_FLAG_NONE));
+}
+
+static void Copy(iree_hal_command_buffer_t* command_buffer,
+                 iree_hal_buffer_t* source_buffer,
+                 iree_device_size_t source_offset,
+                 iree_hal_buffer_t* target_buffer,
+                 iree_device_size_t target_offset, iree_device_size_t length) {
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      command_buffer,
+      iree_hal_make_buffer_ref(source_buffer, source_offset, length),
+      iree_hal_make_buffer_ref(target_buffer, target_offset, length),
+      IREE_HAL_COPY_FLAG_NONE));
+}
+
+static void Barrier(iree_hal_command_buffer_t* command_buffer) {
+  IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+      command_buffer, IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE,
+      IREE_HAL_EXECUTION_STAGE_COMMAND_ISSUE,
+      IREE_HAL_EXECUTION_BARRIER_FLAG_NONE, 0, NULL, 0, NULL));
+}
+
+// A copy reading a range must observe the fill that wrote it.
+TEST_P(TaskCommandBufferTest, ReadAfterWrite) {
+  for (int i = 0; i < kIterationCount; ++i) {
+    ZeroBuffer(buffer_a_);
+    ZeroBuffer(buffer_b_);
+    RecordAndExecute([&](iree_hal_command_buffer_t* command_buffer) {
+      Fill(command_buffer, buffer_a_, 0, kBufferLength, 1);
+      Barrier(command_buffer);
+      Copy(command_buffer, buffer_a_, 0, buffer_b_, 0, kBufferLength);
+    });
+    EXPECT_EQ(CountMismatches(buffer_b_, 0, kBufferLength, 1u), 0u);
+  }
+}
+
+// A fill overwriting a range must wait for the copy reading it.
+TEST_P(TaskCommandBufferTest, WriteAfterRead) {
+  for (int i = 0; i < kIterationCount; ++i) {
+    ZeroBuffer(buffer_b_);
+    uint32_t value = 1;
+    IREE_ASSERT_OK(iree_hal_buffer_map_fill(buffer_a_, 0, kBufferLength,
+                                            &value, sizeof(value)));
+    RecordAndExecute([&](iree_hal_command_buffer_t* command_buffer) {
+      Copy(command_buffer, buffer_a_, 0, buffer_b_, 0, kBufferLength);
+      Barrier(command_buffer);
+      Fill(command_buffer, buffer_a_, 0, kBufferLength, 2);
+    });
+    EXPECT_EQ(CountMismatches(buffer_b_, 0, kBufferLength, 1u), 0u);
+    EXPECT_EQ(CountMismatches(buffer_a_, 0, kBufferLength, 2u), 0u);
+  }
+}
+
+// Partially overlapping writes must land in recording order.
+TEST_P(TaskCommandBufferTest, WriteAfterWrite) {
+  for (int i = 0; i < kIterationCount; ++i) {
+    ZeroBuffer(buffer_a_);
+    RecordAndExecute([&](iree_hal_command_buffer_t* command_buffer) {
+      Fill(command_buffer, buffer_a_, 0, kQuarterLength * 3, 1);
+      Barrier(command_buffer);
+      Fill(command_buffer, buffer_a_, kQuarterLength, kQuarterLength * 3, 2);
+    });
+    EXPECT_EQ(CountMismatches(buffer_a_, 0, kQuarterLength, 1u), 0u);
+    EXPECT_EQ(
+        CountMismatches(buffer_a_, kQuarterLength, kQuarterLength * 3, 2u),
+        0u);
+  }
+}
+
+// Fills and copies touching partially overlapping ranges of the same buffers:
+//   fill A[0, 2q) = 1
+//   copy A[q, 3q) -> B[0, 2q)   (reads the tail of the fill: RAW)
+//   fill A[2q, 4q) = 3          (overwrites the tail of the copy source: WAR)
+//   fill B[q, 2q) = 4           (overwrites the tail of the copy target: WAW)
+TEST_P(TaskCommandBufferTest, FillCopyOverlappingRanges) {
+  for (int i = 0; i < kIterationCount; ++i) {
+    ZeroBuffer(buffer_a_);
+    ZeroBuffer(buffer_b_);
+    RecordAndExecute([&](iree_hal_command_buffer_t* command_buffer) {
+      Fill(command_buffer, buffer_a_, 0, kQuarterLength * 2, 1);
+      Barrier(command_buffer);
+      Copy(command_buffer, buffer_a_, kQuarterLength, buffer_b_, 0,
+           kQuarterLength * 2);
+      Barrier(command_buffer);
+      Fill(command_buffer, buffer_a_, kQuarterLength * 2, kQuarterLength * 2,
+           3);
+      Barrier(command_buffer);
+      Fill(command_buffer, buffer_b_, kQuarterLength, kQuarterLength, 4);
+    });
+    EXPECT_EQ(CountMismatches(buffer_a_, 0, kQuarterLength * 2, 1u), 0u);
+    EXPECT_EQ(CountMismatches(buffer_a_, kQuarterLength * 2,
+                              kQuarterLength * 2, 3u),
+              0u);
+    EXPECT_EQ(CountMismatches(buffer_b_, 0, kQuarterLength, 1u), 0u);
+    EXPECT_EQ(CountMismatches(buffer_b_, kQuarterLength, kQuarterLength, 4u),
+              0u);
+    EXPECT_EQ(CountMismatches(buffer_b_, kQuarterLength * 2,
+                              kQuarterLength * 2, 0u),
+              0u);
+  }
+}
+
+// Commands on disjoint ranges separated by barriers all complete.
+TEST_P(TaskCommandBufferTest, DisjointRanges) {
+  for (int i = 0; i < kIterationCount; ++i) {
+    ZeroBuffer(buffer_a_);
+    RecordAndExecute([&](iree_hal_command_buffer_t* command_buffer) {
+      for (uint32_t j = 0; j < 4; ++j) {
+        Fill(command_buffer, buffer_a_, kQuarterLength * j, kQuarterLength,
+             j + 1);
+        Barrier(command_buffer);
+      }
+    });
+    for (uint32_t j = 0; j < 4; ++j) {
+      EXPECT_EQ(CountMismatches(buffer_a_, kQuarterLength * j, kQuarterLength,
+                                j + 1),
+                0u);
+    }
+  }
+}
+
+// Command buffers execute correctly with each priority hint. The tasks of the
+// command buffer inherit the class from its roots.
+TEST_P(TaskCommandBufferTest, PriorityHints) {
+  const iree_hal_execute_flags_t kFlags[] = {
+      IREE_HAL_EXECUTE_FLAG_PRIORITY_HIGH,
+      IREE_HAL_EXECUTE_FLAG_PRIORITY_LOW,
+      IREE_HAL_EXECUTE_FLAG_PRIORITY_HIGH | IREE_HAL_EXECUTE_FLAG_PRIORITY_LOW,
+  };
+  for (iree_hal_execute_flags_t flags : kFlags) {
+    ZeroBuffer(buffer_a_);
+    ZeroBuffer(buffer_b_);
+    RecordAndExecute(
+        [&](iree_hal_command_buffer_t* command_buffer) {
+          Fill(command_buffer, buffer_a_, 0, kBufferLength, 1);
+          Barrier(command_buffer);
+          Copy(command_buffer, buffer_a_, 0, buffer_b_, 0, kBufferLength);
+        },
+        flags);
+    EXPECT_EQ(CountMismatches(buffer_b_, 0, kBufferLength, 1u), 0u);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    BarrierModes, TaskCommandBufferTest,
+    ::testing::Values(IREE_HAL_TASK_BARRIER_MODE_GLOBAL,
+                      IREE_HAL_TASK_BARRIER_MODE_HAZARD_TRACKING),
+    [](const ::testing::TestParamInfo<iree_hal_task_barrier_mode_t>& info) {
+      return info.param == IREE_HAL_TASK_BARRIER_MODE_GLOBAL
+                 ? "Global"
+                 : "HazardTracking";
+    });
+
+// Records reusable command buffers into task DAGs that are replayed on each
+// submission with the binding table provided.
+class TaskCommandBufferReplayTest : public TaskCommandBufferTestBase {
+ protected:
+  void SetUp() override {
+    CreateDevice(IREE_HAL_TASK_BARRIER_MODE_GLOBAL,
+                 /*replay_command_buffers=*/true);
+    iree_task_scope_initialize(iree_make_cstring_view("replay"),
+                               IREE_TASK_SCOPE_FLAG_NONE, &scope_);
+    iree_arena_block_pool_initialize(32 * 1024, iree_allocator_system(),
+                                     &block_pool_);
+  }
+
+  void TearDown() override {
+    iree_arena_block_pool_deinitialize(&block_pool_);
+    iree_task_scope_deinitialize(&scope_);
+    TaskCommandBufferTestBase::TearDown();
+  }
+
+  // Records commands into |command_buffer| that fill binding table slot 0
+  // with |value| and then copy it to slot 1.
+  static void RecordFillCopy(iree_hal_command_buffer_t* command_buffer,
+                             uint32_t value) {
+    IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+    IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+        command_buffer,
+        iree_hal_make_indirect_buffer_ref(/*buffer_slot=*/0, 0, kBufferLength),
+        &value, sizeof(value), IREE_HAL_FILL_FLAG_NONE));
+    Barrier(command_buffer);
+    IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+        command_buffer,
+        iree_hal_make_indirect_buffer_ref(/*buffer_slot=*/0, 0, kBufferLength),
+        iree_hal_make_indirect_buffer_ref(/*buffer_slot=*/1, 0, kBufferLength),
+        IREE_HAL_COPY_FLAG_NONE));
+    IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  }
+
+  // Executes |command_buffer| on the device with |bindings| as the binding
+  // table and waits for it to complete.
+  void Execute(iree_hal_command_buffer_t* command_buffer,
+               std::vector<iree_hal_buffer_binding_t> bindings) {
+    uint64_t signal_value = ++semaphore_value_;
+    iree_hal_semaphore_list_t signal_semaphores = {
+        /*count=*/1,
+        /*semaphores=*/&semaphore_,
+        /*payload_values=*/&signal_value,
+    };
+    iree_hal_buffer_binding_table_t binding_table = {bindings.size(),
+                                                     bindings.data()};
+    IREE_ASSERT_OK(iree_hal_device_queue_execute(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_semaphores, command_buffer, binding_table,
+        IREE_HAL_EXECUTE_FLAG_NONE));
+    IREE_ASSERT_OK(iree_hal_semaphore_wait(semaphore_, signal_value,
+                                           iree_infinite_timeout(),
+                                           IREE_HAL_WAIT_FLAG_DEFAULT));
+  }
+
+  // Issues the DAG of |command_buffer| with |bindings| as the binding table
+  // directly, bypassing the validation performed by the HAL when submitted to
+  // a device, and returns the status code of resolving the bindings. Failures
+  // must leave the DAG available for replay and issue no tasks.
+  iree_status_code_t IssueInvalid(iree_hal_command_buffer_t* command_buffer,
+                             std::vector<iree_hal_buffer_binding_t> bindings) {
+    EXPECT_TRUE(iree_hal_task_command_buffer_acquire(command_buffer, &scope_));
+    iree_arena_allocator_t arena;
+    iree_arena_initialize(&block_pool_, &arena);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_hal_buffer_binding_table_t binding_table = {bindings.size(),
+                                                     bindings.data()};
+    iree_status_t status = iree_hal_task_command_buffer_issue(
+        command_buffer, /*queue_state=*/NULL, /*retire_task=*/NULL,
+        IREE_TASK_PRIORITY_NORMAL, binding_table, &arena, &submission);
+    EXPECT_TRUE(iree_task_submission_is_empty(&submission));
+    iree_arena_deinitialize(&arena);
+    return iree_status_consume_code(status);
+  }
+
+  // Returns a host buffer with the given |access| and |usage|. Buffers
+  // allocated from the heap allocator always allow transfers.
+  static iree_hal_buffer_t* WrapHostBuffer(iree_hal_memory_access_t access,
+                                           iree_hal_buffer_usage_t usage) {
+    void* data = NULL;
+    IREE_CHECK_OK(iree_allocator_malloc_aligned(
+        iree_allocator_system(), kBufferLength,
+        IREE_HAL_HEAP_BUFFER_ALIGNMENT, 0, &data));
+    iree_hal_buffer_release_callback_t release_callback = {
+        +[](void* user_data, iree_hal_buffer_t* buffer) {
+          iree_allocator_free_aligned(iree_allocator_system(), user_data);
+        },
+        data,
+    };
+    iree_hal_buffer_placement_t placement = {0};
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_heap_buffer_wrap(
+        placement,
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+        access, usage, kBufferLength,
+        iree_make_byte_span(data, kBufferLength), release_callback,
+        iree_allocator_system(), &buffer));
+    return buffer;
+  }
+
+  static iree_hal_buffer_binding_t Bind(
+      iree_hal_buffer_t* buffer, iree_device_size_t offset = 0,
+      iree_device_size_t length = IREE_HAL_WHOLE_BUFFER) {
+    iree_hal_buffer_binding_t binding = {buffer, offset, length};
+    return binding;
+  }
+
+  iree_task_scope_t scope_;
+  iree_arena_block_pool_t block_pool_;
+};
+
+// Each replay of the DAG resolves the references against the binding table
+// of that submission.
+TEST_F(TaskCommandBufferReplayTest, ReplayWithBindingTables) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_DEFAULT,
+      IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/2, &command_buffer));
+  EXPECT_TRUE(iree_hal_task_command_buffer_isa(command_buffer));
+  RecordFillCopy(command_buffer, 1);
+  for (int i = 0; i < kIterationCount; ++i) {
+    ZeroBuffer(buffer_a_);
+    ZeroBuffer(buffer_b_);
+    iree_hal_buffer_t* source = (i % 2) ? buffer_a_ : buffer_b_;
+    iree_hal_buffer_t* target = (i % 2) ? buffer_b_ : buffer_a_;
+    Execute(command_buffer, {Bind(source), Bind(target)});
+    EXPECT_EQ(CountMismatches(target, 0, kBufferLength, 1u), 0u);
+  }
+  iree_hal_command_buffer_release(command_buffer);
+}
+
+// Bindings with offsets into a larger buffer are resolved relative to them.
+TEST_F(TaskCommandBufferReplayTest, ReplayWithBindingOffsets) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_DEFAULT,
+      IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/2, &command_buffer));
+  RecordFillCopy(command_buffer, 2);
+  iree_hal_buffer_params_t buffer_params = {0};
+  buffer_params.type =
+      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+  buffer_params.usage =
+      IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator_, buffer_params, kBufferLength * 2, &buffer));
+  for (int i = 0; i < 2; ++i) {
+    ZeroBuffer(buffer);
+    iree_device_size_t source_offset = i ? 0 : kBufferLength;
+    iree_device_size_t target_offset = i ? kBufferLength : 0;
+    Execute(command_buffer, {Bind(buffer, source_offset, kBufferLength),
+                             Bind(buffer, target_offset, kBufferLength)});
+    EXPECT_EQ(CountMismatches(buffer, 0, kBufferLength * 2, 2u), 0u);
+  }
+  iree_hal_buffer_release(buffer);
+  iree_hal_command_buffer_release(command_buffer);
+}
+
+// Binding tables that do not satisfy the requirements of the commands fail
+// to issue with the same errors as validation of the commands would produce.
+TEST_F(TaskCommandBufferReplayTest, InvalidBindingTables) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_task_command_buffer_create(
+      device_allocator_, &scope_, IREE_HAL_TASK_BARRIER_MODE_GLOBAL,
+      IREE_HAL_COMMAND_BUFFER_MODE_DEFAULT, IREE_HAL_COMMAND_CATEGORY_ANY,
+      IREE_HAL_QUEUE_AFFINITY_ANY, /*binding_capacity=*/2, &block_pool_,
+      iree_allocator_system(), &command_buffer));
+  RecordFillCopy(command_buffer, 3);
+
+  // Missing buffer.
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            IssueInvalid(command_buffer, {Bind(buffer_a_), Bind(NULL)}));
+
+  // Slot beyond the end of the binding table.
+  EXPECT_EQ(IREE_STATUS_OUT_OF_RANGE,
+            IssueInvalid(command_buffer, {Bind(buffer_a_)}));
+
+  // Binding range smaller than the range accessed by the commands.
+  EXPECT_EQ(IREE_STATUS_OUT_OF_RANGE,
+            IssueInvalid(command_buffer, {Bind(buffer_a_),
+                                          Bind(buffer_b_, 0, kQuarterLength)}));
+
+  // Binding range extending past the end of the buffer.
+  EXPECT_EQ(IREE_STATUS_OUT_OF_RANGE,
+            IssueInvalid(command_buffer,
+                         {Bind(buffer_a_, kQuarterLength, kBufferLength),
+                          Bind(buffer_b_)}));
+
+  // Buffer not allowing the transfer usage of the commands.
+  iree_hal_buffer_t* storage_buffer = WrapHostBuffer(
+      IREE_HAL_MEMORY_ACCESS_ALL,
+      IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE | IREE_HAL_BUFFER_USAGE_MAPPING);
+  EXPECT_EQ(
+      IREE_STATUS_PERMISSION_DENIED,
+      IssueInvalid(command_buffer, {Bind(storage_buffer), Bind(buffer_b_)}));
+  iree_hal_buffer_release(storage_buffer);
+
+  // Read-only buffer as the target of the commands.
+  iree_hal_buffer_t* read_only_buffer = WrapHostBuffer(
+      IREE_HAL_MEMORY_ACCESS_READ,
+      IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING);
+  EXPECT_EQ(
+      IREE_STATUS_PERMISSION_DENIED,
+      IssueInvalid(command_buffer, {Bind(buffer_a_), Bind(read_only_buffer)}));
+  iree_hal_buffer_release(read_only_buffer);
+
+  // None of the failures left the DAG in-flight.
+  EXPECT_TRUE(iree_hal_task_command_buffer_acquire(command_buffer, &scope_));
+
+  iree_hal_command_buffer_release(command_buffer);
+}
+
+TEST(TaskQueuePriorityTest, ExecuteFlags) {
+  EXPECT_EQ(iree_hal_task_queue_priority_from_execute_flags(
+                IREE_HAL_EXECUTE_FLAG_NONE),
+            IREE_TASK_PRIORITY_NORMAL);
+  EXPECT_EQ(iree_hal_task_queue_priority_from_execute_flags(
+                IREE_HAL_EXECUTE_FLAG_PRIORITY_HIGH),
+            IREE_TASK_PRIORITY_HIGH);
+  EXPECT_EQ(iree_hal_task_queue_priority_from_execute_flags(
+                IREE_HAL_EXECUTE_FLAG_PRIORITY_LOW),
+            IREE_TASK_PRIORITY_LOW);
+  // High priority wins when both hints are set.
+  EXPECT_EQ(iree_hal_task_queue_priority_from_execute_flags(
+                IREE_HAL_EXECUTE_FLAG_PRIORITY_HIGH |
+                IREE_HAL_EXECUTE_FLAG_PRIORITY_LOW),
+            IREE_TASK_PRIORITY_HIGH);
+}
+
+}  // namespace
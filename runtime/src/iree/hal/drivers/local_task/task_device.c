@@ -12,6 +12,7 @@
 
 #include "iree/base/internal/arena.h"
 #include "iree/base/internal/cpu.h"
+#include "iree/base/internal/memory.h"
 #include "iree/hal/drivers/local_task/task_command_buffer.h"
 #include "iree/hal/drivers/local_task/task_event.h"
 #include "iree/hal/drivers/local_task/task_queue.h"
@@ -43,6 +44,22 @@ typedef struct iree_hal_task_device_t {
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
+  // Optional pool of host threads used to stage streaming file transfers.
+  iree_hal_file_transfer_pool_t* file_transfer_pool;
+
+  // Whether imported fd-backed files prefer io_uring.
+  bool file_io_uring;
+
+  // Whether reusable command buffers replay a prebuilt task DAG.
+  bool replay_command_buffers;
+
+  // Queues that are candidates for routing by the NUMA node of the caller.
+  // Empty if routing is disabled or all queues are on the same node.
+  iree_hal_queue_affinity_t numa_queue_mask;
+
+  // Whether queue-ordered allocations default to the affinity of the queue.
+  bool numa_buffer_placement;
+
   iree_host_size_t queue_count;
   iree_hal_task_queue_t queues[];
 } iree_hal_task_device_t;
@@ -59,6 +76,12 @@ void iree_hal_task_device_params_initialize(
     iree_hal_task_device_params_t* out_params) {
   out_params->arena_block_size = 32 * 1024;
   out_params->queue_scope_flags = IREE_TASK_SCOPE_FLAG_NONE;
+  out_params->barrier_mode = IREE_HAL_TASK_BARRIER_MODE_GLOBAL;
+  out_params->file_transfer_thread_count = 1;
+  out_params->file_io_uring = false;
+  out_params->numa_queue_routing = false;
+  out_params->numa_buffer_placement = false;
+  out_params->replay_command_buffers = false;
 }
 
 static iree_status_t iree_hal_task_device_check_params(
@@ -115,6 +138,9 @@ iree_status_t iree_hal_task_device_create(
     device->host_allocator = host_allocator;
     device->device_allocator = device_allocator;
     iree_hal_allocator_retain(device_allocator);
+    device->file_io_uring = params->file_io_uring;
+    device->replay_command_buffers = params->replay_command_buffers;
+    device->numa_buffer_placement = params->numa_buffer_placement;
 
     iree_arena_block_pool_initialize(4096, host_allocator,
                                      &device->small_block_pool);
@@ -136,10 +162,32 @@ iree_status_t iree_hal_task_device_create(
       iree_hal_queue_affinity_t queue_affinity = 1ull << i;
       iree_hal_task_queue_initialize(
           device->identifier, queue_affinity, params->queue_scope_flags,
-          queue_executors[i], &device->small_block_pool,
+          params->barrier_mode, queue_executors[i], &device->small_block_pool,
           &device->large_block_pool, device->device_allocator,
           &device->queues[i]);
     }
+
+    // Routing is only useful if there are queues on different nodes.
+    if (params->numa_queue_routing) {
+      uint32_t first_node = IREE_MEMORY_NODE_ID_ANY;
+      bool multiple_nodes = false;
+      for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+        const uint32_t memory_node = device->queues[i].memory_node;
+        if (memory_node == IREE_MEMORY_NODE_ID_ANY) continue;
+        if (first_node == IREE_MEMORY_NODE_ID_ANY) first_node = memory_node;
+        multiple_nodes |= memory_node != first_node;
+        device->numa_queue_mask |= 1ull << i;
+      }
+      if (!multiple_nodes) device->numa_queue_mask = 0;
+    }
+  }
+
+  // Threads staging file transfers are created once and reused by all
+  // transfers on the device.
+  if (iree_status_is_ok(status) && params->file_transfer_thread_count > 1) {
+    status = iree_hal_file_transfer_pool_create(
+        params->file_transfer_thread_count, host_allocator,
+        &device->file_transfer_pool);
   }
 
   if (iree_status_is_ok(status)) {
@@ -156,6 +204,8 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
   iree_allocator_t host_allocator = iree_hal_device_host_allocator(base_device);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_file_transfer_pool_free(device->file_transfer_pool);
+
   for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
     iree_hal_task_queue_deinitialize(&device->queues[i]);
   }
@@ -280,6 +330,21 @@ static iree_host_size_t iree_hal_task_device_select_queue(
   // TODO(benvanik): evaluate if we want to obscure this mapping a bit so that
   // affinity really means "equivalent affinities map to equivalent queues" and
   // not a specific queue index.
+
+  // If the caller allows multiple queues on different NUMA nodes prefer the
+  // one on the node the caller is running on. Tasks issued and transient
+  // memory first touched by the queue then stay local to the caller.
+  iree_hal_queue_affinity_t node_candidates = queue_affinity;
+  iree_hal_queue_affinity_and_into(node_candidates, device->numa_queue_mask);
+  if (iree_hal_queue_affinity_count(node_candidates) > 1) {
+    const uint32_t memory_node = iree_memory_query_current_node();
+    IREE_HAL_FOR_QUEUE_AFFINITY(node_candidates) {
+      if (device->queues[queue_ordinal].memory_node == memory_node) {
+        return queue_ordinal;
+      }
+    }
+  }
+
   return queue_affinity % device->queue_count;
 }
 
@@ -296,13 +361,11 @@ static iree_status_t iree_hal_task_device_create_command_buffer(
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
-  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT) ||
-      binding_capacity > 0) {
-    // TODO(indirect-cmd): natively support reusable task command buffers. For
-    // now we emulate by recording into a deferred command buffer and
-    // recording/issuing at submission time. The task system needs some
-    // reworking to support being able to resubmit task graphs as today it is
-    // destructive.
+  if (!device->replay_command_buffers &&
+      (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT) ||
+       binding_capacity > 0)) {
+    // Record into a deferred command buffer and record a new task DAG from it
+    // each time it is submitted.
     return iree_hal_deferred_command_buffer_create(
         iree_hal_device_allocator(base_device), mode, command_categories,
         queue_affinity, binding_capacity, &device->large_block_pool,
@@ -312,7 +375,8 @@ static iree_status_t iree_hal_task_device_create_command_buffer(
         device, command_categories, queue_affinity);
     return iree_hal_task_command_buffer_create(
         iree_hal_device_allocator(base_device),
-        &device->queues[queue_index].scope, mode, command_categories,
+        &device->queues[queue_index].scope,
+        device->queues[queue_index].barrier_mode, mode, command_categories,
         queue_affinity, binding_capacity, &device->large_block_pool,
         device->host_allocator, out_command_buffer);
   }
@@ -348,8 +412,11 @@ static iree_status_t iree_hal_task_device_import_file(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
     iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
-  return iree_hal_file_from_handle(
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  return iree_hal_file_from_handle_with_flags(
       iree_hal_device_allocator(base_device), queue_affinity, access, handle,
+      device->file_io_uring ? IREE_HAL_FILE_FROM_HANDLE_FLAG_PREFER_IO_URING
+                            : IREE_HAL_FILE_FROM_HANDLE_FLAG_NONE,
       iree_hal_device_host_allocator(base_device), out_file);
 }
 
@@ -389,6 +456,13 @@ static iree_status_t iree_hal_task_device_queue_alloca(
   IREE_RETURN_IF_ERROR(
       iree_hal_semaphore_list_wait(wait_semaphore_list, iree_infinite_timeout(),
                                    IREE_HAL_WAIT_FLAG_DEFAULT));
+  // Place the buffer near the queue it is allocated on unless requested
+  // otherwise.
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  if (device->numa_buffer_placement &&
+      iree_hal_queue_affinity_is_empty(params.queue_affinity)) {
+    params.queue_affinity = queue_affinity;
+  }
   IREE_RETURN_IF_ERROR(
       iree_hal_allocator_allocate_buffer(iree_hal_device_allocator(base_device),
                                          params, allocation_size, out_buffer));
@@ -416,11 +490,13 @@ static iree_status_t iree_hal_task_device_queue_read(
     iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
     iree_device_size_t length, iree_hal_read_flags_t flags) {
   // TODO: expose streaming chunk count/size options.
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
   iree_status_t loop_status = iree_ok_status();
   iree_hal_file_transfer_options_t options = {
       .loop = iree_loop_inline(&loop_status),
       .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
       .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
+      .pool = device->file_transfer_pool,
   };
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_read_streaming(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
@@ -437,11 +513,13 @@ static iree_status_t iree_hal_task_device_queue_write(
     iree_hal_file_t* target_file, uint64_t target_offset,
     iree_device_size_t length, iree_hal_write_flags_t flags) {
   // TODO: expose streaming chunk count/size options.
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
   iree_status_t loop_status = iree_ok_status();
   iree_hal_file_transfer_options_t options = {
       .loop = iree_loop_inline(&loop_status),
       .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
       .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
+      .pool = device->file_transfer_pool,
   };
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_write_streaming(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
@@ -486,6 +564,7 @@ static iree_status_t iree_hal_task_device_queue_execute(
       .signal_semaphores = signal_semaphore_list,
       .command_buffer = command_buffer,
       .binding_table = binding_table,
+      .priority = iree_hal_task_queue_priority_from_execute_flags(flags),
   };
   return iree_hal_task_queue_submit_commands(&device->queues[queue_index], 1,
                                              &batch);
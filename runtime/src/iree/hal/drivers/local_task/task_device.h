@@ -9,6 +9,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/drivers/local_task/task_command_buffer.h"
 #include "iree/hal/local/executable_loader.h"
 #include "iree/task/executor.h"
 
@@ -25,6 +26,33 @@ typedef struct iree_hal_task_device_params_t {
   iree_host_size_t arena_block_size;
   // Default flags for the iree_task_scope_t used for each queue.
   iree_task_scope_flags_t queue_scope_flags;
+  // Controls how command buffer barriers are lowered into the task DAG.
+  // Hazard tracking allows independent commands separated by barriers to
+  // execute concurrently at the cost of slightly more expensive recording.
+  // Defaults to global barriers.
+  iree_hal_task_barrier_mode_t barrier_mode;
+  // Number of host threads used to stage large file reads and writes.
+  // Each thread double-buffers its chunks so that file I/O overlaps with the
+  // copies performed by the queue. The threads are created with the device
+  // and shared by all transfers. 1 stages all chunks on the submitting thread.
+  iree_host_size_t file_transfer_thread_count;
+  // Services imported fd-backed files with io_uring when available. Falls back
+  // to synchronous pread/pwrite if io_uring cannot be used by the process.
+  bool file_io_uring;
+  // Routes operations whose queue affinity allows multiple queues to the queue
+  // whose executor is pinned to the NUMA memory node of the calling thread.
+  // Only has an effect when queues are serviced by executors on different
+  // nodes. Disabled by default.
+  bool numa_queue_routing;
+  // Allocates buffers requested on a queue without a queue affinity of their
+  // own for that queue so that the device allocator can place their memory on
+  // the NUMA node of the queue. Disabled by default.
+  bool numa_buffer_placement;
+  // Records reusable and indirect command buffers into task DAGs that are
+  // replayed on each submission instead of re-recording the commands into a
+  // new DAG each time. Costs additional memory per command buffer. Disabled by
+  // default.
+  bool replay_command_buffers;
 } iree_hal_task_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -0,0 +1,254 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_task/task_device.h"
+#include "iree/hal/utils/file_registry.h"
+#include "iree/io/file_handle.h"
+#include "iree/task/executor.h"
+#include "iree/task/topology.h"
+#include "iree/testing/benchmark.h"
+
+IREE_FLAG(int64_t, max_transfer_size_mb, 1024,
+          "Transfers larger than this many megabytes are skipped. Pass 10240\n"
+          "to include the 10 GB transfers (requires 10 GB of both free disk in\n"
+          "$TMPDIR and free memory).");
+
+// Number of worker threads in the executor servicing the queue copies.
+#define IREE_HAL_TASK_FILE_TRANSFER_BENCHMARK_WORKER_COUNT 8
+
+// Set in user_data for benchmarks that write the buffer to the file instead
+// of reading the file into the buffer.
+#define IREE_HAL_TASK_FILE_TRANSFER_BENCHMARK_WRITE (1u << 8)
+
+typedef struct iree_hal_task_file_transfer_benchmark_t {
+  iree_task_executor_t* executor;
+  iree_hal_allocator_t* device_allocator;
+  iree_hal_device_t* device;
+  iree_hal_semaphore_t* semaphore;
+  uint64_t semaphore_value;
+  char path[256];
+  iree_hal_file_t* file;
+  iree_hal_buffer_t* buffer;
+} iree_hal_task_file_transfer_benchmark_t;
+
+static void iree_hal_task_file_transfer_benchmark_deinitialize(
+    iree_hal_task_file_transfer_benchmark_t* benchmark) {
+  iree_hal_buffer_release(benchmark->buffer);
+  iree_hal_file_release(benchmark->file);
+  if (benchmark->path[0]) remove(benchmark->path);
+  iree_hal_semaphore_release(benchmark->semaphore);
+  iree_hal_device_release(benchmark->device);
+  iree_hal_allocator_release(benchmark->device_allocator);
+  iree_task_executor_release(benchmark->executor);
+}
+
+// Submits a transfer of |length| bytes between the file and the buffer and
+// waits for it to complete.
+static iree_status_t iree_hal_task_file_transfer_benchmark_transfer(
+    iree_hal_task_file_transfer_benchmark_t* benchmark, bool write,
+    iree_device_size_t length) {
+  uint64_t signal_value = ++benchmark->semaphore_value;
+  iree_hal_semaphore_list_t signal_semaphores = {
+      .count = 1,
+      .semaphores = &benchmark->semaphore,
+      .payload_values = &signal_value,
+  };
+  if (write) {
+    IREE_RETURN_IF_ERROR(iree_hal_device_queue_write(
+        benchmark->device, IREE_HAL_QUEUE_AFFINITY_ANY,
+        iree_hal_semaphore_list_empty(), signal_semaphores, benchmark->buffer,
+        0, benchmark->file, 0, length, IREE_HAL_WRITE_FLAG_NONE));
+  } else {
+    IREE_RETURN_IF_ERROR(iree_hal_device_queue_read(
+        benchmark->device, IREE_HAL_QUEUE_AFFINITY_ANY,
+        iree_hal_semaphore_list_empty(), signal_semaphores, benchmark->file, 0,
+        benchmark->buffer, 0, length, IREE_HAL_READ_FLAG_NONE));
+  }
+  return iree_hal_semaphore_wait(benchmark->semaphore, signal_value,
+                                 iree_infinite_timeout(),
+                                 IREE_HAL_WAIT_FLAG_DEFAULT);
+}
+
+// Creates a device that stages file transfers with |thread_count| threads and
+// a file and buffer of |length| bytes. The file is populated from the buffer so
+// that reads come from the page cache and measure the transfer overhead.
+static iree_status_t iree_hal_task_file_transfer_benchmark_initialize(
+    iree_host_size_t thread_count, iree_device_size_t length,
+    iree_allocator_t host_allocator,
+    iree_hal_task_file_transfer_benchmark_t* out_benchmark) {
+  memset(out_benchmark, 0, sizeof(*out_benchmark));
+
+  iree_task_executor_options_t executor_options;
+  iree_task_executor_options_initialize(&executor_options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(
+      IREE_HAL_TASK_FILE_TRANSFER_BENCHMARK_WORKER_COUNT, &topology);
+  iree_status_t status = iree_task_executor_create(
+      executor_options, &topology, host_allocator, &out_benchmark->executor);
+  iree_task_topology_deinitialize(&topology);
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_allocator_create_heap(
+        iree_make_cstring_view("local"), host_allocator, host_allocator,
+        &out_benchmark->device_allocator);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_hal_task_device_params_t params;
+    iree_hal_task_device_params_initialize(&params);
+    params.file_transfer_thread_count = thread_count;
+    status = iree_hal_task_device_create(
+        iree_make_cstring_view("local-task"), &params, /*queue_count=*/1,
+        &out_benchmark->executor, /*loader_count=*/0, /*loaders=*/NULL,
+        out_benchmark->device_allocator, host_allocator,
+        &out_benchmark->device);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_create(
+        out_benchmark->device, IREE_HAL_QUEUE_AFFINITY_ANY, 0ull,
+        IREE_HAL_SEMAPHORE_FLAG_DEFAULT, &out_benchmark->semaphore);
+  }
+
+  // Create a buffer filled with a non-zero pattern.
+  if (iree_status_is_ok(status)) {
+    iree_hal_buffer_params_t buffer_params = {
+        .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+        .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
+    };
+    status = iree_hal_allocator_allocate_buffer(
+        out_benchmark->device_allocator, buffer_params, length,
+        &out_benchmark->buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    const uint32_t pattern = 0xCDCDCDCDu;
+    status = iree_hal_buffer_map_fill(out_benchmark->buffer, 0, length,
+                                      &pattern, sizeof(pattern));
+  }
+
+  // Create the file and populate it with the buffer contents.
+  iree_io_file_handle_t* handle = NULL;
+  if (iree_status_is_ok(status)) {
+    const char* tmpdir = getenv("TEST_TMPDIR");
+    if (!tmpdir) tmpdir = getenv("TMPDIR");
+    if (!tmpdir) tmpdir = "/tmp";
+    snprintf(out_benchmark->path, sizeof(out_benchmark->path),
+             "%s/task_file_transfer_benchmark_%" PRIu64 ".bin", tmpdir,
+             (uint64_t)length);
+    status = iree_io_file_handle_create(
+        IREE_IO_FILE_MODE_READ | IREE_IO_FILE_MODE_WRITE |
+            IREE_IO_FILE_MODE_SEQUENTIAL_SCAN | IREE_IO_FILE_MODE_OVERWRITE,
+        iree_make_cstring_view(out_benchmark->path), length, host_allocator,
+        &handle);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_file_from_handle(
+        out_benchmark->device_allocator, IREE_HAL_QUEUE_AFFINITY_ANY,
+        IREE_HAL_MEMORY_ACCESS_READ | IREE_HAL_MEMORY_ACCESS_WRITE, handle,
+        host_allocator, &out_benchmark->file);
+  }
+  iree_io_file_handle_release(handle);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_task_file_transfer_benchmark_transfer(
+        out_benchmark, /*write=*/true, length);
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_hal_task_file_transfer_benchmark_deinitialize(out_benchmark);
+  }
+  return status;
+}
+
+// Transfers an entire file to or from a buffer and reports the throughput.
+// Compare the bytes/s of the threaded variants against threads_1 to see how
+// much of the transfer is bound by the single staging thread.
+//
+// user_data encodes the thread count in the low 8 bits, whether the transfer
+// is a write in bit 8, and the transfer size in megabytes in the high bits.
+static iree_status_t iree_hal_task_file_transfer_benchmark_run(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  uintptr_t user_data = (uintptr_t)benchmark_def->user_data;
+  iree_host_size_t thread_count = user_data & 0xFF;
+  bool write = (user_data & IREE_HAL_TASK_FILE_TRANSFER_BENCHMARK_WRITE) != 0;
+  int64_t size_mb = (int64_t)(user_data >> 16);
+  if (size_mb > FLAG_max_transfer_size_mb) {
+    iree_benchmark_skip(benchmark_state,
+                        "transfer size exceeds --max_transfer_size_mb");
+    return iree_ok_status();
+  }
+  iree_device_size_t length = (iree_device_size_t)size_mb * 1024 * 1024;
+
+  iree_hal_task_file_transfer_benchmark_t benchmark;
+  iree_status_t status = iree_hal_task_file_transfer_benchmark_initialize(
+      thread_count, length, benchmark_state->host_allocator, &benchmark);
+  if (!iree_status_is_ok(status)) {
+    // Most likely out of disk or memory for the larger sizes.
+    iree_status_ignore(status);
+    iree_benchmark_skip(benchmark_state, "failed to create file or buffer");
+    return iree_ok_status();
+  }
+
+  int64_t batch_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    IREE_CHECK_OK(iree_hal_task_file_transfer_benchmark_transfer(
+        &benchmark, write, length));
+    ++batch_count;
+  }
+  iree_benchmark_set_bytes_processed(benchmark_state,
+                                     batch_count * (int64_t)length);
+
+  iree_hal_task_file_transfer_benchmark_deinitialize(&benchmark);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage(
+      "task_file_transfer_benchmark",
+      "Measures streaming file transfer throughput on the local-task device.");
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_hal_task_file_transfer_benchmark_run
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_MILLISECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_task_file_transfer_benchmark_run,
+    };
+    static const uint32_t size_mbs[] = {1, 16, 256, 1024, 10240};
+    static const uint32_t thread_counts[] = {1, 2, 4, 8};
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(size_mbs); ++i) {
+      for (iree_host_size_t j = 0; j < IREE_ARRAYSIZE(thread_counts); ++j) {
+        for (uint32_t write = 0; write <= 1; ++write) {
+          char name[64];
+          snprintf(name, sizeof(name), "%s_%umb_threads_%u",
+                   write ? "write" : "read", size_mbs[i], thread_counts[j]);
+          benchmark_def.user_data =
+              (void*)(((uintptr_t)size_mbs[i] << 16) |
+                      (write ? IREE_HAL_TASK_FILE_TRANSFER_BENCHMARK_WRITE
+                             : 0) |
+                      thread_counts[j]);
+          iree_benchmark_register(iree_make_cstring_view(name),
+                                  &benchmark_def);
+        }
+      }
+    }
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
@@ -0,0 +1,231 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_task/task_device.h"
+#include "iree/hal/utils/file_registry.h"
+#include "iree/io/file_handle.h"
+#include "iree/task/executor.h"
+#include "iree/task/topology.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Large enough to span several chunks when staged with multiple threads.
+static constexpr iree_device_size_t kLargeLength = 20 * 1024 * 1024 + 4096 + 8;
+// Fits in a single chunk.
+static constexpr iree_device_size_t kSmallLength = 64 * 1024 + 8;
+
+// Round-trips buffers through a file on a local-task device that stages
+// transfers with the number of threads given by the test parameter.
+class TaskFileTransferTest : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    iree_task_executor_options_t executor_options;
+    iree_task_executor_options_initialize(&executor_options);
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/4,
+                                                   &topology);
+    IREE_ASSERT_OK(iree_task_executor_create(executor_options, &topology,
+                                             host_allocator, &executor_));
+    iree_task_topology_deinitialize(&topology);
+
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("local"), host_allocator, host_allocator,
+        &device_allocator_));
+    iree_hal_task_device_params_t params;
+    iree_hal_task_device_params_initialize(&params);
+    params.file_transfer_thread_count = GetParam();
+    IREE_ASSERT_OK(iree_hal_task_device_create(
+        iree_make_cstring_view("local-task"), &params, /*queue_count=*/1,
+        &executor_, /*loader_count=*/0, /*loaders=*/NULL, device_allocator_,
+        host_allocator, &device_));
+
+    const char* tmpdir = getenv("TEST_TMPDIR");
+    if (!tmpdir) tmpdir = getenv("TMPDIR");
+    if (!tmpdir) tmpdir = "/tmp";
+    // Parameterized test names contain '/'.
+    std::string test_name =
+        ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    std::replace(test_name.begin(), test_name.end(), '/', '_');
+    path_ = std::string(tmpdir) + "/task_file_transfer_test_" + test_name;
+    iree_io_file_handle_t* handle = NULL;
+    IREE_ASSERT_OK(iree_io_file_handle_create(
+        IREE_IO_FILE_MODE_READ | IREE_IO_FILE_MODE_WRITE |
+            IREE_IO_FILE_MODE_RANDOM_ACCESS | IREE_IO_FILE_MODE_OVERWRITE,
+        iree_make_string_view(path_.data(), path_.size()), 2 * kLargeLength,
+        host_allocator, &handle));
+    iree_status_t status = iree_hal_file_from_handle(
+        device_allocator_, IREE_HAL_QUEUE_AFFINITY_ANY,
+        IREE_HAL_MEMORY_ACCESS_READ | IREE_HAL_MEMORY_ACCESS_WRITE, handle,
+        host_allocator, &file_);
+    iree_io_file_handle_release(handle);
+    IREE_ASSERT_OK(status);
+  }
+
+  void TearDown() override {
+    iree_hal_file_release(file_);
+    if (!path_.empty()) remove(path_.c_str());
+    iree_hal_device_release(device_);
+    iree_hal_allocator_release(device_allocator_);
+    iree_task_executor_release(executor_);
+  }
+
+  iree_hal_buffer_t* AllocateBuffer(iree_device_size_t length) {
+    iree_hal_buffer_params_t params = {};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage =
+        IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(device_allocator_, params,
+                                                     length, &buffer));
+    return buffer;
+  }
+
+  // Fills |buffer| with bytes that differ per offset and per |seed|.
+  static std::vector<uint8_t> FillPattern(iree_hal_buffer_t* buffer,
+                                          uint8_t seed) {
+    std::vector<uint8_t> contents(iree_hal_buffer_byte_length(buffer));
+    for (size_t i = 0; i < contents.size(); ++i) {
+      contents[i] = (uint8_t)(i * 31 + i / 4096 + seed);
+    }
+    IREE_CHECK_OK(iree_hal_buffer_map_write(buffer, 0, contents.data(),
+                                            contents.size()));
+    return contents;
+  }
+
+  static std::vector<uint8_t> ReadContents(iree_hal_buffer_t* buffer,
+                                           iree_device_size_t offset,
+                                           iree_device_size_t length) {
+    std::vector<uint8_t> contents(length);
+    IREE_CHECK_OK(
+        iree_hal_buffer_map_read(buffer, offset, contents.data(), length));
+    return contents;
+  }
+
+  // Submits a transfer between |file_offset| in the file and |buffer_offset|
+  // in |buffer| and waits for it to complete.
+  iree_status_t Transfer(bool write, uint64_t file_offset,
+                         iree_hal_buffer_t* buffer,
+                         iree_device_size_t buffer_offset,
+                         iree_device_size_t length) {
+    iree_hal_semaphore_t* semaphore = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_semaphore_create(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, 0ull,
+        IREE_HAL_SEMAPHORE_FLAG_DEFAULT, &semaphore));
+    uint64_t signal_value = 1ull;
+    iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore,
+                                                   &signal_value};
+    iree_status_t status = iree_ok_status();
+    if (write) {
+      status = iree_hal_device_queue_write(
+          device_, IREE_HAL_QUEUE_AFFINITY_ANY,
+          iree_hal_semaphore_list_empty(), signal_semaphores, buffer,
+          buffer_offset, file_, file_offset, length, IREE_HAL_WRITE_FLAG_NONE);
+    } else {
+      status = iree_hal_device_queue_read(
+          device_, IREE_HAL_QUEUE_AFFINITY_ANY,
+          iree_hal_semaphore_list_empty(), signal_semaphores, file_,
+          file_offset, buffer, buffer_offset, length, IREE_HAL_READ_FLAG_NONE);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_semaphore_wait(semaphore, signal_value,
+                                       iree_infinite_timeout(),
+                                       IREE_HAL_WAIT_FLAG_DEFAULT);
+    }
+    iree_hal_semaphore_release(semaphore);
+    return status;
+  }
+
+  // Writes a patterned buffer to the file at |file_offset|, reads it back
+  // into a second buffer at |buffer_offset|, and compares the contents.
+  void RoundTrip(iree_device_size_t length, uint64_t file_offset,
+                 iree_device_size_t buffer_offset, uint8_t seed) {
+    iree_hal_buffer_t* source = AllocateBuffer(buffer_offset + length);
+    std::vector<uint8_t> expected = FillPattern(source, seed);
+    IREE_ASSERT_OK(Transfer(/*write=*/true, file_offset, source, buffer_offset,
+                            length));
+
+    iree_hal_buffer_t* target = AllocateBuffer(buffer_offset + length);
+    IREE_ASSERT_OK(iree_hal_buffer_map_zero(target, 0, IREE_HAL_WHOLE_BUFFER));
+    IREE_ASSERT_OK(Transfer(/*write=*/false, file_offset, target,
+                            buffer_offset, length));
+    std::vector<uint8_t> actual = ReadContents(target, buffer_offset, length);
+    EXPECT_TRUE(std::equal(actual.begin(), actual.end(),
+                           expected.begin() + buffer_offset));
+    // Bytes before the transferred range must be untouched.
+    std::vector<uint8_t> prefix = ReadContents(target, 0, buffer_offset);
+    EXPECT_TRUE(std::all_of(prefix.begin(), prefix.end(),
+                            [](uint8_t b) { return b == 0; }));
+
+    iree_hal_buffer_release(target);
+    iree_hal_buffer_release(source);
+  }
+
+  iree_task_executor_t* executor_ = NULL;
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  std::string path_;
+  iree_hal_file_t* file_ = NULL;
+};
+
+// Regression test for streaming writes deadlocking on the wait and signal
+// timepoints of each staging copy aliasing each other.
+TEST_P(TaskFileTransferTest, SmallRoundTrip) {
+  RoundTrip(kSmallLength, /*file_offset=*/0, /*buffer_offset=*/0, 1);
+}
+
+// Spans multiple chunks so that transfers with multiple threads claim chunks
+// on each of them.
+TEST_P(TaskFileTransferTest, LargeRoundTrip) {
+  RoundTrip(kLargeLength, /*file_offset=*/0, /*buffer_offset=*/0, 2);
+}
+
+TEST_P(TaskFileTransferTest, LargeRoundTripWithOffsets) {
+  RoundTrip(kLargeLength, /*file_offset=*/kLargeLength - 128,
+            /*buffer_offset=*/256, 3);
+}
+
+// Transfers are repeated to ensure the persistent transfer threads can be
+// reused.
+TEST_P(TaskFileTransferTest, RepeatedRoundTrips) {
+  for (int i = 0; i < 4; ++i) {
+    RoundTrip(kLargeLength, /*file_offset=*/i * 4096, /*buffer_offset=*/0,
+              (uint8_t)(4 + i));
+  }
+}
+
+// Transfers issued from multiple threads concurrently share the device's
+// transfer threads. Each thread works on its own half of the file.
+TEST_P(TaskFileTransferTest, ConcurrentRoundTrips) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back([this, i]() {
+      for (int j = 0; j < 2; ++j) {
+        RoundTrip(kLargeLength, /*file_offset=*/i * kLargeLength,
+                  /*buffer_offset=*/0, (uint8_t)(8 + i * 2 + j));
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
+INSTANTIATE_TEST_SUITE_P(ThreadCounts, TaskFileTransferTest,
+                         ::testing::Values(1, 4),
+                         ::testing::PrintToStringParamName());
+
+}  // namespace
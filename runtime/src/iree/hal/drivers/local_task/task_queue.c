@@ -213,6 +213,7 @@ static iree_status_t iree_hal_task_queue_issue_cmd_deferred(
       z0,
       iree_hal_task_command_buffer_create(
           cmd->queue->device_allocator, &cmd->queue->scope,
+          cmd->queue->barrier_mode,
           iree_hal_command_buffer_mode(command_buffer) |
               IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
               IREE_HAL_COMMAND_BUFFER_MODE_UNRETAINED |
@@ -246,10 +247,11 @@ static iree_status_t iree_hal_task_queue_issue_cmd_deferred(
   // Issue the task command buffer as if it had been recorded directly to begin
   // with.
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_hal_task_command_buffer_issue(task_command_buffer,
-                                             &cmd->queue->state,
-                                             cmd->task.header.completion_task,
-                                             cmd->arena, pending_submission));
+      z0, iree_hal_task_command_buffer_issue(
+              task_command_buffer, &cmd->queue->state,
+              cmd->task.header.completion_task, cmd->task.header.priority,
+              iree_hal_buffer_binding_table_empty(), cmd->arena,
+              pending_submission));
 
   // Still retained in the resource set until retirement.
   iree_hal_command_buffer_release(task_command_buffer);
@@ -270,14 +272,18 @@ static iree_status_t iree_hal_task_queue_issue_cmd(
   iree_status_t status = iree_ok_status();
   if (cmd->command_buffer != NULL) {
     if (iree_hal_task_command_buffer_isa(cmd->command_buffer)) {
-      if (cmd->binding_table.count > 0) {
-        status = iree_make_status(
-            IREE_STATUS_UNIMPLEMENTED,
-            "task command buffers do not support binding tables yet");
-      } else {
+      if (iree_hal_task_command_buffer_acquire(cmd->command_buffer,
+                                               &cmd->queue->scope)) {
         status = iree_hal_task_command_buffer_issue(
             cmd->command_buffer, &cmd->queue->state,
-            cmd->task.header.completion_task, cmd->arena, pending_submission);
+            cmd->task.header.completion_task, cmd->task.header.priority,
+            cmd->binding_table, cmd->arena, pending_submission);
+      } else {
+        // The prebuilt DAG is still in-flight from a prior submission (or was
+        // built for another queue) so record a transient one.
+        status = iree_hal_task_queue_issue_cmd_deferred(
+            cmd, iree_hal_task_command_buffer_deferred(cmd->command_buffer),
+            cmd->binding_table, pending_submission);
       }
     } else if (iree_hal_deferred_command_buffer_isa(cmd->command_buffer)) {
       status = iree_hal_task_queue_issue_cmd_deferred(
@@ -311,6 +317,7 @@ static iree_status_t iree_hal_task_queue_issue_cmd_allocate(
       scope, iree_task_make_call_closure(iree_hal_task_queue_issue_cmd, 0),
       &cmd->task);
   iree_task_set_completion_task(&cmd->task.header, retire_task);
+  iree_task_set_priority(&cmd->task.header, batch->priority);
   cmd->arena = arena;
   cmd->queue = queue;
   cmd->resource_set = resource_set;
@@ -659,6 +666,7 @@ static iree_status_t iree_hal_task_queue_host_call_cmd_allocate(
 void iree_hal_task_queue_initialize(iree_string_view_t identifier,
                                     iree_hal_queue_affinity_t affinity,
                                     iree_task_scope_flags_t scope_flags,
+                                    iree_hal_task_barrier_mode_t barrier_mode,
                                     iree_task_executor_t* executor,
                                     iree_arena_block_pool_t* small_block_pool,
                                     iree_arena_block_pool_t* large_block_pool,
@@ -672,10 +680,12 @@ void iree_hal_task_queue_initialize(iree_string_view_t identifier,
   out_queue->affinity = affinity;
   out_queue->executor = executor;
   iree_task_executor_retain(out_queue->executor);
+  out_queue->memory_node = iree_task_executor_query_memory_node(executor);
   out_queue->small_block_pool = small_block_pool;
   out_queue->large_block_pool = large_block_pool;
   out_queue->device_allocator = device_allocator;
   iree_hal_allocator_retain(out_queue->device_allocator);
+  out_queue->barrier_mode = barrier_mode;
 
   iree_task_scope_initialize(identifier, scope_flags, &out_queue->scope);
 
@@ -813,6 +823,16 @@ static iree_status_t iree_hal_task_queue_submit_batches(
   return iree_ok_status();
 }
 
+iree_task_priority_t iree_hal_task_queue_priority_from_execute_flags(
+    iree_hal_execute_flags_t flags) {
+  if (iree_all_bits_set(flags, IREE_HAL_EXECUTE_FLAG_PRIORITY_HIGH)) {
+    return IREE_TASK_PRIORITY_HIGH;
+  } else if (iree_all_bits_set(flags, IREE_HAL_EXECUTE_FLAG_PRIORITY_LOW)) {
+    return IREE_TASK_PRIORITY_LOW;
+  }
+  return IREE_TASK_PRIORITY_NORMAL;
+}
+
 iree_status_t iree_hal_task_queue_submit_commands(
     iree_hal_task_queue_t* queue, iree_host_size_t batch_count,
     const iree_hal_task_submission_batch_t* batches) {
@@ -13,6 +13,7 @@
 #include "iree/base/internal/arena.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/hal/api.h"
+#include "iree/hal/drivers/local_task/task_command_buffer.h"
 #include "iree/hal/drivers/local_task/task_queue_state.h"
 #include "iree/task/executor.h"
 #include "iree/task/scope.h"
@@ -37,8 +38,18 @@ typedef struct iree_hal_task_submission_batch_t {
 
   // Semaphores to signal once all command buffers have completed execution.
   iree_hal_semaphore_list_t signal_semaphores;
+
+  // Priority class of the tasks issued for the command buffer. Workers will
+  // prefer higher priority tasks and preempt lower priority dispatches between
+  // tiles.
+  iree_task_priority_t priority;
 } iree_hal_task_submission_batch_t;
 
+// Returns the task priority class for the IREE_HAL_EXECUTE_FLAG_PRIORITY_*
+// hints in |flags|. High priority takes precedence if both hints are set.
+iree_task_priority_t iree_hal_task_queue_priority_from_execute_flags(
+    iree_hal_execute_flags_t flags);
+
 typedef struct iree_hal_task_queue_t {
   // Affinity mask this queue processes.
   iree_hal_queue_affinity_t affinity;
@@ -46,6 +57,10 @@ typedef struct iree_hal_task_queue_t {
   // Shared executor that the queue submits tasks to.
   iree_task_executor_t* executor;
 
+  // NUMA memory node the executor workers are pinned to or
+  // IREE_MEMORY_NODE_ID_ANY if they are unpinned or span nodes.
+  uint32_t memory_node;
+
   // Shared block pool for allocating submission transients (tasks/events/etc).
   iree_arena_block_pool_t* small_block_pool;
   // Shared block pool for large allocations (command buffers/etc).
@@ -54,6 +69,9 @@ typedef struct iree_hal_task_queue_t {
   // Device allocator used for transient allocations/tracking.
   iree_hal_allocator_t* device_allocator;
 
+  // Barrier mode used by command buffers issued to the queue.
+  iree_hal_task_barrier_mode_t barrier_mode;
+
   // Scope used for all tasks in the queue.
   // This allows for easy waits on all outstanding queue tasks as well as
   // differentiation of tasks within the executor.
@@ -68,6 +86,7 @@ typedef struct iree_hal_task_queue_t {
 void iree_hal_task_queue_initialize(iree_string_view_t identifier,
                                     iree_hal_queue_affinity_t affinity,
                                     iree_task_scope_flags_t scope_flags,
+                                    iree_hal_task_barrier_mode_t barrier_mode,
                                     iree_task_executor_t* executor,
                                     iree_arena_block_pool_t* small_block_pool,
                                     iree_arena_block_pool_t* large_block_pool,
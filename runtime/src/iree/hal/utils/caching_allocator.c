@@ -6,11 +6,164 @@
 
 #include "iree/hal/utils/caching_allocator.h"
 
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
 #include "iree/base/internal/synchronization.h"
 
 // Default capacity of a pool free list when not specified by the user.
 #define IREE_HAL_CACHING_ALLOCATOR_DEFAULT_FREE_LIST_CAPACITY 64
 
+// Default capacity of each pool magazine when not specified by the user.
+#define IREE_HAL_CACHING_ALLOCATOR_DEFAULT_MAGAZINE_CAPACITY 8
+
+// Maximum capacity of each pool magazine. Magazines are scanned linearly and
+// are only meant to hold the few buffers a thread is actively cycling through.
+#define IREE_HAL_CACHING_ALLOCATOR_MAX_MAGAZINE_CAPACITY 64
+
+// log2 of the number of size classes each power-of-two range is divided into.
+// Bounds the internal waste of rounding to a size class to 1/(2^N).
+#define IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_SUB_BITS 3
+
+// Total number of size classes covering all 64-bit sizes. Free buffers are
+// bucketed by the size class of their allocation size.
+#define IREE_HAL_CACHING_ALLOCATOR_BUCKET_COUNT \
+  (64 << IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_SUB_BITS)
+
+// Sentinel used to terminate free entry lists.
+#define IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE UINT32_MAX
+
+// Returns the size class that |size| belongs to: the smallest class that is at
+// least |size|. Small sizes get a class each and larger sizes have
+// 2^IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_SUB_BITS classes per power of two.
+// If |out_class_size| is provided it receives the size of the class.
+static uint32_t iree_hal_caching_allocator_size_class(
+    iree_device_size_t size, iree_device_size_t* out_class_size) {
+  const int sub_bits = IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_SUB_BITS;
+  const uint64_t value = (uint64_t)size;
+  if (value <= (1ull << sub_bits)) {
+    if (out_class_size) *out_class_size = size;
+    return (uint32_t)value;
+  }
+  // Keep the top sub_bits+1 bits of (value-1) and round up. The mantissa will
+  // be in the range (2^sub_bits, 2^(sub_bits+1)] and when it hits the top of
+  // the range the next shift's first class is produced.
+  const int shift =
+      63 - iree_math_count_leading_zeros_u64(value - 1) - sub_bits;
+  const uint64_t mantissa = ((value - 1) >> shift) + 1;
+  if (out_class_size) *out_class_size = (iree_device_size_t)(mantissa << shift);
+  return (uint32_t)(((uint64_t)shift << sub_bits) + mantissa);
+}
+
+// A buffer retained in the pool free list.
+// Entries are linked into both a per-size-class bucket list and a pool-wide
+// recency list. Unused entries are linked through bucket_next.
+typedef struct iree_hal_caching_allocator_entry_t {
+  // Retained buffer available for reuse.
+  iree_hal_buffer_t* buffer;
+  // Neighbors in the bucket list ordered from most to least recently used.
+  uint32_t bucket_prev;
+  uint32_t bucket_next;
+  // Neighbors in the pool-wide list ordered from most to least recently used.
+  uint32_t recency_prev;
+  uint32_t recency_next;
+} iree_hal_caching_allocator_entry_t;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_caching_allocator_magazine_t
+//===----------------------------------------------------------------------===//
+
+// 1-based slot of the current thread used to select magazines or 0 if the
+// thread has not yet been assigned one. Slots are assigned round-robin so that
+// the first N threads using any caching allocator map to N distinct magazines.
+// If thread-locals are unavailable all threads share a slot; this is still
+// correct but will contend.
+static iree_thread_local uint32_t iree_hal_caching_allocator_thread_slot = 0;
+
+// Returns the 0-based slot of the current thread.
+static uint32_t iree_hal_caching_allocator_current_thread_slot(void) {
+  uint32_t slot = iree_hal_caching_allocator_thread_slot;
+  if (IREE_UNLIKELY(!slot)) {
+    static iree_atomic_int32_t next_slot = IREE_ATOMIC_VAR_INIT(0);
+    slot = (uint32_t)iree_atomic_fetch_add(&next_slot, 1,
+                                           iree_memory_order_relaxed) +
+           1;
+    iree_hal_caching_allocator_thread_slot = slot;
+  }
+  return slot - 1;
+}
+
+// A small cache of free buffers used by a subset of threads.
+// Magazines sit in front of the shared pool free list and are only guarded by
+// their own mutex. As each thread sticks to a single magazine the mutex is
+// uncontended in the common case and the pool mutex is only taken when the
+// magazine misses or overflows.
+typedef struct iree_hal_caching_allocator_magazine_t {
+  // Guards the magazine state.
+  iree_slim_mutex_t mutex;
+
+  IREE_STATISTICS(struct {
+    // Total number of acquisitions serviced from the magazine.
+    uint64_t hit_count;
+    // Total bytes added to requests serviced from the magazine by rounding up
+    // to size classes.
+    iree_device_size_t bytes_wasted;
+  } statistics;)
+
+  // Number of buffers in the magazine.
+  iree_host_size_t count;
+
+  // Retained free buffers in ascending recency (the higher the index the more
+  // recent) with magazine_capacity slots.
+  iree_hal_buffer_t* buffers[];
+} iree_hal_caching_allocator_magazine_t;
+
+// Returns the size of a magazine with |capacity| buffer slots padded such that
+// adjacent magazines do not share cache lines.
+static iree_host_size_t iree_hal_caching_allocator_magazine_size(
+    iree_host_size_t capacity) {
+  return iree_host_align(sizeof(iree_hal_caching_allocator_magazine_t) +
+                             capacity * sizeof(iree_hal_buffer_t*),
+                         iree_hardware_destructive_interference_size);
+}
+
+// Returns true if |buffer| can service a request with the given parameters.
+static bool iree_hal_caching_allocator_buffer_matches(
+    iree_hal_buffer_t* buffer, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size) {
+  // NOTE: we are not currently checking alignment as we don't really have it.
+  // We assume programs will use consistent alignments for a particular heap
+  // (as the heap has a min alignment).
+  return iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                           params->type) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                           params->usage) &&
+         iree_hal_buffer_allocation_size(buffer) == allocation_size;
+}
+
+// Scans |magazine| for a buffer matching the given requirements and returns
+// ownership.
+//
+// Must be called with the magazine mutex held.
+static iree_hal_buffer_t*
+iree_hal_caching_allocator_magazine_find_and_take_buffer(
+    iree_hal_caching_allocator_magazine_t* magazine,
+    const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size) {
+  // Walk backwards so that we check the most recently released buffers first.
+  for (iree_host_size_t i = magazine->count; i > 0; --i) {
+    iree_hal_buffer_t* buffer = magazine->buffers[i - 1];
+    if (iree_hal_caching_allocator_buffer_matches(buffer, params,
+                                                  allocation_size)) {
+      // Shift the list down to keep it dense and in ascending recency order.
+      memmove(&magazine->buffers[i - 1], &magazine->buffers[i],
+              (magazine->count - i) * sizeof(magazine->buffers[0]));
+      --magazine->count;
+      return buffer;
+    }
+  }
+  return NULL;  // nothing found
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_caching_allocator_pool_t
 //===----------------------------------------------------------------------===//
@@ -28,12 +181,43 @@ void iree_hal_caching_allocator_pool_params_initialize(
   out_params->max_allocation_capacity = IREE_DEVICE_SIZE_MAX;
   out_params->max_free_allocation_count =
       IREE_HAL_CACHING_ALLOCATOR_DEFAULT_FREE_LIST_CAPACITY;
+  out_params->flags = IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_NONE;
+  out_params->magazine_count = 0;
+  out_params->magazine_capacity =
+      IREE_HAL_CACHING_ALLOCATOR_DEFAULT_MAGAZINE_CAPACITY;
+}
+
+// Returns |params| with the magazine configuration clamped to supported values.
+static iree_hal_caching_allocator_pool_params_t
+iree_hal_caching_allocator_pool_params_normalize(
+    iree_hal_caching_allocator_pool_params_t params) {
+  if (params.magazine_count) {
+    params.magazine_count = (iree_host_size_t)iree_math_round_up_to_pow2_u64(
+        (uint64_t)params.magazine_count);
+    params.magazine_capacity =
+        iree_max(1, iree_min(params.magazine_capacity,
+                             IREE_HAL_CACHING_ALLOCATOR_MAX_MAGAZINE_CAPACITY));
+  } else {
+    params.magazine_capacity = 0;
+  }
+  return params;
 }
 
 // Pool of arbitrarily-sized device allocations for a particular heap.
 // This maintains a free list of blocks available for use but does not track
 // outstanding allocations.
 //
+// Free buffers are bucketed by size class so that finding a buffer for a
+// request only needs to look at buffers that are likely to match. When the
+// IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES flag is set allocations are
+// rounded up to their size class such that any buffer in a bucket can service
+// any request mapping to it.
+//
+// Optional magazines sit in front of the free list to avoid contention on the
+// pool mutex when many threads allocate from the same pool. Buffers are only
+// moved between magazines and the free list when a magazine overflows, when
+// the pool is about to allocate a new buffer, and when trimming.
+//
 // Thread-safe. Pools can service requests from multiple threads concurrently by
 // way of a pool-specific mutex. The mutex will not be held during underlying
 // allocator operations such as when acquiring a new allocation as these can be
@@ -63,19 +247,79 @@ typedef iree_alignas(
   // Total size, in bytes, of all free buffers currently in this pool.
   iree_device_size_t free_allocated_size;
 
-  // Flat MRU list of available buffers with max_free_allocation_count slots.
-  // Sorted by ascending recency (the higher the index the more recent).
-  // If we really cared about optimizing the interior removal then we'd want
-  // a linked/skip list or some bucketing but that's really for the higher
-  // level allocators to do.
+  IREE_STATISTICS(struct {
+    // Total number of acquisitions serviced from the free list.
+    uint64_t hit_count;
+    // Total number of acquisitions that had to allocate a new buffer.
+    uint64_t miss_count;
+    // Total bytes added to requests by rounding up to size classes.
+    iree_device_size_t bytes_wasted;
+  } statistics;)
+
+  // Number of buffers in the free list.
   iree_host_size_t free_count;
-  iree_hal_buffer_t* free_buffers[];
+
+  // Head of the pool-wide recency list (most recently used entry).
+  uint32_t recency_head;
+  // Tail of the pool-wide recency list (least recently used entry).
+  uint32_t recency_tail;
+  // Head of the list of unused entries linked through bucket_next.
+  uint32_t unused_head;
+
+  // Per-thread magazines with params.magazine_count elements each
+  // magazine_stride bytes apart. NULL if magazines are disabled.
+  uint8_t* magazines;
+  iree_host_size_t magazine_stride;
+
+  // Most recently used entry in each size class bucket.
+  uint32_t bucket_heads[IREE_HAL_CACHING_ALLOCATOR_BUCKET_COUNT];
+
+  // Free list entry storage with max_free_allocation_count slots.
+  iree_hal_caching_allocator_entry_t entries[];
 } iree_hal_caching_allocator_pool_t;
 
 static void iree_hal_caching_allocator_pool_trim(
     iree_hal_caching_allocator_pool_t* pool);
 
-// Initializes a buffer pool in |out_pool|.
+// Returns the total size in bytes of a pool with the given |params| including
+// its free list and magazine storage.
+static iree_host_size_t iree_hal_caching_allocator_pool_size(
+    iree_hal_caching_allocator_pool_params_t params) {
+  iree_host_size_t size = iree_host_align(
+      sizeof(iree_hal_caching_allocator_pool_t) +
+          sizeof(iree_hal_caching_allocator_entry_t) *
+              params.max_free_allocation_count,
+      iree_max_align_t);
+  if (params.magazine_count) {
+    // Padded so that the magazines can be aligned to cache lines.
+    size += iree_hardware_destructive_interference_size +
+            params.magazine_count * iree_hal_caching_allocator_magazine_size(
+                                        params.magazine_capacity);
+  }
+  return iree_host_align(size, iree_max_align_t);
+}
+
+// Returns the magazine at |index| in |pool|.
+static iree_hal_caching_allocator_magazine_t*
+iree_hal_caching_allocator_pool_magazine_at(
+    iree_hal_caching_allocator_pool_t* pool, iree_host_size_t index) {
+  return (iree_hal_caching_allocator_magazine_t*)(pool->magazines +
+                                                  index *
+                                                      pool->magazine_stride);
+}
+
+// Returns the magazine assigned to the current thread in |pool|.
+// Requires that magazines are enabled.
+static iree_hal_caching_allocator_magazine_t*
+iree_hal_caching_allocator_pool_thread_magazine(
+    iree_hal_caching_allocator_pool_t* pool) {
+  return iree_hal_caching_allocator_pool_magazine_at(
+      pool, iree_hal_caching_allocator_current_thread_slot() &
+                (pool->params.magazine_count - 1));
+}
+
+// Initializes a buffer pool in |out_pool| with the storage size as returned by
+// iree_hal_caching_allocator_pool_size.
 // Buffer device storage will be allocated from |device_allocator|.
 static void iree_hal_caching_allocator_pool_initialize(
     iree_hal_caching_allocator_pool_params_t params,
@@ -88,7 +332,42 @@ static void iree_hal_caching_allocator_pool_initialize(
   iree_slim_mutex_initialize(&out_pool->mutex);
   out_pool->total_allocated_size = 0;
   out_pool->free_allocated_size = 0;
+  IREE_STATISTICS(memset(&out_pool->statistics, 0,
+                         sizeof(out_pool->statistics)));
   out_pool->free_count = 0;
+  out_pool->recency_head = IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE;
+  out_pool->recency_tail = IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(out_pool->bucket_heads);
+       ++i) {
+    out_pool->bucket_heads[i] = IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE;
+  }
+
+  // Link all entries into the unused list.
+  out_pool->unused_head = IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE;
+  for (iree_host_size_t i = params.max_free_allocation_count; i > 0; --i) {
+    iree_hal_caching_allocator_entry_t* entry = &out_pool->entries[i - 1];
+    memset(entry, 0, sizeof(*entry));
+    entry->bucket_next = out_pool->unused_head;
+    out_pool->unused_head = (uint32_t)(i - 1);
+  }
+
+  // Initialize magazines (if any) in the storage following the entries.
+  out_pool->magazines = NULL;
+  out_pool->magazine_stride = 0;
+  if (params.magazine_count) {
+    uint8_t* entries_end =
+        (uint8_t*)&out_pool->entries[params.max_free_allocation_count];
+    out_pool->magazines = (uint8_t*)iree_host_align(
+        (uintptr_t)entries_end, iree_hardware_destructive_interference_size);
+    out_pool->magazine_stride =
+        iree_hal_caching_allocator_magazine_size(params.magazine_capacity);
+    for (iree_host_size_t i = 0; i < params.magazine_count; ++i) {
+      iree_hal_caching_allocator_magazine_t* magazine =
+          iree_hal_caching_allocator_pool_magazine_at(out_pool, i);
+      memset(magazine, 0, out_pool->magazine_stride);
+      iree_slim_mutex_initialize(&magazine->mutex);
+    }
+  }
 
   IREE_TRACE_SET_PLOT_TYPE(IREE_HAL_CACHING_ALLOCATOR_ID,
                            IREE_TRACING_PLOT_TYPE_MEMORY, /*step=*/true,
@@ -114,26 +393,70 @@ static void iree_hal_caching_allocator_pool_deinitialize(
   IREE_ASSERT_EQ(pool->free_count, 0,
                  "must have released all allocations prior to deinit");
 
+  for (iree_host_size_t i = 0; i < pool->params.magazine_count; ++i) {
+    iree_slim_mutex_deinitialize(
+        &iree_hal_caching_allocator_pool_magazine_at(pool, i)->mutex);
+  }
   iree_slim_mutex_deinitialize(&pool->mutex);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Returns the size that should be allocated for a request of
+// |allocation_size| bytes from |pool|. When size classes are enabled this
+// rounds up to the size class unless doing so would exceed the heap limits.
+static iree_device_size_t iree_hal_caching_allocator_pool_round_size(
+    const iree_hal_caching_allocator_pool_t* pool,
+    iree_device_size_t allocation_size) {
+  if (!iree_all_bits_set(pool->params.flags,
+                         IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES)) {
+    return allocation_size;
+  }
+  iree_device_size_t class_size = 0;
+  iree_hal_caching_allocator_size_class(allocation_size, &class_size);
+  if (pool->params.heap.max_allocation_size &&
+      class_size > pool->params.heap.max_allocation_size) {
+    return allocation_size;
+  }
+  return class_size;
+}
+
 // Pushes |buffer| on to the pool free list as the most recently used.
-// The buffer will be retained in the list.
+// The caller must have retained the buffer and ownership of that reference is
+// transferred to the list.
 //
 // Must be called with the pool mutex held.
 static void iree_hal_caching_allocator_pool_push_buffer(
     iree_hal_caching_allocator_pool_t* pool, iree_hal_buffer_t* buffer) {
-  // Retain the buffer; the caller must release it to complete the ownership
-  // transfer.
-  iree_hal_buffer_retain(buffer);
-
   IREE_ASSERT_LT(pool->free_count, pool->params.max_free_allocation_count);
+  IREE_ASSERT_NE(pool->unused_head, IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE);
+
+  // Grab an unused entry.
+  const uint32_t entry_index = pool->unused_head;
+  iree_hal_caching_allocator_entry_t* entry = &pool->entries[entry_index];
+  pool->unused_head = entry->bucket_next;
+  ++pool->free_count;
+  entry->buffer = buffer;
+
+  // Add to the front of its bucket (the most recent).
+  const uint32_t bucket_index = iree_hal_caching_allocator_size_class(
+      iree_hal_buffer_allocation_size(buffer), NULL);
+  entry->bucket_prev = IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE;
+  entry->bucket_next = pool->bucket_heads[bucket_index];
+  if (entry->bucket_next != IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE) {
+    pool->entries[entry->bucket_next].bucket_prev = entry_index;
+  }
+  pool->bucket_heads[bucket_index] = entry_index;
 
-  // Add to the end of the list (the most recent).
-  iree_host_size_t i = pool->free_count++;
-  pool->free_buffers[i] = buffer;
+  // Add to the front of the pool-wide recency list.
+  entry->recency_prev = IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE;
+  entry->recency_next = pool->recency_head;
+  if (entry->recency_next != IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE) {
+    pool->entries[entry->recency_next].recency_prev = entry_index;
+  } else {
+    pool->recency_tail = entry_index;
+  }
+  pool->recency_head = entry_index;
 
   // Track that we're now retaining unused memory.
   pool->free_allocated_size += buffer->allocation_size;
@@ -141,19 +464,44 @@ static void iree_hal_caching_allocator_pool_push_buffer(
                             pool->free_allocated_size);
 }
 
-// Takes the buffer in the |pool| free list at index |i| and returns ownership.
-// If the list is large this is bad but in most cases it's just a few dozen
-// elements.
+// Takes the buffer in the |pool| free list at |entry_index| and returns
+// ownership.
 //
 // Must be called with the pool mutex held.
 static iree_hal_buffer_t* iree_hal_caching_allocator_pool_take_buffer_at(
-    iree_hal_caching_allocator_pool_t* pool, iree_host_size_t i) {
-  iree_hal_buffer_t* buffer = pool->free_buffers[i];
-  if (i < pool->free_count - 1) {
-    // Shift the list down to keep it dense and in ascending recency order.
-    memmove(&pool->free_buffers[i], &pool->free_buffers[i + 1],
-            (pool->free_count - i - 1) * sizeof(pool->free_buffers[0]));
+    iree_hal_caching_allocator_pool_t* pool, uint32_t entry_index) {
+  iree_hal_caching_allocator_entry_t* entry = &pool->entries[entry_index];
+  iree_hal_buffer_t* buffer = entry->buffer;
+
+  // Unlink from the bucket list.
+  if (entry->bucket_prev != IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE) {
+    pool->entries[entry->bucket_prev].bucket_next = entry->bucket_next;
+  } else {
+    const uint32_t bucket_index = iree_hal_caching_allocator_size_class(
+        iree_hal_buffer_allocation_size(buffer), NULL);
+    pool->bucket_heads[bucket_index] = entry->bucket_next;
+  }
+  if (entry->bucket_next != IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE) {
+    pool->entries[entry->bucket_next].bucket_prev = entry->bucket_prev;
+  }
+
+  // Unlink from the recency list.
+  if (entry->recency_prev != IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE) {
+    pool->entries[entry->recency_prev].recency_next = entry->recency_next;
+  } else {
+    pool->recency_head = entry->recency_next;
+  }
+  if (entry->recency_next != IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE) {
+    pool->entries[entry->recency_next].recency_prev = entry->recency_prev;
+  } else {
+    pool->recency_tail = entry->recency_prev;
   }
+
+  // Return the entry to the unused list.
+  entry->buffer = NULL;
+  entry->bucket_next = pool->unused_head;
+  pool->unused_head = entry_index;
+
   --pool->free_count;
   pool->free_allocated_size -= buffer->allocation_size;
   IREE_TRACE_PLOT_VALUE_I64(IREE_HAL_CACHING_ALLOCATOR_ID,
@@ -161,25 +509,25 @@ static iree_hal_buffer_t* iree_hal_caching_allocator_pool_take_buffer_at(
   return buffer;
 }
 
-// Scans the |pool| free list for a buffer matching the given requirements and
-// returns ownership.
+// Scans the |pool| free list bucket for |allocation_size| for a buffer matching
+// the given requirements and returns ownership. Only buffers of the same size
+// class are considered and in the common case the first (most recently
+// released) buffer in the bucket matches.
 //
 // Must be called with the pool mutex held.
 static iree_hal_buffer_t* iree_hal_caching_allocator_pool_find_and_take_buffer(
     iree_hal_caching_allocator_pool_t* pool,
     const iree_hal_buffer_params_t* params,
     iree_device_size_t allocation_size) {
-  // Walk backwards so that we check the most recently released buffers first.
-  for (int i = (int)pool->free_count - 1; i >= 0; --i) {
-    // NOTE: we are not currently checking alignment as we don't really have it.
-    // We assume programs will use consistent alignments for a particular heap
-    // (as the heap has a min alignment).
-    iree_hal_buffer_t* buffer = pool->free_buffers[i];
-    if (iree_all_bits_set(iree_hal_buffer_memory_type(buffer), params->type) &&
-        iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
-                          params->usage) &&
-        iree_hal_buffer_allocation_size(buffer) == allocation_size) {
-      return iree_hal_caching_allocator_pool_take_buffer_at(pool, i);
+  const uint32_t bucket_index =
+      iree_hal_caching_allocator_size_class(allocation_size, NULL);
+  for (uint32_t entry_index = pool->bucket_heads[bucket_index];
+       entry_index != IREE_HAL_CACHING_ALLOCATOR_ENTRY_NONE;
+       entry_index = pool->entries[entry_index].bucket_next) {
+    iree_hal_buffer_t* buffer = pool->entries[entry_index].buffer;
+    if (iree_hal_caching_allocator_buffer_matches(buffer, params,
+                                                  allocation_size)) {
+      return iree_hal_caching_allocator_pool_take_buffer_at(pool, entry_index);
     }
   }
   return NULL;  // nothing found
@@ -200,7 +548,7 @@ static void iree_hal_caching_allocator_pool_trim_to_size(
     // Take the oldest buffer in the list.
     iree_hal_buffer_t* dead_buffer =
         iree_hal_caching_allocator_pool_take_buffer_at(pool,
-                                                       pool->free_count - 1);
+                                                       pool->recency_tail);
 
     // NOTE: we've removed the buffer but have not subtracted the size from
     // the total yet - we want to do that only after releasing the buffer.
@@ -224,15 +572,104 @@ static void iree_hal_caching_allocator_pool_trim_to_size(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Releases a retained |buffer| to the shared |pool| free list if there is
+// capacity remaining and otherwise deallocates it. Ownership of the caller's
+// reference is transferred to the pool.
+//
+// Thread-safe; multiple threads may concurrently access the |pool|.
+static void iree_hal_caching_allocator_pool_release_retained(
+    iree_hal_caching_allocator_pool_t* pool, iree_hal_buffer_t* buffer) {
+  // Try to add the buffer to the pool. If the pool is at capacity we'll just
+  // release it back to the allocator.
+  iree_slim_mutex_lock(&pool->mutex);
+
+  const iree_device_size_t allocation_size =
+      iree_hal_buffer_allocation_size(buffer);
+  const bool under_capacity = pool->total_allocated_size - allocation_size <=
+                              pool->params.max_allocation_capacity;
+  const bool under_count =
+      pool->free_count + 1 <= pool->params.max_free_allocation_count;
+  if (under_capacity && under_count) {
+    iree_hal_caching_allocator_pool_push_buffer(pool, buffer);
+    buffer = NULL;
+  }
+
+  // If the buffer didn't fit in the pool we drop it here while we don't hold
+  // the lock as deallocations can be very expensive.
+  if (buffer) {
+    iree_slim_mutex_unlock(&pool->mutex);
+    iree_hal_allocator_deallocate_buffer(pool->device_allocator, buffer);
+    iree_slim_mutex_lock(&pool->mutex);
+    pool->total_allocated_size -= allocation_size;
+  }
+
+  iree_slim_mutex_unlock(&pool->mutex);
+}
+
+// Moves the oldest buffers in |magazine| to the shared |pool| free list until
+// at most |target_count| remain. This is how buffers released on one thread
+// flow back to others and how magazines are drained during trims.
+//
+// The magazine mutex must not be held by the caller.
+static void iree_hal_caching_allocator_pool_flush_magazine(
+    iree_hal_caching_allocator_pool_t* pool,
+    iree_hal_caching_allocator_magazine_t* magazine,
+    iree_host_size_t target_count) {
+  iree_hal_buffer_t* flushed_buffers
+      [IREE_HAL_CACHING_ALLOCATOR_MAX_MAGAZINE_CAPACITY];
+  iree_slim_mutex_lock(&magazine->mutex);
+  iree_host_size_t flushed_count =
+      magazine->count > target_count ? magazine->count - target_count : 0;
+  memcpy(flushed_buffers, magazine->buffers,
+         flushed_count * sizeof(flushed_buffers[0]));
+  memmove(&magazine->buffers[0], &magazine->buffers[flushed_count],
+          (magazine->count - flushed_count) * sizeof(magazine->buffers[0]));
+  magazine->count -= flushed_count;
+  iree_slim_mutex_unlock(&magazine->mutex);
+
+  // Return to the shared pool without holding the magazine lock as the pool
+  // may need to deallocate.
+  for (iree_host_size_t i = 0; i < flushed_count; ++i) {
+    iree_hal_caching_allocator_pool_release_retained(pool, flushed_buffers[i]);
+  }
+}
+
+// Scans the magazines of other threads for a buffer matching the given
+// requirements and returns ownership. Used before allocating new buffers so
+// that buffers stranded in magazines of threads that are no longer allocating
+// get reused. Magazines currently in use by other threads are skipped.
+//
+// Thread-safe; multiple threads may concurrently access the |pool|.
+static iree_hal_buffer_t* iree_hal_caching_allocator_pool_steal_buffer(
+    iree_hal_caching_allocator_pool_t* pool,
+    const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size) {
+  for (iree_host_size_t i = 0; i < pool->params.magazine_count; ++i) {
+    iree_hal_caching_allocator_magazine_t* magazine =
+        iree_hal_caching_allocator_pool_magazine_at(pool, i);
+    if (!iree_slim_mutex_try_lock(&magazine->mutex)) continue;
+    iree_hal_buffer_t* buffer =
+        iree_hal_caching_allocator_magazine_find_and_take_buffer(
+            magazine, params, allocation_size);
+    iree_slim_mutex_unlock(&magazine->mutex);
+    if (buffer) return buffer;
+  }
+  return NULL;  // nothing found
+}
+
 // Releases all unused buffers in |pool| to the underlying device allocator.
 //
 // The pool mutex must not be held by the caller.
 static void iree_hal_caching_allocator_pool_trim(
     iree_hal_caching_allocator_pool_t* pool) {
+  for (iree_host_size_t i = 0; i < pool->params.magazine_count; ++i) {
+    iree_hal_caching_allocator_pool_flush_magazine(
+        pool, iree_hal_caching_allocator_pool_magazine_at(pool, i), 0);
+  }
   iree_hal_caching_allocator_pool_trim_to_size(pool, 0);
 }
 
-// Acquires a buffer of |allocation_size| from the |pool|.
+// Acquires a buffer of at least |allocation_size| from the |pool|.
 // The buffer will have a memory type and usage compatible with the given types.
 // Fails if the pool is empty and the underlying device fails the allocation.
 //
@@ -244,6 +681,35 @@ static iree_status_t iree_hal_caching_allocator_pool_acquire(
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
 
+  // Round up to the size class (if enabled) so that the buffer can be reused
+  // for any request of similar size.
+  IREE_STATISTICS(const iree_device_size_t requested_size = allocation_size);
+  allocation_size =
+      iree_hal_caching_allocator_pool_round_size(pool, allocation_size);
+
+  // Try the magazine of the current thread first. This only takes the
+  // magazine mutex which is usually uncontended.
+  if (pool->magazines) {
+    iree_hal_caching_allocator_magazine_t* magazine =
+        iree_hal_caching_allocator_pool_thread_magazine(pool);
+    iree_slim_mutex_lock(&magazine->mutex);
+    iree_hal_buffer_t* magazine_buffer =
+        iree_hal_caching_allocator_magazine_find_and_take_buffer(
+            magazine, params, allocation_size);
+    IREE_STATISTICS({
+      if (magazine_buffer) {
+        ++magazine->statistics.hit_count;
+        magazine->statistics.bytes_wasted += allocation_size - requested_size;
+      }
+    });
+    iree_slim_mutex_unlock(&magazine->mutex);
+    if (magazine_buffer) {
+      *out_buffer = magazine_buffer;
+      IREE_TRACE_ZONE_END(z0);
+      return iree_ok_status();
+    }
+  }
+
   // Scan the free list to find an appropriate block.
   // If found we pop it off the list and return it without needing to allocate.
   iree_slim_mutex_lock(&pool->mutex);
@@ -255,7 +721,32 @@ static iree_status_t iree_hal_caching_allocator_pool_acquire(
     // for by other threads allocating at the same time.
     pool->total_allocated_size += allocation_size;
   }
+  IREE_STATISTICS({
+    if (existing_buffer) {
+      ++pool->statistics.hit_count;
+    } else {
+      ++pool->statistics.miss_count;
+    }
+    pool->statistics.bytes_wasted += allocation_size - requested_size;
+  });
   iree_slim_mutex_unlock(&pool->mutex);
+
+  // Before allocating reclaim a buffer held idle in another thread's magazine.
+  // Those are already accounted for in the total so undo our reservation.
+  if (!existing_buffer && pool->magazines) {
+    existing_buffer = iree_hal_caching_allocator_pool_steal_buffer(
+        pool, params, allocation_size);
+    if (existing_buffer) {
+      iree_slim_mutex_lock(&pool->mutex);
+      pool->total_allocated_size -= allocation_size;
+      IREE_STATISTICS({
+        --pool->statistics.miss_count;
+        ++pool->statistics.hit_count;
+      });
+      iree_slim_mutex_unlock(&pool->mutex);
+    }
+  }
+
   if (existing_buffer) {
     // Found a buffer! Return it uninitialized.
     *out_buffer = existing_buffer;
@@ -290,6 +781,9 @@ static iree_status_t iree_hal_caching_allocator_pool_acquire(
 }
 
 // Releases a |buffer| to the |pool| if there is capacity remaining.
+// If magazines are enabled the buffer is released to the current thread's
+// magazine and when that is full the older half of the magazine is returned
+// to the shared pool.
 //
 // Thread-safe; multiple threads may concurrently access the |pool|.
 static void iree_hal_caching_allocator_pool_release(
@@ -298,32 +792,30 @@ static void iree_hal_caching_allocator_pool_release(
   IREE_TRACE_ZONE_APPEND_VALUE_I64(
       z0, (int64_t)iree_hal_buffer_allocation_size(buffer));
 
-  // Try to add the buffer to the pool. If the pool is at capacity we'll just
-  // release it back to the allocator.
-  iree_slim_mutex_lock(&pool->mutex);
-
-  const iree_device_size_t allocation_size =
-      iree_hal_buffer_allocation_size(buffer);
-  const bool under_capacity = pool->total_allocated_size - allocation_size <=
-                              pool->params.max_allocation_capacity;
-  const bool under_count =
-      pool->free_count + 1 <= pool->params.max_free_allocation_count;
-  if (under_capacity && under_count) {
-    iree_hal_caching_allocator_pool_push_buffer(pool, buffer);
-    buffer = NULL;
-  }
+  // Retain the buffer; the reference is owned by the magazine or free list it
+  // is placed in and transferred to the next user when acquired.
+  iree_hal_buffer_retain(buffer);
 
-  // If the buffer didn't fit in the pool we drop it here while we don't hold
-  // the lock as deallocations can be very expensive.
-  if (buffer) {
-    iree_slim_mutex_unlock(&pool->mutex);
-    iree_hal_allocator_deallocate_buffer(pool->device_allocator, buffer);
-    iree_slim_mutex_lock(&pool->mutex);
-    pool->total_allocated_size -= allocation_size;
+  if (pool->magazines) {
+    iree_hal_caching_allocator_magazine_t* magazine =
+        iree_hal_caching_allocator_pool_thread_magazine(pool);
+    for (;;) {
+      iree_slim_mutex_lock(&magazine->mutex);
+      if (magazine->count < pool->params.magazine_capacity) {
+        magazine->buffers[magazine->count++] = buffer;
+        buffer = NULL;
+      }
+      iree_slim_mutex_unlock(&magazine->mutex);
+      if (!buffer) break;
+      // Magazine is full: rebalance by returning the older half to the shared
+      // pool where other threads can find them and try again.
+      iree_hal_caching_allocator_pool_flush_magazine(
+          pool, magazine, pool->params.magazine_capacity / 2);
+    }
+  } else {
+    iree_hal_caching_allocator_pool_release_retained(pool, buffer);
   }
 
-  iree_slim_mutex_unlock(&pool->mutex);
-
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -404,11 +896,8 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
       iree_sizeof_struct(*allocator) + pool_list_size, iree_max_align_t);
   iree_host_size_t pool_offset = total_size;
   for (iree_host_size_t i = 0; i < pool_count; ++i) {
-    iree_hal_caching_allocator_pool_t* pool = NULL;
-    total_size += iree_host_align(
-        sizeof(*pool) + sizeof(pool->free_buffers[0]) *
-                            pool_params[i].max_free_allocation_count,
-        iree_max_align_t);
+    total_size += iree_hal_caching_allocator_pool_size(
+        iree_hal_caching_allocator_pool_params_normalize(pool_params[i]));
   }
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0,
@@ -425,15 +914,13 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
   // Initialize each pool.
   uint8_t* pool_ptr = (uint8_t*)allocator + pool_offset;
   for (iree_host_size_t i = 0; i < pool_count; ++i) {
+    iree_hal_caching_allocator_pool_params_t params =
+        iree_hal_caching_allocator_pool_params_normalize(pool_params[i]);
     iree_hal_caching_allocator_pool_t* pool =
         (iree_hal_caching_allocator_pool_t*)pool_ptr;
-    pool_ptr += iree_host_align(
-        sizeof(*pool) + sizeof(pool->free_buffers[0]) *
-                            pool_params[i].max_free_allocation_count,
-        iree_max_align_t);
+    pool_ptr += iree_hal_caching_allocator_pool_size(params);
     allocator->pools[i] = pool;
-    iree_hal_caching_allocator_pool_initialize(pool_params[i], device_allocator,
-                                               pool);
+    iree_hal_caching_allocator_pool_initialize(params, device_allocator, pool);
   }
 
   *out_allocator = (iree_hal_allocator_t*)allocator;
@@ -547,12 +1034,17 @@ iree_status_t iree_hal_caching_allocator_create_from_spec(
     iree_string_view_t max_allocation_size_str = iree_string_view_empty();
     iree_string_view_t max_allocation_capacity_str = iree_string_view_empty();
     iree_string_view_t max_free_allocation_count_str = iree_string_view_empty();
+    iree_string_view_t mode_str = iree_string_view_empty();
+    iree_string_view_t magazine_count_str = iree_string_view_empty();
     iree_string_view_split(pool_config, ';', &max_allocation_size_str,
                            &pool_config);
     iree_string_view_split(pool_config, ';', &max_allocation_capacity_str,
                            &pool_config);
     iree_string_view_split(pool_config, ';', &max_free_allocation_count_str,
                            &pool_config);
+    iree_string_view_split(pool_config, ';', &mode_str, &pool_config);
+    iree_string_view_split(pool_config, ';', &magazine_count_str,
+                           &pool_config);
     max_allocation_size_str = iree_string_view_trim(max_allocation_size_str);
     if (!iree_string_view_is_empty(max_allocation_size_str) &&
         !iree_string_view_equal(max_allocation_size_str, IREE_SV("*"))) {
@@ -584,6 +1076,29 @@ iree_status_t iree_hal_caching_allocator_create_from_spec(
       }
       pool_params->max_free_allocation_count = max_free_allocation_count;
     }
+    mode_str = iree_string_view_trim(mode_str);
+    if (iree_string_view_equal(mode_str, IREE_SV("size_classes"))) {
+      pool_params->flags |= IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES;
+    } else if (!iree_string_view_is_empty(mode_str) &&
+               !iree_string_view_equal(mode_str, IREE_SV("exact")) &&
+               !iree_string_view_equal(mode_str, IREE_SV("*"))) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "invalid pool mode '%.*s'; expected `exact` or "
+                              "`size_classes`",
+                              (int)mode_str.size, mode_str.data);
+    }
+    magazine_count_str = iree_string_view_trim(magazine_count_str);
+    if (!iree_string_view_is_empty(magazine_count_str) &&
+        !iree_string_view_equal(magazine_count_str, IREE_SV("*"))) {
+      uint32_t magazine_count = 0;
+      if (!iree_string_view_atoi_uint32(magazine_count_str, &magazine_count)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "invalid magazine count '%.*s'",
+                                (int)magazine_count_str.size,
+                                magazine_count_str.data);
+      }
+      pool_params->magazine_count = magazine_count;
+    }
   } while (!iree_string_view_is_empty(config_pairs));
   return iree_hal_caching_allocator_create_with_pools(
       pool_count, pool_params_storage, device_allocator, host_allocator,
@@ -633,6 +1148,24 @@ static void iree_hal_caching_allocator_query_statistics(
       iree_hal_caching_allocator_cast(base_allocator);
   iree_hal_allocator_query_statistics(allocator->device_allocator,
                                       out_statistics);
+  IREE_STATISTICS({
+    for (iree_host_size_t i = 0; i < allocator->pool_count; ++i) {
+      iree_hal_caching_allocator_pool_t* pool = allocator->pools[i];
+      iree_slim_mutex_lock(&pool->mutex);
+      out_statistics->pool_hit_count += pool->statistics.hit_count;
+      out_statistics->pool_miss_count += pool->statistics.miss_count;
+      out_statistics->pool_bytes_wasted += pool->statistics.bytes_wasted;
+      iree_slim_mutex_unlock(&pool->mutex);
+      for (iree_host_size_t j = 0; j < pool->params.magazine_count; ++j) {
+        iree_hal_caching_allocator_magazine_t* magazine =
+            iree_hal_caching_allocator_pool_magazine_at(pool, j);
+        iree_slim_mutex_lock(&magazine->mutex);
+        out_statistics->pool_hit_count += magazine->statistics.hit_count;
+        out_statistics->pool_bytes_wasted += magazine->statistics.bytes_wasted;
+        iree_slim_mutex_unlock(&magazine->mutex);
+      }
+    }
+  });
 }
 
 static iree_status_t iree_hal_caching_allocator_query_memory_heaps(
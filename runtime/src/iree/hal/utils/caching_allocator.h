@@ -26,6 +26,18 @@ extern "C" {
 // manipulated from multiple threads.
 typedef struct iree_hal_caching_allocator_t iree_hal_caching_allocator_t;
 
+// Flags controlling iree_hal_caching_allocator_t pool behavior.
+enum iree_hal_caching_allocator_pool_flag_bits_t {
+  IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_NONE = 0u,
+  // Rounds allocation sizes up to geometric size classes so that requests of
+  // similar but not identical sizes can reuse the same cached buffers. Each
+  // power-of-two range is divided into 8 classes bounding the internal waste
+  // of any allocation to at most 12.5% of its size. Without this flag buffers
+  // are only reused for requests of the exact same size.
+  IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES = 1u << 0,
+};
+typedef uint32_t iree_hal_caching_allocator_pool_flags_t;
+
 // Parameters used to configure an iree_hal_caching_allocator_t pool.
 // These cannot be changed once the allocator has been created.
 typedef struct iree_hal_caching_allocator_pool_params_t {
@@ -49,6 +61,21 @@ typedef struct iree_hal_caching_allocator_pool_params_t {
   // This is used to allocate storage for the free list and should be reasonably
   // bounded (~64-1024).
   iree_host_size_t max_free_allocation_count;
+
+  // Flags controlling pool behavior.
+  iree_hal_caching_allocator_pool_flags_t flags;
+
+  // Number of magazines caching free buffers in front of the shared pool free
+  // list. Each thread is assigned one magazine and when there are at least as
+  // many magazines as threads allocating from the pool most acquire and
+  // release operations will not contend on the shared pool. Rounded up to a
+  // power of two. 0 disables magazines.
+  iree_host_size_t magazine_count;
+
+  // Maximum number of free buffers retained in each magazine. When a magazine
+  // fills half of its buffers are returned to the shared pool. Buffers held in
+  // magazines are not counted against max_free_allocation_count.
+  iree_host_size_t magazine_capacity;
 } iree_hal_caching_allocator_pool_params_t;
 
 // Initializes |out_params| to the default values using |heap| for storage.
@@ -101,10 +128,16 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
 // defaults.
 //
 // Expected form:
-//   heap_key=max_allocation_size;max_allocation_capacity;max_free_allocation_count
+//   heap_key=max_allocation_size;max_allocation_capacity;max_free_allocation_count[;mode[;magazine_count]]
+// Where the optional mode is either `exact` (default) to only reuse buffers of
+// the same size or `size_classes` to round allocations up to size classes (see
+// IREE_HAL_CACHING_ALLOCATOR_POOL_FLAG_SIZE_CLASSES) and the optional
+// magazine_count enables per-thread magazines (see
+// iree_hal_caching_allocator_pool_params_t::magazine_count).
 // Example:
 //   device_local=1gib;1gib;8
-//   host_local=*;*;32
+//   host_local=*;*;32;size_classes
+//   host_local=*;*;32;exact;8
 iree_status_t iree_hal_caching_allocator_create_from_spec(
     iree_string_view_t config_pairs, iree_hal_allocator_t* device_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
@@ -0,0 +1,249 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/caching_allocator.h"
+#include "iree/testing/benchmark.h"
+
+// Maximum number of threads allocating concurrently.
+#define IREE_HAL_CACHING_ALLOCATOR_BENCHMARK_MAX_THREADS 16
+
+// Number of acquire/release pairs each thread performs per iteration.
+#define IREE_HAL_CACHING_ALLOCATOR_BENCHMARK_OPS_PER_THREAD 4096
+
+// Number of buffers each thread keeps live at a time. Mimics a program that
+// has a few transient buffers in flight at once.
+#define IREE_HAL_CACHING_ALLOCATOR_BENCHMARK_LIVE_BUFFERS 4
+
+// Pool of threads created once per benchmark and kicked off for each timed
+// iteration so that thread creation is not measured.
+typedef struct iree_hal_caching_allocator_benchmark_pool_t {
+  iree_hal_allocator_t* allocator;
+  uint32_t thread_count;
+  // Incremented by the main thread to start an iteration.
+  iree_atomic_int32_t generation;
+  // Number of threads that have not yet finished the current iteration.
+  iree_atomic_int32_t pending_count;
+  // Set by the main thread when the threads should exit.
+  iree_atomic_int32_t exit_requested;
+  // Posted when |generation| or |exit_requested| change.
+  iree_notification_t start_notification;
+  // Posted when |pending_count| reaches 0.
+  iree_notification_t done_notification;
+  iree_thread_t* threads[IREE_HAL_CACHING_ALLOCATOR_BENCHMARK_MAX_THREADS];
+} iree_hal_caching_allocator_benchmark_pool_t;
+
+typedef struct iree_hal_caching_allocator_benchmark_thread_t {
+  iree_hal_caching_allocator_benchmark_pool_t* pool;
+  uint32_t seed;
+  // Last generation the thread ran.
+  int32_t generation;
+} iree_hal_caching_allocator_benchmark_thread_t;
+
+// Cycles through allocations of a handful of sizes so that after warmup all
+// requests should hit the cache.
+static void iree_hal_caching_allocator_benchmark_thread_run(
+    iree_hal_allocator_t* allocator, uint32_t seed) {
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
+  };
+  iree_hal_buffer_t*
+      buffers[IREE_HAL_CACHING_ALLOCATOR_BENCHMARK_LIVE_BUFFERS] = {NULL};
+  for (uint32_t i = 0; i < IREE_HAL_CACHING_ALLOCATOR_BENCHMARK_OPS_PER_THREAD;
+       ++i) {
+    uint32_t slot = i % IREE_ARRAYSIZE(buffers);
+    iree_hal_buffer_release(buffers[slot]);
+    iree_device_size_t allocation_size = 4096 * (1 + ((i * 7 + seed) % 4));
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        allocator, params, allocation_size, &buffers[slot]));
+  }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(buffers); ++i) {
+    iree_hal_buffer_release(buffers[i]);
+  }
+}
+
+static bool iree_hal_caching_allocator_benchmark_thread_should_wake(
+    void* arg) {
+  iree_hal_caching_allocator_benchmark_thread_t* thread =
+      (iree_hal_caching_allocator_benchmark_thread_t*)arg;
+  return iree_atomic_load(&thread->pool->exit_requested,
+                          iree_memory_order_acquire) ||
+         iree_atomic_load(&thread->pool->generation,
+                          iree_memory_order_acquire) != thread->generation;
+}
+
+static int iree_hal_caching_allocator_benchmark_thread_main(void* entry_arg) {
+  iree_hal_caching_allocator_benchmark_thread_t* thread =
+      (iree_hal_caching_allocator_benchmark_thread_t*)entry_arg;
+  iree_hal_caching_allocator_benchmark_pool_t* pool = thread->pool;
+  for (;;) {
+    iree_notification_await(
+        &pool->start_notification,
+        iree_hal_caching_allocator_benchmark_thread_should_wake, thread,
+        iree_infinite_timeout());
+    if (iree_atomic_load(&pool->exit_requested, iree_memory_order_acquire)) {
+      break;
+    }
+    thread->generation =
+        iree_atomic_load(&pool->generation, iree_memory_order_acquire);
+    iree_hal_caching_allocator_benchmark_thread_run(pool->allocator,
+                                                    thread->seed);
+    if (iree_atomic_fetch_sub(&pool->pending_count, 1,
+                              iree_memory_order_acq_rel) == 1) {
+      iree_notification_post(&pool->done_notification, IREE_ALL_WAITERS);
+    }
+  }
+  return 0;
+}
+
+static void iree_hal_caching_allocator_benchmark_pool_initialize(
+    iree_hal_allocator_t* allocator, uint32_t thread_count,
+    iree_hal_caching_allocator_benchmark_thread_t* thread_args,
+    iree_allocator_t host_allocator,
+    iree_hal_caching_allocator_benchmark_pool_t* out_pool) {
+  memset(out_pool, 0, sizeof(*out_pool));
+  out_pool->allocator = allocator;
+  out_pool->thread_count = thread_count;
+  iree_notification_initialize(&out_pool->start_notification);
+  iree_notification_initialize(&out_pool->done_notification);
+  iree_thread_create_params_t thread_params;
+  memset(&thread_params, 0, sizeof(thread_params));
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    thread_args[i].pool = out_pool;
+    thread_args[i].seed = i;
+    thread_args[i].generation = 0;
+    IREE_CHECK_OK(iree_thread_create(
+        iree_hal_caching_allocator_benchmark_thread_main, &thread_args[i],
+        thread_params, host_allocator, &out_pool->threads[i]));
+  }
+}
+
+static void iree_hal_caching_allocator_benchmark_pool_deinitialize(
+    iree_hal_caching_allocator_benchmark_pool_t* pool) {
+  iree_atomic_store(&pool->exit_requested, 1, iree_memory_order_release);
+  iree_notification_post(&pool->start_notification, IREE_ALL_WAITERS);
+  for (uint32_t i = 0; i < pool->thread_count; ++i) {
+    // Releasing the thread joins it.
+    iree_thread_release(pool->threads[i]);
+  }
+  iree_notification_deinitialize(&pool->done_notification);
+  iree_notification_deinitialize(&pool->start_notification);
+}
+
+static bool iree_hal_caching_allocator_benchmark_pool_is_done(void* arg) {
+  iree_hal_caching_allocator_benchmark_pool_t* pool =
+      (iree_hal_caching_allocator_benchmark_pool_t*)arg;
+  return iree_atomic_load(&pool->pending_count, iree_memory_order_acquire) ==
+         0;
+}
+
+// Runs one iteration on all threads of |pool| and waits for them to finish.
+static void iree_hal_caching_allocator_benchmark_pool_run(
+    iree_hal_caching_allocator_benchmark_pool_t* pool) {
+  iree_atomic_store(&pool->pending_count, (int32_t)pool->thread_count,
+                    iree_memory_order_release);
+  iree_atomic_fetch_add(&pool->generation, 1, iree_memory_order_acq_rel);
+  iree_notification_post(&pool->start_notification, IREE_ALL_WAITERS);
+  iree_notification_await(&pool->done_notification,
+                          iree_hal_caching_allocator_benchmark_pool_is_done,
+                          pool, iree_infinite_timeout());
+}
+
+// Tests the throughput of acquire/release pairs from many threads sharing one
+// caching allocator. Compare the shared variants with the magazine variants to
+// see the cost of contention on the shared pool.
+//
+// user_data encodes the thread count in the low 16 bits and the magazine count
+// in the high 16 bits.
+static iree_status_t iree_hal_caching_allocator_benchmark_threads(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  uint32_t thread_count = (uint32_t)(uintptr_t)benchmark_def->user_data;
+  uint32_t magazine_count = thread_count >> 16;
+  thread_count &= 0xFFFF;
+
+  iree_hal_allocator_t* heap_allocator = NULL;
+  IREE_CHECK_OK(iree_hal_allocator_create_heap(
+      iree_make_cstring_view("heap"), host_allocator, host_allocator,
+      &heap_allocator));
+  iree_hal_allocator_memory_heap_t heap;
+  iree_host_size_t heap_count = 0;
+  IREE_CHECK_OK(iree_hal_allocator_query_memory_heaps(heap_allocator, 1, &heap,
+                                                      &heap_count));
+  iree_hal_caching_allocator_pool_params_t pool_params;
+  iree_hal_caching_allocator_pool_params_initialize(heap, &pool_params);
+  pool_params.magazine_count = magazine_count;
+  iree_hal_allocator_t* allocator = NULL;
+  IREE_CHECK_OK(iree_hal_caching_allocator_create_with_pools(
+      1, &pool_params, heap_allocator, host_allocator, &allocator));
+
+  iree_hal_caching_allocator_benchmark_thread_t
+      thread_args[IREE_HAL_CACHING_ALLOCATOR_BENCHMARK_MAX_THREADS];
+  iree_hal_caching_allocator_benchmark_pool_t pool;
+  iree_hal_caching_allocator_benchmark_pool_initialize(
+      allocator, thread_count, thread_args, host_allocator, &pool);
+
+  while (iree_benchmark_keep_running(
+      benchmark_state,
+      /*batch_count=*/thread_count *
+          IREE_HAL_CACHING_ALLOCATOR_BENCHMARK_OPS_PER_THREAD)) {
+    iree_hal_caching_allocator_benchmark_pool_run(&pool);
+  }
+
+  iree_hal_caching_allocator_benchmark_pool_deinitialize(&pool);
+
+  iree_hal_allocator_release(allocator);
+  iree_hal_allocator_release(heap_allocator);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_hal_caching_allocator_benchmark_threads
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_caching_allocator_benchmark_threads,
+    };
+    benchmark_def.user_data = (void*)1u;
+    iree_benchmark_register(iree_make_cstring_view("shared_1"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)4u;
+    iree_benchmark_register(iree_make_cstring_view("shared_4"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)16u;
+    iree_benchmark_register(iree_make_cstring_view("shared_16"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)((16u << 16) | 1u);
+    iree_benchmark_register(iree_make_cstring_view("magazines_1"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)((16u << 16) | 4u);
+    iree_benchmark_register(iree_make_cstring_view("magazines_4"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)((16u << 16) | 16u);
+    iree_benchmark_register(iree_make_cstring_view("magazines_16"),
+                            &benchmark_def);
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
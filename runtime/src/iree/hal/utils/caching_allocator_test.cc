@@ -0,0 +1,283 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/caching_allocator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+class CachingAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &heap_allocator_));
+  }
+
+  void TearDown() override { iree_hal_allocator_release(heap_allocator_); }
+
+  // Creates a caching allocator wrapping the heap allocator with |spec|.
+  iree_hal_allocator_t* CreateAllocator(const char* spec) {
+    iree_hal_allocator_t* allocator = NULL;
+    IREE_CHECK_OK(iree_hal_caching_allocator_create_from_spec(
+        iree_make_cstring_view(spec), heap_allocator_, iree_allocator_system(),
+        &allocator));
+    return allocator;
+  }
+
+  // Allocates a device-local buffer of |allocation_size| from |allocator|.
+  static iree_hal_buffer_t* Allocate(iree_hal_allocator_t* allocator,
+                                     iree_device_size_t allocation_size) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(allocator, params,
+                                                     allocation_size, &buffer));
+    return buffer;
+  }
+
+  iree_hal_allocator_t* heap_allocator_ = NULL;
+};
+
+// Tests that without size classes only buffers of the exact same size are
+// reused.
+TEST_F(CachingAllocatorTest, ExactSizeReuse) {
+  iree_hal_allocator_t* allocator = CreateAllocator("*=*;*;8");
+
+  iree_hal_buffer_t* buffer0 = Allocate(allocator, 1000);
+  EXPECT_EQ(iree_hal_buffer_allocation_size(buffer0), 1000);
+  void* storage0 = iree_hal_buffer_allocated_buffer(buffer0);
+  iree_hal_buffer_release(buffer0);
+
+  // Different size should miss.
+  iree_hal_buffer_t* buffer1 = Allocate(allocator, 1001);
+  EXPECT_EQ(iree_hal_buffer_allocation_size(buffer1), 1001);
+  iree_hal_buffer_release(buffer1);
+
+  // Same size should hit the cached buffer.
+  iree_hal_buffer_t* buffer2 = Allocate(allocator, 1000);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer2), storage0);
+  iree_hal_buffer_release(buffer2);
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator, &statistics);
+  EXPECT_EQ(statistics.pool_hit_count, 1);
+  EXPECT_EQ(statistics.pool_miss_count, 2);
+  EXPECT_EQ(statistics.pool_bytes_wasted, 0);
+#endif  // IREE_STATISTICS_ENABLE
+
+  iree_hal_allocator_release(allocator);
+}
+
+// Tests that with size classes buffers are reused for requests of similar
+// sizes and that the rounding waste is reported.
+TEST_F(CachingAllocatorTest, SizeClassReuse) {
+  iree_hal_allocator_t* allocator = CreateAllocator("*=*;*;8;size_classes");
+
+  // 1000 rounds up to the 1024 size class.
+  iree_hal_buffer_t* buffer0 = Allocate(allocator, 1000);
+  EXPECT_EQ(iree_hal_buffer_allocation_size(buffer0), 1024);
+  void* storage0 = iree_hal_buffer_allocated_buffer(buffer0);
+  iree_hal_buffer_release(buffer0);
+
+  // 1020 is in the same size class and should hit.
+  iree_hal_buffer_t* buffer1 = Allocate(allocator, 1020);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer1), storage0);
+  EXPECT_EQ(iree_hal_buffer_allocation_size(buffer1), 1024);
+
+  // 1025 is in the next size class (1152) and should miss.
+  iree_hal_buffer_t* buffer2 = Allocate(allocator, 1025);
+  EXPECT_EQ(iree_hal_buffer_allocation_size(buffer2), 1152);
+  iree_hal_buffer_release(buffer2);
+  iree_hal_buffer_release(buffer1);
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator, &statistics);
+  EXPECT_EQ(statistics.pool_hit_count, 1);
+  EXPECT_EQ(statistics.pool_miss_count, 2);
+  EXPECT_EQ(statistics.pool_bytes_wasted, 24 + 4 + 127);
+#endif  // IREE_STATISTICS_ENABLE
+
+  iree_hal_allocator_release(allocator);
+}
+
+// Tests that size class rounding bounds the waste of each allocation.
+TEST_F(CachingAllocatorTest, SizeClassWasteBounded) {
+  iree_hal_allocator_t* allocator = CreateAllocator("*=*;*;64;size_classes");
+  for (iree_device_size_t size = 1; size < 1024 * 1024; size = size * 3 + 1) {
+    iree_hal_buffer_t* buffer = Allocate(allocator, size);
+    iree_device_size_t allocation_size =
+        iree_hal_buffer_allocation_size(buffer);
+    EXPECT_GE(allocation_size, size);
+    EXPECT_LE(allocation_size - size, size / 8 + 1) << size;
+    iree_hal_buffer_release(buffer);
+  }
+  iree_hal_allocator_release(allocator);
+}
+
+// Tests that more free buffers than fit in the pool are released to the
+// underlying allocator and that cached buffers of other sizes are still found.
+TEST_F(CachingAllocatorTest, FreeListCapacity) {
+  iree_hal_allocator_t* allocator = CreateAllocator("*=*;*;2");
+
+  iree_hal_buffer_t* buffers[3] = {
+      Allocate(allocator, 100),
+      Allocate(allocator, 200),
+      Allocate(allocator, 300),
+  };
+  void* storage1 = iree_hal_buffer_allocated_buffer(buffers[1]);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(buffers); ++i) {
+    iree_hal_buffer_release(buffers[i]);
+  }
+
+  // The 300 byte buffer did not fit and should have been deallocated.
+  iree_hal_buffer_t* buffer = Allocate(allocator, 200);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer), storage1);
+  iree_hal_buffer_release(buffer);
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator, &statistics);
+  EXPECT_EQ(statistics.pool_hit_count, 1);
+  EXPECT_EQ(statistics.pool_miss_count, 3);
+#endif  // IREE_STATISTICS_ENABLE
+
+  IREE_EXPECT_OK(iree_hal_allocator_trim(allocator));
+  iree_hal_allocator_release(allocator);
+}
+
+// Tests that buffers released on a thread are reused from its magazine.
+TEST_F(CachingAllocatorTest, MagazineReuse) {
+  iree_hal_allocator_t* allocator = CreateAllocator("*=*;*;8;exact;4");
+
+  iree_hal_buffer_t* buffer0 = Allocate(allocator, 100);
+  void* storage0 = iree_hal_buffer_allocated_buffer(buffer0);
+  iree_hal_buffer_release(buffer0);
+
+  iree_hal_buffer_t* buffer1 = Allocate(allocator, 100);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer1), storage0);
+  iree_hal_buffer_release(buffer1);
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator, &statistics);
+  EXPECT_EQ(statistics.pool_hit_count, 1);
+  EXPECT_EQ(statistics.pool_miss_count, 1);
+#endif  // IREE_STATISTICS_ENABLE
+
+  iree_hal_allocator_release(allocator);
+}
+
+// Tests that overflowing a magazine returns buffers to the shared pool and
+// that trimming releases all buffers held in magazines.
+TEST_F(CachingAllocatorTest, MagazineOverflowAndTrim) {
+  iree_hal_allocator_t* allocator = CreateAllocator("*=*;*;8;exact;2");
+
+  std::vector<iree_hal_buffer_t*> buffers;
+  for (iree_device_size_t i = 0; i < 32; ++i) {
+    buffers.push_back(Allocate(allocator, 64 * (i % 4 + 1)));
+  }
+  for (iree_hal_buffer_t* buffer : buffers) iree_hal_buffer_release(buffer);
+  buffers.clear();
+
+  // All sizes should now be cached somewhere.
+  for (iree_device_size_t i = 0; i < 4; ++i) {
+    buffers.push_back(Allocate(allocator, 64 * (i + 1)));
+  }
+  for (iree_hal_buffer_t* buffer : buffers) iree_hal_buffer_release(buffer);
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator, &statistics);
+  EXPECT_EQ(statistics.pool_hit_count, 4);
+  EXPECT_EQ(statistics.pool_miss_count, 32);
+#endif  // IREE_STATISTICS_ENABLE
+
+  // Trimming should release everything back to the heap allocator.
+  IREE_EXPECT_OK(iree_hal_allocator_trim(allocator));
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_query_statistics(heap_allocator_, &statistics);
+  EXPECT_EQ(statistics.host_bytes_allocated, statistics.host_bytes_freed);
+#endif  // IREE_STATISTICS_ENABLE
+
+  iree_hal_allocator_release(allocator);
+}
+
+// Tests that a buffer left in another thread's magazine is reused instead of
+// allocating a new one.
+TEST_F(CachingAllocatorTest, MagazineSteal) {
+  iree_hal_allocator_t* allocator = CreateAllocator("*=*;*;8;exact;8");
+
+  void* storage0 = NULL;
+  std::thread thread([&]() {
+    iree_hal_buffer_t* buffer = Allocate(allocator, 100);
+    storage0 = iree_hal_buffer_allocated_buffer(buffer);
+    iree_hal_buffer_release(buffer);
+  });
+  thread.join();
+
+  iree_hal_buffer_t* buffer = Allocate(allocator, 100);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer), storage0);
+  iree_hal_buffer_release(buffer);
+
+  iree_hal_allocator_release(allocator);
+}
+
+// Tests concurrent allocation from many threads sharing magazines.
+TEST_F(CachingAllocatorTest, MagazineConcurrency) {
+  iree_hal_allocator_t* allocator = CreateAllocator("*=*;*;16;size_classes;2");
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t]() {
+      iree_hal_buffer_t* buffers[4] = {NULL};
+      for (int i = 0; i < 1000; ++i) {
+        int slot = (i + t) % IREE_ARRAYSIZE(buffers);
+        if (buffers[slot]) iree_hal_buffer_release(buffers[slot]);
+        buffers[slot] = Allocate(allocator, 256 + 64 * ((i * 7 + t) % 16));
+      }
+      for (iree_hal_buffer_t* buffer : buffers) iree_hal_buffer_release(buffer);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  IREE_EXPECT_OK(iree_hal_allocator_trim(allocator));
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(heap_allocator_, &statistics);
+  EXPECT_EQ(statistics.host_bytes_allocated, statistics.host_bytes_freed);
+#endif  // IREE_STATISTICS_ENABLE
+
+  iree_hal_allocator_release(allocator);
+}
+
+TEST_F(CachingAllocatorTest, InvalidPoolMode) {
+  iree_hal_allocator_t* allocator = NULL;
+  EXPECT_THAT(Status(iree_hal_caching_allocator_create_from_spec(
+                  IREE_SV("*=*;*;8;bogus"), heap_allocator_,
+                  iree_allocator_system(), &allocator)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -7,6 +7,7 @@
 #include "iree/hal/utils/file_registry.h"
 
 #include "iree/hal/utils/fd_file.h"
+#include "iree/hal/utils/io_uring_file.h"
 #include "iree/hal/utils/memory_file.h"
 
 IREE_API_EXPORT iree_status_t iree_hal_file_from_handle(
@@ -14,6 +15,16 @@ IREE_API_EXPORT iree_status_t iree_hal_file_from_handle(
     iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
     iree_io_file_handle_t* handle, iree_allocator_t host_allocator,
     iree_hal_file_t** out_file) {
+  return iree_hal_file_from_handle_with_flags(
+      device_allocator, queue_affinity, access, handle,
+      IREE_HAL_FILE_FROM_HANDLE_FLAG_NONE, host_allocator, out_file);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_file_from_handle_with_flags(
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle, iree_hal_file_from_handle_flags_t flags,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file) {
   IREE_ASSERT_ARGUMENT(handle);
   IREE_ASSERT_ARGUMENT(out_file);
   *out_file = NULL;
@@ -26,10 +37,24 @@ IREE_API_EXPORT iree_status_t iree_hal_file_from_handle(
           iree_hal_memory_file_wrap(device_allocator, queue_affinity, access,
                                     handle, host_allocator, out_file);
       break;
-    case IREE_IO_FILE_HANDLE_TYPE_FD:
+    case IREE_IO_FILE_HANDLE_TYPE_FD: {
+      // io_uring keeps many requests in flight for reads of large files but
+      // may be restricted in some environments; any failure to set it up
+      // falls back to synchronous pread/pwrite.
+      if (iree_all_bits_set(flags,
+                            IREE_HAL_FILE_FROM_HANDLE_FLAG_PREFER_IO_URING)) {
+        iree_hal_io_uring_file_params_t io_uring_params;
+        iree_hal_io_uring_file_params_initialize(&io_uring_params);
+        status = iree_hal_io_uring_file_from_handle(
+            access, handle, &io_uring_params, host_allocator, out_file);
+        if (iree_status_is_ok(status)) break;
+        IREE_TRACE_ZONE_APPEND_TEXT(z0, "io_uring unavailable");
+        iree_status_ignore(status);
+      }
       status = iree_hal_fd_file_from_handle(access, handle, host_allocator,
                                             out_file);
       break;
+    }
     default:
       status = iree_make_status(
           IREE_STATUS_UNIMPLEMENTED,
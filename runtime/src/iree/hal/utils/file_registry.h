@@ -15,6 +15,18 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Bitfield controlling which common host implementations may be used by
+// iree_hal_file_from_handle_with_flags.
+typedef uint32_t iree_hal_file_from_handle_flags_t;
+enum iree_hal_file_from_handle_flag_bits_t {
+  IREE_HAL_FILE_FROM_HANDLE_FLAG_NONE = 0u,
+  // Services IREE_IO_FILE_HANDLE_TYPE_FD handles with io_uring (see
+  // iree_hal_io_uring_file_t) when supported. If io_uring is unavailable or
+  // cannot be set up (unsupported kernel, seccomp, memlock limits, etc) the
+  // synchronous fd implementation is used instead.
+  IREE_HAL_FILE_FROM_HANDLE_FLAG_PREFER_IO_URING = 1u << 0,
+};
+
 // Creates a file backed by |handle| using a common host implementation.
 // Supported file handle types are determined based on compile configuration.
 //
@@ -28,6 +40,14 @@ IREE_API_EXPORT iree_status_t iree_hal_file_from_handle(
     iree_io_file_handle_t* handle, iree_allocator_t host_allocator,
     iree_hal_file_t** out_file);
 
+// Creates a file backed by |handle| as with iree_hal_file_from_handle with
+// |flags| opting in to additional implementations.
+IREE_API_EXPORT iree_status_t iree_hal_file_from_handle_with_flags(
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle, iree_hal_file_from_handle_flags_t flags,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -6,7 +6,10 @@
 
 #include "iree/hal/utils/file_transfer.h"
 
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
 
 //===----------------------------------------------------------------------===//
 // Configuration
@@ -35,6 +38,13 @@
 #define IREE_HAL_TRANSFER_CHUNKS_PER_WORKER 8
 #endif  // IREE_HAL_TRANSFER_CHUNKS_PER_WORKER
 
+#if !defined(IREE_HAL_TRANSFER_THREAD_CHUNK_SIZE)
+// Bytes per chunk when transferring with multiple threads. Each thread reserves
+// two chunks of staging so this is smaller than IREE_HAL_TRANSFER_CHUNK_SIZE to
+// bound staging memory consumption as the thread count grows.
+#define IREE_HAL_TRANSFER_THREAD_CHUNK_SIZE (8 * 1024 * 1024)
+#endif  // !IREE_HAL_TRANSFER_THREAD_CHUNK_SIZE
+
 //===----------------------------------------------------------------------===//
 // iree_hal_transfer_operation_t
 //===----------------------------------------------------------------------===//
@@ -151,6 +161,36 @@ typedef struct iree_hal_transfer_operation_t {
   iree_hal_transfer_worker_bitmask_t live_workers;
 } iree_hal_transfer_operation_t;
 
+// Returns the parameters used to allocate staging buffers for transfers in
+// |direction|. This optimizes for access patterns such as sequential writes
+// from the host when staging into the buffer and sequential cached reads from
+// the host when staging out of the buffer.
+static iree_hal_buffer_params_t iree_hal_transfer_staging_buffer_params(
+    iree_hal_transfer_direction_t direction,
+    iree_hal_queue_affinity_t queue_affinity) {
+  iree_hal_buffer_params_t params = {
+      .access = IREE_HAL_MEMORY_ACCESS_ALL,
+      // TODO(benvanik): make staging alignment an option/device query?
+      .min_alignment = 64,
+      .queue_affinity = queue_affinity,
+  };
+  if (direction == IREE_HAL_TRANSFER_READ_FILE_TO_BUFFER) {
+    params.type = IREE_HAL_MEMORY_TYPE_OPTIMAL_FOR_HOST |
+                  IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                   IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
+                   IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_SEQUENTIAL_WRITE;
+  } else {
+    params.type = IREE_HAL_MEMORY_TYPE_OPTIMAL_FOR_HOST |
+                  IREE_HAL_MEMORY_TYPE_HOST_CACHED |
+                  IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                   IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
+                   IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_RANDOM;
+  }
+  return params;
+}
+
 static void iree_hal_transfer_operation_release(
     iree_hal_transfer_operation_t* operation);
 static void iree_hal_transfer_operation_destroy(
@@ -498,7 +538,9 @@ static iree_status_t iree_hal_transfer_worker_copy_file_to_buffer(
       .semaphores = &worker->semaphore,
       .payload_values = &wait_timepoint,
   };
-  uint64_t signal_timepoint = ++worker->pending_timepoint;
+  // The worker timeline only advances once the copy has been submitted so that
+  // the final dealloca does not wait on a timepoint that will never signal.
+  uint64_t signal_timepoint = worker->pending_timepoint + 1;
   iree_hal_semaphore_list_t signal_semaphore_list = {
       .count = 1,
       .semaphores = &worker->semaphore,
@@ -525,6 +567,9 @@ static iree_status_t iree_hal_transfer_worker_copy_file_to_buffer(
         operation->buffer_offset + transfer_offset, transfer_length,
         IREE_HAL_COPY_FLAG_NONE);
   }
+  if (iree_status_is_ok(status)) {
+    worker->pending_timepoint = signal_timepoint;
+  }
 
   // Wait for the copy to complete and tick again if we expect there to be more
   // work. If there are no more chunks to copy (or they are spoken for by other
@@ -567,20 +612,9 @@ static iree_status_t iree_hal_transfer_operation_launch_read(
   IREE_ASSERT(operation->direction == IREE_HAL_TRANSFER_READ_FILE_TO_BUFFER);
 
   // Staging buffers get allocated based on the direction we are transferring.
-  // This optimizes for access patterns such as sequential writes from the host
-  // when staging into the buffer and sequential cached reads from the host when
-  // staging out of the buffer.
-  iree_hal_buffer_params_t staging_buffer_params = {
-      .access = IREE_HAL_MEMORY_ACCESS_ALL,
-      // TODO(benvanik): make staging alignment an option/device query?
-      .min_alignment = 64,
-      .queue_affinity = operation->queue_affinity,
-      .type = IREE_HAL_MEMORY_TYPE_OPTIMAL_FOR_HOST |
-              IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
-      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
-               IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
-               IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_SEQUENTIAL_WRITE,
-  };
+  iree_hal_buffer_params_t staging_buffer_params =
+      iree_hal_transfer_staging_buffer_params(operation->direction,
+                                              operation->queue_affinity);
 
   // Queue the staging buffer allocation.
   // When it completes we'll do the first host->device copy via mapping.
@@ -666,16 +700,18 @@ static iree_status_t iree_hal_transfer_worker_copy_buffer_to_staging(
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)transfer_length);
 
   // Timeline increments by one.
+  uint64_t wait_timepoint = worker->pending_timepoint;
   iree_hal_semaphore_list_t wait_semaphore_list = {
       .count = 1,
       .semaphores = &worker->semaphore,
-      .payload_values = &worker->pending_timepoint,
+      .payload_values = &wait_timepoint,
   };
-  ++worker->pending_timepoint;
+  // Advanced only once the copy has been submitted (as with reads).
+  uint64_t signal_timepoint = worker->pending_timepoint + 1;
   iree_hal_semaphore_list_t signal_semaphore_list = {
       .count = 1,
       .semaphores = &worker->semaphore,
-      .payload_values = &worker->pending_timepoint,
+      .payload_values = &signal_timepoint,
   };
 
   // Track the pending copy operation so we know where to place it in the file.
@@ -691,6 +727,7 @@ static iree_status_t iree_hal_transfer_worker_copy_buffer_to_staging(
 
   // Wait for the copy to complete so we can write it to the file.
   if (iree_status_is_ok(status)) {
+    worker->pending_timepoint = signal_timepoint;
     status = iree_loop_wait_one(
         loop,
         iree_hal_semaphore_await(worker->semaphore, worker->pending_timepoint),
@@ -758,21 +795,9 @@ static iree_status_t iree_hal_transfer_operation_launch_write(
   IREE_ASSERT(operation->direction == IREE_HAL_TRANSFER_WRITE_BUFFER_TO_FILE);
 
   // Staging buffers get allocated based on the direction we are transferring.
-  // This optimizes for access patterns such as sequential writes from the host
-  // when staging into the buffer and sequential cached reads from the host when
-  // staging out of the buffer.
-  iree_hal_buffer_params_t staging_buffer_params = {
-      .access = IREE_HAL_MEMORY_ACCESS_ALL,
-      // TODO(benvanik): make staging alignment an option/device query?
-      .min_alignment = 64,
-      .queue_affinity = operation->queue_affinity,
-      .type = IREE_HAL_MEMORY_TYPE_OPTIMAL_FOR_HOST |
-              IREE_HAL_MEMORY_TYPE_HOST_CACHED |
-              IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
-      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
-               IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
-               IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_RANDOM,
-  };
+  iree_hal_buffer_params_t staging_buffer_params =
+      iree_hal_transfer_staging_buffer_params(operation->direction,
+                                              operation->queue_affinity);
 
   // Queue the staging buffer allocation.
   // When it completes we'll signal each worker to start its first transfer.
@@ -825,6 +850,693 @@ static iree_status_t iree_hal_transfer_operation_launch_write(
   return iree_ok_status();  // return ok as loop is fine but operation is not
 }
 
+//===----------------------------------------------------------------------===//
+// iree_hal_file_transfer_pool_t
+//===----------------------------------------------------------------------===//
+
+// Maximum number of threads that can be used by a parallel transfer.
+#define IREE_HAL_TRANSFER_THREAD_MAX_COUNT 64
+
+// Function run by each thread of a pool job with the thread ordinal in
+// [0, thread_count). Ordinal 0 is always the thread that issued the job.
+typedef void(IREE_API_PTR* iree_hal_file_transfer_pool_fn_t)(
+    void* user_data, iree_host_size_t thread_ordinal);
+
+typedef struct iree_hal_file_transfer_pool_thread_t {
+  // Parent pool the thread is a member of.
+  iree_hal_file_transfer_pool_t* pool;
+  // Ordinal of the thread in [1, thread_count).
+  iree_host_size_t ordinal;
+  // Last job generation the thread ran.
+  int32_t generation;
+  // Thread handle; releasing it joins the thread.
+  iree_thread_t* handle;
+} iree_hal_file_transfer_pool_thread_t;
+
+struct iree_hal_file_transfer_pool_t {
+  iree_allocator_t host_allocator;
+  // Total number of threads including the thread issuing jobs.
+  iree_host_size_t thread_count;
+  // Held by the transfer using the pool.
+  iree_slim_mutex_t mutex;
+  // Current job; valid while |mutex| is held and a job is running.
+  iree_hal_file_transfer_pool_fn_t job_fn;
+  void* job_user_data;
+  // Number of threads participating in the current job.
+  iree_host_size_t job_thread_count;
+  // Incremented to start a job.
+  iree_atomic_int32_t generation;
+  // Number of pool threads that have not yet finished the current job.
+  iree_atomic_int32_t pending_count;
+  // Set when the pool threads should exit.
+  iree_atomic_int32_t exit_requested;
+  // Posted when |generation| or |exit_requested| change.
+  iree_notification_t start_notification;
+  // Posted when |pending_count| reaches 0.
+  iree_notification_t done_notification;
+  // Pool threads with ordinals [1, thread_count).
+  iree_host_size_t pool_thread_count;
+  iree_hal_file_transfer_pool_thread_t threads[];
+};
+
+static bool iree_hal_file_transfer_pool_thread_should_wake(void* arg) {
+  iree_hal_file_transfer_pool_thread_t* thread =
+      (iree_hal_file_transfer_pool_thread_t*)arg;
+  return iree_atomic_load(&thread->pool->exit_requested,
+                          iree_memory_order_acquire) ||
+         iree_atomic_load(&thread->pool->generation,
+                          iree_memory_order_acquire) != thread->generation;
+}
+
+static int iree_hal_file_transfer_pool_thread_main(void* entry_arg) {
+  iree_hal_file_transfer_pool_thread_t* thread =
+      (iree_hal_file_transfer_pool_thread_t*)entry_arg;
+  iree_hal_file_transfer_pool_t* pool = thread->pool;
+  for (;;) {
+    iree_notification_await(&pool->start_notification,
+                            iree_hal_file_transfer_pool_thread_should_wake,
+                            thread, iree_infinite_timeout());
+    if (iree_atomic_load(&pool->exit_requested, iree_memory_order_acquire)) {
+      break;
+    }
+    thread->generation =
+        iree_atomic_load(&pool->generation, iree_memory_order_acquire);
+    if (thread->ordinal < pool->job_thread_count) {
+      pool->job_fn(pool->job_user_data, thread->ordinal);
+    }
+    if (iree_atomic_fetch_sub(&pool->pending_count, 1,
+                              iree_memory_order_acq_rel) == 1) {
+      iree_notification_post(&pool->done_notification, IREE_ALL_WAITERS);
+    }
+  }
+  return 0;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_file_transfer_pool_create(
+    iree_host_size_t thread_count, iree_allocator_t host_allocator,
+    iree_hal_file_transfer_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  if (thread_count < 1 || thread_count > IREE_HAL_TRANSFER_THREAD_MAX_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "file transfer thread count %" PRIhsz
+                            " out of range [1, %d]",
+                            thread_count, IREE_HAL_TRANSFER_THREAD_MAX_COUNT);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)thread_count);
+
+  iree_hal_file_transfer_pool_t* pool = NULL;
+  const iree_host_size_t pool_thread_count = thread_count - 1;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              host_allocator,
+              sizeof(*pool) + pool_thread_count * sizeof(pool->threads[0]),
+              (void**)&pool));
+  pool->host_allocator = host_allocator;
+  pool->thread_count = thread_count;
+  iree_slim_mutex_initialize(&pool->mutex);
+  iree_atomic_store(&pool->generation, 0, iree_memory_order_relaxed);
+  iree_atomic_store(&pool->pending_count, 0, iree_memory_order_relaxed);
+  iree_atomic_store(&pool->exit_requested, 0, iree_memory_order_relaxed);
+  iree_notification_initialize(&pool->start_notification);
+  iree_notification_initialize(&pool->done_notification);
+
+  iree_thread_create_params_t thread_params;
+  memset(&thread_params, 0, sizeof(thread_params));
+  thread_params.name = iree_make_cstring_view("iree-hal-transfer");
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < pool_thread_count; ++i) {
+    iree_hal_file_transfer_pool_thread_t* thread = &pool->threads[i];
+    thread->pool = pool;
+    thread->ordinal = i + 1;
+    thread->generation = 0;
+    status = iree_thread_create(iree_hal_file_transfer_pool_thread_main,
+                                thread, thread_params, host_allocator,
+                                &thread->handle);
+    if (!iree_status_is_ok(status)) break;
+    pool->pool_thread_count = i + 1;
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_pool = pool;
+  } else {
+    iree_hal_file_transfer_pool_free(pool);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT void iree_hal_file_transfer_pool_free(
+    iree_hal_file_transfer_pool_t* pool) {
+  if (!pool) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_atomic_store(&pool->exit_requested, 1, iree_memory_order_release);
+  iree_notification_post(&pool->start_notification, IREE_ALL_WAITERS);
+  for (iree_host_size_t i = 0; i < pool->pool_thread_count; ++i) {
+    // Releasing the thread joins it.
+    iree_thread_release(pool->threads[i].handle);
+  }
+  iree_notification_deinitialize(&pool->done_notification);
+  iree_notification_deinitialize(&pool->start_notification);
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  iree_allocator_free(pool->host_allocator, pool);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static bool iree_hal_file_transfer_pool_is_done(void* arg) {
+  iree_hal_file_transfer_pool_t* pool = (iree_hal_file_transfer_pool_t*)arg;
+  return iree_atomic_load(&pool->pending_count, iree_memory_order_acquire) ==
+         0;
+}
+
+// Runs |fn| on |thread_count| threads of |pool| (including the calling thread
+// as ordinal 0) and returns once all have finished. If the pool is in use by
+// another transfer only the calling thread runs and |out_thread_count| is 1.
+static void iree_hal_file_transfer_pool_run(
+    iree_hal_file_transfer_pool_t* pool, iree_host_size_t thread_count,
+    iree_hal_file_transfer_pool_fn_t fn, void* user_data,
+    iree_host_size_t* out_thread_count) {
+  if (thread_count <= 1 || !iree_slim_mutex_try_lock(&pool->mutex)) {
+    *out_thread_count = 1;
+    fn(user_data, 0);
+    return;
+  }
+  *out_thread_count = thread_count;
+  pool->job_fn = fn;
+  pool->job_user_data = user_data;
+  pool->job_thread_count = thread_count;
+  iree_atomic_store(&pool->pending_count, (int32_t)pool->pool_thread_count,
+                    iree_memory_order_release);
+  iree_atomic_fetch_add(&pool->generation, 1, iree_memory_order_acq_rel);
+  iree_notification_post(&pool->start_notification, IREE_ALL_WAITERS);
+  fn(user_data, 0);
+  iree_notification_await(&pool->done_notification,
+                          iree_hal_file_transfer_pool_is_done, pool,
+                          iree_infinite_timeout());
+  pool->job_fn = NULL;
+  pool->job_user_data = NULL;
+  iree_slim_mutex_unlock(&pool->mutex);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_transfer_parallel_operation_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_transfer_parallel_operation_t
+    iree_hal_transfer_parallel_operation_t;
+
+// A host thread staging chunks of a parallel transfer operation.
+// Each thread owns two staging chunks so that the file I/O for one chunk can
+// overlap with the device copy into or out of the other. Threads claim chunks
+// from the operation until there are none remaining such that faster threads
+// take on more of the transfer.
+typedef struct iree_hal_transfer_thread_t {
+  // Parent operation this thread is a part of.
+  iree_hal_transfer_parallel_operation_t* operation;
+  // Aligned offset into the staging buffer of the first of two chunks.
+  iree_device_size_t staging_buffer_offset;
+  // Semaphore representing the timeline of the thread. The payload is a
+  // monotonically increasing operation count.
+  iree_hal_semaphore_t* semaphore;
+  // Last timepoint submitted to the device by the thread.
+  uint64_t pending_timepoint;
+  // Timepoint at which each staging chunk is no longer in use by the device.
+  uint64_t slot_timepoints[2];
+  // Status of the thread after it has exited.
+  iree_status_t status;
+} iree_hal_transfer_thread_t;
+
+// Manages a transfer split across multiple host threads.
+// Unlike iree_hal_transfer_operation_t this does not tick the loop once the
+// transfer has begun: the loop callback runs the threads to completion and
+// frees the operation after scheduling the staging buffer deallocation.
+typedef struct iree_hal_transfer_parallel_operation_t {
+  // Device this transfer operation is acting on.
+  iree_hal_device_t* device;
+  // Queue affinity all operations should be assigned.
+  iree_hal_queue_affinity_t queue_affinity;
+  // Used to associate tracing events with this operation.
+  IREE_TRACE(int32_t trace_id;)
+
+  // Direction of the operation (read file->buffer or write buffer->file).
+  iree_hal_transfer_direction_t direction;
+  // Retained file resource.
+  iree_hal_file_t* file;
+  // Offset into the file where the operation begins.
+  uint64_t file_offset;
+  // Retained buffer resource.
+  iree_hal_buffer_t* buffer;
+  // Offset into the buffer where the operation begins.
+  iree_device_size_t buffer_offset;
+  // Total length of the operation.
+  iree_device_size_t length;
+
+  // Original user semaphores to signal at the end of the transfer operation.
+  // Contents are stored at the end of the struct.
+  iree_hal_semaphore_list_t signal_semaphore_list;
+
+  // Shared staging buffer; contains two chunks for each thread.
+  iree_hal_buffer_t* staging_buffer;
+  // Size of each chunk in bytes. The last chunk may be smaller.
+  iree_device_size_t chunk_size;
+  // Total number of chunks in the transfer.
+  int64_t chunk_count;
+  // Index of the next chunk to be claimed by a thread.
+  iree_atomic_int64_t next_chunk;
+  // Set when any thread fails so that others stop claiming chunks.
+  iree_atomic_int32_t failed;
+
+  // Pool whose threads run the operation.
+  iree_hal_file_transfer_pool_t* pool;
+  // Total number of threads participating in the operation.
+  iree_host_size_t thread_count;
+  // State for each thread in the operation.
+  // Stored at the end of the struct.
+  iree_hal_transfer_thread_t* threads;
+} iree_hal_transfer_parallel_operation_t;
+
+static void iree_hal_transfer_parallel_operation_destroy(
+    iree_hal_transfer_parallel_operation_t* operation);
+
+static iree_status_t iree_hal_transfer_parallel_operation_create(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_transfer_direction_t direction, iree_hal_file_t* file,
+    uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length,
+    iree_hal_file_transfer_options_t options,
+    iree_hal_transfer_parallel_operation_t** out_operation) {
+  IREE_ASSERT_ARGUMENT(out_operation);
+  *out_operation = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_allocator_t host_allocator = iree_hal_device_host_allocator(device);
+
+  // Determine how many threads are required. There's no use in having more
+  // threads than chunks as each thread will claim at least one.
+  iree_device_size_t chunk_size = options.chunk_size;
+  if (chunk_size == IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT) {
+    chunk_size = iree_min(IREE_HAL_TRANSFER_THREAD_CHUNK_SIZE, length);
+  }
+  chunk_size = iree_device_align(chunk_size, 64);
+  iree_device_size_t chunk_count =
+      iree_device_size_ceil_div(length, chunk_size);
+  iree_host_size_t thread_count =
+      iree_min(options.pool->thread_count,
+               iree_min((iree_host_size_t)chunk_count,
+                        IREE_HAL_TRANSFER_THREAD_MAX_COUNT));
+
+  // Calculate total size of the structure with all its associated data.
+  iree_hal_transfer_parallel_operation_t* operation = NULL;
+  iree_host_size_t total_size = sizeof(*operation);
+  iree_host_size_t semaphores_offset =
+      iree_host_align(total_size, iree_max_align_t);
+  total_size = semaphores_offset + sizeof(signal_semaphore_list.semaphores[0]) *
+                                       signal_semaphore_list.count;
+  iree_host_size_t payload_values_offset =
+      iree_host_align(total_size, iree_max_align_t);
+  total_size =
+      payload_values_offset + sizeof(signal_semaphore_list.payload_values[0]) *
+                                  signal_semaphore_list.count;
+  iree_host_size_t thread_offset =
+      iree_host_align(total_size, iree_max_align_t);
+  total_size = thread_offset + sizeof(operation->threads[0]) * thread_count;
+
+  // Allocate and initialize the struct.
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, total_size, (void**)&operation));
+  operation->device = device;
+  iree_hal_device_retain(device);
+  operation->queue_affinity = queue_affinity;
+  operation->direction = direction;
+  operation->file = file;
+  iree_hal_file_retain(file);
+  operation->file_offset = file_offset;
+  operation->buffer = buffer;
+  iree_hal_buffer_retain(buffer);
+  operation->buffer_offset = buffer_offset;
+  operation->length = length;
+  operation->chunk_size = chunk_size;
+  operation->chunk_count = (int64_t)chunk_count;
+  iree_atomic_store(&operation->next_chunk, 0, iree_memory_order_relaxed);
+  iree_atomic_store(&operation->failed, 0, iree_memory_order_relaxed);
+  operation->pool = options.pool;
+  operation->thread_count = thread_count;
+
+  // Assign all pointers to the struct suffix storage.
+  operation->signal_semaphore_list.count = signal_semaphore_list.count;
+  operation->signal_semaphore_list.semaphores =
+      (iree_hal_semaphore_t**)((uintptr_t)operation + semaphores_offset);
+  operation->signal_semaphore_list.payload_values =
+      (uint64_t*)((uintptr_t)operation + payload_values_offset);
+  operation->threads =
+      (iree_hal_transfer_thread_t*)((uintptr_t)operation + thread_offset);
+
+  IREE_TRACE({
+    static iree_atomic_int32_t next_trace_id = IREE_ATOMIC_VAR_INIT(0);
+    operation->trace_id =
+        iree_atomic_fetch_add(&next_trace_id, 1, iree_memory_order_seq_cst);
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, operation->trace_id);
+  });
+
+  // Retain each signal semaphore for ourselves as we don't know if the caller
+  // will hold them for the lifetime of the operation.
+  memcpy(operation->signal_semaphore_list.semaphores,
+         signal_semaphore_list.semaphores,
+         sizeof(signal_semaphore_list.semaphores[0]) *
+             signal_semaphore_list.count);
+  memcpy(operation->signal_semaphore_list.payload_values,
+         signal_semaphore_list.payload_values,
+         sizeof(signal_semaphore_list.payload_values[0]) *
+             signal_semaphore_list.count);
+  for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+    iree_hal_semaphore_retain(signal_semaphore_list.semaphores[i]);
+  }
+
+  // Initialize all threads. The threads themselves are not created until the
+  // transfer begins.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < thread_count; ++i) {
+    iree_hal_transfer_thread_t* thread = &operation->threads[i];
+    thread->operation = operation;
+    thread->staging_buffer_offset = chunk_size * 2 * i;
+    status = iree_hal_semaphore_create(
+        device, IREE_HAL_QUEUE_AFFINITY_ANY, thread->pending_timepoint,
+        IREE_HAL_SEMAPHORE_FLAG_DEFAULT, &thread->semaphore);
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "thread count: ");
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)thread_count);
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "chunk size: ");
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)chunk_size);
+    *out_operation = operation;
+  } else {
+    iree_hal_transfer_parallel_operation_destroy(operation);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_transfer_parallel_operation_destroy(
+    iree_hal_transfer_parallel_operation_t* operation) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, operation->trace_id);
+  iree_allocator_t host_allocator =
+      iree_hal_device_host_allocator(operation->device);
+
+  for (iree_host_size_t i = 0; i < operation->thread_count; ++i) {
+    iree_hal_transfer_thread_t* thread = &operation->threads[i];
+    iree_hal_semaphore_release(thread->semaphore);
+    iree_status_ignore(thread->status);
+  }
+  iree_hal_buffer_release(operation->staging_buffer);
+  for (iree_host_size_t i = 0; i < operation->signal_semaphore_list.count;
+       ++i) {
+    iree_hal_semaphore_release(operation->signal_semaphore_list.semaphores[i]);
+  }
+  iree_hal_buffer_release(operation->buffer);
+  iree_hal_file_release(operation->file);
+  iree_hal_device_release(operation->device);
+
+  iree_allocator_free(host_allocator, operation);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Claims the next chunk of the transfer for the calling thread.
+// Returns false if there are no chunks remaining or the operation has failed.
+static bool iree_hal_transfer_parallel_operation_claim_chunk(
+    iree_hal_transfer_parallel_operation_t* operation,
+    iree_device_size_t* out_transfer_offset,
+    iree_device_size_t* out_transfer_length) {
+  if (iree_atomic_load(&operation->failed, iree_memory_order_acquire)) {
+    return false;
+  }
+  int64_t chunk_index = iree_atomic_fetch_add(&operation->next_chunk, 1,
+                                              iree_memory_order_relaxed);
+  if (chunk_index >= operation->chunk_count) return false;
+  *out_transfer_offset =
+      (iree_device_size_t)chunk_index * operation->chunk_size;
+  *out_transfer_length = iree_min(operation->length - *out_transfer_offset,
+                                  operation->chunk_size);
+  return true;
+}
+
+// Issues an asynchronous device copy between the staging chunk in |slot| of
+// |thread| and the buffer. Copies issued by a thread are chained on its
+// timeline so that they retire in order.
+static iree_status_t iree_hal_transfer_thread_queue_copy(
+    iree_hal_transfer_thread_t* thread, int slot,
+    iree_device_size_t transfer_offset, iree_device_size_t transfer_length) {
+  iree_hal_transfer_parallel_operation_t* operation = thread->operation;
+  uint64_t wait_timepoint = thread->pending_timepoint;
+  iree_hal_semaphore_list_t wait_semaphore_list = {
+      .count = 1,
+      .semaphores = &thread->semaphore,
+      .payload_values = &wait_timepoint,
+  };
+  uint64_t signal_timepoint = wait_timepoint + 1;
+  iree_hal_semaphore_list_t signal_semaphore_list = {
+      .count = 1,
+      .semaphores = &thread->semaphore,
+      .payload_values = &signal_timepoint,
+  };
+  iree_device_size_t staging_offset =
+      thread->staging_buffer_offset + slot * operation->chunk_size;
+  iree_status_t status = iree_ok_status();
+  if (operation->direction == IREE_HAL_TRANSFER_READ_FILE_TO_BUFFER) {
+    status = iree_hal_device_queue_copy(
+        operation->device, operation->queue_affinity, wait_semaphore_list,
+        signal_semaphore_list, operation->staging_buffer, staging_offset,
+        operation->buffer, operation->buffer_offset + transfer_offset,
+        transfer_length, IREE_HAL_COPY_FLAG_NONE);
+  } else {
+    status = iree_hal_device_queue_copy(
+        operation->device, operation->queue_affinity, wait_semaphore_list,
+        signal_semaphore_list, operation->buffer,
+        operation->buffer_offset + transfer_offset, operation->staging_buffer,
+        staging_offset, transfer_length, IREE_HAL_COPY_FLAG_NONE);
+  }
+  if (iree_status_is_ok(status)) {
+    thread->pending_timepoint = signal_timepoint;
+    thread->slot_timepoints[slot] = signal_timepoint;
+  }
+  return status;
+}
+
+// Reads chunks from the file into alternating staging chunks and queues the
+// copies into the target buffer. The read of each chunk overlaps with the copy
+// of the previous one.
+static iree_status_t iree_hal_transfer_thread_run_read(
+    iree_hal_transfer_thread_t* thread) {
+  iree_hal_transfer_parallel_operation_t* operation = thread->operation;
+  iree_device_size_t transfer_offset = 0;
+  iree_device_size_t transfer_length = 0;
+  for (int slot = 0; iree_hal_transfer_parallel_operation_claim_chunk(
+           operation, &transfer_offset, &transfer_length);
+       slot ^= 1) {
+    // Wait for the device to finish copying out of the staging chunk from the
+    // last time it was used.
+    IREE_RETURN_IF_ERROR(iree_hal_semaphore_wait(
+        thread->semaphore, thread->slot_timepoints[slot],
+        iree_infinite_timeout(), IREE_HAL_WAIT_FLAG_DEFAULT));
+    IREE_RETURN_IF_ERROR(iree_hal_file_read(
+        operation->file, operation->file_offset + transfer_offset,
+        operation->staging_buffer,
+        thread->staging_buffer_offset + slot * operation->chunk_size,
+        transfer_length));
+    IREE_RETURN_IF_ERROR(iree_hal_transfer_thread_queue_copy(
+        thread, slot, transfer_offset, transfer_length));
+  }
+  return iree_ok_status();
+}
+
+// Queues copies from the source buffer into alternating staging chunks and
+// writes them to the file. The copy of each chunk overlaps with the write of
+// the previous one.
+static iree_status_t iree_hal_transfer_thread_run_write(
+    iree_hal_transfer_thread_t* thread) {
+  iree_hal_transfer_parallel_operation_t* operation = thread->operation;
+  int slot = 0;
+  iree_device_size_t transfer_offset = 0;
+  iree_device_size_t transfer_length = 0;
+  bool has_chunk = iree_hal_transfer_parallel_operation_claim_chunk(
+      operation, &transfer_offset, &transfer_length);
+  if (has_chunk) {
+    IREE_RETURN_IF_ERROR(iree_hal_transfer_thread_queue_copy(
+        thread, slot, transfer_offset, transfer_length));
+  }
+  while (has_chunk) {
+    // Queue the copy of the next chunk into the other staging chunk. Its prior
+    // contents were written to the file on the last iteration.
+    iree_device_size_t next_offset = 0;
+    iree_device_size_t next_length = 0;
+    bool has_next_chunk = iree_hal_transfer_parallel_operation_claim_chunk(
+        operation, &next_offset, &next_length);
+    if (has_next_chunk) {
+      IREE_RETURN_IF_ERROR(iree_hal_transfer_thread_queue_copy(
+          thread, slot ^ 1, next_offset, next_length));
+    }
+
+    // Wait for the current chunk to land in staging and flush it to the file.
+    IREE_RETURN_IF_ERROR(iree_hal_semaphore_wait(
+        thread->semaphore, thread->slot_timepoints[slot],
+        iree_infinite_timeout(), IREE_HAL_WAIT_FLAG_DEFAULT));
+    IREE_RETURN_IF_ERROR(iree_hal_file_write(
+        operation->file, operation->file_offset + transfer_offset,
+        operation->staging_buffer,
+        thread->staging_buffer_offset + slot * operation->chunk_size,
+        transfer_length));
+
+    has_chunk = has_next_chunk;
+    transfer_offset = next_offset;
+    transfer_length = next_length;
+    slot ^= 1;
+  }
+  return iree_ok_status();
+}
+
+// Runs |thread| until there are no more chunks to claim or it fails.
+// The first failure stops all other threads from claiming new chunks.
+static void iree_hal_transfer_thread_run(iree_hal_transfer_thread_t* thread) {
+  iree_hal_transfer_parallel_operation_t* operation = thread->operation;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)operation->trace_id);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)(thread - operation->threads));
+  iree_status_t status =
+      operation->direction == IREE_HAL_TRANSFER_READ_FILE_TO_BUFFER
+          ? iree_hal_transfer_thread_run_read(thread)
+          : iree_hal_transfer_thread_run_write(thread);
+  if (!iree_status_is_ok(status)) {
+    iree_atomic_store(&operation->failed, 1, iree_memory_order_release);
+  }
+  thread->status = status;
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static void iree_hal_transfer_thread_pool_fn(void* user_data,
+                                             iree_host_size_t thread_ordinal) {
+  iree_hal_transfer_parallel_operation_t* operation =
+      (iree_hal_transfer_parallel_operation_t*)user_data;
+  iree_hal_transfer_thread_run(&operation->threads[thread_ordinal]);
+}
+
+// Runs all threads of the transfer to completion and then schedules the
+// staging buffer deallocation to signal the user semaphores. Frees the
+// operation.
+static iree_status_t iree_hal_transfer_parallel_operation_run(
+    void* user_data, iree_loop_t loop, iree_status_t status) {
+  iree_hal_transfer_parallel_operation_t* operation =
+      (iree_hal_transfer_parallel_operation_t*)user_data;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)operation->trace_id);
+
+  if (iree_status_is_ok(status)) {
+    // The calling thread acts as the first thread. If the pool is busy with
+    // another transfer the calling thread claims all of the chunks.
+    iree_host_size_t used_thread_count = 0;
+    iree_hal_file_transfer_pool_run(
+        operation->pool, operation->thread_count,
+        iree_hal_transfer_thread_pool_fn, operation, &used_thread_count);
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)used_thread_count);
+  } else {
+    operation->threads[0].status = status;
+  }
+
+  // Deallocating the staging buffer can only happen after all copies into or
+  // out of it have completed so we wait on every thread timeline.
+  iree_hal_semaphore_list_t wait_semaphore_list = {
+      .count = operation->thread_count,
+      .semaphores = (iree_hal_semaphore_t**)iree_alloca(
+          operation->thread_count * sizeof(iree_hal_semaphore_t*)),
+      .payload_values =
+          (uint64_t*)iree_alloca(operation->thread_count * sizeof(uint64_t)),
+  };
+  bool failed = false;
+  for (iree_host_size_t i = 0; i < operation->thread_count; ++i) {
+    iree_hal_transfer_thread_t* thread = &operation->threads[i];
+    wait_semaphore_list.semaphores[i] = thread->semaphore;
+    wait_semaphore_list.payload_values[i] = thread->pending_timepoint;
+    failed = failed || !iree_status_is_ok(thread->status);
+  }
+
+  // When the dealloca completes signal the original semaphores passed in to the
+  // operation. If the transfer failed then we signal them all to failure.
+  iree_hal_semaphore_list_t signal_semaphore_list =
+      operation->signal_semaphore_list;
+  if (failed) {
+    for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+      signal_semaphore_list.payload_values[i] =
+          IREE_HAL_SEMAPHORE_FAILURE_VALUE;
+    }
+  }
+
+  // If the dealloca failed we don't have a great way of letting anyone know.
+  // We'll just drop it on the floor for now and let the buffer be freed by
+  // reference counting.
+  iree_status_ignore(iree_hal_device_queue_dealloca(
+      operation->device, operation->queue_affinity, wait_semaphore_list,
+      signal_semaphore_list, operation->staging_buffer,
+      IREE_HAL_DEALLOCA_FLAG_NONE));
+
+  iree_hal_transfer_parallel_operation_destroy(operation);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Begins the parallel transfer operation after |wait_semaphore_list| is
+// satisfied. Ownership of |operation| is transferred to the loop on success.
+static iree_status_t iree_hal_transfer_parallel_operation_launch(
+    iree_hal_transfer_parallel_operation_t* operation,
+    iree_hal_semaphore_list_t wait_semaphore_list, iree_loop_t loop) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)operation->trace_id);
+
+  // Staging buffers get allocated based on the direction we are transferring.
+  iree_hal_buffer_params_t staging_buffer_params =
+      iree_hal_transfer_staging_buffer_params(operation->direction,
+                                              operation->queue_affinity);
+
+  // Queue the staging buffer allocation. Both staging chunks of each thread are
+  // available once it completes.
+  iree_hal_semaphore_list_t alloca_semaphore_list = {
+      .count = operation->thread_count,
+      .semaphores =
+          iree_alloca(sizeof(iree_hal_semaphore_t*) * operation->thread_count),
+      .payload_values = iree_alloca(sizeof(uint64_t) * operation->thread_count),
+  };
+  for (iree_host_size_t i = 0; i < operation->thread_count; ++i) {
+    iree_hal_transfer_thread_t* thread = &operation->threads[i];
+    alloca_semaphore_list.semaphores[i] = thread->semaphore;
+    alloca_semaphore_list.payload_values[i] = ++thread->pending_timepoint;
+    thread->slot_timepoints[0] = thread->pending_timepoint;
+    thread->slot_timepoints[1] = thread->pending_timepoint;
+  }
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_device_queue_alloca(
+              operation->device, operation->queue_affinity, wait_semaphore_list,
+              alloca_semaphore_list, IREE_HAL_ALLOCATOR_POOL_DEFAULT,
+              staging_buffer_params,
+              operation->chunk_size * 2 * operation->thread_count,
+              IREE_HAL_ALLOCA_FLAG_NONE, &operation->staging_buffer));
+
+  // All threads start from the same point so we only need to wait on one.
+  iree_hal_transfer_thread_t* thread = &operation->threads[0];
+  iree_status_t status = iree_loop_wait_one(
+      loop,
+      iree_hal_semaphore_await(thread->semaphore, thread->pending_timepoint),
+      iree_infinite_timeout(), iree_hal_transfer_parallel_operation_run,
+      operation);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // Memory file IO API
 //===----------------------------------------------------------------------===//
@@ -853,6 +1565,18 @@ static iree_status_t iree_hal_file_validate_access(
 #endif  // IREE_STATUS_MODE
 }
 
+// Returns true if a transfer of |length| bytes should be split across multiple
+// threads. Transfers that fit in a single chunk always run on the loop.
+static bool iree_hal_transfer_should_use_threads(
+    iree_device_size_t length, iree_hal_file_transfer_options_t options) {
+  if (!options.pool || options.pool->thread_count <= 1) return false;
+  iree_device_size_t chunk_size = options.chunk_size;
+  if (chunk_size == IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT) {
+    chunk_size = IREE_HAL_TRANSFER_THREAD_CHUNK_SIZE;
+  }
+  return length > chunk_size;
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_device_queue_read_streaming(
     iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -883,6 +1607,22 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_read_streaming(
         "used with streaming file transfer");
   }
 
+  // Large transfers can be split across multiple threads when requested.
+  // The operation is owned by the loop once launched.
+  if (iree_hal_transfer_should_use_threads(length, options)) {
+    iree_hal_transfer_parallel_operation_t* parallel_operation = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_transfer_parallel_operation_create(
+        device, queue_affinity, signal_semaphore_list,
+        IREE_HAL_TRANSFER_READ_FILE_TO_BUFFER, source_file, source_offset,
+        target_buffer, target_offset, length, options, &parallel_operation));
+    iree_status_t status = iree_hal_transfer_parallel_operation_launch(
+        parallel_operation, wait_semaphore_list, options.loop);
+    if (!iree_status_is_ok(status)) {
+      iree_hal_transfer_parallel_operation_destroy(parallel_operation);
+    }
+    return status;
+  }
+
   // Allocate full transfer operation.
   iree_hal_transfer_operation_t* operation = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_transfer_operation_create(
@@ -933,6 +1673,22 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_write_streaming(
         "used with streaming file transfer");
   }
 
+  // Large transfers can be split across multiple threads when requested.
+  // The operation is owned by the loop once launched.
+  if (iree_hal_transfer_should_use_threads(length, options)) {
+    iree_hal_transfer_parallel_operation_t* parallel_operation = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_transfer_parallel_operation_create(
+        device, queue_affinity, signal_semaphore_list,
+        IREE_HAL_TRANSFER_WRITE_BUFFER_TO_FILE, target_file, target_offset,
+        source_buffer, source_offset, length, options, &parallel_operation));
+    iree_status_t status = iree_hal_transfer_parallel_operation_launch(
+        parallel_operation, wait_semaphore_list, options.loop);
+    if (!iree_status_is_ok(status)) {
+      iree_hal_transfer_parallel_operation_destroy(parallel_operation);
+    }
+    return status;
+  }
+
   // Allocate full transfer operation.
   iree_hal_transfer_operation_t* operation = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_transfer_operation_create(
@@ -21,6 +21,23 @@ extern "C" {
 #define IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT 0
 #define IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT 0
 
+// A set of persistent host threads used to stage large file transfers in
+// parallel. Devices create a pool once and pass it to each transfer with
+// iree_hal_file_transfer_options_t so that threads are not created and joined
+// per transfer. A pool is used by one transfer at a time: transfers that find
+// it busy stage all of their chunks on the thread running the loop callback.
+typedef struct iree_hal_file_transfer_pool_t iree_hal_file_transfer_pool_t;
+
+// Creates a pool that splits transfers across |thread_count| threads in total:
+// the thread running the transfer plus |thread_count| - 1 pool threads.
+IREE_API_EXPORT iree_status_t iree_hal_file_transfer_pool_create(
+    iree_host_size_t thread_count, iree_allocator_t host_allocator,
+    iree_hal_file_transfer_pool_t** out_pool);
+
+// Joins all pool threads and frees |pool|. No transfers may be using the pool.
+IREE_API_EXPORT void iree_hal_file_transfer_pool_free(
+    iree_hal_file_transfer_pool_t* pool);
+
 // Options for file-based transfer operations.
 typedef struct iree_hal_file_transfer_options_t {
   // Loop to use for asynchronous host operations. If inline then the transfer
@@ -38,6 +55,15 @@ typedef struct iree_hal_file_transfer_options_t {
   // IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT can be used to have the
   // implementation select a chunk size based on the size of the transfer.
   iree_device_size_t chunk_size;
+  // Optional pool of host threads used to stage chunks concurrently.
+  // When provided large transfers are split across the pool threads that each
+  // pipeline file I/O into one half of a double-buffered staging reservation
+  // while the device copies out of the other half. |chunk_count| is ignored in
+  // this mode as each thread always reserves two chunks. The |loop| is only
+  // used to wait for the transfer to begin and the loop callback returns once
+  // all threads have finished their chunks.
+  // NULL processes all chunks with coroutines on |loop|.
+  iree_hal_file_transfer_pool_t* pool;
 } iree_hal_file_transfer_options_t;
 
 // EXPERIMENTAL: eventually we'll focus this only on emulating support where
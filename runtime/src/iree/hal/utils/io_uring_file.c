@@ -0,0 +1,892 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Must define _GNU_SOURCE before includes to get O_DIRECT from fcntl.h.
+#define _GNU_SOURCE
+
+#include "iree/hal/utils/io_uring_file.h"
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+
+#if IREE_FILE_IO_ENABLE && defined(IREE_PLATFORM_LINUX)
+#define IREE_HAL_IO_URING_ENABLE 1
+#else
+#define IREE_HAL_IO_URING_ENABLE 0
+#endif  // IREE_FILE_IO_ENABLE && IREE_PLATFORM_LINUX
+
+// Default number of requests kept in flight per operation.
+#define IREE_HAL_IO_URING_FILE_DEFAULT_QUEUE_DEPTH 32
+
+// Default size of each request. Large enough to amortize the per-request
+// overhead and small enough that a full queue keeps the device busy.
+#define IREE_HAL_IO_URING_FILE_DEFAULT_REQUEST_SIZE (1 * 1024 * 1024)
+
+// Maximum number of requests kept in flight per operation.
+#define IREE_HAL_IO_URING_FILE_MAX_QUEUE_DEPTH 4096
+
+IREE_API_EXPORT void iree_hal_io_uring_file_params_initialize(
+    iree_hal_io_uring_file_params_t* out_params) {
+  IREE_ASSERT_ARGUMENT(out_params);
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->flags = IREE_HAL_IO_URING_FILE_FLAG_NONE;
+  out_params->queue_depth = IREE_HAL_IO_URING_FILE_DEFAULT_QUEUE_DEPTH;
+  out_params->request_size = IREE_HAL_IO_URING_FILE_DEFAULT_REQUEST_SIZE;
+}
+
+#if IREE_HAL_IO_URING_ENABLE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Alignment of file offsets, lengths, and memory addresses required for
+// O_DIRECT requests. Most devices only require the logical block size (often
+// 512B) but the page size is always valid.
+#define IREE_HAL_IO_URING_DIRECT_ALIGNMENT 4096
+
+// Maximum number of idle rings retained by a file for reuse.
+#define IREE_HAL_IO_URING_FILE_MAX_IDLE_RINGS 8
+
+// user_data of cancellation requests. Never a valid slot index.
+#define IREE_HAL_IO_URING_CANCEL_USER_DATA UINT64_MAX
+
+//===----------------------------------------------------------------------===//
+// iree_hal_io_uring_t
+//===----------------------------------------------------------------------===//
+
+// A single request in flight. Short transfers are resubmitted from the same
+// slot until the span is exhausted.
+typedef struct iree_hal_io_uring_slot_t {
+  // File descriptor the request is issued against.
+  int fd;
+  // Host memory the remaining span is transferred to/from.
+  uint8_t* ptr;
+  // File offset of the remaining span.
+  uint64_t offset;
+  // Remaining length of the span in bytes.
+  iree_host_size_t length;
+  // Storage for the request vector; must remain valid until completion on
+  // kernels without IORING_FEAT_SUBMIT_STABLE.
+  struct iovec iov;
+  // True while a request for the slot is queued or in flight.
+  bool in_flight;
+} iree_hal_io_uring_slot_t;
+
+// An io_uring instance with its submission and completion rings mapped.
+// Rings are only ever used by one thread at a time.
+typedef struct iree_hal_io_uring_t {
+  int ring_fd;
+
+  void* sq_ring;
+  size_t sq_ring_size;
+  void* cq_ring;
+  size_t cq_ring_size;
+  struct io_uring_sqe* sqes;
+  size_t sqes_size;
+
+  uint32_t* sq_head;
+  uint32_t* sq_tail;
+  uint32_t sq_mask;
+  uint32_t* sq_array;
+  uint32_t* cq_head;
+  uint32_t* cq_tail;
+  uint32_t cq_mask;
+  struct io_uring_cqe* cqes;
+
+  // Number of SQEs queued that have not yet been consumed by the kernel.
+  uint32_t unsubmitted_count;
+
+  // Stack of slot indices not currently in flight.
+  uint32_t slot_count;
+  uint32_t free_slot_count;
+  uint32_t* free_slots;
+  iree_hal_io_uring_slot_t slots[];
+} iree_hal_io_uring_t;
+
+static int iree_hal_io_uring_setup(uint32_t entries,
+                                   struct io_uring_params* params) {
+  return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int iree_hal_io_uring_enter(int ring_fd, uint32_t to_submit,
+                                   uint32_t min_complete, uint32_t flags) {
+  return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                      flags, NULL, 0);
+}
+
+// Returns true if the error code from io_uring_setup indicates that io_uring
+// is not supported or not allowed (vs. a transient resource failure).
+static bool iree_hal_io_uring_is_unsupported_errno(int error) {
+  return error == ENOSYS || error == EPERM || error == EACCES ||
+         error == EINVAL;
+}
+
+IREE_API_EXPORT bool iree_hal_io_uring_is_available(void) {
+  // 0 = unknown, 1 = available, 2 = unavailable.
+  static iree_atomic_int32_t availability = IREE_ATOMIC_VAR_INIT(0);
+  int32_t value = iree_atomic_load(&availability, iree_memory_order_acquire);
+  if (value == 0) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ring_fd = iree_hal_io_uring_setup(1, &params);
+    if (ring_fd >= 0) {
+      close(ring_fd);
+      value = 1;
+    } else if (iree_hal_io_uring_is_unsupported_errno(errno)) {
+      value = 2;
+    } else {
+      // Transient failure (out of memory/descriptors); query again next time.
+      return false;
+    }
+    iree_atomic_store(&availability, value, iree_memory_order_release);
+  }
+  return value == 1;
+}
+
+static void iree_hal_io_uring_destroy(iree_hal_io_uring_t* ring,
+                                      iree_allocator_t host_allocator) {
+  if (!ring) return;
+  if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+  if (ring->cq_ring && ring->cq_ring != ring->sq_ring) {
+    munmap(ring->cq_ring, ring->cq_ring_size);
+  }
+  if (ring->sq_ring) munmap(ring->sq_ring, ring->sq_ring_size);
+  if (ring->ring_fd >= 0) close(ring->ring_fd);
+  iree_allocator_free(host_allocator, ring);
+}
+
+static void* iree_hal_io_uring_mmap(int ring_fd, size_t size, off_t offset) {
+  void* ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+  return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+static iree_status_t iree_hal_io_uring_create(
+    uint32_t queue_depth, iree_allocator_t host_allocator,
+    iree_hal_io_uring_t** out_ring) {
+  *out_ring = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_io_uring_t* ring = NULL;
+  const iree_host_size_t total_size =
+      sizeof(*ring) + queue_depth * sizeof(ring->slots[0]) +
+      queue_depth * sizeof(ring->free_slots[0]);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&ring));
+  ring->ring_fd = -1;
+  ring->slot_count = queue_depth;
+  ring->free_slots = (uint32_t*)&ring->slots[queue_depth];
+  ring->free_slot_count = queue_depth;
+  for (uint32_t i = 0; i < queue_depth; ++i) {
+    ring->free_slots[i] = queue_depth - i - 1;
+  }
+
+  // The completion ring defaults to twice the submission ring and since we
+  // never have more than |queue_depth| requests in flight it cannot overflow.
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring->ring_fd = iree_hal_io_uring_setup(queue_depth, &params);
+  if (ring->ring_fd < 0) {
+    const int error = errno;
+    iree_hal_io_uring_destroy(ring, host_allocator);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_hal_io_uring_is_unsupported_errno(error)
+                                ? IREE_STATUS_UNAVAILABLE
+                                : iree_status_code_from_errno(error),
+                            "io_uring_setup failed (%d)", error);
+  }
+
+  ring->sq_ring_size =
+      params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  ring->cq_ring_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    ring->sq_ring_size = iree_max(ring->sq_ring_size, ring->cq_ring_size);
+    ring->cq_ring_size = ring->sq_ring_size;
+  }
+  ring->sq_ring = iree_hal_io_uring_mmap(ring->ring_fd, ring->sq_ring_size,
+                                         IORING_OFF_SQ_RING);
+  if (ring->sq_ring) {
+    ring->cq_ring = (params.features & IORING_FEAT_SINGLE_MMAP)
+                        ? ring->sq_ring
+                        : iree_hal_io_uring_mmap(ring->ring_fd,
+                                                 ring->cq_ring_size,
+                                                 IORING_OFF_CQ_RING);
+  }
+  ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  if (ring->cq_ring) {
+    ring->sqes = (struct io_uring_sqe*)iree_hal_io_uring_mmap(
+        ring->ring_fd, ring->sqes_size, IORING_OFF_SQES);
+  }
+  if (!ring->sqes) {
+    const int error = errno;
+    iree_hal_io_uring_destroy(ring, host_allocator);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(error),
+                            "failed to map io_uring rings");
+  }
+
+  uint8_t* sq_ring = (uint8_t*)ring->sq_ring;
+  ring->sq_head = (uint32_t*)(sq_ring + params.sq_off.head);
+  ring->sq_tail = (uint32_t*)(sq_ring + params.sq_off.tail);
+  ring->sq_mask = *(uint32_t*)(sq_ring + params.sq_off.ring_mask);
+  ring->sq_array = (uint32_t*)(sq_ring + params.sq_off.array);
+  uint8_t* cq_ring = (uint8_t*)ring->cq_ring;
+  ring->cq_head = (uint32_t*)(cq_ring + params.cq_off.head);
+  ring->cq_tail = (uint32_t*)(cq_ring + params.cq_off.tail);
+  ring->cq_mask = *(uint32_t*)(cq_ring + params.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe*)(cq_ring + params.cq_off.cqes);
+
+  *out_ring = ring;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Queues a request for the remaining span of |slot_index|. The request is not
+// visible to the kernel until the next iree_hal_io_uring_submit_and_wait.
+static void iree_hal_io_uring_queue(iree_hal_io_uring_t* ring, uint8_t opcode,
+                                    uint32_t slot_index) {
+  iree_hal_io_uring_slot_t* slot = &ring->slots[slot_index];
+  slot->iov.iov_base = slot->ptr;
+  slot->iov.iov_len = slot->length;
+
+  // We are the only producer so the tail can be read without synchronization.
+  const uint32_t tail = *ring->sq_tail;
+  const uint32_t index = tail & ring->sq_mask;
+  struct io_uring_sqe* sqe = &ring->sqes[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = slot->fd;
+  sqe->off = slot->offset;
+  sqe->addr = (uint64_t)(uintptr_t)&slot->iov;
+  sqe->len = 1;
+  sqe->user_data = slot_index;
+  ring->sq_array[index] = index;
+  iree_atomic_store((iree_atomic_uint32_t*)ring->sq_tail, tail + 1,
+                    iree_memory_order_release);
+  ++ring->unsubmitted_count;
+  slot->in_flight = true;
+}
+
+// Queues a request cancelling the request in flight for |slot_index|.
+// Completes with -ENOENT if the request has already completed.
+static void iree_hal_io_uring_queue_cancel(iree_hal_io_uring_t* ring,
+                                           uint32_t slot_index) {
+  const uint32_t tail = *ring->sq_tail;
+  const uint32_t index = tail & ring->sq_mask;
+  struct io_uring_sqe* sqe = &ring->sqes[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = slot_index;
+  sqe->user_data = IREE_HAL_IO_URING_CANCEL_USER_DATA;
+  ring->sq_array[index] = index;
+  iree_atomic_store((iree_atomic_uint32_t*)ring->sq_tail, tail + 1,
+                    iree_memory_order_release);
+  ++ring->unsubmitted_count;
+}
+
+// Removes all queued requests the kernel has not consumed. Their slots are
+// returned to the free list as the kernel never saw them.
+static void iree_hal_io_uring_discard_unsubmitted(iree_hal_io_uring_t* ring) {
+  const uint32_t head = iree_atomic_load(
+      (iree_atomic_uint32_t*)ring->sq_head, iree_memory_order_acquire);
+  uint32_t tail = *ring->sq_tail;
+  for (; tail != head; --tail) {
+    const uint64_t user_data =
+        ring->sqes[(tail - 1) & ring->sq_mask].user_data;
+    if (user_data == IREE_HAL_IO_URING_CANCEL_USER_DATA) continue;
+    ring->slots[user_data].in_flight = false;
+    ring->free_slots[ring->free_slot_count++] = (uint32_t)user_data;
+  }
+  iree_atomic_store((iree_atomic_uint32_t*)ring->sq_tail, tail,
+                    iree_memory_order_release);
+  ring->unsubmitted_count = 0;
+}
+
+// Submits all queued requests and waits for at least one completion.
+static iree_status_t iree_hal_io_uring_submit_and_wait(
+    iree_hal_io_uring_t* ring) {
+  for (;;) {
+    int result = iree_hal_io_uring_enter(ring->ring_fd,
+                                         ring->unsubmitted_count, /*min=*/1,
+                                         IORING_ENTER_GETEVENTS);
+    if (result >= 0) {
+      ring->unsubmitted_count -= (uint32_t)result;
+      return iree_ok_status();
+    }
+    const int error = errno;
+    if (error == EINTR || error == EAGAIN || error == EBUSY) continue;
+    return iree_make_status(iree_status_code_from_errno(error),
+                            "io_uring_enter failed");
+  }
+}
+
+// Cancels all requests in flight on |ring| and waits until the kernel has
+// completed each of them so that the memory they reference is no longer in
+// use. Closing the ring does not cancel requests so this must be done before
+// returning from a failed operation. Completions are discarded.
+static iree_status_t iree_hal_io_uring_cancel_and_drain(
+    iree_hal_io_uring_t* ring) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Requests the kernel never consumed do not need to be cancelled.
+  iree_hal_io_uring_discard_unsubmitted(ring);
+
+  // Cancellation is best-effort: if the cancellations cannot be submitted we
+  // still wait for the requests to complete on their own.
+  uint32_t pending_count = ring->slot_count - ring->free_slot_count;
+  for (uint32_t i = 0; i < ring->slot_count; ++i) {
+    if (ring->slots[i].in_flight) iree_hal_io_uring_queue_cancel(ring, i);
+  }
+  int result = 0;
+  if (ring->unsubmitted_count > 0) {
+    do {
+      result = iree_hal_io_uring_enter(ring->ring_fd, ring->unsubmitted_count,
+                                       /*min_complete=*/0, /*flags=*/0);
+    } while (result < 0 &&
+             (errno == EINTR || errno == EAGAIN || errno == EBUSY));
+    if (result > 0) pending_count += (uint32_t)result;
+    iree_hal_io_uring_discard_unsubmitted(ring);
+  }
+
+  // Reap until both the requests and the submitted cancellations complete so
+  // that no stale completions are left in the ring for its next use.
+  iree_status_t status = iree_ok_status();
+  while (pending_count > 0) {
+    result = iree_hal_io_uring_enter(ring->ring_fd, /*to_submit=*/0,
+                                     /*min_complete=*/1,
+                                     IORING_ENTER_GETEVENTS);
+    if (result < 0) {
+      const int error = errno;
+      if (error == EINTR || error == EAGAIN || error == EBUSY) continue;
+      // Only possible if the ring itself is invalid. The remaining slots stay
+      // marked in flight so the ring is never reused.
+      status = iree_make_status(iree_status_code_from_errno(error),
+                                "io_uring_enter failed draining %u requests",
+                                pending_count);
+      break;
+    }
+    uint32_t head = *ring->cq_head;
+    const uint32_t tail = iree_atomic_load(
+        (iree_atomic_uint32_t*)ring->cq_tail, iree_memory_order_acquire);
+    for (; head != tail; ++head) {
+      const struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+      if (cqe->user_data != IREE_HAL_IO_URING_CANCEL_USER_DATA) {
+        const uint32_t slot_index = (uint32_t)cqe->user_data;
+        ring->slots[slot_index].in_flight = false;
+        ring->free_slots[ring->free_slot_count++] = slot_index;
+      }
+      --pending_count;
+    }
+    iree_atomic_store((iree_atomic_uint32_t*)ring->cq_head, head,
+                      iree_memory_order_release);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_io_uring_operation_t
+//===----------------------------------------------------------------------===//
+
+// A contiguous range of a transfer issued against a single file descriptor.
+typedef struct iree_hal_io_uring_span_t {
+  int fd;
+  uint8_t* ptr;
+  uint64_t offset;
+  iree_host_size_t length;
+} iree_hal_io_uring_span_t;
+
+// A read or write of one host memory range split into up to three spans: an
+// unaligned head and tail through the page cache and an O_DIRECT body.
+typedef struct iree_hal_io_uring_operation_t {
+  uint8_t opcode;
+  iree_host_size_t request_size;
+  iree_host_size_t span_count;
+  iree_host_size_t span_index;
+  iree_hal_io_uring_span_t spans[3];
+} iree_hal_io_uring_operation_t;
+
+static void iree_hal_io_uring_operation_append_span(
+    iree_hal_io_uring_operation_t* operation, int fd, uint8_t* ptr,
+    uint64_t offset, iree_host_size_t length) {
+  if (length == 0) return;
+  iree_hal_io_uring_span_t* span = &operation->spans[operation->span_count++];
+  span->fd = fd;
+  span->ptr = ptr;
+  span->offset = offset;
+  span->length = length;
+}
+
+// Pops the next request from the operation into |slot|.
+// Returns false if all requests have been issued.
+static bool iree_hal_io_uring_operation_next(
+    iree_hal_io_uring_operation_t* operation, iree_hal_io_uring_slot_t* slot) {
+  while (operation->span_index < operation->span_count) {
+    iree_hal_io_uring_span_t* span = &operation->spans[operation->span_index];
+    if (span->length == 0) {
+      ++operation->span_index;
+      continue;
+    }
+    const iree_host_size_t length =
+        iree_min(span->length, operation->request_size);
+    slot->fd = span->fd;
+    slot->ptr = span->ptr;
+    slot->offset = span->offset;
+    slot->length = length;
+    span->ptr += length;
+    span->offset += length;
+    span->length -= length;
+    return true;
+  }
+  return false;
+}
+
+// Executes all requests of |operation| on |ring| keeping as many in flight as
+// the ring has slots. If a request fails no new requests are issued and those
+// in flight are allowed to complete. If the ring itself fails the requests in
+// flight are cancelled and waited on. Either way the kernel has finished with
+// the memory when this returns unless draining the ring also failed, in which
+// case the ring is left with slots in flight and must not be reused.
+static iree_status_t iree_hal_io_uring_operation_execute(
+    iree_hal_io_uring_operation_t* operation, iree_hal_io_uring_t* ring) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_ok_status();
+  uint32_t in_flight_count = 0;
+  for (;;) {
+    // Fill all free slots with new requests.
+    while (iree_status_is_ok(status) && ring->free_slot_count > 0) {
+      const uint32_t slot_index = ring->free_slots[ring->free_slot_count - 1];
+      if (!iree_hal_io_uring_operation_next(operation,
+                                            &ring->slots[slot_index])) {
+        break;
+      }
+      --ring->free_slot_count;
+      ++in_flight_count;
+      iree_hal_io_uring_queue(ring, operation->opcode, slot_index);
+    }
+    if (in_flight_count == 0) break;
+
+    iree_status_t enter_status = iree_hal_io_uring_submit_and_wait(ring);
+    if (!iree_status_is_ok(enter_status)) {
+      status = iree_status_join(status, enter_status);
+      status =
+          iree_status_join(status, iree_hal_io_uring_cancel_and_drain(ring));
+      break;
+    }
+
+    // Reap all available completions. Short transfers are requeued from the
+    // same slot.
+    uint32_t head = *ring->cq_head;
+    const uint32_t tail = iree_atomic_load(
+        (iree_atomic_uint32_t*)ring->cq_tail, iree_memory_order_acquire);
+    for (; head != tail; ++head) {
+      const struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+      const uint32_t slot_index = (uint32_t)cqe->user_data;
+      iree_hal_io_uring_slot_t* slot = &ring->slots[slot_index];
+      if (cqe->res > 0 && iree_status_is_ok(status)) {
+        slot->ptr += cqe->res;
+        slot->offset += cqe->res;
+        slot->length -= (iree_host_size_t)cqe->res;
+        if (slot->length > 0) {
+          iree_hal_io_uring_queue(ring, operation->opcode, slot_index);
+          continue;
+        }
+      } else if (cqe->res == 0 && iree_status_is_ok(status)) {
+        status = iree_make_status(
+            IREE_STATUS_OUT_OF_RANGE,
+            "end of file hit during %s at offset %" PRIu64,
+            operation->opcode == IORING_OP_READV ? "read" : "write",
+            slot->offset);
+      } else if (cqe->res < 0 && iree_status_is_ok(status)) {
+        status = iree_make_status(
+            iree_status_code_from_errno(-cqe->res),
+            "failed to %s %" PRIhsz " bytes at offset %" PRIu64,
+            operation->opcode == IORING_OP_READV ? "read" : "write",
+            slot->length, slot->offset);
+      }
+      slot->in_flight = false;
+      ring->free_slots[ring->free_slot_count++] = slot_index;
+      --in_flight_count;
+    }
+    iree_atomic_store((iree_atomic_uint32_t*)ring->cq_head, head,
+                      iree_memory_order_release);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_io_uring_file_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_io_uring_file_t {
+  iree_hal_resource_t resource;
+  // Used to allocate this structure.
+  iree_allocator_t host_allocator;
+  // Allowed access bits.
+  iree_hal_memory_access_t access;
+  // Base file handle, retained.
+  iree_io_file_handle_t* handle;
+  // File descriptor used for requests through the page cache. May be owned by
+  // the handle or |owned_fd|.
+  int buffered_fd;
+  // File descriptor opened with O_DIRECT or -1 if direct IO is not used.
+  int direct_fd;
+  // File descriptor opened by the file and closed when it is destroyed or -1.
+  int owned_fd;
+  // Total file (stream) length in bytes as queried on creation.
+  uint64_t length;
+  // Maximum number of requests in flight per operation.
+  uint32_t queue_depth;
+  // Maximum size of each request in bytes.
+  iree_host_size_t request_size;
+  // Guards |idle_rings|.
+  iree_slim_mutex_t mutex;
+  // Rings not currently in use by any operation. Operations on multiple
+  // threads each acquire their own ring.
+  iree_host_size_t idle_ring_count;
+  iree_hal_io_uring_t* idle_rings[IREE_HAL_IO_URING_FILE_MAX_IDLE_RINGS];
+} iree_hal_io_uring_file_t;
+
+static const iree_hal_file_vtable_t iree_hal_io_uring_file_vtable;
+
+static iree_hal_io_uring_file_t* iree_hal_io_uring_file_cast(
+    iree_hal_file_t* IREE_RESTRICT base_value) {
+  return (iree_hal_io_uring_file_t*)base_value;
+}
+
+// Returns the allowed access and length in bytes of the file descriptor.
+static iree_status_t iree_hal_io_uring_fd_stat(
+    int fd, iree_hal_memory_access_t* out_allowed_access,
+    uint64_t* out_length) {
+  *out_allowed_access = IREE_HAL_MEMORY_ACCESS_NONE;
+  *out_length = 0;
+  struct stat buffer = {0};
+  if (fstat(fd, &buffer) == -1) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "unable to stat file descriptor length");
+  }
+  *out_allowed_access =
+      ((buffer.st_mode & S_IRUSR) ? IREE_HAL_MEMORY_ACCESS_READ : 0) |
+      ((buffer.st_mode & S_IWUSR) ? IREE_HAL_MEMORY_ACCESS_WRITE : 0);
+  *out_length = (uint64_t)buffer.st_size;
+  return iree_ok_status();
+}
+
+// Opens a new file descriptor for the same file as |fd| with |fd_flags|.
+// Returns -1 if the file could not be reopened.
+static int iree_hal_io_uring_fd_reopen(int fd, int fd_flags) {
+  char path[64];
+  snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+  return open(path, fd_flags | O_CLOEXEC);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_io_uring_file_from_handle(
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    const iree_hal_io_uring_file_params_t* params,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(out_file);
+  *out_file = NULL;
+
+  iree_io_file_handle_primitive_t primitive =
+      iree_io_file_handle_primitive(handle);
+  if (primitive.type != IREE_IO_FILE_HANDLE_TYPE_FD) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "support for creating non-fd files not supported");
+  }
+  const int fd = primitive.value.fd;
+  if (!iree_hal_io_uring_is_available()) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "io_uring is not available in this process");
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Query the file length. This also acts as a quick check that the file
+  // descriptor is accessible.
+  iree_hal_memory_access_t allowed_access = IREE_HAL_MEMORY_ACCESS_NONE;
+  uint64_t length = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_io_uring_fd_stat(fd, &allowed_access, &length));
+
+  // Verify that the requested access can be satisfied.
+  if (iree_all_bits_set(access, IREE_HAL_MEMORY_ACCESS_READ) &&
+      !iree_all_bits_set(allowed_access, IREE_HAL_MEMORY_ACCESS_READ)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_PERMISSION_DENIED,
+        "read access requested on a file descriptor that is not readable");
+  } else if (iree_all_bits_set(access, IREE_HAL_MEMORY_ACCESS_WRITE) &&
+             !iree_all_bits_set(allowed_access, IREE_HAL_MEMORY_ACCESS_WRITE)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                            "write access requested on a file descriptor that "
+                            "is not writable");
+  }
+
+  iree_hal_io_uring_file_t* file = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*file), (void**)&file));
+  iree_hal_resource_initialize(&iree_hal_io_uring_file_vtable,
+                               &file->resource);
+  file->host_allocator = host_allocator;
+  file->access = access;
+  file->handle = handle;
+  iree_io_file_handle_retain(file->handle);
+  file->buffered_fd = fd;
+  file->direct_fd = -1;
+  file->owned_fd = -1;
+  file->length = length;
+  file->queue_depth =
+      iree_max(1u, iree_min(params->queue_depth,
+                            IREE_HAL_IO_URING_FILE_MAX_QUEUE_DEPTH));
+  file->request_size = params->request_size
+                           ? params->request_size
+                           : IREE_HAL_IO_URING_FILE_DEFAULT_REQUEST_SIZE;
+  iree_slim_mutex_initialize(&file->mutex);
+
+  // Direct IO requires a second descriptor as O_DIRECT applies to the open
+  // file description. If the handle was opened with O_DIRECT we instead reopen
+  // it without so that unaligned requests can go through the page cache.
+  // Failing to reopen is not fatal: we behave as iree_hal_fd_file_t would.
+  const int fd_flags = fcntl(fd, F_GETFL);
+  if (fd_flags != -1 && (fd_flags & O_DIRECT)) {
+    file->owned_fd =
+        iree_hal_io_uring_fd_reopen(fd, fd_flags & O_ACCMODE);
+    if (file->owned_fd != -1) {
+      file->buffered_fd = file->owned_fd;
+      file->direct_fd = fd;
+    }
+  } else if (fd_flags != -1 &&
+             iree_all_bits_set(params->flags,
+                               IREE_HAL_IO_URING_FILE_FLAG_DIRECT)) {
+    file->owned_fd =
+        iree_hal_io_uring_fd_reopen(fd, (fd_flags & O_ACCMODE) | O_DIRECT);
+    file->direct_fd = file->owned_fd;
+  }
+  if (file->direct_fd != -1) {
+    file->request_size = iree_host_align(file->request_size,
+                                         IREE_HAL_IO_URING_DIRECT_ALIGNMENT);
+  }
+
+  *out_file = (iree_hal_file_t*)file;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_io_uring_file_destroy(
+    iree_hal_file_t* IREE_RESTRICT base_file) {
+  iree_hal_io_uring_file_t* file = iree_hal_io_uring_file_cast(base_file);
+  iree_allocator_t host_allocator = file->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  for (iree_host_size_t i = 0; i < file->idle_ring_count; ++i) {
+    iree_hal_io_uring_destroy(file->idle_rings[i], host_allocator);
+  }
+  iree_slim_mutex_deinitialize(&file->mutex);
+  if (file->owned_fd != -1) close(file->owned_fd);
+  iree_io_file_handle_release(file->handle);
+
+  iree_allocator_free(host_allocator, file);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_hal_memory_access_t iree_hal_io_uring_file_allowed_access(
+    iree_hal_file_t* base_file) {
+  iree_hal_io_uring_file_t* file = iree_hal_io_uring_file_cast(base_file);
+  return file->access;
+}
+
+static uint64_t iree_hal_io_uring_file_length(iree_hal_file_t* base_file) {
+  iree_hal_io_uring_file_t* file = iree_hal_io_uring_file_cast(base_file);
+  return file->length;
+}
+
+static iree_hal_buffer_t* iree_hal_io_uring_file_storage_buffer(
+    iree_hal_file_t* base_file) {
+  return NULL;
+}
+
+static bool iree_hal_io_uring_file_supports_synchronous_io(
+    iree_hal_file_t* base_file) {
+  // Operations are issued asynchronously to the kernel but each read/write
+  // call blocks until all of its requests have completed.
+  return true;
+}
+
+// Acquires an idle ring from the file or creates a new one.
+static iree_status_t iree_hal_io_uring_file_acquire_ring(
+    iree_hal_io_uring_file_t* file, iree_hal_io_uring_t** out_ring) {
+  *out_ring = NULL;
+  iree_slim_mutex_lock(&file->mutex);
+  if (file->idle_ring_count > 0) {
+    *out_ring = file->idle_rings[--file->idle_ring_count];
+  }
+  iree_slim_mutex_unlock(&file->mutex);
+  if (*out_ring) return iree_ok_status();
+  return iree_hal_io_uring_create(file->queue_depth, file->host_allocator,
+                                  out_ring);
+}
+
+// Returns |ring| to the file for reuse. Rings that failed are destroyed as
+// they may still have requests in flight; closing the ring cancels them.
+static void iree_hal_io_uring_file_release_ring(iree_hal_io_uring_file_t* file,
+                                                iree_hal_io_uring_t* ring,
+                                                bool reusable) {
+  if (reusable) {
+    iree_slim_mutex_lock(&file->mutex);
+    if (file->idle_ring_count < IREE_ARRAYSIZE(file->idle_rings)) {
+      file->idle_rings[file->idle_ring_count++] = ring;
+      ring = NULL;
+    }
+    iree_slim_mutex_unlock(&file->mutex);
+  }
+  iree_hal_io_uring_destroy(ring, file->host_allocator);
+}
+
+static iree_status_t iree_hal_io_uring_file_execute(
+    iree_hal_io_uring_file_t* file, iree_hal_io_uring_operation_t* operation) {
+  iree_hal_io_uring_t* ring = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_io_uring_file_acquire_ring(file, &ring));
+  iree_status_t status = iree_hal_io_uring_operation_execute(operation, ring);
+  iree_hal_io_uring_file_release_ring(
+      file, ring, /*reusable=*/ring->free_slot_count == ring->slot_count);
+  return status;
+}
+
+static iree_status_t iree_hal_io_uring_file_read(
+    iree_hal_file_t* base_file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  if (length == 0) return iree_ok_status();
+  iree_hal_io_uring_file_t* file = iree_hal_io_uring_file_cast(base_file);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+
+  iree_hal_buffer_mapping_t mapping = {{0}};
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_buffer_map_range(buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+                                    IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE,
+                                    buffer_offset, length, &mapping));
+
+  // Reads whose destination is aligned congruently with the file offset can
+  // bypass the page cache for all whole blocks. Everything else is read
+  // through the page cache.
+  iree_hal_io_uring_operation_t operation = {
+      .opcode = IORING_OP_READV,
+      .request_size = file->request_size,
+  };
+  uint8_t* ptr = mapping.contents.data;
+  const iree_host_size_t ptr_length = mapping.contents.data_length;
+  const uint64_t alignment = IREE_HAL_IO_URING_DIRECT_ALIGNMENT;
+  const uint64_t body_begin = (file_offset + alignment - 1) & ~(alignment - 1);
+  const uint64_t body_end = (file_offset + ptr_length) & ~(alignment - 1);
+  if (file->direct_fd != -1 &&
+      (((uintptr_t)ptr - file_offset) & (alignment - 1)) == 0 &&
+      body_begin < body_end) {
+    const iree_host_size_t head_length =
+        (iree_host_size_t)(body_begin - file_offset);
+    const iree_host_size_t body_length =
+        (iree_host_size_t)(body_end - body_begin);
+    iree_hal_io_uring_operation_append_span(&operation, file->buffered_fd, ptr,
+                                            file_offset, head_length);
+    iree_hal_io_uring_operation_append_span(&operation, file->direct_fd,
+                                            ptr + head_length, body_begin,
+                                            body_length);
+    iree_hal_io_uring_operation_append_span(
+        &operation, file->buffered_fd, ptr + head_length + body_length,
+        body_end, ptr_length - head_length - body_length);
+  } else {
+    iree_hal_io_uring_operation_append_span(&operation, file->buffered_fd, ptr,
+                                            file_offset, ptr_length);
+  }
+  iree_status_t status = iree_hal_io_uring_file_execute(file, &operation);
+
+  if (iree_status_is_ok(status) &&
+      !iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                         IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+    status = iree_hal_buffer_mapping_flush_range(&mapping, 0, length);
+  }
+
+  status = iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_io_uring_file_write(
+    iree_hal_file_t* base_file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  if (length == 0) return iree_ok_status();
+  iree_hal_io_uring_file_t* file = iree_hal_io_uring_file_cast(base_file);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+
+  iree_hal_buffer_mapping_t mapping = {{0}};
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_buffer_map_range(buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+                                    IREE_HAL_MEMORY_ACCESS_READ, buffer_offset,
+                                    length, &mapping));
+
+  iree_status_t status = iree_ok_status();
+  if (!iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                         IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+    status = iree_hal_buffer_mapping_invalidate_range(&mapping, 0, length);
+  }
+
+  // Writes always go through the page cache so that they are coherent with
+  // any buffered reads of partial blocks.
+  if (iree_status_is_ok(status)) {
+    iree_hal_io_uring_operation_t operation = {
+        .opcode = IORING_OP_WRITEV,
+        .request_size = file->request_size,
+    };
+    iree_hal_io_uring_operation_append_span(
+        &operation, file->buffered_fd, mapping.contents.data, file_offset,
+        mapping.contents.data_length);
+    status = iree_hal_io_uring_file_execute(file, &operation);
+  }
+
+  status = iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static const iree_hal_file_vtable_t iree_hal_io_uring_file_vtable = {
+    .destroy = iree_hal_io_uring_file_destroy,
+    .allowed_access = iree_hal_io_uring_file_allowed_access,
+    .length = iree_hal_io_uring_file_length,
+    .storage_buffer = iree_hal_io_uring_file_storage_buffer,
+    .supports_synchronous_io = iree_hal_io_uring_file_supports_synchronous_io,
+    .read = iree_hal_io_uring_file_read,
+    .write = iree_hal_io_uring_file_write,
+};
+
+#else
+
+IREE_API_EXPORT bool iree_hal_io_uring_is_available(void) { return false; }
+
+IREE_API_EXPORT iree_status_t iree_hal_io_uring_file_from_handle(
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    const iree_hal_io_uring_file_params_t* params,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "io_uring support is only available on Linux with "
+                          "IREE_FILE_IO_ENABLE=1");
+}
+
+#endif  // IREE_HAL_IO_URING_ENABLE
@@ -0,0 +1,70 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_IO_URING_FILE_H_
+#define IREE_HAL_UTILS_IO_URING_FILE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/io/file_handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_io_uring_file_t
+//===----------------------------------------------------------------------===//
+
+// Bitfield specifying io_uring file behavior.
+typedef uint32_t iree_hal_io_uring_file_flags_t;
+enum iree_hal_io_uring_file_flag_bits_t {
+  IREE_HAL_IO_URING_FILE_FLAG_NONE = 0u,
+  // Reads bypass the page cache (O_DIRECT) when the destination memory is
+  // aligned congruently with the file offset. The unaligned head and tail of
+  // each read and all writes still go through the page cache. Use when
+  // streaming large files exactly once (such as parameters at model load) to
+  // avoid the copy through and pollution of the page cache.
+  IREE_HAL_IO_URING_FILE_FLAG_DIRECT = 1u << 0,
+};
+
+// Parameters controlling an io_uring file.
+typedef struct iree_hal_io_uring_file_params_t {
+  // Flags controlling file behavior.
+  iree_hal_io_uring_file_flags_t flags;
+  // Maximum number of requests kept in flight by a single read or write.
+  // Deeper queues are required to saturate NVMe devices.
+  uint32_t queue_depth;
+  // Maximum size in bytes of each request. Reads and writes are split into
+  // requests of this size that are serviced concurrently.
+  iree_host_size_t request_size;
+} iree_hal_io_uring_file_params_t;
+
+// Initializes |out_params| to their default values.
+IREE_API_EXPORT void iree_hal_io_uring_file_params_initialize(
+    iree_hal_io_uring_file_params_t* out_params);
+
+// Returns true if io_uring is supported by the kernel and allowed for the
+// process. The result is cached after the first query.
+IREE_API_EXPORT bool iree_hal_io_uring_is_available(void);
+
+// Creates a file backed by |handle| on disk that services reads and writes
+// with io_uring, keeping up to |params.queue_depth| requests in flight per
+// operation. Only supports file handles of IREE_IO_FILE_HANDLE_TYPE_FD.
+//
+// Returns IREE_STATUS_UNAVAILABLE if io_uring is not supported on the platform
+// or has been disabled for the process; callers should fall back to
+// iree_hal_fd_file_from_handle.
+IREE_API_EXPORT iree_status_t iree_hal_io_uring_file_from_handle(
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    const iree_hal_io_uring_file_params_t* params,
+    iree_allocator_t host_allocator, iree_hal_file_t** out_file);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_IO_URING_FILE_H_
@@ -0,0 +1,249 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/io_uring_file.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/file_registry.h"
+#include "iree/io/file_handle.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+// Size of the test file. Not a multiple of the direct IO alignment so that the
+// tail of full-file reads must go through the page cache.
+static constexpr iree_host_size_t kFileLength = 3 * 1024 * 1024 + 123;
+
+// Creates a temporary file with known contents wrapped in an fd handle.
+class FdFileTestBase : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Fill the file with a pattern where each byte depends on its offset.
+    const char* tmpdir = getenv("TEST_TMPDIR");
+    if (!tmpdir) tmpdir = getenv("TMPDIR");
+    if (!tmpdir) tmpdir = "/tmp";
+    path_ = std::string(tmpdir) + "/io_uring_file_test_XXXXXX";
+    fd_ = mkstemp(&path_[0]);
+    ASSERT_NE(fd_, -1);
+    contents_.resize(kFileLength);
+    for (iree_host_size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = (uint8_t)((i * 31) ^ (i >> 12));
+    }
+    ASSERT_EQ(pwrite(fd_, contents_.data(), contents_.size(), 0),
+              (ssize_t)contents_.size());
+
+    iree_io_file_handle_primitive_t primitive;
+    primitive.type = IREE_IO_FILE_HANDLE_TYPE_FD;
+    primitive.value.fd = fd_;
+    IREE_ASSERT_OK(iree_io_file_handle_wrap(
+        IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE, primitive,
+        iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+        &handle_));
+
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+  }
+
+  void TearDown() override {
+    iree_hal_allocator_release(device_allocator_);
+    iree_io_file_handle_release(handle_);
+    if (fd_ != -1) {
+      close(fd_);
+      unlink(path_.c_str());
+    }
+  }
+
+  // Allocates a host-mappable buffer of |allocation_size|.
+  iree_hal_buffer_t* Allocate(iree_device_size_t allocation_size) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+    params.usage =
+        IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_, params, allocation_size, &buffer));
+    return buffer;
+  }
+
+  // Reads |length| bytes of |buffer| at |buffer_offset| into a vector.
+  static std::vector<uint8_t> ReadBack(iree_hal_buffer_t* buffer,
+                                       iree_device_size_t buffer_offset,
+                                       iree_host_size_t length) {
+    std::vector<uint8_t> data(length);
+    IREE_CHECK_OK(
+        iree_hal_buffer_map_read(buffer, buffer_offset, data.data(), length));
+    return data;
+  }
+
+  // Returns the expected file contents in the given range.
+  std::vector<uint8_t> Expected(uint64_t offset, iree_host_size_t length) {
+    return std::vector<uint8_t>(contents_.begin() + offset,
+                                contents_.begin() + offset + length);
+  }
+
+  std::string path_;
+  int fd_ = -1;
+  std::vector<uint8_t> contents_;
+  iree_io_file_handle_t* handle_ = NULL;
+  iree_hal_allocator_t* device_allocator_ = NULL;
+};
+
+class IoUringFileTest : public FdFileTestBase {
+ protected:
+  void SetUp() override {
+    if (!iree_hal_io_uring_is_available()) {
+      GTEST_SKIP() << "io_uring not available";
+    }
+    FdFileTestBase::SetUp();
+  }
+
+  // Creates an io_uring file with small requests so that even modest reads
+  // are split into many requests in flight.
+  iree_hal_file_t* CreateFile(iree_hal_io_uring_file_flags_t flags) {
+    iree_hal_io_uring_file_params_t params;
+    iree_hal_io_uring_file_params_initialize(&params);
+    params.flags = flags;
+    params.queue_depth = 8;
+    params.request_size = 64 * 1024;
+    iree_hal_file_t* file = NULL;
+    IREE_CHECK_OK(iree_hal_io_uring_file_from_handle(
+        IREE_HAL_MEMORY_ACCESS_READ | IREE_HAL_MEMORY_ACCESS_WRITE, handle_,
+        &params, iree_allocator_system(), &file));
+    return file;
+  }
+};
+
+// Tests reading the entire file with many requests in flight.
+TEST_F(IoUringFileTest, ReadFull) {
+  iree_hal_file_t* file = CreateFile(IREE_HAL_IO_URING_FILE_FLAG_NONE);
+  EXPECT_EQ(iree_hal_file_length(file), kFileLength);
+  iree_hal_buffer_t* buffer = Allocate(kFileLength);
+  IREE_ASSERT_OK(iree_hal_file_read(file, 0, buffer, 0, kFileLength));
+  EXPECT_EQ(ReadBack(buffer, 0, kFileLength), Expected(0, kFileLength));
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+// Tests that reads of unaligned ranges with direct IO requested produce the
+// same results as buffered reads.
+TEST_F(IoUringFileTest, ReadUnalignedDirect) {
+  iree_hal_file_t* file = CreateFile(IREE_HAL_IO_URING_FILE_FLAG_DIRECT);
+  const uint64_t file_offset = 4095;
+  const iree_host_size_t length = 1024 * 1024 + 7;
+  iree_hal_buffer_t* buffer = Allocate(length + 17);
+  IREE_ASSERT_OK(iree_hal_file_read(file, file_offset, buffer, 17, length));
+  EXPECT_EQ(ReadBack(buffer, 17, length), Expected(file_offset, length));
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+// Tests that reads with the destination aligned congruently with the file
+// offset (eligible for direct IO) produce the correct results including the
+// unaligned head and tail.
+TEST_F(IoUringFileTest, ReadCongruentDirect) {
+  iree_hal_file_t* file = CreateFile(IREE_HAL_IO_URING_FILE_FLAG_DIRECT);
+  const uint64_t file_offset = 4096 + 100;
+  const iree_host_size_t length = kFileLength - file_offset;
+  iree_hal_buffer_t* buffer = Allocate(length + 4096);
+
+  // Pick the buffer offset such that the host pointer has the same alignment
+  // as the file offset.
+  iree_hal_buffer_mapping_t mapping;
+  IREE_ASSERT_OK(iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+      IREE_HAL_WHOLE_BUFFER, &mapping));
+  const uintptr_t base = (uintptr_t)mapping.contents.data;
+  IREE_ASSERT_OK(iree_hal_buffer_unmap_range(&mapping));
+  const iree_device_size_t buffer_offset =
+      (iree_device_size_t)((file_offset - base) & 4095);
+
+  IREE_ASSERT_OK(
+      iree_hal_file_read(file, file_offset, buffer, buffer_offset, length));
+  EXPECT_EQ(ReadBack(buffer, buffer_offset, length),
+            Expected(file_offset, length));
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+// Tests that writes land in the file and can be read back.
+TEST_F(IoUringFileTest, WriteReadback) {
+  iree_hal_file_t* file = CreateFile(IREE_HAL_IO_URING_FILE_FLAG_NONE);
+  const uint64_t file_offset = 12345;
+  const iree_host_size_t length = 512 * 1024 + 3;
+  std::vector<uint8_t> data(length);
+  for (iree_host_size_t i = 0; i < length; ++i) data[i] = (uint8_t)(i * 7);
+  iree_hal_buffer_t* buffer = Allocate(length);
+  IREE_ASSERT_OK(iree_hal_buffer_map_write(buffer, 0, data.data(), length));
+  IREE_ASSERT_OK(iree_hal_file_write(file, file_offset, buffer, 0, length));
+
+  std::vector<uint8_t> file_data(length);
+  ASSERT_EQ(pread(fd_, file_data.data(), length, file_offset), (ssize_t)length);
+  EXPECT_EQ(file_data, data);
+
+  iree_hal_buffer_t* read_buffer = Allocate(length);
+  IREE_ASSERT_OK(
+      iree_hal_file_read(file, file_offset, read_buffer, 0, length));
+  EXPECT_EQ(ReadBack(read_buffer, 0, length), data);
+  iree_hal_buffer_release(read_buffer);
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+// Tests that reading past the end of the file fails after all in-flight
+// requests have drained and that the file remains usable.
+TEST_F(IoUringFileTest, ReadPastEnd) {
+  iree_hal_file_t* file = CreateFile(IREE_HAL_IO_URING_FILE_FLAG_NONE);
+  const iree_host_size_t length = 1024 * 1024;
+  iree_hal_buffer_t* buffer = Allocate(length);
+  EXPECT_THAT(Status(iree_hal_file_read(file, kFileLength - length / 2, buffer,
+                                        0, length)),
+              StatusIs(StatusCode::kOutOfRange));
+  IREE_ASSERT_OK(iree_hal_file_read(file, 0, buffer, 0, length));
+  EXPECT_EQ(ReadBack(buffer, 0, length), Expected(0, length));
+  iree_hal_buffer_release(buffer);
+  iree_hal_file_release(file);
+}
+
+using FileFromHandleTest = FdFileTestBase;
+
+// Tests that fd handles can be read with and without preferring io_uring.
+// When io_uring is unavailable the preference must fall back to pread.
+TEST_F(FileFromHandleTest, ReadFd) {
+  for (iree_hal_file_from_handle_flags_t flags :
+       {IREE_HAL_FILE_FROM_HANDLE_FLAG_NONE,
+        IREE_HAL_FILE_FROM_HANDLE_FLAG_PREFER_IO_URING}) {
+    iree_hal_file_t* file = NULL;
+    IREE_ASSERT_OK(iree_hal_file_from_handle_with_flags(
+        device_allocator_, IREE_HAL_QUEUE_AFFINITY_ANY,
+        IREE_HAL_MEMORY_ACCESS_READ, handle_, flags, iree_allocator_system(),
+        &file));
+    EXPECT_EQ(iree_hal_file_length(file), kFileLength);
+    iree_hal_buffer_t* buffer = Allocate(kFileLength);
+    IREE_ASSERT_OK(iree_hal_file_read(file, 0, buffer, 0, kFileLength));
+    EXPECT_EQ(ReadBack(buffer, 0, kFileLength), Expected(0, kFileLength));
+    iree_hal_buffer_release(buffer);
+    iree_hal_file_release(file);
+  }
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
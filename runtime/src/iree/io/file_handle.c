@@ -698,14 +698,21 @@ static iree_status_t iree_io_platform_map_file_view(
   } else {
     map_flags |= MAP_SHARED;
   }
+
+  // Map the memory.
+  // MAP_HUGETLB is only supported for files on hugetlbfs and fails with EINVAL
+  // for everything else; in that case we fall back to normal pages and request
+  // transparent huge pages below.
+  void* ptr = MAP_FAILED;
 #if defined(MAP_HUGETLB)
   if (iree_all_bits_set(flags, IREE_IO_FILE_MAPPING_FLAG_LARGE_PAGES)) {
-    map_flags |= MAP_HUGETLB;
+    ptr = mmap(NULL, adjusted_length, prot, map_flags | MAP_HUGETLB, fd,
+               offset);
   }
 #endif  // MAP_HUGETLB
-
-  // Map the memory.
-  void* ptr = mmap(NULL, adjusted_length, prot, map_flags, fd, offset);
+  if (ptr == MAP_FAILED) {
+    ptr = mmap(NULL, adjusted_length, prot, map_flags, fd, offset);
+  }
   if (ptr == MAP_FAILED) {
     return iree_make_status(iree_status_code_from_errno(errno),
                             "failed to map file handle range %" PRIu64
@@ -715,17 +722,22 @@ static iree_status_t iree_io_platform_map_file_view(
   }
 
   // Pass hints to the memory manager - informational only.
-  int advice = 0;
+  // Note that advice values are not bit flags and must be issued separately.
   if (iree_all_bits_set(flags, IREE_IO_FILE_MAPPING_FLAG_SEQUENTIAL_ACCESS)) {
-    advice |= MADV_SEQUENTIAL;
+    madvise(ptr, adjusted_length, MADV_SEQUENTIAL);
   }
 #if defined(MADV_DONTDUMP)
   if (iree_all_bits_set(flags, IREE_IO_FILE_MAPPING_FLAG_EXCLUDE_FROM_DUMPS)) {
-    advice |= MADV_DONTDUMP;
+    madvise(ptr, adjusted_length, MADV_DONTDUMP);
   }
 #endif  // MADV_DONTDUMP
-  if (advice) {
-    madvise(ptr, adjusted_length, advice);
+#if defined(MADV_HUGEPAGE)
+  if (iree_all_bits_set(flags, IREE_IO_FILE_MAPPING_FLAG_LARGE_PAGES)) {
+    madvise(ptr, adjusted_length, MADV_HUGEPAGE);
+  }
+#endif  // MADV_HUGEPAGE
+  if (iree_all_bits_set(flags, IREE_IO_FILE_MAPPING_FLAG_PREFETCH)) {
+    madvise(ptr, adjusted_length, MADV_WILLNEED);
   }
 
   *out_impl = ptr;
@@ -795,7 +807,10 @@ static iree_status_t iree_io_platform_map_file_view(
   // Create a file mapping object which will retain the file handle for the
   // lifetime of the mapping.
   DWORD protect = 0;
-  if (iree_all_bits_set(access, IREE_IO_FILE_ACCESS_WRITE)) {
+  if (iree_all_bits_set(flags, IREE_IO_FILE_MAPPING_FLAG_PRIVATE) &&
+      iree_all_bits_set(access, IREE_IO_FILE_ACCESS_WRITE)) {
+    protect |= PAGE_WRITECOPY;
+  } else if (iree_all_bits_set(access, IREE_IO_FILE_ACCESS_WRITE)) {
     protect |= PAGE_READWRITE;
   } else if (iree_all_bits_set(access, IREE_IO_FILE_ACCESS_READ)) {
     protect |= PAGE_READONLY;
@@ -813,7 +828,10 @@ static iree_status_t iree_io_platform_map_file_view(
 
   // Map the requested range into the virtual address space of the process.
   DWORD desired_access = 0;
-  if (iree_all_bits_set(access, IREE_IO_FILE_ACCESS_READ)) {
+  if (iree_all_bits_set(flags, IREE_IO_FILE_MAPPING_FLAG_PRIVATE) &&
+      iree_all_bits_set(access, IREE_IO_FILE_ACCESS_WRITE)) {
+    desired_access |= FILE_MAP_COPY;
+  } else if (iree_all_bits_set(access, IREE_IO_FILE_ACCESS_READ)) {
     desired_access |= FILE_MAP_READ;
   } else if (iree_all_bits_set(access, IREE_IO_FILE_ACCESS_WRITE)) {
     desired_access |= FILE_MAP_WRITE;
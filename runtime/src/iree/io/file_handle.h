@@ -258,7 +258,8 @@ enum iree_io_file_mapping_flag_bits_t {
   // larger than the normal page size (MB vs. KB) care should be used to only
   // apply this to large allocations.
   //
-  // Implemented by FILE_MAP_LARGE_PAGES/MAP_HUGETLB, where available.
+  // Implemented by FILE_MAP_LARGE_PAGES/MAP_HUGETLB, where available, and
+  // otherwise by requesting transparent huge pages with MADV_HUGEPAGE.
   IREE_IO_FILE_MAPPING_FLAG_LARGE_PAGES = 1ull << 1,
 
   // Excludes the view memory from minidumps/coredumps.
@@ -277,6 +278,13 @@ enum iree_io_file_mapping_flag_bits_t {
   //
   // Implemented by MAP_PRIVATE, where available.
   IREE_IO_FILE_MAPPING_FLAG_PRIVATE = 1ull << 3,
+
+  // Hints that the entire view will be accessed soon and should be read into
+  // memory asynchronously. Useful to overlap file I/O with other work when the
+  // view is mapped well in advance of its first use.
+  //
+  // Implemented by MADV_WILLNEED, where available.
+  IREE_IO_FILE_MAPPING_FLAG_PREFETCH = 1ull << 4,
 };
 
 // A mapped file view into host memory.
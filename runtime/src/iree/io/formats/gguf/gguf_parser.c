@@ -417,12 +417,24 @@ static iree_status_t iree_io_gguf_calculate_storage_size(
   for (uint32_t i = 0; i < tensor_info->n_dimensions; ++i) {
     element_count *= tensor_info->dimensions[i];
   }
-  if (tensor_info->type < 0 || tensor_info->type >= GGML_TYPE_COUNT) {
+  if (tensor_info->type >= GGML_TYPE_COUNT ||
+      ggml_type_traits[tensor_info->type].blck_size == 0) {
     return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                             "GGML tensor type %d not supported",
                             (int)tensor_info->type);
   }
   const ggml_type_traits_t type_traits = ggml_type_traits[tensor_info->type];
+  // Blocks never span rows so the innermost dimension must be whole blocks.
+  if (tensor_info->n_dimensions > 0 &&
+      tensor_info->dimensions[0] % type_traits.blck_size != 0) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "tensor `%.*s` innermost dimension %" PRIu64
+        " is not a multiple of the GGML type %d block size %d",
+        (int)tensor_info->name.size, tensor_info->name.data,
+        tensor_info->dimensions[0], (int)tensor_info->type,
+        type_traits.blck_size);
+  }
   *out_storage_size =
       (element_count * type_traits.type_size) / type_traits.blck_size;
   return iree_ok_status();
@@ -635,10 +647,38 @@ static iree_status_t iree_io_gguf_append_tensor_info(
                             begin, end, parser->tensor_data_size);
   }
 
+  // Block-quantized tensors are exposed as their raw blocks and carry the
+  // block layout in the entry metadata so that consumers can operate on them
+  // directly instead of requiring them to be dequantized ahead of time.
+  iree_io_gguf_tensor_metadata_t tensor_metadata;
+  iree_const_byte_span_t metadata = iree_const_byte_span_empty();
+  const ggml_type_traits_t type_traits = ggml_type_traits[tensor_info->type];
+  if (type_traits.blck_size > 1) {
+    if (tensor_info->n_dimensions > IREE_IO_GGUF_MAX_DIMENSIONS) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "tensor `%.*s` has rank %u but at most %d "
+                              "dimensions are supported",
+                              (int)tensor_info->name.size,
+                              tensor_info->name.data, tensor_info->n_dimensions,
+                              IREE_IO_GGUF_MAX_DIMENSIONS);
+    }
+    memset(&tensor_metadata, 0, sizeof(tensor_metadata));
+    tensor_metadata.magic = IREE_IO_GGUF_TENSOR_METADATA_MAGIC;
+    tensor_metadata.type = tensor_info->type;
+    tensor_metadata.block_element_count = (uint32_t)type_traits.blck_size;
+    tensor_metadata.block_size = (uint32_t)type_traits.type_size;
+    tensor_metadata.dimension_count = tensor_info->n_dimensions;
+    for (uint32_t i = 0; i < tensor_info->n_dimensions; ++i) {
+      tensor_metadata.dimensions[i] = tensor_info->dimensions[i];
+    }
+    metadata = iree_make_const_byte_span(&tensor_metadata,
+                                         sizeof(tensor_metadata));
+  }
+
   // Add entry to the index.
   iree_io_parameter_index_entry_t entry = {
       .key = tensor_info->name,
-      .metadata = iree_const_byte_span_empty(),
+      .metadata = metadata,
       .length = storage_size,
       .type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE,
       .storage =
@@ -726,6 +766,31 @@ static iree_status_t iree_io_parse_gguf_index_from_memory(
   return iree_ok_status();
 }
 
+IREE_API_EXPORT iree_status_t iree_io_gguf_tensor_metadata_parse(
+    iree_const_byte_span_t metadata,
+    iree_io_gguf_tensor_metadata_t* out_metadata) {
+  IREE_ASSERT_ARGUMENT(out_metadata);
+  memset(out_metadata, 0, sizeof(*out_metadata));
+  if (metadata.data_length != sizeof(*out_metadata)) {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "entry metadata is not GGUF tensor metadata");
+  }
+  // Metadata storage in the index has no alignment guarantees.
+  memcpy(out_metadata, metadata.data, sizeof(*out_metadata));
+  if (out_metadata->magic != IREE_IO_GGUF_TENSOR_METADATA_MAGIC) {
+    memset(out_metadata, 0, sizeof(*out_metadata));
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "entry metadata is not GGUF tensor metadata");
+  }
+  if (out_metadata->dimension_count > IREE_IO_GGUF_MAX_DIMENSIONS ||
+      out_metadata->block_element_count == 0 ||
+      out_metadata->block_size == 0) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "GGUF tensor metadata is corrupt");
+  }
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT iree_status_t iree_io_parse_gguf_index(
     iree_io_file_handle_t* file_handle, iree_io_parameter_index_t* index,
     iree_allocator_t host_allocator) {
@@ -15,7 +15,77 @@
 extern "C" {
 #endif  // __cplusplus
 
+//===----------------------------------------------------------------------===//
+// GGML tensor types
+//===----------------------------------------------------------------------===//
+
+// Storage type of a tensor in a .gguf file. Values match `ggml_type` in ggml.h
+// and are stored in files so they must not change.
+enum iree_io_gguf_tensor_type_e {
+  IREE_IO_GGUF_TENSOR_TYPE_F32 = 0,
+  IREE_IO_GGUF_TENSOR_TYPE_F16 = 1,
+  IREE_IO_GGUF_TENSOR_TYPE_Q4_0 = 2,
+  IREE_IO_GGUF_TENSOR_TYPE_Q4_1 = 3,
+  IREE_IO_GGUF_TENSOR_TYPE_Q5_0 = 6,
+  IREE_IO_GGUF_TENSOR_TYPE_Q5_1 = 7,
+  IREE_IO_GGUF_TENSOR_TYPE_Q8_0 = 8,
+  IREE_IO_GGUF_TENSOR_TYPE_Q8_1 = 9,
+  IREE_IO_GGUF_TENSOR_TYPE_Q2_K = 10,
+  IREE_IO_GGUF_TENSOR_TYPE_Q3_K = 11,
+  IREE_IO_GGUF_TENSOR_TYPE_Q4_K = 12,
+  IREE_IO_GGUF_TENSOR_TYPE_Q5_K = 13,
+  IREE_IO_GGUF_TENSOR_TYPE_Q6_K = 14,
+  IREE_IO_GGUF_TENSOR_TYPE_Q8_K = 15,
+  IREE_IO_GGUF_TENSOR_TYPE_I8 = 16,
+  IREE_IO_GGUF_TENSOR_TYPE_I16 = 17,
+  IREE_IO_GGUF_TENSOR_TYPE_I32 = 18,
+};
+typedef uint32_t iree_io_gguf_tensor_type_t;
+
+// Maximum tensor rank supported by GGML (GGML_MAX_DIMS).
+#define IREE_IO_GGUF_MAX_DIMENSIONS 4
+
+// Magic value identifying iree_io_gguf_tensor_metadata_t: 'GGQB'.
+#define IREE_IO_GGUF_TENSOR_METADATA_MAGIC 0x42514747u
+
+// Metadata attached to parameter index entries of block-quantized tensors.
+// The parameter contents are the raw GGML blocks exactly as stored in the file
+// (no dequantization is performed) and this describes how to interpret them.
+// Tensors with scalar element types (F32, F16, I8, etc) have no metadata.
+//
+// Blocks are laid out row-major with the innermost dimension first: a tensor
+// with dimensions [K, N] is N rows of K / block_element_count blocks each.
+typedef struct iree_io_gguf_tensor_metadata_t {
+  // IREE_IO_GGUF_TENSOR_METADATA_MAGIC.
+  uint32_t magic;
+  // Block-quantized storage type of the tensor.
+  iree_io_gguf_tensor_type_t type;
+  // Number of logical elements encoded by each block.
+  uint32_t block_element_count;
+  // Size of each block in bytes.
+  uint32_t block_size;
+  // Number of valid dimensions in |dimensions|.
+  uint32_t dimension_count;
+  uint32_t reserved;
+  // Logical tensor dimensions with the innermost (contiguous) dimension first
+  // as in the file. dimensions[0] is a multiple of block_element_count.
+  uint64_t dimensions[IREE_IO_GGUF_MAX_DIMENSIONS];
+} iree_io_gguf_tensor_metadata_t;
+
+// Decodes the |metadata| of a parameter index entry produced by
+// iree_io_parse_gguf_index into |out_metadata|. Returns IREE_STATUS_NOT_FOUND
+// if the entry is not a block-quantized tensor.
+IREE_API_EXPORT iree_status_t iree_io_gguf_tensor_metadata_parse(
+    iree_const_byte_span_t metadata,
+    iree_io_gguf_tensor_metadata_t* out_metadata);
+
+//===----------------------------------------------------------------------===//
+// Parsing
+//===----------------------------------------------------------------------===//
+
 // Parses a .gguf file and merges its contained resources into |index|.
+// Block-quantized tensors are added with their raw block contents and an
+// iree_io_gguf_tensor_metadata_t describing the block layout.
 //
 // Specification:
 // https://github.com/ggerganov/ggml/blob/master/docs/gguf.md
@@ -125,5 +125,72 @@ TEST(GgufFormatTest, MultipleTensors) {
   iree_io_parameter_index_release(index);
 }
 
+TEST(GgufFormatTest, QuantizedTensors) {
+  iree_io_parameter_index_t* index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &index));
+
+  iree_io_file_handle_t* file_handle = OpenTestFile("quantized.gguf");
+  IREE_ASSERT_OK(
+      iree_io_parse_gguf_index(file_handle, index, iree_allocator_system()));
+  iree_io_file_handle_release(file_handle);
+
+  // 2 rows of 2 Q4_0 blocks (32 elements in 18 bytes each).
+  const iree_io_parameter_index_entry_t* q4_0 = NULL;
+  IREE_ASSERT_OK(iree_io_parameter_index_lookup(index, IREE_SV("q4_0"), &q4_0));
+  EXPECT_EQ(q4_0->storage.file.offset, 512);
+  EXPECT_EQ(q4_0->length, 2 * 2 * 18);
+  iree_io_gguf_tensor_metadata_t q4_0_metadata;
+  IREE_ASSERT_OK(
+      iree_io_gguf_tensor_metadata_parse(q4_0->metadata, &q4_0_metadata));
+  EXPECT_EQ(q4_0_metadata.type, IREE_IO_GGUF_TENSOR_TYPE_Q4_0);
+  EXPECT_EQ(q4_0_metadata.block_element_count, 32);
+  EXPECT_EQ(q4_0_metadata.block_size, 18);
+  EXPECT_EQ(q4_0_metadata.dimension_count, 2);
+  EXPECT_EQ(q4_0_metadata.dimensions[0], 64);
+  EXPECT_EQ(q4_0_metadata.dimensions[1], 2);
+
+  // 3 rows of 1 Q8_0 block (32 elements in 34 bytes each).
+  const iree_io_parameter_index_entry_t* q8_0 = NULL;
+  IREE_ASSERT_OK(iree_io_parameter_index_lookup(index, IREE_SV("q8_0"), &q8_0));
+  EXPECT_EQ(q8_0->storage.file.offset, 640);
+  EXPECT_EQ(q8_0->length, 3 * 34);
+  iree_io_gguf_tensor_metadata_t q8_0_metadata;
+  IREE_ASSERT_OK(
+      iree_io_gguf_tensor_metadata_parse(q8_0->metadata, &q8_0_metadata));
+  EXPECT_EQ(q8_0_metadata.type, IREE_IO_GGUF_TENSOR_TYPE_Q8_0);
+  EXPECT_EQ(q8_0_metadata.block_element_count, 32);
+  EXPECT_EQ(q8_0_metadata.block_size, 34);
+  EXPECT_EQ(q8_0_metadata.dimensions[0], 32);
+  EXPECT_EQ(q8_0_metadata.dimensions[1], 3);
+
+  // 1 row of 1 Q4_K super-block (256 elements in 144 bytes).
+  const iree_io_parameter_index_entry_t* q4_k = NULL;
+  IREE_ASSERT_OK(iree_io_parameter_index_lookup(index, IREE_SV("q4_k"), &q4_k));
+  EXPECT_EQ(q4_k->storage.file.offset, 768);
+  EXPECT_EQ(q4_k->length, 144);
+  iree_io_gguf_tensor_metadata_t q4_k_metadata;
+  IREE_ASSERT_OK(
+      iree_io_gguf_tensor_metadata_parse(q4_k->metadata, &q4_k_metadata));
+  EXPECT_EQ(q4_k_metadata.type, IREE_IO_GGUF_TENSOR_TYPE_Q4_K);
+  EXPECT_EQ(q4_k_metadata.block_element_count, 256);
+  EXPECT_EQ(q4_k_metadata.block_size, 144);
+  EXPECT_EQ(q4_k_metadata.dimensions[0], 256);
+  EXPECT_EQ(q4_k_metadata.dimensions[1], 1);
+
+  // Scalar tensors have no block metadata.
+  const iree_io_parameter_index_entry_t* f32 = NULL;
+  IREE_ASSERT_OK(iree_io_parameter_index_lookup(index, IREE_SV("f32"), &f32));
+  EXPECT_EQ(f32->storage.file.offset, 960);
+  EXPECT_EQ(f32->length, 16);
+  EXPECT_TRUE(iree_const_byte_span_is_empty(f32->metadata));
+  iree_io_gguf_tensor_metadata_t f32_metadata;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_NOT_FOUND,
+      iree_io_gguf_tensor_metadata_parse(f32->metadata, &f32_metadata));
+
+  iree_io_parameter_index_release(index);
+}
+
 }  // namespace
 }  // namespace iree
@@ -22,7 +22,7 @@
 
 import argparse
 import numpy as np
-from gguf import GGUFWriter
+from gguf import GGML_QUANT_SIZES, GGMLQuantizationType, GGUFWriter
 
 
 def save_file(tensors, path):
@@ -36,7 +36,11 @@ def save_file(tensors, path):
     writer.add_array("metadata_strs", ["a", "b", "c"])
 
     for key, value in tensors.items():
-        writer.add_tensor(key, value)
+        if isinstance(value, tuple):
+            value, raw_dtype = value
+            writer.add_tensor(key, value, raw_dtype=raw_dtype)
+        else:
+            writer.add_tensor(key, value)
 
     writer.write_header_to_file()
     writer.write_kv_data_to_file()
@@ -45,6 +49,18 @@ def save_file(tensors, path):
     writer.close()
 
 
+def quantized_blocks(quant_type, rows, cols):
+    """Returns raw blocks for a rows x cols tensor of the given quantized type.
+
+    The block contents are an arbitrary byte pattern: the parser only cares
+    about the layout and not the values.
+    """
+    block_size, type_size = GGML_QUANT_SIZES[quant_type]
+    byte_count = rows * (cols // block_size) * type_size
+    data = (np.arange(byte_count) % 251).astype(np.uint8)
+    return (data.reshape(rows, byte_count // rows), quant_type)
+
+
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description="GGUF testdata file generator.")
     parser.add_argument(
@@ -70,3 +86,14 @@ if __name__ == "__main__":
         },
         f"multiple{args.suffix}.gguf",
     )
+
+    # block-quantized tensors mixed with a scalar tensor
+    save_file(
+        {
+            "q4_0": quantized_blocks(GGMLQuantizationType.Q4_0, 2, 64),
+            "q8_0": quantized_blocks(GGMLQuantizationType.Q8_0, 3, 32),
+            "q4_k": quantized_blocks(GGMLQuantizationType.Q4_K, 1, 256),
+            "f32": np.ones((1, 4), dtype=np.float32),
+        },
+        f"quantized{args.suffix}.gguf",
+    )
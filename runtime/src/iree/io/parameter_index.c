@@ -7,8 +7,48 @@
 #include "iree/io/parameter_index.h"
 
 #include "iree/base/internal/atomics.h"
+#include "iree/base/internal/hash.h"
 #include "iree/base/internal/synchronization.h"
 
+//===----------------------------------------------------------------------===//
+// Key hashing
+//===----------------------------------------------------------------------===//
+
+// Maximum fraction of buckets that may be used before the table is grown.
+// Linear probing degrades quickly past ~75% so we keep it well under that.
+#define IREE_IO_PARAMETER_INDEX_MAX_LOAD_NUMERATOR 1
+#define IREE_IO_PARAMETER_INDEX_MAX_LOAD_DENOMINATOR 2
+
+// A single bucket in the key hash table.
+// An empty bucket has a NULL |entry|. We keep the full hash so that probing
+// only needs to compare keys when the hashes match and growth does not need
+// to rehash the key strings.
+typedef struct iree_io_parameter_index_bucket_t {
+  uint64_t hash;
+  const iree_io_parameter_index_entry_t* entry;
+} iree_io_parameter_index_bucket_t;
+
+// Returns the bucket containing |key| or the empty bucket where it would be
+// inserted. Requires that the table has at least one empty bucket.
+static iree_io_parameter_index_bucket_t* iree_io_parameter_index_find_bucket(
+    iree_io_parameter_index_bucket_t* buckets, iree_host_size_t bucket_capacity,
+    uint64_t hash, iree_string_view_t key) {
+  const iree_host_size_t mask = bucket_capacity - 1;
+  iree_host_size_t i = (iree_host_size_t)hash & mask;
+  while (buckets[i].entry) {
+    if (buckets[i].hash == hash &&
+        iree_string_view_equal(key, buckets[i].entry->key)) {
+      break;
+    }
+    i = (i + 1) & mask;
+  }
+  return &buckets[i];
+}
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_index_t
+//===----------------------------------------------------------------------===//
+
 struct iree_io_parameter_index_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t host_allocator;
@@ -24,6 +64,13 @@ struct iree_io_parameter_index_t {
   iree_host_size_t entry_count;
   // Dense list of entries in the index. Grows as needed.
   iree_io_parameter_index_entry_t** entries;
+
+  // Total capacity of the open-addressed hash table in buckets. Always zero or
+  // a power of two so that probing can mask instead of mod.
+  iree_host_size_t bucket_capacity;
+  // Hash table mapping keys to entries using linear probing. Rebuilt when
+  // grown and otherwise only appended to as the index is insert-only.
+  iree_io_parameter_index_bucket_t* buckets;
 };
 
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_create(
@@ -46,6 +93,8 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_create(
   index->entry_capacity = 0;
   index->entry_count = 0;
   index->entries = NULL;
+  index->bucket_capacity = 0;
+  index->buckets = NULL;
 
   *out_index = index;
   IREE_TRACE_ZONE_END(z0);
@@ -71,6 +120,9 @@ static void iree_io_parameter_index_destroy(iree_io_parameter_index_t* index) {
   if (index->entries) {
     iree_allocator_free(host_allocator, index->entries);
   }
+  if (index->buckets) {
+    iree_allocator_free(host_allocator, index->buckets);
+  }
 
   iree_slim_mutex_deinitialize(&index->mutex);
 
@@ -102,6 +154,44 @@ iree_io_parameter_index_count(iree_io_parameter_index_t* index) {
   return count;
 }
 
+// Grows the hash table such that |entry_capacity| entries can be stored
+// without exceeding the maximum load factor. Buckets are moved in table order.
+// This keeps first-wins lookups intact because the table only ever holds the
+// first entry added for each key; later duplicates are never inserted.
+static iree_status_t iree_io_parameter_index_reserve_buckets_unsafe(
+    iree_io_parameter_index_t* index, iree_host_size_t entry_capacity) {
+  iree_host_size_t new_bucket_capacity = 16;
+  while (new_bucket_capacity * IREE_IO_PARAMETER_INDEX_MAX_LOAD_NUMERATOR <
+         entry_capacity * IREE_IO_PARAMETER_INDEX_MAX_LOAD_DENOMINATOR) {
+    new_bucket_capacity <<= 1;
+  }
+  if (new_bucket_capacity <= index->bucket_capacity) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, new_bucket_capacity);
+
+  iree_io_parameter_index_bucket_t* new_buckets = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(index->host_allocator,
+                                new_bucket_capacity * sizeof(new_buckets[0]),
+                                (void**)&new_buckets));
+  for (iree_host_size_t i = 0; i < index->bucket_capacity; ++i) {
+    const iree_io_parameter_index_bucket_t* old_bucket = &index->buckets[i];
+    if (!old_bucket->entry) continue;
+    iree_io_parameter_index_bucket_t* new_bucket =
+        iree_io_parameter_index_find_bucket(new_buckets, new_bucket_capacity,
+                                            old_bucket->hash,
+                                            old_bucket->entry->key);
+    *new_bucket = *old_bucket;
+  }
+
+  iree_allocator_free(index->host_allocator, index->buckets);
+  index->bucket_capacity = new_bucket_capacity;
+  index->buckets = new_buckets;
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 static iree_status_t iree_io_parameter_index_reserve_unsafe(
     iree_io_parameter_index_t* index, iree_host_size_t new_capacity) {
   IREE_ASSERT_ARGUMENT(index);
@@ -109,10 +199,18 @@ static iree_status_t iree_io_parameter_index_reserve_unsafe(
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, new_capacity);
 
+  // Size the hash table first so that adds up to the new capacity never need
+  // to rehash. Growing the entry list only once the table can hold them keeps
+  // the table from filling up (and probing forever) if either allocation fails.
+  iree_status_t status =
+      iree_io_parameter_index_reserve_buckets_unsafe(index, new_capacity);
+
   iree_io_parameter_index_entry_t** new_entries = index->entries;
-  iree_status_t status = iree_allocator_realloc(
-      index->host_allocator, new_capacity * sizeof(index->entries[0]),
-      (void**)&new_entries);
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_realloc(index->host_allocator,
+                                    new_capacity * sizeof(index->entries[0]),
+                                    (void**)&new_entries);
+  }
   if (iree_status_is_ok(status)) {
     index->entry_capacity = new_capacity;
     index->entries = new_entries;
@@ -186,6 +284,19 @@ iree_io_parameter_index_add(iree_io_parameter_index_t* index,
 
     // Append the entry to the file index.
     index->entries[index->entry_count++] = cloned_entry;
+
+    // Add the entry to the hash table. The table is always sized to the entry
+    // capacity so this cannot fail. If the key already exists we keep the
+    // original entry to match the first-wins behavior of lookups.
+    uint64_t hash = iree_hash_string_view(cloned_entry->key);
+    iree_io_parameter_index_bucket_t* bucket =
+        iree_io_parameter_index_find_bucket(index->buckets,
+                                            index->bucket_capacity, hash,
+                                            cloned_entry->key);
+    if (!bucket->entry) {
+      bucket->hash = hash;
+      bucket->entry = cloned_entry;
+    }
   }
 
   iree_slim_mutex_unlock(&index->mutex);
@@ -226,12 +337,12 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup(
   iree_slim_mutex_lock(&index->mutex);
 
   iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < index->entry_count; ++i) {
-    const iree_io_parameter_index_entry_t* entry = index->entries[i];
-    if (iree_string_view_equal(key, entry->key)) {
-      *out_entry = entry;
-      break;
-    }
+  if (index->bucket_capacity > 0) {
+    const iree_io_parameter_index_bucket_t* bucket =
+        iree_io_parameter_index_find_bucket(
+            index->buckets, index->bucket_capacity,
+            iree_hash_string_view(key), key);
+    *out_entry = bucket->entry;
   }
   if (*out_entry == NULL) {
     status = iree_make_status(IREE_STATUS_NOT_FOUND,
@@ -115,6 +115,8 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_get(
     const iree_io_parameter_index_entry_t** out_entry);
 
 // Performs a file entry lookup of |key| in the index and returns it.
+// Lookups are hashed and take constant time regardless of the number of
+// entries. If multiple entries share the same key the first added is returned.
 // The returned |out_entry| is valid for the lifetime of the index.
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup(
     iree_io_parameter_index_t* index, iree_string_view_t key,
@@ -0,0 +1,205 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/prng.h"
+#include "iree/io/parameter_index.h"
+#include "iree/testing/benchmark.h"
+
+// Formats the key for parameter |i| into |buffer|.
+// Keys are shaped like those in real LLM checkpoints so that they share long
+// common prefixes and only differ in a few characters.
+static iree_string_view_t iree_io_parameter_index_benchmark_key(
+    uint32_t i, char* buffer, iree_host_size_t buffer_capacity) {
+  int length = snprintf(buffer, buffer_capacity,
+                        "model.layers.%u.self_attn.q_proj.weight.%u", i / 16,
+                        i % 16);
+  return iree_make_string_view(buffer, (iree_host_size_t)length);
+}
+
+// Creates an index with |count| splat entries with unique keys.
+static iree_io_parameter_index_t* iree_io_parameter_index_benchmark_create(
+    uint32_t count, iree_allocator_t host_allocator) {
+  iree_io_parameter_index_t* index = NULL;
+  IREE_CHECK_OK(iree_io_parameter_index_create(host_allocator, &index));
+  char key_buffer[128];
+  for (uint32_t i = 0; i < count; ++i) {
+    iree_io_parameter_index_entry_t entry = {
+        .key = iree_io_parameter_index_benchmark_key(i, key_buffer,
+                                                     sizeof(key_buffer)),
+        .metadata = iree_const_byte_span_empty(),
+        .length = 4,
+        .type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT,
+        .storage =
+            {
+                .splat =
+                    {
+                        .pattern_length = 1,
+                        .pattern = {0},
+                    },
+            },
+    };
+    IREE_CHECK_OK(iree_io_parameter_index_add(index, &entry));
+  }
+  return index;
+}
+
+// Tests the cost of building an index of N entries one add at a time as the
+// parsers do.
+//
+// user_data is a count of entries to add.
+static iree_status_t iree_io_parameter_index_benchmark_add_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  uint32_t count = (uint32_t)(uintptr_t)benchmark_def->user_data;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/count)) {
+    iree_io_parameter_index_t* index =
+        iree_io_parameter_index_benchmark_create(count, host_allocator);
+    iree_io_parameter_index_release(index);
+  }
+  return iree_ok_status();
+}
+
+// Tests lookup performance of keys in randomized order in an index of N
+// entries. This should be flat as N grows.
+//
+// user_data is a count of entries in the index.
+static iree_status_t iree_io_parameter_index_benchmark_lookup_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  uint32_t count = (uint32_t)(uintptr_t)benchmark_def->user_data;
+  iree_io_parameter_index_t* index =
+      iree_io_parameter_index_benchmark_create(count, host_allocator);
+
+  // Preformat keys so we are only measuring the lookup.
+  enum { KEY_POOL_SIZE = 256, KEY_CAPACITY = 128 };
+  char* key_storage = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc(host_allocator,
+                                      KEY_POOL_SIZE * KEY_CAPACITY,
+                                      (void**)&key_storage));
+  iree_string_view_t keys[KEY_POOL_SIZE];
+  iree_prng_xoroshiro128_state_t prng = {0};
+  iree_prng_xoroshiro128_initialize(123ull, &prng);
+  for (uint32_t i = 0; i < KEY_POOL_SIZE; ++i) {
+    uint32_t key_idx = iree_prng_xoroshiro128plus_next_uint32(&prng) % count;
+    keys[i] = iree_io_parameter_index_benchmark_key(
+        key_idx, key_storage + i * KEY_CAPACITY, KEY_CAPACITY);
+  }
+
+  while (iree_benchmark_keep_running(benchmark_state,
+                                     /*batch_count=*/KEY_POOL_SIZE)) {
+    for (uint32_t i = 0; i < KEY_POOL_SIZE; ++i) {
+      const iree_io_parameter_index_entry_t* entry = NULL;
+      IREE_CHECK_OK(iree_io_parameter_index_lookup(index, keys[i], &entry));
+    }
+  }
+
+  iree_allocator_free(host_allocator, key_storage);
+  iree_io_parameter_index_release(index);
+  return iree_ok_status();
+}
+
+// Tests lookup performance of keys that are not present in an index of N
+// entries. This is the worst case for the probing as it must run until an
+// empty bucket is found.
+//
+// user_data is a count of entries in the index.
+static iree_status_t iree_io_parameter_index_benchmark_lookup_miss_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  uint32_t count = (uint32_t)(uintptr_t)benchmark_def->user_data;
+  iree_io_parameter_index_t* index =
+      iree_io_parameter_index_benchmark_create(count, host_allocator);
+
+  char key_buffer[128];
+  iree_string_view_t key = iree_io_parameter_index_benchmark_key(
+      count + 1, key_buffer, sizeof(key_buffer));
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    const iree_io_parameter_index_entry_t* entry = NULL;
+    iree_status_ignore(iree_io_parameter_index_lookup(index, key, &entry));
+  }
+
+  iree_io_parameter_index_release(index);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_io_parameter_index_benchmark_add_n
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_io_parameter_index_benchmark_add_n,
+    };
+    benchmark_def.user_data = (void*)1000u;
+    iree_benchmark_register(iree_make_cstring_view("add_1000"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)10000u;
+    iree_benchmark_register(iree_make_cstring_view("add_10000"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)100000u;
+    iree_benchmark_register(iree_make_cstring_view("add_100000"),
+                            &benchmark_def);
+  }
+
+  // iree_io_parameter_index_benchmark_lookup_n
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_io_parameter_index_benchmark_lookup_n,
+    };
+    benchmark_def.user_data = (void*)1000u;
+    iree_benchmark_register(iree_make_cstring_view("lookup_1000"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)10000u;
+    iree_benchmark_register(iree_make_cstring_view("lookup_10000"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)100000u;
+    iree_benchmark_register(iree_make_cstring_view("lookup_100000"),
+                            &benchmark_def);
+  }
+
+  // iree_io_parameter_index_benchmark_lookup_miss_n
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_io_parameter_index_benchmark_lookup_miss_n,
+    };
+    benchmark_def.user_data = (void*)1000u;
+    iree_benchmark_register(iree_make_cstring_view("lookup_miss_1000"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)10000u;
+    iree_benchmark_register(iree_make_cstring_view("lookup_miss_10000"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)100000u;
+    iree_benchmark_register(iree_make_cstring_view("lookup_miss_100000"),
+                            &benchmark_def);
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
@@ -6,6 +6,7 @@
 
 #include "iree/io/parameter_index_provider.h"
 
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/utils/file_cache.h"
 
 // Limit concurrent operations to avoid blowing the stack. This is arbitrary and
@@ -13,13 +14,39 @@
 // a growable stack scratchpad.
 #define IREE_IO_PARAMETER_OP_BATCH_MAX_CONCURRENCY 8
 
+// Maximum number of memory heaps queried from a device allocator when deciding
+// whether file mappings can be imported.
+#define IREE_IO_PARAMETER_INDEX_PROVIDER_MAX_HEAP_COUNT 8
+
+// Initial capacity of the file mapping cache. Parameters are usually stored in
+// only a few files.
+#define IREE_IO_PARAMETER_INDEX_PROVIDER_INITIAL_MAPPING_CAPACITY 4
+
+// A file handle mapped into host memory for direct import.
+typedef struct iree_io_parameter_index_provider_mapping_t {
+  // File handle the mapping was made from. Retained.
+  iree_io_file_handle_t* handle;
+  // Mapping of the entire file or NULL if the file could not be mapped and
+  // should not be retried. Retained.
+  iree_io_file_mapping_t* mapping;
+} iree_io_parameter_index_provider_mapping_t;
+
 typedef struct iree_io_parameter_index_provider_t {
   iree_io_parameter_provider_t base;
   iree_allocator_t host_allocator;
+  iree_io_parameter_index_provider_flags_t flags;
   iree_host_size_t max_concurrent_operations;
   iree_string_view_t scope;
   iree_io_parameter_index_t* index;
   iree_hal_file_cache_t* file_cache;
+
+  // Guards |mappings|.
+  iree_slim_mutex_t mapping_mutex;
+  // Files mapped for import on host-coherent devices. Imported buffers retain
+  // the mapping they reference so this is just a cache and can be trimmed.
+  iree_host_size_t mapping_count;
+  iree_host_size_t mapping_capacity;
+  iree_io_parameter_index_provider_mapping_t* mappings;
 } iree_io_parameter_index_provider_t;
 
 static const iree_io_parameter_provider_vtable_t
@@ -31,18 +58,41 @@ iree_io_parameter_index_provider_cast(
   return (iree_io_parameter_index_provider_t*)base_provider;
 }
 
+IREE_API_EXPORT void iree_io_parameter_index_provider_options_initialize(
+    iree_io_parameter_index_provider_options_t* out_options) {
+  IREE_ASSERT_ARGUMENT(out_options);
+  memset(out_options, 0, sizeof(*out_options));
+  out_options->flags = IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_NONE;
+  out_options->max_concurrent_operations =
+      IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS;
+}
+
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
     iree_string_view_t scope, iree_io_parameter_index_t* index,
     iree_host_size_t max_concurrent_operations, iree_allocator_t host_allocator,
     iree_io_parameter_provider_t** out_provider) {
+  iree_io_parameter_index_provider_options_t options;
+  iree_io_parameter_index_provider_options_initialize(&options);
+  options.max_concurrent_operations = max_concurrent_operations;
+  return iree_io_parameter_index_provider_create_with_options(
+      scope, index, &options, host_allocator, out_provider);
+}
+
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_provider_create_with_options(
+    iree_string_view_t scope, iree_io_parameter_index_t* index,
+    const iree_io_parameter_index_provider_options_t* options,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider) {
   IREE_ASSERT_ARGUMENT(index);
+  IREE_ASSERT_ARGUMENT(options);
   IREE_ASSERT_ARGUMENT(out_provider);
   *out_provider = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_TEXT(z0, scope.data, scope.size);
 
-  max_concurrent_operations =
-      iree_max(1, iree_min(max_concurrent_operations,
+  const iree_host_size_t max_concurrent_operations =
+      iree_max(1, iree_min(options->max_concurrent_operations,
                            IREE_IO_PARAMETER_OP_BATCH_MAX_CONCURRENCY));
 
   iree_io_parameter_index_provider_t* provider = NULL;
@@ -52,7 +102,9 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
   iree_atomic_ref_count_init(&provider->base.ref_count);
   provider->base.vtable = &iree_io_parameter_index_provider_vtable;
   provider->host_allocator = host_allocator;
+  provider->flags = options->flags;
   provider->max_concurrent_operations = max_concurrent_operations;
+  iree_slim_mutex_initialize(&provider->mapping_mutex);
 
   provider->scope = iree_make_string_view(
       (const char*)provider + sizeof(*provider), scope.size);
@@ -73,6 +125,19 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
   return status;
 }
 
+// Releases all cached file mappings. Buffers imported from the mappings retain
+// them and remain valid.
+static void iree_io_parameter_index_provider_trim_mappings(
+    iree_io_parameter_index_provider_t* provider) {
+  iree_slim_mutex_lock(&provider->mapping_mutex);
+  for (iree_host_size_t i = 0; i < provider->mapping_count; ++i) {
+    iree_io_file_mapping_release(provider->mappings[i].mapping);
+    iree_io_file_handle_release(provider->mappings[i].handle);
+  }
+  provider->mapping_count = 0;
+  iree_slim_mutex_unlock(&provider->mapping_mutex);
+}
+
 static void iree_io_parameter_index_provider_destroy(
     iree_io_parameter_provider_t* IREE_RESTRICT base_provider) {
   iree_io_parameter_index_provider_t* provider =
@@ -80,6 +145,9 @@ static void iree_io_parameter_index_provider_destroy(
   iree_allocator_t host_allocator = provider->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_io_parameter_index_provider_trim_mappings(provider);
+  iree_allocator_free(host_allocator, provider->mappings);
+  iree_slim_mutex_deinitialize(&provider->mapping_mutex);
   iree_hal_file_cache_release(provider->file_cache);
   iree_io_parameter_index_release(provider->index);
 
@@ -99,6 +167,7 @@ static iree_status_t iree_io_parameter_index_provider_notify(
     case IREE_IO_PARAMETER_PROVIDER_SIGNAL_SUSPEND:
     case IREE_IO_PARAMETER_PROVIDER_SIGNAL_LOW_MEMORY:
       iree_hal_file_cache_trim(provider->file_cache);
+      iree_io_parameter_index_provider_trim_mappings(provider);
       break;
     default:
       break;
@@ -678,6 +747,206 @@ static void iree_io_file_handle_buffer_release(void* user_data,
   iree_io_file_handle_release((iree_io_file_handle_t*)user_data);
 }
 
+static void iree_io_file_mapping_buffer_release(void* user_data,
+                                                iree_hal_buffer_t* buffer) {
+  iree_io_file_mapping_release((iree_io_file_mapping_t*)user_data);
+}
+
+// Queries whether all memory heaps of |device_allocator| are host-visible and
+// host-coherent such that host memory can be imported without copies (as with
+// local-sync/local-task). |out_min_alignment| receives the largest alignment
+// required by any heap.
+static bool iree_io_parameter_index_provider_is_host_coherent(
+    iree_hal_allocator_t* device_allocator,
+    iree_device_size_t* out_min_alignment) {
+  *out_min_alignment = 1;
+  iree_hal_allocator_memory_heap_t
+      heaps[IREE_IO_PARAMETER_INDEX_PROVIDER_MAX_HEAP_COUNT];
+  iree_host_size_t heap_count = 0;
+  iree_status_t status = iree_hal_allocator_query_memory_heaps(
+      device_allocator, IREE_ARRAYSIZE(heaps), heaps, &heap_count);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return false;
+  }
+  bool is_host_coherent = heap_count > 0;
+  for (iree_host_size_t i = 0; i < heap_count; ++i) {
+    if (!iree_all_bits_set(heaps[i].type,
+                           IREE_HAL_MEMORY_TYPE_HOST_VISIBLE |
+                               IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+      is_host_coherent = false;
+    }
+    *out_min_alignment = iree_max(*out_min_alignment, heaps[i].min_alignment);
+  }
+  return is_host_coherent;
+}
+
+// Returns a retained mapping of the entire file |handle| or NULL if the file
+// cannot be mapped. Mappings are cached such that all parameters in the same
+// file share a single mapping.
+static iree_status_t iree_io_parameter_index_provider_map_file(
+    iree_io_parameter_index_provider_t* provider,
+    iree_io_file_handle_t* handle, iree_io_file_mapping_t** out_mapping) {
+  *out_mapping = NULL;
+  iree_slim_mutex_lock(&provider->mapping_mutex);
+
+  for (iree_host_size_t i = 0; i < provider->mapping_count; ++i) {
+    if (provider->mappings[i].handle == handle) {
+      *out_mapping = provider->mappings[i].mapping;
+      iree_io_file_mapping_retain(*out_mapping);
+      iree_slim_mutex_unlock(&provider->mapping_mutex);
+      return iree_ok_status();
+    }
+  }
+
+  if (provider->mapping_count == provider->mapping_capacity) {
+    iree_host_size_t new_capacity =
+        iree_max(IREE_IO_PARAMETER_INDEX_PROVIDER_INITIAL_MAPPING_CAPACITY,
+                 provider->mapping_capacity * 2);
+    iree_status_t status = iree_allocator_realloc(
+        provider->host_allocator, new_capacity * sizeof(provider->mappings[0]),
+        (void**)&provider->mappings);
+    if (!iree_status_is_ok(status)) {
+      // Not being able to cache the mapping is not fatal: the caller falls
+      // back to allocating and reading.
+      iree_status_ignore(status);
+      iree_slim_mutex_unlock(&provider->mapping_mutex);
+      return iree_ok_status();
+    }
+    provider->mapping_capacity = new_capacity;
+  }
+
+  // Map the file copy-on-write so that the pages are shared with the page cache
+  // until written. Failure to map (pipes, unsupported platforms, etc) is
+  // recorded so we don't retry for every parameter in the file. No readahead is
+  // requested as only the ranges of parameters that are loaded get touched.
+  IREE_TRACE_ZONE_BEGIN_NAMED(z_map,
+                              "iree_io_parameter_index_provider_map_file");
+  iree_io_file_mapping_t* mapping = NULL;
+  iree_io_file_mapping_flags_t mapping_flags =
+      IREE_IO_FILE_MAPPING_FLAG_PRIVATE |
+      IREE_IO_FILE_MAPPING_FLAG_EXCLUDE_FROM_DUMPS;
+  if (iree_all_bits_set(provider->flags,
+                        IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_LARGE_PAGES)) {
+    mapping_flags |= IREE_IO_FILE_MAPPING_FLAG_LARGE_PAGES;
+  }
+  iree_status_t map_status = iree_io_file_map_view(
+      handle, IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE, 0,
+      IREE_HOST_SIZE_MAX, mapping_flags, provider->host_allocator, &mapping);
+  if (!iree_status_is_ok(map_status)) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z_map, "map failed");
+    iree_status_ignore(map_status);
+    mapping = NULL;
+  }
+  iree_io_file_handle_retain(handle);
+  provider->mappings[provider->mapping_count++] =
+      (iree_io_parameter_index_provider_mapping_t){
+          .handle = handle,
+          .mapping = mapping,
+      };
+  iree_io_file_mapping_retain(mapping);
+  *out_mapping = mapping;
+  IREE_TRACE_ZONE_END(z_map);
+
+  iree_slim_mutex_unlock(&provider->mapping_mutex);
+  return iree_ok_status();
+}
+
+// Attempts to import the file storage of the parameter range described by
+// |entry| and |span| directly as a buffer. This only works with specific file
+// types and with specific target usage. The most common cases for this are
+// when using parameters as staging sources (so host memory is ok) or on
+// unified memory systems (where host memory is device memory) such as the
+// local CPU devices where platform files are memory mapped.
+//
+// |host_coherent| indicates whether the device memory is host memory and
+// platform files should be mapped for import. |min_alignment| is the alignment
+// required by the device for imported memory.
+//
+// Returns a NULL |out_buffer| if the import is not possible and the caller
+// should fall back to allocating and reading.
+static iree_status_t iree_io_parameter_index_provider_try_import(
+    iree_io_parameter_index_provider_t* provider, iree_hal_device_t* device,
+    bool host_coherent, iree_device_size_t min_alignment,
+    iree_hal_buffer_params_t target_params,
+    const iree_io_parameter_index_entry_t* entry,
+    const iree_io_parameter_span_t* span, iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  if (entry->type != IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE) {
+    return iree_ok_status();
+  }
+  iree_io_file_handle_t* handle = entry->storage.file.handle;
+  const uint64_t file_offset =
+      entry->storage.file.offset + span->parameter_offset;
+
+  // Get a host pointer to the file contents and a retained reference to the
+  // object keeping them live.
+  iree_byte_span_t contents = iree_byte_span_empty();
+  iree_hal_buffer_release_callback_t release_callback =
+      iree_hal_buffer_release_callback_null();
+  switch (iree_io_file_handle_type(handle)) {
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION: {
+      contents = iree_io_file_handle_primitive(handle).value.host_allocation;
+      release_callback.fn = iree_io_file_handle_buffer_release;
+      release_callback.user_data = handle;
+      iree_io_file_handle_retain(handle);
+      break;
+    }
+    case IREE_IO_FILE_HANDLE_TYPE_FD: {
+      if (!host_coherent ||
+          !iree_all_bits_set(provider->flags,
+                             IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_MAP_FILES)) {
+        return iree_ok_status();
+      }
+      iree_io_file_mapping_t* mapping = NULL;
+      IREE_RETURN_IF_ERROR(
+          iree_io_parameter_index_provider_map_file(provider, handle, &mapping));
+      if (!mapping) return iree_ok_status();
+      contents = iree_io_file_mapping_contents_rw(mapping);
+      release_callback.fn = iree_io_file_mapping_buffer_release;
+      release_callback.user_data = mapping;
+      break;
+    }
+    default:
+      return iree_ok_status();
+  }
+
+  // The range must be in bounds and meet the alignment the device requires of
+  // all buffers (parameter archives are usually aligned for this).
+  uint8_t* ptr = contents.data + file_offset;
+  iree_status_t status = iree_ok_status();
+  if (file_offset + span->length > contents.data_length ||
+      ((uintptr_t)ptr % min_alignment) != 0) {
+    status = iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_hal_external_buffer_t external_buffer = {
+        .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+        .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
+        .size = span->length,
+        .handle =
+            {
+                .host_allocation =
+                    {
+                        .ptr = ptr,
+                    },
+            },
+    };
+    status = iree_hal_allocator_import_buffer(
+        iree_hal_device_allocator(device), target_params, &external_buffer,
+        release_callback, out_buffer);
+  }
+
+  // Failing to import is ok as the caller will just do the full
+  // allocate + read.
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    release_callback.fn(release_callback.user_data, NULL);
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_io_parameter_index_provider_load(
     iree_io_parameter_provider_t* base_provider, iree_hal_device_t* device,
     iree_hal_queue_affinity_t queue_affinity,
@@ -697,6 +966,11 @@ static iree_status_t iree_io_parameter_index_provider_load(
                                    wait_semaphore_list, signal_semaphore_list,
                                    &batch);
 
+  // Devices whose memory is host memory can import file mappings directly.
+  iree_device_size_t min_alignment = 1;
+  const bool host_coherent = iree_io_parameter_index_provider_is_host_coherent(
+      iree_hal_device_allocator(device), &min_alignment);
+
   // Process each entry by enqueuing the appropriate operation.
   iree_status_t status = iree_ok_status();
   for (iree_host_size_t i = 0; i < count; ++i) {
@@ -725,52 +999,14 @@ static iree_status_t iree_io_parameter_index_provider_load(
     // extremely expensive driver handling. Startup paths with parameters aren't
     // usually critical, though, so it's (probably) fine today as-is.
 
-    // Try first to reuse the file backing store directly as a buffer. This only
-    // works with specific file types and with specific target usage. The most
-    // common cases for this are when using parameters as staging sources (so
-    // host memory is ok) or on unified memory systems (where host memory is
-    // device memory) and the file was originally mapped. We could extend the
-    // conditions in which we use this with some better file handle helpers that
-    // allow us to map files that we already have open via other mechanisms
-    // (FILE, fd, etc).
+    // Try first to reuse the file backing store directly as a buffer.
     iree_hal_buffer_t* target_buffer = NULL;
-    if (iree_status_is_ok(status) &&
-        source_entry->type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE &&
-        iree_io_file_handle_type(source_entry->storage.file.handle) ==
-            IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-      iree_byte_span_t host_allocation =
-          iree_io_file_handle_primitive(source_entry->storage.file.handle)
-              .value.host_allocation;
-      iree_hal_external_buffer_t external_buffer = {
-          .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
-          .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
-          .size = host_allocation.data_length,
-          .handle =
-              {
-                  .host_allocation =
-                      {
-                          .ptr = host_allocation.data +
-                                 source_entry->storage.file.offset,
-                      },
-              },
-      };
-      iree_hal_buffer_release_callback_t release_callback = {
-          .fn = iree_io_file_handle_buffer_release,
-          .user_data = source_entry->storage.file.handle,
-      };
-      iree_io_file_handle_retain(source_entry->storage.file.handle);
-      iree_status_t import_status = iree_hal_allocator_import_buffer(
-          iree_hal_device_allocator(device), target_params, &external_buffer,
-          release_callback, &target_buffer);
-      if (iree_status_is_ok(import_status)) {
-        // Import succeeded - issue a barrier to preserve the async timeline.
+    if (iree_status_is_ok(status)) {
+      status = iree_io_parameter_index_provider_try_import(
+          provider, device, host_coherent, min_alignment, target_params,
+          source_entry, &span, &target_buffer);
+      if (target_buffer) {
         IREE_TRACE_ZONE_APPEND_TEXT(z_entry, "import succeeded");
-      } else {
-        // Failed to import - that's ok as we'll just do the full allocate +
-        // read.
-        IREE_TRACE_ZONE_APPEND_TEXT(z_entry, "import failed");
-        import_status = iree_status_ignore(import_status);
-        iree_io_file_handle_release(source_entry->storage.file.handle);
       }
     }
 
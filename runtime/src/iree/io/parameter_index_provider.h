@@ -21,6 +21,48 @@ extern "C" {
 // Reasonable default for the `max_concurrent_operations` parameter.
 #define IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS 16
 
+// Bitfield controlling parameter index provider behavior.
+typedef uint32_t iree_io_parameter_index_provider_flags_t;
+enum iree_io_parameter_index_provider_flag_bits_t {
+  IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_NONE = 0u,
+  // Loads of parameters stored in platform files on devices whose memory is
+  // host memory (local-sync/local-task/etc) import a memory mapping of the file
+  // directly instead of allocating and reading into a new buffer. Files are
+  // mapped copy-on-write so pages are shared with the page cache (and other
+  // processes loading the same file) until written. Pages are faulted in as
+  // the imported parameters are accessed. Disabled by default.
+  IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_MAP_FILES = 1u << 0,
+  // Requests large pages for mapped files where supported. Reduces TLB
+  // pressure when accessing large parameters.
+  IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_LARGE_PAGES = 1u << 1,
+};
+
+// Options controlling parameter index provider behavior.
+typedef struct iree_io_parameter_index_provider_options_t {
+  // Flags controlling provider behavior.
+  iree_io_parameter_index_provider_flags_t flags;
+  // Limits how many file operations as part of a gather or scatter are allowed
+  // to be in-flight at a time. A lower number can reduce system resource
+  // requirements during the operation (less transient memory required, etc)
+  // while increasing latency (lower I/O utilization).
+  iree_host_size_t max_concurrent_operations;
+} iree_io_parameter_index_provider_options_t;
+
+// Initializes |out_options| to their default values.
+IREE_API_EXPORT void iree_io_parameter_index_provider_options_initialize(
+    iree_io_parameter_index_provider_options_t* out_options);
+
+// Creates a parameter provider serving from the provided |index| with the
+// given |options|.
+// As parameters are operated on their files will be registered with the devices
+// they are used on and cached for future requests.
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_provider_create_with_options(
+    iree_string_view_t scope, iree_io_parameter_index_t* index,
+    const iree_io_parameter_index_provider_options_t* options,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider);
+
 // Creates a parameter provider serving from the provided |index|.
 // As parameters are operated on their files will be registered with the devices
 // they are used on and cached for future requests.
@@ -30,6 +72,9 @@ extern "C" {
 // number can reduce system resource requirements during the operation (less
 // transient memory required, etc) while increasing latency (lower I/O
 // utilization).
+//
+// Equivalent to iree_io_parameter_index_provider_create_with_options with the
+// default options.
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
     iree_string_view_t scope, iree_io_parameter_index_t* index,
     iree_host_size_t max_concurrent_operations, iree_allocator_t host_allocator,
@@ -0,0 +1,235 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_index_provider.h"
+
+#include "iree/base/api.h"
+
+#if IREE_FILE_IO_ENABLE
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_sync/sync_device.h"
+#include "iree/io/file_contents.h"
+#include "iree/io/parameter_index.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+static std::string GetUniquePath(const char* unique_name) {
+  const char* test_tmpdir = getenv("TEST_TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TEMP");
+  if (!test_tmpdir) test_tmpdir = "/tmp";
+  std::random_device d;
+  uint64_t random = (static_cast<uint64_t>(d()) << 32) | d();
+  char unique_path[256];
+  snprintf(unique_path, sizeof unique_path, "%s/iree_test_%" PRIx64 "_%s",
+           test_tmpdir, random, unique_name);
+  return unique_path;
+}
+
+// Allocator forwarding to the system allocator that counts allocations and
+// fails all reallocations to |failing_realloc_size| bytes (if not zero).
+struct TestAllocator {
+  int allocation_count = 0;
+  iree_host_size_t failing_realloc_size = 0;
+  int failed_realloc_count = 0;
+
+  static iree_status_t Ctl(void* self, iree_allocator_command_t command,
+                           const void* params, void** inout_ptr) {
+    TestAllocator* allocator = (TestAllocator*)self;
+    if (command != IREE_ALLOCATOR_COMMAND_FREE) {
+      if (command == IREE_ALLOCATOR_COMMAND_REALLOC &&
+          allocator->failing_realloc_size != 0 &&
+          ((const iree_allocator_alloc_params_t*)params)->byte_length ==
+              allocator->failing_realloc_size) {
+        ++allocator->failed_realloc_count;
+        return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                                "reallocation disabled");
+      }
+      ++allocator->allocation_count;
+    }
+    iree_allocator_t system = iree_allocator_system();
+    return system.ctl(system.self, command, params, inout_ptr);
+  }
+
+  iree_allocator_t allocator() { return {this, Ctl}; }
+};
+
+class ParameterIndexProviderTest : public ::testing::Test {
+ protected:
+  // Two parameters at page-aligned offsets in the same file.
+  static constexpr iree_host_size_t kParameterLength = 4096;
+  static constexpr iree_host_size_t kParameterCount = 2;
+
+  void SetUp() override {
+    path_ = GetUniquePath("parameters.bin");
+    contents_.resize(kParameterLength * kParameterCount);
+    for (iree_host_size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = (uint8_t)(i * 7 + i / kParameterLength);
+    }
+    IREE_ASSERT_OK(iree_io_file_contents_write(
+        iree_make_string_view(path_.data(), path_.size()),
+        iree_make_const_byte_span(contents_.data(), contents_.size()),
+        iree_allocator_system()));
+
+    IREE_ASSERT_OK(iree_io_parameter_index_create(iree_allocator_system(),
+                                                  &index_));
+    iree_io_file_handle_t* file_handle = NULL;
+    IREE_ASSERT_OK(iree_io_file_handle_open(
+        IREE_IO_FILE_MODE_READ | IREE_IO_FILE_MODE_RANDOM_ACCESS,
+        iree_make_string_view(path_.data(), path_.size()),
+        iree_allocator_system(), &file_handle));
+    for (iree_host_size_t i = 0; i < kParameterCount; ++i) {
+      keys_.push_back("param" + std::to_string(i));
+    }
+    for (iree_host_size_t i = 0; i < kParameterCount; ++i) {
+      iree_io_parameter_index_entry_t entry = {};
+      entry.key = iree_make_string_view(keys_[i].data(), keys_[i].size());
+      entry.length = kParameterLength;
+      entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE;
+      entry.storage.file.handle = file_handle;
+      entry.storage.file.offset = i * kParameterLength;
+      IREE_ASSERT_OK(iree_io_parameter_index_add(index_, &entry));
+    }
+    iree_io_file_handle_release(file_handle);
+
+    // Buffer contents are allocated from |data_allocator_| so that loads that
+    // import the file mapping can be told apart from those that read into new
+    // allocations.
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), data_allocator_.allocator(), iree_allocator_system(),
+        &device_allocator_));
+    iree_hal_sync_device_params_t device_params;
+    iree_hal_sync_device_params_initialize(&device_params);
+    IREE_ASSERT_OK(iree_hal_sync_device_create(
+        IREE_SV("sync"), &device_params, /*loader_count=*/0,
+        /*loaders=*/NULL, device_allocator_, iree_allocator_system(),
+        &device_));
+  }
+
+  void TearDown() override {
+    iree_hal_device_release(device_);
+    iree_hal_allocator_release(device_allocator_);
+    iree_io_parameter_index_release(index_);
+    remove(path_.c_str());
+  }
+
+  // Loads all parameters with a provider created with |flags| and verifies
+  // their contents.
+  void LoadAndVerify(iree_io_parameter_index_provider_flags_t flags,
+                     iree_allocator_t host_allocator) {
+    iree_io_parameter_index_provider_options_t options;
+    iree_io_parameter_index_provider_options_initialize(&options);
+    options.flags = flags;
+    iree_io_parameter_provider_t* provider = NULL;
+    IREE_ASSERT_OK(iree_io_parameter_index_provider_create_with_options(
+        IREE_SV("scope"), index_, &options, host_allocator, &provider));
+
+    iree_hal_semaphore_t* semaphore = NULL;
+    IREE_ASSERT_OK(iree_hal_semaphore_create(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, 0ull,
+        IREE_HAL_SEMAPHORE_FLAG_DEFAULT, &semaphore));
+    uint64_t signal_value = 1ull;
+    iree_hal_semaphore_list_t signal_list = {1, &semaphore, &signal_value};
+
+    iree_hal_buffer_params_t target_params = {};
+    target_params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    target_params.usage =
+        IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING;
+    target_params.access = IREE_HAL_MEMORY_ACCESS_ALL;
+    iree_hal_buffer_t* buffers[kParameterCount] = {NULL};
+    IREE_ASSERT_OK(iree_io_parameter_provider_load(
+        provider, device_, IREE_HAL_QUEUE_AFFINITY_ANY,
+        iree_hal_semaphore_list_empty(), signal_list, IREE_SV("scope"),
+        target_params, kParameterCount, {Enumerate, this}, {Emit, buffers}));
+    IREE_ASSERT_OK(iree_hal_semaphore_wait(semaphore, signal_value,
+                                           iree_infinite_timeout(),
+                                           IREE_HAL_WAIT_FLAG_DEFAULT));
+
+    for (iree_host_size_t i = 0; i < kParameterCount; ++i) {
+      ASSERT_NE(buffers[i], nullptr);
+      std::vector<uint8_t> actual(kParameterLength);
+      IREE_ASSERT_OK(iree_hal_buffer_map_read(buffers[i], 0, actual.data(),
+                                              actual.size()));
+      EXPECT_TRUE(std::equal(actual.begin(), actual.end(),
+                             contents_.begin() + i * kParameterLength));
+      iree_hal_buffer_release(buffers[i]);
+    }
+    iree_hal_semaphore_release(semaphore);
+    iree_io_parameter_provider_release(provider);
+  }
+
+  static iree_status_t Enumerate(void* user_data, iree_host_size_t i,
+                                 iree_string_view_t* out_key,
+                                 iree_io_parameter_span_t* out_span) {
+    auto* test = (ParameterIndexProviderTest*)user_data;
+    *out_key = iree_make_string_view(test->keys_[i].data(),
+                                     test->keys_[i].size());
+    out_span->parameter_offset = 0;
+    out_span->buffer_offset = 0;
+    out_span->length = kParameterLength;
+    return iree_ok_status();
+  }
+
+  static iree_status_t Emit(void* user_data, iree_host_size_t i,
+                            iree_hal_buffer_t* buffer) {
+    iree_hal_buffer_t** buffers = (iree_hal_buffer_t**)user_data;
+    iree_hal_buffer_retain(buffer);
+    buffers[i] = buffer;
+    return iree_ok_status();
+  }
+
+  std::string path_;
+  std::vector<uint8_t> contents_;
+  std::vector<std::string> keys_;
+  iree_io_parameter_index_t* index_ = NULL;
+  TestAllocator data_allocator_;
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+};
+
+// Without FLAG_MAP_FILES (the default) parameters are read into buffers
+// allocated from the device.
+TEST_F(ParameterIndexProviderTest, LoadUnmapped) {
+  LoadAndVerify(IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_NONE,
+                iree_allocator_system());
+  EXPECT_GT(data_allocator_.allocation_count, 0);
+}
+
+// With FLAG_MAP_FILES on a host-coherent device parameters are imported from
+// the file mapping without allocating buffer storage.
+TEST_F(ParameterIndexProviderTest, LoadMapped) {
+  LoadAndVerify(IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_MAP_FILES,
+                iree_allocator_system());
+  EXPECT_EQ(data_allocator_.allocation_count, 0);
+}
+
+// Failing to grow the mapping cache falls back to reading the parameters. The
+// cache starts with 4 entries of a file handle and mapping pointer each. No
+// other array grown while loading has that size (the device file cache starts
+// with 16 pointers).
+TEST_F(ParameterIndexProviderTest, LoadMappedCacheGrowFailure) {
+  TestAllocator host_allocator;
+  host_allocator.failing_realloc_size = 4 * 2 * sizeof(void*);
+  LoadAndVerify(IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_MAP_FILES,
+                host_allocator.allocator());
+  EXPECT_GT(host_allocator.failed_realloc_count, 0);
+  EXPECT_GT(data_allocator_.allocation_count, 0);
+}
+
+}  // namespace
+
+#endif  // IREE_FILE_IO_ENABLE
@@ -0,0 +1,160 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_index.h"
+
+#include <string>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+static std::string MakeKey(iree_host_size_t i) {
+  return "model.layers." + std::to_string(i) + ".weight";
+}
+
+static iree_status_t AddSplatEntry(iree_io_parameter_index_t* index,
+                                   const std::string& key, uint8_t value) {
+  iree_io_parameter_index_entry_t entry = {};
+  entry.key = iree_make_string_view(key.data(), key.size());
+  entry.length = 4;
+  entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT;
+  entry.storage.splat.pattern_length = 1;
+  entry.storage.splat.pattern[0] = value;
+  return iree_io_parameter_index_add(index, &entry);
+}
+
+static void ExpectLookup(iree_io_parameter_index_t* index,
+                         const std::string& key, uint8_t value) {
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  IREE_ASSERT_OK(iree_io_parameter_index_lookup(
+      index, iree_make_string_view(key.data(), key.size()), &entry));
+  ASSERT_NE(entry, nullptr);
+  EXPECT_TRUE(iree_string_view_equal(
+      entry->key, iree_make_string_view(key.data(), key.size())));
+  EXPECT_EQ(entry->storage.splat.pattern[0], value);
+}
+
+// Allocator forwarding to the system allocator that fails once |budget|
+// allocations have been made. A negative budget never fails.
+struct FailingAllocator {
+  int budget = -1;
+
+  static iree_status_t Ctl(void* self, iree_allocator_command_t command,
+                           const void* params, void** inout_ptr) {
+    FailingAllocator* allocator = (FailingAllocator*)self;
+    if (command != IREE_ALLOCATOR_COMMAND_FREE && allocator->budget >= 0) {
+      if (allocator->budget == 0) {
+        return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                                "allocation budget exhausted");
+      }
+      --allocator->budget;
+    }
+    iree_allocator_t system = iree_allocator_system();
+    return system.ctl(system.self, command, params, inout_ptr);
+  }
+
+  iree_allocator_t allocator() { return {this, Ctl}; }
+};
+
+TEST(ParameterIndexTest, LookupEmpty) {
+  iree_io_parameter_index_t* index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &index));
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  EXPECT_THAT(iree::Status(iree_io_parameter_index_lookup(
+                  index, IREE_SV("missing"), &entry)),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(entry, nullptr);
+  iree_io_parameter_index_release(index);
+}
+
+// Adds enough entries to grow (and rehash) the table several times and checks
+// that every entry remains reachable.
+TEST(ParameterIndexTest, LookupManyEntries) {
+  iree_io_parameter_index_t* index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &index));
+  static const iree_host_size_t kEntryCount = 10000;
+  for (iree_host_size_t i = 0; i < kEntryCount; ++i) {
+    IREE_ASSERT_OK(AddSplatEntry(index, MakeKey(i), (uint8_t)i));
+  }
+  EXPECT_EQ(iree_io_parameter_index_count(index), kEntryCount);
+  for (iree_host_size_t i = 0; i < kEntryCount; ++i) {
+    ExpectLookup(index, MakeKey(i), (uint8_t)i);
+  }
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  EXPECT_THAT(iree::Status(iree_io_parameter_index_lookup(
+                  index, IREE_SV("model.layers.10000.weight"), &entry)),
+              StatusIs(StatusCode::kNotFound));
+  iree_io_parameter_index_release(index);
+}
+
+TEST(ParameterIndexTest, DuplicateKeysResolveToFirst) {
+  iree_io_parameter_index_t* index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &index));
+  for (int i = 0; i < 100; ++i) {
+    IREE_ASSERT_OK(AddSplatEntry(index, MakeKey(i), 1));
+  }
+  IREE_ASSERT_OK(AddSplatEntry(index, MakeKey(42), 2));
+  // Grow past the duplicate to ensure rehashing keeps the first entry.
+  for (int i = 100; i < 1000; ++i) {
+    IREE_ASSERT_OK(AddSplatEntry(index, MakeKey(i), 1));
+  }
+  EXPECT_EQ(iree_io_parameter_index_count(index), 1001u);
+  ExpectLookup(index, MakeKey(42), 1);
+  iree_io_parameter_index_release(index);
+}
+
+// Fails each allocation made while growing the index in turn and checks that
+// the index remains usable (and lookups terminate) once allocations succeed
+// again.
+TEST(ParameterIndexTest, GrowFailure) {
+  for (int budget = 0; budget < 3; ++budget) {
+    FailingAllocator failing_allocator;
+    iree_io_parameter_index_t* index = NULL;
+    IREE_ASSERT_OK(
+        iree_io_parameter_index_create(failing_allocator.allocator(), &index));
+    // Fill the initial capacity so that the next add has to grow.
+    static const int kInitialCount = 16;
+    for (int i = 0; i < kInitialCount; ++i) {
+      IREE_ASSERT_OK(AddSplatEntry(index, MakeKey(i), (uint8_t)i));
+    }
+
+    failing_allocator.budget = budget;
+    EXPECT_THAT(iree::Status(AddSplatEntry(index, MakeKey(kInitialCount),
+                                           (uint8_t)kInitialCount)),
+                StatusIs(StatusCode::kResourceExhausted));
+    failing_allocator.budget = -1;
+
+    // Fill the index up to the capacity reserved before the failure: the hash
+    // table must still have empty buckets for misses to terminate.
+    for (int i = kInitialCount; i < kInitialCount * 2; ++i) {
+      IREE_ASSERT_OK(AddSplatEntry(index, MakeKey(i), (uint8_t)i));
+    }
+    const iree_io_parameter_index_entry_t* entry = NULL;
+    EXPECT_THAT(iree::Status(iree_io_parameter_index_lookup(
+                    index, IREE_SV("missing"), &entry)),
+                StatusIs(StatusCode::kNotFound));
+
+    // Keep growing after the failure.
+    for (int i = kInitialCount * 2; i < kInitialCount * 8; ++i) {
+      IREE_ASSERT_OK(AddSplatEntry(index, MakeKey(i), (uint8_t)i));
+    }
+    for (int i = 0; i < kInitialCount * 8; ++i) {
+      ExpectLookup(index, MakeKey(i), (uint8_t)i);
+    }
+    iree_io_parameter_index_release(index);
+  }
+}
+
+}  // namespace
@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/memory.h"
 #include "iree/task/topology.h"
 
 //===----------------------------------------------------------------------===//
@@ -24,6 +25,20 @@ IREE_FLAG(
     "when latency is the #1 priority (vs. thermals, system-wide scheduling,\n"
     "etc).");
 
+IREE_FLAG(
+    string, task_worker_idle_mode, "fixed",
+    "Specifies how workers wait for more work once they have run out:\n"
+    "  'fixed': spin for --task_worker_spin_us= and yield\n"
+    "           --task_worker_yield_count= times before sleeping.\n"
+    "  'adaptive': as 'fixed' but only spin when the average interval between\n"
+    "              recent submissions is shorter than --task_worker_spin_us=\n"
+    "              (or a default bound if 0).");
+
+IREE_FLAG(
+    int32_t, task_worker_yield_count, 0,
+    "Number of times each worker yields its timeslice and rechecks for work\n"
+    "after spinning and before sleeping.");
+
 IREE_FLAG(
     int32_t, task_worker_stack_size, 128 * 1024,
     "Minimum size in bytes of each worker thread stack.\n"
@@ -44,12 +59,46 @@ IREE_FLAG(
     "be configured to make at least that amount of local memory available.\n"
     "By default the CPU L2 cache size is used if such queries are supported.");
 
+IREE_FLAG(
+    string, task_dispatch_reservation_mode, "fixed",
+    "Specifies how dispatch shards reserve tiles from the dispatch grid:\n"
+    "  'fixed': reserve a fixed number of tiles at a time.\n"
+    "  'guided': reserve a shrinking fraction of the remaining tiles.\n"
+    "  'adaptive': as 'guided' but bounded by the measured tile latency.");
+
 iree_status_t iree_task_executor_options_initialize_from_flags(
     iree_task_executor_options_t* out_options) {
   IREE_ASSERT_ARGUMENT(out_options);
   iree_task_executor_options_initialize(out_options);
+  if (strcmp(FLAG_task_dispatch_reservation_mode, "fixed") == 0) {
+    out_options->dispatch_reservation_mode =
+        IREE_TASK_DISPATCH_RESERVATION_MODE_FIXED;
+  } else if (strcmp(FLAG_task_dispatch_reservation_mode, "guided") == 0) {
+    out_options->dispatch_reservation_mode =
+        IREE_TASK_DISPATCH_RESERVATION_MODE_GUIDED;
+  } else if (strcmp(FLAG_task_dispatch_reservation_mode, "adaptive") == 0) {
+    out_options->dispatch_reservation_mode =
+        IREE_TASK_DISPATCH_RESERVATION_MODE_ADAPTIVE;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown --task_dispatch_reservation_mode= '%s'; "
+                            "expected 'fixed', 'guided', or 'adaptive'",
+                            FLAG_task_dispatch_reservation_mode);
+  }
+  if (strcmp(FLAG_task_worker_idle_mode, "fixed") == 0) {
+    out_options->worker_idle_mode = IREE_TASK_WORKER_IDLE_MODE_FIXED;
+  } else if (strcmp(FLAG_task_worker_idle_mode, "adaptive") == 0) {
+    out_options->worker_idle_mode = IREE_TASK_WORKER_IDLE_MODE_ADAPTIVE;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown --task_worker_idle_mode= '%s'; "
+                            "expected 'fixed' or 'adaptive'",
+                            FLAG_task_worker_idle_mode);
+  }
   out_options->worker_spin_ns =
       (iree_duration_t)FLAG_task_worker_spin_us * 1000;
+  out_options->worker_yield_count =
+      (uint32_t)iree_max(0, FLAG_task_worker_yield_count);
   out_options->worker_stack_size =
       (iree_host_size_t)FLAG_task_worker_stack_size;
   out_options->worker_local_memory_size =
@@ -72,7 +121,12 @@ IREE_FLAG(
     " 'physical_cores':\n"
     "   Creates one executor per NUMA node in --task_topology_nodes= and one\n"
     "   group per physical core in each NUMA node up to the value specified\n"
-    "   by --task_topology_max_group_count=.");
+    "   by --task_topology_max_group_count=.\n"
+    " 'numa':\n"
+    "   Creates one executor per NUMA memory node in --task_topology_nodes=\n"
+    "   (default all) with workers pinned to the physical cores attached to\n"
+    "   that node. Queue affinities select the executor and buffers are\n"
+    "   placed on its node. Use on multi-socket systems.");
 
 IREE_FLAG(
     int32_t, task_topology_group_count, 0,
@@ -91,11 +145,12 @@ IREE_FLAG_LIST(
     "[0, total_processor_count) range on Windows.");
 
 IREE_FLAG(
-    string, task_topology_nodes, "current",
+    string, task_topology_nodes, "",
     "Comma-separated list of NUMA nodes that topologies will be defined for.\n"
     "Each node specified will be configured based on the other topology\n"
     "flags. 'all' can be used to indicate all available NUMA nodes and\n"
-    "'current' will inherit the node of the calling thread.");
+    "'current' will inherit the node of the calling thread. Defaults to\n"
+    "'all' with --task_topology_mode=numa and 'current' otherwise.");
 
 IREE_FLAG(
     int32_t, task_topology_max_group_count, 64,
@@ -135,45 +190,31 @@ static iree_status_t iree_task_topologies_select_nodes_from_flags(
   IREE_ASSERT_ARGUMENT(out_node_mask);
   *out_node_mask = 0ull;
 
-  // Query the total number of NUMA nodes in the system. On implementations
-  // where this information isn't available this will return 1.
-  const iree_host_size_t available_node_count =
-      iree_max(1u, iree_min(64u, iree_task_topology_query_node_count()));
+  // Query the NUMA nodes available in the system. On implementations where
+  // this information isn't available only node 0 is available. In numa mode
+  // the nodes are the online memory nodes, which may be sparse, instead of the
+  // cluster/package IDs used by the other topology modes.
+  const bool memory_nodes = strcmp(FLAG_task_topology_mode, "numa") == 0;
+  uint64_t available_node_mask = 0ull;
+  iree_task_topology_node_id_t current_node_id = 0;
+  if (memory_nodes) {
+    available_node_mask = iree_memory_query_node_mask();
+    current_node_id = iree_memory_query_current_node();
+  } else {
+    const iree_host_size_t available_node_count =
+        iree_max(1u, iree_min(64u, iree_task_topology_query_node_count()));
+    available_node_mask = UINT64_MAX >> (64 - available_node_count);
+    current_node_id = iree_task_topology_query_current_node();
+  }
 
   // Build a bitmask based on the flags.
   iree_string_view_t nodes_flag =
       iree_make_cstring_view(FLAG_task_topology_nodes);
-  uint64_t node_mask = 0ull;
-  if (iree_string_view_is_empty(nodes_flag) ||
-      iree_string_view_equal(nodes_flag, IREE_SV("current"))) {
-    // Use a single default node.
-    node_mask = 1ull << iree_task_topology_query_current_node();
-  } else if (iree_string_view_equal(nodes_flag, IREE_SV("all"))) {
-    // Use all nodes in the system (set bits starting at 0 for each node).
-    node_mask = UINT64_MAX >> (64 - available_node_count);
-  } else {
-    // Use some subset of nodes.
-    iree_string_view_t remaining = nodes_flag;
-    while (!iree_string_view_is_empty(remaining)) {
-      iree_string_view_t node_value;
-      iree_string_view_split(remaining, ',', &node_value, &remaining);
-      uint32_t node_id = 0;
-      if (!iree_string_view_atoi_uint32(node_value, &node_id)) {
-        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                                "invalid NUMA node ID specified: '%.*s'",
-                                (int)node_value.size, node_value.data);
-      } else if (node_id >= available_node_count) {
-        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                                "NUMA node ID out of valid range [0,%" PRIhsz
-                                "): %u",
-                                available_node_count, node_id);
-      }
-      node_mask |= 1ull << node_id;
-    }
+  if (iree_string_view_is_empty(nodes_flag)) {
+    nodes_flag = memory_nodes ? IREE_SV("all") : IREE_SV("current");
   }
-
-  *out_node_mask = node_mask;
-  return iree_ok_status();
+  return iree_task_topology_select_nodes(nodes_flag, available_node_mask,
+                                         current_node_id, out_node_mask);
 }
 
 static iree_status_t iree_task_topology_parse_performance_level(
@@ -273,6 +314,22 @@ iree_status_t iree_task_topology_initialize_from_flags(
     return iree_task_topology_initialize_from_physical_cores(
         node_id, performance_level, distribution,
         FLAG_task_topology_max_group_count, out_topology);
+  } else if (strcmp(FLAG_task_topology_mode, "numa") == 0) {
+    // Physical cores attached to a specific NUMA memory node.
+    iree_task_topology_performance_level_t performance_level =
+        IREE_TASK_TOPOLOGY_PERFORMANCE_LEVEL_ANY;
+    iree_task_topology_distribution_t distribution =
+        IREE_TASK_TOPOLOGY_DISTRIBUTION_SCATTER;
+    if (!iree_task_topology_parse_favor_preset(
+            FLAG_task_topology_favor, &performance_level, &distribution)) {
+      IREE_RETURN_IF_ERROR(iree_task_topology_parse_performance_level(
+          FLAG_task_topology_performance_level, &performance_level));
+      IREE_RETURN_IF_ERROR(iree_task_topology_parse_distribution(
+          FLAG_task_topology_distribution, &distribution));
+    }
+    return iree_task_topology_initialize_from_memory_node(
+        node_id, performance_level, distribution,
+        FLAG_task_topology_max_group_count, out_topology);
   } else {
     return iree_make_status(
         IREE_STATUS_INVALID_ARGUMENT,
@@ -26,7 +26,8 @@ iree_status_t iree_task_executor_options_initialize_from_flags(
 
 // Initializes |out_topology| from the command line flags.
 // Depending on the mode flags |node_id| will be used to pin the topology to a
-// specific NUMA node.
+// specific NUMA node. With --task_topology_mode=numa |node_id| is a NUMA memory
+// node as used by iree/base/internal/memory.h instead of a cluster ID.
 iree_status_t iree_task_topology_initialize_from_flags(
     iree_task_topology_node_id_t node_id, iree_task_topology_t* out_topology);
 
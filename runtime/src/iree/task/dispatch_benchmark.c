@@ -0,0 +1,163 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/task/executor.h"
+#include "iree/task/scope.h"
+#include "iree/task/submission.h"
+#include "iree/task/task.h"
+#include "iree/task/topology.h"
+#include "iree/testing/benchmark.h"
+
+// Number of worker threads in the executor running the dispatches.
+#define IREE_TASK_DISPATCH_BENCHMARK_WORKER_COUNT 8
+
+// Shapes of per-tile cost used by the benchmarks.
+typedef enum iree_task_dispatch_benchmark_workload_e {
+  // Tiles that do almost no work so that the cost of reserving tiles dominates.
+  IREE_TASK_DISPATCH_BENCHMARK_WORKLOAD_TINY = 0,
+  // Tiles that all do the same moderate amount of work.
+  IREE_TASK_DISPATCH_BENCHMARK_WORKLOAD_UNIFORM = 1,
+  // Tiles that get more expensive towards the end of the grid such that
+  // whichever shard reserves the last batch of tiles determines the latency.
+  IREE_TASK_DISPATCH_BENCHMARK_WORKLOAD_SKEWED = 2,
+} iree_task_dispatch_benchmark_workload_t;
+
+typedef struct iree_task_dispatch_benchmark_params_t {
+  iree_task_dispatch_reservation_mode_t reservation_mode;
+  iree_task_dispatch_benchmark_workload_t workload;
+  uint32_t tile_count;
+} iree_task_dispatch_benchmark_params_t;
+
+// Spins for roughly |iteration_count| dependent multiply-adds.
+static uint32_t iree_task_dispatch_benchmark_spin(uint32_t seed,
+                                                  uint32_t iteration_count) {
+  volatile uint32_t value = seed;
+  for (uint32_t i = 0; i < iteration_count; ++i) {
+    value = value * 1664525u + 1013904223u;
+  }
+  return value;
+}
+
+static iree_status_t iree_task_dispatch_benchmark_tile(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const iree_task_dispatch_benchmark_params_t* params =
+      (const iree_task_dispatch_benchmark_params_t*)user_context;
+  const uint32_t x = tile_context->workgroup_xyz[0];
+  switch (params->workload) {
+    default:
+    case IREE_TASK_DISPATCH_BENCHMARK_WORKLOAD_TINY:
+      break;
+    case IREE_TASK_DISPATCH_BENCHMARK_WORKLOAD_UNIFORM:
+      iree_task_dispatch_benchmark_spin(x, 2000);
+      break;
+    case IREE_TASK_DISPATCH_BENCHMARK_WORKLOAD_SKEWED:
+      // The last 1/16th of the tiles are 32x more expensive than the rest.
+      iree_task_dispatch_benchmark_spin(
+          x, x >= params->tile_count - params->tile_count / 16 ? 32000 : 1000);
+      break;
+  }
+  return iree_ok_status();
+}
+
+// Issues a 1D dispatch over the configured tile count and waits for it to
+// complete. Each iteration measures the latency of a single dispatch from
+// submission until the last tile has finished, so the skewed variants show how
+// well each reservation mode avoids a long tail on a single worker.
+//
+// user_data points at a static iree_task_dispatch_benchmark_params_t.
+static iree_status_t iree_task_dispatch_benchmark_run(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_task_dispatch_benchmark_params_t* params =
+      (const iree_task_dispatch_benchmark_params_t*)benchmark_def->user_data;
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.dispatch_reservation_mode = params->reservation_mode;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(
+      IREE_TASK_DISPATCH_BENCHMARK_WORKER_COUNT, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_CHECK_OK(iree_task_executor_create(options, &topology, host_allocator,
+                                          &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("benchmark"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {params->tile_count, 1, 1};
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_task_dispatch_t dispatch_task;
+    iree_task_dispatch_initialize(
+        &scope,
+        iree_task_make_dispatch_closure(iree_task_dispatch_benchmark_tile,
+                                        (void*)params),
+        workgroup_size, workgroup_count, &dispatch_task);
+    iree_task_fence_t* fence = NULL;
+    IREE_CHECK_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&dispatch_task.header, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch_task.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_CHECK_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_task_dispatch_benchmark_run
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_MICROSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_task_dispatch_benchmark_run,
+    };
+    static const char* mode_names[] = {"fixed", "guided", "adaptive"};
+    static const char* workload_names[] = {"tiny", "uniform", "skewed"};
+    static const uint32_t tile_counts[] = {256, 4096, 65536};
+    static iree_task_dispatch_benchmark_params_t
+        params[IREE_ARRAYSIZE(workload_names)][IREE_ARRAYSIZE(tile_counts)]
+              [IREE_ARRAYSIZE(mode_names)];
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(workload_names); ++i) {
+      for (iree_host_size_t j = 0; j < IREE_ARRAYSIZE(tile_counts); ++j) {
+        for (iree_host_size_t k = 0; k < IREE_ARRAYSIZE(mode_names); ++k) {
+          params[i][j][k].reservation_mode =
+              (iree_task_dispatch_reservation_mode_t)k;
+          params[i][j][k].workload = (iree_task_dispatch_benchmark_workload_t)i;
+          params[i][j][k].tile_count = tile_counts[j];
+          char name[64];
+          snprintf(name, sizeof(name), "%s_%u_%s", workload_names[i],
+                   tile_counts[j], mode_names[k]);
+          benchmark_def.user_data = &params[i][j][k];
+          iree_benchmark_register(iree_make_cstring_view(name),
+                                  &benchmark_def);
+        }
+      }
+    }
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
@@ -96,7 +96,10 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   iree_atomic_ref_count_init(&executor->ref_count);
   executor->allocator = allocator;
   executor->scheduling_mode = options.scheduling_mode;
+  executor->dispatch_reservation_mode = options.dispatch_reservation_mode;
   executor->worker_spin_ns = options.worker_spin_ns;
+  executor->worker_idle_mode = options.worker_idle_mode;
+  executor->worker_yield_count = options.worker_yield_count;
   iree_atomic_task_slist_initialize(&executor->incoming_ready_slist);
   iree_slim_mutex_initialize(&executor->coordinator_mutex);
 
@@ -274,6 +277,22 @@ iree_host_size_t iree_task_executor_worker_count(
   return executor->worker_count;
 }
 
+uint32_t iree_task_executor_query_memory_node(iree_task_executor_t* executor) {
+  uint32_t node_id = IREE_MEMORY_NODE_ID_ANY;
+  for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
+    iree_thread_affinity_t affinity =
+        executor->workers[i].ideal_thread_affinity;
+    if (!affinity.id_assigned) return IREE_MEMORY_NODE_ID_ANY;
+    uint32_t worker_node_id = iree_memory_query_processor_node(affinity.id);
+    if (worker_node_id == IREE_MEMORY_NODE_ID_ANY ||
+        (i > 0 && worker_node_id != node_id)) {
+      return IREE_MEMORY_NODE_ID_ANY;
+    }
+    node_id = worker_node_id;
+  }
+  return node_id;
+}
+
 iree_event_pool_t* iree_task_executor_event_pool(
     iree_task_executor_t* executor) {
   return executor->event_pool;
@@ -410,10 +429,53 @@ void iree_task_executor_merge_submission(iree_task_executor_t* executor,
   iree_task_submission_reset(submission);
 }
 
+// Updates the moving average of the intervals between submissions used to pick
+// the adaptive worker spin duration.
+static void iree_task_executor_record_submit_time(
+    iree_task_executor_t* executor) {
+  const int64_t now_ns = (int64_t)iree_time_now();
+  const int64_t last_ns = iree_atomic_exchange(
+      &executor->last_submit_time_ns, now_ns, iree_memory_order_relaxed);
+  if (last_ns == 0 || now_ns <= last_ns) return;
+  const int64_t interval_ns = now_ns - last_ns;
+  int64_t average_ns = iree_atomic_load(&executor->submit_interval_ns,
+                                        iree_memory_order_relaxed);
+  if (average_ns == 0) {
+    average_ns = interval_ns;
+  } else {
+    average_ns += (interval_ns - average_ns) >>
+                  IREE_TASK_WORKER_ADAPTIVE_INTERVAL_SMOOTHING_SHIFT;
+  }
+  iree_atomic_store(&executor->submit_interval_ns, average_ns,
+                    iree_memory_order_relaxed);
+}
+
+iree_duration_t iree_task_executor_worker_spin_duration(
+    iree_task_executor_t* executor) {
+  if (executor->worker_idle_mode != IREE_TASK_WORKER_IDLE_MODE_ADAPTIVE) {
+    return executor->worker_spin_ns;
+  }
+  iree_duration_t max_spin_ns = executor->worker_spin_ns;
+  if (max_spin_ns == IREE_DURATION_ZERO) {
+    max_spin_ns = IREE_TASK_WORKER_ADAPTIVE_MAX_SPIN_NS;
+  }
+  const int64_t interval_ns = iree_atomic_load(&executor->submit_interval_ns,
+                                               iree_memory_order_relaxed);
+  // With no history yet or submissions arriving further apart than we are
+  // willing to spin for we'd only be burning cycles before sleeping anyway.
+  if (interval_ns == 0 || interval_ns > max_spin_ns) return IREE_DURATION_ZERO;
+  return iree_min(interval_ns * IREE_TASK_WORKER_ADAPTIVE_SPIN_INTERVAL_SCALE,
+                  max_spin_ns);
+}
+
 void iree_task_executor_submit(iree_task_executor_t* executor,
                                iree_task_submission_t* submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (executor->worker_idle_mode == IREE_TASK_WORKER_IDLE_MODE_ADAPTIVE) {
+    iree_task_executor_record_submit_time(executor);
+  }
+
   // Concatenate the submitted tasks onto our primary LIFO incoming lists.
   iree_task_executor_merge_submission(executor, submission);
 
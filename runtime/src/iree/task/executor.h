@@ -12,6 +12,7 @@
 #include "iree/base/api.h"
 #include "iree/base/internal/atomics.h"
 #include "iree/base/internal/event_pool.h"
+#include "iree/base/internal/memory.h"
 #include "iree/task/scope.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
@@ -154,6 +155,14 @@ extern "C" {
 //    e. If another worker (or iree_task_executor_flush) is already wearing the
 //       coordinator hat then the worker will go to sleep.
 //
+// Tasks carry a priority class (iree_task_priority_t) that is inherited by the
+// tasks they make ready. The local_task_queue keeps one FIFO per class and
+// always pops from the highest one, thieves only steal from the highest one,
+// and posting a task to a worker mailbox records its class so that a running
+// dispatch shard of a lower class yields between tile reservations. Tasks
+// readied by high priority work are handed to the coordinator immediately
+// instead of waiting for the worker to run out of work.
+//
 //==============================================================================
 // Scaling Down
 //==============================================================================
@@ -268,11 +277,32 @@ enum iree_task_scheduling_mode_bits_t {
 };
 typedef uint32_t iree_task_scheduling_mode_t;
 
+// Specifies how workers that have run out of work wait for more.
+// Workers always move through the same phases: spin on their wake notification
+// for a duration, yield their timeslice a number of times while rechecking for
+// work, and then sleep in the kernel until woken. Spinning and yielding avoid
+// the tens of microseconds it takes to wake a sleeping thread at the cost of
+// burning cycles that other threads (or other processes) could have used.
+typedef enum iree_task_worker_idle_mode_e {
+  // Workers spin for worker_spin_ns and yield worker_yield_count times before
+  // sleeping.
+  IREE_TASK_WORKER_IDLE_MODE_FIXED = 0,
+  // As IREE_TASK_WORKER_IDLE_MODE_FIXED but the spin duration follows the
+  // average interval between recent submissions to the executor: workers spin
+  // only when the next submission is expected to arrive before the
+  // worker_spin_ns bound (or IREE_TASK_WORKER_ADAPTIVE_MAX_SPIN_NS if zero).
+  // Intended for loops of back-to-back small submissions such as decoding.
+  IREE_TASK_WORKER_IDLE_MODE_ADAPTIVE = 1,
+} iree_task_worker_idle_mode_t;
+
 // Options controlling task executor behavior.
 typedef struct iree_task_executor_options_t {
   // Specifies the schedule mode used for worker and workload balancing.
   iree_task_scheduling_mode_t scheduling_mode;
 
+  // Specifies how dispatch shards reserve tiles from the dispatch grid.
+  iree_task_dispatch_reservation_mode_t dispatch_reservation_mode;
+
   // Base value added to each executor-local worker index.
   // This allows workers to uniquely identify themselves in multi-executor
   // configurations.
@@ -288,6 +318,16 @@ typedef struct iree_task_executor_options_t {
   // scheduling, and the environment).
   iree_duration_t worker_spin_ns;
 
+  // Specifies how workers wait for more work once they have run out.
+  // In IREE_TASK_WORKER_IDLE_MODE_ADAPTIVE worker_spin_ns is the upper bound of
+  // the spin duration.
+  iree_task_worker_idle_mode_t worker_idle_mode;
+
+  // Number of times each worker yields its timeslice and rechecks for work
+  // after spinning and before sleeping. Yielding keeps the worker runnable
+  // while allowing other threads on the same processor to make progress.
+  uint32_t worker_yield_count;
+
   // Minimum size in bytes of each worker thread stack.
   // The underlying platform may allocate more stack space but _should_
   // guarantee that the available stack space is near this amount. Note that the
@@ -336,6 +376,12 @@ void iree_task_executor_trim(iree_task_executor_t* executor);
 iree_host_size_t iree_task_executor_worker_count(
     iree_task_executor_t* executor);
 
+// Returns the NUMA memory node all workers of the executor are pinned to or
+// IREE_MEMORY_NODE_ID_ANY if the workers are not pinned to processors, span
+// multiple nodes, or the query is not available on the platform. Memory used
+// by work submitted to the executor should be placed on this node.
+uint32_t iree_task_executor_query_memory_node(iree_task_executor_t* executor);
+
 // Returns an iree_event_t pool managed by the executor.
 // Users of the task system should acquire their transient events from this.
 // Long-lived events should be allocated on their own in order to avoid
@@ -38,10 +38,27 @@ struct iree_task_executor_t {
   // TODO(benvanik): make mutable; currently always the same reserved value.
   iree_task_scheduling_mode_t scheduling_mode;
 
+  // Defines how dispatch shards reserve tiles from the dispatch grid.
+  iree_task_dispatch_reservation_mode_t dispatch_reservation_mode;
+
   // Time each worker should spin before parking itself to wait for more work.
   // IREE_DURATION_ZERO is used to disable spinning.
   iree_duration_t worker_spin_ns;
 
+  // Defines how workers wait for more work once they have run out.
+  iree_task_worker_idle_mode_t worker_idle_mode;
+
+  // Number of times each worker yields before parking itself.
+  uint32_t worker_yield_count;
+
+  // Time of the most recent iree_task_executor_submit and the moving average of
+  // the intervals between submissions in nanoseconds. Only maintained in
+  // IREE_TASK_WORKER_IDLE_MODE_ADAPTIVE and accessed with
+  // memory_order_relaxed: concurrent submitters may race but the result is only
+  // used as a hint for how long workers should spin.
+  iree_atomic_int64_t last_submit_time_ns;
+  iree_atomic_int64_t submit_interval_ns;
+
   // State used by the work-stealing operations performed by donated threads.
   // This is **NOT SYNCHRONIZED** and relies on the fact that we actually don't
   // much care about the precise selection of workers enough to mind any tears
@@ -128,6 +145,11 @@ struct iree_task_executor_t {
   iree_task_worker_t* workers;  // [worker_count]
 };
 
+// Returns the duration idle workers should spin waiting for more work before
+// yielding and then parking themselves.
+iree_duration_t iree_task_executor_worker_spin_duration(
+    iree_task_executor_t* executor);
+
 // Merges a submission into the primary FIFO queues.
 // Coordinators will fetch items from here as workers demand them but otherwise
 // not be notified of the changes (waiting until coordination runs again).
@@ -31,6 +31,12 @@ iree_host_size_t iree_task_post_batch_worker_count(
   return post_batch->executor->worker_count;
 }
 
+iree_task_dispatch_reservation_mode_t
+iree_task_post_batch_dispatch_reservation_mode(
+    const iree_task_post_batch_t* post_batch) {
+  return post_batch->executor->dispatch_reservation_mode;
+}
+
 static iree_host_size_t iree_task_post_batch_select_random_worker(
     iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set) {
   // The masks are accessed with 'relaxed' order because they are just hints.
@@ -51,6 +51,11 @@ void iree_task_post_batch_initialize(iree_task_executor_t* executor,
 iree_host_size_t iree_task_post_batch_worker_count(
     const iree_task_post_batch_t* post_batch);
 
+// Returns the mode dispatches posted by the batch use to reserve tiles.
+iree_task_dispatch_reservation_mode_t
+iree_task_post_batch_dispatch_reservation_mode(
+    const iree_task_post_batch_t* post_batch);
+
 // Selects a random worker from the given affinity set.
 iree_host_size_t iree_task_post_batch_select_worker(
     iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set);
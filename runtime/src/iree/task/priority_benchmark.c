@@ -0,0 +1,199 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/task/executor.h"
+#include "iree/task/scope.h"
+#include "iree/task/submission.h"
+#include "iree/task/task.h"
+#include "iree/task/topology.h"
+#include "iree/testing/benchmark.h"
+
+// Number of worker threads in the executor running the dispatches.
+#define IREE_TASK_PRIORITY_BENCHMARK_WORKER_COUNT 4
+
+// Shape of the long-running background dispatch. Workers stay busy with it
+// for tens to hundreds of milliseconds depending on the core count.
+#define IREE_TASK_PRIORITY_BENCHMARK_LONG_TILE_COUNT 4096
+#define IREE_TASK_PRIORITY_BENCHMARK_LONG_TILE_NS (50 * 1000)
+
+// Shape of the latency-sensitive dispatch measured in each iteration.
+#define IREE_TASK_PRIORITY_BENCHMARK_SHORT_TILE_COUNT \
+  IREE_TASK_PRIORITY_BENCHMARK_WORKER_COUNT
+#define IREE_TASK_PRIORITY_BENCHMARK_SHORT_TILE_NS (10 * 1000)
+
+// Maximum number of latency samples retained for computing percentiles.
+// Once full the oldest samples are overwritten.
+#define IREE_TASK_PRIORITY_BENCHMARK_MAX_SAMPLES 1024
+
+typedef struct iree_task_priority_benchmark_params_t {
+  // Priority class of the short dispatches being measured.
+  iree_task_priority_t short_priority;
+  // Whether a long dispatch is kept running in the background.
+  bool background;
+} iree_task_priority_benchmark_params_t;
+
+// Busy-waits for the number of nanoseconds passed as the user context.
+static iree_status_t iree_task_priority_benchmark_tile(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const iree_time_t deadline_ns =
+      iree_time_now() + (iree_duration_t)(uintptr_t)user_context;
+  while (iree_time_now() < deadline_ns) {
+  }
+  return iree_ok_status();
+}
+
+// Submits a dispatch of |tile_count| tiles each taking |tile_ns| to |scope|.
+static void iree_task_priority_benchmark_submit(
+    iree_task_executor_t* executor, iree_task_scope_t* scope,
+    iree_task_priority_t priority, uint32_t tile_count, iree_duration_t tile_ns,
+    iree_task_dispatch_t* dispatch_task) {
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {tile_count, 1, 1};
+  iree_task_dispatch_initialize(
+      scope,
+      iree_task_make_dispatch_closure(iree_task_priority_benchmark_tile,
+                                      (void*)(uintptr_t)tile_ns),
+      workgroup_size, workgroup_count, dispatch_task);
+  iree_task_set_priority(&dispatch_task->header, priority);
+  iree_task_fence_t* fence = NULL;
+  IREE_CHECK_OK(iree_task_executor_acquire_fence(executor, scope, &fence));
+  iree_task_set_completion_task(&dispatch_task->header, &fence->header);
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &dispatch_task->header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+}
+
+static int iree_task_priority_benchmark_compare_samples(const void* a,
+                                                        const void* b) {
+  const iree_duration_t lhs = *(const iree_duration_t*)a;
+  const iree_duration_t rhs = *(const iree_duration_t*)b;
+  return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+// Measures the submit-to-completion latency of short dispatches while a long
+// normal priority dispatch keeps all workers busy. Without preemption the
+// short dispatch waits for the workers to run out of long tiles; with a higher
+// priority class the workers yield between tiles and run it immediately.
+//
+// The reported time is the mean latency and the label contains the p50/p99.
+//
+// user_data points at a static iree_task_priority_benchmark_params_t.
+static iree_status_t iree_task_priority_benchmark_run(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_task_priority_benchmark_params_t* params =
+      (const iree_task_priority_benchmark_params_t*)benchmark_def->user_data;
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(
+      IREE_TASK_PRIORITY_BENCHMARK_WORKER_COUNT, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_CHECK_OK(iree_task_executor_create(options, &topology, host_allocator,
+                                          &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_scope_t long_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("long"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &long_scope);
+  iree_task_scope_t short_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("short"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &short_scope);
+
+  iree_duration_t* samples = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc(
+      host_allocator,
+      IREE_TASK_PRIORITY_BENCHMARK_MAX_SAMPLES * sizeof(*samples),
+      (void**)&samples));
+  iree_host_size_t sample_count = 0;
+
+  iree_task_dispatch_t long_dispatch;
+  iree_task_dispatch_t short_dispatch;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    // Keep the background dispatch running; this is outside of the measured
+    // latency but inside the timed region as we want the workers to be busy.
+    if (params->background && iree_task_scope_is_idle(&long_scope)) {
+      iree_task_priority_benchmark_submit(
+          executor, &long_scope, IREE_TASK_PRIORITY_NORMAL,
+          IREE_TASK_PRIORITY_BENCHMARK_LONG_TILE_COUNT,
+          IREE_TASK_PRIORITY_BENCHMARK_LONG_TILE_NS, &long_dispatch);
+    }
+
+    const iree_time_t start_ns = iree_time_now();
+    iree_task_priority_benchmark_submit(
+        executor, &short_scope, params->short_priority,
+        IREE_TASK_PRIORITY_BENCHMARK_SHORT_TILE_COUNT,
+        IREE_TASK_PRIORITY_BENCHMARK_SHORT_TILE_NS, &short_dispatch);
+    IREE_CHECK_OK(
+        iree_task_scope_wait_idle(&short_scope, IREE_TIME_INFINITE_FUTURE));
+    samples[sample_count++ % IREE_TASK_PRIORITY_BENCHMARK_MAX_SAMPLES] =
+        iree_time_now() - start_ns;
+  }
+
+  // Report percentiles over the retained samples.
+  const iree_host_size_t retained_count =
+      iree_min(sample_count, IREE_TASK_PRIORITY_BENCHMARK_MAX_SAMPLES);
+  if (retained_count > 0) {
+    qsort(samples, retained_count, sizeof(*samples),
+          iree_task_priority_benchmark_compare_samples);
+    char label[64];
+    snprintf(label, sizeof(label), "p50=%.1fus p99=%.1fus",
+             samples[retained_count / 2] / 1000.0,
+             samples[(retained_count * 99) / 100] / 1000.0);
+    iree_benchmark_set_label(benchmark_state, label);
+  }
+  iree_allocator_free(host_allocator, samples);
+
+  IREE_CHECK_OK(
+      iree_task_scope_wait_idle(&long_scope, IREE_TIME_INFINITE_FUTURE));
+  iree_task_scope_deinitialize(&short_scope);
+  iree_task_scope_deinitialize(&long_scope);
+  iree_task_executor_release(executor);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_task_priority_benchmark_run
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_MICROSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_task_priority_benchmark_run,
+    };
+    static const struct {
+      const char* name;
+      iree_task_priority_benchmark_params_t params;
+    } variants[] = {
+        {"idle_normal", {IREE_TASK_PRIORITY_NORMAL, false}},
+        {"busy_normal", {IREE_TASK_PRIORITY_NORMAL, true}},
+        {"busy_high", {IREE_TASK_PRIORITY_HIGH, true}},
+    };
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(variants); ++i) {
+      benchmark_def.user_data = &variants[i].params;
+      iree_benchmark_register(iree_make_cstring_view(variants[i].name),
+                              &benchmark_def);
+    }
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
@@ -12,24 +12,65 @@
 void iree_task_queue_initialize(iree_task_queue_t* out_queue) {
   memset(out_queue, 0, sizeof(*out_queue));
   iree_slim_mutex_initialize(&out_queue->mutex);
-  iree_task_list_initialize(&out_queue->list);
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    iree_task_list_initialize(&out_queue->lists[i]);
+  }
 }
 
 void iree_task_queue_deinitialize(iree_task_queue_t* queue) {
-  iree_task_list_discard(&queue->list);
+  for (iree_host_size_t i = 0; i < IREE_TASK_PRIORITY_COUNT; ++i) {
+    iree_task_list_discard(&queue->lists[i]);
+  }
   iree_slim_mutex_deinitialize(&queue->mutex);
 }
 
+// Returns the list of the highest priority class that has tasks or NULL if the
+// queue is empty.
+static iree_task_list_t* iree_task_queue_highest_list(
+    iree_task_queue_t* queue) {
+  for (int i = IREE_TASK_PRIORITY_COUNT - 1; i >= 0; --i) {
+    if (!iree_task_list_is_empty(&queue->lists[i])) return &queue->lists[i];
+  }
+  return NULL;
+}
+
+// Pops the task at the front of the highest priority class list, if any.
+static iree_task_t* iree_task_queue_pop_front_locked(
+    iree_task_queue_t* queue) {
+  iree_task_list_t* list = iree_task_queue_highest_list(queue);
+  return list ? iree_task_list_pop_front(list) : NULL;
+}
+
+// Appends the FIFO |list| of tasks to the queue. Runs of tasks with the same
+// priority class are appended in one operation such that the common case of
+// all tasks having the same priority does not walk the list under the lock.
+static void iree_task_queue_append_locked(iree_task_queue_t* queue,
+                                          iree_task_list_t* list) {
+  while (!iree_task_list_is_empty(list)) {
+    iree_task_t* run_head = list->head;
+    iree_task_t* run_tail = run_head;
+    while (run_tail->next_task &&
+           run_tail->next_task->priority == run_head->priority) {
+      run_tail = run_tail->next_task;
+    }
+    iree_task_list_t run = {run_head, run_tail};
+    list->head = run_tail->next_task;
+    if (!list->head) list->tail = NULL;
+    run_tail->next_task = NULL;
+    iree_task_list_append(&queue->lists[run_head->priority], &run);
+  }
+}
+
 bool iree_task_queue_is_empty(iree_task_queue_t* queue) {
   iree_slim_mutex_lock(&queue->mutex);
-  bool is_empty = iree_task_list_is_empty(&queue->list);
+  bool is_empty = iree_task_queue_highest_list(queue) == NULL;
   iree_slim_mutex_unlock(&queue->mutex);
   return is_empty;
 }
 
 void iree_task_queue_push_front(iree_task_queue_t* queue, iree_task_t* task) {
   iree_slim_mutex_lock(&queue->mutex);
-  iree_task_list_push_front(&queue->list, task);
+  iree_task_list_push_front(&queue->lists[task->priority], task);
   iree_slim_mutex_unlock(&queue->mutex);
 }
 
@@ -38,7 +79,7 @@ void iree_task_queue_append_from_lifo_list_unsafe(iree_task_queue_t* queue,
   // NOTE: reversing the list outside of the lock.
   iree_task_list_reverse(list);
   iree_slim_mutex_lock(&queue->mutex);
-  iree_task_list_append(&queue->list, list);
+  iree_task_queue_append_locked(queue, list);
   iree_slim_mutex_unlock(&queue->mutex);
 }
 
@@ -54,8 +95,8 @@ iree_task_t* iree_task_queue_flush_from_lifo_slist(
 
   // Append the tasks and pop off the front for return.
   iree_slim_mutex_lock(&queue->mutex);
-  if (did_flush) iree_task_list_append(&queue->list, &suffix);
-  iree_task_t* next_task = iree_task_list_pop_front(&queue->list);
+  if (did_flush) iree_task_queue_append_locked(queue, &suffix);
+  iree_task_t* next_task = iree_task_queue_pop_front_locked(queue);
   iree_slim_mutex_unlock(&queue->mutex);
 
   return next_task;
@@ -63,7 +104,7 @@ iree_task_t* iree_task_queue_flush_from_lifo_slist(
 
 iree_task_t* iree_task_queue_pop_front(iree_task_queue_t* queue) {
   iree_slim_mutex_lock(&queue->mutex);
-  iree_task_t* next_task = iree_task_list_pop_front(&queue->list);
+  iree_task_t* next_task = iree_task_queue_pop_front_locked(queue);
   iree_slim_mutex_unlock(&queue->mutex);
   return next_task;
 }
@@ -75,7 +116,10 @@ iree_task_t* iree_task_queue_try_steal(iree_task_queue_t* source_queue,
   iree_task_list_t stolen_tasks;
   iree_task_list_initialize(&stolen_tasks);
   if (iree_slim_mutex_try_lock(&source_queue->mutex)) {
-    iree_task_list_split(&source_queue->list, max_tasks, &stolen_tasks);
+    iree_task_list_t* source_list = iree_task_queue_highest_list(source_queue);
+    if (source_list) {
+      iree_task_list_split(source_list, max_tasks, &stolen_tasks);
+    }
     iree_slim_mutex_unlock(&source_queue->mutex);
   }
 
@@ -83,8 +127,9 @@ iree_task_t* iree_task_queue_try_steal(iree_task_queue_t* source_queue,
   iree_task_t* next_task = NULL;
   if (!iree_task_list_is_empty(&stolen_tasks)) {
     iree_slim_mutex_lock(&target_queue->mutex);
-    iree_task_list_append(&target_queue->list, &stolen_tasks);
-    next_task = iree_task_list_pop_front(&target_queue->list);
+    iree_task_list_append(&target_queue->lists[stolen_tasks.head->priority],
+                          &stolen_tasks);
+    next_task = iree_task_queue_pop_front_locked(target_queue);
     iree_slim_mutex_unlock(&target_queue->mutex);
   }
   return next_task;
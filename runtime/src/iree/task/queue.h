@@ -102,12 +102,16 @@ extern "C" {
 // list we can't easily just walk backward and we don't want to be introducing
 // cache line contention as thieves start touching the same tasks as the worker
 // is while processing.
+//
+// Tasks are kept in one FIFO list per iree_task_priority_t class. The owner
+// always pops from the highest priority class with tasks available and thieves
+// steal from the same so that idle workers help with the most urgent work.
 typedef struct iree_task_queue_t {
   // Must be held when manipulating the queue. >90% accesses are by the owner.
   iree_slim_mutex_t mutex;
 
-  // FIFO task list.
-  iree_task_list_t list IREE_GUARDED_BY(mutex);
+  // FIFO task lists indexed by iree_task_priority_t.
+  iree_task_list_t lists[IREE_TASK_PRIORITY_COUNT] IREE_GUARDED_BY(mutex);
 } iree_task_queue_t;
 
 // Initializes a work-stealing task queue in-place.
@@ -144,11 +148,13 @@ iree_task_t* iree_task_queue_flush_from_lifo_slist(
     iree_task_queue_t* queue, iree_atomic_task_slist_t* source_slist);
 
 // Pops a task from the front of the queue if any are available.
+// Tasks of higher priority classes are popped before lower ones.
 //
 // Must only be called from the owning worker's thread.
 iree_task_t* iree_task_queue_pop_front(iree_task_queue_t* queue);
 
 // Tries to steal up to |max_tasks| from the back of the queue.
+// Only tasks of the highest priority class available are stolen.
 //
 // On success, up to |max_tasks| tasks that were at the tail of the
 // |source_queue| will be moved to the |target_queue| and the first of the
@@ -190,6 +190,45 @@ TEST(QueueTest, FlushSlistOrdered) {
   iree_task_queue_deinitialize(&queue);
 }
 
+TEST(QueueTest, FlushSlistPrioritized) {
+  iree_task_queue_t queue;
+  iree_task_queue_initialize(&queue);
+
+  // Make a lifo list: d<-c<-b<-a with b and d at high priority.
+  iree_atomic_task_slist_t slist;
+  iree_atomic_task_slist_initialize(&slist);
+  iree_task_t task_a = {0};
+  task_a.priority = IREE_TASK_PRIORITY_NORMAL;
+  iree_atomic_task_slist_push(&slist, &task_a);
+  iree_task_t task_b = {0};
+  task_b.priority = IREE_TASK_PRIORITY_HIGH;
+  iree_atomic_task_slist_push(&slist, &task_b);
+  iree_task_t task_c = {0};
+  task_c.priority = IREE_TASK_PRIORITY_NORMAL;
+  iree_atomic_task_slist_push(&slist, &task_c);
+  iree_task_t task_d = {0};
+  task_d.priority = IREE_TASK_PRIORITY_HIGH;
+  iree_atomic_task_slist_push(&slist, &task_d);
+
+  // High priority tasks are returned first in FIFO order followed by the
+  // normal priority tasks in FIFO order.
+  EXPECT_EQ(&task_b, iree_task_queue_flush_from_lifo_slist(&queue, &slist));
+  EXPECT_EQ(&task_d, iree_task_queue_pop_front(&queue));
+
+  // A low priority task pushed to the front still runs after normal ones.
+  iree_task_t task_e = {0};
+  task_e.priority = IREE_TASK_PRIORITY_LOW;
+  iree_task_queue_push_front(&queue, &task_e);
+  EXPECT_EQ(&task_a, iree_task_queue_pop_front(&queue));
+  EXPECT_EQ(&task_c, iree_task_queue_pop_front(&queue));
+  EXPECT_EQ(&task_e, iree_task_queue_pop_front(&queue));
+  EXPECT_TRUE(iree_task_queue_is_empty(&queue));
+
+  iree_atomic_task_slist_deinitialize(&slist);
+
+  iree_task_queue_deinitialize(&queue);
+}
+
 TEST(QueueTest, TryStealEmpty) {
   iree_task_queue_t source_queue;
   iree_task_queue_initialize(&source_queue);
@@ -336,4 +375,37 @@ TEST(QueueTest, TryStealAll) {
   iree_task_queue_deinitialize(&target_queue);
 }
 
+TEST(QueueTest, TryStealPrioritized) {
+  iree_task_queue_t source_queue;
+  iree_task_queue_initialize(&source_queue);
+  iree_task_queue_t target_queue;
+  iree_task_queue_initialize(&target_queue);
+
+  iree_task_t task_a = {0};
+  task_a.priority = IREE_TASK_PRIORITY_NORMAL;
+  iree_task_t task_b = {0};
+  task_b.priority = IREE_TASK_PRIORITY_NORMAL;
+  iree_task_t task_c = {0};
+  task_c.priority = IREE_TASK_PRIORITY_HIGH;
+  iree_task_t task_d = {0};
+  task_d.priority = IREE_TASK_PRIORITY_HIGH;
+  iree_task_queue_push_front(&source_queue, &task_d);
+  iree_task_queue_push_front(&source_queue, &task_c);
+  iree_task_queue_push_front(&source_queue, &task_b);
+  iree_task_queue_push_front(&source_queue, &task_a);
+
+  // Thieves only take from the highest priority class available.
+  EXPECT_EQ(&task_d, iree_task_queue_try_steal_until_success(
+                         &source_queue, &target_queue, 1000));
+  EXPECT_TRUE(iree_task_queue_is_empty(&target_queue));
+
+  EXPECT_EQ(&task_c, iree_task_queue_pop_front(&source_queue));
+  EXPECT_EQ(&task_a, iree_task_queue_pop_front(&source_queue));
+  EXPECT_EQ(&task_b, iree_task_queue_pop_front(&source_queue));
+  EXPECT_TRUE(iree_task_queue_is_empty(&source_queue));
+
+  iree_task_queue_deinitialize(&source_queue);
+  iree_task_queue_deinitialize(&target_queue);
+}
+
 }  // namespace
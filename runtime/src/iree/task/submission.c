@@ -14,6 +14,7 @@
 void iree_task_submission_initialize(iree_task_submission_t* out_submission) {
   iree_task_list_initialize(&out_submission->ready_list);
   iree_task_list_initialize(&out_submission->waiting_list);
+  out_submission->ready_priority_mask = 0;
 }
 
 void iree_task_submission_initialize_from_lifo_slist(
@@ -31,11 +32,13 @@ void iree_task_submission_initialize_from_lifo_slist(
 void iree_task_submission_reset(iree_task_submission_t* submission) {
   memset(&submission->ready_list, 0, sizeof(submission->ready_list));
   memset(&submission->waiting_list, 0, sizeof(submission->waiting_list));
+  submission->ready_priority_mask = 0;
 }
 
 void iree_task_submission_discard(iree_task_submission_t* submission) {
   iree_task_list_discard(&submission->ready_list);
   iree_task_list_discard(&submission->waiting_list);
+  submission->ready_priority_mask = 0;
 }
 
 bool iree_task_submission_is_empty(iree_task_submission_t* submission) {
@@ -43,6 +46,11 @@ bool iree_task_submission_is_empty(iree_task_submission_t* submission) {
          iree_task_list_is_empty(&submission->waiting_list);
 }
 
+bool iree_task_submission_has_ready_priority_above(
+    const iree_task_submission_t* submission, iree_task_priority_t priority) {
+  return (submission->ready_priority_mask >> (priority + 1)) != 0;
+}
+
 void iree_task_submission_enqueue(iree_task_submission_t* submission,
                                   iree_task_t* task) {
   IREE_ASSERT_TRUE(iree_task_is_ready(task),
@@ -56,6 +64,7 @@ void iree_task_submission_enqueue(iree_task_submission_t* submission,
   } else {
     // Task is ready to execute immediately.
     iree_task_list_push_front(&submission->ready_list, task);
+    submission->ready_priority_mask |= 1u << task->priority;
   }
 }
 
@@ -59,6 +59,13 @@ typedef struct iree_task_submission_t {
   // more of a set than an ordered list and that they can all be waited on as a
   // multi-wait-any.
   iree_task_list_t waiting_list;
+
+  // Bitmask of 1 << iree_task_priority_t for each priority class of task that
+  // has been enqueued to ready_list since the submission was last initialized
+  // or reset. Allows the producer to check for urgent work without walking the
+  // list. Tasks flushed in with iree_task_submission_initialize_from_lifo_slist
+  // are not tracked.
+  uint32_t ready_priority_mask;
 } iree_task_submission_t;
 
 // Initializes a task submission.
@@ -82,6 +89,11 @@ void iree_task_submission_discard(iree_task_submission_t* submission);
 // Returns true if the submission has no tasks.
 bool iree_task_submission_is_empty(iree_task_submission_t* submission);
 
+// Returns true if a task of a priority class above |priority| has been enqueued
+// to the ready list of the submission.
+bool iree_task_submission_has_ready_priority_above(
+    const iree_task_submission_t* submission, iree_task_priority_t priority);
+
 // Enqueues |task| to the pending |submission|.
 // The task will be checked to see whether it is immediately ready to execute
 // and placed in an appropriate list; all dependencies must be declared prior to
@@ -0,0 +1,154 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/task/executor.h"
+#include "iree/task/scope.h"
+#include "iree/task/submission.h"
+#include "iree/task/task.h"
+#include "iree/task/topology.h"
+#include "iree/testing/benchmark.h"
+
+// Number of worker threads in the executor running the dispatches.
+#define IREE_TASK_SUBMIT_LATENCY_BENCHMARK_WORKER_COUNT 4
+
+// Number of dispatches submitted one after another in each iteration.
+#define IREE_TASK_SUBMIT_LATENCY_BENCHMARK_CHAIN_LENGTH 64
+
+typedef struct iree_task_submit_latency_benchmark_params_t {
+  iree_task_worker_idle_mode_t idle_mode;
+  iree_duration_t spin_ns;
+  uint32_t yield_count;
+  // Host time spent between receiving the results of one dispatch and
+  // submitting the next, as if the host was sampling a token.
+  iree_duration_t host_gap_ns;
+} iree_task_submit_latency_benchmark_params_t;
+
+static iree_status_t iree_task_submit_latency_benchmark_tile(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  return iree_ok_status();
+}
+
+// Busy-waits for |duration_ns| on the calling thread.
+static void iree_task_submit_latency_benchmark_host_work(
+    iree_duration_t duration_ns) {
+  if (duration_ns == IREE_DURATION_ZERO) return;
+  const iree_time_t deadline_ns = iree_time_now() + duration_ns;
+  while (iree_time_now() < deadline_ns) {
+  }
+}
+
+// Submits a chain of tiny dispatches where each dispatch is only submitted
+// after the previous one has completed. This models a decode loop where the
+// host needs the results of each step before it can issue the next and the
+// latency is dominated by how quickly idle workers notice the new work.
+//
+// user_data points at a static iree_task_submit_latency_benchmark_params_t.
+static iree_status_t iree_task_submit_latency_benchmark_run(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_task_submit_latency_benchmark_params_t* params =
+      (const iree_task_submit_latency_benchmark_params_t*)
+          benchmark_def->user_data;
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_idle_mode = params->idle_mode;
+  options.worker_spin_ns = params->spin_ns;
+  options.worker_yield_count = params->yield_count;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(
+      IREE_TASK_SUBMIT_LATENCY_BENCHMARK_WORKER_COUNT, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_CHECK_OK(iree_task_executor_create(options, &topology, host_allocator,
+                                          &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("benchmark"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {
+      IREE_TASK_SUBMIT_LATENCY_BENCHMARK_WORKER_COUNT, 1, 1};
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    for (int i = 0; i < IREE_TASK_SUBMIT_LATENCY_BENCHMARK_CHAIN_LENGTH; ++i) {
+      iree_task_dispatch_t dispatch_task;
+      iree_task_dispatch_initialize(
+          &scope,
+          iree_task_make_dispatch_closure(
+              iree_task_submit_latency_benchmark_tile, NULL),
+          workgroup_size, workgroup_count, &dispatch_task);
+      iree_task_fence_t* fence = NULL;
+      IREE_CHECK_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+      iree_task_set_completion_task(&dispatch_task.header, &fence->header);
+      iree_task_submission_t submission;
+      iree_task_submission_initialize(&submission);
+      iree_task_submission_enqueue(&submission, &dispatch_task.header);
+      iree_task_executor_submit(executor, &submission);
+      iree_task_executor_flush(executor);
+      IREE_CHECK_OK(
+          iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+      iree_task_submit_latency_benchmark_host_work(params->host_gap_ns);
+    }
+  }
+  iree_benchmark_set_items_processed(
+      benchmark_state, IREE_TASK_SUBMIT_LATENCY_BENCHMARK_CHAIN_LENGTH);
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_task_submit_latency_benchmark_run
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_MICROSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_task_submit_latency_benchmark_run,
+    };
+    static const struct {
+      const char* name;
+      iree_task_submit_latency_benchmark_params_t params;
+    } policies[] = {
+        {"sleep", {IREE_TASK_WORKER_IDLE_MODE_FIXED, 0, 0}},
+        {"yield", {IREE_TASK_WORKER_IDLE_MODE_FIXED, 0, 16}},
+        {"spin_50us", {IREE_TASK_WORKER_IDLE_MODE_FIXED, 50 * 1000, 0}},
+        {"spin_50us_yield",
+         {IREE_TASK_WORKER_IDLE_MODE_FIXED, 50 * 1000, 16}},
+        {"adaptive", {IREE_TASK_WORKER_IDLE_MODE_ADAPTIVE, 0, 16}},
+    };
+    static const iree_duration_t host_gaps_ns[] = {0, 20 * 1000, 1000 * 1000};
+    static iree_task_submit_latency_benchmark_params_t
+        params[IREE_ARRAYSIZE(host_gaps_ns)][IREE_ARRAYSIZE(policies)];
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(host_gaps_ns); ++i) {
+      for (iree_host_size_t j = 0; j < IREE_ARRAYSIZE(policies); ++j) {
+        params[i][j] = policies[j].params;
+        params[i][j].host_gap_ns = host_gaps_ns[i];
+        char name[64];
+        snprintf(name, sizeof(name), "gap_%uus_%s",
+                 (uint32_t)(host_gaps_ns[i] / 1000), policies[j].name);
+        benchmark_def.user_data = &params[i][j];
+        iree_benchmark_register(iree_make_cstring_view(name), &benchmark_def);
+      }
+    }
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
@@ -28,6 +28,7 @@ void iree_task_initialize(iree_task_type_t type, iree_task_scope_t* scope,
   out_task->scope = scope;
   out_task->affinity_set = iree_task_affinity_for_any_worker();
   out_task->type = type;
+  out_task->priority = IREE_TASK_PRIORITY_NORMAL;
 }
 
 void iree_task_set_cleanup_fn(iree_task_t* task,
@@ -35,6 +36,20 @@ void iree_task_set_cleanup_fn(iree_task_t* task,
   task->cleanup_fn = cleanup_fn;
 }
 
+void iree_task_set_priority(iree_task_t* task, iree_task_priority_t priority) {
+  task->priority = priority;
+  task->flags |= IREE_TASK_FLAG_PRIORITY_ASSIGNED;
+}
+
+// Propagates the priority class of |task| to |ready_task| that it has readied.
+// Tasks with an explicitly assigned priority class keep it.
+static inline void iree_task_inherit_priority(iree_task_priority_t priority,
+                                              iree_task_t* ready_task) {
+  if (!(ready_task->flags & IREE_TASK_FLAG_PRIORITY_ASSIGNED)) {
+    ready_task->priority = priority;
+  }
+}
+
 void iree_task_set_completion_task(iree_task_t* task,
                                    iree_task_t* completion_task) {
   IREE_ASSERT(!task->completion_task);
@@ -43,6 +58,25 @@ void iree_task_set_completion_task(iree_task_t* task,
                         iree_memory_order_acq_rel);
 }
 
+void iree_task_reset(iree_task_t* task, iree_task_t* completion_task,
+                     int32_t pending_dependency_count) {
+  IREE_ASSERT(!task->pool);
+  task->next_task = NULL;
+  task->completion_task = completion_task;
+  iree_atomic_store(&task->pending_dependency_count, pending_dependency_count,
+                    iree_memory_order_relaxed);
+  task->flags &=
+      ~(IREE_TASK_FLAG_WAIT_COMPLETED | IREE_TASK_FLAG_DISPATCH_RETIRE |
+        IREE_TASK_FLAG_ABORTED | IREE_TASK_FLAG_PRIORITY_ASSIGNED);
+  task->priority = IREE_TASK_PRIORITY_NORMAL;
+
+  // Status is consumed as tasks retire but statistics are only merged.
+  if (task->type == IREE_TASK_TYPE_DISPATCH) {
+    iree_task_dispatch_t* dispatch_task = (iree_task_dispatch_t*)task;
+    memset(&dispatch_task->statistics, 0, sizeof(dispatch_task->statistics));
+  }
+}
+
 bool iree_task_is_ready(iree_task_t* task) {
   if (iree_atomic_load(&task->pending_dependency_count,
                        iree_memory_order_acquire) > 0) {
@@ -153,6 +187,9 @@ static void iree_task_retire(iree_task_t* task,
   iree_task_t* completion_task = task->completion_task;
   task->completion_task = NULL;
 
+  // The task may be returned to its pool during cleanup.
+  const iree_task_priority_t priority = task->priority;
+
   if (iree_status_is_ok(status)) {
     // Task completed successfully.
     iree_task_cleanup(task, IREE_STATUS_OK);
@@ -163,6 +200,7 @@ static void iree_task_retire(iree_task_t* task,
     if (completion_task_ready) {
       // This was the last pending dependency and the completion task is ready
       // to run.
+      iree_task_inherit_priority(priority, completion_task);
       iree_task_submission_enqueue(pending_submission, completion_task);
     }
   } else {
@@ -350,6 +388,7 @@ void iree_task_barrier_retire(iree_task_barrier_t* task,
     if (iree_atomic_fetch_sub(&dependent_task->pending_dependency_count, 1,
                               iree_memory_order_acq_rel) == 1) {
       // The dependent task has retired and can now be made ready.
+      iree_task_inherit_priority(task->header.priority, dependent_task);
       iree_task_submission_enqueue(pending_submission, dependent_task);
     }
   }
@@ -575,8 +614,7 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
     // indirection buffer have been satisfied and its safe to read. We perform
     // the indirection here and convert the dispatch to a direct one such that
     // following code can read the value.
-    // TODO(benvanik): non-one-shot command buffers won't be able to do this as
-    // the intent is that they can be dynamic per execution.
+    // Tasks that are reset for resubmission must restore the pointer and flag.
     const uint32_t* source_ptr = dispatch_task->workgroup_count.ptr;
     memcpy(dispatch_task->workgroup_count.value, source_ptr,
            sizeof(dispatch_task->workgroup_count.value));
@@ -606,11 +644,21 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
   iree_host_size_t shard_count =
       iree_min(dispatch_task->tile_count, worker_count);
 
+  dispatch_task->shard_count = (uint32_t)shard_count;
+
   // Compute how many tiles we want each shard to reserve at a time from the
   // larger grid. A higher number reduces overhead and improves locality while
   // a lower number reduces maximum worst-case latency (coarser work stealing).
-  if (dispatch_task->tile_count <
-      worker_count * IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
+  dispatch_task->reservation_mode =
+      iree_task_post_batch_dispatch_reservation_mode(post_batch);
+  if (dispatch_task->reservation_mode !=
+      IREE_TASK_DISPATCH_RESERVATION_MODE_FIXED) {
+    // Shards size each reservation as they go.
+    dispatch_task->tiles_per_reservation =
+        IREE_TASK_DISPATCH_MAX_TILES_PER_DYNAMIC_RESERVATION;
+  } else if (dispatch_task->tile_count <
+             worker_count *
+                 IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
     // Grid is small - allow it to be eagerly sliced up.
     dispatch_task->tiles_per_reservation = 1;
   } else {
@@ -690,6 +738,7 @@ void iree_task_dispatch_shard_initialize(iree_task_dispatch_t* dispatch_task,
                                          iree_task_dispatch_shard_t* out_task) {
   iree_task_initialize(IREE_TASK_TYPE_DISPATCH_SHARD,
                        dispatch_task->header.scope, &out_task->header);
+  out_task->header.priority = dispatch_task->header.priority;
   iree_task_set_completion_task(&out_task->header, &dispatch_task->header);
 }
 
@@ -707,9 +756,59 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
   return shard_task;
 }
 
-void iree_task_dispatch_shard_execute(
+// Returns the number of tiles a shard should reserve next from the dispatch
+// grid. |tile_duration_ns| is the latency of tiles measured by the shard so far
+// or 0 if no tiles have been executed yet.
+static uint32_t iree_task_dispatch_shard_reservation_size(
+    iree_task_dispatch_t* dispatch_task, iree_duration_t tile_duration_ns) {
+  if (dispatch_task->reservation_mode ==
+      IREE_TASK_DISPATCH_RESERVATION_MODE_FIXED) {
+    return dispatch_task->tiles_per_reservation;
+  }
+
+  // Take a fraction of the fair share of the remaining tiles. The tile index is
+  // only a hint here as other shards may be reserving concurrently; that's ok
+  // as every reservation is still disjoint.
+  const uint32_t tile_index = (uint32_t)iree_atomic_load(
+      &dispatch_task->tile_index, iree_memory_order_relaxed);
+  if (tile_index >= dispatch_task->tile_count) return 1;
+  const uint32_t remaining_tiles = dispatch_task->tile_count - tile_index;
+  uint32_t tile_count =
+      remaining_tiles / (dispatch_task->shard_count *
+                         IREE_TASK_DISPATCH_GUIDED_RESERVATION_DIVISOR);
+
+  if (dispatch_task->reservation_mode ==
+      IREE_TASK_DISPATCH_RESERVATION_MODE_ADAPTIVE) {
+    // Start with a single tile to measure how expensive tiles are and then
+    // batch up as many as fit in the target reservation duration.
+    const iree_duration_t budgeted_tile_count =
+        tile_duration_ns > 0
+            ? IREE_TASK_DISPATCH_ADAPTIVE_RESERVATION_DURATION_NS /
+                  tile_duration_ns
+            : 1;
+    if (budgeted_tile_count < (iree_duration_t)tile_count) {
+      tile_count = (uint32_t)budgeted_tile_count;
+    }
+  }
+
+  return iree_max(1u,
+                  iree_min(tile_count, dispatch_task->tiles_per_reservation));
+}
+
+// Returns true if tasks of a priority class above |priority| are pending in
+// |pending_priority_mask|.
+static inline bool iree_task_dispatch_shard_should_yield(
+    iree_task_priority_t priority, iree_atomic_int32_t* pending_priority_mask) {
+  if (!pending_priority_mask) return false;
+  const int32_t mask =
+      iree_atomic_load(pending_priority_mask, iree_memory_order_relaxed);
+  return (mask >> (priority + 1)) != 0;
+}
+
+bool iree_task_dispatch_shard_execute(
     iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
     uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    iree_atomic_int32_t* pending_priority_mask,
     iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -732,7 +831,7 @@ void iree_task_dispatch_shard_execute(
                          worker_local_memory.data_length));
     iree_task_retire(&task->header, pending_submission, iree_ok_status());
     IREE_TRACE_ZONE_END(z0);
-    return;
+    return true;
   }
 
   // Prepare context shared for all tiles in the shard.
@@ -758,7 +857,11 @@ void iree_task_dispatch_shard_execute(
 
   // Loop over all tiles until they are all processed.
   const uint32_t tile_count = dispatch_task->tile_count;
-  const uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
+  const bool measure_tiles = dispatch_task->reservation_mode ==
+                             IREE_TASK_DISPATCH_RESERVATION_MODE_ADAPTIVE;
+  iree_duration_t tile_duration_ns = 0;
+  uint32_t tiles_per_reservation =
+      iree_task_dispatch_shard_reservation_size(dispatch_task, 0);
   // relaxed order because we only care about atomic increments, not about
   // ordering of tile_index accesses w.r.t. other memory accesses.
   uint32_t tile_base =
@@ -767,6 +870,8 @@ void iree_task_dispatch_shard_execute(
   while (tile_base < tile_count) {
     const uint32_t tile_range =
         iree_min(tile_base + tiles_per_reservation, tile_count);
+    const iree_time_t reservation_start_ns =
+        measure_tiles ? iree_time_now() : 0;
     for (uint32_t tile_index = tile_base; tile_index < tile_range;
          ++tile_index) {
       // TODO(benvanik): faster math here, especially knowing we pull off N
@@ -810,7 +915,34 @@ void iree_task_dispatch_shard_execute(
       }
     }
 
+    // Update the running estimate of the tile latency with the reservation
+    // we just completed. The average is weighted towards the latest
+    // reservations as tile costs may vary across the grid.
+    if (measure_tiles) {
+      const iree_duration_t reservation_tile_duration_ns =
+          iree_max(1, (iree_time_now() - reservation_start_ns) /
+                          (iree_duration_t)(tile_range - tile_base));
+      tile_duration_ns =
+          tile_duration_ns
+              ? (tile_duration_ns * 3 + reservation_tile_duration_ns) / 4
+              : reservation_tile_duration_ns;
+    }
+
+    // Yield to higher priority work posted to the worker before taking more
+    // tiles. Other shards may continue to make progress on the dispatch.
+    if (iree_task_dispatch_shard_should_yield(task->header.priority,
+                                              pending_priority_mask)) {
+      iree_task_dispatch_statistics_merge(&shard_statistics,
+                                          &dispatch_task->statistics);
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "preempted");
+      IREE_TRACE_ZONE_END(z0);
+      return false;
+    }
+
     // Try to grab the next slice of tiles.
+    tiles_per_reservation =
+        iree_task_dispatch_shard_reservation_size(dispatch_task,
+                                                  tile_duration_ns);
     tile_base =
         iree_atomic_fetch_add(&dispatch_task->tile_index, tiles_per_reservation,
                               iree_memory_order_relaxed);
@@ -827,4 +959,5 @@ abort_shard:
   // propagated to the dispatch and it'll clean up after all shards are joined.
   iree_task_retire(&task->header, pending_submission, iree_ok_status());
   IREE_TRACE_ZONE_END(z0);
+  return true;
 }
@@ -117,9 +117,37 @@ enum iree_task_flag_bits_t {
   // happens and may be available for querying before all tasks have been
   // cleaned up.
   IREE_TASK_FLAG_ABORTED = 1u << 5,
+
+  // The priority class of the task was assigned with iree_task_set_priority and
+  // must not be replaced by the class of the task that readies it.
+  IREE_TASK_FLAG_PRIORITY_ASSIGNED = 1u << 6,
 };
 typedef uint16_t iree_task_flags_t;
 
+// Priority class of a task used by workers to select which ready task to run
+// next. Ready tasks of a higher class always run before those of a lower class
+// that are queued on the same worker and dispatch shards of a lower class yield
+// their worker between tile reservations when tasks of a higher class are
+// posted to it. Tasks within a class run in FIFO order.
+//
+// Tasks readied by the completion of another task (completion tasks and
+// barrier dependents) inherit the priority class of the task that readied them
+// unless they were assigned a class with iree_task_set_priority (including
+// IREE_TASK_PRIORITY_NORMAL). This allows a submission to set the priority of
+// only its root tasks.
+enum iree_task_priority_e {
+  // Throughput-oriented work that should only run when nothing else is ready.
+  IREE_TASK_PRIORITY_LOW = 0u,
+  // Default priority class.
+  IREE_TASK_PRIORITY_NORMAL = 1u,
+  // Latency-sensitive work that should run as soon as possible.
+  IREE_TASK_PRIORITY_HIGH = 2u,
+};
+typedef uint8_t iree_task_priority_t;
+
+// Total number of priority classes.
+#define IREE_TASK_PRIORITY_COUNT 3
+
 typedef struct iree_task_t iree_task_t;
 
 // A function called to cleanup tasks.
@@ -180,6 +208,9 @@ struct iree_alignas(iree_max_align_t) iree_task_t {
 
   // Task-specific flag bits.
   iree_task_flags_t flags;
+
+  // Priority class used to order the task against other ready tasks.
+  iree_task_priority_t priority;
 };
 static_assert(offsetof(iree_task_t, next_task) == 0,
               "next_task intrusive pointer must be at offset 0");
@@ -202,12 +233,29 @@ void iree_task_initialize(iree_task_type_t type, iree_task_scope_t* scope,
 void iree_task_set_cleanup_fn(iree_task_t* task,
                               iree_task_cleanup_fn_t cleanup_fn);
 
+// Sets the priority class of the task. Must be called prior to submission.
+// The assigned class is kept when the task is readied by another task.
+void iree_task_set_priority(iree_task_t* task, iree_task_priority_t priority);
+
 // Sets up a dependency edge from |task| to |completion_task| such that when
 // |task| completes |completion_task| will be notified and have its
 // pending_dependency_count decremented.
 void iree_task_set_completion_task(iree_task_t* task,
                                    iree_task_t* completion_task);
 
+// Resets a |task| that has retired so that it can be submitted again.
+// Retiring consumes the dependency edges and execution state of a task and
+// this restores them to what they were when the task was first built:
+// |completion_task| is assigned without changing its dependency count and
+// |pending_dependency_count| must match the number of tasks that complete into
+// |task| at the time it is submitted. The priority class is reset to normal and
+// may be inherited again.
+//
+// Only tasks that are not owned by a pool may be reset and the caller must
+// ensure that no prior execution of the task is still in-flight.
+void iree_task_reset(iree_task_t* task, iree_task_t* completion_task,
+                     int32_t pending_dependency_count);
+
 // Returns true if the |task| is ready to execute immediately.
 // Though this is safe to call from any thread the test may have false-negatives
 // (ready tasks are not returned as ready) due to cross-thread synchronization
@@ -478,6 +526,28 @@ void iree_task_wait_set_wait_any(iree_task_wait_t* task,
 // IREE_TASK_TYPE_DISPATCH_* structures
 //==============================================================================
 
+// Specifies how dispatch shards reserve tiles from the dispatch grid.
+// Each reservation is an atomic operation on a counter shared by all shards:
+// reserving too few tiles at a time causes contention on the counter when tiles
+// are cheap while reserving too many causes tail imbalance when tiles are
+// expensive as the last reservations are held by a few workers.
+typedef enum iree_task_dispatch_reservation_mode_e {
+  // Each reservation takes a fixed number of tiles
+  // (IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION or 1 if the grid is
+  // small relative to the worker count).
+  IREE_TASK_DISPATCH_RESERVATION_MODE_FIXED = 0,
+  // Guided self-scheduling: each reservation takes a fraction of the remaining
+  // tiles such that early reservations are large and amortize the counter
+  // while the reservations shrink to single tiles near the end of the grid to
+  // balance the tail.
+  IREE_TASK_DISPATCH_RESERVATION_MODE_GUIDED = 1,
+  // As IREE_TASK_DISPATCH_RESERVATION_MODE_GUIDED but each reservation is also
+  // bounded to roughly IREE_TASK_DISPATCH_ADAPTIVE_RESERVATION_DURATION_NS of
+  // work based on the per-tile latency measured by the shard. Cheap tiles are
+  // batched while expensive tiles are reserved one at a time.
+  IREE_TASK_DISPATCH_RESERVATION_MODE_ADAPTIVE = 2,
+} iree_task_dispatch_reservation_mode_t;
+
 // Statistics tracked across an entire dispatch operation.
 // Each tile contributes to these statistics as they execute to provide an
 // aggregate set of statistics that can be reported to tracing/user queries.
@@ -642,10 +712,19 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   uint32_t tile_count;
 
   // Maximum number of tiles to fetch per tile reservation from the grid.
-  // Bounded by IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION and a
-  // reasonable number chosen based on the tile and shard counts.
+  // In IREE_TASK_DISPATCH_RESERVATION_MODE_FIXED this is bounded by
+  // IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION and a reasonable number
+  // chosen based on the tile and shard counts. In other modes this bounds the
+  // reservations sized by the shards.
   uint32_t tiles_per_reservation;
 
+  // Number of shards the dispatch was issued as.
+  uint32_t shard_count;
+
+  // Defines how shards size their tile reservations.
+  // Assigned from the executor when the dispatch is issued.
+  iree_task_dispatch_reservation_mode_t reservation_mode;
+
   // The tail tile index; the next reservation will start from here.
   // This is used by shards to slice off the work to perform in their inner
   // loop. Ideally we'd have no destructive interference with other shared data
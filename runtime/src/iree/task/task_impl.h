@@ -118,11 +118,21 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
 // |worker_local_memory| is a block of memory exclusively available to the shard
 // during execution. Contents are undefined both before and after execution.
 //
+// |pending_priority_mask| is an optional bitmask of (1 << iree_task_priority_t)
+// bits for priority classes of tasks waiting to run on the executing worker.
+// Tile reservations act as preemption points: if a class above the shard's own
+// is pending the shard stops before reserving more tiles and returns false
+// without retiring. The caller must requeue the shard to continue execution
+// once the higher priority work has run.
+//
 // Errors are propagated to the parent scope and the dispatch will fail once
 // all shards have completed.
-void iree_task_dispatch_shard_execute(
+//
+// Returns true if the shard retired.
+bool iree_task_dispatch_shard_execute(
     iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
     uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    iree_atomic_int32_t* pending_priority_mask,
     iree_task_submission_t* pending_submission);
 
 #ifdef __cplusplus
@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <memory>
+#include <string>
 
 #include "iree/base/api.h"
 #include "iree/task/submission.h"
@@ -66,7 +67,16 @@ class GridCoverage {
   std::unique_ptr<iree_atomic_int32_t[]> storage_;
 };
 
-class TaskDispatchTest : public TaskTest {
+class TaskDispatchTest
+    : public TaskTest,
+      public ::testing::WithParamInterface<
+          iree_task_dispatch_reservation_mode_t> {
+ protected:
+  void ConfigureExecutorOptions(
+      iree_task_executor_options_t* options) override {
+    options->dispatch_reservation_mode = GetParam();
+  }
+
  public:
   void DispatchAndVerifyGrid(const uint32_t workgroup_size[3],
                              const uint32_t workgroup_count[3],
@@ -84,35 +94,66 @@ class TaskDispatchTest : public TaskTest {
   }
 };
 
-TEST_F(TaskDispatchTest, Issue000) {
+TEST_P(TaskDispatchTest, Issue000) {
   IREE_TRACE_SCOPE();
   const uint32_t kWorkgroupSize[3] = {1, 1, 1};
   const uint32_t kWorkgroupCount[3] = {0, 0, 0};
   DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
 }
 
-TEST_F(TaskDispatchTest, Issue120) {
+TEST_P(TaskDispatchTest, Issue120) {
   IREE_TRACE_SCOPE();
   const uint32_t kWorkgroupSize[3] = {1, 1, 1};
   const uint32_t kWorkgroupCount[3] = {1, 2, 0};
   DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
 }
 
-TEST_F(TaskDispatchTest, Issue111) {
+TEST_P(TaskDispatchTest, Issue111) {
   IREE_TRACE_SCOPE();
   const uint32_t kWorkgroupSize[3] = {1, 1, 1};
   const uint32_t kWorkgroupCount[3] = {1, 1, 1};
   DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
 }
 
-TEST_F(TaskDispatchTest, Issue345) {
+TEST_P(TaskDispatchTest, Issue345) {
   IREE_TRACE_SCOPE();
   const uint32_t kWorkgroupSize[3] = {1, 1, 1};
   const uint32_t kWorkgroupCount[3] = {3, 4, 5};
   DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
 }
 
-TEST_F(TaskDispatchTest, IssueIndirect) {
+TEST_P(TaskDispatchTest, IssueLarge) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {1000, 37, 3};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
+}
+
+// Tests a grid where the cost of tiles varies such that reservations sized
+// from the cheap tiles would be far too large for the expensive ones.
+TEST_P(TaskDispatchTest, IssueSkewed) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {4096, 1, 1};
+  GridCoverage coverage(kWorkgroupCount);
+  auto tile = [](void* user_context,
+                 const iree_task_tile_context_t* tile_context,
+                 iree_task_submission_t* pending_submission) -> iree_status_t {
+    // The last few tiles are ~1000x more expensive than the rest.
+    if (tile_context->workgroup_xyz[0] >= 4000) {
+      iree_wait_until(iree_time_now() + 100 * 1000);
+    }
+    return GridCoverage::Tile(user_context, tile_context, pending_submission);
+  };
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(
+      &scope_, iree_task_make_dispatch_closure(tile, (void*)&coverage),
+      kWorkgroupSize, kWorkgroupCount, &task);
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  EXPECT_TRUE(coverage.Verify());
+}
+
+TEST_P(TaskDispatchTest, IssueIndirect) {
   IREE_TRACE_SCOPE();
 
   static const uint32_t kWorkgroupSize[3] = {1, 1, 1};
@@ -148,7 +189,7 @@ TEST_F(TaskDispatchTest, IssueIndirect) {
   EXPECT_TRUE(coverage.Verify());
 }
 
-TEST_F(TaskDispatchTest, IssueFailure) {
+TEST_P(TaskDispatchTest, IssueFailure) {
   IREE_TRACE_SCOPE();
 
   const uint32_t kWorkgroupSize[3] = {1, 1, 1};
@@ -172,7 +213,7 @@ TEST_F(TaskDispatchTest, IssueFailure) {
               StatusIs(StatusCode::kDataLoss));
 }
 
-TEST_F(TaskDispatchTest, IssueFailureChained) {
+TEST_P(TaskDispatchTest, IssueFailureChained) {
   IREE_TRACE_SCOPE();
 
   const uint32_t kWorkgroupSize[3] = {1, 1, 1};
@@ -213,4 +254,23 @@ TEST_F(TaskDispatchTest, IssueFailureChained) {
               StatusIs(StatusCode::kDataLoss));
 }
 
+INSTANTIATE_TEST_SUITE_P(
+    ReservationModes, TaskDispatchTest,
+    ::testing::Values(IREE_TASK_DISPATCH_RESERVATION_MODE_FIXED,
+                      IREE_TASK_DISPATCH_RESERVATION_MODE_GUIDED,
+                      IREE_TASK_DISPATCH_RESERVATION_MODE_ADAPTIVE),
+    [](const ::testing::TestParamInfo<iree_task_dispatch_reservation_mode_t>&
+           info) -> std::string {
+      switch (info.param) {
+        case IREE_TASK_DISPATCH_RESERVATION_MODE_FIXED:
+          return "Fixed";
+        case IREE_TASK_DISPATCH_RESERVATION_MODE_GUIDED:
+          return "Guided";
+        case IREE_TASK_DISPATCH_RESERVATION_MODE_ADAPTIVE:
+          return "Adaptive";
+        default:
+          return "Unknown";
+      }
+    });
+
 }  // namespace
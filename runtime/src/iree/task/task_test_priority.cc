@@ -0,0 +1,272 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdint>
+#include <memory>
+
+#include "iree/base/api.h"
+#include "iree/task/submission.h"
+#include "iree/task/task.h"
+#include "iree/task/task_impl.h"
+#include "iree/task/testing/task_test.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+class TaskPriorityTest : public TaskTest {};
+
+// Initializes |task| as a call that records the priority class it ran with.
+static void InitializeRecordingCall(iree_task_scope_t* scope,
+                                    iree_task_priority_t* out_priority,
+                                    iree_task_call_t* task) {
+  iree_task_call_initialize(
+      scope,
+      iree_task_make_call_closure(
+          [](void* user_context, iree_task_t* task,
+             iree_task_submission_t* pending_submission) {
+            *(iree_task_priority_t*)user_context = task->priority;
+            return iree_ok_status();
+          },
+          (void*)out_priority),
+      task);
+}
+
+// Tasks readied by a completed task inherit its priority class.
+TEST_F(TaskPriorityTest, CompletionTaskInherits) {
+  iree_task_priority_t priority_a = IREE_TASK_PRIORITY_LOW;
+  iree_task_priority_t priority_b = IREE_TASK_PRIORITY_LOW;
+  iree_task_call_t task_a;
+  InitializeRecordingCall(&scope_, &priority_a, &task_a);
+  iree_task_set_priority(&task_a.header, IREE_TASK_PRIORITY_HIGH);
+  iree_task_call_t task_b;
+  InitializeRecordingCall(&scope_, &priority_b, &task_b);
+  iree_task_set_completion_task(&task_a.header, &task_b.header);
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task_a.header, &task_b.header));
+  EXPECT_EQ(priority_a, IREE_TASK_PRIORITY_HIGH);
+  EXPECT_EQ(priority_b, IREE_TASK_PRIORITY_HIGH);
+}
+
+// An explicitly assigned normal priority class is kept instead of inheriting.
+TEST_F(TaskPriorityTest, AssignedNormalIsKept) {
+  iree_task_priority_t priority_a = IREE_TASK_PRIORITY_LOW;
+  iree_task_priority_t priority_b = IREE_TASK_PRIORITY_LOW;
+  iree_task_call_t task_a;
+  InitializeRecordingCall(&scope_, &priority_a, &task_a);
+  iree_task_set_priority(&task_a.header, IREE_TASK_PRIORITY_HIGH);
+  iree_task_call_t task_b;
+  InitializeRecordingCall(&scope_, &priority_b, &task_b);
+  iree_task_set_priority(&task_b.header, IREE_TASK_PRIORITY_NORMAL);
+  iree_task_set_completion_task(&task_a.header, &task_b.header);
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task_a.header, &task_b.header));
+  EXPECT_EQ(priority_a, IREE_TASK_PRIORITY_HIGH);
+  EXPECT_EQ(priority_b, IREE_TASK_PRIORITY_NORMAL);
+}
+
+// Barrier dependents inherit the class of the barrier unless assigned one.
+TEST_F(TaskPriorityTest, BarrierDependentsInherit) {
+  iree_task_priority_t priority_a = IREE_TASK_PRIORITY_NORMAL;
+  iree_task_priority_t priority_b = IREE_TASK_PRIORITY_NORMAL;
+  iree_task_priority_t priority_c = IREE_TASK_PRIORITY_NORMAL;
+  iree_task_call_t task_a;
+  InitializeRecordingCall(&scope_, &priority_a, &task_a);
+  iree_task_set_priority(&task_a.header, IREE_TASK_PRIORITY_LOW);
+  iree_task_call_t task_b;
+  InitializeRecordingCall(&scope_, &priority_b, &task_b);
+  iree_task_call_t task_c;
+  InitializeRecordingCall(&scope_, &priority_c, &task_c);
+  iree_task_set_priority(&task_c.header, IREE_TASK_PRIORITY_HIGH);
+  iree_task_t* dependent_tasks[2] = {&task_b.header, &task_c.header};
+  iree_task_barrier_t barrier;
+  iree_task_barrier_initialize(&scope_, IREE_ARRAYSIZE(dependent_tasks),
+                               dependent_tasks, &barrier);
+  iree_task_set_completion_task(&task_a.header, &barrier.header);
+  iree_task_nop_t join;
+  iree_task_nop_initialize(&scope_, &join);
+  iree_task_set_completion_task(&task_b.header, &join.header);
+  iree_task_set_completion_task(&task_c.header, &join.header);
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task_a.header, &join.header));
+  EXPECT_EQ(priority_a, IREE_TASK_PRIORITY_LOW);
+  EXPECT_EQ(priority_b, IREE_TASK_PRIORITY_LOW);
+  EXPECT_EQ(priority_c, IREE_TASK_PRIORITY_HIGH);
+}
+
+// Counts how many times each tile of a 1D dispatch has been executed.
+struct TileCounts {
+  explicit TileCounts(uint32_t tile_count)
+      : tile_count(tile_count), counts(new iree_atomic_int32_t[tile_count]) {
+    for (uint32_t i = 0; i < tile_count; ++i) {
+      counts[i] = IREE_ATOMIC_VAR_INIT(0);
+    }
+  }
+
+  static iree_status_t Tile(void* user_context,
+                            const iree_task_tile_context_t* tile_context,
+                            iree_task_submission_t* pending_submission) {
+    auto* tile_counts = (TileCounts*)user_context;
+    iree_atomic_fetch_add(&tile_counts->counts[tile_context->workgroup_xyz[0]],
+                          1, iree_memory_order_relaxed);
+    iree_atomic_fetch_add(&tile_counts->total, 1, iree_memory_order_acq_rel);
+    return iree_ok_status();
+  }
+
+  int32_t Total() {
+    return iree_atomic_load(&total, iree_memory_order_acquire);
+  }
+
+  bool AllExecutedOnce() {
+    for (uint32_t i = 0; i < tile_count; ++i) {
+      if (iree_atomic_load(&counts[i], iree_memory_order_relaxed) != 1) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  uint32_t tile_count;
+  std::unique_ptr<iree_atomic_int32_t[]> counts;
+  iree_atomic_int32_t total = IREE_ATOMIC_VAR_INIT(0);
+};
+
+// A shard stops between tile reservations while a higher priority class is
+// pending and continues where it left off when executed again.
+TEST_F(TaskPriorityTest, ShardYieldsToHigherPriority) {
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {4, 1, 1};
+  TileCounts tile_counts(kWorkgroupCount[0]);
+  iree_task_dispatch_t dispatch_task;
+  iree_task_dispatch_initialize(
+      &scope_, iree_task_make_dispatch_closure(TileCounts::Tile, &tile_counts),
+      kWorkgroupSize, kWorkgroupCount, &dispatch_task);
+
+  // Issue the dispatch as a single shard reserving one tile at a time.
+  dispatch_task.header.flags |= IREE_TASK_FLAG_DISPATCH_RETIRE;
+  dispatch_task.tile_count = kWorkgroupCount[0];
+  dispatch_task.shard_count = 1;
+  dispatch_task.reservation_mode = IREE_TASK_DISPATCH_RESERVATION_MODE_FIXED;
+  dispatch_task.tiles_per_reservation = 1;
+  iree_atomic_store(&dispatch_task.tile_index, 0, iree_memory_order_relaxed);
+  iree_task_dispatch_shard_t shard_task;
+  iree_task_dispatch_shard_initialize(&dispatch_task, &shard_task);
+
+  iree_task_submission_t pending_submission;
+  iree_task_submission_initialize(&pending_submission);
+
+  // Each execution yields after one reservation while high priority work is
+  // pending.
+  iree_atomic_int32_t pending_priority_mask =
+      IREE_ATOMIC_VAR_INIT(1 << IREE_TASK_PRIORITY_HIGH);
+  for (int32_t i = 1; i <= 2; ++i) {
+    EXPECT_FALSE(iree_task_dispatch_shard_execute(
+        &shard_task, /*processor_id=*/0, /*worker_id=*/0,
+        iree_byte_span_empty(), &pending_priority_mask, &pending_submission));
+    EXPECT_EQ(tile_counts.Total(), i);
+    EXPECT_TRUE(iree_task_submission_is_empty(&pending_submission));
+  }
+
+  // Work of the same or lower class does not preempt the shard.
+  iree_atomic_store(&pending_priority_mask,
+                    (1 << IREE_TASK_PRIORITY_NORMAL) |
+                        (1 << IREE_TASK_PRIORITY_LOW),
+                    iree_memory_order_relaxed);
+  EXPECT_TRUE(iree_task_dispatch_shard_execute(
+      &shard_task, /*processor_id=*/0, /*worker_id=*/0, iree_byte_span_empty(),
+      &pending_priority_mask, &pending_submission));
+  EXPECT_TRUE(tile_counts.AllExecutedOnce());
+
+  // Retiring the last shard readies the dispatch to retire.
+  EXPECT_EQ(pending_submission.ready_list.head, &dispatch_task.header);
+  EXPECT_FALSE(iree_task_submission_has_ready_priority_above(
+      &pending_submission, IREE_TASK_PRIORITY_NORMAL));
+  EXPECT_TRUE(iree_task_submission_has_ready_priority_above(
+      &pending_submission, IREE_TASK_PRIORITY_LOW));
+  iree_task_submission_reset(&pending_submission);
+}
+
+// A high priority task submitted while a long normal priority dispatch is
+// running on every worker runs before the dispatch completes. The preempted
+// shards are requeued and the dispatch still executes every tile once.
+TEST_F(TaskPriorityTest, DispatchPreemptedAndRequeued) {
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {4096, 1, 1};
+  // Tiles are slow enough that the dispatch runs for a while and record which
+  // workers have started executing them.
+  struct SlowTileCounts : public TileCounts {
+    using TileCounts::TileCounts;
+    static iree_status_t Tile(void* user_context,
+                              const iree_task_tile_context_t* tile_context,
+                              iree_task_submission_t* pending_submission) {
+      auto* tile_counts = (SlowTileCounts*)user_context;
+      iree_atomic_fetch_or(&tile_counts->worker_mask,
+                           1 << (tile_context->worker_id % 32),
+                           iree_memory_order_acq_rel);
+      iree_wait_until(iree_time_now() + 100 * 1000);
+      return TileCounts::Tile(user_context, tile_context, pending_submission);
+    }
+    iree_atomic_int32_t worker_mask = IREE_ATOMIC_VAR_INIT(0);
+  };
+  SlowTileCounts tile_counts(kWorkgroupCount[0]);
+  iree_task_dispatch_t dispatch_task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(SlowTileCounts::Tile, &tile_counts),
+      kWorkgroupSize, kWorkgroupCount, &dispatch_task);
+  iree_task_fence_t* dispatch_fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor_, &scope_, &dispatch_fence));
+  iree_task_set_completion_task(&dispatch_task.header, &dispatch_fence->header);
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &dispatch_task.header);
+  iree_task_executor_submit(executor_, &submission);
+  iree_task_executor_flush(executor_);
+
+  // Wait for every worker to be executing the dispatch before submitting the
+  // high priority task. A worker may not get a shard if another worker stole
+  // it so only wait for up to a quarter of the tiles.
+  const int32_t all_worker_mask =
+      (1 << iree_min(iree_task_executor_worker_count(executor_), 31)) - 1;
+  while (iree_atomic_load(&tile_counts.worker_mask,
+                          iree_memory_order_acquire) != all_worker_mask &&
+         tile_counts.Total() < (int32_t)kWorkgroupCount[0] / 4) {
+    iree_wait_until(iree_time_now() + 100 * 1000);
+  }
+
+  struct CallState {
+    TileCounts* tile_counts;
+    int32_t tiles_executed = -1;
+  } call_state = {&tile_counts};
+  iree_task_call_t call_task;
+  iree_task_call_initialize(
+      &scope_,
+      iree_task_make_call_closure(
+          [](void* user_context, iree_task_t* task,
+             iree_task_submission_t* pending_submission) {
+            auto* call_state = (CallState*)user_context;
+            call_state->tiles_executed = call_state->tile_counts->Total();
+            return iree_ok_status();
+          },
+          &call_state),
+      &call_task);
+  iree_task_set_priority(&call_task.header, IREE_TASK_PRIORITY_HIGH);
+  iree_task_fence_t* call_fence = NULL;
+  IREE_ASSERT_OK(
+      iree_task_executor_acquire_fence(executor_, &scope_, &call_fence));
+  iree_task_set_completion_task(&call_task.header, &call_fence->header);
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &call_task.header);
+  iree_task_executor_submit(executor_, &submission);
+  iree_task_executor_flush(executor_);
+
+  IREE_ASSERT_OK(
+      iree_task_scope_wait_idle(&scope_, IREE_TIME_INFINITE_FUTURE));
+  // Without preemption the task would only run once workers run out of tiles.
+  EXPECT_GE(call_state.tiles_executed, 0);
+  EXPECT_LT(call_state.tiles_executed, (int32_t)kWorkgroupCount[0] / 2);
+  EXPECT_TRUE(tile_counts.AllExecutedOnce());
+}
+
+}  // namespace
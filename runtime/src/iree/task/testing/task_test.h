@@ -23,8 +23,9 @@ class TaskTest : public ::testing::Test {
  protected:
   virtual void SetUp() {
     iree_task_executor_options_t options;
-    options.worker_local_memory_size = 64 * 1024;
     iree_task_executor_options_initialize(&options);
+    options.worker_local_memory_size = 64 * 1024;
+    ConfigureExecutorOptions(&options);
     iree_task_topology_t topology;
     iree_task_topology_initialize_from_group_count(8, &topology);
     IREE_ASSERT_OK(iree_task_executor_create(
@@ -41,6 +42,10 @@ class TaskTest : public ::testing::Test {
     iree_task_executor_release(executor_);
   }
 
+  // Allows tests to override the options used to create the executor.
+  virtual void ConfigureExecutorOptions(iree_task_executor_options_t* options) {
+  }
+
   // Submits a sequence of tasks with |head_task| at the head and |tail_task| at
   // the tail (they can be the same).
   iree_status_t SubmitTasksAndWaitIdle(iree_task_t* head_task,
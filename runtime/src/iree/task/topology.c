@@ -11,6 +11,51 @@
 
 #include "iree/base/api.h"
 
+iree_status_t iree_task_topology_select_nodes(
+    iree_string_view_t node_list, uint64_t available_node_mask,
+    iree_task_topology_node_id_t current_node_id, uint64_t* out_node_mask) {
+  IREE_ASSERT_ARGUMENT(out_node_mask);
+  *out_node_mask = 0ull;
+  if (available_node_mask == 0ull) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE, "no nodes available");
+  }
+
+  if (iree_string_view_equal(node_list, IREE_SV("current"))) {
+    // Use a single default node.
+    if (current_node_id < 64 &&
+        (available_node_mask & (1ull << current_node_id))) {
+      *out_node_mask = 1ull << current_node_id;
+    } else {
+      *out_node_mask = available_node_mask & (~available_node_mask + 1);
+    }
+    return iree_ok_status();
+  } else if (iree_string_view_equal(node_list, IREE_SV("all"))) {
+    // Use all nodes in the system.
+    *out_node_mask = available_node_mask;
+    return iree_ok_status();
+  }
+
+  // Use some subset of nodes.
+  uint64_t node_mask = 0ull;
+  iree_string_view_t remaining = node_list;
+  while (!iree_string_view_is_empty(remaining)) {
+    iree_string_view_t node_value;
+    iree_string_view_split(remaining, ',', &node_value, &remaining);
+    uint32_t node_id = 0;
+    if (!iree_string_view_atoi_uint32(node_value, &node_id)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "invalid NUMA node ID specified: '%.*s'",
+                              (int)node_value.size, node_value.data);
+    } else if (node_id >= 64 || !(available_node_mask & (1ull << node_id))) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "NUMA node ID %u is not available", node_id);
+    }
+    node_mask |= 1ull << node_id;
+  }
+  *out_node_mask = node_mask;
+  return iree_ok_status();
+}
+
 void iree_task_topology_group_initialize(
     uint8_t group_index, iree_task_topology_group_t* out_group) {
   memset(out_group, 0, sizeof(*out_group));
@@ -169,3 +214,25 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set_string(
   return iree_task_topology_initialize_from_logical_cpu_set(cpu_count, cpu_ids,
                                                             out_topology);
 }
+
+#if defined(IREE_TASK_USE_CPUINFO) || !defined(IREE_PLATFORM_LINUX) || \
+    defined(IREE_PLATFORM_EMSCRIPTEN)
+
+// Topology implementations other than sysfs cannot map processors to memory
+// nodes; everything is treated as belonging to memory node 0.
+iree_status_t iree_task_topology_initialize_from_memory_node(
+    uint32_t memory_node_id,
+    iree_task_topology_performance_level_t performance_level,
+    iree_task_topology_distribution_t distribution,
+    iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
+  if (memory_node_id != 0) {
+    iree_task_topology_initialize(out_topology);
+    return iree_ok_status();
+  }
+  return iree_task_topology_initialize_from_physical_cores(
+      IREE_TASK_TOPOLOGY_NODE_ID_ANY, performance_level, distribution,
+      max_core_count, out_topology);
+}
+
+#endif  // IREE_TASK_USE_CPUINFO || !IREE_PLATFORM_LINUX ||
+        // IREE_PLATFORM_EMSCRIPTEN
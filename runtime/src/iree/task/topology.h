@@ -37,6 +37,18 @@ iree_host_size_t iree_task_topology_query_node_count(void);
 // is not available on the platform.
 iree_task_topology_node_id_t iree_task_topology_query_current_node(void);
 
+// Selects the nodes from |available_node_mask| (bit N set for each available
+// node N below 64) that are specified by |node_list| and returns them as a
+// bitmask in |out_node_mask|. |node_list| is one of:
+//   `current`: |current_node_id| if available or the lowest available node.
+//   `all`: every available node.
+//   A comma-separated list of node IDs: each listed node; all must be
+//   available.
+// Node IDs need not be dense: memory nodes may be offline leaving holes.
+iree_status_t iree_task_topology_select_nodes(
+    iree_string_view_t node_list, uint64_t available_node_mask,
+    iree_task_topology_node_id_t current_node_id, uint64_t* out_node_mask);
+
 //===----------------------------------------------------------------------===//
 // Topology group (worker thread(s) assigned to a processor)
 //===----------------------------------------------------------------------===//
@@ -237,6 +249,25 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_distribution_t distribution,
     iree_host_size_t max_core_count, iree_task_topology_t* out_topology);
 
+// Initializes a topology with one group for each physical core that allocates
+// memory from the NUMA memory node |memory_node_id| (as reported by
+// iree_memory_query_processor_node). Otherwise behaves as
+// iree_task_topology_initialize_from_physical_cores with a node_id of
+// IREE_TASK_TOPOLOGY_NODE_ID_ANY.
+//
+// Topology node IDs are cluster/package IDs that need not match memory nodes
+// (e.g. sub-NUMA clustering splits a package into multiple memory nodes). Use
+// this when workers should be pinned next to the memory they access.
+//
+// When processors cannot be mapped to memory nodes (non-Linux platforms or
+// cpuinfo-based topologies) all cores are considered to be on memory node 0
+// and the topology for any other node is empty.
+iree_status_t iree_task_topology_initialize_from_memory_node(
+    uint32_t memory_node_id,
+    iree_task_topology_performance_level_t performance_level,
+    iree_task_topology_distribution_t distribution,
+    iree_host_size_t max_core_count, iree_task_topology_t* out_topology);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -14,6 +14,7 @@
 #define _GNU_SOURCE
 
 #include "iree/base/internal/math.h"
+#include "iree/base/internal/memory.h"
 #include "iree/task/topology.h"
 
 #if !defined(IREE_TASK_USE_CPUINFO) && defined(IREE_PLATFORM_LINUX) && \
@@ -804,8 +805,10 @@ static iree_host_size_t iree_sysfs_enumerate_cache_domains(
   return domain_count;
 }
 
-iree_status_t iree_task_topology_initialize_from_physical_cores(
-    iree_task_topology_node_id_t node_id,
+// Initializes |out_topology| with one group per physical core on the cluster
+// |node_id| and the NUMA memory node |memory_node_id|. Either may be ANY.
+static iree_status_t iree_task_topology_initialize_from_filtered_cores(
+    iree_task_topology_node_id_t node_id, uint32_t memory_node_id,
     iree_task_topology_performance_level_t performance_level,
     iree_task_topology_distribution_t distribution,
     iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
@@ -869,6 +872,12 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
       iree_status_ignore(cluster_status);
     }
 
+    // Filter by the memory node the processor allocates from.
+    if (memory_node_id != IREE_MEMORY_NODE_ID_ANY &&
+        iree_memory_query_processor_node(cpu) != memory_node_id) {
+      continue;  // Wrong memory node.
+    }
+
     // Filter by performance level on heterogeneous systems (ARM big.LITTLE).
     // On homogeneous systems or when ANY is requested, use all cores.
     if (is_heterogeneous &&
@@ -983,5 +992,34 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
   return status;
 }
 
+iree_status_t iree_task_topology_initialize_from_physical_cores(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_performance_level_t performance_level,
+    iree_task_topology_distribution_t distribution,
+    iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
+  return iree_task_topology_initialize_from_filtered_cores(
+      node_id, IREE_MEMORY_NODE_ID_ANY, performance_level, distribution,
+      max_core_count, out_topology);
+}
+
+iree_status_t iree_task_topology_initialize_from_memory_node(
+    uint32_t memory_node_id,
+    iree_task_topology_performance_level_t performance_level,
+    iree_task_topology_distribution_t distribution,
+    iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
+  if (iree_memory_query_node_count() <= 1 &&
+      iree_memory_query_processor_node(0) == IREE_MEMORY_NODE_ID_ANY) {
+    // No NUMA information (kernel without CONFIG_NUMA); everything is node 0.
+    if (memory_node_id != 0) {
+      iree_task_topology_initialize(out_topology);
+      return iree_ok_status();
+    }
+    memory_node_id = IREE_MEMORY_NODE_ID_ANY;
+  }
+  return iree_task_topology_initialize_from_filtered_cores(
+      IREE_TASK_TOPOLOGY_NODE_ID_ANY, memory_node_id, performance_level,
+      distribution, max_core_count, out_topology);
+}
+
 #endif  // !IREE_TASK_USE_CPUINFO && IREE_PLATFORM_LINUX &&
         // !IREE_PLATFORM_EMSCRIPTEN
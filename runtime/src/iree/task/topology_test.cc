@@ -8,11 +8,14 @@
 
 #include <cstddef>
 
+#include "iree/base/internal/memory.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
 namespace {
 
+using iree::Status;
+using iree::StatusCode;
 using namespace iree::testing::status;
 
 TEST(TopologyTest, Lifetime) {
@@ -145,4 +148,90 @@ TEST(TopologyTest, FromPhysicalCores) {
   iree_task_topology_deinitialize(&topology);
 }
 
+// Nodes 1 and 3 are available with 0 and 2 offline.
+static constexpr uint64_t kSparseNodeMask = 0xAull;
+
+static uint64_t SelectNodes(const char* node_list, uint64_t available_node_mask,
+                            iree_task_topology_node_id_t current_node_id) {
+  uint64_t node_mask = 0;
+  IREE_CHECK_OK(iree_task_topology_select_nodes(
+      iree_make_cstring_view(node_list), available_node_mask, current_node_id,
+      &node_mask));
+  return node_mask;
+}
+
+TEST(TopologyTest, SelectNodesCurrent) {
+  EXPECT_EQ(SelectNodes("current", kSparseNodeMask, 3), 0x8ull);
+  // Nodes that are not available fall back to the lowest available node.
+  EXPECT_EQ(SelectNodes("current", kSparseNodeMask, 0), 0x2ull);
+  EXPECT_EQ(SelectNodes("current", kSparseNodeMask, 64), 0x2ull);
+  EXPECT_EQ(SelectNodes("current", kSparseNodeMask,
+                        IREE_TASK_TOPOLOGY_NODE_ID_ANY),
+            0x2ull);
+}
+
+TEST(TopologyTest, SelectNodesAll) {
+  EXPECT_EQ(SelectNodes("all", kSparseNodeMask, 1), kSparseNodeMask);
+  EXPECT_EQ(SelectNodes("all", UINT64_MAX, 0), UINT64_MAX);
+}
+
+TEST(TopologyTest, SelectNodesList) {
+  EXPECT_EQ(SelectNodes("3", kSparseNodeMask, 1), 0x8ull);
+  EXPECT_EQ(SelectNodes("1,3", kSparseNodeMask, 1), kSparseNodeMask);
+}
+
+TEST(TopologyTest, SelectNodesInvalid) {
+  uint64_t node_mask = 0;
+  // Offline nodes below the highest online node.
+  EXPECT_THAT(Status(iree_task_topology_select_nodes(
+                  IREE_SV("2"), kSparseNodeMask, 1, &node_mask)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(Status(iree_task_topology_select_nodes(
+                  IREE_SV("1,0"), kSparseNodeMask, 1, &node_mask)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(Status(iree_task_topology_select_nodes(
+                  IREE_SV("64"), UINT64_MAX, 0, &node_mask)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(Status(iree_task_topology_select_nodes(
+                  IREE_SV("x"), kSparseNodeMask, 1, &node_mask)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+// Every system has memory node 0 (all cores are on it when processors cannot
+// be mapped to memory nodes).
+TEST(TopologyTest, FromMemoryNode) {
+  static constexpr iree_host_size_t kMaxGroupCount = 4;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  IREE_ASSERT_OK(iree_task_topology_initialize_from_memory_node(
+      /*memory_node_id=*/0, IREE_TASK_TOPOLOGY_PERFORMANCE_LEVEL_ANY,
+      IREE_TASK_TOPOLOGY_DISTRIBUTION_SCATTER, kMaxGroupCount, &topology));
+  EnsureTopologyValid(kMaxGroupCount, &topology);
+  for (iree_host_size_t i = 0; i < iree_task_topology_group_count(&topology);
+       ++i) {
+    const uint32_t node_id = iree_memory_query_processor_node(
+        iree_task_topology_get_group(&topology, i)->processor_index);
+    if (node_id != IREE_MEMORY_NODE_ID_ANY) EXPECT_EQ(node_id, 0u);
+  }
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Memory nodes that are not online have no cores.
+TEST(TopologyTest, FromMemoryNodeOffline) {
+  const uint64_t online_node_mask = iree_memory_query_node_mask();
+  uint32_t offline_node_id = 0;
+  while (offline_node_id < 64 &&
+         (online_node_mask & (1ull << offline_node_id))) {
+    ++offline_node_id;
+  }
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  IREE_ASSERT_OK(iree_task_topology_initialize_from_memory_node(
+      offline_node_id, IREE_TASK_TOPOLOGY_PERFORMANCE_LEVEL_ANY,
+      IREE_TASK_TOPOLOGY_DISTRIBUTION_SCATTER, /*max_core_count=*/4,
+      &topology));
+  EXPECT_EQ(iree_task_topology_group_count(&topology), 0);
+  iree_task_topology_deinitialize(&topology);
+}
+
 }  // namespace
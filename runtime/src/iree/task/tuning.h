@@ -94,6 +94,41 @@ extern "C" {
 // memory).
 #define IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION (8)
 
+// Maximum number of tiles a single reservation may take when the reservation
+// size is chosen dynamically (IREE_TASK_DISPATCH_RESERVATION_MODE_GUIDED and
+// IREE_TASK_DISPATCH_RESERVATION_MODE_ADAPTIVE). Bounds the amount of work a
+// shard may hold that other shards can no longer help with.
+#define IREE_TASK_DISPATCH_MAX_TILES_PER_DYNAMIC_RESERVATION (256)
+
+// Divisor applied to the remaining tiles per shard when sizing guided
+// reservations. A divisor of 2 has each reservation take at most half of the
+// fair share of remaining tiles per shard so that the reservations taken last
+// are small enough for the other shards to balance out.
+#define IREE_TASK_DISPATCH_GUIDED_RESERVATION_DIVISOR (2)
+
+// Target duration of each reservation in
+// IREE_TASK_DISPATCH_RESERVATION_MODE_ADAPTIVE. Shards measure the latency of
+// the tiles they execute and reserve as many tiles as are expected to complete
+// in this time. Longer durations reduce contention on the dispatch tile counter
+// and shorter durations reduce the time a shard may hold onto tiles that idle
+// workers could otherwise be running.
+#define IREE_TASK_DISPATCH_ADAPTIVE_RESERVATION_DURATION_NS (50 * 1000)
+
+// Maximum duration workers spin waiting for more work when using
+// IREE_TASK_WORKER_IDLE_MODE_ADAPTIVE and no explicit worker_spin_ns bound was
+// provided. Beyond this it's almost always cheaper to pay for the wake.
+#define IREE_TASK_WORKER_ADAPTIVE_MAX_SPIN_NS (200 * 1000)
+
+// Multiple of the average interval between executor submissions that workers
+// spin for in IREE_TASK_WORKER_IDLE_MODE_ADAPTIVE. Values above 1 let workers
+// catch submissions that arrive a bit late without having to sleep.
+#define IREE_TASK_WORKER_ADAPTIVE_SPIN_INTERVAL_SCALE (2)
+
+// log2 of the smoothing factor applied to the moving average of the intervals
+// between executor submissions. 3 weights each new interval by 1/8 so that a
+// single outlier (a stall in the host program) doesn't disable spinning.
+#define IREE_TASK_WORKER_ADAPTIVE_INTERVAL_SMOOTHING_SHIFT (3)
+
 // Whether to enable per-tile colors for each tile tracing zone based on the
 // tile grid xyz. Not cheap and can be disabled to reduce tracing overhead.
 // TODO(#4017): make per-tile color tracing fast enough to always have on.
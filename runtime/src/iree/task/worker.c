@@ -45,6 +45,8 @@ iree_status_t iree_task_worker_initialize(
   iree_notification_initialize(&out_worker->wake_notification);
   iree_notification_initialize(&out_worker->state_notification);
   iree_atomic_task_slist_initialize(&out_worker->mailbox_slist);
+  iree_atomic_store(&out_worker->pending_priority_mask, 0,
+                    iree_memory_order_relaxed);
   iree_task_queue_initialize(&out_worker->local_task_queue);
 
   iree_task_worker_state_t initial_state = IREE_TASK_WORKER_STATE_RUNNING;
@@ -128,10 +130,9 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker) {
   worker->thread = NULL;
 
   // Release unfinished tasks by flushing the mailbox (which if we're here can't
-  // get anything more posted to it) and then discarding everything we still
-  // have a reference to.
+  // get anything more posted to it). The local task queue discards everything
+  // we still have a reference to when it is deinitialized below.
   iree_atomic_task_slist_discard(&worker->mailbox_slist);
-  iree_task_list_discard(&worker->local_task_queue.list);
 
   iree_notification_deinitialize(&worker->wake_notification);
   iree_notification_deinitialize(&worker->state_notification);
@@ -176,8 +177,19 @@ void iree_task_worker_post_tasks(iree_task_worker_t* worker,
                                  iree_task_list_t* list) {
   // Move the list into the mailbox. Note that the mailbox is LIFO and this list
   // is concatenated with its current order preserved (which should be LIFO).
+  int32_t priority_mask = 0;
+  for (iree_task_t* task = list->head; task; task = task->next_task) {
+    priority_mask |= 1 << task->priority;
+  }
   iree_atomic_task_slist_concat(&worker->mailbox_slist, list->head, list->tail);
   memset(list, 0, sizeof(*list));
+
+  // Publish the priorities only after the tasks are in the mailbox so that a
+  // worker observing the mask is guaranteed to find them when it flushes. A
+  // racing flush may pick up the tasks before the mask is set; this only
+  // causes a spurious flush on the next tile and never a missed preemption.
+  iree_atomic_fetch_or(&worker->pending_priority_mask, priority_mask,
+                       iree_memory_order_release);
 }
 
 iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
@@ -209,16 +221,21 @@ static void iree_task_worker_execute(
   // TODO(benvanik): think a bit more about this timing; this ensures we have
   // BFS behavior at the cost of the additional merge overhead - it's probably
   // worth it?
-  // TODO(benvanik): handle partial tasks and re-queuing.
   switch (task->type) {
     case IREE_TASK_TYPE_CALL: {
       iree_task_call_execute((iree_task_call_t*)task, pending_submission);
       break;
     }
     case IREE_TASK_TYPE_DISPATCH_SHARD: {
-      iree_task_dispatch_shard_execute(
-          (iree_task_dispatch_shard_t*)task, worker->processor_id,
-          worker->worker_index, worker->local_memory, pending_submission);
+      if (!iree_task_dispatch_shard_execute(
+              (iree_task_dispatch_shard_t*)task, worker->processor_id,
+              worker->worker_index, worker->local_memory,
+              &worker->pending_priority_mask, pending_submission)) {
+        // Preempted by higher priority work posted to the mailbox; requeue
+        // the shard so that it resumes tile reservation once that work has
+        // been processed. Other workers may steal it in the meantime.
+        iree_task_queue_push_front(&worker->local_task_queue, task);
+      }
       break;
     }
     default:
@@ -237,10 +254,23 @@ static bool iree_task_worker_pump_once(
     iree_task_worker_t* worker, iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // If higher priority tasks have been posted to the mailbox since we last
+  // flushed it then move them into the local queue first so that they are
+  // ordered ahead of the tasks we already have. The local queue pops from the
+  // highest priority class available.
+  iree_task_t* task = NULL;
+  if (iree_atomic_load(&worker->pending_priority_mask,
+                       iree_memory_order_relaxed)) {
+    iree_atomic_exchange(&worker->pending_priority_mask, 0,
+                         iree_memory_order_acquire);
+    task = iree_task_queue_flush_from_lifo_slist(&worker->local_task_queue,
+                                                 &worker->mailbox_slist);
+  }
+
   // Check the local work queue for any work we know we should start
   // processing immediately. Other workers may try to steal some of this work
   // if we take too long.
-  iree_task_t* task = iree_task_queue_pop_front(&worker->local_task_queue);
+  if (!task) task = iree_task_queue_pop_front(&worker->local_task_queue);
 
   // Check the mailbox to see if we have incoming work that has been posted.
   // We try to greedily move it to our local work list so that we can work
@@ -297,6 +327,11 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
   // be able to process it with the proper processor ID immediately.
   iree_task_worker_update_processor_id(worker);
 
+  // Progress through the idle phases (spin -> yield -> sleep) since the worker
+  // last found work. See iree_task_worker_idle_mode_t.
+  bool idle_spun = false;
+  uint32_t idle_yield_count = 0;
+
   // Pump the thread loop to process more tasks.
   while (true) {
     // If we fail to find any work to do we'll wait at the end of this loop.
@@ -325,8 +360,22 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
     iree_task_submission_t pending_submission;
     iree_task_submission_initialize(&pending_submission);
 
+    bool did_work = false;
     while (iree_task_worker_pump_once(worker, &pending_submission)) {
       // All work done ^, which will return false when the worker should wait.
+      did_work = true;
+
+      // Tasks readied by high priority work (fences signaling completion,
+      // dependent dispatches, etc) would otherwise wait in the pending
+      // submission until this worker runs out of lower priority work. Hand
+      // them to the executor immediately so that they are scheduled without
+      // that delay.
+      if (iree_task_submission_has_ready_priority_above(
+              &pending_submission, IREE_TASK_PRIORITY_NORMAL)) {
+        iree_task_executor_merge_submission(worker->executor,
+                                            &pending_submission);
+        iree_task_executor_coordinate(worker->executor, worker);
+      }
     }
 
     bool schedule_dirty = false;
@@ -335,6 +384,11 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
                                           &pending_submission);
       schedule_dirty = true;
     }
+    if (did_work || schedule_dirty) {
+      // Found work so the next time we run out we start over from spinning.
+      idle_spun = false;
+      idle_yield_count = 0;
+    }
 
     // We've finished all the work we have scheduled so set our idle flag.
     // This ensures that if any other thread comes in and wants to give us
@@ -358,16 +412,38 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
         !iree_task_queue_is_empty(&worker->local_task_queue)) {
       // Have more work to do; loop around to try another pump.
       iree_notification_cancel_wait(&worker->wake_notification);
+      continue;
+    }
+
+    iree_duration_t spin_ns = IREE_DURATION_ZERO;
+    if (!idle_spun) {
+      idle_spun = true;
+      spin_ns = iree_task_executor_worker_spin_duration(worker->executor);
+    }
+    if (spin_ns != IREE_DURATION_ZERO) {
+      // Spin on the notification without entering the kernel. Whether or not
+      // we were posted we loop around and recheck everything as work may also
+      // arrive from coordination or theft.
+      iree_notification_commit_wait(&worker->wake_notification, wait_token,
+                                    spin_ns,
+                                    /*deadline_ns=*/IREE_TIME_INFINITE_PAST);
+    } else if (idle_yield_count < worker->executor->worker_yield_count) {
+      // Give up the rest of our timeslice but stay runnable so that we'll
+      // recheck for work without paying for a wake.
+      ++idle_yield_count;
+      iree_notification_cancel_wait(&worker->wake_notification);
+      iree_thread_yield();
     } else {
-      // Spin/wait in the kernel. We don't care if the condition fails as we're
-      // just using it as a pulse.
+      // Wait in the kernel. We don't care if the condition fails as we're just
+      // using it as a pulse.
       IREE_TRACE_ZONE_BEGIN_NAMED(z_wait,
                                   "iree_task_worker_main_pump_wake_wait");
-      iree_notification_commit_wait(
-          &worker->wake_notification, wait_token,
-          /*spin_ns=*/worker->executor->worker_spin_ns,
-          /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
+      iree_notification_commit_wait(&worker->wake_notification, wait_token,
+                                    /*spin_ns=*/IREE_DURATION_ZERO,
+                                    /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
       IREE_TRACE_ZONE_END(z_wait);
+      idle_spun = false;
+      idle_yield_count = 0;
 
       // Woke from a wait - query the processor ID in case we migrated during
       // the sleep.
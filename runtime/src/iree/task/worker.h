@@ -63,6 +63,14 @@ typedef struct iree_task_worker_t {
   // LAYOUT: must be 64b away from local_task_queue.
   iree_atomic_task_slist_t mailbox_slist;
 
+  // Bitmask of 1 << iree_task_priority_t for each priority class of task that
+  // has been posted to mailbox_slist since the worker last flushed it. Running
+  // dispatch shards check this between tiles and yield if a higher priority
+  // task is waiting such that latency-sensitive work is not stuck behind a
+  // long-running dispatch.
+  // LAYOUT: next to mailbox_slist as posters touch both.
+  iree_atomic_int32_t pending_priority_mask;
+
   // Current state of the worker (iree_task_worker_state_t).
   // LAYOUT: frequent access; next to wake_notification as they are always
   //         accessed together.
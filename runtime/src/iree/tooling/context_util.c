@@ -7,6 +7,7 @@
 #include "iree/tooling/context_util.h"
 
 #include <memory.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "iree/base/internal/flags.h"
@@ -14,6 +15,7 @@
 #include "iree/hal/local/loaders/registration/init.h"
 #include "iree/hal/local/plugins/registration/init.h"
 #include "iree/io/file_contents.h"
+#include "iree/io/file_handle.h"
 #include "iree/modules/hal/inline/module.h"
 #include "iree/modules/hal/loader/module.h"
 #include "iree/modules/hal/module.h"
@@ -43,6 +45,22 @@ IREE_FLAG(
     "        warm-up time and variance as mapped pages are swapped\n"
     "        by the OS.");
 
+IREE_FLAG(
+    bool, module_prefer_native, false,
+    "Loads a native module from a system library next to each vmfb when one\n"
+    "exists (`foo.so` next to `foo.vmfb`) instead of interpreting the\n"
+    "bytecode module. The library is built from the C module of the same\n"
+    "program compiled with `--output-format=vm-c\n"
+    "--iree-vm-c-module-dynamic-export`.");
+
+#if defined(IREE_PLATFORM_WINDOWS)
+#define IREE_TOOLING_DYNAMIC_LIBRARY_EXTENSION "dll"
+#elif defined(IREE_PLATFORM_APPLE)
+#define IREE_TOOLING_DYNAMIC_LIBRARY_EXTENSION "dylib"
+#else
+#define IREE_TOOLING_DYNAMIC_LIBRARY_EXTENSION "so"
+#endif  // IREE_PLATFORM_*
+
 static iree_status_t iree_tooling_load_bytecode_module(
     iree_vm_instance_t* instance, iree_string_view_t path,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module) {
@@ -115,6 +133,47 @@ static iree_status_t iree_tooling_load_dynamic_module(
   return status;
 }
 
+// Loads the native module compiled ahead-of-time for the bytecode module at
+// |path| if a system library with the same stem exists next to it.
+// Returns OK with |out_module| set to NULL if no library exists.
+static iree_status_t iree_tooling_try_load_native_module(
+    iree_vm_instance_t* instance, iree_string_view_t path,
+    iree_allocator_t host_allocator, iree_vm_module_t** out_module) {
+  *out_module = NULL;
+  if (iree_string_view_equal(path, IREE_SV("-"))) return iree_ok_status();
+
+  // foo/bar.vmfb -> foo/bar.so. Relative paths without a directory are
+  // prefixed so that the system loader doesn't search its library paths.
+  iree_string_view_t dirname = iree_file_path_dirname(path);
+  iree_string_view_t stem = iree_file_path_stem(path);
+  char library_path[2048];
+  int library_path_length = snprintf(
+      library_path, sizeof(library_path), "%.*s/%.*s.%s",
+      iree_string_view_is_empty(dirname) ? 1 : (int)dirname.size,
+      iree_string_view_is_empty(dirname) ? "." : dirname.data, (int)stem.size,
+      stem.data, IREE_TOOLING_DYNAMIC_LIBRARY_EXTENSION);
+  if (library_path_length < 0 ||
+      library_path_length >= (int)sizeof(library_path)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "module path too long: '%.*s'", (int)path.size,
+                            path.data);
+  }
+
+  // Only fall back to bytecode if the library does not exist; any failure
+  // loading a library that is present is reported.
+  iree_io_file_handle_t* file_handle = NULL;
+  iree_status_t status = iree_io_file_handle_open(
+      IREE_IO_FILE_MODE_READ, iree_make_cstring_view(library_path),
+      host_allocator, &file_handle);
+  if (iree_status_is_not_found(status)) return iree_status_ignore(status);
+  IREE_RETURN_IF_ERROR(status);
+  iree_io_file_handle_release(file_handle);
+
+  return iree_tooling_load_dynamic_module(
+      instance, iree_make_cstring_view(library_path), iree_string_view_empty(),
+      iree_string_view_empty(), host_allocator, out_module);
+}
+
 iree_status_t iree_tooling_load_modules_from_flags(
     iree_vm_instance_t* instance, iree_allocator_t host_allocator,
     iree_tooling_module_list_t* list) {
@@ -148,11 +207,20 @@ iree_status_t iree_tooling_load_modules_from_flags(
                                            host_allocator, &module),
           "loading dynamic module at '%.*s'", (int)path.size, path.data);
     } else {
-      IREE_RETURN_AND_END_ZONE_IF_ERROR(
-          z0,
-          iree_tooling_load_bytecode_module(instance, path, host_allocator,
-                                            &module),
-          "loading bytecode module at '%.*s'", (int)path.size, path.data);
+      if (FLAG_module_prefer_native) {
+        IREE_RETURN_AND_END_ZONE_IF_ERROR(
+            z0,
+            iree_tooling_try_load_native_module(instance, path, host_allocator,
+                                                &module),
+            "loading native module for '%.*s'", (int)path.size, path.data);
+      }
+      if (!module) {
+        IREE_RETURN_AND_END_ZONE_IF_ERROR(
+            z0,
+            iree_tooling_load_bytecode_module(instance, path, host_allocator,
+                                              &module),
+            "loading bytecode module at '%.*s'", (int)path.size, path.data);
+      }
     }
 
     // Store loaded module in the list. It'll be the caller's responsibility to
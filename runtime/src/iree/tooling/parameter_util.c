@@ -24,6 +24,15 @@ IREE_FLAG(
     "  preload: read entire parameter files into wired memory on startup.\n"
     "  file: uses platform file APIs to read/write the file as needed.");
 
+IREE_FLAG(
+    bool, parameter_map_files, false,
+    "Imports memory mappings of parameter files directly on devices whose\n"
+    "memory is host memory (local-sync/local-task) instead of allocating\n"
+    "and reading into new buffers.");
+
+IREE_FLAG(bool, parameter_large_pages, false,
+          "Requests large pages for parameter files mapped for import.");
+
 // Opens the parameter file at |path| with the mode specified by the
 // --parameter_mode flag and returns its handle.
 static iree_status_t iree_io_open_parameter_file(
@@ -141,12 +150,19 @@ iree_status_t iree_tooling_create_parameters_module_from_flags(
   iree_io_parameter_provider_t** providers =
       (iree_io_parameter_provider_t**)iree_alloca(
           scope_map.count * sizeof(iree_io_parameter_provider_t*));
+  iree_io_parameter_index_provider_options_t provider_options;
+  iree_io_parameter_index_provider_options_initialize(&provider_options);
+  if (FLAG_parameter_map_files) {
+    provider_options.flags |= IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_MAP_FILES;
+  }
+  if (FLAG_parameter_large_pages) {
+    provider_options.flags |= IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_LARGE_PAGES;
+  }
   if (iree_status_is_ok(status)) {
     for (iree_host_size_t i = 0; i < scope_map.count; ++i) {
-      status = iree_io_parameter_index_provider_create(
+      status = iree_io_parameter_index_provider_create_with_options(
           scope_map.entries[i]->scope, scope_map.entries[i]->index,
-          IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS,
-          host_allocator, &providers[i]);
+          &provider_options, host_allocator, &providers[i]);
       if (!iree_status_is_ok(status)) break;
       ++provider_count;
     }
@@ -1692,6 +1692,8 @@ iree_status_t iree_vm_bytecode_disassemble_op(
     }
 
     DISASM_OP(CORE, Call) {
+      // Entry for the GlobalLoadRefCall superinstruction.
+    disasm_fused_Call:;
       int32_t function_ordinal = VM_ParseFuncAttr("callee");
       const iree_vm_register_list_t* src_reg_list =
           VM_ParseVariadicOperands("operands");
@@ -1736,6 +1738,8 @@ iree_status_t iree_vm_bytecode_disassemble_op(
     }
 
     DISASM_OP(CORE, CallVariadic) {
+      // Entry for the GlobalLoadRefCallVariadic superinstruction.
+    disasm_fused_CallVariadic:;
       int32_t function_ordinal = VM_ParseFuncAttr("callee");
       // TODO(benvanik): print segment sizes.
       // const iree_vm_register_list_t* segment_size_list =
@@ -1900,6 +1904,103 @@ iree_status_t iree_vm_bytecode_disassemble_op(
       break;
     }
 
+    //===------------------------------------------------------------------===//
+    // Superinstructions
+    //===------------------------------------------------------------------===//
+    // Fused ops are printed as the sequence of ops they replace.
+
+#define DISASM_OP_CORE_CMP_COND_BRANCH(op_name, operand_type, op_mnemonic)  \
+  DISASM_OP(CORE, op_name) {                                                \
+    uint16_t lhs_reg = VM_ParseOperandReg##operand_type("lhs");             \
+    uint16_t rhs_reg = VM_ParseOperandReg##operand_type("rhs");             \
+    uint16_t result_reg = VM_ParseResultRegI32("result");                   \
+    int32_t true_block_pc = VM_ParseBranchTarget("true_dest");              \
+    const iree_vm_register_remap_list_t* true_remap_list =                  \
+        VM_ParseBranchOperands("true_operands");                            \
+    int32_t false_block_pc = VM_ParseBranchTarget("false_dest");            \
+    const iree_vm_register_remap_list_t* false_remap_list =                 \
+        VM_ParseBranchOperands("false_operands");                           \
+    EMIT_I32_REG_NAME(result_reg);                                          \
+    IREE_RETURN_IF_ERROR(                                                   \
+        iree_string_builder_append_format(b, " = %s ", op_mnemonic));       \
+    EMIT_##operand_type##_REG_NAME(lhs_reg);                                \
+    EMIT_OPTIONAL_VALUE_##operand_type(regs->i32[lhs_reg]);                 \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ", "));      \
+    EMIT_##operand_type##_REG_NAME(rhs_reg);                                \
+    EMIT_OPTIONAL_VALUE_##operand_type(regs->i32[rhs_reg]);                 \
+    IREE_RETURN_IF_ERROR(                                                   \
+        iree_string_builder_append_cstring(b, "; vm.cond_br "));            \
+    EMIT_I32_REG_NAME(result_reg);                                          \
+    IREE_RETURN_IF_ERROR(                                                   \
+        iree_string_builder_append_format(b, ", ^%08X(", true_block_pc));   \
+    EMIT_REMAP_LIST(true_remap_list);                                       \
+    IREE_RETURN_IF_ERROR(                                                   \
+        iree_string_builder_append_format(b, "), ^%08X(", false_block_pc)); \
+    EMIT_REMAP_LIST(false_remap_list);                                      \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ")"));       \
+    break;                                                                  \
+  }
+
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpEQI32CondBranch, I32, "vm.cmp.eq.i32");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpNEI32CondBranch, I32, "vm.cmp.ne.i32");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpLTI32SCondBranch, I32,
+                                   "vm.cmp.lt.i32.s");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpLTI32UCondBranch, I32,
+                                   "vm.cmp.lt.i32.u");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpEQI64CondBranch, I64, "vm.cmp.eq.i64");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpNEI64CondBranch, I64, "vm.cmp.ne.i64");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpLTI64SCondBranch, I64,
+                                   "vm.cmp.lt.i64.s");
+    DISASM_OP_CORE_CMP_COND_BRANCH(CmpLTI64UCondBranch, I64,
+                                   "vm.cmp.lt.i64.u");
+
+    DISASM_OP(CORE, AddI32Imm) {
+      uint16_t lhs_reg = VM_ParseOperandRegI32("lhs");
+      int32_t rhs = VM_ParseAttrI32("rhs");
+      uint16_t result_reg = VM_ParseResultRegI32("result");
+      EMIT_I32_REG_NAME(result_reg);
+      IREE_RETURN_IF_ERROR(
+          iree_string_builder_append_cstring(b, " = vm.add.i32 "));
+      EMIT_I32_REG_NAME(lhs_reg);
+      EMIT_OPTIONAL_VALUE_I32(regs->i32[lhs_reg]);
+      IREE_RETURN_IF_ERROR(iree_string_builder_append_format(b, ", %d", rhs));
+      break;
+    }
+
+    DISASM_OP(CORE, AddI64Imm) {
+      uint16_t lhs_reg = VM_ParseOperandRegI64("lhs");
+      int64_t rhs = VM_ParseAttrI64("rhs");
+      uint16_t result_reg = VM_ParseResultRegI64("result");
+      EMIT_I64_REG_NAME(result_reg);
+      IREE_RETURN_IF_ERROR(
+          iree_string_builder_append_cstring(b, " = vm.add.i64 "));
+      EMIT_I64_REG_NAME(lhs_reg);
+      EMIT_OPTIONAL_VALUE_I64(regs->i32[lhs_reg]);
+      IREE_RETURN_IF_ERROR(
+          iree_string_builder_append_format(b, ", %" PRId64, rhs));
+      break;
+    }
+
+#define DISASM_OP_CORE_GLOBAL_LOAD_REF_CALL(op_name, call_op_name)        \
+  DISASM_OP(CORE, op_name) {                                              \
+    uint32_t global = VM_ParseGlobalAttr("global");                       \
+    const iree_vm_type_def_t type_def = VM_ParseTypeOf("value");          \
+    bool result_is_move;                                                  \
+    uint16_t result_reg = VM_ParseResultRegRef("value", &result_is_move); \
+    EMIT_REF_REG_NAME(result_reg);                                        \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(               \
+        b, " = vm.global.load.ref .refs[%u]", global));                   \
+    EMIT_OPTIONAL_VALUE_REF(&module_state->global_ref_table[global]);     \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, " : !"));  \
+    EMIT_TYPE_NAME(type_def);                                             \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, "; "));    \
+    goto disasm_fused_##call_op_name;                                     \
+  }
+
+    DISASM_OP_CORE_GLOBAL_LOAD_REF_CALL(GlobalLoadRefCall, Call);
+    DISASM_OP_CORE_GLOBAL_LOAD_REF_CALL(GlobalLoadRefCallVariadic,
+                                        CallVariadic);
+
     //===------------------------------------------------------------------===//
     // Extension trampolines
     //===------------------------------------------------------------------===//
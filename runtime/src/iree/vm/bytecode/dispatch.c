@@ -1635,27 +1635,32 @@ static iree_status_t iree_vm_bytecode_dispatch(
       }
     });
 
+// Decodes the true and false branch targets and jumps to one of them based on
+// |condition|, remapping the registers of the taken branch.
+#define DISPATCH_COND_BRANCH(condition)                                    \
+  int32_t true_block_pc = VM_DecBranchTarget("true_dest");                 \
+  const iree_vm_register_remap_list_t* true_remap_list =                   \
+      VM_DecBranchOperands("true_operands");                               \
+  int32_t false_block_pc = VM_DecBranchTarget("false_dest");               \
+  const iree_vm_register_remap_list_t* false_remap_list =                  \
+      VM_DecBranchOperands("false_operands");                              \
+  if (condition) {                                                         \
+    pc = true_block_pc + IREE_VM_BLOCK_MARKER_SIZE; /* skip marker */      \
+    if (IREE_UNLIKELY(true_remap_list->size > 0)) {                        \
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs_i32, regs_ref, \
+                                                       true_remap_list);   \
+    }                                                                      \
+  } else {                                                                 \
+    pc = false_block_pc + IREE_VM_BLOCK_MARKER_SIZE; /* skip marker */     \
+    if (IREE_UNLIKELY(false_remap_list->size > 0)) {                       \
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs_i32, regs_ref, \
+                                                       false_remap_list);  \
+    }                                                                      \
+  }
+
     DISPATCH_OP(CORE, CondBranch, {
       int32_t condition = VM_DecOperandRegI32("condition");
-      int32_t true_block_pc = VM_DecBranchTarget("true_dest");
-      const iree_vm_register_remap_list_t* true_remap_list =
-          VM_DecBranchOperands("true_operands");
-      int32_t false_block_pc = VM_DecBranchTarget("false_dest");
-      const iree_vm_register_remap_list_t* false_remap_list =
-          VM_DecBranchOperands("false_operands");
-      if (condition) {
-        pc = true_block_pc + IREE_VM_BLOCK_MARKER_SIZE;  // skip block marker
-        if (IREE_UNLIKELY(true_remap_list->size > 0)) {
-          iree_vm_bytecode_dispatch_remap_branch_registers(regs_i32, regs_ref,
-                                                           true_remap_list);
-        }
-      } else {
-        pc = false_block_pc + IREE_VM_BLOCK_MARKER_SIZE;  // skip block marker
-        if (IREE_UNLIKELY(false_remap_list->size > 0)) {
-          iree_vm_bytecode_dispatch_remap_branch_registers(regs_i32, regs_ref,
-                                                           false_remap_list);
-        }
-      }
+      DISPATCH_COND_BRANCH(condition);
     });
 
     DISPATCH_OP(CORE, BranchTable, {
@@ -1690,6 +1695,7 @@ static iree_status_t iree_vm_bytecode_dispatch(
     });
 
     DISPATCH_OP(CORE, Call, {
+      DISPATCH_FUSED_ENTRY(CORE, Call);
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* src_reg_list =
           VM_DecVariadicOperands("operands");
@@ -1728,6 +1734,7 @@ static iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP(CORE, CallVariadic, {
       // TODO(benvanik): dedupe with above or merge and always have the seg size
       // list be present (but empty) for non-variadic calls.
+      DISPATCH_FUSED_ENTRY(CORE, CallVariadic);
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* segment_size_list =
           VM_DecVariadicOperands("segment_sizes");
@@ -1878,6 +1885,75 @@ static iree_status_t iree_vm_bytecode_dispatch(
       pc = block_pc + IREE_VM_BLOCK_MARKER_SIZE;  // skip block marker
     });
 
+    //===------------------------------------------------------------------===//
+    // Superinstructions
+    //===------------------------------------------------------------------===//
+    // Fused op sequences emitted by the compiler. Each decodes the same
+    // operands as the ops it replaces but keeps intermediate values in locals
+    // instead of round-tripping them through the register file.
+
+#define DISPATCH_OP_CORE_CMP_COND_BRANCH(op_name, type, dec_operand, op_func) \
+  DISPATCH_OP(CORE, op_name, {                                                \
+    type lhs = dec_operand("lhs");                                            \
+    type rhs = dec_operand("rhs");                                            \
+    int32_t* result = VM_DecResultRegI32("result");                           \
+    int32_t condition = op_func(lhs, rhs);                                    \
+    *result = condition;                                                      \
+    DISPATCH_COND_BRANCH(condition);                                          \
+  });
+
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpEQI32CondBranch, int32_t,
+                                     VM_DecOperandRegI32, vm_cmp_eq_i32);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpNEI32CondBranch, int32_t,
+                                     VM_DecOperandRegI32, vm_cmp_ne_i32);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpLTI32SCondBranch, int32_t,
+                                     VM_DecOperandRegI32, vm_cmp_lt_i32s);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpLTI32UCondBranch, int32_t,
+                                     VM_DecOperandRegI32, vm_cmp_lt_i32u);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpEQI64CondBranch, int64_t,
+                                     VM_DecOperandRegI64, vm_cmp_eq_i64);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpNEI64CondBranch, int64_t,
+                                     VM_DecOperandRegI64, vm_cmp_ne_i64);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpLTI64SCondBranch, int64_t,
+                                     VM_DecOperandRegI64, vm_cmp_lt_i64s);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH(CmpLTI64UCondBranch, int64_t,
+                                     VM_DecOperandRegI64, vm_cmp_lt_i64u);
+
+    DISPATCH_OP(CORE, AddI32Imm, {
+      int32_t lhs = VM_DecOperandRegI32("lhs");
+      int32_t rhs = VM_DecAttrI32("rhs");
+      int32_t* result = VM_DecResultRegI32("result");
+      *result = vm_add_i32(lhs, rhs);
+    });
+
+    DISPATCH_OP(CORE, AddI64Imm, {
+      int64_t lhs = VM_DecOperandRegI64("lhs");
+      int64_t rhs = VM_DecAttrI64("rhs");
+      int64_t* result = VM_DecResultRegI64("result");
+      *result = vm_add_i64(lhs, rhs);
+    });
+
+    // vm.global.load.ref followed by the operands of vm.call/vm.call.variadic.
+#define DISPATCH_OP_CORE_GLOBAL_LOAD_REF_CALL(op_name, call_op_name)   \
+  DISPATCH_OP(CORE, op_name, {                                         \
+    uint32_t global = VM_DecGlobalAttr("global");                      \
+    IREE_ASSERT(global < module_state->global_ref_count);              \
+    const iree_vm_type_def_t type_def = VM_DecTypeOf("value");         \
+    bool result_is_move;                                               \
+    iree_vm_ref_t* result =                                            \
+        VM_DecResultRegRef("value", &result_is_move);                  \
+    iree_vm_ref_t* global_ref =                                        \
+        &module_state->global_ref_table[global];                       \
+    IREE_RETURN_IF_ERROR(iree_vm_ref_retain_or_move_checked(           \
+        result_is_move, global_ref, iree_vm_type_def_as_ref(type_def), \
+        result));                                                      \
+    DISPATCH_FUSED_CONTINUE(CORE, call_op_name);                       \
+  });
+
+    DISPATCH_OP_CORE_GLOBAL_LOAD_REF_CALL(GlobalLoadRefCall, Call);
+    DISPATCH_OP_CORE_GLOBAL_LOAD_REF_CALL(GlobalLoadRefCallVariadic,
+                                          CallVariadic);
+
     //===------------------------------------------------------------------===//
     // Extension trampolines
     //===------------------------------------------------------------------===//
@@ -348,6 +348,13 @@ static inline const iree_vm_register_list_t* VM_DecVariadicOperandsImpl(
 
 #endif  // IREE_DISPATCH_MODE_COMPUTED_GOTO
 
+// Superinstructions ending with the operands of another op execute their own
+// prefix and then continue into the body of that op. The entry label is placed
+// at the start of the op body so that no declarations are bypassed.
+#define DISPATCH_FUSED_ENTRY(ext, op_name) _dispatch_fused_##ext##_##op_name:;
+#define DISPATCH_FUSED_CONTINUE(ext, op_name) \
+  goto _dispatch_fused_##ext##_##op_name;
+
 // Common dispatch op macros
 
 #define DISPATCH_OP_CORE_UNARY_I32(op_name, op_func)  \
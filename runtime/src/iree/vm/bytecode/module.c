@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "iree/base/internal/hash.h"
 #include "iree/vm/bytecode/archive.h"
 #include "iree/vm/bytecode/module_impl.h"
 #include "iree/vm/bytecode/verifier.h"
@@ -26,6 +27,56 @@ static bool iree_vm_flatbuffer_strcmp(flatbuffers_string_t lhs,
   return x != 0 ? x : lhs_size < rhs.size ? -1 : lhs_size > rhs.size;
 }
 
+// Hashes a function name. Only the low 32 bits are kept in the table.
+static uint32_t iree_vm_bytecode_hash_function_name(const char* data,
+                                                    iree_host_size_t size) {
+  return (uint32_t)iree_hash_string_view(iree_make_string_view(data, size));
+}
+
+// Returns the capacity of a function name table holding |count| functions.
+// Tables are kept at most half full so that probe sequences stay short and
+// there is always an empty slot to terminate them.
+static iree_host_size_t iree_vm_bytecode_function_name_table_capacity(
+    iree_host_size_t count) {
+  if (count == 0) return 0;
+  iree_host_size_t capacity = 1;
+  while (capacity < count * 2) capacity <<= 1;
+  return capacity;
+}
+
+// Inserts |name| -> |ordinal| into |table|. Names are inserted in ordinal order
+// so that if a name is present multiple times lookups find the first ordinal
+// as a linear scan would.
+static void iree_vm_bytecode_function_name_table_insert(
+    iree_vm_bytecode_function_name_table_t* table, flatbuffers_string_t name,
+    uint32_t ordinal) {
+  const uint32_t hash =
+      iree_vm_bytecode_hash_function_name(name, flatbuffers_string_len(name));
+  const iree_host_size_t mask = table->capacity - 1;
+  iree_host_size_t slot = hash & mask;
+  while (table->entries[slot].ordinal_plus_one) slot = (slot + 1) & mask;
+  table->entries[slot].hash = hash;
+  table->entries[slot].ordinal_plus_one = ordinal + 1;
+}
+
+// Returns the ordinal + 1 of the next entry in the probe sequence at |slot|
+// whose name hashes to |hash| or 0 if there are no more candidates. Callers
+// must compare the name of the returned function as different names may hash
+// to the same value.
+static uint32_t iree_vm_bytecode_function_name_table_probe(
+    const iree_vm_bytecode_function_name_table_t* table, uint32_t hash,
+    iree_host_size_t* slot) {
+  if (table->capacity == 0) return 0;
+  const iree_host_size_t mask = table->capacity - 1;
+  for (;;) {
+    const iree_vm_bytecode_function_name_entry_t* entry =
+        &table->entries[*slot & mask];
+    *slot = (*slot & mask) + 1;
+    if (!entry->ordinal_plus_one) return 0;
+    if (entry->hash == hash) return entry->ordinal_plus_one;
+  }
+}
+
 // Resolves a type through either builtin rules or the ref registered types.
 static bool iree_vm_bytecode_module_resolve_type(
     iree_vm_instance_t* instance, iree_vm_TypeDef_table_t type_def,
@@ -272,14 +323,17 @@ static iree_status_t iree_vm_bytecode_module_lookup_function(
   out_function->linkage = linkage;
   out_function->module = &module->interface;
 
-  // NOTE: we could organize exports alphabetically so we could bsearch.
+  const uint32_t hash =
+      iree_vm_bytecode_hash_function_name(name.data, name.size);
+  iree_host_size_t slot = hash;
+  uint32_t ordinal_plus_one = 0;
   if (linkage == IREE_VM_FUNCTION_LINKAGE_IMPORT ||
       linkage == IREE_VM_FUNCTION_LINKAGE_IMPORT_OPTIONAL) {
     iree_vm_ImportFunctionDef_vec_t imported_functions =
         iree_vm_BytecodeModuleDef_imported_functions(module->def);
-    for (iree_host_size_t ordinal = 0;
-         ordinal < iree_vm_ImportFunctionDef_vec_len(imported_functions);
-         ++ordinal) {
+    while ((ordinal_plus_one = iree_vm_bytecode_function_name_table_probe(
+                &module->import_name_table, hash, &slot))) {
+      const iree_host_size_t ordinal = ordinal_plus_one - 1;
       iree_vm_ImportFunctionDef_table_t import_def =
           iree_vm_ImportFunctionDef_vec_at(imported_functions, ordinal);
       if (iree_vm_flatbuffer_strcmp(
@@ -296,9 +350,9 @@ static iree_status_t iree_vm_bytecode_module_lookup_function(
              linkage == IREE_VM_FUNCTION_LINKAGE_EXPORT_OPTIONAL) {
     iree_vm_ExportFunctionDef_vec_t exported_functions =
         iree_vm_BytecodeModuleDef_exported_functions(module->def);
-    for (iree_host_size_t ordinal = 0;
-         ordinal < iree_vm_ExportFunctionDef_vec_len(exported_functions);
-         ++ordinal) {
+    while ((ordinal_plus_one = iree_vm_bytecode_function_name_table_probe(
+                &module->export_name_table, hash, &slot))) {
+      const iree_host_size_t ordinal = ordinal_plus_one - 1;
       iree_vm_ExportFunctionDef_table_t export_def =
           iree_vm_ExportFunctionDef_vec_at(exported_functions, ordinal);
       if (iree_vm_flatbuffer_strcmp(
@@ -902,12 +956,26 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   size_t rodata_ref_table_size =
       iree_host_align(rodata_ref_count * sizeof(iree_vm_buffer_t), 16);
 
+  iree_vm_ImportFunctionDef_vec_t imported_functions =
+      iree_vm_BytecodeModuleDef_imported_functions(module_def);
+  iree_vm_ExportFunctionDef_vec_t exported_functions =
+      iree_vm_BytecodeModuleDef_exported_functions(module_def);
+  iree_host_size_t import_name_table_capacity =
+      iree_vm_bytecode_function_name_table_capacity(
+          iree_vm_ImportFunctionDef_vec_len(imported_functions));
+  iree_host_size_t export_name_table_capacity =
+      iree_vm_bytecode_function_name_table_capacity(
+          iree_vm_ExportFunctionDef_vec_len(exported_functions));
+  size_t name_table_size =
+      (import_name_table_capacity + export_name_table_capacity) *
+      sizeof(iree_vm_bytecode_function_name_entry_t);
+
   iree_vm_bytecode_module_t* module = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0,
-      iree_allocator_malloc(
-          allocator, sizeof(*module) + type_table_size + rodata_ref_table_size,
-          (void**)&module));
+      z0, iree_allocator_malloc(allocator,
+                                sizeof(*module) + type_table_size +
+                                    rodata_ref_table_size + name_table_size,
+                                (void**)&module));
   module->allocator = allocator;
 
   iree_vm_FunctionDescriptor_vec_t function_descriptors =
@@ -986,6 +1054,34 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
                               iree_allocator_null(), ref);
   }
 
+  // Build the function name tables used for lookups by name. The entries are
+  // zeroed by the allocation and zero indicates an empty slot.
+  module->import_name_table.capacity = import_name_table_capacity;
+  module->import_name_table.entries =
+      (iree_vm_bytecode_function_name_entry_t*)((uint8_t*)module +
+                                                sizeof(*module) +
+                                                type_table_size +
+                                                rodata_ref_table_size);
+  module->export_name_table.capacity = export_name_table_capacity;
+  module->export_name_table.entries =
+      module->import_name_table.entries + import_name_table_capacity;
+  for (uint32_t i = 0;
+       i < iree_vm_ImportFunctionDef_vec_len(imported_functions); ++i) {
+    iree_vm_bytecode_function_name_table_insert(
+        &module->import_name_table,
+        iree_vm_ImportFunctionDef_full_name(
+            iree_vm_ImportFunctionDef_vec_at(imported_functions, i)),
+        i);
+  }
+  for (uint32_t i = 0;
+       i < iree_vm_ExportFunctionDef_vec_len(exported_functions); ++i) {
+    iree_vm_bytecode_function_name_table_insert(
+        &module->export_name_table,
+        iree_vm_ExportFunctionDef_local_name(
+            iree_vm_ExportFunctionDef_vec_at(exported_functions, i)),
+        i);
+  }
+
   // Verify functions in the module now that we've verified the metadata that we
   // need to do so.
   iree_status_t verify_status = iree_ok_status();
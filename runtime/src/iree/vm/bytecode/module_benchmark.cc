@@ -12,6 +12,7 @@
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode/module.h"
 #include "iree/vm/bytecode/module_benchmark_module_c.h"
+#include "iree/vm/bytecode/module_benchmark_nofuse_module_c.h"
 
 namespace {
 
@@ -71,10 +72,12 @@ static iree_status_t native_import_module_create(
 }
 
 // Benchmarks the given exported function, optionally passing in arguments.
-static iree_status_t RunFunction(iree_benchmark_state_t* benchmark_state,
-                                 iree_string_view_t function_name,
-                                 std::vector<int32_t> i32_args,
-                                 int result_count, int64_t batch_size = 1) {
+// |module_file_toc| selects the compiled variant of the benchmark module.
+static iree_status_t RunFunction(
+    iree_benchmark_state_t* benchmark_state, iree_string_view_t function_name,
+    std::vector<int32_t> i32_args, int result_count, int64_t batch_size = 1,
+    const iree_file_toc_t* module_file_toc =
+        iree_vm_bytecode_module_benchmark_module_create()) {
   iree_vm_instance_t* instance = NULL;
   IREE_CHECK_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
                                         iree_allocator_system(), &instance));
@@ -83,8 +86,6 @@ static iree_status_t RunFunction(iree_benchmark_state_t* benchmark_state,
   IREE_CHECK_OK(native_import_module_create(instance, iree_allocator_system(),
                                             &import_module));
 
-  const auto* module_file_toc =
-      iree_vm_bytecode_module_benchmark_module_create();
   iree_vm_module_t* bytecode_module = nullptr;
   IREE_CHECK_OK(iree_vm_bytecode_module_create(
       instance,
@@ -222,6 +223,42 @@ IREE_BENCHMARK_FN(BM_FullModuleInit) {
 }
 IREE_BENCHMARK_REGISTER(BM_FullModuleInit);
 
+IREE_BENCHMARK_FN(BM_LookupFunctionByName) {
+  iree_vm_instance_t* instance = NULL;
+  IREE_CHECK_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                        iree_allocator_system(), &instance));
+
+  const auto* module_file_toc =
+      iree_vm_bytecode_module_benchmark_module_create();
+  iree_vm_module_t* module = nullptr;
+  IREE_CHECK_OK(iree_vm_bytecode_module_create(
+      instance,
+      iree_const_byte_span_t{
+          reinterpret_cast<const uint8_t*>(module_file_toc->data),
+          static_cast<iree_host_size_t>(module_file_toc->size)},
+      iree_allocator_null(), iree_allocator_system(), &module));
+
+  // Looks up the last export as that was the worst case with a linear scan.
+  iree_vm_module_signature_t signature = iree_vm_module_signature(module);
+  iree_vm_function_t last_function;
+  IREE_CHECK_OK(iree_vm_module_lookup_function_by_ordinal(
+      module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+      signature.export_function_count - 1, &last_function));
+  iree_string_view_t name = iree_vm_function_name(&last_function);
+
+  while (iree_benchmark_keep_running(benchmark_state, 1)) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(iree_vm_module_lookup_function_by_name(
+        module, IREE_VM_FUNCTION_LINKAGE_EXPORT, name, &function));
+    iree_optimization_barrier(function.module);
+  }
+
+  iree_vm_module_release(module);
+  iree_vm_instance_release(instance);
+  return iree_ok_status();
+}
+IREE_BENCHMARK_REGISTER(BM_LookupFunctionByName);
+
 IREE_ATTRIBUTE_NOINLINE static int empty_fn(void) {
   int ret = 1;
   iree_optimization_barrier(ret);
@@ -335,6 +372,40 @@ IREE_BENCHMARK_FN(BM_LoopSumBytecode) {
 }
 IREE_BENCHMARK_REGISTER(BM_LoopSumBytecode);
 
+IREE_BENCHMARK_FN(BM_LoopSumBytecodeNoSuperinstructions) {
+  static const int batch = 100000;
+  return RunFunction(
+      benchmark_state,
+      iree_make_cstring_view("bytecode_module_benchmark.loop_sum"), {batch},
+      /*result_count=*/1,
+      /*batch_size=*/batch,
+      iree_vm_bytecode_module_benchmark_nofuse_module_create());
+}
+IREE_BENCHMARK_REGISTER(BM_LoopSumBytecodeNoSuperinstructions);
+
+IREE_BENCHMARK_FN(BM_GlobalLoadCallBytecode) {
+  static const int batch = 10000;
+  return RunFunction(
+      benchmark_state,
+      iree_make_cstring_view("bytecode_module_benchmark.global_load_call"),
+      {batch},
+      /*result_count=*/1,
+      /*batch_size=*/batch);
+}
+IREE_BENCHMARK_REGISTER(BM_GlobalLoadCallBytecode);
+
+IREE_BENCHMARK_FN(BM_GlobalLoadCallBytecodeNoSuperinstructions) {
+  static const int batch = 10000;
+  return RunFunction(
+      benchmark_state,
+      iree_make_cstring_view("bytecode_module_benchmark.global_load_call"),
+      {batch},
+      /*result_count=*/1,
+      /*batch_size=*/batch,
+      iree_vm_bytecode_module_benchmark_nofuse_module_create());
+}
+IREE_BENCHMARK_REGISTER(BM_GlobalLoadCallBytecodeNoSuperinstructions);
+
 IREE_BENCHMARK_FN(BM_BufferReduceReference) {
   static const int batch = 100000;
   static auto work = +[](int32_t* buffer, int i, int sum) {
@@ -374,6 +445,18 @@ IREE_BENCHMARK_FN(BM_BufferReduceBytecode) {
 }
 IREE_BENCHMARK_REGISTER(BM_BufferReduceBytecode);
 
+IREE_BENCHMARK_FN(BM_BufferReduceBytecodeNoSuperinstructions) {
+  static const int batch = 100000;
+  return RunFunction(
+      benchmark_state,
+      iree_make_cstring_view("bytecode_module_benchmark.buffer_reduce"),
+      {batch},
+      /*result_count=*/1,
+      /*batch_size=*/batch,
+      iree_vm_bytecode_module_benchmark_nofuse_module_create());
+}
+IREE_BENCHMARK_REGISTER(BM_BufferReduceBytecodeNoSuperinstructions);
+
 // NOTE: unrolled 8x, requires %count to be % 8 = 0.
 IREE_BENCHMARK_FN(BM_BufferReduceBytecodeUnrolled) {
   static const int batch = 100000;
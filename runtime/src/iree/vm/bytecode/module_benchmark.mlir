@@ -77,6 +77,33 @@ vm.module @bytecode_module_benchmark {
     vm.return %ie : i32
   }
 
+  // Measures the cost of loading a global ref and passing it to a call.
+  vm.global.ref private mutable @global_buffer : !vm.buffer
+  vm.func @buffer_length(%buf : !vm.buffer) -> i32 attributes {inlining_policy = #util.inline.never} {
+    %length = vm.buffer.length %buf : !vm.buffer -> i64
+    %length_i32 = vm.trunc.i64.i32 %length : i64 -> i32
+    vm.return %length_i32 : i32
+  }
+  vm.export @global_load_call
+  vm.func @global_load_call(%count : i32) -> i32 {
+    %c16 = vm.const.i64 16
+    %alignment = vm.const.i32 16
+    %buf = vm.buffer.alloc %c16, %alignment : !vm.buffer
+    vm.global.store.ref %buf, @global_buffer : !vm.buffer
+    %c1 = vm.const.i32 1
+    %i0 = vm.const.i32.zero
+    vm.br ^loop(%i0, %i0 : i32, i32)
+  ^loop(%i : i32, %sum : i32):
+    %ref = vm.global.load.ref @global_buffer : !vm.buffer
+    %length = vm.call @buffer_length(%ref) : (!vm.buffer) -> i32
+    %new_sum = vm.add.i32 %sum, %length : i32
+    %in = vm.add.i32 %i, %c1 : i32
+    %cmp = vm.cmp.lt.i32.s %in, %count : i32
+    vm.cond_br %cmp, ^loop(%in, %new_sum : i32, i32), ^loop_exit(%new_sum : i32)
+  ^loop_exit(%result : i32):
+    vm.return %result : i32
+  }
+
   // Measures the cost of lots of buffer loads.
   vm.export @buffer_reduce
   vm.func @buffer_reduce(%count : i32) -> i32 {
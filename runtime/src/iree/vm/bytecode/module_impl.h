@@ -18,6 +18,24 @@
 extern "C" {
 #endif  // __cplusplus
 
+// An entry in an open-addressed table mapping function names to ordinals.
+// Empty slots have an |ordinal_plus_one| of 0.
+typedef struct iree_vm_bytecode_function_name_entry_t {
+  // Hash of the function name used to skip most string comparisons.
+  uint32_t hash;
+  // Ordinal of the function in the import/export table + 1.
+  uint32_t ordinal_plus_one;
+} iree_vm_bytecode_function_name_entry_t;
+
+// A table of function names hashed to their ordinals built when the module is
+// loaded so that lookups by name (such as import resolution) don't need to
+// scan all functions.
+typedef struct iree_vm_bytecode_function_name_table_t {
+  // Power-of-two capacity of |entries| or 0 if there are no functions.
+  iree_host_size_t capacity;
+  iree_vm_bytecode_function_name_entry_t* entries;
+} iree_vm_bytecode_function_name_table_t;
+
 // A loaded bytecode module.
 typedef struct iree_vm_bytecode_module_t {
   // Interface routing to the bytecode module functions.
@@ -48,6 +66,10 @@ typedef struct iree_vm_bytecode_module_t {
   iree_host_size_t rodata_ref_count;
   iree_vm_buffer_t* rodata_ref_table;
 
+  // Tables mapping import full names and export local names to ordinals.
+  iree_vm_bytecode_function_name_table_t import_name_table;
+  iree_vm_bytecode_function_name_table_t export_name_table;
+
   // Type table mapping module type IDs to registered VM types.
   iree_host_size_t type_count;
   iree_vm_type_def_t type_table[];
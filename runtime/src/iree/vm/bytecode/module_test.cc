@@ -100,6 +100,7 @@ static std::vector<iree_vm_ref_t> MakeNullRefList(size_t count) {
 
 namespace {
 
+using iree::Status;
 using iree::StatusCode;
 using iree::StatusOr;
 using iree::testing::status::IsOkAndHolds;
@@ -208,6 +209,44 @@ class VMBytecodeModuleTest : public ::testing::Test {
   iree_vm_module_t* bytecode_module_ = nullptr;
 };
 
+// Tests that every export can be looked up by name and resolves to the same
+// ordinal that is reported when enumerating the exports.
+TEST_F(VMBytecodeModuleTest, LookupFunctionByName) {
+  iree_vm_module_signature_t signature =
+      iree_vm_module_signature(bytecode_module_);
+  ASSERT_GT(signature.export_function_count, 0);
+  for (iree_host_size_t i = 0; i < signature.export_function_count; ++i) {
+    iree_vm_function_t function;
+    IREE_ASSERT_OK(iree_vm_module_lookup_function_by_ordinal(
+        bytecode_module_, IREE_VM_FUNCTION_LINKAGE_EXPORT, i, &function));
+    iree_string_view_t name = iree_vm_function_name(&function);
+    iree_vm_function_t lookup_function;
+    IREE_ASSERT_OK(iree_vm_module_lookup_function_by_name(
+        bytecode_module_, IREE_VM_FUNCTION_LINKAGE_EXPORT, name,
+        &lookup_function));
+    EXPECT_EQ(lookup_function.module, bytecode_module_);
+    EXPECT_EQ(lookup_function.ordinal, i);
+  }
+}
+
+// Tests that names that are not exported are not found even when they share a
+// prefix with an export.
+TEST_F(VMBytecodeModuleTest, LookupFunctionByNameNotFound) {
+  iree_vm_function_t function;
+  EXPECT_THAT(Status(iree_vm_module_lookup_function_by_name(
+                  bytecode_module_, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+                  iree_make_cstring_view("FuncIO"), &function)),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_THAT(Status(iree_vm_module_lookup_function_by_name(
+                  bytecode_module_, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+                  iree_make_cstring_view("FuncIO10"), &function)),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_THAT(Status(iree_vm_module_lookup_function_by_name(
+                  bytecode_module_, IREE_VM_FUNCTION_LINKAGE_IMPORT,
+                  iree_make_cstring_view("FuncIO1"), &function)),
+              StatusIs(StatusCode::kNotFound));
+}
+
 TEST_F(VMBytecodeModuleTest, FuncIOEmpty) {
   EXPECT_THAT(RunFunction("FuncIOEmpty", std::vector<iree_vm_value_t>()),
               IsOkAndHolds(Eq(std::vector<iree_vm_value_t>())));
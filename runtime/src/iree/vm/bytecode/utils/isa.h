@@ -38,8 +38,10 @@
 // to load older serialized files when there are backwards-compatible changes.
 // Higher versions are disallowed as they occur when new ops are added that
 // otherwise cannot be executed by older runtimes.
+// Minor version 1 added superinstruction opcodes; the compiler emits modules
+// not using them as minor version 0.
 // Matches BytecodeEncoder::kVersionMinor in the compiler.
-#define IREE_VM_BYTECODE_VERSION_MINOR 0
+#define IREE_VM_BYTECODE_VERSION_MINOR 1
 
 //===----------------------------------------------------------------------===//
 // Bytecode structural constants
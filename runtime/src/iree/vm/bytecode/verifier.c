@@ -1582,6 +1582,8 @@ static iree_status_t iree_vm_bytecode_function_verify_bytecode_op(
     });
 
     VERIFY_OP(CORE, Call, {
+      // Entry for the GlobalLoadRefCall superinstruction.
+    verify_fused_Call:;
       VM_VerifyFuncAttr(callee_ordinal);
       VM_VerifyVariadicOperandsAny(operands);
       VM_VerifyVariadicResultsAny(results);
@@ -1610,6 +1612,8 @@ static iree_status_t iree_vm_bytecode_function_verify_bytecode_op(
     });
 
     VERIFY_OP(CORE, CallVariadic, {
+      // Entry for the GlobalLoadRefCallVariadic superinstruction.
+    verify_fused_CallVariadic:;
       VM_VerifyFuncAttr(callee_ordinal);
       VM_VerifyVariadicOperands(segment_sizes);
       VM_VerifyVariadicOperandsAny(operands);
@@ -1699,6 +1703,61 @@ static iree_status_t iree_vm_bytecode_function_verify_bytecode_op(
       verify_state->in_block = 0;  // terminator
     });
 
+    //===------------------------------------------------------------------===//
+    // Superinstructions
+    //===------------------------------------------------------------------===//
+
+#define VERIFY_OP_CORE_CMP_COND_BRANCH(op_name, operand_type) \
+  VERIFY_OP(CORE, op_name, {                                  \
+    VM_VerifyOperandReg##operand_type(lhs);                   \
+    VM_VerifyOperandReg##operand_type(rhs);                   \
+    VM_VerifyResultRegI32(result);                            \
+    VM_VerifyBranchTarget(true_dest_pc);                      \
+    VM_VerifyBranchOperands(true_operands);                   \
+    VM_VerifyBranchTarget(false_dest_pc);                     \
+    VM_VerifyBranchOperands(false_operands);                  \
+    verify_state->in_block = 0; /* terminator */              \
+  });
+
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpEQI32CondBranch, I32);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpNEI32CondBranch, I32);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpLTI32SCondBranch, I32);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpLTI32UCondBranch, I32);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpEQI64CondBranch, I64);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpNEI64CondBranch, I64);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpLTI64SCondBranch, I64);
+    VERIFY_OP_CORE_CMP_COND_BRANCH(CmpLTI64UCondBranch, I64);
+
+    VERIFY_OP(CORE, AddI32Imm, {
+      VM_VerifyOperandRegI32(lhs);
+      VM_VerifyAttrI32(rhs);
+      VM_VerifyResultRegI32(result);
+    });
+
+    VERIFY_OP(CORE, AddI64Imm, {
+      VM_VerifyOperandRegI64(lhs);
+      VM_VerifyAttrI64(rhs);
+      VM_VerifyResultRegI64(result);
+    });
+
+    // The global load is followed by the operands of the call which are
+    // verified by the regular call verification.
+    VERIFY_OP(CORE, GlobalLoadRefCall, {
+      VM_VerifyGlobalAttr(global);
+      VM_VerifyGlobalRefOrdinal(global);
+      VM_VerifyTypeOf(type_def);
+      VM_VerifyResultRegRef(value);
+      goto verify_fused_Call;
+    });
+
+    VERIFY_OP(CORE, GlobalLoadRefCallVariadic, {
+      VM_VerifyGlobalAttr(global);
+      VM_VerifyGlobalRefOrdinal(global);
+      VM_VerifyTypeOf(type_def);
+      VM_VerifyResultRegRef(value);
+      goto verify_fused_CallVariadic;
+    });
+
     //===------------------------------------------------------------------===//
     // Extension trampolines
     //===------------------------------------------------------------------===//
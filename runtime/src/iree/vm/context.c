@@ -169,9 +169,11 @@ static iree_status_t iree_vm_context_resolve_module_imports(
       z0, iree_vm_module_enumerate_dependencies(
               module, iree_vm_context_check_module_dependency, context));
 
-  // NOTE: this has some bad characteristics, but the number of modules and the
-  // number of imported functions should be relatively small (even if the number
-  // of exported functions for particular modules is large).
+  // NOTE: each import scans the (small) list of modules by name and then looks
+  // up the function in the module that matches. Modules are expected to make
+  // that lookup cheap even when they have large numbers of exports (bytecode
+  // modules hash function names on load) as it happens for every import of
+  // every context created.
   iree_vm_module_signature_t module_signature = module->signature(module->self);
   for (int i = 0; i < module_signature.import_function_count; ++i) {
     iree_vm_function_t decl_function;
@@ -0,0 +1,170 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Compares the bytecode interpreter against the same module compiled to C
+// ahead-of-time and loaded from a shared library as a dynamic module.
+
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/benchmark.h"
+#include "iree/vm/api.h"
+#include "iree/vm/bytecode/module.h"
+#include "iree/vm/dynamic/module.h"
+#include "iree/vm/dynamic/module_benchmark_bytecode_module_c.h"
+
+// Path to the shared library built from module_benchmark.mlir.
+#if !defined(IREE_VM_DYNAMIC_MODULE_BENCHMARK_LIBRARY_PATH)
+#error "IREE_VM_DYNAMIC_MODULE_BENCHMARK_LIBRARY_PATH must be defined"
+#endif  // IREE_VM_DYNAMIC_MODULE_BENCHMARK_LIBRARY_PATH
+
+namespace {
+
+enum class ModuleKind {
+  kBytecode,
+  kNative,
+};
+
+static iree_status_t CreateModule(iree_vm_instance_t* instance,
+                                  ModuleKind kind,
+                                  iree_vm_module_t** out_module) {
+  switch (kind) {
+    case ModuleKind::kBytecode: {
+      const auto* module_file_toc =
+          iree_vm_dynamic_module_benchmark_bytecode_module_create();
+      return iree_vm_bytecode_module_create(
+          instance,
+          iree_const_byte_span_t{
+              reinterpret_cast<const uint8_t*>(module_file_toc->data),
+              static_cast<iree_host_size_t>(module_file_toc->size)},
+          iree_allocator_null(), iree_allocator_system(), out_module);
+    }
+    case ModuleKind::kNative:
+      return iree_vm_dynamic_module_load_from_file(
+          instance,
+          iree_make_cstring_view(IREE_VM_DYNAMIC_MODULE_BENCHMARK_LIBRARY_PATH),
+          iree_string_view_empty(), /*param_count=*/0, /*params=*/NULL,
+          iree_allocator_system(), out_module);
+  }
+  return iree_make_status(IREE_STATUS_INVALID_ARGUMENT);
+}
+
+// Benchmarks the given exported function, optionally passing in arguments.
+static iree_status_t RunFunction(iree_benchmark_state_t* benchmark_state,
+                                 ModuleKind kind,
+                                 iree_string_view_t function_name,
+                                 std::vector<int32_t> i32_args,
+                                 int result_count, int64_t batch_size = 1) {
+  iree_vm_instance_t* instance = NULL;
+  IREE_CHECK_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                        iree_allocator_system(), &instance));
+
+  iree_vm_module_t* module = NULL;
+  IREE_CHECK_OK(CreateModule(instance, kind, &module));
+
+  iree_vm_context_t* context = NULL;
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      instance, IREE_VM_CONTEXT_FLAG_NONE, 1, &module, iree_allocator_system(),
+      &context));
+
+  iree_vm_function_t function;
+  IREE_CHECK_OK(
+      iree_vm_context_resolve_function(context, function_name, &function));
+
+  iree_vm_function_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.function = function;
+  call.arguments =
+      iree_make_byte_span(iree_alloca(i32_args.size() * sizeof(int32_t)),
+                          i32_args.size() * sizeof(int32_t));
+  call.results =
+      iree_make_byte_span(iree_alloca(result_count * sizeof(int32_t)),
+                          result_count * sizeof(int32_t));
+
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE,
+                                  iree_vm_context_state_resolver(context),
+                                  iree_allocator_system());
+  while (iree_benchmark_keep_running(benchmark_state, batch_size)) {
+    for (iree_host_size_t i = 0; i < i32_args.size(); ++i) {
+      reinterpret_cast<int32_t*>(call.arguments.data)[i] = i32_args[i];
+    }
+    IREE_CHECK_OK(function.module->begin_call(function.module->self, stack,
+                                              call));
+  }
+  iree_vm_stack_deinitialize(stack);
+
+  iree_vm_module_release(module);
+  iree_vm_context_release(context);
+  iree_vm_instance_release(instance);
+
+  return iree_ok_status();
+}
+
+IREE_BENCHMARK_FN(BM_CallInternalFuncBytecode) {
+  static const int batch = 100;
+  return RunFunction(
+      benchmark_state, ModuleKind::kBytecode,
+      iree_make_cstring_view("dynamic_module_benchmark.call_internal_func"),
+      {batch},
+      /*result_count=*/1,
+      /*batch_size=*/batch);
+}
+IREE_BENCHMARK_REGISTER(BM_CallInternalFuncBytecode);
+
+IREE_BENCHMARK_FN(BM_CallInternalFuncNative) {
+  static const int batch = 100;
+  return RunFunction(
+      benchmark_state, ModuleKind::kNative,
+      iree_make_cstring_view("dynamic_module_benchmark.call_internal_func"),
+      {batch},
+      /*result_count=*/1,
+      /*batch_size=*/batch);
+}
+IREE_BENCHMARK_REGISTER(BM_CallInternalFuncNative);
+
+IREE_BENCHMARK_FN(BM_LoopSumBytecode) {
+  static const int batch = 100000;
+  return RunFunction(
+      benchmark_state, ModuleKind::kBytecode,
+      iree_make_cstring_view("dynamic_module_benchmark.loop_sum"), {batch},
+      /*result_count=*/1,
+      /*batch_size=*/batch);
+}
+IREE_BENCHMARK_REGISTER(BM_LoopSumBytecode);
+
+IREE_BENCHMARK_FN(BM_LoopSumNative) {
+  static const int batch = 100000;
+  return RunFunction(
+      benchmark_state, ModuleKind::kNative,
+      iree_make_cstring_view("dynamic_module_benchmark.loop_sum"), {batch},
+      /*result_count=*/1,
+      /*batch_size=*/batch);
+}
+IREE_BENCHMARK_REGISTER(BM_LoopSumNative);
+
+IREE_BENCHMARK_FN(BM_BufferReduceBytecode) {
+  static const int batch = 100000;
+  return RunFunction(
+      benchmark_state, ModuleKind::kBytecode,
+      iree_make_cstring_view("dynamic_module_benchmark.buffer_reduce"),
+      {batch},
+      /*result_count=*/1,
+      /*batch_size=*/batch);
+}
+IREE_BENCHMARK_REGISTER(BM_BufferReduceBytecode);
+
+IREE_BENCHMARK_FN(BM_BufferReduceNative) {
+  static const int batch = 100000;
+  return RunFunction(
+      benchmark_state, ModuleKind::kNative,
+      iree_make_cstring_view("dynamic_module_benchmark.buffer_reduce"),
+      {batch},
+      /*result_count=*/1,
+      /*batch_size=*/batch);
+}
+IREE_BENCHMARK_REGISTER(BM_BufferReduceNative);
+
+}  // namespace
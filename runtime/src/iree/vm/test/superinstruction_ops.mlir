@@ -0,0 +1,171 @@
+// Tests for op sequences that the bytecode encoder fuses into
+// superinstructions. The same sequences appear throughout the other test
+// modules but these cover the edge cases of the fused encodings.
+vm.module @superinstruction_ops {
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.* + vm.cond_br
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_cond_br_loop_i32
+  vm.func @test_cmp_cond_br_loop_i32() {
+    %c0 = vm.const.i32 0
+    %c10 = vm.const.i32 10
+    %c10dno = util.optimization_barrier %c10 : i32
+    vm.br ^loop(%c0, %c0 : i32, i32)
+  ^loop(%i : i32, %sum : i32):
+    %sum_next = vm.add.i32 %sum, %i : i32
+    %c1 = vm.const.i32 1
+    %i_next = vm.add.i32 %i, %c1 : i32
+    %cond = vm.cmp.lt.i32.s %i_next, %c10dno : i32
+    vm.cond_br %cond, ^loop(%i_next, %sum_next : i32, i32), ^exit(%sum_next : i32)
+  ^exit(%result : i32):
+    %c45 = vm.const.i32 45
+    vm.check.eq %result, %c45, "sum(0..9) != 45" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_cond_br_loop_i64
+  vm.func @test_cmp_cond_br_loop_i64() {
+    %c0 = vm.const.i64 0
+    %c10 = vm.const.i64 10
+    %c10dno = util.optimization_barrier %c10 : i64
+    vm.br ^loop(%c0, %c0 : i64, i64)
+  ^loop(%i : i64, %sum : i64):
+    %sum_next = vm.add.i64 %sum, %i : i64
+    %c1 = vm.const.i64 1
+    %i_next = vm.add.i64 %i, %c1 : i64
+    %cond = vm.cmp.ne.i64 %i_next, %c10dno : i64
+    vm.cond_br %cond, ^loop(%i_next, %sum_next : i64, i64), ^exit(%sum_next : i64)
+  ^exit(%result : i64):
+    %c45 = vm.const.i64 45
+    vm.check.eq %result, %c45, "sum(0..9) != 45" : i64
+    vm.return
+  }
+
+  // The comparison result must still be written to its register when it is
+  // used after the branch.
+  vm.export @test_cmp_cond_br_result_live
+  vm.func @test_cmp_cond_br_result_live() {
+    %c1 = vm.const.i32 1
+    %c2 = vm.const.i32 2
+    %c1dno = util.optimization_barrier %c1 : i32
+    %c2dno = util.optimization_barrier %c2 : i32
+    %cond = vm.cmp.eq.i32 %c1dno, %c2dno : i32
+    vm.cond_br %cond, ^bb1, ^bb2(%cond : i32)
+  ^bb1:
+    %code = vm.const.i32 4
+    vm.fail %code, "unreachable!"
+  ^bb2(%arg : i32):
+    %c0 = vm.const.i32 0
+    vm.check.eq %arg, %c0, "cmp result lost across branch" : i32
+    vm.check.eq %cond, %c0, "cmp result lost across branch" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_cond_br_unsigned
+  vm.func @test_cmp_cond_br_unsigned() {
+    %cn1 = vm.const.i32 -1
+    %c1 = vm.const.i32 1
+    %cn1dno = util.optimization_barrier %cn1 : i32
+    %c1dno = util.optimization_barrier %c1 : i32
+    %cond = vm.cmp.lt.i32.u %cn1dno, %c1dno : i32
+    vm.cond_br %cond, ^bb1, ^bb2
+  ^bb1:
+    %code = vm.const.i32 4
+    vm.fail %code, "0xFFFFFFFF <u 1"
+  ^bb2:
+    vm.return
+  }
+
+  vm.export @test_cmp_cond_br_unsigned_i64
+  vm.func @test_cmp_cond_br_unsigned_i64() {
+    %cn1 = vm.const.i64 -1
+    %c1 = vm.const.i64 1
+    %cn1dno = util.optimization_barrier %cn1 : i64
+    %c1dno = util.optimization_barrier %c1 : i64
+    %cond = vm.cmp.lt.i64.s %cn1dno, %c1dno : i64
+    vm.cond_br %cond, ^bb1, ^bb2
+  ^bb1:
+    %cond_u = vm.cmp.lt.i64.u %cn1dno, %c1dno : i64
+    vm.cond_br %cond_u, ^bb2, ^bb3
+  ^bb2:
+    %code = vm.const.i32 4
+    vm.fail %code, "unreachable!"
+  ^bb3:
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.const.* + vm.add.*
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_add_imm_i32
+  vm.func @test_add_imm_i32() {
+    %c5 = vm.const.i32 5
+    %c5dno = util.optimization_barrier %c5 : i32
+    %cn7 = vm.const.i32 -7
+    // Constant on the lhs.
+    %v = vm.add.i32 %cn7, %c5dno : i32
+    %cn2 = vm.const.i32 -2
+    vm.check.eq %v, %cn2, "5 + -7 != -2" : i32
+    vm.return
+  }
+
+  vm.export @test_add_imm_i64
+  vm.func @test_add_imm_i64() {
+    %c1 = vm.const.i64 1
+    %c1dno = util.optimization_barrier %c1 : i64
+    %cbig = vm.const.i64 4294967296
+    %v = vm.add.i64 %c1dno, %cbig : i64
+    %expected = vm.const.i64 4294967297
+    vm.check.eq %v, %expected, "1 + 2^32 != 2^32 + 1" : i64
+    vm.return
+  }
+
+  // The constant has other uses and must still be materialized.
+  vm.export @test_add_imm_shared_const
+  vm.func @test_add_imm_shared_const() {
+    %c3 = vm.const.i32 3
+    %c3dno = util.optimization_barrier %c3 : i32
+    %v = vm.add.i32 %c3dno, %c3 : i32
+    %w = vm.mul.i32 %v, %c3 : i32
+    %c18 = vm.const.i32 18
+    vm.check.eq %w, %c18, "(3 + 3) * 3 != 18" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.global.load.ref + vm.call
+  //===--------------------------------------------------------------------===//
+
+  vm.global.ref private mutable @g_buffer : !vm.buffer
+  vm.rodata private @buffer dense<[1, 2, 3]> : tensor<3xi8>
+
+  vm.export @test_global_load_ref_call
+  vm.func @test_global_load_ref_call() {
+    vm.call @_store_global() : () -> ()
+    %ref = vm.global.load.ref @g_buffer : !vm.buffer
+    %length = vm.call @_buffer_length(%ref) : (!vm.buffer) -> i64
+    %c3 = vm.const.i64 3
+    vm.check.eq %length, %c3, "length != 3" : i64
+    // The global must keep its reference after being passed to the call.
+    %ref2 = vm.global.load.ref @g_buffer : !vm.buffer
+    vm.check.nz %ref2 : !vm.buffer
+    vm.return
+  }
+
+  vm.func private @_store_global()
+      attributes {inlining_policy = #util.inline.never} {
+    %rodata = vm.const.ref.rodata @buffer : !vm.buffer
+    vm.global.store.ref %rodata, @g_buffer : !vm.buffer
+    vm.return
+  }
+
+  vm.func private @_buffer_length(%buffer : !vm.buffer) -> i64
+      attributes {inlining_policy = #util.inline.never} {
+    %length = vm.buffer.length %buffer : !vm.buffer -> i64
+    vm.return %length : i64
+  }
+
+}
@@ -0,0 +1,41 @@
+// RUN: iree-run-mlir \
+// RUN:   --Xcompiler,iree-hal-target-device=local \
+// RUN:   --Xcompiler,iree-hal-local-target-device-backends=llvm-cpu \
+// RUN:   --Xcompiler,iree-stream-partitioning-favor=balanced \
+// RUN:   --input=64x64xf32=1 %s | FileCheck %s
+// RUN: iree-compile \
+// RUN:   --iree-hal-target-device=local \
+// RUN:   --iree-hal-local-target-device-backends=llvm-cpu \
+// RUN:   --iree-stream-partitioning-favor=balanced %s | \
+// RUN: iree-benchmark-module --device=local-task --module=- \
+// RUN:   --function=branching --input=64x64xf32=1 | \
+// RUN: FileCheck %s --check-prefix=BENCHMARK
+
+// A model with independent branches of differing cost that join at the end.
+// The cost model partitioning must produce the same results as the reference
+// partitioning while scheduling the branches into balanced waves.
+
+// CHECK-LABEL: EXEC @branching
+// BENCHMARK: BM_branching
+func.func @branching(%input: tensor<64x64xf32>) -> tensor<64x64xf32> {
+  %zero = arith.constant 0.0 : f32
+  %two = arith.constant dense<2.0> : tensor<64x64xf32>
+  %empty = tensor.empty() : tensor<64x64xf32>
+  %fill = linalg.fill ins(%zero : f32) outs(%empty : tensor<64x64xf32>) -> tensor<64x64xf32>
+
+  // Two large branches.
+  %lhs = linalg.matmul ins(%input, %input : tensor<64x64xf32>, tensor<64x64xf32>)
+                       outs(%fill : tensor<64x64xf32>) -> tensor<64x64xf32>
+  %scaled = arith.mulf %input, %two : tensor<64x64xf32>
+  %rhs = linalg.matmul ins(%scaled, %input : tensor<64x64xf32>, tensor<64x64xf32>)
+                       outs(%fill : tensor<64x64xf32>) -> tensor<64x64xf32>
+
+  // A small branch.
+  %neg = arith.negf %input : tensor<64x64xf32>
+  %abs = math.absf %neg : tensor<64x64xf32>
+
+  %sum = arith.addf %lhs, %rhs : tensor<64x64xf32>
+  %result = arith.addf %sum, %abs : tensor<64x64xf32>
+  return %result : tensor<64x64xf32>
+}
+// CHECK: 64x64xf32=[193 193 193
@@ -0,0 +1,513 @@
+// Copyright 2025 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Autotunes the tile sizes of LLVMCPU dispatches on the host and produces a
+// transform dialect tuning spec for them.
+//
+// Usage:
+//  iree-compile model.mlir \
+//    --iree-hal-target-device=local \
+//    --iree-hal-local-target-device-backends=llvm-cpu \
+//    --iree-hal-dump-executable-benchmarks-to=/tmp/benchmarks/ \
+//    -o /dev/null
+//  iree-tune-cpu-dispatches /tmp/benchmarks/ \
+//    --benchmark-arg=--device=local-sync \
+//    -o /tmp/tuning_spec.mlir
+//  iree-compile model.mlir ... \
+//    --iree-codegen-tuning-spec-path=/tmp/tuning_spec.mlir
+//
+// Each dumped executable benchmark is compiled once per LLVMCPU tile candidate
+// (`--iree-llvmcpu-pgo-tile-candidate`) and run with `iree-benchmark-module`.
+// The compiler records the configuration it picked for every dispatch as a
+// tuning spec named after the benchmark, and the spec of the fastest candidate
+// of each benchmark is kept. The kept specs are nested into a single module and
+// linked into one `__kernel_config` entry point with
+// `iree-codegen-link-tuning-specs`.
+//
+// Intermediate files are written to a temporary directory that is removed on
+// exit unless `--work-dir` or `--keep-work-dir` is passed.
+//
+// Compilation runs on `--jobs` threads. Benchmarks run on `--benchmark-jobs`
+// threads, which defaults to 1 as concurrent benchmarks compete for the same
+// cores and skew the measurements.
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace cl = llvm::cl;
+using llvm::ArrayRef;
+using llvm::SmallVector;
+using llvm::StringRef;
+
+static cl::OptionCategory tunerCategory("iree-tune-cpu-dispatches options");
+
+static cl::list<std::string> inputPaths(
+    cl::Positional, cl::OneOrMore,
+    cl::desc("<benchmark .mlir files or directories containing them>"),
+    cl::cat(tunerCategory));
+
+static cl::opt<std::string>
+    outputPath("o", cl::desc("Path to write the linked tuning spec to."),
+               cl::value_desc("filename"), cl::init("-"),
+               cl::cat(tunerCategory));
+
+static cl::opt<std::string> workDir(
+    "work-dir",
+    cl::desc("Directory for the intermediate modules, specs and benchmark "
+             "results. Defaults to a new temporary directory."),
+    cl::cat(tunerCategory));
+
+static cl::opt<bool> keepWorkDir(
+    "keep-work-dir",
+    cl::desc("Keeps the temporary work directory (and the compile and "
+             "benchmark logs in it) instead of removing it on exit."),
+    cl::init(false), cl::cat(tunerCategory));
+
+static cl::opt<int> numCandidates(
+    "num-candidates",
+    cl::desc("Number of tile candidates to try for each dispatch. Must not "
+             "exceed the number of candidates supported by iree-compile."),
+    cl::init(5), cl::cat(tunerCategory));
+
+static cl::opt<unsigned>
+    numCompileJobs("jobs",
+                   cl::desc("Number of candidates compiled concurrently. "
+                            "Defaults to the number of hardware threads."),
+                   cl::init(0), cl::cat(tunerCategory));
+
+static cl::opt<unsigned> numBenchmarkJobs(
+    "benchmark-jobs",
+    cl::desc("Number of candidates benchmarked concurrently."), cl::init(1),
+    cl::cat(tunerCategory));
+
+static cl::opt<unsigned>
+    timeoutSeconds("timeout",
+                   cl::desc("Seconds after which a compile or benchmark "
+                            "invocation is abandoned. 0 waits indefinitely."),
+                   cl::init(0), cl::cat(tunerCategory));
+
+static cl::list<std::string>
+    compileArgs("compile-arg",
+                cl::desc("Extra argument passed to every iree-compile "
+                         "invocation."),
+                cl::cat(tunerCategory));
+
+static cl::list<std::string> benchmarkArgs(
+    "benchmark-arg",
+    cl::desc("Extra argument passed to every iree-benchmark-module "
+             "invocation (e.g. --device=local-sync)."),
+    cl::cat(tunerCategory));
+
+static cl::opt<std::string> compileToolPath(
+    "iree-compile-path",
+    cl::desc("Path to iree-compile. Defaults to the one next to this tool, "
+             "then to PATH."),
+    cl::cat(tunerCategory));
+
+static cl::opt<std::string> benchmarkToolPath(
+    "iree-benchmark-module-path",
+    cl::desc("Path to iree-benchmark-module. Defaults to the one next to this "
+             "tool, then to PATH."),
+    cl::cat(tunerCategory));
+
+static cl::opt<std::string>
+    optToolPath("iree-opt-path",
+                cl::desc("Path to iree-opt. Defaults to the one next to this "
+                         "tool, then to PATH."),
+                cl::cat(tunerCategory));
+
+namespace {
+
+struct Candidate {
+  int index = 0;
+  std::string vmfbPath;
+  std::string specPath;
+  std::string resultsPath;
+  std::string compileLogPath;
+  std::string benchmarkLogPath;
+  bool compiled = false;
+  // Sum of the real time of all benchmarks in the module.
+  std::optional<double> totalNs;
+};
+
+struct Benchmark {
+  std::string inputPath;
+  std::string name;
+  std::vector<Candidate> candidates;
+};
+
+} // namespace
+
+static std::mutex logMutex;
+
+static void logLine(const llvm::Twine &message) {
+  std::lock_guard<std::mutex> lock(logMutex);
+  llvm::errs() << message << "\n";
+}
+
+/// Resolves a tool from its flag, from the directory of this binary or from
+/// PATH, in that order.
+static std::optional<std::string> findTool(StringRef flagValue,
+                                           StringRef toolName,
+                                           const char *argv0) {
+  if (!flagValue.empty()) {
+    return flagValue.str();
+  }
+  std::string mainExecutable =
+      llvm::sys::fs::getMainExecutable(argv0, (void *)(intptr_t)findTool);
+  if (!mainExecutable.empty()) {
+    llvm::SmallString<256> siblingPath(
+        llvm::sys::path::parent_path(mainExecutable));
+    llvm::sys::path::append(siblingPath, toolName);
+    if (llvm::sys::fs::can_execute(siblingPath)) {
+      return siblingPath.str().str();
+    }
+  }
+  llvm::ErrorOr<std::string> pathTool = llvm::sys::findProgramByName(toolName);
+  if (pathTool) {
+    return *pathTool;
+  }
+  return std::nullopt;
+}
+
+/// Runs `program` with `args`, sending both stdout and stderr to `logPath`.
+static bool runTool(StringRef program, ArrayRef<std::string> args,
+                    StringRef logPath) {
+  SmallVector<StringRef> argRefs;
+  argRefs.push_back(program);
+  llvm::append_range(argRefs, args);
+  std::optional<StringRef> redirects[] = {StringRef(""), logPath, logPath};
+  std::string errorMessage;
+  int exitCode = llvm::sys::ExecuteAndWait(
+      program, argRefs, /*Env=*/std::nullopt, redirects, timeoutSeconds,
+      /*MemoryLimit=*/0, &errorMessage);
+  if (exitCode != 0) {
+    std::string reason = errorMessage.empty() ? "" : ": " + errorMessage;
+    logLine(llvm::Twine("  ") + llvm::sys::path::filename(program) +
+            " failed" + reason + " (see " + logPath + ")");
+    return false;
+  }
+  return true;
+}
+
+static bool collectBenchmarks(std::vector<Benchmark> &benchmarks) {
+  auto addBenchmark = [&](StringRef path) {
+    Benchmark &benchmark = benchmarks.emplace_back();
+    benchmark.inputPath = path.str();
+    benchmark.name = llvm::sys::path::stem(path).str();
+  };
+  for (const std::string &path : inputPaths) {
+    if (!llvm::sys::fs::is_directory(path)) {
+      addBenchmark(path);
+      continue;
+    }
+    std::error_code ec;
+    std::vector<std::string> directoryFiles;
+    for (llvm::sys::fs::directory_iterator it(path, ec), end;
+         it != end && !ec; it.increment(ec)) {
+      if (StringRef(it->path()).ends_with("_benchmark.mlir")) {
+        directoryFiles.push_back(it->path());
+      }
+    }
+    if (ec) {
+      llvm::errs() << "error: failed to list " << path << ": " << ec.message()
+                   << "\n";
+      return false;
+    }
+    llvm::sort(directoryFiles);
+    llvm::for_each(directoryFiles, addBenchmark);
+  }
+  return true;
+}
+
+/// Returns the sum of the real time of all benchmark iterations in the
+/// google benchmark JSON report at `path`.
+static std::optional<double> parseBenchmarkResults(StringRef path) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer =
+      llvm::MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return std::nullopt;
+  }
+  llvm::Expected<llvm::json::Value> report =
+      llvm::json::parse((*buffer)->getBuffer());
+  if (!report) {
+    llvm::consumeError(report.takeError());
+    return std::nullopt;
+  }
+  const llvm::json::Object *reportObject = report->getAsObject();
+  const llvm::json::Array *entries =
+      reportObject ? reportObject->getArray("benchmarks") : nullptr;
+  if (!entries) {
+    return std::nullopt;
+  }
+
+  std::optional<double> totalNs;
+  for (const llvm::json::Value &entry : *entries) {
+    const llvm::json::Object *entryObject = entry.getAsObject();
+    if (!entryObject) {
+      continue;
+    }
+    // Skip the mean/median/stddev aggregates produced with repetitions.
+    std::optional<StringRef> runType = entryObject->getString("run_type");
+    if (runType && *runType != "iteration") {
+      continue;
+    }
+    std::optional<double> realTime = entryObject->getNumber("real_time");
+    if (!realTime) {
+      continue;
+    }
+    StringRef timeUnit = entryObject->getString("time_unit").value_or("ns");
+    double scale = llvm::StringSwitch<double>(timeUnit)
+                       .Case("ns", 1.0)
+                       .Case("us", 1e3)
+                       .Case("ms", 1e6)
+                       .Case("s", 1e9)
+                       .Default(1.0);
+    totalNs = totalNs.value_or(0.0) + *realTime * scale;
+  }
+  return totalNs;
+}
+
+/// Returns the name of the spec module of the benchmark `name`. Each benchmark
+/// gets its own name so that the specs can be nested into the same module.
+static std::string getSpecSymbolName(StringRef name) {
+  std::string symbolName;
+  for (char c : name) {
+    symbolName.push_back(llvm::isAlnum(c) ? c : '_');
+  }
+  return symbolName + "_spec";
+}
+
+int main(int argc, char **argv) {
+  llvm::InitLLVM y(argc, argv);
+  cl::HideUnrelatedOptions(tunerCategory);
+  cl::ParseCommandLineOptions(
+      argc, argv,
+      "IREE LLVMCPU dispatch autotuner\n\n"
+      "Searches tile sizes for the executable benchmarks dumped with "
+      "--iree-hal-dump-executable-benchmarks-to and writes a tuning spec "
+      "for --iree-codegen-tuning-spec-path.\n");
+
+  std::optional<std::string> compileTool =
+      findTool(compileToolPath, "iree-compile", argv[0]);
+  std::optional<std::string> benchmarkTool =
+      findTool(benchmarkToolPath, "iree-benchmark-module", argv[0]);
+  std::optional<std::string> optTool =
+      findTool(optToolPath, "iree-opt", argv[0]);
+  if (!compileTool || !benchmarkTool || !optTool) {
+    llvm::errs() << "error: failed to find iree-compile, iree-opt and "
+                    "iree-benchmark-module; pass their paths explicitly\n";
+    return 1;
+  }
+  if (numCandidates <= 0) {
+    llvm::errs() << "error: --num-candidates must be positive\n";
+    return 1;
+  }
+
+  std::vector<Benchmark> benchmarks;
+  if (!collectBenchmarks(benchmarks)) {
+    return 1;
+  }
+  if (benchmarks.empty()) {
+    llvm::errs() << "error: no executable benchmarks found\n";
+    return 1;
+  }
+
+  llvm::SmallString<256> workPath(workDir);
+  bool removeWorkPath = false;
+  if (workPath.empty()) {
+    if (std::error_code ec = llvm::sys::fs::createUniqueDirectory(
+            "iree-tune-cpu-dispatches", workPath)) {
+      llvm::errs() << "error: failed to create a work directory: "
+                   << ec.message() << "\n";
+      return 1;
+    }
+    removeWorkPath = !keepWorkDir;
+  } else if (std::error_code ec =
+                 llvm::sys::fs::create_directories(workPath)) {
+    llvm::errs() << "error: failed to create " << workPath << ": "
+                 << ec.message() << "\n";
+    return 1;
+  }
+  auto removeWorkDir = llvm::make_scope_exit([&]() {
+    if (removeWorkPath) {
+      llvm::sys::fs::remove_directories(workPath);
+    }
+  });
+  logLine("Tuning " + llvm::Twine(benchmarks.size()) + " benchmarks in " +
+          workPath);
+
+  for (Benchmark &benchmark : benchmarks) {
+    for (int index = 0; index < numCandidates; ++index) {
+      Candidate &candidate = benchmark.candidates.emplace_back();
+      candidate.index = index;
+      llvm::SmallString<256> basePath(workPath);
+      llvm::sys::path::append(basePath,
+                              benchmark.name + "." + llvm::Twine(index));
+      std::string base = basePath.str().str();
+      candidate.vmfbPath = base + ".vmfb";
+      candidate.specPath = base + ".spec.mlir";
+      candidate.resultsPath = base + ".json";
+      candidate.compileLogPath = base + ".compile.log";
+      candidate.benchmarkLogPath = base + ".benchmark.log";
+    }
+  }
+
+  // Compile all candidates of all benchmarks.
+  {
+    llvm::DefaultThreadPool compilePool(
+        llvm::hardware_concurrency(numCompileJobs));
+    for (Benchmark &benchmark : benchmarks) {
+      for (Candidate &candidate : benchmark.candidates) {
+        compilePool.async([&]() {
+          std::vector<std::string> args = {
+              benchmark.inputPath,
+              "--iree-llvmcpu-pgo-tile-candidate=" +
+                  std::to_string(candidate.index),
+              "--iree-llvmcpu-pgo-tuning-spec-output=" + candidate.specPath,
+              "--iree-llvmcpu-pgo-tuning-spec-name=" +
+                  getSpecSymbolName(benchmark.name),
+              "-o",
+              candidate.vmfbPath,
+          };
+          llvm::append_range(args, compileArgs);
+          candidate.compiled =
+              runTool(*compileTool, args, candidate.compileLogPath) &&
+              llvm::sys::fs::exists(candidate.specPath);
+        });
+      }
+    }
+    compilePool.wait();
+  }
+
+  // Benchmark the candidates that compiled.
+  {
+    llvm::DefaultThreadPool benchmarkPool(
+        llvm::hardware_concurrency(numBenchmarkJobs));
+    for (Benchmark &benchmark : benchmarks) {
+      for (Candidate &candidate : benchmark.candidates) {
+        if (!candidate.compiled) {
+          continue;
+        }
+        benchmarkPool.async([&]() {
+          std::vector<std::string> args = {
+              "--module=" + candidate.vmfbPath,
+              "--benchmark_out=" + candidate.resultsPath,
+              "--benchmark_out_format=json",
+          };
+          llvm::append_range(args, benchmarkArgs);
+          if (runTool(*benchmarkTool, args, candidate.benchmarkLogPath)) {
+            candidate.totalNs = parseBenchmarkResults(candidate.resultsPath);
+          }
+        });
+      }
+    }
+    benchmarkPool.wait();
+  }
+
+  // Keep the spec of the fastest candidate of each benchmark.
+  std::vector<std::string> specs;
+  for (Benchmark &benchmark : benchmarks) {
+    const Candidate *best = nullptr;
+    for (const Candidate &candidate : benchmark.candidates) {
+      if (candidate.totalNs &&
+          (!best || *candidate.totalNs < *best->totalNs)) {
+        best = &candidate;
+      }
+    }
+    if (!best) {
+      logLine("Skipping " + benchmark.name + ": no candidate was measured");
+      continue;
+    }
+    logLine("Selected candidate " + llvm::Twine(best->index) + " for " +
+            benchmark.name + " (" +
+            llvm::formatv("{0:F1}", *best->totalNs / 1e3).str() + "us)");
+
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> specBuffer =
+        llvm::MemoryBuffer::getFile(best->specPath);
+    if (!specBuffer) {
+      logLine("Skipping " + benchmark.name + ": cannot read " +
+              best->specPath);
+      continue;
+    }
+    specs.push_back((*specBuffer)->getBuffer().str());
+  }
+  if (specs.empty()) {
+    llvm::errs() << "error: no dispatch could be tuned";
+    if (removeWorkPath) {
+      llvm::errs() << "; pass --keep-work-dir to inspect the logs";
+    }
+    llvm::errs() << "\n";
+    return 1;
+  }
+
+  // A single spec already has a default entry point and needs no linking.
+  if (specs.size() == 1) {
+    std::error_code ec;
+    llvm::ToolOutputFile output(outputPath, ec, llvm::sys::fs::OF_None);
+    if (ec) {
+      llvm::errs() << "error: failed to open " << outputPath << ": "
+                   << ec.message() << "\n";
+      return 1;
+    }
+    output.os() << specs.front();
+    output.keep();
+    return 0;
+  }
+
+  llvm::SmallString<256> unlinkedPath(workPath);
+  llvm::sys::path::append(unlinkedPath, "unlinked_tuning_spec.mlir");
+  {
+    std::error_code ec;
+    llvm::raw_fd_ostream os(unlinkedPath, ec);
+    if (ec) {
+      llvm::errs() << "error: failed to write " << unlinkedPath << ": "
+                   << ec.message() << "\n";
+      return 1;
+    }
+    os << "module @iree_cpu_autotuned_spec attributes "
+          "{transform.with_named_sequence} {\n";
+    for (const std::string &spec : specs) {
+      os << spec << "\n";
+    }
+    os << "}\n";
+  }
+
+  llvm::SmallString<256> linkLogPath(workPath);
+  llvm::sys::path::append(linkLogPath, "link_tuning_specs.log");
+  std::vector<std::string> linkArgs = {
+      unlinkedPath.str().str(),
+      "--pass-pipeline=builtin.module(iree-codegen-link-tuning-specs)",
+      "-o",
+      outputPath,
+  };
+  if (!runTool(*optTool, linkArgs, linkLogPath)) {
+    return 1;
+  }
+  return 0;
+}
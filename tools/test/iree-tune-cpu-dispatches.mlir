@@ -0,0 +1,31 @@
+// RUN: iree-compile %s -o %t.vmfb \
+// RUN:     --iree-hal-target-device=local \
+// RUN:     --iree-hal-local-target-device-backends=llvm-cpu \
+// RUN:     --iree-hal-dump-executable-benchmarks-to=%t.benchmarks && \
+// RUN: iree-tune-cpu-dispatches %t.benchmarks \
+// RUN:     --num-candidates=1 \
+// RUN:     --benchmark-arg=--device=local-task \
+// RUN:     -o %t.spec.mlir && \
+// RUN: iree-opt %t.spec.mlir | FileCheck %s
+
+// Each dispatch is tuned from its own executable benchmark and the specs of
+// both are linked into a single default entry point. A single candidate is
+// enough to exercise the compile, benchmark and link steps.
+
+// CHECK-LABEL: module @iree_cpu_autotuned_spec
+//  CHECK-SAME:   iree_codegen.tuning_spec_with_default_entrypoint
+//   CHECK-DAG:   transform.named_sequence @match_matmuls_dispatch_0
+//   CHECK-DAG:   transform.named_sequence @match_matmuls_dispatch_1
+//       CHECK:   transform.named_sequence @__kernel_config
+//  CHECK-SAME:     iree_codegen.tuning_spec_entrypoint
+//       CHECK:     transform.foreach_match
+func.func @matmuls(%lhs: tensor<64x128xf32>, %rhs0: tensor<128x256xf32>, %rhs1: tensor<256x32xf32>) -> tensor<64x32xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %empty0 = tensor.empty() : tensor<64x256xf32>
+  %fill0 = linalg.fill ins(%cst : f32) outs(%empty0 : tensor<64x256xf32>) -> tensor<64x256xf32>
+  %matmul0 = linalg.matmul ins(%lhs, %rhs0 : tensor<64x128xf32>, tensor<128x256xf32>) outs(%fill0 : tensor<64x256xf32>) -> tensor<64x256xf32>
+  %empty1 = tensor.empty() : tensor<64x32xf32>
+  %fill1 = linalg.fill ins(%cst : f32) outs(%empty1 : tensor<64x32xf32>) -> tensor<64x32xf32>
+  %matmul1 = linalg.matmul ins(%matmul0, %rhs1 : tensor<64x256xf32>, tensor<256x32xf32>) outs(%fill1 : tensor<64x32xf32>) -> tensor<64x32xf32>
+  return %matmul1 : tensor<64x32xf32>
+}